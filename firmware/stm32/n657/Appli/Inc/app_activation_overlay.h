@@ -0,0 +1,87 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_activation_overlay.h
+ * @brief   Boot-time checks for the shared NPU activation arena plan.
+ *
+ * Pure logic with no HAL, ThreadX or BSP dependency. The model stages run
+ * strictly one after another, so tools/activation_overlay.py lets stages
+ * whose lifetimes do not intersect share the same part of the activation
+ * arena and writes the result to app_activation_overlay_plan.h. This module
+ * checks that plan (every region inside the arena, no two regions live at
+ * the same step sharing bytes) and checks each stage's live buffer tables
+ * against its planned region once the runtime has placed them.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#ifndef __APP_ACTIVATION_OVERLAY_H
+#define __APP_ACTIVATION_OVERLAY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+	const char *name;    /* Generated network name, e.g. "heatmap_cd". */
+	uint32_t offset;     /* From the arena base. */
+	uint32_t size;
+	uint8_t first_step;  /* Pipeline steps during which the region is live. */
+	uint8_t last_step;
+} AppActivationOverlay_Region_t;
+
+typedef enum {
+	APP_ACTIVATION_OVERLAY_OK = 0,
+	/* A region, or a buffer, runs past the end of the arena. */
+	APP_ACTIVATION_OVERLAY_OUT_OF_ARENA,
+	/* Two regions live at the same step share bytes. */
+	APP_ACTIVATION_OVERLAY_LIFETIME_OVERLAP,
+	/* The stage's buffers reach outside its planned region. */
+	APP_ACTIVATION_OVERLAY_EXTENT_EXCEEDED,
+	APP_ACTIVATION_OVERLAY_UNKNOWN_STAGE,
+} AppActivationOverlay_Status_t;
+
+/* Arena-relative span of one stage's buffers, built up buffer by buffer. */
+typedef struct {
+	uint32_t start;
+	uint32_t end;
+	uint32_t buffer_count;   /* Buffers inside the arena. */
+	uint32_t outside_count;  /* Buffers wholly outside, e.g. on xSPI2. */
+	bool straddles;          /* A buffer crosses an arena edge. */
+} AppActivationOverlay_Extent_t;
+
+/**
+ * @brief Check a plan against its own arena and lifetimes.
+ * @param first_out,second_out Optional; indices of the offending regions.
+ */
+AppActivationOverlay_Status_t AppActivationOverlay_CheckPlan(
+		const AppActivationOverlay_Region_t *regions_ptr, uint32_t region_count,
+		uint32_t arena_size, uint32_t *first_out, uint32_t *second_out);
+
+/** @retval NULL when no region has that name. */
+const AppActivationOverlay_Region_t *AppActivationOverlay_Find(
+		const AppActivationOverlay_Region_t *regions_ptr, uint32_t region_count,
+		const char *name);
+
+void AppActivationOverlay_ExtentInit(AppActivationOverlay_Extent_t *extent_ptr);
+
+/** @brief Fold one buffer, by absolute address, into a stage's extent. */
+void AppActivationOverlay_ExtentAdd(AppActivationOverlay_Extent_t *extent_ptr,
+		uint32_t arena_base, uint32_t arena_size, uint32_t buffer_addr,
+		uint32_t buffer_len);
+
+AppActivationOverlay_Status_t AppActivationOverlay_CheckExtent(
+		const AppActivationOverlay_Region_t *region_ptr,
+		const AppActivationOverlay_Extent_t *extent_ptr);
+
+const char *AppActivationOverlay_StatusName(
+		AppActivationOverlay_Status_t status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_ACTIVATION_OVERLAY_H */
@@ -0,0 +1,33 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_activation_overlay_plan.h
+ * @brief   Activation arena plan for the sequential NPU stages.
+ *
+ * Placeholder, not generated: the packages' buffer tables that
+ * tools/activation_overlay.py reads are not checked in, so every stage is
+ * given the whole arena and nothing is shared or freed. Run the tool on a
+ * tree with the generated packages to replace this file with a real plan.
+ * Checked at boot by app_activation_overlay.c.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#ifndef __APP_ACTIVATION_OVERLAY_PLAN_H
+#define __APP_ACTIVATION_OVERLAY_PLAN_H
+
+#define APP_ACTIVATION_ARENA_BASE_ADDR   0x34100000UL
+#define APP_ACTIVATION_ARENA_SIZE_BYTES  2883576UL
+/* High-water mark of the plan; [USED, SIZE) is free for other buffers. */
+#define APP_ACTIVATION_ARENA_USED_BYTES  2883576UL
+/* Set until the tool writes a plan from real buffer tables. */
+#define APP_ACTIVATION_OVERLAY_PLAN_PLACEHOLDER  1U
+
+#define APP_ACTIVATION_OVERLAY_REGION_COUNT  3U
+/* { network name, offset, size, first step, last step } */
+#define APP_ACTIVATION_OVERLAY_REGIONS \
+	{ "obb_box_board_bbox_deploy_candidate", 0x00000000UL, 2883576UL, 0U, 0U }, \
+	{ "heatmap_cd", 0x00000000UL, 2883576UL, 1U, 1U }, \
+	{ "tip_focus_v18_int8", 0x00000000UL, 2883576UL, 2U, 2U }
+
+#endif /* __APP_ACTIVATION_OVERLAY_PLAN_H */
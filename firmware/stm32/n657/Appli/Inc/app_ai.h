@@ -81,6 +81,26 @@ bool AppAI_Xspi2EnsureMemoryMappedMode(void);
  */
 bool App_AI_GetLastInferenceResult(float *value_out);
 
+/**
+ * @brief Retrieve the last gauge box decoded by the OBB stage.
+ *
+ * The box is the axis-aligned extent of the rotated OBB, normalised to the
+ * frame it was detected in.
+ *
+ * @param[out] generation_out Bumps every time a new box is published.
+ * @retval true when at least one box has been decoded since boot.
+ */
+bool App_AI_GetLastGaugeBox(float *center_x_out, float *center_y_out,
+		float *width_out, float *height_out, uint32_t *generation_out);
+
+/**
+ * @brief Skip the OBB stage for the frames that follow.
+ *
+ * Used by the ROI capture path once the sensor window already frames the
+ * gauge on the training crop; the fixed training crop is used instead.
+ */
+void App_AI_SetObbStageSkipped(bool skip);
+
 /**
  * @brief Verify that tip-focus weights are programmed in xSPI2 flash.
  *
@@ -92,6 +112,31 @@ bool App_AI_GetLastInferenceResult(float *value_out);
  */
 bool AppAI_VerifyTipFocusWeights(void);
 
+/**
+ * @brief Check whether the NPU or the xSPI2 controller is moving data.
+ *
+ * True while a network's epoch loop runs or xSPI2 is in an indirect command.
+ * The clock switcher holds bus changes off while this is set.
+ */
+bool AppAI_IsBusMasterActive(void);
+
+/**
+ * @brief Number of network epoch loops started since boot, across all
+ *        networks; a stage whose last run is not the latest cannot re-arm.
+ */
+uint32_t AppAI_GetNpuRunCount(void);
+
+/**
+ * @brief Software-reset the xSPI2 NOR back to 1-line SPI before a reboot.
+ *
+ * The octal STR/DTR runtime modes live in the flash's volatile CR2, which an
+ * MCU reset does not clear; the boot ROM and FSBL only read SPI. Call this
+ * on every path that ends in a reset the firmware can see coming. Resets
+ * the firmware never sees (NRST, a debugger reset) are why
+ * APP_AI_XSPI2_DTR_ENABLED defaults to 0.
+ */
+void AppAI_Xspi2ResetFlashForReboot(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -61,6 +61,27 @@
 #ifndef APP_AI_RESET_NETWORK_EACH_INFERENCE
 #define APP_AI_RESET_NETWORK_EACH_INFERENCE 0
 #endif
+/* Run each stage's network init once and only re-arm the runtime between
+ * inferences; a changed instance, an aborted run or any other network run in
+ * between still forces a full init. Off by default: the re-arm goes through
+ * LL_ATON_RT_Reset_Network, which the OBB stage does not survive (see the
+ * per-frame reset note in app_ai_helpers_decode.inc). */
+#ifndef APP_AI_REUSE_STAGE_RUNTIME
+#define APP_AI_REUSE_STAGE_RUNTIME 0U
+#endif
+/* Re-arms between per-stage init/re-arm timing lines on the console. */
+#ifndef APP_AI_STAGE_RUNTIME_LOG_INTERVAL
+#define APP_AI_STAGE_RUNTIME_LOG_INTERVAL 32U
+#endif
+/* Per-epoch timing for tools/weight_placement.py. It reads the microsecond
+ * timer once per epoch block, so it stays off outside profiling builds. */
+#ifndef APP_AI_ENABLE_EPOCH_PROFILE
+#define APP_AI_ENABLE_EPOCH_PROFILE 0U
+#endif
+/* Completed runs per printed [AI][EPOCH] profile window. */
+#ifndef APP_AI_EPOCH_PROFILE_REPORT_RUNS
+#define APP_AI_EPOCH_PROFILE_REPORT_RUNS 16U
+#endif
 /* The OBB stage is now fallback-only. The live board inference path routes
  * through the tip-focus UNet heatmap model first, but we keep the old
  * crop front-end behind a switch so it can still be re-enabled for debug. */
@@ -113,6 +134,10 @@
 #define APP_AI_CAPTURE_FRAME_BYTES_PER_PIXEL CAMERA_CAPTURE_BYTES_PER_PIXEL
 #define APP_AI_CAPTURE_FRAME_BYTES \
 	(APP_AI_CAPTURE_FRAME_WIDTH_PIXELS * APP_AI_CAPTURE_FRAME_HEIGHT_PIXELS * APP_AI_CAPTURE_FRAME_BYTES_PER_PIXEL)
+/* Smallest frame the preprocessors accept: one Y8 frame. YUV422 and Y8 are
+ * told apart by length (see AppAI_IsY8Frame). */
+#define APP_AI_CAPTURE_FRAME_MIN_BYTES \
+	(APP_AI_CAPTURE_FRAME_WIDTH_PIXELS * APP_AI_CAPTURE_FRAME_HEIGHT_PIXELS)
 /* Rectified scalar reader: 224x224x3 float RGB input. The offline prod v0.8
  * recipe uses the luma-refined crop to feed this float path, then applies the
  * external calibration/postprocess in firmware. */
@@ -216,6 +241,24 @@
 #define APP_AI_XSPI2_PROGRAM_CHUNK_BYTES 4096U
 #define APP_AI_XSPI2_ERASE_BLOCK_BYTES (64U * 1024U)
 #define APP_AI_XSPI2_PROBE_BYTES 16U
+/* Octal DTR for the runtime weight window. The first runtime reconfigure of
+ * each boot sweeps the DQS input delay over the head of the tip-focus image,
+ * centres the widest passing run and checks every stage signature through
+ * the mapped window; any failure leaves the flash in STR for the rest of the
+ * boot. Off by default: DOPI and the dummy cycles sit in the NOR's volatile
+ * CR2, which survives an MCU reset. The fault loops software-reset the flash
+ * (AppAI_Xspi2ResetFlashForReboot), but after an NRST or debugger reset the
+ * boot ROM cannot read a DTR flash until the board is power-cycled. */
+#ifndef APP_AI_XSPI2_DTR_ENABLED
+#define APP_AI_XSPI2_DTR_ENABLED 0U
+#endif
+/* Calibration pattern length, read from the tip-focus image head. */
+#define APP_AI_XSPI2_DTR_PATTERN_BYTES 64U
+/* Delay taps swept across half a memory clock (the DTR data eye). */
+#define APP_AI_XSPI2_DTR_TAP_COUNT 64U
+/* Windows narrower than this leave too little margin for drift. */
+#define APP_AI_XSPI2_DTR_MIN_WINDOW_TAPS 6U
+#define APP_AI_XSPI2_DTR_READS_PER_TAP 4U
 /* Keep the rectifier crop slightly larger than the raw box so the scalar head
  * still sees the needle and a bit of surrounding dial context. */
 #define APP_AI_RECTIFIER_CROP_SCALE 1.80f
@@ -59,6 +59,17 @@ extern bool AppAI_InitStage(const AppAI_ModelStageSpec *stage);
 
 extern bool AppAI_EnsureStageRuntimeReady(const AppAI_ModelStageSpec *stage);
 
+/* Activation arena plan (app_activation_overlay_plan.h) checks. */
+extern bool AppAI_CheckActivationOverlayPlan(void);
+
+extern bool AppAI_CheckActivationOverlay(const char *network_name,
+	const NN_Instance_TypeDef *nn_instance);
+
+/* Per-epoch timing profile (APP_AI_ENABLE_EPOCH_PROFILE). */
+extern void AppAI_EpochProfileBegin(const char *network_name);
+extern void AppAI_EpochProfileMark(void);
+extern void AppAI_EpochProfileEnd(bool completed);
+
 /* ------------------------------------------------------------------ */
 /* Crop-box decoders                                                  */
 /* ------------------------------------------------------------------ */
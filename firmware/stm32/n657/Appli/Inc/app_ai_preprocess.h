@@ -30,6 +30,14 @@ extern bool AppAI_PreprocessYuv422FrameToFloatInput(
 	size_t input_float_count, size_t input_len_bytes,
 	size_t output_width, size_t output_height);
 
+extern bool AppAI_IsY8Frame(size_t frame_size_bytes,
+	size_t frame_width_pixels);
+
+extern float AppAI_ReadNormalizedLumaFromY8Bilinear(const uint8_t *frame_bytes,
+	size_t frame_size_bytes,
+	size_t frame_width_pixels, size_t frame_height_pixels,
+	float source_x, float source_y);
+
 extern void AppAI_ReadRgbFromYuv422Bilinear(const uint8_t *frame_bytes,
 	size_t frame_size_bytes,
 	size_t frame_width_pixels, size_t frame_height_pixels,
@@ -94,6 +94,16 @@ extern bool   app_ai_tip_focus_last_published_valid;
 extern uint32_t app_ai_tip_focus_consecutive_invalid;
 extern uint32_t app_ai_tip_focus_outlier_streak;
 
+/* ------------------------------------------------------------------ */
+/* Gauge box published for ROI capture                                */
+/* ------------------------------------------------------------------ */
+extern float             app_ai_gauge_box_center_x;
+extern float             app_ai_gauge_box_center_y;
+extern float             app_ai_gauge_box_width;
+extern float             app_ai_gauge_box_height;
+extern volatile uint32_t app_ai_gauge_box_generation;
+extern volatile bool     app_ai_skip_obb_stage;
+
 /* ------------------------------------------------------------------ */
 /* Forced (debug) crop override                                       */
 /* ------------------------------------------------------------------ */
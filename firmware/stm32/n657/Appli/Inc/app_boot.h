@@ -0,0 +1,60 @@
+/*
+ *******************************************************************************
+ * @file    app_boot.h
+ * @brief   Boot orchestrator: runs init tasks concurrently by dependency.
+ *
+ * The task table lives in app_boot.c. Each lane is a thread that calls
+ * AppBoot_RunLane() with its own dispatcher; tasks owned by another
+ * subsystem (RTC read in main(), SD mount in the FileX thread) are reported
+ * through AppBoot_CompleteExternal(). Times are HAL milliseconds since reset.
+ *******************************************************************************
+ */
+
+#ifndef __APP_BOOT_H
+#define __APP_BOOT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "tx_api.h"
+
+typedef enum {
+	APP_BOOT_LANE_CAMERA = 0,
+	APP_BOOT_LANE_AI,
+	APP_BOOT_LANE_EXTERNAL,
+} AppBoot_Lane_t;
+
+typedef enum {
+	APP_BOOT_TASK_RTC = 0,
+	APP_BOOT_TASK_SD_MOUNT,
+	APP_BOOT_TASK_NPU_CONFIG,
+	APP_BOOT_TASK_MODEL_INIT,
+	APP_BOOT_TASK_CAMERA_PROBE,
+	APP_BOOT_TASK_SENSOR_CONFIG,
+	APP_BOOT_TASK_AE_SEED,
+	APP_BOOT_TASK_COUNT,
+} AppBoot_Task_t;
+
+#define APP_BOOT_TASK_MASK(task)  (1UL << (uint32_t) (task))
+
+/* Runs one task on the calling lane; returns its outcome. */
+typedef bool (*AppBoot_TaskRunner_t)(AppBoot_Task_t task);
+
+UINT AppBoot_Init(void);
+
+void AppBoot_RunLane(AppBoot_Lane_t lane, AppBoot_TaskRunner_t runner);
+void AppBoot_CompleteExternal(AppBoot_Task_t task, bool success);
+
+bool AppBoot_WaitForTasks(uint32_t task_mask, uint32_t timeout_ms);
+bool AppBoot_TaskSucceeded(AppBoot_Task_t task);
+
+void AppBoot_NotifyReading(const char *source);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_BOOT_H */
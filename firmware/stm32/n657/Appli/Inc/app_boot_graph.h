@@ -0,0 +1,105 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_boot_graph.h
+ * @brief   Dependency graph for boot-time initialization tasks.
+ *
+ * Pure logic with no HAL or ThreadX dependency. Each task names the lane
+ * (worker thread) that runs it and the tasks it depends on; a lane asks for
+ * its next runnable task and reports the outcome. Hard dependencies must
+ * succeed, and a failure skips everything downstream. Soft dependencies are
+ * waited for only until a deadline measured from boot, so an optional input
+ * (an SD-backed seed, say) never holds up the first reading for long.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#ifndef __APP_BOOT_GRAPH_H
+#define __APP_BOOT_GRAPH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Dependencies are bit masks, so the graph is capped at one word of tasks. */
+#define APP_BOOT_GRAPH_MAX_TASKS      16U
+/* Wait hint meaning "until some task completes". */
+#define APP_BOOT_GRAPH_WAIT_FOREVER   UINT32_MAX
+
+#define APP_BOOT_GRAPH_TASK_BIT(index)  (1UL << (index))
+
+typedef struct {
+	const char *name;
+	uint32_t lane;              /* Worker that runs the task. */
+	uint32_t hard_deps;         /* Must all succeed first. */
+	uint32_t soft_deps;         /* Waited for until soft_deadline_ms. */
+	uint32_t soft_deadline_ms;  /* Since boot; ignored without soft deps. */
+} AppBootGraph_TaskDesc_t;
+
+typedef enum {
+	APP_BOOT_TASK_PENDING = 0,
+	APP_BOOT_TASK_RUNNING,
+	APP_BOOT_TASK_DONE,
+	APP_BOOT_TASK_FAILED,
+	APP_BOOT_TASK_SKIPPED,      /* A hard dependency failed or was skipped. */
+} AppBootGraph_TaskState_t;
+
+typedef enum {
+	APP_BOOT_GRAPH_NEXT_READY = 0,  /* *index_out is now RUNNING. */
+	APP_BOOT_GRAPH_NEXT_WAIT,       /* Lane has work blocked on other lanes. */
+	APP_BOOT_GRAPH_NEXT_FINISHED,   /* Lane has nothing left to run. */
+} AppBootGraph_Next_t;
+
+typedef struct {
+	const AppBootGraph_TaskDesc_t *tasks;
+	size_t task_count;
+	uint32_t origin_ms;
+	AppBootGraph_TaskState_t state[APP_BOOT_GRAPH_MAX_TASKS];
+	uint32_t start_ms[APP_BOOT_GRAPH_MAX_TASKS];
+	uint32_t end_ms[APP_BOOT_GRAPH_MAX_TASKS];
+} AppBootGraph_t;
+
+/**
+ * @brief Reset the graph, rejecting unknown, self or cyclic dependencies.
+ * @param origin_ms Boot time on the caller's millisecond clock.
+ */
+bool AppBootGraph_Init(AppBootGraph_t *graph_ptr,
+		const AppBootGraph_TaskDesc_t *tasks_ptr, size_t task_count,
+		uint32_t origin_ms);
+
+/**
+ * @brief Claim the next runnable task for @p lane.
+ *
+ * Tasks are taken in table order among those whose dependencies allow it.
+ * @param wait_ms_out On WAIT, how long until a soft deadline could unblock a
+ *        task, or APP_BOOT_GRAPH_WAIT_FOREVER. May be NULL.
+ */
+AppBootGraph_Next_t AppBootGraph_TakeNext(AppBootGraph_t *graph_ptr,
+		uint32_t lane, uint32_t now_ms, size_t *index_out,
+		uint32_t *wait_ms_out);
+
+/**
+ * @brief Record a task outcome.
+ *
+ * A task completed straight from PENDING (one driven by another subsystem,
+ * such as the SD mount) is timed from boot.
+ * @retval false when the task is unknown or already finished.
+ */
+bool AppBootGraph_Complete(AppBootGraph_t *graph_ptr, size_t index,
+		bool success, uint32_t now_ms);
+
+/* true once every task in @p task_mask is DONE, FAILED or SKIPPED. */
+bool AppBootGraph_IsSettled(const AppBootGraph_t *graph_ptr,
+		uint32_t task_mask);
+
+const char *AppBootGraph_StateName(AppBootGraph_TaskState_t state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_BOOT_GRAPH_H */
@@ -0,0 +1,77 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_burst_fusion.h
+ * @brief   Align and merge a short burst of frames into one denoised frame.
+ *
+ * Pure helpers with no HAL dependency. Each burst frame is registered against
+ * the first with an integer translation search on luma, then every output
+ * byte is the temporal median or mean of the aligned samples. Samples that
+ * fall off the frame after the shift are simply left out of the merge.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#ifndef __APP_BURST_FUSION_H
+#define __APP_BURST_FUSION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "app_frame_format.h"
+
+/* Upper bound on frames in one burst; sizes the per-pixel sample scratch. */
+#define APP_BURST_FUSION_MAX_FRAMES 5U
+
+typedef enum {
+	/* Best noise reduction (sqrt(K)); any moving glint is smeared in. */
+	APP_BURST_FUSION_MEAN = 0,
+	/* Rejects a glint or flicker present in a minority of frames. */
+	APP_BURST_FUSION_MEDIAN = 1,
+} AppBurstFusion_Method_t;
+
+/**
+ * @brief Translation of one frame relative to the reference frame.
+ *
+ * frame(x + dx, y + dy) shows the same scene point as reference(x, y).
+ */
+typedef struct {
+	int32_t dx;
+	int32_t dy;
+} AppBurstFusion_Shift_t;
+
+/**
+ * @brief Find the integer shift that best registers @p frame_ptr onto
+ *        @p reference_ptr.
+ *
+ * Minimises the mean absolute luma difference over the overlap on a 2x2
+ * subsampled grid. YUV422 shifts are kept to even columns so the chroma
+ * pairs stay aligned byte for byte.
+ * @param max_shift_pixels Search radius in each direction.
+ */
+bool AppBurstFusion_EstimateShift(const uint8_t *reference_ptr,
+		const uint8_t *frame_ptr, AppFrameFormat_t format, size_t width_pixels,
+		size_t height_pixels, uint32_t max_shift_pixels,
+		AppBurstFusion_Shift_t *shift_out);
+
+/**
+ * @brief Merge @p frame_count aligned frames into @p output_ptr.
+ *
+ * @p shifts_ptr[0] should be zero so every output byte has at least the
+ * reference sample. @p output_ptr must not alias any input frame.
+ */
+bool AppBurstFusion_Fuse(const uint8_t *const *frames_ptr,
+		const AppBurstFusion_Shift_t *shifts_ptr, size_t frame_count,
+		AppFrameFormat_t format, size_t width_pixels, size_t height_pixels,
+		AppBurstFusion_Method_t method, uint8_t *output_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_BURST_FUSION_H */
@@ -14,9 +14,15 @@
 extern "C" {
 #endif
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
+#include "app_camera_config.h"
+#include "app_frame_ingest.h"
 #include "app_memory_budget.h"
+#include "app_nn_pipe.h"
+#include "tx_api.h"
 
 /* Shared camera buffer state ------------------------------------------------ */
 extern uint32_t camera_capture_active_buffer_index;
@@ -27,11 +33,39 @@ extern uint8_t camera_inference_frame_snapshot_pending[CAMERA_CAPTURE_BUFFER_SIZ
 extern uint32_t camera_capture_write_probe_words[2U];
 extern uint32_t camera_capture_raw_level_histogram[1024U];
 
+/* One-pass summaries of the accepted capture and of the inference snapshot
+ * copied from it. Consumers check AppFrameIngest_Describes() before use. */
+extern AppFrameIngest_Descriptor_t camera_capture_frame_descriptor;
+extern AppFrameIngest_Descriptor_t camera_inference_frame_descriptor;
+
+/* RGB888 frame of the ancillary NN pipe. The camera thread publishes it with
+ * the main frame it was taken with; the inference request adopts it together
+ * with the snapshot and holds it until the AI worker is done, and the pipe is
+ * not re-armed into a held frame. */
+#if CAMERA_CAPTURE_ENABLE_NN_PIPE
+extern uint8_t camera_nn_capture_buffer[CAMERA_NN_FRAME_SIZE_BYTES];
+#endif
+extern AppNnPipe_Frame_t camera_capture_nn_frame;
+extern AppNnPipe_Frame_t camera_inference_nn_frame;
+
 /* Shared camera buffer helpers --------------------------------------------- */
 void AppCameraBuffers_PrepareForDma(void);
 void AppCameraBuffers_InvalidateCaptureRegion(uint32_t captured_bytes);
-uint32_t AppCameraBuffers_CountNonZeroBytes(const uint8_t *buffer_ptr,
+bool AppCameraBuffers_DescribeCaptureFrame(const uint8_t *frame_ptr,
 		uint32_t length_bytes);
+void AppCameraBuffers_AdoptSnapshotDescriptor(const uint8_t *source_ptr,
+		size_t length_bytes);
+void AppCameraBuffers_AdoptNnFrame(const uint8_t *source_ptr);
+void AppCameraBuffers_ReleaseNnFrame(void);
+bool AppCameraBuffers_IsNnFrameHeld(void);
+
+/* Capture buffer references held by asynchronous consumers (archival save).
+ * InitSync creates the release event before the first Retain. */
+UINT AppCameraBuffers_InitSync(void);
+void AppCameraBuffers_RetainCaptureBuffer(void);
+void AppCameraBuffers_ReleaseCaptureBuffer(void);
+bool AppCameraBuffers_IsCaptureBufferHeld(void);
+bool AppCameraBuffers_WaitForCaptureBufferRelease(ULONG wait_ticks);
 
 #ifdef __cplusplus
 }
@@ -12,6 +12,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include "app_frame_format.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -23,6 +24,17 @@ bool AppCameraCapture_RunImx335Background(void);
 /* Capture a frame, save it to storage, and queue dry-run inference if needed. */
 bool AppCameraCapture_CaptureAndStoreSingleFrame(void);
 
+/* Runtime pixel layout for processed captures; applied from the next frame. */
+void AppCameraCapture_SetFrameFormat(AppFrameFormat_t format);
+AppFrameFormat_t AppCameraCapture_GetFrameFormat(void);
+
+/* Boot-time AE seed: load SD-backed capture settings and seed the sensor. */
+bool AppCameraCapture_PrepareFirstCapture(void);
+
+/* Park the sensor for an idle gap; returns how early the next capture must
+ * start so the woken sensor delivers its first frame on time. */
+uint32_t AppCameraCapture_EnterIdlePower(uint32_t idle_ms);
+
 /* Internal capture helpers now owned by the capture module. */
 bool AppCameraCapture_CaptureSingleFrame(uint32_t *captured_bytes_ptr);
 void AppCameraCapture_LogCaptureState(const char *reason);
@@ -76,6 +76,19 @@ extern "C" {
 #define CAMERA_CAPTURE_BRIGHTNESS_BRIGHT_RATIO_PERCENT     50U
 #define CAMERA_CAPTURE_BRIGHTNESS_BRIGHT_SOLID_MEAN_THRESHOLD 215U
 #define CAMERA_CAPTURE_BRIGHTNESS_BRIGHT_MIN_THRESHOLD     45U
+/* Take the gate's luma summary from the DCMIPP statistics the ISP gathers on
+ * the training crop when a cycle completed after the snapshot was armed;
+ * otherwise sample every STEP-th pixel of every STEP-th crop row (4 -> 1/16
+ * of the crop). The hardware bins are coarse thresholds, so their min, max
+ * and bright count are bounds that lean towards accepting the frame. The
+ * settle frames cover the 2-VSYNC statistics latency plus the sensor's
+ * exposure delay. */
+#define CAMERA_CAPTURE_ISP_BRIGHTNESS_STATS_ENABLED      1U
+#define CAMERA_CAPTURE_ISP_STATS_SETTLE_FRAMES            3U
+#define CAMERA_CAPTURE_BRIGHTNESS_SAMPLE_STEP             4U
+/* The DMA-written check reads every Nth 32-bit word of the frame and stops
+ * at the first non-zero one. */
+#define CAMERA_CAPTURE_NONZERO_PROBE_STRIDE_WORDS        16U
 /* Keep brightness nudges centered around the usable band instead of using a
  * single fixed step that can bounce between too-dark and too-bright frames.
  * The runtime scales the step from this target mean and damps it when the
@@ -92,11 +105,84 @@ extern "C" {
  * capture loop unbounded. */
 #define CAMERA_CAPTURE_BRIGHTNESS_RETRY_LIMIT             14U
 #define CAMERA_CAPTURE_BRIGHTNESS_SETTLE_DELAY_MS         250U
+/* Replace the nudge ladder above with a model-based controller: the rejected
+ * frame's crop histogram and the sensor's exposure x gain response give the
+ * required correction in one step, with a damped second step if the ISP tone
+ * curve differs from the assumed gamma. The host simulation converges in one
+ * or two frames from the cold-start seed across the recorded lighting, so
+ * three corrections leaves one spare for a scene change mid-request. Set to
+ * 0U to fall back to the nudge ladder. */
+#define CAMERA_CAPTURE_PREDICTIVE_EXPOSURE_ENABLED          1U
+#define CAMERA_CAPTURE_EXPOSURE_MAX_CORRECTIONS             3U
+#define CAMERA_CAPTURE_EXPOSURE_RESPONSE_GAMMA            2.2f
+#define CAMERA_CAPTURE_EXPOSURE_SECOND_STEP_DAMPING       0.8f
+/* About 6.6 stops; bounds the damage of a wildly wrong measurement. */
+#define CAMERA_CAPTURE_EXPOSURE_MAX_STEP_RATIO          100.0f
 /* Capture crop is expressed directly in pixels/lines. */
 #define CAMERA_CAPTURE_CROP_HSTART_PIXELS   0U
 #define CAMERA_CAPTURE_CROP_VSTART_LINES    0U
 /* Time to let AE hardware converge before locking exposure/gain for capture. */
 #define CAMERA_CAPTURE_AE_SETTLE_DELAY_MS         500U
+/* Remember the accepted exposure/gain per hour of day (keyed by the DS3231
+ * date) in a small CRC-sealed file on the SD card, and seed the sensor from
+ * it before the first frame. The 500 ms AE settle above then only runs when
+ * that first frame fails the brightness gate. Entries older than the max age
+ * are ignored so seasonal drift cannot pin a stale seed. */
+#define CAMERA_CAPTURE_EXPOSURE_MEMORY_ENABLED          1U
+#define CAMERA_CAPTURE_EXPOSURE_MEMORY_MAX_AGE_DAYS     7U
+#define CAMERA_CAPTURE_EXPOSURE_MEMORY_FILE_NAME   "exposure.bin"
+/* Region-of-interest capture: once the OBB stage has found the gauge, the
+ * CMW pipe crops the sensor window that puts the gauge box on the training
+ * crop of the 224x224 frame, so the downstream crop ratios stay valid while
+ * the dial gets the full output resolution. The OBB stage then only runs
+ * every REVALIDATE_FRAMES captures; a failed re-validation drops back to the
+ * default centred square. The minimum window bounds the zoom at roughly 4x
+ * over the default framing. Opt-in until it has been validated on target. */
+#define CAMERA_CAPTURE_ROI_MODE_ENABLED                 0U
+#define CAMERA_CAPTURE_ROI_MARGIN_PERCENT               5U
+#define CAMERA_CAPTURE_ROI_MIN_WINDOW_PIXELS          448U
+#define CAMERA_CAPTURE_ROI_MOVE_TOLERANCE_PERCENT       3U
+#define CAMERA_CAPTURE_ROI_REVALIDATE_FRAMES           10U
+/* Pixel layout of processed captures. Y8 keeps only the luma plane: the CMW
+ * pipe packs MONO_Y8 through the RGB->YUV matrix, halving DMA traffic,
+ * buffer copies, cache maintenance and SD archive size. The models then see
+ * grey RGB (the APP_AI_YUV422_INPUT_LUMA_ONLY view), so validate a
+ * deployment on Y8 archives before switching it. A deployment overrides the
+ * default with a selection file on the SD card containing "y8" or "yuv422". */
+#define CAMERA_CAPTURE_DEFAULT_FRAME_FORMAT   APP_FRAME_FORMAT_YUV422
+#define CAMERA_CAPTURE_FRAME_FORMAT_FILE_NAME  "frame_format.txt"
+/* Burst capture: when the accepted frame needed high analog gain (dusk,
+ * indoor lighting) or shows a patch of near-white glare, grab BURST_FRAMES
+ * in total at the same locked exposure, register each against the first
+ * with an integer translation search of +/-MAX_SHIFT pixels, and merge them
+ * into the capture buffer before inference. The median merge drops a glint
+ * or flicker seen in a minority of frames; the mean merge denoises more but
+ * keeps it. The ring is CPU-only, so it lives in ordinary cached RAM, but
+ * it costs BURST_FRAMES full frames of .bss (~300 KB at the defaults), so
+ * the feature is opt-in and needs a memory budget check when enabled. */
+#define CAMERA_CAPTURE_BURST_ENABLED                   0U
+#define CAMERA_CAPTURE_BURST_FRAMES                    3U
+#define CAMERA_CAPTURE_BURST_MAX_SHIFT_PIXELS          6U
+#define CAMERA_CAPTURE_BURST_FUSION_METHOD    APP_BURST_FUSION_MEDIAN
+/* 18 dB of IMX335 gain is about 8x: read noise is visible in the needle. */
+#define CAMERA_CAPTURE_BURST_MIN_GAIN_MDB          18000
+#define CAMERA_CAPTURE_BURST_GLARE_RATIO_PERCENT      10U
+/* Sensor power between captures. After each cycle the camera thread parks
+ * the IMX335 in the deepest state whose measured wake-to-first-frame time
+ * still fits the idle gap, and starts waking that long before the next
+ * capture. Standby is MODE_SELECT only (registers kept); off drops XCLR and
+ * the module enable, so the wake replays the driver's register table and the
+ * cached exposure/gain seed. WAKE_MS are the estimates used until the first
+ * measurement; an off state that fails to come back MAX_WAKE_FAILURES times
+ * in a row is not used again until reset. Off by default until the wake
+ * timings have been validated on target. */
+#define CAMERA_SENSOR_POWER_ENABLED                    0U
+#define CAMERA_SENSOR_STANDBY_MIN_IDLE_MS           2000U
+#define CAMERA_SENSOR_STANDBY_WAKE_MS                600U
+#define CAMERA_SENSOR_OFF_MIN_IDLE_MS              20000U
+#define CAMERA_SENSOR_OFF_WAKE_MS                   1500U
+#define CAMERA_SENSOR_WAKE_GUARD_MS                  100U
+#define CAMERA_SENSOR_OFF_MAX_WAKE_FAILURES            2U
 /* Arm one CSI line/byte counter on VC0 so we can tell whether the receiver
  * is observing line progress even when the captured payload stays all zeros. */
 #define CAMERA_CAPTURE_CSI_LB_PROBE_COUNTER      DCMIPP_CSI_COUNTER0
@@ -128,9 +214,29 @@ extern "C" {
 #define CAMERA_STORAGE_WAIT_TIMEOUT_MS      70000U
 #define CAMERA_CAPTURE_RETRY_DELAY_MS       50U
 #define CAMERA_FIRST_FRAME_WARMUP_DELAY_MS  1500U
-#define CAMERA_STREAM_WARMUP_DELAY_MS       250U
 #define IMX335_CAPTURE_FRAMERATE_FPS        10
 #define CAMERA_CAPTURE_FILE_NAME_LENGTH     64U
+/* Archival save policy. Inference is dispatched first on frame-ready; the SD
+ * save runs afterwards from the same capture buffer in the low-priority
+ * storage worker, so SD latency no longer sits on the capture-to-result path.
+ *   ALL          - archive every accepted frame (bring-up default).
+ *   EVERY_NTH    - archive one frame out of CAMERA_CAPTURE_SAVE_EVERY_N_FRAMES.
+ *   NO_READ_ONLY - archive only frames whose inference did not publish a value.
+ *                  The worker copies the frame into its own buffer first, so
+ *                  this policy costs one more frame of RAM. */
+#define CAMERA_CAPTURE_SAVE_POLICY_ALL           0U
+#define CAMERA_CAPTURE_SAVE_POLICY_EVERY_NTH     1U
+#define CAMERA_CAPTURE_SAVE_POLICY_NO_READ_ONLY  2U
+#define CAMERA_CAPTURE_SAVE_POLICY          CAMERA_CAPTURE_SAVE_POLICY_ALL
+#define CAMERA_CAPTURE_SAVE_EVERY_N_FRAMES  10U
+/* Upper bound on how long the no-read policy waits for the AI outcome. The
+ * wait runs on the worker's copy, after the capture buffer was released. */
+#define CAMERA_CAPTURE_SAVE_OUTCOME_WAIT_MS 30000U
+/* Upper bound on how long a new capture waits for the storage worker to drop
+ * its reference on the capture buffer before DMA is re-armed into it. The
+ * reference covers one SD write (or the no-read copy), never the outcome
+ * wait above. */
+#define CAMERA_CAPTURE_BUFFER_RELEASE_TIMEOUT_MS  15000U
 #define CAMERA_STORAGE_READY_EVENT_FLAG     0x00000001U
 /* Seed IMX335 at ~1/3 of the exposure range (~11088 us at max=33266 us).
  * The 1/5 seed (6659 us) required 10+ nudge steps to reach the crop-mean
@@ -170,6 +276,27 @@ extern "C" {
 #define CAMERA_CAPTURE_PIPE                 DCMIPP_PIPE1
 #endif
 
+/* Ancillary NN pipe. PIPE2 takes the same exposure as the processed pipe,
+ * crops the training window in sensor coordinates, downsizes it and packs
+ * RGB888 letterboxed at the model resolution (app_nn_pipe.h), so the first
+ * AI stage only quantizes bytes instead of cropping, resizing and converting
+ * YUV on the CPU. PIPE1 keeps writing YUV422 for the baseline and archive.
+ * A frame is used only when it came from the same exposure as the accepted
+ * main frame; otherwise, or when the pipe cannot be set up, the CPU path
+ * runs as before. FRAME_WAIT_MS bounds the wait for it after PIPE1 is done.
+ * Opt-in until it has run on target: the PIPE2 buffer adds one model-sized
+ * RGB888 tensor (~150 KB at 224x224) to .noncacheable, so check the memory
+ * budget report before enabling it. */
+#if CAMERA_CAPTURE_FORCE_RAW_DIAGNOSTIC
+#define CAMERA_CAPTURE_ENABLE_NN_PIPE       0U
+#else
+#define CAMERA_CAPTURE_ENABLE_NN_PIPE       0U
+#endif
+#define CAMERA_NN_PIPE                      DCMIPP_PIPE2
+#define CAMERA_NN_PIPE_FRAME_WAIT_MS        20U
+/* Pipe line pitch and write address alignment. */
+#define CAMERA_NN_PIPE_ALIGN_BYTES          16U
+
 /* Prevent accidentally using mode 1 (solid black = all-zero pixels) during
  * raw diagnostic; it is indistinguishable from a broken DMA path. */
 #if CAMERA_CAPTURE_FORCE_RAW_DIAGNOSTIC && (IMX335_TEST_PATTERN_MODE == 1)
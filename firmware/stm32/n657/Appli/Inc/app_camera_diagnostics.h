@@ -17,6 +17,7 @@ extern "C" {
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "app_frame_ingest.h"
 #include "stm32n6xx_hal.h"
 #include "stm32n6xx_hal_dcmipp.h"
 
@@ -87,9 +88,10 @@ void AppCameraDiagnostics_LogCaptureBufferSummary(const uint8_t *buffer_ptr,
 void AppCameraDiagnostics_LogCaptureBufferPreview(const char *reason,
 		const uint8_t *buffer_ptr, uint32_t length_bytes);
 
-/* Print a compact Y/U/V summary from the packed YUV422 frame buffer. */
+/* Print a compact Y/U/V summary from the ingest descriptor of a packed
+ * YUV422 frame. */
 void AppCameraDiagnostics_LogYuv422ChromaSummary(const char *reason,
-		const uint8_t *buffer_ptr, uint32_t length_bytes);
+		const AppFrameIngest_Descriptor_t *descriptor_ptr);
 
 /* Print a compact ROI summary for the processed YUV frame. */
 void AppCameraDiagnostics_LogProcessedFrameDiagnostics(const char *reason,
@@ -16,6 +16,9 @@ extern "C" {
 #include <stdint.h>
 #include "main.h"
 #include "tx_api.h"
+#include "app_frame_format.h"
+#include "app_luma_stats.h"
+#include "app_nn_pipe.h"
 
 HAL_StatusTypeDef CameraPlatform_ReadImx335ChipId(uint8_t *chip_id);
 UINT CameraPlatform_ProbeBCamsImx(void);
@@ -27,9 +30,16 @@ DCMIPP_HandleTypeDef *CameraPlatform_GetCaptureDcmippHandle(void);
 int32_t CameraPlatform_GetTickMs(void);
 ULONG CameraPlatform_MillisecondsToTicks(uint32_t timeout_ms);
 void CameraPlatform_CacheAcceptedExposureGain(void);
+void CameraPlatform_SetExposureSeed(int32_t exposure_us, int32_t gain_mdb);
 bool CameraPlatform_SeedImx335ExposureGain(void);
 bool CameraPlatform_AdjustImx335ExposureGain(bool brighten,
 		uint32_t step_percent);
+bool CameraPlatform_GetImx335ExposureGain(int32_t *exposure_us,
+		int32_t *gain_mdb);
+bool CameraPlatform_GetImx335ExposureLimits(uint32_t *exposure_min_us,
+		uint32_t *exposure_max_us, int32_t *gain_min_mdb, int32_t *gain_max_mdb);
+bool CameraPlatform_SetImx335ExposureGain(int32_t exposure_us,
+		int32_t gain_mdb);
 bool CameraPlatform_EnableImx335AutoExposure(void);
 bool CameraPlatform_DisableImx335AutoExposure(void);
 bool CameraPlatform_AeSettleAndLock(void);
@@ -38,8 +48,21 @@ bool CameraPlatform_LogImx335AutoExposureState(const char *reason);
 void CameraPlatform_ReapplyImx335TestPattern(void);
 bool CameraPlatform_StartImx335Stream(void);
 bool CameraPlatform_StopImx335Stream(void);
+bool CameraPlatform_PowerOffImx335(void);
+bool CameraPlatform_PowerOnImx335(void);
+bool CameraPlatform_SetCaptureWindow(uint32_t x, uint32_t y, uint32_t width,
+		uint32_t height);
+void CameraPlatform_SetCaptureFrameFormat(AppFrameFormat_t format);
+AppFrameFormat_t CameraPlatform_GetCaptureFrameFormat(void);
+uint32_t CameraPlatform_GetCaptureFrameBytes(void);
+bool CameraPlatform_ArmIspLumaStats(void);
+bool CameraPlatform_GetIspLumaStats(uint8_t bright_level,
+		AppLumaStats_t *stats);
 bool CameraPlatform_PrepareDcmippSnapshot(void);
 bool CameraPlatform_StartDcmippSnapshot(void);
+bool CameraPlatform_IsNnPipeArmed(void);
+const AppNnPipe_Layout_t *CameraPlatform_GetNnPipeLayout(void);
+void CameraPlatform_StopNnPipe(void);
 bool CameraPlatform_ConfigureCsiLineByteProbe(void);
 int32_t CameraPlatform_I2cReadReg(uint16_t dev_addr, uint16_t reg,
 		uint8_t *pdata, uint16_t length);
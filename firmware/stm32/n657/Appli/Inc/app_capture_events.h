@@ -0,0 +1,143 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_capture_events.h
+ * @brief   Snapshot completion state machine fed by DCMIPP/CSI interrupts.
+ *
+ * Pure logic with no HAL or ThreadX dependency. The interrupt callbacks post
+ * VSYNC, start-of-frame, end-of-frame, frame-complete and error events with
+ * a microsecond timestamp; the capture thread arms the machine, blocks on
+ * one event flags group until the exact deadline and then reads the result.
+ *
+ * When the sensor is already streaming at arm time, a frame only counts if a
+ * frame boundary (VSYNC or SOF) arrived after arming, so the capture waits
+ * for the next whole frame instead of sleeping through a fixed warm-up.
+ * Timestamps are wrap-safe 32-bit microseconds.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#ifndef __APP_CAPTURE_EVENTS_H
+#define __APP_CAPTURE_EVENTS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Event flag bits: one per interrupt event, plus the two the capture
+ * thread blocks on. */
+#define APP_CAPTURE_EVENTS_FLAG_VSYNC   (1UL << 0)
+#define APP_CAPTURE_EVENTS_FLAG_SOF     (1UL << 1)
+#define APP_CAPTURE_EVENTS_FLAG_EOF     (1UL << 2)
+#define APP_CAPTURE_EVENTS_FLAG_FRAME   (1UL << 3)
+#define APP_CAPTURE_EVENTS_FLAG_ERROR   (1UL << 4)
+#define APP_CAPTURE_EVENTS_FLAG_READY   (1UL << 5)
+#define APP_CAPTURE_EVENTS_FLAG_FAILED  (1UL << 6)
+/* Ancillary NN pipe frame written or failed; outside the state machine. */
+#define APP_CAPTURE_EVENTS_FLAG_NN_FRAME (1UL << 7)
+#define APP_CAPTURE_EVENTS_FLAG_ALL     0xFFUL
+#define APP_CAPTURE_EVENTS_FLAG_DONE \
+	(APP_CAPTURE_EVENTS_FLAG_READY | APP_CAPTURE_EVENTS_FLAG_FAILED)
+
+typedef enum {
+	APP_CAPTURE_EVENT_VSYNC = 0, /* Pipe VSYNC: a frame starts. */
+	APP_CAPTURE_EVENT_SOF,       /* CSI start of frame. */
+	APP_CAPTURE_EVENT_EOF,       /* CSI end of frame. */
+	APP_CAPTURE_EVENT_FRAME,     /* Pipe frame complete; buffer written. */
+	APP_CAPTURE_EVENT_ERROR,     /* Pipe, CSI or ISP failure. */
+} AppCaptureEvents_Event_t;
+
+typedef enum {
+	APP_CAPTURE_EVENTS_IDLE = 0,
+	APP_CAPTURE_EVENTS_ARMED,     /* Waiting for the next frame boundary. */
+	APP_CAPTURE_EVENTS_IN_FRAME,  /* Boundary seen, frame in flight. */
+	APP_CAPTURE_EVENTS_READY,     /* Frame complete, not yet taken. */
+	APP_CAPTURE_EVENTS_FAILED,
+	APP_CAPTURE_EVENTS_TIMED_OUT,
+} AppCaptureEvents_State_t;
+
+/* Per-capture phases. Without a boundary event the SOF phase is zero and
+ * sof_to_eof spans from the arm. */
+typedef struct {
+	uint32_t arm_to_sof_us;
+	uint32_t sof_to_eof_us;
+	uint32_t eof_to_ready_us;
+	uint32_t arm_to_ready_us;
+	uint32_t dropped_frames;
+	uint32_t rewaits;
+} AppCaptureEvents_Timing_t;
+
+typedef struct {
+	AppCaptureEvents_State_t state;
+	bool wait_for_boundary;
+	bool sof_seen;
+	bool eof_seen;
+	uint32_t arm_us;
+	uint32_t timeout_us;
+	uint32_t sof_us;
+	uint32_t eof_us;
+	uint32_t error_code;
+	/* Frames completed before any boundary after the arm. */
+	uint32_t dropped_frames;
+	/* Frames the thread sent back to wait for the next one. */
+	uint32_t rewaits;
+} AppCaptureEvents_Context_t;
+
+/**
+ * @brief Start waiting for one frame, giving up @p timeout_us after @p now_us.
+ * @param wait_for_boundary true when the sensor already streams, so a frame
+ *        already in flight at arm time must not be taken.
+ */
+void AppCaptureEvents_Arm(AppCaptureEvents_Context_t *context_ptr,
+		uint32_t now_us, uint32_t timeout_us, bool wait_for_boundary);
+
+/**
+ * @brief Feed one interrupt event; callable from interrupt context.
+ *
+ * Events while idle or after the frame was decided are ignored, except that
+ * an error still fails a ready frame the thread has not taken yet.
+ * @retval The state after the event.
+ */
+AppCaptureEvents_State_t AppCaptureEvents_Post(
+		AppCaptureEvents_Context_t *context_ptr, AppCaptureEvents_Event_t event,
+		uint32_t now_us, uint32_t error_code);
+
+/**
+ * @brief Current state, moving to TIMED_OUT once the deadline has passed
+ *        with no frame or error.
+ */
+AppCaptureEvents_State_t AppCaptureEvents_Check(
+		AppCaptureEvents_Context_t *context_ptr, uint32_t now_us);
+
+/* Microseconds left until the deadline; 0 once it has passed. */
+uint32_t AppCaptureEvents_RemainingUs(
+		const AppCaptureEvents_Context_t *context_ptr, uint32_t now_us);
+
+/**
+ * @brief Send a ready frame back to wait for the next one, keeping the
+ *        deadline; used when the frame turned out unusable (all zero).
+ * @retval false unless the state was READY.
+ */
+bool AppCaptureEvents_Rewait(AppCaptureEvents_Context_t *context_ptr);
+
+/**
+ * @brief Take the ready frame and report its phase timings.
+ * @retval false unless the state was READY.
+ */
+bool AppCaptureEvents_Accept(AppCaptureEvents_Context_t *context_ptr,
+		uint32_t now_us, AppCaptureEvents_Timing_t *timing_out);
+
+/* Flag bits to set for @p event that resulted in @p state. */
+uint32_t AppCaptureEvents_FlagsFor(AppCaptureEvents_Event_t event,
+		AppCaptureEvents_State_t state);
+
+const char *AppCaptureEvents_StateName(AppCaptureEvents_State_t state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_CAPTURE_EVENTS_H */
@@ -0,0 +1,104 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_capture_roi.h
+ * @brief   Sensor capture window that tracks the last accepted gauge box.
+ *
+ * Pure geometry with no HAL or ThreadX dependency. The window is chosen so
+ * the gauge box lands on a fixed target rectangle of the output frame (the
+ * training crop), which keeps every downstream ratio-based crop valid while
+ * spending the full output resolution on the gauge region.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#ifndef __APP_CAPTURE_ROI_H
+#define __APP_CAPTURE_ROI_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* DCMIPP crop offsets and sizes must land on a Bayer quad. */
+#define APP_CAPTURE_ROI_ALIGN_PIXELS 2U
+
+/**
+ * @brief Rectangle in sensor pixel coordinates.
+ */
+typedef struct {
+	uint32_t x;
+	uint32_t y;
+	uint32_t width;
+	uint32_t height;
+} AppCaptureRoi_Window_t;
+
+/**
+ * @brief Gauge box normalised to the output frame it was detected in.
+ */
+typedef struct {
+	float center_x;
+	float center_y;
+	float width;
+	float height;
+} AppCaptureRoi_Box_t;
+
+typedef struct {
+	uint32_t sensor_width;
+	uint32_t sensor_height;
+	uint32_t output_width;
+	uint32_t output_height;
+	/* Where the box should land in the output frame, normalised 0..1. */
+	float target_x_min;
+	float target_y_min;
+	float target_x_max;
+	float target_y_max;
+	/* Extra room around the box on each side, in percent of its size. */
+	uint32_t margin_percent;
+	/* Smallest window width; bounds the zoom to what the optics resolve. */
+	uint32_t min_window_width;
+	/* Window moves smaller than this share of its width are ignored. */
+	uint32_t move_tolerance_percent;
+} AppCaptureRoi_Config_t;
+
+/**
+ * @brief The largest centred window with the output aspect ratio.
+ *
+ * This is the fixed framing used before any box is known.
+ */
+void AppCaptureRoi_DefaultWindow(const AppCaptureRoi_Config_t *config_ptr,
+		AppCaptureRoi_Window_t *window_out);
+
+/**
+ * @brief Map a normalised output-frame point back to sensor pixels.
+ */
+void AppCaptureRoi_FrameToSensor(const AppCaptureRoi_Window_t *window_ptr,
+		float frame_x, float frame_y, float *sensor_x_out, float *sensor_y_out);
+
+/**
+ * @brief Compute the window that puts @p box_ptr on the target rectangle.
+ *
+ * @p frame_window_ptr is the window the box was detected in. The result keeps
+ * the output aspect ratio, is clamped to the sensor and to the minimum
+ * width, and is aligned for the DCMIPP crop.
+ * @retval false when the box is degenerate or falls outside the frame.
+ */
+bool AppCaptureRoi_WindowFromBox(const AppCaptureRoi_Config_t *config_ptr,
+		const AppCaptureRoi_Window_t *frame_window_ptr,
+		const AppCaptureRoi_Box_t *box_ptr, AppCaptureRoi_Window_t *window_out);
+
+/**
+ * @brief Check whether @p next_ptr differs enough from @p current_ptr to be
+ *        worth reprogramming the pipe (OBB boxes jitter by a few pixels).
+ */
+bool AppCaptureRoi_ShouldMove(const AppCaptureRoi_Config_t *config_ptr,
+		const AppCaptureRoi_Window_t *current_ptr,
+		const AppCaptureRoi_Window_t *next_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_CAPTURE_ROI_H */
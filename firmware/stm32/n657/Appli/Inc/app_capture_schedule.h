@@ -0,0 +1,119 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_capture_schedule.h
+ * @brief   Adaptive capture period driven by recent gauge readings.
+ *
+ * Pure logic with no HAL or ThreadX dependency: the caller feeds published
+ * readings with a millisecond timestamp and asks for the next capture delay.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#ifndef __APP_CAPTURE_SCHEDULE_H
+#define __APP_CAPTURE_SCHEDULE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define APP_CAPTURE_SCHEDULE_HISTORY_SIZE  6U
+#define APP_CAPTURE_SCHEDULE_DAY_MS        86400000UL
+
+/**
+ * @brief Tunables for the adaptive capture period.
+ */
+typedef struct {
+	uint32_t min_period_ms;        /* Hard floor while the gauge is moving. */
+	uint32_t base_period_ms;       /* Period used with no or uncertain history. */
+	uint32_t max_period_ms;        /* Hard ceiling while the gauge is flat. */
+	float stable_rate_per_min;     /* At or below this the period lengthens. */
+	float fast_rate_per_min;       /* At or above this the period shortens. */
+	bool alarm_enabled;
+	float alarm_low;               /* Readings near either threshold shorten */
+	float alarm_high;              /* the period like a fast change does. */
+	float alarm_margin;
+	uint32_t daily_capture_budget; /* 0 disables the energy budget. */
+} AppCaptureSchedule_Config_t;
+
+typedef struct {
+	uint32_t time_ms;
+	float value;
+} AppCaptureSchedule_Sample_t;
+
+/**
+ * @brief Why the last period was chosen, for logging.
+ */
+typedef enum {
+	APP_CAPTURE_SCHEDULE_REASON_BASE = 0,
+	APP_CAPTURE_SCHEDULE_REASON_STABLE,
+	APP_CAPTURE_SCHEDULE_REASON_CHANGING,
+	APP_CAPTURE_SCHEDULE_REASON_ALARM,
+	APP_CAPTURE_SCHEDULE_REASON_BUDGET,
+} AppCaptureSchedule_Reason_t;
+
+typedef struct {
+	AppCaptureSchedule_Config_t config;
+	AppCaptureSchedule_Sample_t history[APP_CAPTURE_SCHEDULE_HISTORY_SIZE];
+	uint32_t history_count;
+	uint32_t history_next_index;
+	uint32_t period_ms;
+	uint32_t day_start_ms;
+	uint32_t day_date_code;        /* RTC YYYYMMDD of the window, 0 unknown. */
+	uint32_t day_capture_count;
+	bool last_reading_valid;
+	float last_rate_per_min;
+	AppCaptureSchedule_Reason_t last_reason;
+} AppCaptureSchedule_Context_t;
+
+/* Reset the schedule; the first period is config->base_period_ms. */
+void AppCaptureSchedule_Init(AppCaptureSchedule_Context_t *context_ptr,
+		const AppCaptureSchedule_Config_t *config_ptr, uint32_t now_ms);
+
+/**
+ * @brief Align the budget window with the RTC calendar day.
+ *
+ * Until this is called the window runs 24 h from boot. Each call re-anchors
+ * the window to the RTC midnight and restarts the count when the RTC date
+ * differs from the one the window was opened with.
+ *
+ * @param context_ptr Schedule state.
+ * @param now_ms Monotonic millisecond time the RTC was read at.
+ * @param date_code RTC date as YYYYMMDD.
+ * @param minute_of_day RTC time of day, 0..1439.
+ */
+void AppCaptureSchedule_SyncWallClock(AppCaptureSchedule_Context_t *context_ptr,
+		uint32_t now_ms, uint32_t date_code, uint32_t minute_of_day);
+
+/**
+ * @brief Account one capture and, when available, the reading it produced.
+ * @param context_ptr Schedule state.
+ * @param now_ms Monotonic millisecond time of the capture.
+ * @param reading_valid false when the cycle published no reading.
+ * @param value Published gauge reading.
+ */
+void AppCaptureSchedule_RecordCapture(AppCaptureSchedule_Context_t *context_ptr,
+		uint32_t now_ms, bool reading_valid, float value);
+
+/**
+ * @brief Compute the delay until the next capture.
+ *
+ * Stable history grows the period by half each cycle up to the ceiling, a
+ * fast change or a reading near an alarm threshold halves it toward the
+ * floor, and anything in between steps back toward the base period. The
+ * result is then stretched so the remaining daily budget lasts until the
+ * end of the current day window.
+ */
+uint32_t AppCaptureSchedule_NextPeriodMs(
+		AppCaptureSchedule_Context_t *context_ptr, uint32_t now_ms);
+
+const char *AppCaptureSchedule_ReasonName(AppCaptureSchedule_Reason_t reason);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_CAPTURE_SCHEDULE_H */
@@ -0,0 +1,60 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_capture_storage.h
+ * @brief   Asynchronous archival save worker for captured frames.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#ifndef __APP_CAPTURE_STORAGE_H
+#define __APP_CAPTURE_STORAGE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "tx_api.h"
+
+/**
+ * @brief Which accepted frames the storage worker should archive to SD.
+ */
+typedef enum {
+	APP_CAPTURE_STORAGE_POLICY_ALL = 0,
+	APP_CAPTURE_STORAGE_POLICY_EVERY_NTH,
+	APP_CAPTURE_STORAGE_POLICY_NO_READ_ONLY,
+} AppCaptureStorage_Policy_t;
+
+UINT AppCaptureStorage_Init(void);
+UINT AppCaptureStorage_Start(void);
+
+/**
+ * @brief Hand an accepted frame to the storage worker.
+ *
+ * The worker holds a reference on the live capture buffer until the save is
+ * finished (or skipped), or under the no-read policy until it has copied the
+ * frame, so the caller must not re-arm DMA into the buffer while
+ * AppCameraBuffers_IsCaptureBufferHeld() reports true.
+ *
+ * @param frame_ptr Live capture buffer.
+ * @param frame_length Captured byte count.
+ * @param file_extension_ptr Extension for the archived file ("yuv422", ...).
+ * @param inference_sequence Sequence returned by the inference runtime for
+ *        this frame, or 0 when no inference was queued.
+ * @retval true when the frame was queued or intentionally skipped by policy.
+ */
+bool AppCaptureStorage_SubmitFrame(const uint8_t *frame_ptr,
+		ULONG frame_length, const CHAR *file_extension_ptr,
+		uint32_t inference_sequence);
+
+/* Wait until the worker has released the capture buffer. */
+bool AppCaptureStorage_WaitForBufferRelease(uint32_t timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_CAPTURE_STORAGE_H */
@@ -0,0 +1,128 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_clock_profile.h
+ * @brief   Clock operating points, derived peripheral settings and arbitration.
+ *
+ * Pure logic with no HAL or ThreadX dependency. Every operating point is a
+ * pair of IC dividers off the fixed 1.2 GHz PLL1: IC1 for the CPU and IC2 for
+ * the system bus (HCLK = IC2 / 4, all APB buses undivided). For each point
+ * this module re-derives what the fixed clock tree used to hardcode: the
+ * SPI5 prescaler for the SD card, the LPUART1 BRR, the I2C TIMINGR and the
+ * DWT cycles per microsecond. A point whose derived settings do not fit is
+ * rejected rather than applied.
+ *
+ * Pipeline phases state a demand per client; the effective profile is the
+ * highest demand, and LOW when nobody asks for anything.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#ifndef __APP_CLOCK_PROFILE_H
+#define __APP_CLOCK_PROFILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Fixed parts of the clock tree set up by App_SystemClock_Config(). */
+#define APP_CLOCK_PROFILE_AHB_DIVIDER     4U
+#define APP_CLOCK_PROFILE_CPU_MAX_HZ      600000000UL  /* VOS scale 1. */
+#define APP_CLOCK_PROFILE_SYS_MAX_HZ      400000000UL
+/* Peripheral targets the derived settings must hit. */
+#define APP_CLOCK_PROFILE_SPI5_MAX_HZ      25000000UL  /* SD SPI-mode limit. */
+#define APP_CLOCK_PROFILE_LPUART_BAUD         115200UL
+/* I2C1/I2C2 run 0x009034B6 at 100 MHz; other kernel clocks keep its
+ * SCL low/high and data setup times. */
+#define APP_CLOCK_PROFILE_I2C_SCLL_NS         1830UL
+#define APP_CLOCK_PROFILE_I2C_SCLH_NS          530UL
+#define APP_CLOCK_PROFILE_I2C_SCLDEL_NS        100UL
+
+/* Ordered by speed so the highest demand wins. */
+typedef enum {
+	APP_CLOCK_PROFILE_LOW = 0,  /* Idle gaps and I/O waits. */
+	APP_CLOCK_PROFILE_NOMINAL,  /* NPU epochs; the CPU mostly waits. */
+	APP_CLOCK_PROFILE_BOOST,    /* Capture, preprocess and baseline CV. */
+	APP_CLOCK_PROFILE_COUNT,
+} AppClockProfile_Id_t;
+
+typedef enum {
+	APP_CLOCK_CLIENT_CAMERA = 0,
+	APP_CLOCK_CLIENT_AI,
+	APP_CLOCK_CLIENT_BASELINE,
+	APP_CLOCK_CLIENT_COUNT,
+} AppClockProfile_Client_t;
+
+typedef struct {
+	uint32_t cpu_divider;  /* IC1 divider off PLL1. */
+	uint32_t sys_divider;  /* IC2 divider off PLL1. */
+} AppClockProfile_Point_t;
+
+typedef struct {
+	uint32_t cpu_hz;
+	uint32_t sys_hz;
+	uint32_t pclk_hz;            /* Kernel clock of SPI5, LPUART1 and I2C. */
+	uint32_t spi5_divider;       /* Power of two, 2..256. */
+	uint32_t spi5_hz;
+	uint32_t lpuart_brr;
+	uint32_t i2c_timing;
+	uint32_t dwt_cycles_per_us;
+} AppClockProfile_Derived_t;
+
+typedef struct {
+	AppClockProfile_Id_t demand[APP_CLOCK_CLIENT_COUNT];
+} AppClockProfile_Demand_t;
+
+/* Time and energy spent in each profile since the last reset. */
+typedef struct {
+	uint32_t dwell_ms[APP_CLOCK_PROFILE_COUNT];
+	uint64_t energy_uj[APP_CLOCK_PROFILE_COUNT];
+} AppClockProfile_Energy_t;
+
+/**
+ * @brief Work out the clocks and peripheral settings for one point.
+ * @retval false when a clock exceeds its limit or a peripheral setting
+ *         cannot be met; @p derived_ptr is then left unspecified.
+ */
+bool AppClockProfile_Derive(uint32_t pll1_hz,
+		const AppClockProfile_Point_t *point_ptr,
+		AppClockProfile_Derived_t *derived_ptr);
+
+/* Smallest power-of-two divider (2..256) keeping SCK at or below max_hz;
+ * 0 when none does. */
+uint32_t AppClockProfile_SpiDivider(uint32_t kernel_hz, uint32_t max_hz);
+
+/* LPUART BRR (256 * f / baud, rounded); 0 outside the valid register range. */
+uint32_t AppClockProfile_LpuartBrr(uint32_t kernel_hz, uint32_t baud);
+
+/* TIMINGR keeping the reference SCL timing; 0 when it does not fit. */
+uint32_t AppClockProfile_I2cTiming(uint32_t kernel_hz);
+
+void AppClockProfile_InitDemand(AppClockProfile_Demand_t *demand_ptr);
+
+/**
+ * @brief Record what one client needs from now on.
+ * @retval The client's previous demand, so a nested phase can restore it.
+ */
+AppClockProfile_Id_t AppClockProfile_SetDemand(
+		AppClockProfile_Demand_t *demand_ptr, AppClockProfile_Client_t client,
+		AppClockProfile_Id_t profile);
+
+/* Highest demand across clients. */
+AppClockProfile_Id_t AppClockProfile_Effective(
+		const AppClockProfile_Demand_t *demand_ptr);
+
+/* Add dwell_ms spent in @p profile at power_mw to its totals. */
+void AppClockProfile_Account(AppClockProfile_Energy_t *energy_ptr,
+		AppClockProfile_Id_t profile, uint32_t dwell_ms, uint32_t power_mw);
+
+const char *AppClockProfile_Name(AppClockProfile_Id_t profile);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_CLOCK_PROFILE_H */
@@ -0,0 +1,55 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_clocks.h
+ * @brief   Phase-driven CPU and bus clock profile switching.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#ifndef __APP_CLOCKS_H
+#define __APP_CLOCKS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "tx_api.h"
+#include "app_clock_profile.h"
+
+/**
+ * @brief Derive the profile table and create the switch mutex.
+ *
+ * Must run before any thread calls AppClocks_SetDemand(); the board stays
+ * at the boost point it booted with until then.
+ * @retval TX_SUCCESS, TX_NOT_AVAILABLE when a profile does not derive, or
+ *         the tx_mutex_create status.
+ */
+UINT AppClocks_Init(void);
+
+/**
+ * @brief State what one pipeline phase needs and apply the new effective
+ *        profile.
+ *
+ * A bus change waits until the console, I2C, SD SPI, the DCMIPP pipes, the
+ * NPU and xSPI2 are idle; when one is busy the switch is deferred to the
+ * next demand change.
+ * @retval The client's previous demand, for restoring after a nested phase.
+ */
+AppClockProfile_Id_t AppClocks_SetDemand(AppClockProfile_Client_t client,
+		AppClockProfile_Id_t profile);
+
+AppClockProfile_Id_t AppClocks_GetActiveProfile(void);
+
+/* Log time and energy per profile since the previous call; call once per
+ * reading so each line is the cost of one reading. */
+void AppClocks_LogEnergyPerReading(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_CLOCKS_H */
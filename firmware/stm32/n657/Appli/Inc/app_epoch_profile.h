@@ -0,0 +1,68 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_epoch_profile.h
+ * @brief   Per-epoch timing profile of one NPU network.
+ *
+ * Pure logic with no HAL, ThreadX or BSP dependency. The inference loop
+ * marks the end of every pass through LL_ATON_RT_RunEpochBlock (including
+ * any wait for the epoch interrupt); the profile keeps min/avg/max time per
+ * epoch step across runs. tools/weight_placement.py reads the printed
+ * profile to rank weight tensors by the flash stall they cause, and a later
+ * profile confirms the predicted gain.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#ifndef __APP_EPOCH_PROFILE_H
+#define __APP_EPOCH_PROFILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define APP_EPOCH_PROFILE_MAX_EPOCHS  160U
+
+typedef struct {
+	uint32_t count;
+	uint32_t min_us;
+	uint32_t max_us;
+	uint64_t total_us;
+} AppEpochProfile_Stat_t;
+
+typedef struct {
+	AppEpochProfile_Stat_t epochs[APP_EPOCH_PROFILE_MAX_EPOCHS];
+	uint32_t epoch_count;  /* Highest epoch step seen + 1. */
+	uint32_t run_count;    /* Completed runs. */
+	uint32_t dropped;      /* Epoch steps past the table. */
+	uint32_t cursor;       /* Next epoch step in the current run. */
+	uint64_t last_mark_us;
+	bool in_run;
+} AppEpochProfile_t;
+
+void AppEpochProfile_Init(AppEpochProfile_t *profile_ptr);
+
+void AppEpochProfile_BeginRun(AppEpochProfile_t *profile_ptr, uint64_t now_us);
+
+/** @brief Close the current epoch step at now_us and open the next one. */
+void AppEpochProfile_Mark(AppEpochProfile_t *profile_ptr, uint64_t now_us);
+
+/**
+ * @brief Finish a run. An aborted run is discarded from run_count but its
+ * epoch samples are kept.
+ */
+void AppEpochProfile_EndRun(AppEpochProfile_t *profile_ptr, bool completed);
+
+uint32_t AppEpochProfile_AverageUs(const AppEpochProfile_Stat_t *stat_ptr);
+
+/** @brief Sum of the per-epoch averages, i.e. the profiled run time. */
+uint64_t AppEpochProfile_TotalAverageUs(const AppEpochProfile_t *profile_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_EPOCH_PROFILE_H */
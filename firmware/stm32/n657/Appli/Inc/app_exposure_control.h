@@ -0,0 +1,113 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_exposure_control.h
+ * @brief   Model-based one-shot exposure/gain correction for the IMX335 path.
+ *
+ * Pure logic with no HAL, ThreadX or middleware dependency so the controller
+ * can run against a simulated sensor in the host unit tests.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#ifndef __APP_EXPOSURE_CONTROL_H
+#define __APP_EXPOSURE_CONTROL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define APP_EXPOSURE_CONTROL_HISTOGRAM_BINS  256U
+
+/**
+ * @brief Sensor exposure and gain, in the units the camera middleware uses.
+ */
+typedef struct {
+	uint32_t exposure_us;
+	int32_t gain_mdb;
+} AppExposureControl_Setting_t;
+
+typedef struct {
+	uint32_t exposure_min_us;
+	uint32_t exposure_max_us;
+	int32_t gain_min_mdb;
+	int32_t gain_max_mdb;
+} AppExposureControl_Limits_t;
+
+/**
+ * @brief Controller tunables.
+ */
+typedef struct {
+	float target_mean;     /* Desired luma mean over the gate crop. */
+	float response_gamma;  /* Assumed luma ~ (exposure x gain)^(1/gamma). */
+	float second_step_damping; /* Fraction of the log correction applied on
+	                            * later steps; 1.0 applies all of it. */
+	float max_step_ratio;  /* Largest exposure x gain change in one step. */
+} AppExposureControl_Config_t;
+
+/**
+ * @brief Luma summary taken from the rejected frame's histogram.
+ */
+typedef struct {
+	uint32_t sample_count;
+	float mean;
+	float clipped_high_fraction;
+	float clipped_low_fraction;
+} AppExposureControl_Measurement_t;
+
+typedef struct {
+	AppExposureControl_Config_t config;
+	AppExposureControl_Limits_t limits;
+	uint32_t step_count;
+	bool has_previous;
+	float previous_total;  /* exposure x linear gain of the previous frame. */
+	float previous_mean;
+	bool previous_clipped;
+	float estimated_gamma; /* Refined from consecutive frames when possible. */
+} AppExposureControl_Context_t;
+
+void AppExposureControl_Init(AppExposureControl_Context_t *context_ptr,
+		const AppExposureControl_Config_t *config_ptr,
+		const AppExposureControl_Limits_t *limits_ptr);
+
+/* Summarize a 256-bin luma histogram for the controller. */
+bool AppExposureControl_Measure(const uint32_t *histogram_ptr,
+		AppExposureControl_Measurement_t *measurement_out);
+
+/**
+ * @brief Compute the exposure/gain for the next frame.
+ *
+ * The first call scales exposure x gain by (target/mean)^gamma in one step.
+ * Later calls refine gamma from the last two frames (when neither was
+ * clipped) and apply a damped correction so a model mismatch does not
+ * oscillate around the target.
+ *
+ * @param context_ptr Controller state for the current capture request.
+ * @param measurement_ptr Luma summary of the rejected frame.
+ * @param current_ptr Exposure/gain the rejected frame was captured with.
+ * @param next_out Receives the setting for the next frame.
+ * @retval false when the sensor is already at the limit in the needed
+ *         direction, so another frame would not change anything.
+ */
+bool AppExposureControl_ComputeNext(AppExposureControl_Context_t *context_ptr,
+		const AppExposureControl_Measurement_t *measurement_ptr,
+		const AppExposureControl_Setting_t *current_ptr,
+		AppExposureControl_Setting_t *next_out);
+
+/* Exposure x linear gain, the quantity the sensor response depends on. */
+float AppExposureControl_TotalFromSetting(
+		const AppExposureControl_Setting_t *setting_ptr);
+
+/* Split a total back into exposure first, then gain, within the limits. */
+void AppExposureControl_SettingFromTotal(
+		const AppExposureControl_Limits_t *limits_ptr, float total,
+		AppExposureControl_Setting_t *setting_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_EXPOSURE_CONTROL_H */
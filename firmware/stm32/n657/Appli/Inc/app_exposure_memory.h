@@ -0,0 +1,96 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_exposure_memory.h
+ * @brief   Accepted IMX335 exposure/gain remembered per time-of-day bucket.
+ *
+ * Pure logic with no HAL, ThreadX or FileX dependency. The table is a flat
+ * CRC-sealed struct so the caller can persist it as-is and reject a torn or
+ * stale-format copy on load.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#ifndef __APP_EXPOSURE_MEMORY_H
+#define __APP_EXPOSURE_MEMORY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define APP_EXPOSURE_MEMORY_MAGIC          0x314D5845UL /* "EXM1" */
+#define APP_EXPOSURE_MEMORY_BUCKET_MINUTES 60U
+#define APP_EXPOSURE_MEMORY_BUCKET_COUNT   (1440U / APP_EXPOSURE_MEMORY_BUCKET_MINUTES)
+/* A stored setting this close to the new one is not worth an SD write. */
+#define APP_EXPOSURE_MEMORY_EXPOSURE_TOLERANCE_PERCENT 20U
+#define APP_EXPOSURE_MEMORY_GAIN_TOLERANCE_MDB       2000
+
+/**
+ * @brief Wall-clock position of a capture, decoded from the RTC.
+ */
+typedef struct {
+	uint32_t date_code;     /* YYYYMMDD. */
+	uint32_t minute_of_day; /* 0..1439. */
+} AppExposureMemory_Time_t;
+
+typedef struct {
+	uint32_t date_code;     /* 0 when the bucket has never been filled. */
+	uint32_t exposure_us;
+	int32_t gain_mdb;
+} AppExposureMemory_Entry_t;
+
+typedef struct {
+	uint32_t magic;
+	uint32_t bucket_count;
+	AppExposureMemory_Entry_t entries[APP_EXPOSURE_MEMORY_BUCKET_COUNT];
+	uint32_t crc32;         /* Over every field above. */
+} AppExposureMemory_Table_t;
+
+/* Reset to an empty, sealed table. */
+void AppExposureMemory_Init(AppExposureMemory_Table_t *table_ptr);
+
+/* Check magic, layout and CRC of a table read back from storage. */
+bool AppExposureMemory_IsValid(const AppExposureMemory_Table_t *table_ptr);
+
+/* Recompute the CRC after editing entries. */
+void AppExposureMemory_Seal(AppExposureMemory_Table_t *table_ptr);
+
+/**
+ * @brief Decode an RTC timestamp such as "2026-03-14_18-05-00".
+ *
+ * Accepts the capture-filename form and the raw "YYYY-MM-DD HH:MM:SS" form.
+ */
+bool AppExposureMemory_ParseTimestamp(const char *text_ptr,
+		AppExposureMemory_Time_t *time_out);
+
+/**
+ * @brief Find the remembered setting for this time of day.
+ *
+ * The capture's own bucket wins; otherwise the nearer neighbouring bucket is
+ * used, since lighting rarely changes much within an hour. Entries older than
+ * @p max_age_days, or dated after @p time_ptr (RTC was reset), are ignored.
+ * @retval true when a setting was found.
+ */
+bool AppExposureMemory_Lookup(const AppExposureMemory_Table_t *table_ptr,
+		const AppExposureMemory_Time_t *time_ptr, uint32_t max_age_days,
+		uint32_t *exposure_us_out, int32_t *gain_mdb_out);
+
+/**
+ * @brief Remember the setting of an accepted frame in its bucket.
+ *
+ * A setting within the exposure/gain tolerance of the stored one on the same
+ * day leaves the entry untouched.
+ * @retval true when the entry was updated and the table should be persisted.
+ */
+bool AppExposureMemory_Store(AppExposureMemory_Table_t *table_ptr,
+		const AppExposureMemory_Time_t *time_ptr, uint32_t exposure_us,
+		int32_t gain_mdb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_EXPOSURE_MEMORY_H */
@@ -58,6 +58,7 @@ FX_MEDIA *AppFileX_GetMediaHandle(void);
 const CHAR *AppFileX_GetCapturedImagesDirectoryName(void);
 UINT AppFileX_AcquireMediaLock(void);
 void AppFileX_ReleaseMediaLock(void);
+void AppFileX_AlignNextAllocationLocked(void);
 UINT AppFileX_PrepareCaptureSlots(void);
 UINT AppFileX_GetNextCapturedImageName(CHAR *file_name_ptr,
 		ULONG file_name_length, const CHAR *file_extension_ptr);
@@ -0,0 +1,70 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_frame_format.h
+ * @brief   Pixel layout of captured frames (packed YUV422 or luma-only Y8).
+ *
+ * Pure helpers with no HAL dependency. Consumers derive the layout from the
+ * frame length they were handed rather than from a global setting, so a
+ * format switch between captures can never reinterpret a frame that is
+ * already queued for inference, the baseline or the SD writer.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#ifndef __APP_FRAME_FORMAT_H
+#define __APP_FRAME_FORMAT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum {
+	/* DCMIPP YUV422_1 packing: Y0 U Y1 V per pixel pair. */
+	APP_FRAME_FORMAT_YUV422 = 0,
+	/* DCMIPP MONO_Y8 packing: one luma byte per pixel. */
+	APP_FRAME_FORMAT_Y8 = 1,
+} AppFrameFormat_t;
+
+/* Chroma value reported for Y8 frames; reads as neutral grey. */
+#define APP_FRAME_FORMAT_NEUTRAL_CHROMA 128U
+
+uint32_t AppFrameFormat_BytesPerPixel(AppFrameFormat_t format);
+
+size_t AppFrameFormat_FrameBytes(AppFrameFormat_t format, size_t width_pixels,
+		size_t height_pixels);
+
+/**
+ * @brief Infer the layout of a frame from its length.
+ *
+ * A full YUV422 frame is twice the Y8 size, so the length alone tells them
+ * apart. @retval false when the length covers neither layout.
+ */
+bool AppFrameFormat_FromLength(size_t width_pixels, size_t height_pixels,
+		size_t length_bytes, AppFrameFormat_t *format_out);
+
+/* Byte offset of the luma sample for pixel (x, y). */
+size_t AppFrameFormat_LumaOffset(AppFrameFormat_t format, size_t width_pixels,
+		size_t x, size_t y);
+
+/* SD archive extension, without the dot. */
+const char *AppFrameFormat_FileExtension(AppFrameFormat_t format);
+
+/**
+ * @brief Parse a deployment selection such as "y8" or "yuv422".
+ *
+ * Case-insensitive; leading and trailing whitespace is ignored so a file
+ * edited on a PC with a trailing CRLF still parses.
+ */
+bool AppFrameFormat_Parse(const char *text_ptr, size_t length,
+		AppFrameFormat_t *format_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_FRAME_FORMAT_H */
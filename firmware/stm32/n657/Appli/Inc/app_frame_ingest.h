@@ -0,0 +1,121 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_frame_ingest.h
+ * @brief   One-pass summary of an accepted capture for every frame consumer.
+ *
+ * Pure logic with no HAL dependency. The capture path walks the accepted
+ * frame once and records what the chroma summary, the AI frame signature
+ * and the baseline brightness profile each used to compute with a full pass
+ * of their own: the non-zero byte count, luma sum, range and histogram,
+ * chroma means and ranges, a 64-bit content hash, the training-crop
+ * brightness profile and a block-mean luma thumbnail.
+ *
+ * The descriptor remembers which buffer and length it describes, so a
+ * consumer handed a different buffer can tell and fall back to its own scan.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#ifndef __APP_FRAME_INGEST_H
+#define __APP_FRAME_INGEST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "app_frame_format.h"
+
+#define APP_FRAME_INGEST_HISTOGRAM_BINS     256U
+/* Each thumbnail pixel is the luma mean of one block x block tile. */
+#define APP_FRAME_INGEST_THUMBNAIL_BLOCK    8U
+#define APP_FRAME_INGEST_THUMBNAIL_MAX_SIDE 32U
+
+/* Brightness-profile region: every crop_step-th pixel of every
+ * crop_step-th row of the crop, counting luma >= crop_bright_level. */
+typedef struct {
+	uint32_t crop_x_min;
+	uint32_t crop_y_min;
+	uint32_t crop_x_end;  /* Exclusive. */
+	uint32_t crop_y_end;  /* Exclusive. */
+	uint32_t crop_step;
+	uint8_t crop_bright_level;
+} AppFrameIngest_Config_t;
+
+typedef struct {
+	bool valid;
+	const uint8_t *frame_ptr;
+	uint32_t length_bytes;
+	AppFrameFormat_t format;
+	uint32_t width_pixels;
+	uint32_t height_pixels;
+
+	uint32_t nonzero_bytes;
+	uint64_t content_hash;
+
+	uint32_t luma_count;
+	uint64_t luma_sum;
+	uint8_t min_y;
+	uint8_t max_y;
+	uint32_t luma_histogram[APP_FRAME_INGEST_HISTOGRAM_BINS];
+
+	/* Zero for Y8 frames. */
+	uint32_t chroma_pair_count;
+	uint64_t u_sum;
+	uint64_t v_sum;
+	uint8_t min_u;
+	uint8_t max_u;
+	uint8_t min_v;
+	uint8_t max_v;
+
+	AppFrameIngest_Config_t crop;
+	uint32_t crop_sample_count;
+	uint32_t crop_bright_count;
+	uint64_t crop_luma_sum;
+
+	/* Zero-sized when the frame is wider or taller than the thumbnail
+	 * can hold. */
+	uint32_t thumbnail_width;
+	uint32_t thumbnail_height;
+	uint8_t thumbnail[APP_FRAME_INGEST_THUMBNAIL_MAX_SIDE
+			* APP_FRAME_INGEST_THUMBNAIL_MAX_SIDE];
+} AppFrameIngest_Descriptor_t;
+
+/**
+ * @brief Summarize a packed YUV422 or Y8 frame in a single pass.
+ *
+ * The frame format is inferred from the length, and every statistic,
+ * including the hash, covers the frame's pixel bytes only. The crop must lie
+ * inside the frame; an empty crop leaves the brightness profile at zero.
+ * @retval false when the length matches neither format or the crop does
+ *         not fit; the descriptor is then marked invalid.
+ */
+bool AppFrameIngest_Run(const uint8_t *frame_ptr, size_t length_bytes,
+		size_t width_pixels, size_t height_pixels,
+		const AppFrameIngest_Config_t *config_ptr,
+		AppFrameIngest_Descriptor_t *descriptor_out);
+
+/**
+ * @brief Content hash the ingest pass records, computed on its own.
+ *
+ * 64-bit FNV-1a over little-endian 32-bit words, with any tail bytes
+ * folded in one at a time.
+ */
+uint64_t AppFrameIngest_Hash(const uint8_t *bytes, size_t length_bytes);
+
+/**
+ * @brief True when @p descriptor_ptr is a valid summary of exactly this
+ *        buffer and length.
+ */
+bool AppFrameIngest_Describes(const AppFrameIngest_Descriptor_t *descriptor_ptr,
+		const uint8_t *frame_ptr, size_t length_bytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_FRAME_INGEST_H */
@@ -23,6 +23,12 @@ UINT AppInferenceRuntime_Init(void);
 UINT AppInferenceRuntime_Start(void);
 bool AppInferenceRuntime_RequestDryInference(const uint8_t *frame_ptr,
 		ULONG frame_length);
+/* Sequence number of the most recently accepted dry-run request. */
+uint32_t AppInferenceRuntime_GetLastRequestSequence(void);
+/* Block until the given request finishes; reports whether a reading was
+ * published (false means the frame ended as a no-read). */
+bool AppInferenceRuntime_WaitForRequestOutcome(uint32_t request_sequence,
+		uint32_t timeout_ms, bool *reading_published_ptr);
 
 #ifdef __cplusplus
 }
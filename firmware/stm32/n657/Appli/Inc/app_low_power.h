@@ -0,0 +1,85 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_low_power.h
+ * @brief   Tickless idle hooks, coalesced service wake-ups and peripheral
+ *          power domains for ThreadX.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#ifndef __APP_LOW_POWER_H
+#define __APP_LOW_POWER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "tx_api.h"
+#include "app_power_domain.h"
+
+/**
+ * @brief Idle residency counters collected by the scheduler idle hooks.
+ */
+typedef struct {
+	uint32_t idle_entry_count;     /* Times the scheduler reached idle. */
+	uint32_t tickless_entry_count; /* Idle entries that stopped SysTick. */
+	uint32_t timer_wake_count;     /* Tickless windows ended by the wake timer. */
+	uint32_t early_wake_count;     /* Tickless windows ended by another IRQ. */
+	uint32_t tickless_ms;          /* Total time spent with SysTick stopped. */
+	uint32_t longest_tickless_ms;  /* Longest single tickless window. */
+	uint32_t suppressed_tick_count;/* ThreadX ticks replayed after wake-up. */
+} AppLowPower_Stats_t;
+
+/* Enable or disable tickless idle at runtime; plain WFI idle stays active. */
+void AppLowPower_SetTicklessEnabled(bool enabled);
+
+void AppLowPower_GetStats(AppLowPower_Stats_t *stats_ptr);
+void AppLowPower_LogStats(void);
+
+/**
+ * @brief Convert a service period into a timeout that ends on the shared
+ *        wake-up grid.
+ *
+ * The returned tick count is at least the requested delay and ends on the
+ * next multiple of APP_LOW_POWER_COALESCE_MS, so services polling on
+ * different periods share one wake-up instead of fragmenting idle time.
+ *
+ * @param delay_ms Minimum delay in milliseconds.
+ * @retval Timeout in ThreadX ticks.
+ */
+ULONG AppLowPower_CoalescedTimeoutTicks(uint32_t delay_ms);
+
+/* Sleep for at least delay_ms, waking on the shared grid. */
+void AppLowPower_SleepCoalesced(uint32_t delay_ms);
+
+/**
+ * @brief Register the NPU, xSPI2, DCMIPP/CSI and SD SPI clock gates.
+ *
+ * Call once before the threads start. Each domain stays in its boot state
+ * until its first release.
+ * @retval TX_SUCCESS, or the status of the deferred-gate timer creation.
+ */
+UINT AppLowPower_InitDomains(void);
+
+/**
+ * @brief Hold a peripheral domain ungated while the caller uses it.
+ * @retval false when no reference was taken; do not release it then.
+ */
+bool AppLowPower_AcquireDomain(AppPowerDomain_Id_t id);
+
+/* Drop a reference; the domain gates after its minimum off time. */
+void AppLowPower_ReleaseDomain(AppPowerDomain_Id_t id);
+
+/* ThreadX idle hooks, called from tx_thread_schedule with interrupts masked. */
+void tx_low_power_enter(void);
+void tx_low_power_exit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_LOW_POWER_H */
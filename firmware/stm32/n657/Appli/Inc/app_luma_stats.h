@@ -0,0 +1,89 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_luma_stats.h
+ * @brief   Luma summaries for the capture brightness gate.
+ *
+ * Pure logic with no HAL or middleware dependency. A summary comes either
+ * from the DCMIPP statistics the ISP library already gathers for AEC (read
+ * in O(1) after frame end) or from a strided CPU sample of the frame's
+ * training crop when those counters are not fresh.
+ *
+ * The hardware bins are cumulative threshold counts rather than disjoint
+ * buckets, so min, max and the bright-pixel count derived from them are
+ * bounds. They are always rounded the way that makes the gate less likely
+ * to reject: max_y up, min_y down and the bright count down.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#ifndef __APP_LUMA_STATS_H
+#define __APP_LUMA_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* ISP_StatisticsTypeDef.histogram layout from the DCMIPP bins modes:
+ * [0..5] count luma < 4, 8, 16, 32, 64, 128 and [6..11] count luma > 127,
+ * 191, 224, 239, 247, 251. */
+#define APP_LUMA_STATS_ISP_BINS       12U
+#define APP_LUMA_STATS_HISTOGRAM_BINS 256U
+
+typedef struct {
+	uint32_t sample_count;
+	uint32_t bright_sample_count;
+	uint8_t min_y;
+	uint8_t max_y;
+	uint32_t mean_y;
+} AppLumaStats_t;
+
+/* Pixel region of a packed frame to sample; luma is the first byte of
+ * each pixel. */
+typedef struct {
+	uint32_t width_pixels;
+	uint32_t bytes_per_pixel;
+	uint32_t x_min;
+	uint32_t y_min;
+	uint32_t x_end;  /* Exclusive. */
+	uint32_t y_end;  /* Exclusive. */
+} AppLumaStats_Region_t;
+
+/**
+ * @brief Summarize the ISP luma average and threshold bins.
+ *
+ * Counts are scaled down together when needed so the gate's percentage
+ * arithmetic cannot overflow.
+ * @param mean_y       ISP luma average over the statistics window.
+ * @param bright_level Luma at and above which a pixel counts as bright.
+ * @retval false when the bins are empty or inconsistent.
+ */
+bool AppLumaStats_FromIspBins(const uint32_t bins[APP_LUMA_STATS_ISP_BINS],
+		uint8_t mean_y, uint8_t bright_level, AppLumaStats_t *stats_ptr);
+
+/**
+ * @brief Sample every step-th pixel of every step-th row of a region.
+ *
+ * step 4 reads 1/16 of the pixels; step 1 is the full scan.
+ * @param histogram_ptr Optional 256-bin histogram to fill, or NULL.
+ * @retval false when the region does not fit in the frame or is empty.
+ */
+bool AppLumaStats_SampleRegion(const uint8_t *frame_ptr, size_t length_bytes,
+		const AppLumaStats_Region_t *region_ptr, uint32_t step,
+		uint8_t bright_level, AppLumaStats_t *stats_ptr,
+		uint32_t *histogram_ptr);
+
+/* True when any stride-th 32-bit word of the buffer is non-zero. Stops at
+ * the first hit, so a live frame costs a handful of reads. */
+bool AppLumaStats_AnyNonZero(const uint8_t *buffer_ptr, size_t length_bytes,
+		uint32_t stride_words);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_LUMA_STATS_H */
@@ -22,6 +22,8 @@ extern "C" {
 #define INFERENCE_LOG_QUEUE_DEPTH               8U
 
 #define CAMERA_INIT_THREAD_STACK_SIZE_BYTES     16384U
+/* Runs App_AI_Model_Init(), which used to run on the camera init stack. */
+#define BOOT_AI_THREAD_STACK_SIZE_BYTES         16384U
 #define CAMERA_ISP_THREAD_STACK_SIZE_BYTES      4096U
 #define CAMERA_HEARTBEAT_THREAD_STACK_SIZE_BYTES 1024U
 /* Keep the AI worker stack large enough for the OBB->UNet cascade while
@@ -29,6 +31,7 @@ extern "C" {
 #define CAMERA_AI_THREAD_STACK_SIZE_BYTES      16384U
 #define BASELINE_RUNTIME_THREAD_STACK_SIZE_BYTES 16384U
 #define IMAGE_CLEANUP_THREAD_STACK_SIZE_BYTES    4096U
+#define CAPTURE_STORAGE_THREAD_STACK_SIZE_BYTES  8192U
 
 /* Capture geometry --------------------------------------------------------- */
 /* Standardize the live capture budget on 224x224 so the AI and baseline
@@ -36,8 +39,15 @@ extern "C" {
 #define CAMERA_CAPTURE_WIDTH_PIXELS             224U
 #define CAMERA_CAPTURE_HEIGHT_PIXELS            224U
 #define CAMERA_CAPTURE_BUFFER_COUNT             1U
+/* Buffers are sized for YUV422; a Y8 capture (app_frame_format.h) fills
+ * only the first half. */
 #define CAMERA_CAPTURE_BYTES_PER_PIXEL          2U
 #define CAMERA_CAPTURE_BUFFER_SIZE_BYTES        (CAMERA_CAPTURE_WIDTH_PIXELS * CAMERA_CAPTURE_HEIGHT_PIXELS * CAMERA_CAPTURE_BYTES_PER_PIXEL)
+/* RGB888 frame of the ancillary NN pipe at the first stage's input size. */
+#define CAMERA_NN_FRAME_WIDTH_PIXELS            224U
+#define CAMERA_NN_FRAME_HEIGHT_PIXELS           224U
+#define CAMERA_NN_FRAME_BYTES_PER_PIXEL         3U
+#define CAMERA_NN_FRAME_SIZE_BYTES              (CAMERA_NN_FRAME_WIDTH_PIXELS * CAMERA_NN_FRAME_HEIGHT_PIXELS * CAMERA_NN_FRAME_BYTES_PER_PIXEL)
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,119 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_nn_pipe.h
+ * @brief   Layout and quantization of the ancillary DCMIPP NN pipe frame.
+ *
+ * Pure logic with no HAL, ThreadX or BSP dependency. The main pipe keeps
+ * writing the YUV422 frame for the baseline and the archive; the ancillary
+ * pipe takes the same exposure, crops it to the training window in sensor
+ * coordinates, downsizes it and packs RGB888 at the model resolution. The
+ * image lands letterboxed in a model-sized buffer exactly where the CPU
+ * resize put it, so the AI side is left with a per-byte quantization pass.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#ifndef __APP_NN_PIPE_H
+#define __APP_NN_PIPE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define APP_NN_PIPE_BYTES_PER_PIXEL  3U
+
+typedef struct {
+	/* Sensor window the main pipe scales onto the capture frame. */
+	uint32_t window_x;
+	uint32_t window_y;
+	uint32_t window_width;
+	uint32_t window_height;
+	/* Capture frame the crop is expressed in. */
+	uint32_t frame_width;
+	uint32_t frame_height;
+	uint32_t crop_x;
+	uint32_t crop_y;
+	uint32_t crop_width;
+	uint32_t crop_height;
+	/* Model input and the pipe's pitch/address alignment. */
+	uint32_t model_width;
+	uint32_t model_height;
+	uint32_t align_bytes;
+} AppNnPipe_Request_t;
+
+typedef struct {
+	/* Pipe crop in sensor coordinates. */
+	uint32_t roi_x;
+	uint32_t roi_y;
+	uint32_t roi_width;
+	uint32_t roi_height;
+	/* Downsized image and where it sits in the model-sized buffer. */
+	uint32_t output_width;
+	uint32_t output_height;
+	uint32_t pad_x;
+	uint32_t pad_y;
+	uint32_t pitch_bytes;
+	uint32_t write_offset_bytes;
+	uint32_t tensor_bytes;
+	uint32_t model_width;
+	uint32_t model_height;
+} AppNnPipe_Layout_t;
+
+typedef enum {
+	APP_NN_PIPE_OK = 0,
+	APP_NN_PIPE_BAD_REQUEST,
+	APP_NN_PIPE_PITCH_UNALIGNED,  /* Model row is not a whole pitch unit. */
+	APP_NN_PIPE_OFFSET_UNALIGNED, /* Letterbox start is not DMA aligned. */
+} AppNnPipe_Status_t;
+
+typedef enum {
+	APP_NN_PIPE_QUANT_COPY = 0, /* uint8 tensor, scale 1/255, zero point 0. */
+	APP_NN_PIPE_QUANT_FLIP_SIGN, /* int8 tensor, scale 1/255, zero point -128. */
+	APP_NN_PIPE_QUANT_TABLE,
+} AppNnPipe_QuantKind_t;
+
+typedef struct {
+	AppNnPipe_QuantKind_t kind;
+	uint8_t table[256];
+} AppNnPipe_Quant_t;
+
+/* One NN pipe image and the capture frame it was taken with. */
+typedef struct {
+	bool valid;
+	const uint8_t *image_ptr;
+	const uint8_t *source_frame_ptr;
+	AppNnPipe_Layout_t layout;
+} AppNnPipe_Frame_t;
+
+/**
+ * @brief Plan the pipe crop and the letterbox with the same rounding as
+ * the CPU resize (scale to fit, centred, padding at the zero point).
+ */
+AppNnPipe_Status_t AppNnPipe_PlanLayout(const AppNnPipe_Request_t *request_ptr,
+		AppNnPipe_Layout_t *layout_ptr);
+
+/**
+ * @brief Build the byte map for q = round(v / 255 / scale) + zero_point,
+ * clamped to the tensor type; padding bytes (0) map to the zero point.
+ */
+void AppNnPipe_BuildQuant(float scale, int32_t zero_point, bool is_unsigned,
+		AppNnPipe_Quant_t *quant_ptr);
+
+/** @brief Quantize an RGB888 image into the tensor; may run in place. */
+void AppNnPipe_Quantize(const AppNnPipe_Quant_t *quant_ptr,
+		const uint8_t *image_ptr, uint8_t *tensor_ptr, size_t length_bytes);
+
+const char *AppNnPipe_StatusName(AppNnPipe_Status_t status);
+
+const char *AppNnPipe_QuantKindName(AppNnPipe_QuantKind_t kind);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_NN_PIPE_H */
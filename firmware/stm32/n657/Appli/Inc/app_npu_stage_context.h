@@ -0,0 +1,131 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_npu_stage_context.h
+ * @brief   Init-once bookkeeping for the NPU execution context of each stage.
+ *
+ * Pure logic with no HAL, ThreadX or BSP dependency. A stage's network init
+ * only has to run once; between inferences the runtime just needs to be
+ * re-armed. The table remembers which stages hold a live context together
+ * with a signature of the instance fields that must not change while it is
+ * live, and tells the caller whether a cheap re-arm is enough or a full init
+ * is needed because the stage is new, was invalidated, or its signature no
+ * longer matches. Only the stage the NPU ran last can be re-armed: any other
+ * network's run rewrites the NPU state and the shared activation arena. It
+ * also keeps the init and re-arm timings per stage.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#ifndef __APP_NPU_STAGE_CONTEXT_H
+#define __APP_NPU_STAGE_CONTEXT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define APP_NPU_STAGE_CONTEXT_MAX_STAGES  8U
+
+typedef enum {
+	/* Context is live and intact: reset the epoch cursor only. */
+	APP_NPU_STAGE_CONTEXT_REARM = 0,
+	/* Run the network init, runtime init and inference init again. */
+	APP_NPU_STAGE_CONTEXT_FULL_INIT,
+} AppNpuStageContext_Action_t;
+
+typedef enum {
+	APP_NPU_STAGE_CONTEXT_REASON_NONE = 0,
+	APP_NPU_STAGE_CONTEXT_REASON_FIRST_USE,
+	/* Dropped by the caller, e.g. after an aborted run or a flash write. */
+	APP_NPU_STAGE_CONTEXT_REASON_INVALIDATED,
+	/* The signature changed while the context was live. */
+	APP_NPU_STAGE_CONTEXT_REASON_CORRUPTED,
+} AppNpuStageContext_Reason_t;
+
+typedef struct {
+	uint32_t count;
+	uint32_t last_us;
+	uint32_t max_us;
+	uint64_t total_us;
+} AppNpuStageContext_Timing_t;
+
+typedef struct {
+	const void *stage_key;        /* Stage spec address; NULL when free. */
+	uint32_t signature;
+	bool live;
+	uint32_t last_run_count;      /* NPU run counter after its last run. */
+	AppNpuStageContext_Reason_t last_reason;
+	uint32_t integrity_failures;
+	AppNpuStageContext_Timing_t init;
+	AppNpuStageContext_Timing_t rearm;
+} AppNpuStageContext_Entry_t;
+
+typedef struct {
+	AppNpuStageContext_Entry_t entries[APP_NPU_STAGE_CONTEXT_MAX_STAGES];
+	uint32_t entry_count;
+} AppNpuStageContext_Table_t;
+
+void AppNpuStageContext_Init(AppNpuStageContext_Table_t *table_ptr);
+
+/** @brief FNV-1a over the words that describe a live context. */
+uint32_t AppNpuStageContext_Signature(const uint32_t *words_ptr,
+		uint32_t word_count);
+
+/**
+ * @brief Decide how to prepare a stage for its next inference.
+ *
+ * Registers an unknown stage on first use. A live stage whose signature
+ * differs is counted as an integrity failure and dropped. When the table is
+ * full the stage is never cached and always needs a full init.
+ * @param reason_out Optional; set to why a full init is needed.
+ */
+AppNpuStageContext_Action_t AppNpuStageContext_Plan(
+		AppNpuStageContext_Table_t *table_ptr, const void *stage_key,
+		uint32_t signature, AppNpuStageContext_Reason_t *reason_out);
+
+/**
+ * @brief Record a completed full init and the signature it left behind.
+ * @retval false when the stage is not in the table.
+ */
+bool AppNpuStageContext_MarkInitialized(AppNpuStageContext_Table_t *table_ptr,
+		const void *stage_key, uint32_t signature, uint32_t elapsed_us);
+
+/** @retval false when the stage is not in the table. */
+bool AppNpuStageContext_RecordRearm(AppNpuStageContext_Table_t *table_ptr,
+		const void *stage_key, uint32_t elapsed_us);
+
+/**
+ * @brief Record that a stage's run finished.
+ * @param npu_run_count Global NPU run counter read after the run.
+ * @retval false when the stage is not in the table.
+ */
+bool AppNpuStageContext_RecordRun(AppNpuStageContext_Table_t *table_ptr,
+		const void *stage_key, uint32_t npu_run_count);
+
+/**
+ * @brief Drop every live stage whose last run is not the NPU's latest run.
+ * @param npu_run_count Global NPU run counter read now.
+ */
+void AppNpuStageContext_InvalidateDisplaced(
+		AppNpuStageContext_Table_t *table_ptr, uint32_t npu_run_count);
+
+/* Force the next use of a stage through a full init. */
+void AppNpuStageContext_Invalidate(AppNpuStageContext_Table_t *table_ptr,
+		const void *stage_key);
+
+void AppNpuStageContext_InvalidateAll(AppNpuStageContext_Table_t *table_ptr);
+
+/** @retval NULL when the stage is not in the table. */
+const AppNpuStageContext_Entry_t *AppNpuStageContext_Get(
+		const AppNpuStageContext_Table_t *table_ptr, const void *stage_key);
+
+const char *AppNpuStageContext_ReasonName(AppNpuStageContext_Reason_t reason);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_NPU_STAGE_CONTEXT_H */
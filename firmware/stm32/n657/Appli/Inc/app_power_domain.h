@@ -0,0 +1,119 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_power_domain.h
+ * @brief   Reference-counted gating for peripheral power domains.
+ *
+ * Pure logic with no HAL or ThreadX dependency. Each user of a block takes a
+ * reference for as long as it touches the hardware; the domain is ungated on
+ * the first acquire and only gated once the last reference has been released
+ * and the domain then stayed unused for its minimum off time. A domain that
+ * is re-acquired inside that window never toggles, so bursts of short uses
+ * (FileX sector I/O, back-to-back model stages) do not pay the re-enable.
+ *
+ * Domains start in whatever state boot left them and stay there until their
+ * first release, so code that runs before any owner opts in is unaffected.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#ifndef __APP_POWER_DOMAIN_H
+#define __APP_POWER_DOMAIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Returned by AppPowerDomain_Service() when no gate is waiting. */
+#define APP_POWER_DOMAIN_NONE_PENDING  UINT32_MAX
+
+typedef enum {
+	APP_POWER_DOMAIN_NPU = 0,  /* Neural-ART NPU and its CACHEAXI. */
+	APP_POWER_DOMAIN_XSPI2,    /* xSPI2 memory-mapped weight window. */
+	APP_POWER_DOMAIN_CAMERA,   /* DCMIPP and the CSI-2 receiver. */
+	APP_POWER_DOMAIN_SD_SPI,   /* SPI5 to the SD card. */
+	APP_POWER_DOMAIN_COUNT,
+} AppPowerDomain_Id_t;
+
+typedef struct {
+	/* Ungate the domain; returning false leaves it off and the acquire fails. */
+	bool (*enable)(void);
+	/* Park whatever must survive the gate; optional. */
+	void (*retain)(void);
+	/* Gate the domain. */
+	void (*disable)(void);
+	/* Unused time after the last release before the domain is gated. */
+	uint32_t min_off_ms;
+} AppPowerDomain_Hooks_t;
+
+typedef struct {
+	AppPowerDomain_Hooks_t hooks;
+	bool registered;
+	bool powered;
+	bool gate_pending;
+	uint32_t ref_count;
+	uint32_t released_ms;
+	uint32_t on_since_ms;
+	uint64_t on_time_ms;   /* Completed on-intervals only. */
+	uint32_t enable_count;
+	uint32_t gate_count;
+} AppPowerDomain_State_t;
+
+typedef struct {
+	AppPowerDomain_State_t domain[APP_POWER_DOMAIN_COUNT];
+} AppPowerDomain_Context_t;
+
+void AppPowerDomain_Init(AppPowerDomain_Context_t *context_ptr);
+
+/**
+ * @brief Attach the hooks for one domain.
+ * @param powered Whether boot left the domain clocked.
+ * @param now_ms  Current time, used to start the on-time account.
+ */
+void AppPowerDomain_Register(AppPowerDomain_Context_t *context_ptr,
+		AppPowerDomain_Id_t id, const AppPowerDomain_Hooks_t *hooks_ptr,
+		bool powered, uint32_t now_ms);
+
+/**
+ * @brief Take a reference, ungating the domain if it was off.
+ *
+ * A pending gate is cancelled without touching the hardware.
+ * @retval false when the domain is unknown or its enable hook failed; no
+ *         reference is held in that case.
+ */
+bool AppPowerDomain_Acquire(AppPowerDomain_Context_t *context_ptr,
+		AppPowerDomain_Id_t id, uint32_t now_ms);
+
+/**
+ * @brief Drop a reference; the last one starts the minimum-off window.
+ *
+ * A domain with no minimum off time is gated here directly.
+ */
+void AppPowerDomain_Release(AppPowerDomain_Context_t *context_ptr,
+		AppPowerDomain_Id_t id, uint32_t now_ms);
+
+/**
+ * @brief Gate every domain whose minimum-off window has run out.
+ * @retval Milliseconds until the next pending gate is due, or
+ *         APP_POWER_DOMAIN_NONE_PENDING when nothing is waiting.
+ */
+uint32_t AppPowerDomain_Service(AppPowerDomain_Context_t *context_ptr,
+		uint32_t now_ms);
+
+bool AppPowerDomain_IsPowered(const AppPowerDomain_Context_t *context_ptr,
+		AppPowerDomain_Id_t id);
+
+/* Total time the domain has been ungated, including the current interval. */
+uint64_t AppPowerDomain_OnTimeMs(const AppPowerDomain_Context_t *context_ptr,
+		AppPowerDomain_Id_t id, uint32_t now_ms);
+
+const char *AppPowerDomain_Name(AppPowerDomain_Id_t id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_POWER_DOMAIN_H */
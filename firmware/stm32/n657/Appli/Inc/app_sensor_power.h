@@ -0,0 +1,84 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_sensor_power.h
+ * @brief   Sensor power-state policy for the idle gap between captures.
+ *
+ * Pure logic with no HAL or ThreadX dependency. The camera thread asks which
+ * state to park the sensor in for the coming idle gap and how early it must
+ * start waking; after each capture it reports how long the wake actually
+ * took to the first valid frame. The deepest state whose measured wake
+ * still fits the gap wins, so a slow wake shrinks its own use instead of
+ * making a capture late.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#ifndef __APP_SENSOR_POWER_H
+#define __APP_SENSOR_POWER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum {
+	APP_SENSOR_POWER_STREAMING = 0, /* Sensor and ISP keep running. */
+	APP_SENSOR_POWER_STANDBY,       /* MODE_SELECT standby, registers kept. */
+	APP_SENSOR_POWER_OFF,           /* XCLR low and module disabled. */
+	APP_SENSOR_POWER_STATE_COUNT,
+} AppSensorPower_State_t;
+
+typedef struct {
+	/* Wake-to-first-frame estimate used until a wake has been measured. */
+	uint32_t initial_wake_ms[APP_SENSOR_POWER_STATE_COUNT];
+	/* Shortest idle gap worth entering each state for. */
+	uint32_t min_idle_ms[APP_SENSOR_POWER_STATE_COUNT];
+	/* Slack added to every wake estimate. */
+	uint32_t guard_ms;
+	/* Failed wakes before a state is no longer chosen; 0 never gives up. */
+	uint32_t max_wake_failures;
+} AppSensorPower_Config_t;
+
+typedef struct {
+	AppSensorPower_Config_t config;
+	uint32_t wake_estimate_ms[APP_SENSOR_POWER_STATE_COUNT];
+	uint32_t wake_count[APP_SENSOR_POWER_STATE_COUNT];
+	uint32_t wake_failures[APP_SENSOR_POWER_STATE_COUNT];
+	bool disabled[APP_SENSOR_POWER_STATE_COUNT];
+} AppSensorPower_Context_t;
+
+void AppSensorPower_Init(AppSensorPower_Context_t *context_ptr,
+		const AppSensorPower_Config_t *config_ptr);
+
+/**
+ * @brief Pick the deepest enabled state whose wake fits in @p idle_ms.
+ *
+ * STREAMING is always allowed and is the answer when nothing else fits.
+ */
+AppSensorPower_State_t AppSensorPower_Choose(
+		const AppSensorPower_Context_t *context_ptr, uint32_t idle_ms);
+
+/* How long before the capture deadline a wake from @p state must start. */
+uint32_t AppSensorPower_WakeLeadMs(const AppSensorPower_Context_t *context_ptr,
+		AppSensorPower_State_t state);
+
+/**
+ * @brief Fold one measured wake into the estimate for @p state.
+ *
+ * A slower wake than expected raises the estimate at once; faster ones pull
+ * it down a quarter of the way, so one lucky wake cannot make the next
+ * capture late. A failed wake counts toward disabling the state.
+ */
+void AppSensorPower_RecordWake(AppSensorPower_Context_t *context_ptr,
+		AppSensorPower_State_t state, bool success, uint32_t wake_ms);
+
+const char *AppSensorPower_StateName(AppSensorPower_State_t state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_SENSOR_POWER_H */
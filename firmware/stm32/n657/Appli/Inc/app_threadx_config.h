@@ -16,10 +16,12 @@ extern "C" {
 
 /* Thread priorities -------------------------------------------------------- */
 #define CAMERA_INIT_THREAD_PRIORITY          9U
+#define BOOT_AI_THREAD_PRIORITY              9U  /* Peer of camera init so both lanes share the CPU */
 #define CAMERA_ISP_THREAD_PRIORITY          11U
 #define CAMERA_HEARTBEAT_THREAD_PRIORITY    10U
 #define CAMERA_AI_THREAD_PRIORITY           11U  /* Above BASELINE (12) so AI always gets CPU */
 #define BASELINE_RUNTIME_THREAD_PRIORITY    12U
+#define CAPTURE_STORAGE_THREAD_PRIORITY     14U  /* Below AI/baseline: SD save is archival only */
 #define IMAGE_CLEANUP_THREAD_PRIORITY       16U
 
 /* Heartbeat timing --------------------------------------------------------- */
@@ -33,9 +35,79 @@ extern "C" {
  * save path is no longer the bottleneck. */
 #define CAMERA_CAPTURE_PERIOD_MS           60000U
 
+/* Adaptive cadence: stretch the period while readings sit flat and shrink it
+ * toward the floor when they move or approach an alarm threshold. Set
+ * CAMERA_CAPTURE_ADAPTIVE_SCHEDULE_ENABLED to 0 for the fixed period above. */
+#define CAMERA_CAPTURE_ADAPTIVE_SCHEDULE_ENABLED   1U
+#define CAMERA_CAPTURE_PERIOD_MIN_MS              15000U
+#define CAMERA_CAPTURE_PERIOD_MAX_MS             900000U
+/* Rates are in gauge units (deg C) per minute. */
+#define CAMERA_CAPTURE_STABLE_RATE_PER_MIN         0.05f
+#define CAMERA_CAPTURE_FAST_RATE_PER_MIN           0.50f
+#define CAMERA_CAPTURE_ALARM_ENABLED               0U
+#define CAMERA_CAPTURE_ALARM_LOW                   0.0f
+#define CAMERA_CAPTURE_ALARM_HIGH                 80.0f
+#define CAMERA_CAPTURE_ALARM_MARGIN                5.0f
+/* Captures allowed per RTC calendar day (24 h from boot while the RTC is
+ * unreadable). Whatever is left is spread over the rest of the day, so quiet
+ * hours bank captures for later excursions. The default is twice the old
+ * fixed cadence. */
+#define CAMERA_CAPTURE_DAILY_BUDGET              2880U
+/* How long the capture thread waits for this cycle's reading before it
+ * schedules the next wake without it. */
+#define CAMERA_CAPTURE_SCHEDULE_OUTCOME_WAIT_MS   20000U
+
 /* Storage maintenance timing ---------------------------------------------- */
 #define IMAGE_CLEANUP_PERIOD_MS            600000U
 
+/* Low-power idle ---------------------------------------------------------- */
+/* When the scheduler is idle, stop SysTick and let TIM5 (the HAL timebase)
+ * wake the core when the next ThreadX timer is due instead of every tick. */
+#define APP_LOW_POWER_TICKLESS_ENABLED        1U
+/* Idle windows shorter than this stay on the normal 10 ms tick. */
+#define APP_LOW_POWER_MIN_TICKLESS_TICKS      2U
+/* Upper bound on one idle window. Timers longer than the 32-slot wheel are
+ * followed to their real expiry, so a pending multi-second sleep reaches
+ * this cap instead of waking every wheel revolution. */
+#define APP_LOW_POWER_MAX_IDLE_MS         10000U
+/* Shared wake-up grid for periodic services. Every coalesced sleep ends on a
+ * multiple of this period so heartbeat, cleanup and sensor polling wake
+ * together instead of staggering across the idle window. */
+#define APP_LOW_POWER_COALESCE_MS          1000U
+
+/* Peripheral power domains (app_low_power.c) ------------------------------ */
+/* Gate the NPU, xSPI2, DCMIPP/CSI and SD SPI clocks between uses. Off by
+ * default until the gating has been validated on target. */
+#define APP_POWER_DOMAINS_ENABLED             0U
+/* How long a released domain must stay unused before it is gated. FileX
+ * issues sector I/O in bursts, so SPI5 waits longest; the camera is only
+ * released once the sensor is parked, so it gates straight away. */
+#define APP_POWER_DOMAIN_NPU_MIN_OFF_MS     500U
+#define APP_POWER_DOMAIN_XSPI2_MIN_OFF_MS   500U
+#define APP_POWER_DOMAIN_CAMERA_MIN_OFF_MS    0U
+#define APP_POWER_DOMAIN_SD_SPI_MIN_OFF_MS 2000U
+
+/* Clock profiles (app_clocks.c) ------------------------------------------- */
+/* Switch the CPU and bus dividers by pipeline phase; 0 stays at boost. */
+#define APP_CLOCK_PROFILES_ENABLED            1U
+/* IC1 (CPU) and IC2 (system bus) dividers off the 1.2 GHz PLL1. Boost is
+ * the boot point; nominal only slows the CPU, which waits on the NPU; low
+ * also halves the bus for idle gaps and SD/console I/O. */
+#define APP_CLOCK_BOOST_CPU_DIVIDER           2U   /* 600 MHz */
+#define APP_CLOCK_BOOST_SYS_DIVIDER           3U   /* 400 MHz */
+#define APP_CLOCK_NOMINAL_CPU_DIVIDER         4U   /* 300 MHz */
+#define APP_CLOCK_NOMINAL_SYS_DIVIDER         3U   /* 400 MHz */
+#define APP_CLOCK_LOW_CPU_DIVIDER             8U   /* 150 MHz */
+#define APP_CLOCK_LOW_SYS_DIVIDER             6U   /* 200 MHz */
+
+/* Boot orchestration (app_boot.c) ---------------------------------------- */
+/* The AE seed waits for the SD mount (its per-hour table lives on the card)
+ * only until this long after reset; a slow or missing card then costs the
+ * remembered seed, not the first reading. */
+#define APP_BOOT_AE_SEED_SD_DEADLINE_MS      3000U
+/* Upper bound on holding the first capture for model init. */
+#define APP_BOOT_MODEL_INIT_WAIT_MS         30000U
+
 /* Camera middleware coordination ------------------------------------------ */
 #define CAMERA_MIDDLEWARE_LOCK_TIMEOUT_MS    5000U
 
@@ -0,0 +1,87 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_xspi2_residency.h
+ * @brief   Verify-once residency table for the model stages on xSPI2.
+ *
+ * Pure logic with no HAL, ThreadX or BSP dependency. Every model stage has
+ * its own region of the one memory-mapped xSPI2 chip, so once a stage's
+ * signatures were checked its weights stay valid until the flash is
+ * provisioned again. The table remembers which stages were verified in the
+ * current flash generation and tells the caller the cheapest way to make a
+ * stage usable: nothing at all, re-enabling the mapped window, or a full
+ * indirect-mode verify.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#ifndef __APP_XSPI2_RESIDENCY_H
+#define __APP_XSPI2_RESIDENCY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define APP_XSPI2_RESIDENCY_MAX_STAGES  8U
+
+typedef enum {
+	/* Resident and the window is mapped: switch with no peripheral traffic. */
+	APP_XSPI2_RESIDENCY_MAPPED = 0,
+	/* Resident but the window is off: only re-enable memory-mapped mode. */
+	APP_XSPI2_RESIDENCY_ENABLE_MM,
+	/* Not verified since boot or the last provisioning. */
+	APP_XSPI2_RESIDENCY_VERIFY,
+} AppXspi2Residency_Action_t;
+
+typedef struct {
+	const void *stage_key;        /* Stage spec address; NULL when free. */
+	uint32_t chip_offset;
+	uint32_t verified_generation; /* 0 = never verified. */
+} AppXspi2Residency_Entry_t;
+
+typedef struct {
+	AppXspi2Residency_Entry_t entries[APP_XSPI2_RESIDENCY_MAX_STAGES];
+	uint32_t entry_count;
+	/* Bumped by every provisioning write; starts at 1, and a zeroed table
+	 * is treated as freshly initialized. */
+	uint32_t generation;
+} AppXspi2Residency_Table_t;
+
+void AppXspi2Residency_Init(AppXspi2Residency_Table_t *table_ptr);
+
+/**
+ * @brief Decide what a stage needs before the NPU may read its weights.
+ *
+ * Registers an unknown stage on first use. When the table is full the stage
+ * is never cached and always needs a verify.
+ */
+AppXspi2Residency_Action_t AppXspi2Residency_Plan(
+		AppXspi2Residency_Table_t *table_ptr, const void *stage_key,
+		uint32_t chip_offset, bool mapped);
+
+/**
+ * @brief Record that the stage's signatures matched in this generation.
+ * @retval false when the stage is not in the table.
+ */
+bool AppXspi2Residency_MarkResident(AppXspi2Residency_Table_t *table_ptr,
+		const void *stage_key);
+
+bool AppXspi2Residency_IsResident(const AppXspi2Residency_Table_t *table_ptr,
+		const void *stage_key);
+
+/* Forget every verification; call after writing or erasing the flash. */
+void AppXspi2Residency_InvalidateAll(AppXspi2Residency_Table_t *table_ptr);
+
+uint32_t AppXspi2Residency_ResidentCount(
+		const AppXspi2Residency_Table_t *table_ptr);
+
+const char *AppXspi2Residency_ActionName(AppXspi2Residency_Action_t action);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_XSPI2_RESIDENCY_H */
@@ -0,0 +1,127 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_xspi_dtr.h
+ * @brief   Octal DTR bring-up, DQS delay calibration and STR fallback for
+ *          the xSPI2 NOR.
+ *
+ * Pure logic with no HAL, ThreadX or BSP dependency. The flash and the
+ * controller are reached through an ops table, so the same sequence runs
+ * against the MX25UM51245G on the board and a simulated NOR in the host unit
+ * tests.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#ifndef __APP_XSPI_DTR_H
+#define __APP_XSPI_DTR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define APP_XSPI_DTR_MAX_TAPS          128U
+#define APP_XSPI_DTR_MAX_REGIONS         6U
+#define APP_XSPI_DTR_MAX_REGION_BYTES   64U
+
+/* Last stage the bring-up reached; DTR_ACTIVE and STR_FALLBACK are final. */
+typedef enum {
+	APP_XSPI_DTR_STATE_STR_REFERENCE = 0,
+	APP_XSPI_DTR_STATE_SWITCHING,
+	APP_XSPI_DTR_STATE_CALIBRATING,
+	APP_XSPI_DTR_STATE_VALIDATING,
+	APP_XSPI_DTR_STATE_DTR_ACTIVE,
+	APP_XSPI_DTR_STATE_STR_FALLBACK,
+	APP_XSPI_DTR_STATE_FAILED,    /* STR could not be restored either. */
+} AppXspiDtr_State_t;
+
+typedef enum {
+	APP_XSPI_DTR_FAILURE_NONE = 0,
+	APP_XSPI_DTR_FAILURE_CONFIG,
+	APP_XSPI_DTR_FAILURE_STR_READ,
+	APP_XSPI_DTR_FAILURE_NO_PATTERN,
+	APP_XSPI_DTR_FAILURE_MODE_SWITCH,
+	APP_XSPI_DTR_FAILURE_NARROW_WINDOW,
+	APP_XSPI_DTR_FAILURE_VALIDATION,
+} AppXspiDtr_Failure_t;
+
+/**
+ * @brief Flash range read in both modes.
+ *
+ * Region 0 is the calibration pattern. When expected is set, the region only
+ * counts once the STR read matches it, so a stale or unprogrammed stage image
+ * cannot be mistaken for a DTR fault.
+ */
+typedef struct {
+	uint32_t offset;
+	uint32_t length;            /* At most APP_XSPI_DTR_MAX_REGION_BYTES. */
+	const uint8_t *expected;    /* Stage signature, or NULL. */
+} AppXspiDtr_Region_t;
+
+typedef struct {
+	const AppXspiDtr_Region_t *regions;
+	uint32_t region_count;
+	uint32_t tap_count;         /* DQS input delay taps to sweep. */
+	uint32_t min_window_taps;   /* Narrower passing windows fall back. */
+	uint32_t reads_per_tap;     /* Pattern reads that must all match. */
+	uint8_t dtr_dummy_cycles;
+} AppXspiDtr_Config_t;
+
+/* Every op returns false on a bus or controller error. */
+typedef struct {
+	/* Reset the flash and controller to octal STR. */
+	bool (*enter_str)(void *ctx);
+	/* Program the read dummy cycles, then DOPI in CR2, then switch the
+	 * controller to DTR with DQS sampling. */
+	bool (*enter_dtr)(void *ctx, uint8_t dummy_cycles);
+	bool (*set_delay_tap)(void *ctx, uint32_t tap);
+	/* Indirect read in the current mode. */
+	bool (*read)(void *ctx, uint32_t offset, uint8_t *dst, uint32_t length);
+	/* Read through the memory-mapped window the NPU streams weights from. */
+	bool (*read_mapped)(void *ctx, uint32_t offset, uint8_t *dst,
+			uint32_t length);
+	void *ctx;
+} AppXspiDtr_Ops_t;
+
+typedef struct {
+	AppXspiDtr_State_t state;
+	AppXspiDtr_Failure_t failure;
+	uint32_t passing_taps;
+	uint32_t window_start;
+	uint32_t window_taps;
+	uint32_t selected_tap;
+	uint32_t validated_regions;
+} AppXspiDtr_Result_t;
+
+/**
+ * @brief Find the widest run of consecutive passing taps.
+ *
+ * Ties go to the lower run. The sweep does not wrap: a window split across
+ * tap 0 and the last tap counts as two.
+ * @retval false when no tap passes.
+ */
+bool AppXspiDtr_FindWidestWindow(const bool *passes, uint32_t tap_count,
+		uint32_t *start_out, uint32_t *width_out);
+
+/**
+ * @brief Switch an STR-initialized flash to octal DTR, or leave it in STR.
+ *
+ * Reads every region in STR, switches mode, sweeps the DQS delay over the
+ * pattern, centres the widest passing window and re-reads every usable
+ * region through the mapped window. Any failure after the switch restores
+ * STR.
+ * @retval The final state, also stored in result_ptr.
+ */
+AppXspiDtr_State_t AppXspiDtr_BringUp(const AppXspiDtr_Config_t *config_ptr,
+		const AppXspiDtr_Ops_t *ops_ptr, AppXspiDtr_Result_t *result_ptr);
+
+const char *AppXspiDtr_FailureName(AppXspiDtr_Failure_t failure);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_XSPI_DTR_H */
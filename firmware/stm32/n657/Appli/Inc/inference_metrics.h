@@ -126,6 +126,15 @@ extern "C"
      */
     uint64_t Metrics_GetMicros(void);
 
+    /**
+     * @brief Tell the timestamp clock the CPU frequency has changed.
+     *
+     * Call right after the switch, with interrupts still locked, so no
+     * cycles at the new rate are counted at the old one.
+     * @param cpu_hz New CPU clock in Hz.
+     */
+    void Metrics_SetCpuClockHz(uint32_t cpu_hz);
+
     /**
      * @brief Override the start time of an active inference slot.
      *
@@ -145,6 +154,17 @@ extern "C"
      */
     void Metrics_PowerSample(float power_mw);
 
+    /**
+     * @brief Count one xSPI2 model stage switch and its latency.
+     *
+     * Reported with the summary in Metrics_LogAll, split by whether the
+     * switch stayed in memory-mapped mode or had to touch the peripheral.
+     * @param elapsed_us Time from the switch request to the stage being usable.
+     * @param touched_peripheral true when the switch re-enabled the mapped
+     *        window or verified the stage in indirect mode.
+     */
+    void Metrics_RecordXspi2StageSwitch(uint32_t elapsed_us, bool touched_peripheral);
+
 #ifdef __cplusplus
 }
 #endif
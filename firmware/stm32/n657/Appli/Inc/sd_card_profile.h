@@ -0,0 +1,206 @@
+#ifndef SD_CARD_PROFILE_H
+#define SD_CARD_PROFILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Profile file layout version; bump when SdCardProfile_Profile changes. */
+#define SD_CARD_PROFILE_MAGIC              (0x53444150UL) /* "SDAP" */
+#define SD_CARD_PROFILE_VERSION            (1UL)
+#define SD_CARD_PROFILE_MAX_CANDIDATES     (12U)
+#define SD_CARD_PROFILE_MAX_SIZE_STEPS     (8U)
+#define SD_CARD_PROFILE_SD_STATUS_BYTES    (64U)
+
+/*==============================================================================
+ * Type: SdCardProfile_SdStatus
+ *
+ * Purpose:
+ *   Allocation-unit fields of the 512-bit SD status register (ACMD13).
+ *
+ * Fields:
+ *   au_size_code     - Raw AU_SIZE field (0 = not defined by the card).
+ *   au_sectors       - AU size in 512-byte sectors, 0 when not defined.
+ *   erase_size_au    - AUs erased per ERASE_TIMEOUT, 0 when not supported.
+ *   erase_timeout_s  - Timeout for erasing erase_size_au AUs, in seconds.
+ *   erase_offset_s   - Fixed erase overhead, in seconds.
+ *==============================================================================*/
+typedef struct {
+	uint8_t au_size_code;
+	uint32_t au_sectors;
+	uint16_t erase_size_au;
+	uint8_t erase_timeout_s;
+	uint8_t erase_offset_s;
+} SdCardProfile_SdStatus;
+
+/*==============================================================================
+ * Type: SdCardProfile_WriteSectorsFunction
+ *
+ * Purpose:
+ *   Write sector_count sectors of scratch data starting at lba and report how
+ *   long the card took, busy time included.
+ *
+ * Returns:
+ *   0 on success, nonzero on failure.
+ *==============================================================================*/
+typedef int32_t (*SdCardProfile_WriteSectorsFunction)(void *write_context,
+		uint32_t lba, uint32_t sector_count, uint32_t *elapsed_us_out);
+
+/*==============================================================================
+ * Type: SdCardProfile_ProbeConfig
+ *
+ * Purpose:
+ *   Scratch window and sweep for the write-latency probe.
+ *
+ * Fields:
+ *   window_start_lba      - First sector of a scratch window the probe may
+ *                           overwrite. Must be a multiple of
+ *                           max_boundary_sectors.
+ *   window_sectors        - Window length; needs at least
+ *                           max_boundary_sectors + probe_sectors.
+ *   probe_sectors         - Length of each alignment test write (power of 2).
+ *   min_boundary_sectors  - Smallest boundary tested (power of 2, at least
+ *                           probe_sectors).
+ *   max_boundary_sectors  - Largest boundary tested (power of 2).
+ *   repeats               - Writes per point; the fastest one counts.
+ *   penalty_percent       - A straddling write this much slower than an
+ *                           aligned one marks a boundary.
+ *==============================================================================*/
+typedef struct {
+	uint32_t window_start_lba;
+	uint32_t window_sectors;
+	uint32_t probe_sectors;
+	uint32_t min_boundary_sectors;
+	uint32_t max_boundary_sectors;
+	uint32_t repeats;
+	uint32_t penalty_percent;
+} SdCardProfile_ProbeConfig;
+
+/*==============================================================================
+ * Type: SdCardProfile_Profile
+ *
+ * Purpose:
+ *   Card write geometry, stored on the card so the probe runs once per card.
+ *
+ * Fields:
+ *   partition_start_lba / partition_sector_count
+ *                     - Partition the profile was measured on; a different
+ *                       partition means a different card or a reformat.
+ *   au_sectors        - AU from the SD status register, 0 when not defined.
+ *   boundary_sectors  - Smallest boundary whose straddling writes stalled,
+ *                       0 when none did.
+ *   align_sectors     - Unit the writers align new files to, 0 for none.
+ *   baseline_us       - Fastest aligned probe write.
+ *   size_us           - Fastest aligned write of 1, 2, 4 ... sectors.
+ *   straddle_us       - Fastest write straddling each tested boundary,
+ *                       starting at min_boundary_sectors.
+ *==============================================================================*/
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t partition_start_lba;
+	uint32_t partition_sector_count;
+	uint32_t au_sectors;
+	uint32_t boundary_sectors;
+	uint32_t align_sectors;
+	uint32_t probe_sectors;
+	uint32_t baseline_us;
+	uint32_t size_step_count;
+	uint32_t size_us[SD_CARD_PROFILE_MAX_SIZE_STEPS];
+	uint32_t min_boundary_sectors;
+	uint32_t candidate_count;
+	uint32_t straddle_us[SD_CARD_PROFILE_MAX_CANDIDATES];
+} SdCardProfile_Profile;
+
+/*==============================================================================
+ * Function: SdCardProfile_ParseSdStatus
+ *
+ * Purpose:
+ *   Decode AU_SIZE, ERASE_SIZE, ERASE_TIMEOUT and ERASE_OFFSET from the SD
+ *   status block (bits 431:400, MSB first as the card sends it).
+ *
+ * Returns:
+ *   1 if the card defines an AU size, otherwise 0.
+ *==============================================================================*/
+uint8_t SdCardProfile_ParseSdStatus(
+		const uint8_t sd_status[SD_CARD_PROFILE_SD_STATUS_BYTES],
+		SdCardProfile_SdStatus *status_out);
+
+/*==============================================================================
+ * Function: SdCardProfile_Probe
+ *
+ * Purpose:
+ *   Measure write latency against size and alignment and find the smallest
+ *   boundary that costs a stall to cross.
+ *
+ * Notes:
+ *   For each power-of-two boundary S, one write of probe_sectors straddles
+ *   window_start + S. S is never a multiple of 2S, so that write only crosses
+ *   a real erase boundary when S is a multiple of the card's unit. The first
+ *   S whose straddle stalls past penalty_percent is the unit.
+ *
+ * Returns:
+ *   0 on success, -1 for an invalid config, -2 if a write failed.
+ *   Fills the measured fields of profile_out; identity and align_sectors are
+ *   left to the caller.
+ *==============================================================================*/
+int32_t SdCardProfile_Probe(SdCardProfile_WriteSectorsFunction write_function,
+		void *write_context, const SdCardProfile_ProbeConfig *config_ptr,
+		SdCardProfile_Profile *profile_out);
+
+/*==============================================================================
+ * Function: SdCardProfile_ChooseAlignSectors
+ *
+ * Purpose:
+ *   Pick the alignment unit: the measured boundary, else the SD status AU,
+ *   never more than max_align_sectors.
+ *
+ * Returns:
+ *   Alignment in sectors (power of 2), or 0 when neither source is known.
+ *==============================================================================*/
+uint32_t SdCardProfile_ChooseAlignSectors(uint32_t boundary_sectors,
+		uint32_t au_sectors, uint32_t max_align_sectors);
+
+/*==============================================================================
+ * Function: SdCardProfile_IsValid
+ *
+ * Purpose:
+ *   Check a profile read back from the card against the mounted partition.
+ *
+ * Returns:
+ *   1 if the profile can be used as-is, otherwise 0.
+ *==============================================================================*/
+uint8_t SdCardProfile_IsValid(const SdCardProfile_Profile *profile_ptr,
+		uint32_t partition_start_lba, uint32_t partition_sector_count);
+
+/*==============================================================================
+ * Function: SdCardProfile_NextAlignedCluster
+ *
+ * Purpose:
+ *   Find the first cluster at or after search_cluster whose first sector is
+ *   a multiple of align_sectors on the card.
+ *
+ * Parameters:
+ *   first_data_lba       - Physical LBA of cluster 2.
+ *   sectors_per_cluster  - FAT cluster size in sectors.
+ *   total_clusters       - Data clusters on the volume (clusters 2..N+1).
+ *   search_cluster       - Where the next allocation would start.
+ *   align_sectors        - Alignment unit (power of 2).
+ *
+ * Returns:
+ *   The aligned cluster, wrapping to the first aligned one past the end, or
+ *   search_cluster unchanged when the cluster grid cannot reach the unit
+ *   (misaligned data region or clusters larger than the unit).
+ *==============================================================================*/
+uint32_t SdCardProfile_NextAlignedCluster(uint32_t first_data_lba,
+		uint32_t sectors_per_cluster, uint32_t total_clusters,
+		uint32_t search_cluster, uint32_t align_sectors);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SD_CARD_PROFILE_H */
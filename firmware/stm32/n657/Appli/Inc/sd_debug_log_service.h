@@ -58,6 +58,21 @@ UINT SdDebugLogService_EnqueueLine(const CHAR *line_ptr);
  *==============================================================================*/
 void SdDebugLogService_ServiceQueue(ULONG max_messages_to_process);
 
+/*==============================================================================
+ * Function: SdDebugLogService_WaitForPending
+ *
+ * Purpose:
+ *   Block the FileX thread until a log line is queued or the timeout expires,
+ *   so an idle log service does not wake the core every tick.
+ *
+ * Parameters:
+ *   wait_ticks - Maximum ThreadX ticks to wait.
+ *
+ * Returns:
+ *   TX_SUCCESS when lines are pending, TX_NO_INSTANCE on timeout.
+ *==============================================================================*/
+UINT SdDebugLogService_WaitForPending(ULONG wait_ticks);
+
 /*==============================================================================
  * Function: SdDebugLogService_ForceFlush
  *
@@ -0,0 +1,163 @@
+#ifndef SD_FAT_FORMAT_H
+#define SD_FAT_FORMAT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SD_FAT_FORMAT_SECTOR_BYTES             (512U)
+#define SD_FAT_FORMAT_NUMBER_OF_FATS           (2U)
+/* Boot sector, FSInfo and the backup copies at sectors 6 and 7. */
+#define SD_FAT_FORMAT_MIN_RESERVED_SECTORS     (32U)
+/* 64 KiB, the largest cluster every FAT32 implementation accepts. */
+#define SD_FAT_FORMAT_MAX_SECTORS_PER_CLUSTER  (128U)
+/* Reserved sectors is a 16-bit field, so alignment is capped at 16 MiB. */
+#define SD_FAT_FORMAT_MAX_ALIGN_SECTORS        (32768U)
+/* FAT32 cluster count limits; fewer clusters would mount as FAT16. */
+#define SD_FAT_FORMAT_MIN_CLUSTERS             (65525UL)
+#define SD_FAT_FORMAT_MAX_CLUSTERS             (0x0FFFFFF5UL)
+#define SD_FAT_FORMAT_MAX_DIRECTORIES          (4U)
+/* Two long-name entries per directory. */
+#define SD_FAT_FORMAT_MAX_NAME_LENGTH          (26U)
+
+/*==============================================================================
+ * Type: SdFatFormat_Config
+ *
+ * Purpose:
+ *   What the layout is tuned for.
+ *
+ * Fields:
+ *   partition_start_lba - Physical LBA of the partition (hidden sectors).
+ *   partition_sectors   - Partition length in sectors.
+ *   align_sectors       - Card allocation unit (power of 2, at most
+ *                         SD_FAT_FORMAT_MAX_ALIGN_SECTORS). FAT 1 starts on
+ *                         a multiple of it.
+ *   file_bytes          - Size of the file the volume mostly holds.
+ *   max_slack_percent   - Clusters may round file_bytes up by at most this
+ *                         much; larger clusters win inside that budget.
+ *==============================================================================*/
+typedef struct {
+	uint32_t partition_start_lba;
+	uint32_t partition_sectors;
+	uint32_t align_sectors;
+	uint32_t file_bytes;
+	uint32_t max_slack_percent;
+} SdFatFormat_Config;
+
+/*==============================================================================
+ * Type: SdFatFormat_Layout
+ *
+ * Purpose:
+ *   FAT32 geometry chosen by SdFatFormat_PlanLayout. Sector numbers are
+ *   relative to the partition start.
+ *
+ * Fields:
+ *   reserved_sectors  - Boot area plus the alignment padding in front of
+ *                       FAT 1.
+ *   sectors_per_fat   - FAT length as recorded in the boot sector, rounded
+ *                       up to a whole cluster.
+ *   fat_used_sectors  - Leading FAT sectors that hold cluster entries; the
+ *                       padding after them is never read.
+ *   data_start_sector - First sector of cluster 2 (the root directory).
+ *==============================================================================*/
+typedef struct {
+	uint32_t hidden_sectors;
+	uint32_t total_sectors;
+	uint32_t align_sectors;
+	uint32_t sectors_per_cluster;
+	uint32_t reserved_sectors;
+	uint32_t sectors_per_fat;
+	uint32_t fat_used_sectors;
+	uint32_t data_start_sector;
+	uint32_t cluster_count;
+} SdFatFormat_Layout;
+
+/*==============================================================================
+ * Type: SdFatFormat_Directory
+ *
+ * Purpose:
+ *   A top-level directory created by the format with a contiguous extent.
+ *
+ * Fields:
+ *   name     - Long name, 1..SD_FAT_FORMAT_MAX_NAME_LENGTH printable ASCII.
+ *   clusters - Extent length; FAT32 directories have no size field, so the
+ *              zeroed clusters read as free entries until used.
+ *==============================================================================*/
+typedef struct {
+	const char *name;
+	uint32_t clusters;
+} SdFatFormat_Directory;
+
+/*==============================================================================
+ * Type: SdFatFormat_WriteSectorFunction
+ *
+ * Purpose:
+ *   Write one 512-byte sector at a partition-relative sector number.
+ *
+ * Returns:
+ *   0 on success, nonzero on failure.
+ *==============================================================================*/
+typedef int32_t (*SdFatFormat_WriteSectorFunction)(void *write_context,
+		uint32_t sector, const uint8_t data[SD_FAT_FORMAT_SECTOR_BYTES]);
+
+/*==============================================================================
+ * Function: SdFatFormat_PlanLayout
+ *
+ * Purpose:
+ *   Choose the cluster size, start the FATs on an allocation-unit boundary
+ *   and keep every data cluster inside a single unit.
+ *
+ * Notes:
+ *   The cluster size is the largest power of two up to 64 KiB, and no larger
+ *   than the unit, that keeps file_bytes within max_slack_percent and still
+ *   gives a FAT32 cluster count. Fewer clusters per file means shorter
+ *   chains and fewer FAT sectors touched per file.
+ *
+ * Returns:
+ *   0 on success, -1 for an invalid config, -2 if no FAT32 layout fits.
+ *==============================================================================*/
+int32_t SdFatFormat_PlanLayout(const SdFatFormat_Config *config_ptr,
+		SdFatFormat_Layout *layout_ptr);
+
+/*==============================================================================
+ * Function: SdFatFormat_Write
+ *
+ * Purpose:
+ *   Write a FAT32 volume with the given layout and directories.
+ *
+ * Notes:
+ *   Only the metadata is written. Both boot sectors are cleared first, then
+ *   come the used FAT sectors, the root directory cluster, each directory
+ *   extent, FSInfo and finally the boot sectors, so an interrupted format
+ *   never leaves a valid boot sector over a half-written FAT.
+ *
+ * Parameters:
+ *   dos_date_time - FAT timestamp for the directories, date in the high
+ *                   16 bits and time in the low 16 bits.
+ *
+ * Returns:
+ *   0 on success, -1 for invalid arguments, -2 if a sector write failed.
+ *==============================================================================*/
+int32_t SdFatFormat_Write(const SdFatFormat_Layout *layout_ptr,
+		const SdFatFormat_Directory *directories, uint32_t directory_count,
+		uint32_t volume_id, uint32_t dos_date_time,
+		SdFatFormat_WriteSectorFunction write_function, void *write_context);
+
+/*==============================================================================
+ * Function: SdFatFormat_DirectoryFirstCluster
+ *
+ * Purpose:
+ *   Cluster where a directory extent starts: right after the root cluster
+ *   and the extents listed before it.
+ *==============================================================================*/
+uint32_t SdFatFormat_DirectoryFirstCluster(
+		const SdFatFormat_Directory *directories, uint32_t directory_index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SD_FAT_FORMAT_H */
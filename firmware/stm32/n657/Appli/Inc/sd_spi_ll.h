@@ -26,11 +26,15 @@ typedef struct {
 /* Switch SPI5 to full data-transfer speed (25 MHz). Call after ACMD41 succeeds. */
 void SPI_SD_SetHighSpeed(void);
 
+/* Keep SCK at 25 MHz after a PCLK2 change; no-op before SetHighSpeed. */
+void SPI_SD_RetuneForBusClock(void);
+
 /* SD SPI bringup helpers */
 uint8_t SPI_SendCMD0_GetR1(void);
 uint8_t SPI_SendCMD8_ReadR7(uint8_t r7_out[4]);
 uint8_t SPI_SendACMD41_UntilReady(uint8_t *cmd55_r1_out);
 uint8_t SPI_SendCMD58_ReadOCR(uint8_t ocr_out[4]);
+uint8_t SPI_SendACMD13_ReadSdStatus(uint8_t sd_status_out[64]);
 void SPI_Test_Run(void);
 
 /* SD block I/O (512-byte sectors) */
@@ -269,6 +269,11 @@
 /* Define the user extension field of the thread control block.*/
 /*#define TX_THREAD_USER_EXTENSION                ????*/
 
+/* Idle in WFI instead of spinning, and let app_low_power.c stop the tick
+   while nothing is due (tx_low_power_enter/tx_low_power_exit).  */
+#define TX_LOW_POWER
+#define TX_ENABLE_WFI
+
 /* USER CODE END 2 */
 
 #endif
@@ -39,6 +39,11 @@
 
 extern bool AppAI_Xspi2EnsureMemoryMappedMode(void);
 extern bool AppAI_VerifyTipFocusWeights(void);
+extern bool AppAI_CheckActivationOverlay(const char *network_name,
+    const NN_Instance_TypeDef *nn_instance);
+extern void AppAI_EpochProfileBegin(const char *network_name);
+extern void AppAI_EpochProfileMark(void);
+extern void AppAI_EpochProfileEnd(bool completed);
 extern const LL_Buffer_InfoTypeDef *LL_ATON_Input_Buffers_Info_tip_focus_v18_int8(void);
 extern const LL_Buffer_InfoTypeDef *LL_ATON_Output_Buffers_Info_tip_focus_v18_int8(void);
 extern const LL_Buffer_InfoTypeDef *LL_ATON_Internal_Buffers_Info_tip_focus_v18_int8(void);
@@ -545,6 +550,13 @@ bool AppAI_TipFocus_Init(void)
             (const void *)_mem_pool_xSPI2_tip_focus_v18_int8);
     }
 
+    if (!AppAI_CheckActivationOverlay("tip_focus_v18_int8",
+            &NN_Instance_tip_focus_v18_int8)) {
+        DebugConsole_WriteString(
+            "[AI][TIP_FOCUS] Init aborted: activations outside the arena plan.\r\n");
+        return false;
+    }
+
     app_ai_tip_focus_outputs_valid = false;
     return true;
 }
@@ -642,27 +654,33 @@ bool AppAI_TipFocus_Run(void)
             app_ai_tip_focus_logged_compiled_in_runtime = true;
         }
 
+        AppAI_EpochProfileBegin("tip_focus_v18_int8");
         for (;;) {
             __asm volatile("mov r9, %0" ::"r"(runtime_r9) : "r9");
             status = LL_ATON_RT_RunEpochBlock(&NN_Instance_tip_focus_v18_int8);
             if (status == LL_ATON_RT_DONE) {
+                AppAI_EpochProfileMark();
                 break;
             }
             if (status == LL_ATON_RT_WFE) {
                 LL_ATON_OSAL_WFE();
                 __asm volatile("mov r9, %0" ::"r"(runtime_r9) : "r9");
+                AppAI_EpochProfileMark();
                 continue;
             }
             if (status == LL_ATON_RT_NO_WFE) {
+                AppAI_EpochProfileMark();
                 continue;
             }
 
+            AppAI_EpochProfileEnd(false);
             DebugConsole_Printf(
                 "[AI][TIP_FOCUS] Unexpected runtime status=%d\r\n",
                 (int)status);
             __asm volatile("mov r9, %0" ::"r"(caller_r9) : "r9");
             return false;
         }
+        AppAI_EpochProfileEnd(true);
     }
 
     AppAI_TipFocus_InvalidateOutputs(output_info);
@@ -0,0 +1,153 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_activation_overlay.c
+ * @brief   Boot-time checks for the shared NPU activation arena plan.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#include "app_activation_overlay.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/** @brief True when [offset, offset + size) fits in the arena. */
+static bool AppActivationOverlay_RegionFits(
+		const AppActivationOverlay_Region_t *region_ptr, uint32_t arena_size) {
+	return (region_ptr->offset <= arena_size)
+			&& (region_ptr->size <= (arena_size - region_ptr->offset));
+}
+
+AppActivationOverlay_Status_t AppActivationOverlay_CheckPlan(
+		const AppActivationOverlay_Region_t *regions_ptr, uint32_t region_count,
+		uint32_t arena_size, uint32_t *first_out, uint32_t *second_out) {
+	if ((regions_ptr == NULL) && (region_count > 0U)) {
+		return APP_ACTIVATION_OVERLAY_UNKNOWN_STAGE;
+	}
+	for (uint32_t first = 0U; first < region_count; first++) {
+		const AppActivationOverlay_Region_t *a_ptr = &regions_ptr[first];
+
+		if (!AppActivationOverlay_RegionFits(a_ptr, arena_size)
+				|| (a_ptr->first_step > a_ptr->last_step)) {
+			if (first_out != NULL) {
+				*first_out = first;
+			}
+			if (second_out != NULL) {
+				*second_out = first;
+			}
+			return APP_ACTIVATION_OVERLAY_OUT_OF_ARENA;
+		}
+		for (uint32_t second = first + 1U; second < region_count; second++) {
+			const AppActivationOverlay_Region_t *b_ptr = &regions_ptr[second];
+			const bool live_together = (a_ptr->first_step <= b_ptr->last_step)
+					&& (b_ptr->first_step <= a_ptr->last_step);
+			const bool share_bytes = (a_ptr->size > 0U) && (b_ptr->size > 0U)
+					&& ((uint64_t) a_ptr->offset
+							< ((uint64_t) b_ptr->offset + b_ptr->size))
+					&& ((uint64_t) b_ptr->offset
+							< ((uint64_t) a_ptr->offset + a_ptr->size));
+
+			if (live_together && share_bytes) {
+				if (first_out != NULL) {
+					*first_out = first;
+				}
+				if (second_out != NULL) {
+					*second_out = second;
+				}
+				return APP_ACTIVATION_OVERLAY_LIFETIME_OVERLAP;
+			}
+		}
+	}
+	return APP_ACTIVATION_OVERLAY_OK;
+}
+
+const AppActivationOverlay_Region_t *AppActivationOverlay_Find(
+		const AppActivationOverlay_Region_t *regions_ptr, uint32_t region_count,
+		const char *name) {
+	if ((regions_ptr == NULL) || (name == NULL)) {
+		return NULL;
+	}
+	for (uint32_t index = 0U; index < region_count; index++) {
+		if ((regions_ptr[index].name != NULL)
+				&& (strcmp(regions_ptr[index].name, name) == 0)) {
+			return &regions_ptr[index];
+		}
+	}
+	return NULL;
+}
+
+void AppActivationOverlay_ExtentInit(AppActivationOverlay_Extent_t *extent_ptr) {
+	if (extent_ptr == NULL) {
+		return;
+	}
+	(void) memset(extent_ptr, 0, sizeof(*extent_ptr));
+}
+
+void AppActivationOverlay_ExtentAdd(AppActivationOverlay_Extent_t *extent_ptr,
+		uint32_t arena_base, uint32_t arena_size, uint32_t buffer_addr,
+		uint32_t buffer_len) {
+	const uint64_t arena_end = (uint64_t) arena_base + arena_size;
+	const uint64_t buffer_end = (uint64_t) buffer_addr + buffer_len;
+	uint32_t start = 0U;
+	uint32_t end = 0U;
+
+	if ((extent_ptr == NULL) || (buffer_len == 0U)) {
+		return;
+	}
+	if ((buffer_end <= arena_base) || (buffer_addr >= arena_end)) {
+		extent_ptr->outside_count++;
+		return;
+	}
+	if ((buffer_addr < arena_base) || (buffer_end > arena_end)) {
+		extent_ptr->straddles = true;
+		return;
+	}
+
+	start = buffer_addr - arena_base;
+	end = (uint32_t) (buffer_end - arena_base);
+	if ((extent_ptr->buffer_count == 0U) || (start < extent_ptr->start)) {
+		extent_ptr->start = start;
+	}
+	if (end > extent_ptr->end) {
+		extent_ptr->end = end;
+	}
+	extent_ptr->buffer_count++;
+}
+
+AppActivationOverlay_Status_t AppActivationOverlay_CheckExtent(
+		const AppActivationOverlay_Region_t *region_ptr,
+		const AppActivationOverlay_Extent_t *extent_ptr) {
+	if ((region_ptr == NULL) || (extent_ptr == NULL)) {
+		return APP_ACTIVATION_OVERLAY_UNKNOWN_STAGE;
+	}
+	if (extent_ptr->straddles) {
+		return APP_ACTIVATION_OVERLAY_OUT_OF_ARENA;
+	}
+	if (extent_ptr->buffer_count == 0U) {
+		return APP_ACTIVATION_OVERLAY_OK;
+	}
+	if ((extent_ptr->start < region_ptr->offset)
+			|| ((extent_ptr->end - region_ptr->offset) > region_ptr->size)) {
+		return APP_ACTIVATION_OVERLAY_EXTENT_EXCEEDED;
+	}
+	return APP_ACTIVATION_OVERLAY_OK;
+}
+
+const char *AppActivationOverlay_StatusName(
+		AppActivationOverlay_Status_t status) {
+	switch (status) {
+	case APP_ACTIVATION_OVERLAY_OK:
+		return "ok";
+	case APP_ACTIVATION_OVERLAY_OUT_OF_ARENA:
+		return "out-of-arena";
+	case APP_ACTIVATION_OVERLAY_LIFETIME_OVERLAP:
+		return "lifetime-overlap";
+	case APP_ACTIVATION_OVERLAY_EXTENT_EXCEEDED:
+		return "extent-exceeded";
+	case APP_ACTIVATION_OVERLAY_UNKNOWN_STAGE:
+		return "unknown-stage";
+	default:
+		return "unknown";
+	}
+}
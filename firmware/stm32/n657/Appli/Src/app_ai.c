@@ -22,6 +22,7 @@
 #include "debug_console.h"
 #include "app_inference_calibration.h"
 #include "app_baseline_runtime.h"
+#include "app_clocks.h"
 #include "app_inference_log_config.h"
 #include "app_inference_log_utils.h"
 #include "app_memory_budget.h"
@@ -41,6 +42,10 @@
 #include "app_ai_inference.h"
 #include "app_ai_stage_obb.h"
 #include "app_ai_stage_tip_focus.h"
+#include "app_activation_overlay.h"
+#include "app_activation_overlay_plan.h"
+#include "app_epoch_profile.h"
+#include "app_camera_buffers.h"
 #include "tx_api.h"
 #include "ll_aton_rt_user_api.h"
 #include "ll_aton.h"
@@ -118,6 +123,15 @@ bool app_ai_tip_focus_last_published_valid = false;
 uint32_t app_ai_tip_focus_consecutive_invalid = 0U;
 uint32_t app_ai_tip_focus_outlier_streak = 0U;
 bool app_ai_forced_crop_active = false;
+/* Axis-aligned extent of the last decoded OBB box, published for the ROI
+ * capture path. The generation bumps after every update. */
+float app_ai_gauge_box_center_x = 0.0f;
+float app_ai_gauge_box_center_y = 0.0f;
+float app_ai_gauge_box_width = 0.0f;
+float app_ai_gauge_box_height = 0.0f;
+volatile uint32_t app_ai_gauge_box_generation = 0U;
+/* Set by the capture thread when the frame is already framed on the gauge. */
+volatile bool app_ai_skip_obb_stage = false;
 size_t app_ai_forced_crop_x_min = 0U;
 size_t app_ai_forced_crop_y_min = 0U;
 size_t app_ai_forced_crop_width = 0U;
@@ -510,7 +524,7 @@ bool __attribute__((noinline)) AppAI_PreprocessYuv422FrameToFloatInput(
 	{
 		return false;
 	}
-	if ((frame_size < (size_t)APP_AI_CAPTURE_FRAME_BYTES) ||
+	if ((frame_size < (size_t)APP_AI_CAPTURE_FRAME_MIN_BYTES) ||
 		(input_float_count < required_float_count) ||
 		(input_len_bytes < required_bytes))
 	{
@@ -1079,3 +1093,289 @@ uintptr_t AppAI_GetRelocRuntimeR9(const NN_Instance_TypeDef *nn_instance)
 
 	return 0U;
 }
+
+static const AppActivationOverlay_Region_t app_ai_activation_overlay_regions[] = {
+	APP_ACTIVATION_OVERLAY_REGIONS
+};
+
+static void AppAI_AddBuffersToOverlayExtent(
+	AppActivationOverlay_Extent_t *extent,
+	const LL_Buffer_InfoTypeDef *buffer_info)
+{
+	if (buffer_info == NULL)
+	{
+		return;
+	}
+	for (; buffer_info->name != NULL; buffer_info++)
+	{
+		AppActivationOverlay_ExtentAdd(extent, APP_ACTIVATION_ARENA_BASE_ADDR,
+			APP_ACTIVATION_ARENA_SIZE_BYTES,
+			(uint32_t)(uintptr_t)LL_Buffer_addr_start(buffer_info),
+			(uint32_t)LL_Buffer_len(buffer_info));
+	}
+}
+
+/**
+ * @brief Check the activation arena plan itself before any stage runs.
+ */
+bool AppAI_CheckActivationOverlayPlan(void)
+{
+	uint32_t first = 0U;
+	uint32_t second = 0U;
+	AppActivationOverlay_Extent_t snapshot_extent;
+	const AppActivationOverlay_Status_t status = AppActivationOverlay_CheckPlan(
+		app_ai_activation_overlay_regions, APP_ACTIVATION_OVERLAY_REGION_COUNT,
+		APP_ACTIVATION_ARENA_SIZE_BYTES, &first, &second);
+
+	if (status != APP_ACTIVATION_OVERLAY_OK)
+	{
+		DebugConsole_Printf("[AI][OVERLAY] Plan invalid (%s): %s / %s\r\n",
+			AppActivationOverlay_StatusName(status),
+			app_ai_activation_overlay_regions[first].name,
+			app_ai_activation_overlay_regions[second].name);
+		return false;
+	}
+	DebugConsole_Printf(
+		"[AI][OVERLAY] Arena 0x%08lX: %lu regions, %lu of %lu bytes planned.\r\n",
+		(unsigned long)APP_ACTIVATION_ARENA_BASE_ADDR,
+		(unsigned long)APP_ACTIVATION_OVERLAY_REGION_COUNT,
+		(unsigned long)APP_ACTIVATION_ARENA_USED_BYTES,
+		(unsigned long)APP_ACTIVATION_ARENA_SIZE_BYTES);
+#if APP_ACTIVATION_OVERLAY_PLAN_PLACEHOLDER
+	(void)DebugConsole_WriteString(
+		"[AI][OVERLAY] Placeholder plan: no arena bytes are shared or freed.\r\n");
+#endif
+
+	/* The frame snapshot is read by every stage, so it may only sit in the
+	 * free tail of the arena. */
+	AppActivationOverlay_ExtentInit(&snapshot_extent);
+	AppActivationOverlay_ExtentAdd(&snapshot_extent,
+		APP_ACTIVATION_ARENA_BASE_ADDR, APP_ACTIVATION_ARENA_USED_BYTES,
+		(uint32_t)(uintptr_t)camera_inference_frame_snapshot,
+		(uint32_t)sizeof(camera_inference_frame_snapshot));
+	if ((snapshot_extent.buffer_count > 0U) || snapshot_extent.straddles)
+	{
+		DebugConsole_Printf(
+			"[AI][OVERLAY] WARNING: frame snapshot at 0x%08lX is inside the planned arena.\r\n",
+			(unsigned long)(uintptr_t)camera_inference_frame_snapshot);
+	}
+	return true;
+}
+
+/**
+ * @brief Check a network's placed buffers against its arena region.
+ *
+ * Call after the network's first init, once the runtime has resolved the
+ * buffer addresses. Buffers outside the arena (xSPI, other SRAM) are not
+ * part of the plan and are skipped.
+ */
+bool AppAI_CheckActivationOverlay(const char *network_name,
+	const NN_Instance_TypeDef *nn_instance)
+{
+	const AppActivationOverlay_Region_t *region = AppActivationOverlay_Find(
+		app_ai_activation_overlay_regions, APP_ACTIVATION_OVERLAY_REGION_COUNT,
+		network_name);
+	AppActivationOverlay_Extent_t extent;
+	AppActivationOverlay_Status_t status;
+
+	if (region == NULL)
+	{
+		DebugConsole_Printf("[AI][OVERLAY] %s has no region in the arena plan.\r\n",
+			(network_name != NULL) ? network_name : "(unnamed)");
+		return false;
+	}
+	if ((nn_instance == NULL) || (nn_instance->network == NULL))
+	{
+		return false;
+	}
+
+	AppActivationOverlay_ExtentInit(&extent);
+	if (nn_instance->network->input_buffers_info != NULL)
+	{
+		AppAI_AddBuffersToOverlayExtent(&extent,
+			nn_instance->network->input_buffers_info());
+	}
+	if (nn_instance->network->output_buffers_info != NULL)
+	{
+		AppAI_AddBuffersToOverlayExtent(&extent,
+			nn_instance->network->output_buffers_info());
+	}
+	if (nn_instance->network->internal_buffers_info != NULL)
+	{
+		AppAI_AddBuffersToOverlayExtent(&extent,
+			nn_instance->network->internal_buffers_info());
+	}
+
+	status = AppActivationOverlay_CheckExtent(region, &extent);
+	DebugConsole_Printf(
+		"[AI][OVERLAY] %s: buffers 0x%08lX..0x%08lX (%lu in arena, %lu outside), region 0x%08lX+%lu: %s\r\n",
+		region->name,
+		(unsigned long)extent.start, (unsigned long)extent.end,
+		(unsigned long)extent.buffer_count, (unsigned long)extent.outside_count,
+		(unsigned long)region->offset, (unsigned long)region->size,
+		AppActivationOverlay_StatusName(status));
+	return status == APP_ACTIVATION_OVERLAY_OK;
+}
+
+/* Set for the length of every epoch loop; the NPU streams xSPI2 weights and
+ * activations over the bus the whole time. */
+static volatile bool app_ai_npu_epochs_running = false;
+/* Epoch loops started by any network since boot. */
+static volatile uint32_t app_ai_npu_run_count = 0U;
+
+#if APP_AI_ENABLE_EPOCH_PROFILE
+/* One profile per network; the OBB, heatmap and tip-focus stages each run
+ * their own epoch loop. */
+#define APP_AI_EPOCH_PROFILE_SLOTS 3U
+
+typedef struct
+{
+	const char *network_name;
+	AppEpochProfile_t profile;
+} AppAI_EpochProfileSlot_t;
+
+static AppAI_EpochProfileSlot_t app_ai_epoch_profiles[APP_AI_EPOCH_PROFILE_SLOTS];
+static AppAI_EpochProfileSlot_t *app_ai_epoch_profile_active = NULL;
+
+static AppAI_EpochProfileSlot_t *AppAI_FindEpochProfileSlot(
+	const char *network_name)
+{
+	for (uint32_t index = 0U; index < APP_AI_EPOCH_PROFILE_SLOTS; index++)
+	{
+		AppAI_EpochProfileSlot_t *slot = &app_ai_epoch_profiles[index];
+		if (slot->network_name == NULL)
+		{
+			slot->network_name = network_name;
+			AppEpochProfile_Init(&slot->profile);
+			return slot;
+		}
+		if (strcmp(slot->network_name, network_name) == 0)
+		{
+			return slot;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief Print one profile window as CSV lines for tools/weight_placement.py,
+ * then start a new window.
+ */
+static void AppAI_ReportEpochProfile(AppAI_EpochProfileSlot_t *slot)
+{
+	const AppEpochProfile_t *profile = &slot->profile;
+
+	DebugConsole_Printf(
+		"[AI][EPOCH] %s runs=%lu epochs=%lu dropped=%lu total_avg_us=%lu\r\n",
+		slot->network_name,
+		(unsigned long)profile->run_count,
+		(unsigned long)profile->epoch_count,
+		(unsigned long)profile->dropped,
+		(unsigned long)AppEpochProfile_TotalAverageUs(profile));
+	for (uint32_t index = 0U; index < profile->epoch_count; index++)
+	{
+		const AppEpochProfile_Stat_t *stat = &profile->epochs[index];
+		DebugConsole_Printf("[AI][EPOCH] %s,%lu,%lu,%lu,%lu,%lu\r\n",
+			slot->network_name,
+			(unsigned long)index,
+			(unsigned long)stat->count,
+			(unsigned long)AppEpochProfile_AverageUs(stat),
+			(unsigned long)stat->min_us,
+			(unsigned long)stat->max_us);
+	}
+	AppEpochProfile_Init(&slot->profile);
+}
+#endif
+
+/**
+ * @brief Start timing a network's epoch loop (APP_AI_ENABLE_EPOCH_PROFILE).
+ *
+ * The loop calls AppAI_EpochProfileMark after every RunEpochBlock pass,
+ * including any WFE wait, and AppAI_EpochProfileEnd once it exits. The pair
+ * also brackets the NPU activity reported by AppAI_IsBusMasterActive.
+ */
+void AppAI_EpochProfileBegin(const char *network_name)
+{
+	app_ai_npu_epochs_running = true;
+	app_ai_npu_run_count++;
+#if APP_AI_ENABLE_EPOCH_PROFILE
+	app_ai_epoch_profile_active = (network_name != NULL) ?
+		AppAI_FindEpochProfileSlot(network_name) : NULL;
+	if (app_ai_epoch_profile_active != NULL)
+	{
+		AppEpochProfile_BeginRun(&app_ai_epoch_profile_active->profile,
+			Metrics_GetMicros());
+	}
+#else
+	(void)network_name;
+#endif
+}
+
+void AppAI_EpochProfileMark(void)
+{
+#if APP_AI_ENABLE_EPOCH_PROFILE
+	if (app_ai_epoch_profile_active != NULL)
+	{
+		AppEpochProfile_Mark(&app_ai_epoch_profile_active->profile,
+			Metrics_GetMicros());
+	}
+#endif
+}
+
+void AppAI_EpochProfileEnd(bool completed)
+{
+	app_ai_npu_epochs_running = false;
+#if APP_AI_ENABLE_EPOCH_PROFILE
+	AppAI_EpochProfileSlot_t *slot = app_ai_epoch_profile_active;
+
+	app_ai_epoch_profile_active = NULL;
+	if (slot == NULL)
+	{
+		return;
+	}
+	AppEpochProfile_EndRun(&slot->profile, completed);
+	if (slot->profile.run_count >= APP_AI_EPOCH_PROFILE_REPORT_RUNS)
+	{
+		AppAI_ReportEpochProfile(slot);
+	}
+#else
+	(void)completed;
+#endif
+}
+
+uint32_t AppAI_GetNpuRunCount(void)
+{
+	return app_ai_npu_run_count;
+}
+
+bool AppAI_IsBusMasterActive(void)
+{
+	const uint32_t xspi_state = hxspi_nor[0U].State;
+
+	/* Memory-mapped mode is the idle state; anything else but READY is an
+	 * indirect command (probe, erase, program) in flight. */
+	return app_ai_npu_epochs_running
+		|| ((xspi_state != HAL_XSPI_STATE_READY)
+			&& (xspi_state != HAL_XSPI_STATE_BUSY_MEM_MAPPED)
+			&& (xspi_state != HAL_XSPI_STATE_RESET));
+}
+
+void AppAI_Xspi2ResetFlashForReboot(void)
+{
+	XSPI_HandleTypeDef *const hxspi = &hxspi_nor[0U];
+	const MX25UM51245G_Transfer_t rate =
+		(Xspi_Nor_Ctx[0U].TransferRate == BSP_XSPI_NOR_DTR_TRANSFER) ? MX25UM51245G_DTR_TRANSFER
+																	 : MX25UM51245G_STR_TRANSFER;
+
+	/* SPI mode is what the boot ROM expects; nothing to undo. */
+	if ((hxspi->State == HAL_XSPI_STATE_RESET) || (Xspi_Nor_Ctx[0U].InterfaceMode != BSP_XSPI_NOR_OPI_MODE))
+	{
+		return;
+	}
+	/* Leave memory-mapped mode so the controller accepts indirect commands. */
+	(void)HAL_XSPI_Abort(hxspi);
+	if (MX25UM51245G_ResetEnable(hxspi, MX25UM51245G_OPI_MODE, rate) == MX25UM51245G_OK)
+	{
+		(void)MX25UM51245G_ResetMemory(hxspi, MX25UM51245G_OPI_MODE, rate);
+	}
+}
@@ -37,6 +37,8 @@
 #include "app_ai_types.h"
 #include "app_ai_logging.h"
 #include "app_ai_xspi2.h"
+#include "app_xspi2_residency.h"
+#include "app_npu_stage_context.h"
 #include "app_ai_preprocess.h"
 #include "app_ai_stage_obb.h"
 #include "app_ai_stage_tip_focus.h"
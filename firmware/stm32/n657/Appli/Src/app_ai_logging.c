@@ -20,6 +20,7 @@
 #include "app_gauge_geometry.h"
 #include "app_inner_celsius_mask.h"
 #include "app_ai_config.h"
+#include "app_camera_buffers.h"
 #define LL_ATON_PLATFORM LL_ATON_PLAT_STM32N6
 #define LL_ATON_OSAL LL_ATON_OSAL_THREADX
 #include "tx_api.h"
@@ -38,6 +38,7 @@
 #include "app_ai_xspi2.h"
 #include "app_ai_stage_obb.h"
 #include "app_ai_stage_tip_focus.h"
+#include "app_camera_buffers.h"
 #include "ina219_power.h"
 #include "inference_metrics.h"
 #include "app_ai_helpers_runtime.inc"
@@ -33,6 +33,7 @@
 #include "stm32n6xx_hal.h"
 
 #include "app_ai_xspi2.h"
+#include "app_xspi_dtr.h"
 #include "app_ai_state.h"
 #include "app_ai_types.h"
 #include "app_ai_inference.h"
@@ -17,10 +17,13 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "app_boot.h"
 #include "app_camera_buffers.h"
+#include "app_clocks.h"
 #include "app_ai_config.h"
 #include "app_baseline_hough.h"
 #include "app_baseline_template.h"
+#include "app_frame_format.h"
 #include "app_gauge_geometry.h"
 #include "app_inference_log_utils.h"
 #include "app_memory_budget.h"
@@ -296,6 +299,9 @@ static size_t camera_baseline_estimate_history_next_index = 0U;
 static bool camera_baseline_current_frame_is_bright = false;
 static float camera_baseline_current_frame_mean_luma = 0.0f;
 static float camera_baseline_current_frame_bright_ratio = 0.0f;
+/* Pixel layout of the frame being estimated, inferred from its length. */
+static AppFrameFormat_t camera_baseline_current_frame_format =
+	APP_FRAME_FORMAT_YUV422;
 /* Last-estimate state shared between the worker thread and other modules. */
 static bool camera_baseline_last_result_valid = false;
 static float camera_baseline_last_temperature_c = 0.0f;
@@ -455,6 +461,7 @@ static void AppBaselineRuntime_StoreLastEstimate(
 	camera_baseline_last_angle_rad = estimate->angle_rad;
 	camera_baseline_last_confidence = estimate->confidence;
 	camera_baseline_last_result_generation++;
+	AppBoot_NotifyReading("baseline");
 }
 
 /**
@@ -669,6 +676,7 @@ bool AppBaselineRuntime_RequestEstimate(const uint8_t *frame_ptr,
 	Metrics_StartInference("BASELINE");
 	(void)memcpy((void *)camera_inference_frame_snapshot, frame_ptr,
 				 (size_t)frame_length);
+	AppCameraBuffers_AdoptSnapshotDescriptor(frame_ptr, (size_t)frame_length);
 	(void)memcpy(first8, camera_inference_frame_snapshot,
 				 (size_t)((frame_length < 8U) ? frame_length : 8U));
 	DebugConsole_Printf(
@@ -758,8 +766,13 @@ static VOID CameraBaselineThread_Entry(ULONG thread_input)
 			(unsigned long)request_generation,
 			(unsigned long)frame_length);
 
-		if (!AppBaselineRuntime_EstimateFromFrame(frame_ptr,
-																  (size_t)frame_length, &estimate))
+		(void)AppClocks_SetDemand(APP_CLOCK_CLIENT_BASELINE,
+								  APP_CLOCK_PROFILE_BOOST);
+		const bool estimate_ok = AppBaselineRuntime_EstimateFromFrame(
+			frame_ptr, (size_t)frame_length, &estimate);
+		(void)AppClocks_SetDemand(APP_CLOCK_CLIENT_BASELINE,
+								  APP_CLOCK_PROFILE_LOW);
+		if (!estimate_ok)
 		{
 			/* Fail closed: a stale value is still an inaccurate publication when
 			 * the physical setpoint has moved or the previous geometry was wrong. */
@@ -904,7 +917,10 @@ static bool AppBaselineRuntime_EstimateFromFrame(const uint8_t *frame_bytes,
 	 * five center hypotheses, polar spoke voting, local refinement, consensus,
 	 * and one final acceptance gate. Template labels are kept for offline
 	 * evaluation only and are not allowed to publish a baseline reading. */
-	if ((frame_bytes == NULL) || (estimate_out == NULL))
+	if ((frame_bytes == NULL) || (estimate_out == NULL) ||
+		!AppFrameFormat_FromLength(CAMERA_CAPTURE_WIDTH_PIXELS,
+								   CAMERA_CAPTURE_HEIGHT_PIXELS, frame_size,
+								   &camera_baseline_current_frame_format))
 	{
 		return false;
 	}
@@ -2033,7 +2049,8 @@ static bool AppBaselineRuntime_EstimateCenterFromBrightPixels(
 {
 	const size_t width_pixels = CAMERA_CAPTURE_WIDTH_PIXELS;
 	const size_t height_pixels = CAMERA_CAPTURE_HEIGHT_PIXELS;
-	const size_t stride_bytes = width_pixels * CAMERA_CAPTURE_BYTES_PER_PIXEL;
+	const size_t stride_bytes = width_pixels *
+		AppFrameFormat_BytesPerPixel(camera_baseline_current_frame_format);
 	size_t inner_center_x = 0U;
 	size_t inner_center_y = 0U;
 	AppGaugeGeometry_TrainingCropCenter(width_pixels, height_pixels,
@@ -3294,20 +3311,52 @@ static bool AppBaselineRuntime_AngleToSweepFractionWithMargin(float angle_rad,
 	return true;
 }
 
+/**
+ * @brief Take the brightness profile from the snapshot's ingest descriptor.
+ *
+ * @retval false when the descriptor does not cover this frame or sampled a
+ *         different crop, step or bright level; the caller scans instead.
+ */
+static bool AppBaselineRuntime_ReadIngestBrightness(
+	const uint8_t *frame_bytes, size_t frame_size,
+	const AppGaugeGeometry_Crop_t *crop, uint64_t *luma_sum_out,
+	size_t *sample_count_out, size_t *bright_count_out)
+{
+	const AppFrameIngest_Descriptor_t *const d =
+		&camera_inference_frame_descriptor;
+
+	if (!AppFrameIngest_Describes(d, frame_bytes, frame_size) ||
+		(d->format != camera_baseline_current_frame_format) ||
+		(d->crop.crop_x_min != crop->x_min) ||
+		(d->crop.crop_y_min != crop->y_min) ||
+		(d->crop.crop_x_end != (crop->x_min + crop->width)) ||
+		(d->crop.crop_y_end != (crop->y_min + crop->height)) ||
+		(d->crop.crop_step != 2U) || (d->crop.crop_bright_level != 180U))
+	{
+		return false;
+	}
+
+	*luma_sum_out = d->crop_luma_sum;
+	*sample_count_out = d->crop_sample_count;
+	*bright_count_out = d->crop_bright_count;
+	return true;
+}
+
 /**
  * @brief Update per-frame brightness profile for adaptive thresholding.
  *
  * We sample the training crop region (step 2) and classify a frame as
  * "bright" when the average luma is high or a large fraction of pixels are
- * above the capture bright threshold.
+ * above the capture bright threshold. The capture's ingest pass already
+ * sampled the same grid, so the scan only runs for frames it did not see.
  */
 static void AppBaselineRuntime_UpdateFrameBrightnessProfile(
 	const uint8_t *frame_bytes, size_t frame_size)
 {
 	const size_t width_pixels = CAMERA_CAPTURE_WIDTH_PIXELS;
 	const size_t height_pixels = CAMERA_CAPTURE_HEIGHT_PIXELS;
-	const size_t expected_size =
-		width_pixels * height_pixels * CAMERA_CAPTURE_BYTES_PER_PIXEL;
+	const size_t expected_size = AppFrameFormat_FrameBytes(
+		camera_baseline_current_frame_format, width_pixels, height_pixels);
 	const AppGaugeGeometry_Crop_t crop =
 		AppGaugeGeometry_TrainingCrop(width_pixels, height_pixels);
 	uint64_t luma_sum = 0U;
@@ -3324,17 +3373,23 @@ static void AppBaselineRuntime_UpdateFrameBrightnessProfile(
 		return;
 	}
 
-	for (size_t y = crop.y_min; y < (crop.y_min + crop.height); y += 2U)
+	if (!AppBaselineRuntime_ReadIngestBrightness(frame_bytes, frame_size,
+												 &crop, &luma_sum,
+												 &sample_count, &bright_count))
 	{
-		for (size_t x = crop.x_min; x < (crop.x_min + crop.width); x += 2U)
+		for (size_t y = crop.y_min; y < (crop.y_min + crop.height); y += 2U)
 		{
-			const float luma =
-				AppBaselineRuntime_ReadLuma(frame_bytes, width_pixels, x, y);
-			luma_sum += (uint64_t)AppBaselineRuntime_RoundToLong(luma);
-			sample_count++;
-			if (luma >= 180.0f)
+			for (size_t x = crop.x_min; x < (crop.x_min + crop.width);
+				 x += 2U)
 			{
-				bright_count++;
+				const float luma = AppBaselineRuntime_ReadLuma(
+					frame_bytes, width_pixels, x, y);
+				luma_sum += (uint64_t)AppBaselineRuntime_RoundToLong(luma);
+				sample_count++;
+				if (luma >= 180.0f)
+				{
+					bright_count++;
+				}
 			}
 		}
 	}
@@ -3398,16 +3453,13 @@ static bool AppBaselineRuntime_IsAngleInSubdialBand(float angle_deg)
 }
 
 /**
- * @brief Read the Y component from one packed YUV422 pixel.
+ * @brief Read the Y component of one pixel of the current YUV422 or Y8 frame.
  */
 static float AppBaselineRuntime_ReadLuma(const uint8_t *frame_bytes,
 										 size_t frame_width_pixels, size_t x, size_t y)
 {
-	const size_t row_stride_bytes = frame_width_pixels * 2U;
-	const size_t pair_offset = (y * row_stride_bytes) + ((x & ~1U) * 2U);
-	const size_t y_offset = pair_offset + (((x & 1U) != 0U) ? 2U : 0U);
-
-	return (float)frame_bytes[y_offset];
+	return (float)frame_bytes[AppFrameFormat_LumaOffset(
+		camera_baseline_current_frame_format, frame_width_pixels, x, y)];
 }
 
 /**
@@ -3438,6 +3490,9 @@ static float AppBaselineRuntime_ReadLumaMin3x3(const uint8_t *frame_bytes,
 
 /**
  * @brief Read the U and V components from one packed YUV422 pixel pair.
+ *
+ * Y8 frames report neutral chroma, which makes the colour-variance penalty
+ * a no-op rather than a false reject.
  */
 static void AppBaselineRuntime_ReadChroma(const uint8_t *frame_bytes,
 										  size_t frame_width_pixels, size_t x, size_t y,
@@ -3446,6 +3501,19 @@ static void AppBaselineRuntime_ReadChroma(const uint8_t *frame_bytes,
 	const size_t row_stride_bytes = frame_width_pixels * 2U;
 	const size_t pair_offset = (y * row_stride_bytes) + ((x & ~1U) * 2U);
 
+	if (camera_baseline_current_frame_format == APP_FRAME_FORMAT_Y8)
+	{
+		if (u_out != NULL)
+		{
+			*u_out = (float)APP_FRAME_FORMAT_NEUTRAL_CHROMA;
+		}
+		if (v_out != NULL)
+		{
+			*v_out = (float)APP_FRAME_FORMAT_NEUTRAL_CHROMA;
+		}
+		return;
+	}
+
 	if (u_out != NULL)
 	{
 		*u_out = (float)frame_bytes[pair_offset + 1U];
@@ -3927,7 +3995,8 @@ bool AppBaselineRuntime_EstimatePolarNeedle(
 		return false;
 	}
 
-	if (frame_size < (frame_width_pixels * frame_height_pixels * CAMERA_CAPTURE_BYTES_PER_PIXEL))
+	if (frame_size < AppFrameFormat_FrameBytes(camera_baseline_current_frame_format,
+											   frame_width_pixels, frame_height_pixels))
 	{
 		return false;
 	}
@@ -0,0 +1,277 @@
+/*
+ *******************************************************************************
+ * @file    app_boot.c
+ * @brief   Boot orchestrator: runs init tasks concurrently by dependency.
+ *******************************************************************************
+ */
+
+#include "app_boot.h"
+
+#include "main.h"
+#include "app_boot_graph.h"
+#include "app_threadx_config.h"
+#include "debug_console.h"
+
+/* One wake-up bit per lane plus one for AppBoot_WaitForTasks(), so every
+ * waiter sees each graph change even though they clear on read. */
+#define APP_BOOT_EVENT_LANE(lane)   (1UL << (uint32_t) (lane))
+#define APP_BOOT_EVENT_WAITER       (1UL << 3)
+#define APP_BOOT_EVENT_ALL          (APP_BOOT_EVENT_LANE(APP_BOOT_LANE_CAMERA) \
+		| APP_BOOT_EVENT_LANE(APP_BOOT_LANE_AI) | APP_BOOT_EVENT_WAITER)
+
+/*
+ * Camera lane: probe -> sensor config -> RTC re-read -> AE seed.
+ * AI lane:     NPU/RISAF config -> model init (weights check, ATON, network).
+ * External:    SD mount, reported by the FileX thread.
+ *
+ * The model no longer waits for the camera, and neither waits for the SD
+ * card. The AE seed reads its per-hour table from SD, so it holds for the
+ * mount only until APP_BOOT_AE_SEED_SD_DEADLINE_MS after reset and then
+ * runs with whatever is in RAM; the capture path retries the load later.
+ * The RTC re-read rides the camera lane because it is a few I2C1
+ * transactions and the AE seed needs the hour.
+ */
+static const AppBootGraph_TaskDesc_t app_boot_tasks[APP_BOOT_TASK_COUNT] = {
+	[APP_BOOT_TASK_NPU_CONFIG] = { "npu-config", APP_BOOT_LANE_AI, 0U, 0U,
+			0U },
+	[APP_BOOT_TASK_MODEL_INIT] = { "model-init", APP_BOOT_LANE_AI,
+			APP_BOOT_TASK_MASK(APP_BOOT_TASK_NPU_CONFIG), 0U, 0U },
+	[APP_BOOT_TASK_CAMERA_PROBE] = { "camera-probe", APP_BOOT_LANE_CAMERA, 0U,
+			0U, 0U },
+	[APP_BOOT_TASK_SENSOR_CONFIG] = { "sensor-config", APP_BOOT_LANE_CAMERA,
+			APP_BOOT_TASK_MASK(APP_BOOT_TASK_CAMERA_PROBE), 0U, 0U },
+	[APP_BOOT_TASK_RTC] = { "rtc", APP_BOOT_LANE_CAMERA,
+			APP_BOOT_TASK_MASK(APP_BOOT_TASK_SENSOR_CONFIG), 0U, 0U },
+	[APP_BOOT_TASK_AE_SEED] = { "ae-seed", APP_BOOT_LANE_CAMERA,
+			APP_BOOT_TASK_MASK(APP_BOOT_TASK_SENSOR_CONFIG),
+			APP_BOOT_TASK_MASK(APP_BOOT_TASK_SD_MOUNT)
+					| APP_BOOT_TASK_MASK(APP_BOOT_TASK_RTC),
+			APP_BOOT_AE_SEED_SD_DEADLINE_MS },
+	[APP_BOOT_TASK_SD_MOUNT] = { "sd-mount", APP_BOOT_LANE_EXTERNAL, 0U, 0U,
+			0U },
+};
+
+static AppBootGraph_t app_boot_graph;
+static TX_MUTEX app_boot_mutex;
+static TX_EVENT_FLAGS_GROUP app_boot_events;
+static bool app_boot_initialized = false;
+static bool app_boot_reading_seen = false;
+
+static const char *AppBoot_LaneName(uint32_t lane) {
+	switch (lane) {
+	case APP_BOOT_LANE_CAMERA:
+		return "camera";
+	case APP_BOOT_LANE_AI:
+		return "ai";
+	default:
+		return "ext";
+	}
+}
+
+/**
+ * @brief Convert a millisecond wait into ThreadX ticks, rounding up.
+ */
+static ULONG AppBoot_MillisecondsToTicks(uint32_t timeout_ms) {
+	if (timeout_ms == APP_BOOT_GRAPH_WAIT_FOREVER) {
+		return TX_WAIT_FOREVER;
+	}
+	return (ULONG) ((((uint64_t) timeout_ms * TX_TIMER_TICKS_PER_SECOND)
+			+ 999U) / 1000U) + 1U;
+}
+
+/**
+ * @brief Record an outcome and wake every lane that may now proceed.
+ */
+static void AppBoot_Complete(size_t index, bool success) {
+	bool recorded = false;
+
+	(void) tx_mutex_get(&app_boot_mutex, TX_WAIT_FOREVER);
+	recorded = AppBootGraph_Complete(&app_boot_graph, index, success,
+			HAL_GetTick());
+	tx_mutex_put(&app_boot_mutex);
+
+	if (!recorded) {
+		return;
+	}
+	DebugConsole_Printf("[BOOT] %s %s at %lu ms\r\n",
+			app_boot_tasks[index].name, success ? "done" : "failed",
+			(unsigned long) app_boot_graph.end_ms[index]);
+	(void) tx_event_flags_set(&app_boot_events, APP_BOOT_EVENT_ALL, TX_OR);
+}
+
+/**
+ * @brief Print every task's window, relative to reset.
+ */
+static void AppBoot_LogTimeline(void) {
+	AppBootGraph_t snapshot;
+
+	(void) tx_mutex_get(&app_boot_mutex, TX_WAIT_FOREVER);
+	snapshot = app_boot_graph;
+	tx_mutex_put(&app_boot_mutex);
+
+	for (size_t i = 0U; i < snapshot.task_count; i++) {
+		const bool finished = (snapshot.state[i] != APP_BOOT_TASK_PENDING)
+				&& (snapshot.state[i] != APP_BOOT_TASK_RUNNING);
+
+		DebugConsole_Printf(
+				"[BOOT][TIMELINE] %-13s lane=%-6s start=%6lu end=%6lu took=%5lu ms %s\r\n",
+				app_boot_tasks[i].name,
+				AppBoot_LaneName(app_boot_tasks[i].lane),
+				(unsigned long) snapshot.start_ms[i],
+				(unsigned long) (finished ? snapshot.end_ms[i] : 0U),
+				(unsigned long) (finished ?
+						(snapshot.end_ms[i] - snapshot.start_ms[i]) : 0U),
+				AppBootGraph_StateName(snapshot.state[i]));
+	}
+}
+
+/**
+ * @brief Create the orchestrator objects and reset the task graph.
+ * @retval TX_SUCCESS when the lanes can start.
+ */
+UINT AppBoot_Init(void) {
+	UINT status = TX_SUCCESS;
+
+	if (app_boot_initialized) {
+		return TX_SUCCESS;
+	}
+
+	/* Origin 0 is reset, so the timeline includes the pre-kernel main(). */
+	if (!AppBootGraph_Init(&app_boot_graph, app_boot_tasks,
+			APP_BOOT_TASK_COUNT, 0U)) {
+		DebugConsole_Printf("[BOOT] Boot task table is invalid.\r\n");
+		return TX_NOT_AVAILABLE;
+	}
+
+	status = tx_mutex_create(&app_boot_mutex, "app_boot", TX_INHERIT);
+	if (status != TX_SUCCESS) {
+		return status;
+	}
+	status = tx_event_flags_create(&app_boot_events, "app_boot_events");
+	if (status != TX_SUCCESS) {
+		return status;
+	}
+
+	app_boot_initialized = true;
+	return TX_SUCCESS;
+}
+
+/**
+ * @brief Run every task of one lane on the calling thread, in dependency
+ *        order, blocking while the lane waits on other lanes.
+ */
+void AppBoot_RunLane(AppBoot_Lane_t lane, AppBoot_TaskRunner_t runner) {
+	if (!app_boot_initialized || (runner == NULL)) {
+		return;
+	}
+
+	for (;;) {
+		size_t index = 0U;
+		uint32_t wait_ms = APP_BOOT_GRAPH_WAIT_FOREVER;
+		ULONG actual_flags = 0U;
+		AppBootGraph_Next_t next = APP_BOOT_GRAPH_NEXT_FINISHED;
+		bool success = false;
+
+		(void) tx_mutex_get(&app_boot_mutex, TX_WAIT_FOREVER);
+		next = AppBootGraph_TakeNext(&app_boot_graph, (uint32_t) lane,
+				HAL_GetTick(), &index, &wait_ms);
+		tx_mutex_put(&app_boot_mutex);
+
+		if (next == APP_BOOT_GRAPH_NEXT_FINISHED) {
+			return;
+		}
+		if (next == APP_BOOT_GRAPH_NEXT_WAIT) {
+			(void) tx_event_flags_get(&app_boot_events,
+					APP_BOOT_EVENT_LANE(lane), TX_OR_CLEAR, &actual_flags,
+					AppBoot_MillisecondsToTicks(wait_ms));
+			continue;
+		}
+
+		DebugConsole_Printf("[BOOT] %s start at %lu ms (lane=%s)\r\n",
+				app_boot_tasks[index].name,
+				(unsigned long) app_boot_graph.start_ms[index],
+				AppBoot_LaneName(lane));
+		success = runner((AppBoot_Task_t) index);
+		AppBoot_Complete(index, success);
+	}
+}
+
+/**
+ * @brief Report a task that another subsystem runs on its own thread.
+ *
+ * Later reports for the same task (an SD remount, say) are ignored.
+ */
+void AppBoot_CompleteExternal(AppBoot_Task_t task, bool success) {
+	if (!app_boot_initialized || (task >= APP_BOOT_TASK_COUNT)) {
+		return;
+	}
+	AppBoot_Complete((size_t) task, success);
+}
+
+/**
+ * @brief Block until every task in the mask has finished or failed.
+ * @retval false on timeout.
+ */
+bool AppBoot_WaitForTasks(uint32_t task_mask, uint32_t timeout_ms) {
+	const ULONG start_tick = tx_time_get();
+	const ULONG timeout_ticks = AppBoot_MillisecondsToTicks(timeout_ms);
+
+	if (!app_boot_initialized) {
+		return false;
+	}
+
+	for (;;) {
+		ULONG actual_flags = 0U;
+		ULONG elapsed_ticks = 0U;
+		bool settled = false;
+
+		(void) tx_mutex_get(&app_boot_mutex, TX_WAIT_FOREVER);
+		settled = AppBootGraph_IsSettled(&app_boot_graph, task_mask);
+		tx_mutex_put(&app_boot_mutex);
+		if (settled) {
+			return true;
+		}
+
+		elapsed_ticks = tx_time_get() - start_tick;
+		if (elapsed_ticks >= timeout_ticks) {
+			return false;
+		}
+		(void) tx_event_flags_get(&app_boot_events, APP_BOOT_EVENT_WAITER,
+				TX_OR_CLEAR, &actual_flags, timeout_ticks - elapsed_ticks);
+	}
+}
+
+/**
+ * @brief true when the task ran and succeeded.
+ */
+bool AppBoot_TaskSucceeded(AppBoot_Task_t task) {
+	return app_boot_initialized && (task < APP_BOOT_TASK_COUNT)
+			&& (app_boot_graph.state[task] == APP_BOOT_TASK_DONE);
+}
+
+/**
+ * @brief Mark the first published reading and print the boot timeline.
+ *
+ * Only the first call after reset logs; later readings return at once.
+ */
+void AppBoot_NotifyReading(const char *source) {
+	bool first = false;
+
+	if (!app_boot_initialized) {
+		return;
+	}
+
+	/* The AI worker and the baseline worker can both get here first. */
+	(void) tx_mutex_get(&app_boot_mutex, TX_WAIT_FOREVER);
+	first = !app_boot_reading_seen;
+	app_boot_reading_seen = true;
+	tx_mutex_put(&app_boot_mutex);
+	if (!first) {
+		return;
+	}
+
+	DebugConsole_Printf("[BOOT] time-to-first-reading=%lu ms (source=%s)\r\n",
+			(unsigned long) HAL_GetTick(),
+			(source != NULL) ? source : "unknown");
+	AppBoot_LogTimeline();
+}
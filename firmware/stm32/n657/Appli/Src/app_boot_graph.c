@@ -0,0 +1,212 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_boot_graph.c
+ * @brief   Dependency graph for boot-time initialization tasks.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#include "app_boot_graph.h"
+
+/**
+ * @brief Mask of tasks currently in @p state.
+ */
+static uint32_t AppBootGraph_MaskInState(const AppBootGraph_t *graph_ptr,
+		AppBootGraph_TaskState_t state) {
+	uint32_t mask = 0U;
+
+	for (size_t i = 0U; i < graph_ptr->task_count; i++) {
+		if (graph_ptr->state[i] == state) {
+			mask |= APP_BOOT_GRAPH_TASK_BIT(i);
+		}
+	}
+	return mask;
+}
+
+/**
+ * @brief Mask of tasks that will not change state again.
+ */
+static uint32_t AppBootGraph_SettledMask(const AppBootGraph_t *graph_ptr) {
+	return AppBootGraph_MaskInState(graph_ptr, APP_BOOT_TASK_DONE)
+			| AppBootGraph_MaskInState(graph_ptr, APP_BOOT_TASK_FAILED)
+			| AppBootGraph_MaskInState(graph_ptr, APP_BOOT_TASK_SKIPPED);
+}
+
+/**
+ * @brief Reset the graph, rejecting unknown, self or cyclic dependencies.
+ */
+bool AppBootGraph_Init(AppBootGraph_t *graph_ptr,
+		const AppBootGraph_TaskDesc_t *tasks_ptr, size_t task_count,
+		uint32_t origin_ms) {
+	uint32_t all_tasks = 0U;
+	uint32_t resolved = 0U;
+	bool progressed = true;
+
+	if ((graph_ptr == NULL) || (tasks_ptr == NULL) || (task_count == 0U)
+			|| (task_count > APP_BOOT_GRAPH_MAX_TASKS)) {
+		return false;
+	}
+	all_tasks = (uint32_t) (APP_BOOT_GRAPH_TASK_BIT(task_count) - 1U);
+
+	for (size_t i = 0U; i < task_count; i++) {
+		const uint32_t deps = tasks_ptr[i].hard_deps | tasks_ptr[i].soft_deps;
+
+		if (((deps & ~all_tasks) != 0U)
+				|| ((deps & APP_BOOT_GRAPH_TASK_BIT(i)) != 0U)) {
+			return false;
+		}
+	}
+
+	/* Peel off tasks whose dependencies are all resolved; anything left
+	 * over sits on a cycle and would never run. */
+	while (progressed && (resolved != all_tasks)) {
+		progressed = false;
+		for (size_t i = 0U; i < task_count; i++) {
+			const uint32_t deps = tasks_ptr[i].hard_deps
+					| tasks_ptr[i].soft_deps;
+
+			if (((resolved & APP_BOOT_GRAPH_TASK_BIT(i)) == 0U)
+					&& ((deps & ~resolved) == 0U)) {
+				resolved |= APP_BOOT_GRAPH_TASK_BIT(i);
+				progressed = true;
+			}
+		}
+	}
+	if (resolved != all_tasks) {
+		return false;
+	}
+
+	graph_ptr->tasks = tasks_ptr;
+	graph_ptr->task_count = task_count;
+	graph_ptr->origin_ms = origin_ms;
+	for (size_t i = 0U; i < APP_BOOT_GRAPH_MAX_TASKS; i++) {
+		graph_ptr->state[i] = APP_BOOT_TASK_PENDING;
+		graph_ptr->start_ms[i] = origin_ms;
+		graph_ptr->end_ms[i] = origin_ms;
+	}
+	return true;
+}
+
+/**
+ * @brief Claim the next runnable task for a lane.
+ */
+AppBootGraph_Next_t AppBootGraph_TakeNext(AppBootGraph_t *graph_ptr,
+		uint32_t lane, uint32_t now_ms, size_t *index_out,
+		uint32_t *wait_ms_out) {
+	uint32_t elapsed_ms = 0U;
+	uint32_t done = 0U;
+	uint32_t settled = 0U;
+	uint32_t wait_ms = APP_BOOT_GRAPH_WAIT_FOREVER;
+	bool lane_busy = false;
+
+	if ((graph_ptr == NULL) || (index_out == NULL)) {
+		return APP_BOOT_GRAPH_NEXT_FINISHED;
+	}
+
+	elapsed_ms = now_ms - graph_ptr->origin_ms;
+	done = AppBootGraph_MaskInState(graph_ptr, APP_BOOT_TASK_DONE);
+	settled = AppBootGraph_SettledMask(graph_ptr);
+	for (size_t i = 0U; i < graph_ptr->task_count; i++) {
+		const AppBootGraph_TaskDesc_t *const task = &graph_ptr->tasks[i];
+
+		if ((task->lane != lane)
+				|| (graph_ptr->state[i] != APP_BOOT_TASK_PENDING)) {
+			continue;
+		}
+		lane_busy = true;
+		if ((task->hard_deps & ~done) != 0U) {
+			continue;
+		}
+		if (((task->soft_deps & ~settled) != 0U)
+				&& (elapsed_ms < task->soft_deadline_ms)) {
+			if ((task->soft_deadline_ms - elapsed_ms) < wait_ms) {
+				wait_ms = task->soft_deadline_ms - elapsed_ms;
+			}
+			continue;
+		}
+
+		graph_ptr->state[i] = APP_BOOT_TASK_RUNNING;
+		graph_ptr->start_ms[i] = now_ms;
+		*index_out = i;
+		return APP_BOOT_GRAPH_NEXT_READY;
+	}
+
+	if (!lane_busy) {
+		return APP_BOOT_GRAPH_NEXT_FINISHED;
+	}
+	if (wait_ms_out != NULL) {
+		*wait_ms_out = wait_ms;
+	}
+	return APP_BOOT_GRAPH_NEXT_WAIT;
+}
+
+/**
+ * @brief Record a task outcome and skip whatever can no longer run.
+ */
+bool AppBootGraph_Complete(AppBootGraph_t *graph_ptr, size_t index,
+		bool success, uint32_t now_ms) {
+	bool changed = true;
+
+	if ((graph_ptr == NULL) || (index >= graph_ptr->task_count)
+			|| ((graph_ptr->state[index] != APP_BOOT_TASK_PENDING)
+					&& (graph_ptr->state[index] != APP_BOOT_TASK_RUNNING))) {
+		return false;
+	}
+
+	if (graph_ptr->state[index] == APP_BOOT_TASK_PENDING) {
+		graph_ptr->start_ms[index] = graph_ptr->origin_ms;
+	}
+	graph_ptr->state[index] = success ?
+			APP_BOOT_TASK_DONE : APP_BOOT_TASK_FAILED;
+	graph_ptr->end_ms[index] = now_ms;
+	if (success) {
+		return true;
+	}
+
+	while (changed) {
+		const uint32_t broken = AppBootGraph_MaskInState(graph_ptr,
+				APP_BOOT_TASK_FAILED)
+				| AppBootGraph_MaskInState(graph_ptr, APP_BOOT_TASK_SKIPPED);
+
+		changed = false;
+		for (size_t i = 0U; i < graph_ptr->task_count; i++) {
+			if ((graph_ptr->state[i] == APP_BOOT_TASK_PENDING)
+					&& ((graph_ptr->tasks[i].hard_deps & broken) != 0U)) {
+				graph_ptr->state[i] = APP_BOOT_TASK_SKIPPED;
+				graph_ptr->start_ms[i] = now_ms;
+				graph_ptr->end_ms[i] = now_ms;
+				changed = true;
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief true once every task in the mask has finished one way or another.
+ */
+bool AppBootGraph_IsSettled(const AppBootGraph_t *graph_ptr,
+		uint32_t task_mask) {
+	if (graph_ptr == NULL) {
+		return false;
+	}
+	return (task_mask & ~AppBootGraph_SettledMask(graph_ptr)) == 0U;
+}
+
+const char *AppBootGraph_StateName(AppBootGraph_TaskState_t state) {
+	switch (state) {
+	case APP_BOOT_TASK_PENDING:
+		return "pending";
+	case APP_BOOT_TASK_RUNNING:
+		return "running";
+	case APP_BOOT_TASK_DONE:
+		return "done";
+	case APP_BOOT_TASK_FAILED:
+		return "failed";
+	case APP_BOOT_TASK_SKIPPED:
+		return "skipped";
+	default:
+		return "unknown";
+	}
+}
@@ -0,0 +1,200 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_burst_fusion.c
+ * @brief   Align and merge a short burst of frames into one denoised frame.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#include "app_burst_fusion.h"
+
+/**
+ * @brief Mean absolute luma difference for one candidate shift, scaled by 16
+ *        to keep some sub-level resolution in integer arithmetic.
+ * @retval UINT32_MAX when the overlap is too small to judge.
+ */
+static uint32_t AppBurstFusion_ShiftCost(const uint8_t *reference_ptr,
+		const uint8_t *frame_ptr, size_t bytes_per_pixel, size_t width_pixels,
+		size_t height_pixels, int32_t dx, int32_t dy) {
+	const int32_t width = (int32_t) width_pixels;
+	const int32_t height = (int32_t) height_pixels;
+	int32_t x_begin = (dx < 0) ? -dx : 0;
+	const int32_t x_end = (dx > 0) ? (width - dx) : width;
+	const int32_t y_begin = (dy < 0) ? -dy : 0;
+	const int32_t y_end = (dy > 0) ? (height - dy) : height;
+	uint64_t sum = 0U;
+	uint32_t count = 0U;
+
+	/* Sample even columns so both offsets land on a YUYV luma byte. */
+	x_begin += (x_begin & 1);
+	for (int32_t y = y_begin; y < y_end; y += 2) {
+		const uint8_t *const reference_row = reference_ptr
+				+ ((size_t) y * width_pixels * bytes_per_pixel);
+		const uint8_t *const frame_row = frame_ptr
+				+ ((size_t) (y + dy) * width_pixels * bytes_per_pixel);
+
+		for (int32_t x = x_begin; x < x_end; x += 2) {
+			const int32_t a = reference_row[(size_t) x * bytes_per_pixel];
+			const int32_t b = frame_row[(size_t) (x + dx) * bytes_per_pixel];
+
+			sum += (uint32_t) ((a > b) ? (a - b) : (b - a));
+			count++;
+		}
+	}
+
+	if ((count == 0U)
+			|| (count < ((width_pixels / 2U) * (height_pixels / 2U) / 4U))) {
+		return UINT32_MAX;
+	}
+	return (uint32_t) ((sum * 16U) / count);
+}
+
+/**
+ * @brief Find the integer shift that best registers a frame onto the
+ *        reference.
+ */
+bool AppBurstFusion_EstimateShift(const uint8_t *reference_ptr,
+		const uint8_t *frame_ptr, AppFrameFormat_t format, size_t width_pixels,
+		size_t height_pixels, uint32_t max_shift_pixels,
+		AppBurstFusion_Shift_t *shift_out) {
+	const size_t bytes_per_pixel = AppFrameFormat_BytesPerPixel(format);
+	const int32_t dx_step = (format == APP_FRAME_FORMAT_YUV422) ? 2 : 1;
+	int32_t max_shift = (int32_t) max_shift_pixels;
+	int32_t max_dx = 0;
+	uint32_t best_cost = 0U;
+
+	if ((reference_ptr == NULL) || (frame_ptr == NULL) || (shift_out == NULL)
+			|| (width_pixels < 4U) || (height_pixels < 4U)) {
+		return false;
+	}
+
+	if ((size_t) max_shift >= (height_pixels / 2U)) {
+		max_shift = (int32_t) (height_pixels / 2U) - 1;
+	}
+	if ((size_t) max_shift >= (width_pixels / 2U)) {
+		max_shift = (int32_t) (width_pixels / 2U) - 1;
+	}
+	max_dx = max_shift - (max_shift % dx_step);
+
+	/* Zero shift wins ties, so a static scene never drifts. */
+	shift_out->dx = 0;
+	shift_out->dy = 0;
+	best_cost = AppBurstFusion_ShiftCost(reference_ptr, frame_ptr,
+			bytes_per_pixel, width_pixels, height_pixels, 0, 0);
+
+	for (int32_t dy = -max_shift; dy <= max_shift; dy++) {
+		for (int32_t dx = -max_dx; dx <= max_dx; dx += dx_step) {
+			uint32_t cost = 0U;
+
+			if ((dx == 0) && (dy == 0)) {
+				continue;
+			}
+			cost = AppBurstFusion_ShiftCost(reference_ptr, frame_ptr,
+					bytes_per_pixel, width_pixels, height_pixels, dx, dy);
+			if (cost < best_cost) {
+				best_cost = cost;
+				shift_out->dx = dx;
+				shift_out->dy = dy;
+			}
+		}
+	}
+
+	return true;
+}
+
+/**
+ * @brief Median of a handful of samples; even counts round the middle pair.
+ */
+static uint8_t AppBurstFusion_Median(uint8_t *samples, size_t count) {
+	for (size_t i = 1U; i < count; i++) {
+		const uint8_t value = samples[i];
+		size_t j = i;
+
+		while ((j > 0U) && (samples[j - 1U] > value)) {
+			samples[j] = samples[j - 1U];
+			j--;
+		}
+		samples[j] = value;
+	}
+
+	if ((count & 1U) != 0U) {
+		return samples[count / 2U];
+	}
+	return (uint8_t) (((uint32_t) samples[(count / 2U) - 1U]
+			+ (uint32_t) samples[count / 2U] + 1U) / 2U);
+}
+
+/**
+ * @brief Merge aligned frames into one output frame.
+ */
+bool AppBurstFusion_Fuse(const uint8_t *const *frames_ptr,
+		const AppBurstFusion_Shift_t *shifts_ptr, size_t frame_count,
+		AppFrameFormat_t format, size_t width_pixels, size_t height_pixels,
+		AppBurstFusion_Method_t method, uint8_t *output_ptr) {
+	const size_t bytes_per_pixel = AppFrameFormat_BytesPerPixel(format);
+	const int32_t row_bytes = (int32_t) (width_pixels * bytes_per_pixel);
+	const uint8_t *row_ptr[APP_BURST_FUSION_MAX_FRAMES];
+	int32_t byte_shift[APP_BURST_FUSION_MAX_FRAMES];
+	int32_t column_begin[APP_BURST_FUSION_MAX_FRAMES];
+	int32_t column_end[APP_BURST_FUSION_MAX_FRAMES];
+
+	if ((frames_ptr == NULL) || (shifts_ptr == NULL) || (output_ptr == NULL)
+			|| (frame_count == 0U)
+			|| (frame_count > APP_BURST_FUSION_MAX_FRAMES)
+			|| (width_pixels == 0U) || (height_pixels == 0U)) {
+		return false;
+	}
+	for (size_t k = 0U; k < frame_count; k++) {
+		if ((frames_ptr[k] == NULL) || (frames_ptr[k] == output_ptr)
+				|| ((format == APP_FRAME_FORMAT_YUV422)
+						&& ((shifts_ptr[k].dx & 1) != 0))) {
+			return false;
+		}
+		byte_shift[k] = shifts_ptr[k].dx * (int32_t) bytes_per_pixel;
+		column_begin[k] = (byte_shift[k] < 0) ? -byte_shift[k] : 0;
+		column_end[k] = (byte_shift[k] > 0) ?
+				(row_bytes - byte_shift[k]) : row_bytes;
+	}
+
+	for (size_t y = 0U; y < height_pixels; y++) {
+		uint8_t *const output_row = output_ptr + (y * (size_t) row_bytes);
+
+		for (size_t k = 0U; k < frame_count; k++) {
+			const int32_t source_y = (int32_t) y + shifts_ptr[k].dy;
+
+			if ((source_y < 0) || (source_y >= (int32_t) height_pixels)) {
+				row_ptr[k] = NULL;
+				continue;
+			}
+			row_ptr[k] = frames_ptr[k] + ((size_t) source_y * (size_t) row_bytes);
+		}
+
+		for (int32_t column = 0; column < row_bytes; column++) {
+			uint8_t samples[APP_BURST_FUSION_MAX_FRAMES];
+			uint32_t sum = 0U;
+			size_t count = 0U;
+
+			for (size_t k = 0U; k < frame_count; k++) {
+				if ((row_ptr[k] == NULL) || (column < column_begin[k])
+						|| (column >= column_end[k])) {
+					continue;
+				}
+				samples[count] = row_ptr[k][column + byte_shift[k]];
+				sum += samples[count];
+				count++;
+			}
+
+			if (count == 0U) {
+				/* Only possible when the reference itself was shifted. */
+				output_row[column] = 0U;
+			} else if ((method == APP_BURST_FUSION_MEDIAN) && (count > 2U)) {
+				output_row[column] = AppBurstFusion_Median(samples, count);
+			} else {
+				output_row[column] = (uint8_t) ((sum + (count / 2U)) / count);
+			}
+		}
+	}
+
+	return true;
+}
@@ -11,7 +11,14 @@
 #include "main.h"
 #include <string.h>
 
+#include "app_gauge_geometry.h"
 #include "debug_console.h"
+#include "tx_api.h"
+
+/* Match the baseline brightness profile: every second pixel of every second
+ * training-crop row, bright at luma 180 and above. */
+#define CAMERA_FRAME_INGEST_CROP_STEP     2U
+#define CAMERA_FRAME_INGEST_BRIGHT_LEVEL  180U
 
 /* Keep the live capture buffer in the noncacheable window so DMA and CPU
  * access stay coherent without extra cache maintenance on the write path. */
@@ -27,6 +34,32 @@ uint8_t camera_capture_buffers[CAMERA_CAPTURE_BUFFER_COUNT][CAMERA_CAPTURE_BUFFE
 uint8_t camera_inference_frame_snapshot[CAMERA_CAPTURE_BUFFER_SIZE_BYTES]
 		__attribute__((section(".tip_focus_activations"), aligned(__SCB_DCACHE_LINE_SIZE)));
 
+/* Written by the camera thread once per accepted frame; the snapshot copy is
+ * adopted together with the frame bytes it describes. */
+AppFrameIngest_Descriptor_t camera_capture_frame_descriptor;
+AppFrameIngest_Descriptor_t camera_inference_frame_descriptor;
+
+#if CAMERA_CAPTURE_ENABLE_NN_PIPE
+/* Written only by the NN pipe DMA, so it shares the noncacheable window with
+ * the capture buffers. */
+uint8_t camera_nn_capture_buffer[CAMERA_NN_FRAME_SIZE_BYTES]
+		__attribute__((section(".noncacheable"), aligned(__SCB_DCACHE_LINE_SIZE)));
+#endif
+AppNnPipe_Frame_t camera_capture_nn_frame;
+AppNnPipe_Frame_t camera_inference_nn_frame;
+static volatile bool camera_nn_frame_held = false;
+
+/* Count asynchronous consumers that still read the live capture buffer. The
+ * storage worker archives straight from the DMA buffer after inference has
+ * been dispatched, so the capture path must not re-arm DMA into it until every
+ * reference is dropped. */
+static volatile uint32_t camera_capture_buffer_ref_count = 0U;
+/* Set each time the count drops to zero, so a waiting capture wakes on
+ * release. */
+#define CAMERA_CAPTURE_BUFFER_RELEASED_FLAG  0x00000001UL
+static TX_EVENT_FLAGS_GROUP camera_capture_buffer_events;
+static bool camera_capture_buffer_events_created = false;
+
 /* Keep the CPU write-probe scratch separate from the live DMA frame. */
 uint32_t camera_capture_write_probe_words[2U];
 
@@ -64,19 +97,131 @@ void AppCameraBuffers_InvalidateCaptureRegion(uint32_t captured_bytes) {
 			(int32_t) invalidate_bytes);
 }
 
-uint32_t AppCameraBuffers_CountNonZeroBytes(const uint8_t *buffer_ptr,
+/* Walk the accepted frame once so the chroma summary, the AI frame signature
+ * and the baseline brightness profile can all read the result instead of
+ * each scanning the frame again. */
+bool AppCameraBuffers_DescribeCaptureFrame(const uint8_t *frame_ptr,
 		uint32_t length_bytes) {
-	uint32_t nonzero_count = 0U;
+	const AppGaugeGeometry_Crop_t crop = AppGaugeGeometry_TrainingCrop(
+			CAMERA_CAPTURE_WIDTH_PIXELS, CAMERA_CAPTURE_HEIGHT_PIXELS);
+	AppFrameIngest_Config_t config;
 
-	if (buffer_ptr == NULL) {
-		return 0U;
+	config.crop_x_min = (uint32_t) crop.x_min;
+	config.crop_y_min = (uint32_t) crop.y_min;
+	config.crop_x_end = (uint32_t) (crop.x_min + crop.width);
+	config.crop_y_end = (uint32_t) (crop.y_min + crop.height);
+	config.crop_step = CAMERA_FRAME_INGEST_CROP_STEP;
+	config.crop_bright_level = CAMERA_FRAME_INGEST_BRIGHT_LEVEL;
+
+	return AppFrameIngest_Run(frame_ptr, length_bytes,
+			CAMERA_CAPTURE_WIDTH_PIXELS, CAMERA_CAPTURE_HEIGHT_PIXELS, &config,
+			&camera_capture_frame_descriptor);
+}
+
+/* Carry the capture descriptor over to the inference snapshot after the
+ * frame bytes were copied from source_ptr; any other source leaves the
+ * snapshot undescribed so its consumers fall back to their own scan. The
+ * baseline worker re-queues the snapshot itself, which keeps its descriptor. */
+void AppCameraBuffers_AdoptSnapshotDescriptor(const uint8_t *source_ptr,
+		size_t length_bytes) {
+	if (source_ptr == camera_inference_frame_snapshot) {
+		return;
+	}
+	if (!AppFrameIngest_Describes(&camera_capture_frame_descriptor, source_ptr,
+			length_bytes)) {
+		camera_inference_frame_descriptor.valid = false;
+		return;
 	}
+	camera_inference_frame_descriptor = camera_capture_frame_descriptor;
+	camera_inference_frame_descriptor.frame_ptr =
+			camera_inference_frame_snapshot;
+}
 
-	for (uint32_t byte_index = 0U; byte_index < length_bytes; byte_index++) {
-		if (buffer_ptr[byte_index] != 0U) {
-			nonzero_count++;
-		}
+/* Hand the NN frame taken with source_ptr to the inference snapshot copied
+ * from it; a frame from another capture is dropped so the AI worker falls
+ * back to CPU preprocessing. */
+void AppCameraBuffers_AdoptNnFrame(const uint8_t *source_ptr) {
+	if ((source_ptr == NULL) || !camera_capture_nn_frame.valid
+			|| (camera_capture_nn_frame.source_frame_ptr != source_ptr)) {
+		camera_inference_nn_frame.valid = false;
+		return;
 	}
+	camera_inference_nn_frame = camera_capture_nn_frame;
+	camera_inference_nn_frame.source_frame_ptr =
+			camera_inference_frame_snapshot;
+	camera_capture_nn_frame.valid = false;
+	camera_nn_frame_held = true;
+}
+
+void AppCameraBuffers_ReleaseNnFrame(void) {
+	camera_inference_nn_frame.valid = false;
+	camera_nn_frame_held = false;
+}
 
-	return nonzero_count;
+bool AppCameraBuffers_IsNnFrameHeld(void) {
+	return camera_nn_frame_held;
+}
+
+UINT AppCameraBuffers_InitSync(void) {
+	UINT status = TX_SUCCESS;
+
+	if (camera_capture_buffer_events_created) {
+		return TX_SUCCESS;
+	}
+	status = tx_event_flags_create(&camera_capture_buffer_events,
+			"camera_capture_buffer");
+	if (status != TX_SUCCESS) {
+		return status;
+	}
+	camera_capture_buffer_events_created = true;
+	return TX_SUCCESS;
+}
+
+void AppCameraBuffers_RetainCaptureBuffer(void) {
+	TX_INTERRUPT_SAVE_AREA
+
+	TX_DISABLE
+	camera_capture_buffer_ref_count++;
+	TX_RESTORE
+}
+
+void AppCameraBuffers_ReleaseCaptureBuffer(void) {
+	bool released = false;
+	TX_INTERRUPT_SAVE_AREA
+
+	TX_DISABLE
+	if (camera_capture_buffer_ref_count > 0U) {
+		camera_capture_buffer_ref_count--;
+	}
+	released = (camera_capture_buffer_ref_count == 0U);
+	TX_RESTORE
+	if (released && camera_capture_buffer_events_created) {
+		(void) tx_event_flags_set(&camera_capture_buffer_events,
+				CAMERA_CAPTURE_BUFFER_RELEASED_FLAG, TX_OR);
+	}
+}
+
+bool AppCameraBuffers_IsCaptureBufferHeld(void) {
+	return (camera_capture_buffer_ref_count != 0U);
+}
+
+/* Block until every capture buffer reference is dropped or wait_ticks pass.
+ * The flag is only a wake-up hint: a Release that set it late, after a new
+ * Retain, leaves it set with a reference held, so each wake consumes it and
+ * the count decides. */
+bool AppCameraBuffers_WaitForCaptureBufferRelease(ULONG wait_ticks) {
+	const ULONG start_tick = tx_time_get();
+	ULONG actual_flags = 0U;
+
+	while (AppCameraBuffers_IsCaptureBufferHeld()) {
+		const ULONG elapsed = tx_time_get() - start_tick;
+
+		if (!camera_capture_buffer_events_created || (elapsed >= wait_ticks)
+				|| (tx_event_flags_get(&camera_capture_buffer_events,
+						CAMERA_CAPTURE_BUFFER_RELEASED_FLAG, TX_OR_CLEAR,
+						&actual_flags, wait_ticks - elapsed) != TX_SUCCESS)) {
+			return !AppCameraBuffers_IsCaptureBufferHeld();
+		}
+	}
+	return true;
 }
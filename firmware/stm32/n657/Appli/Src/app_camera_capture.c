@@ -19,14 +19,26 @@
 #include "app_threadx.h"
 #include "app_threadx_config.h"
 #include "app_camera_buffers.h"
+#include "app_capture_storage.h"
 #include "app_camera_config.h"
 #include "app_camera_diagnostics.h"
 #include "app_camera_platform.h"
+#include "app_burst_fusion.h"
+#include "app_capture_events.h"
+#include "app_capture_roi.h"
+#include "app_exposure_control.h"
+#include "app_exposure_memory.h"
+#include "app_luma_stats.h"
+#include "app_sensor_power.h"
 #include "app_gauge_geometry.h"
 #include "app_filex.h"
+#include "app_ai.h"
 #include "app_inference_runtime.h"
+#include "app_low_power.h"
 #include "app_storage.h"
 #include "debug_console.h"
+#include "ds3231_clock.h"
+#include "inference_metrics.h"
 #include "threadx_utils.h"
 #include "cmw_imx335.h"
 #include "imx335.h"
@@ -40,7 +52,8 @@ extern bool camera_cmw_initialized;
 extern bool camera_stream_started;
 extern volatile bool camera_capture_isp_loop_paused;
 extern volatile uint32_t camera_capture_isp_run_count;
-extern TX_SEMAPHORE camera_capture_done_semaphore;
+extern TX_EVENT_FLAGS_GROUP camera_capture_events;
+extern AppCaptureEvents_Context_t camera_capture_event_state;
 extern TX_SEMAPHORE camera_capture_isp_semaphore;
 extern volatile bool camera_capture_failed;
 extern volatile uint32_t camera_capture_error_code;
@@ -55,6 +68,10 @@ extern volatile uint32_t camera_capture_line_error_mask;
 extern volatile uint32_t camera_capture_csi_linebyte_event_count;
 extern volatile bool camera_capture_csi_linebyte_event_logged;
 extern volatile uint32_t camera_capture_vsync_event_count;
+extern volatile uint32_t camera_capture_frame_vsync_count;
+extern volatile uint32_t camera_nn_frame_event_count;
+extern volatile uint32_t camera_nn_frame_vsync_count;
+extern volatile bool camera_nn_frame_failed;
 extern volatile uint32_t camera_capture_csi_irq_count;
 extern volatile uint32_t camera_capture_dcmipp_irq_count;
 extern volatile uint32_t camera_capture_reported_byte_count;
@@ -72,7 +89,106 @@ extern uint32_t camera_capture_active_buffer_index;
  */
 static bool AppCameraCapture_ShouldRetryDcmippError(uint32_t error_code) {
 	return (error_code == 0x00008100U)
-			&& (camera_capture_reported_byte_count >= CAMERA_CAPTURE_BUFFER_SIZE_BYTES);
+			&& (camera_capture_reported_byte_count
+					>= CameraPlatform_GetCaptureFrameBytes());
+}
+
+/**
+ * @brief Arm the completion state machine and clear stale event flags.
+ *
+ * Armed before the receiver so no event of the wanted frame can slip past it.
+ * A stream that already runs may be mid-frame, so the capture then waits for
+ * the next frame boundary instead of a fixed warm-up delay.
+ */
+static void AppCameraCapture_ArmCaptureEvents(bool wait_for_boundary) {
+	TX_INTERRUPT_SAVE_AREA
+
+	TX_DISABLE
+	AppCaptureEvents_Arm(&camera_capture_event_state,
+			(uint32_t) Metrics_GetMicros(), CAMERA_CAPTURE_TIMEOUT_MS * 1000U,
+			wait_for_boundary);
+	TX_RESTORE
+	(void) tx_event_flags_set(&camera_capture_events,
+			~((ULONG) APP_CAPTURE_EVENTS_FLAG_ALL), TX_AND);
+}
+
+/**
+ * @brief Read the capture state, timing it out once the deadline passed.
+ * @param remaining_us_ptr Receives the microseconds left until the deadline.
+ */
+static AppCaptureEvents_State_t AppCameraCapture_CheckCaptureEvents(
+		uint32_t *remaining_us_ptr) {
+	AppCaptureEvents_State_t state = APP_CAPTURE_EVENTS_IDLE;
+	uint32_t now_us = 0U;
+	TX_INTERRUPT_SAVE_AREA
+
+	TX_DISABLE
+	now_us = (uint32_t) Metrics_GetMicros();
+	state = AppCaptureEvents_Check(&camera_capture_event_state, now_us);
+	*remaining_us_ptr = AppCaptureEvents_RemainingUs(&camera_capture_event_state,
+			now_us);
+	TX_RESTORE
+	return state;
+}
+
+/**
+ * @brief Block until the frame is ready or failed, or until the deadline.
+ */
+static void AppCameraCapture_WaitForCaptureEvents(uint32_t remaining_us) {
+	const uint32_t remaining_ms = (remaining_us + 999U) / 1000U;
+	ULONG wait_ticks = CameraPlatform_MillisecondsToTicks(remaining_ms);
+	ULONG actual_flags = 0U;
+
+	if (wait_ticks == 0U) {
+		wait_ticks = 1U;
+	}
+	(void) tx_event_flags_get(&camera_capture_events,
+			APP_CAPTURE_EVENTS_FLAG_DONE, TX_OR_CLEAR, &actual_flags, wait_ticks);
+}
+
+/**
+ * @brief Publish the NN pipe frame taken with the accepted main frame.
+ *
+ * The NN pipe writes a smaller frame and usually finishes first; a short
+ * wait covers the rest. The frame is kept only when it is the single NN
+ * frame of the snapshot and ended in the same VSYNC period as the accepted
+ * main frame, so both show the same exposure.
+ */
+static void AppCameraCapture_CollectNnFrame(const uint8_t *frame_ptr) {
+#if CAMERA_CAPTURE_ENABLE_NN_PIPE
+	ULONG actual_flags = 0U;
+#endif
+
+	camera_capture_nn_frame.valid = false;
+#if CAMERA_CAPTURE_ENABLE_NN_PIPE
+	if (!CameraPlatform_IsNnPipeArmed()) {
+		return;
+	}
+	if ((camera_nn_frame_event_count == 0U) && !camera_nn_frame_failed) {
+		(void) tx_event_flags_get(&camera_capture_events,
+				APP_CAPTURE_EVENTS_FLAG_NN_FRAME, TX_OR_CLEAR, &actual_flags,
+				CameraPlatform_MillisecondsToTicks(
+						CAMERA_NN_PIPE_FRAME_WAIT_MS));
+	}
+	CameraPlatform_StopNnPipe();
+	if (camera_nn_frame_failed || (camera_nn_frame_event_count != 1U)
+			|| (camera_nn_frame_vsync_count
+					!= camera_capture_frame_vsync_count)) {
+		DebugConsole_Printf(
+				"[CAMERA][NN] Frame not used: frames=%lu failed=%u vsync=%lu/%lu\r\n",
+				(unsigned long) camera_nn_frame_event_count,
+				(unsigned int) (camera_nn_frame_failed ? 1U : 0U),
+				(unsigned long) camera_nn_frame_vsync_count,
+				(unsigned long) camera_capture_frame_vsync_count);
+		return;
+	}
+	camera_capture_nn_frame.image_ptr = camera_nn_capture_buffer;
+	camera_capture_nn_frame.source_frame_ptr = frame_ptr;
+	camera_capture_nn_frame.layout = *CameraPlatform_GetNnPipeLayout();
+	camera_capture_nn_frame.valid = true;
+#else
+	(void) frame_ptr;
+#endif
 }
 
 /**
@@ -84,17 +200,11 @@ typedef enum {
 	APP_CAMERA_CAPTURE_BRIGHTNESS_TOO_BRIGHT,
 } AppCameraCapture_BrightnessGate_t;
 
-/**
- * @brief Crop luma summary used to decide whether to accept a frame.
- */
-typedef struct {
-	uint32_t sample_count;
-	uint32_t bright_sample_count;
-	uint8_t min_y;
-	uint8_t max_y;
-	uint32_t mean_y;
-} AppCameraCapture_BrightnessStats_t;
-
+#if CAMERA_CAPTURE_PREDICTIVE_EXPOSURE_ENABLED
+/* Crop luma histogram of the last analyzed frame, input to the exposure
+ * controller. Static to keep 1 KiB off the camera thread stack. */
+static uint32_t camera_capture_luma_histogram[APP_EXPOSURE_CONTROL_HISTOGRAM_BINS];
+#else
 /**
  * @brief Clamp a brightness nudge step to a safe runtime range.
  */
@@ -116,7 +226,7 @@ static uint32_t AppCameraCapture_ClampBrightnessStepPercent(uint32_t step_percen
  * adjacent exposure settings.
  */
 static uint32_t AppCameraCapture_ComputeBrightnessStepPercent(
-		const AppCameraCapture_BrightnessStats_t *stats,
+		const AppLumaStats_t *stats,
 		AppCameraCapture_BrightnessGate_t gate,
 		AppCameraCapture_BrightnessGate_t previous_gate) {
 	uint32_t mean_error = 0U;
@@ -160,82 +270,78 @@ static uint32_t AppCameraCapture_ComputeBrightnessStepPercent(
 
 	return AppCameraCapture_ClampBrightnessStepPercent(step_percent);
 }
+#endif /* CAMERA_CAPTURE_PREDICTIVE_EXPOSURE_ENABLED */
 
 /**
- * @brief Measure luma over the full training crop region of a YUV422 frame.
+ * @brief Sample luma over the training crop region of a YUV422 or Y8 frame.
  *
- * Sampling the entire training crop (rather than a small centre ROI) avoids
+ * Sampling the whole training crop (rather than a small centre ROI) avoids
  * being fooled by specular reflections on the gauge glass, which can make a
  * small centre ROI read as "bright enough" while the rest of the dial face
  * is still underexposed.  The model sees exactly this region, so the mean
- * here directly predicts whether the model input will be well-exposed.
+ * here directly predicts whether the model input will be well-exposed. A
+ * 4x4 grid over it keeps that coverage at 1/16 of the reads.
+ * @param histogram_ptr Optional 256-bin luma histogram to fill, or NULL.
  */
 static bool AppCameraCapture_ComputeBrightnessStats(const uint8_t *buffer_ptr,
-		uint32_t length_bytes, AppCameraCapture_BrightnessStats_t *stats) {
+		uint32_t length_bytes, AppLumaStats_t *stats,
+		uint32_t *histogram_ptr) {
 	const uint32_t frame_width_pixels = CAMERA_CAPTURE_WIDTH_PIXELS;
 	const uint32_t frame_height_lines = CAMERA_CAPTURE_HEIGHT_PIXELS;
-	const uint32_t bytes_per_pixel = CAMERA_CAPTURE_BYTES_PER_PIXEL;
-	const uint32_t stride_bytes = frame_width_pixels * bytes_per_pixel;
-	uint64_t sum_y = 0U;
-	uint32_t sample_count = 0U;
-	uint32_t bright_sample_count = 0U;
-	uint8_t min_y = 0xFFU;
-	uint8_t max_y = 0U;
-
-	if ((buffer_ptr == NULL) || (stats == NULL) || (length_bytes < stride_bytes)) {
+	AppFrameFormat_t frame_format = APP_FRAME_FORMAT_YUV422;
+	AppLumaStats_Region_t region = { 0 };
+
+	if ((buffer_ptr == NULL) || (stats == NULL)
+			|| !AppFrameFormat_FromLength(frame_width_pixels,
+					frame_height_lines, length_bytes, &frame_format)) {
 		return false;
 	}
 
 	const AppGaugeGeometry_Crop_t crop = AppGaugeGeometry_TrainingCrop(
 			(size_t) frame_width_pixels, (size_t) frame_height_lines);
-	const uint32_t x_end = (uint32_t) (crop.x_min + crop.width);
-	const uint32_t y_end = (uint32_t) (crop.y_min + crop.height);
-
-	if ((x_end > frame_width_pixels) || (y_end > frame_height_lines)) {
-		return false;
-	}
-
-	for (uint32_t row = (uint32_t) crop.y_min; row < y_end; row++) {
-		const uint32_t row_base = row * stride_bytes;
 
-		if ((row_base + (x_end * bytes_per_pixel)) > length_bytes) {
-			return false;
-		}
-
-		for (uint32_t col = (uint32_t) crop.x_min; col < x_end; col++) {
-			const uint8_t y_sample = buffer_ptr[row_base + (col * bytes_per_pixel)];
-
-			if (y_sample < min_y) {
-				min_y = y_sample;
-			}
-			if (y_sample > max_y) {
-				max_y = y_sample;
-			}
-			if (y_sample >= CAMERA_CAPTURE_BRIGHTNESS_BRIGHT_PIXEL_LEVEL_THRESHOLD) {
-				bright_sample_count++;
-			}
-			sum_y += y_sample;
-			sample_count++;
-		}
-	}
+	region.width_pixels = frame_width_pixels;
+	region.bytes_per_pixel = AppFrameFormat_BytesPerPixel(frame_format);
+	region.x_min = (uint32_t) crop.x_min;
+	region.y_min = (uint32_t) crop.y_min;
+	region.x_end = (uint32_t) (crop.x_min + crop.width);
+	region.y_end = (uint32_t) (crop.y_min + crop.height);
+
+	return AppLumaStats_SampleRegion(buffer_ptr, length_bytes, &region,
+			CAMERA_CAPTURE_BRIGHTNESS_SAMPLE_STEP,
+			CAMERA_CAPTURE_BRIGHTNESS_BRIGHT_PIXEL_LEVEL_THRESHOLD, stats,
+			histogram_ptr);
+}
 
-	if (sample_count == 0U) {
-		return false;
+/**
+ * @brief Summarize the accepted snapshot's crop luma for the gate.
+ *
+ * Prefers the DCMIPP statistics, which cost nothing to read; falls back to
+ * the sampled crop when no statistics cycle completed for this snapshot.
+ * @param histogram_ptr Filled only on the sampled path; see from_isp_ptr.
+ * @param[out] from_isp_ptr Set when the summary came from the hardware.
+ */
+static bool AppCameraCapture_MeasureBrightness(const uint8_t *buffer_ptr,
+		uint32_t length_bytes, AppLumaStats_t *stats,
+		uint32_t *histogram_ptr, bool *from_isp_ptr) {
+	*from_isp_ptr = false;
+#if CAMERA_CAPTURE_ISP_BRIGHTNESS_STATS_ENABLED
+	if (CameraPlatform_GetIspLumaStats(
+			(uint8_t) CAMERA_CAPTURE_BRIGHTNESS_BRIGHT_PIXEL_LEVEL_THRESHOLD,
+			stats)) {
+		*from_isp_ptr = true;
+		return true;
 	}
-
-	stats->sample_count = sample_count;
-	stats->bright_sample_count = bright_sample_count;
-	stats->min_y = min_y;
-	stats->max_y = max_y;
-	stats->mean_y = (uint32_t) (sum_y / sample_count);
-	return true;
+#endif
+	return AppCameraCapture_ComputeBrightnessStats(buffer_ptr, length_bytes,
+			stats, histogram_ptr);
 }
 
 /**
  * @brief Decide whether a processed frame is too dark, too bright, or usable.
  */
 static AppCameraCapture_BrightnessGate_t AppCameraCapture_ClassifyBrightness(
-		const AppCameraCapture_BrightnessStats_t *stats) {
+		const AppLumaStats_t *stats) {
 	if (stats == NULL) {
 		return APP_CAMERA_CAPTURE_BRIGHTNESS_OK;
 	}
@@ -266,8 +372,8 @@ static AppCameraCapture_BrightnessGate_t AppCameraCapture_ClassifyBrightness(
  * @brief Print the brightness gate result so we can see why a frame was retried.
  */
 static void AppCameraCapture_LogBrightnessGateDecision(
-		const AppCameraCapture_BrightnessStats_t *stats,
-		AppCameraCapture_BrightnessGate_t decision) {
+		const AppLumaStats_t *stats,
+		AppCameraCapture_BrightnessGate_t decision, bool from_isp) {
 	const char *decision_label = "ok";
 
 	switch (decision) {
@@ -282,8 +388,8 @@ static void AppCameraCapture_LogBrightnessGateDecision(
 	}
 
 	DebugConsole_Printf(
-			"[CAMERA][CAPTURE] Brightness gate (%s): samples=%lu mean=%lu min=%u max=%u bright=%lu (%lu%%) thresholds dark<=%u/%u bright_ratio>=%u%%@%u bright_solid>=%u/%u.\r\n",
-			decision_label,
+			"[CAMERA][CAPTURE] Brightness gate (%s, %s): samples=%lu mean=%lu min=%u max=%u bright=%lu (%lu%%) thresholds dark<=%u/%u bright_ratio>=%u%%@%u bright_solid>=%u/%u.\r\n",
+			decision_label, from_isp ? "isp" : "sampled",
 			(unsigned long) ((stats != NULL) ? stats->sample_count : 0U),
 			(unsigned long) ((stats != NULL) ? stats->mean_y : 0U),
 			(unsigned int) ((stats != NULL) ? stats->min_y : 0U),
@@ -539,12 +645,8 @@ static void AppCameraCapture_LogSavePathState(const uint8_t *image_ptr,
  * @retval true when the frame reaches storage successfully.
  */
 bool AppCameraCapture_CaptureSingleFrame(uint32_t *captured_bytes_ptr) {
-	const ULONG wait_ticks = CameraPlatform_MillisecondsToTicks(
-	CAMERA_CAPTURE_TIMEOUT_MS);
-	const ULONG poll_ticks = CameraPlatform_MillisecondsToTicks(20U);
-	ULONG next_wait_log_tick = 0U;
-	ULONG deadline_tick = 0U;
-	UINT semaphore_status = TX_SUCCESS;
+	AppCaptureEvents_State_t capture_state = APP_CAPTURE_EVENTS_IDLE;
+	uint32_t remaining_us = 0U;
 	bool should_reset_sensor_stream = false;
 	DCMIPP_HandleTypeDef *capture_dcmipp =
 			CameraPlatform_GetCaptureDcmippHandle();
@@ -553,6 +655,13 @@ bool AppCameraCapture_CaptureSingleFrame(uint32_t *captured_bytes_ptr) {
 		return false;
 	}
 
+	/* The storage worker may still be archiving the previous frame straight
+	 * from the capture buffer; never re-arm DMA underneath it. */
+	if (!AppCaptureStorage_WaitForBufferRelease(
+			CAMERA_CAPTURE_BUFFER_RELEASE_TIMEOUT_MS)) {
+		return false;
+	}
+
 	camera_capture_isp_loop_paused = true;
 
 	if (!App_ThreadX_LockCameraMiddleware(
@@ -571,6 +680,9 @@ bool AppCameraCapture_CaptureSingleFrame(uint32_t *captured_bytes_ptr) {
 		camera_capture_isp_loop_paused = false;
 		return false;
 	}
+#if CAMERA_CAPTURE_ISP_BRIGHTNESS_STATS_ENABLED
+	(void) CameraPlatform_ArmIspLumaStats();
+#endif
 
 	camera_capture_failed = false;
 	camera_capture_error_code = 0U;
@@ -585,6 +697,11 @@ bool AppCameraCapture_CaptureSingleFrame(uint32_t *captured_bytes_ptr) {
 	camera_capture_csi_linebyte_event_count = 0U;
 	camera_capture_csi_linebyte_event_logged = false;
 	camera_capture_vsync_event_count = 0U;
+	camera_capture_frame_vsync_count = 0U;
+	camera_nn_frame_event_count = 0U;
+	camera_nn_frame_vsync_count = 0U;
+	camera_nn_frame_failed = false;
+	camera_capture_nn_frame.valid = false;
 	camera_capture_isp_run_count = 0U;
 	camera_capture_csi_irq_count = 0U;
 	camera_capture_dcmipp_irq_count = 0U;
@@ -594,10 +711,7 @@ bool AppCameraCapture_CaptureSingleFrame(uint32_t *captured_bytes_ptr) {
 	camera_capture_result_buffer = camera_capture_buffers[0];
 	AppCameraBuffers_PrepareForDma();
 
-	/* Drain any stale semaphore token before arming the next snapshot. */
-	while (tx_semaphore_get(&camera_capture_done_semaphore, TX_NO_WAIT)
-			== TX_SUCCESS) {
-	}
+	AppCameraCapture_ArmCaptureEvents(camera_stream_started);
 
 	/* Match ST's CMW_CAMERA_Start() ordering: arm the CSI/DCMIPP receiver first,
 	 * then start the ISP + sensor stream. This avoids missing the first valid
@@ -617,96 +731,102 @@ bool AppCameraCapture_CaptureSingleFrame(uint32_t *captured_bytes_ptr) {
 		if (!CameraPlatform_StartImx335Stream()) {
 			(void) HAL_DCMIPP_CSI_PIPE_Stop(capture_dcmipp, CAMERA_CAPTURE_PIPE,
 			DCMIPP_VIRTUAL_CHANNEL0);
+			CameraPlatform_StopNnPipe();
 			camera_capture_snapshot_armed = false;
 			App_ThreadX_UnlockCameraMiddleware();
 			camera_capture_isp_loop_paused = false;
 			return false;
 		}
-	} else {
-		/* On later snapshots, give the already-running stream a brief moment to
-		 * advance to the armed frame boundary before we block on completion. */
-		DelayMilliseconds_ThreadX(CAMERA_STREAM_WARMUP_DELAY_MS);
 	}
 	(void) CameraPlatform_LogImx335AutoExposureState("capture-start");
 	App_ThreadX_UnlockCameraMiddleware();
 
-	deadline_tick = tx_time_get() + wait_ticks;
-	next_wait_log_tick = tx_time_get()
-			+ CameraPlatform_MillisecondsToTicks(1000U);
+	/* Block on the completion flags until the exact deadline; the interrupt
+	 * callbacks wake the thread as soon as the frame is decided. */
 	while (true) {
-		semaphore_status = tx_semaphore_get(&camera_capture_done_semaphore,
-				poll_ticks);
-		if (semaphore_status == TX_SUCCESS) {
-			if (!camera_capture_failed) {
-				const uint32_t completed_buffer_index =
-						camera_capture_active_buffer_index;
-				uint32_t completed_nonzero_bytes = 0U;
-				uint8_t *completed_buffer_ptr = NULL;
-				bool keep_waiting_for_convergence = false;
-
-				completed_buffer_ptr =
-						camera_capture_buffers[completed_buffer_index];
-
-				completed_nonzero_bytes = AppCameraBuffers_CountNonZeroBytes(
-						completed_buffer_ptr, CAMERA_CAPTURE_BUFFER_SIZE_BYTES);
-				if ((completed_nonzero_bytes == 0U)
-						&& camera_capture_use_cmw_pipeline) {
-					keep_waiting_for_convergence = true;
-				}
-
-				if (keep_waiting_for_convergence) {
-					if ((tx_time_get() >= deadline_tick)
-							|| (camera_capture_failed)) {
-						DebugConsole_Printf(
-								"[CAMERA][CAPTURE] Camera path never produced nonzero pixels before timeout.\r\n");
-						camera_capture_isp_loop_paused = false;
-						return false;
-					}
+		capture_state = AppCameraCapture_CheckCaptureEvents(&remaining_us);
+
+		if (capture_state == APP_CAPTURE_EVENTS_READY) {
+			const uint32_t completed_buffer_index =
+					camera_capture_active_buffer_index;
+			uint8_t *completed_buffer_ptr =
+					camera_capture_buffers[completed_buffer_index];
+			AppCaptureEvents_Timing_t capture_timing;
+			bool accepted = false;
+			TX_INTERRUPT_SAVE_AREA
+
+			/* A live frame hits within the first few probes; only a frame
+			 * the pipe never wrote pays for the sparse full sweep. An empty
+			 * frame means the pipeline has not converged yet, so take the
+			 * next whole frame against the same deadline. */
+			if (camera_capture_use_cmw_pipeline
+					&& !AppLumaStats_AnyNonZero(completed_buffer_ptr,
+							CameraPlatform_GetCaptureFrameBytes(),
+							CAMERA_CAPTURE_NONZERO_PROBE_STRIDE_WORDS)) {
+				TX_DISABLE
+				(void) AppCaptureEvents_Rewait(&camera_capture_event_state);
+				TX_RESTORE
+				continue;
+			}
 
-					DelayMilliseconds_ThreadX(CAMERA_CAPTURE_RETRY_DELAY_MS);
-					continue;
-				}
+			TX_DISABLE
+			accepted = AppCaptureEvents_Accept(&camera_capture_event_state,
+					(uint32_t) Metrics_GetMicros(), &capture_timing);
+			TX_RESTORE
+			if (!accepted) {
+				/* A late error failed the frame after the check. */
+				continue;
+			}
 
-				camera_capture_result_buffer = completed_buffer_ptr;
-				(void) HAL_DCMIPP_CSI_PIPE_Stop(capture_dcmipp,
-				CAMERA_CAPTURE_PIPE, DCMIPP_VIRTUAL_CHANNEL0);
-				camera_capture_snapshot_armed = false;
-				*captured_bytes_ptr = camera_capture_byte_count;
-				if (camera_capture_use_cmw_pipeline) {
-					(void) AppCameraBuffers_InvalidateCaptureRegion(
-							camera_capture_byte_count);
-				}
-				return true;
+			DebugConsole_Printf(
+					"[CAMERA][CAPTURE][TIMING] arm-sof=%lu sof-eof=%lu eof-ready=%lu total=%lu us dropped=%lu rewaits=%lu\r\n",
+					(unsigned long) capture_timing.arm_to_sof_us,
+					(unsigned long) capture_timing.sof_to_eof_us,
+					(unsigned long) capture_timing.eof_to_ready_us,
+					(unsigned long) capture_timing.arm_to_ready_us,
+					(unsigned long) capture_timing.dropped_frames,
+					(unsigned long) capture_timing.rewaits);
+			camera_capture_result_buffer = completed_buffer_ptr;
+			(void) HAL_DCMIPP_CSI_PIPE_Stop(capture_dcmipp,
+			CAMERA_CAPTURE_PIPE, DCMIPP_VIRTUAL_CHANNEL0);
+			AppCameraCapture_CollectNnFrame(completed_buffer_ptr);
+			camera_capture_snapshot_armed = false;
+			*captured_bytes_ptr = camera_capture_byte_count;
+			if (camera_capture_use_cmw_pipeline) {
+				(void) AppCameraBuffers_InvalidateCaptureRegion(
+						camera_capture_byte_count);
 			}
+			return true;
+		}
 
+		if (capture_state == APP_CAPTURE_EVENTS_FAILED) {
 			DebugConsole_Printf(
 					"[CAMERA][CAPTURE] DCMIPP reported capture error code 0x%08lX.\r\n",
-					(unsigned long) camera_capture_error_code);
-			AppCameraDiagnostics_LogDcmippErrorCode(camera_capture_error_code);
+					(unsigned long) camera_capture_event_state.error_code);
+			AppCameraDiagnostics_LogDcmippErrorCode(
+					camera_capture_event_state.error_code);
 			AppCameraCapture_LogCaptureState("capture-error");
-			should_reset_sensor_stream =
-			AppCameraCapture_ShouldRetryDcmippError(camera_capture_error_code);
+			should_reset_sensor_stream = AppCameraCapture_ShouldRetryDcmippError(
+					camera_capture_event_state.error_code);
 			break;
 		}
 
-		if ((tx_time_get() >= deadline_tick) || camera_capture_failed) {
-			if (tx_time_get() >= deadline_tick) {
-				DebugConsole_Printf(
-						"[CAMERA][CAPTURE] Timed out waiting for frame completion.\r\n");
-			}
+		if (capture_state == APP_CAPTURE_EVENTS_TIMED_OUT) {
+			DebugConsole_Printf(
+					"[CAMERA][CAPTURE] Timed out waiting for frame completion: sof=%u eof=%u dropped=%lu rewaits=%lu\r\n",
+					(unsigned int) (camera_capture_event_state.sof_seen ? 1U : 0U),
+					(unsigned int) (camera_capture_event_state.eof_seen ? 1U : 0U),
+					(unsigned long) camera_capture_event_state.dropped_frames,
+					(unsigned long) camera_capture_event_state.rewaits);
 			break;
 		}
 
-		if ((next_wait_log_tick == 0U) || (tx_time_get() >= next_wait_log_tick)) {
-			DebugConsole_Printf(
-					"[CAMERA][CAPTURE] Waiting for frame completion...\r\n");
-			next_wait_log_tick = tx_time_get()
-					+ CameraPlatform_MillisecondsToTicks(1000U);
-		}
+		AppCameraCapture_WaitForCaptureEvents(remaining_us);
 	}
 
 	(void) HAL_DCMIPP_CSI_PIPE_Stop(capture_dcmipp, CAMERA_CAPTURE_PIPE,
 	DCMIPP_VIRTUAL_CHANNEL0);
+	CameraPlatform_StopNnPipe();
 	if (should_reset_sensor_stream) {
 		if (!CameraPlatform_StopImx335Stream()) {
 			DebugConsole_WriteString(
@@ -718,33 +838,752 @@ bool AppCameraCapture_CaptureSingleFrame(uint32_t *captured_bytes_ptr) {
 	return false;
 }
 
+#if CAMERA_SENSOR_POWER_ENABLED
+/* Where the sensor was parked after the last cycle, and the wake in flight. */
+static AppSensorPower_Context_t camera_sensor_power;
+static bool camera_sensor_power_initialized = false;
+static AppSensorPower_State_t camera_sensor_power_state =
+		APP_SENSOR_POWER_STREAMING;
+static bool camera_sensor_wake_pending = false;
+static uint32_t camera_sensor_wake_start_ms = 0U;
+/* DCMIPP/CSI reference held from the wake until the sensor is parked. */
+static bool camera_dcmipp_domain_held = false;
+
 /**
- * @brief Capture a single frame, save it to the SD card, and queue inference.
- * @retval true when the frame reaches storage successfully.
+ * @brief Load the sensor power tunables on first use.
+ */
+static void AppCameraCapture_InitSensorPower(void) {
+	const AppSensorPower_Config_t config = {
+		.initial_wake_ms = { 0U, CAMERA_SENSOR_STANDBY_WAKE_MS,
+				CAMERA_SENSOR_OFF_WAKE_MS },
+		.min_idle_ms = { 0U, CAMERA_SENSOR_STANDBY_MIN_IDLE_MS,
+				CAMERA_SENSOR_OFF_MIN_IDLE_MS },
+		.guard_ms = CAMERA_SENSOR_WAKE_GUARD_MS,
+		.max_wake_failures = CAMERA_SENSOR_OFF_MAX_WAKE_FAILURES,
+	};
+
+	if (camera_sensor_power_initialized) {
+		return;
+	}
+	AppSensorPower_Init(&camera_sensor_power, &config);
+	camera_sensor_power_initialized = true;
+}
+
+/**
+ * @brief Start timing a wake and power the sensor back on if it was off.
+ * @retval false when the sensor could not be brought back this cycle.
+ */
+static bool AppCameraCapture_BeginSensorWake(void) {
+	bool powered = true;
+
+	AppCameraCapture_InitSensorPower();
+	if (!camera_dcmipp_domain_held) {
+		camera_dcmipp_domain_held = AppLowPower_AcquireDomain(
+				APP_POWER_DOMAIN_CAMERA);
+	}
+	camera_sensor_wake_start_ms = HAL_GetTick();
+	camera_sensor_wake_pending = true;
+
+	if (camera_sensor_power_state != APP_SENSOR_POWER_OFF) {
+		return true;
+	}
+
+	camera_capture_isp_loop_paused = true;
+	if (!App_ThreadX_LockCameraMiddleware(
+			CameraPlatform_MillisecondsToTicks(
+					CAMERA_MIDDLEWARE_LOCK_TIMEOUT_MS))) {
+		camera_capture_isp_loop_paused = false;
+		return false;
+	}
+	powered = CameraPlatform_PowerOnImx335();
+	App_ThreadX_UnlockCameraMiddleware();
+	camera_capture_isp_loop_paused = false;
+
+	if (!powered) {
+		/* Stay in OFF so the next cycle retries the power-on. */
+		AppSensorPower_RecordWake(&camera_sensor_power, APP_SENSOR_POWER_OFF,
+				false, 0U);
+		camera_sensor_wake_pending = false;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Close the wake timing at the first frame the receiver delivered.
+ * @param frame_ready false when the cycle ended without any frame; the
+ *        measurement is dropped rather than counted against the state.
+ */
+static void AppCameraCapture_FinishSensorWake(bool frame_ready) {
+	uint32_t wake_ms = 0U;
+
+	if (!camera_sensor_wake_pending) {
+		return;
+	}
+	camera_sensor_wake_pending = false;
+	if (!frame_ready) {
+		return;
+	}
+
+	wake_ms = HAL_GetTick() - camera_sensor_wake_start_ms;
+	AppSensorPower_RecordWake(&camera_sensor_power, camera_sensor_power_state,
+			true, wake_ms);
+	DebugConsole_Printf(
+			"[CAMERA][POWER] wake from %s to first frame: %lu ms (lead now %lu ms)\r\n",
+			AppSensorPower_StateName(camera_sensor_power_state),
+			(unsigned long) wake_ms,
+			(unsigned long) AppSensorPower_WakeLeadMs(&camera_sensor_power,
+					camera_sensor_power_state));
+	camera_sensor_power_state = APP_SENSOR_POWER_STREAMING;
+}
+
+/**
+ * @brief Park the sensor for the idle gap before the next capture.
+ *
+ * Standby leaves the receiver pipe stopped (it already is between snapshots)
+ * and the ISP loop idle, since that only runs while the sensor streams.
+ * @param idle_ms Time until the next capture should start.
+ * @retval How long before that deadline the caller must start the capture.
+ */
+uint32_t AppCameraCapture_EnterIdlePower(uint32_t idle_ms) {
+	AppSensorPower_State_t target = APP_SENSOR_POWER_STREAMING;
+	bool entered = false;
+
+	if (!camera_capture_use_cmw_pipeline) {
+		return 0U;
+	}
+
+	AppCameraCapture_InitSensorPower();
+	target = AppSensorPower_Choose(&camera_sensor_power, idle_ms);
+	if (target != APP_SENSOR_POWER_STREAMING) {
+		camera_capture_isp_loop_paused = true;
+		if (App_ThreadX_LockCameraMiddleware(
+				CameraPlatform_MillisecondsToTicks(
+						CAMERA_MIDDLEWARE_LOCK_TIMEOUT_MS))) {
+			entered = (target == APP_SENSOR_POWER_OFF) ?
+					CameraPlatform_PowerOffImx335() :
+					CameraPlatform_StopImx335Stream();
+			App_ThreadX_UnlockCameraMiddleware();
+		}
+		camera_capture_isp_loop_paused = false;
+
+		if (!entered) {
+			if (target == APP_SENSOR_POWER_OFF) {
+				AppSensorPower_RecordWake(&camera_sensor_power,
+						APP_SENSOR_POWER_OFF, false, 0U);
+			}
+			DebugConsole_Printf(
+					"[CAMERA][POWER] Could not enter %s; leaving sensor as is.\r\n",
+					AppSensorPower_StateName(target));
+			target = camera_stream_started ?
+					APP_SENSOR_POWER_STREAMING : APP_SENSOR_POWER_STANDBY;
+		}
+	}
+
+	/* Nothing touches the receiver while the sensor is parked, so its
+	 * clocks can go with it. */
+	if ((target != APP_SENSOR_POWER_STREAMING) && camera_dcmipp_domain_held) {
+		AppLowPower_ReleaseDomain(APP_POWER_DOMAIN_CAMERA);
+		camera_dcmipp_domain_held = false;
+	}
+
+	camera_sensor_power_state = target;
+	DebugConsole_Printf("[CAMERA][POWER] idle=%lu ms -> %s (wake lead %lu ms)\r\n",
+			(unsigned long) idle_ms, AppSensorPower_StateName(target),
+			(unsigned long) AppSensorPower_WakeLeadMs(&camera_sensor_power,
+					target));
+	return AppSensorPower_WakeLeadMs(&camera_sensor_power, target);
+}
+#endif
+
+#if CAMERA_CAPTURE_EXPOSURE_MEMORY_ENABLED
+/* Per-hour exposure memory. Lives in RAM between captures and is mirrored to
+ * the SD card so a reset does not lose it. */
+static AppExposureMemory_Table_t camera_exposure_memory;
+static bool camera_exposure_memory_initialized = false;
+static bool camera_exposure_memory_loaded = false;
+
+/**
+ * @brief Read the persisted exposure memory once the SD card is mounted.
+ *
+ * Until the media is ready the table runs RAM-only; the first successful
+ * mount replaces it with the persisted copy when that copy is intact.
+ */
+static void AppCameraCapture_LoadExposureMemory(void) {
+	static AppExposureMemory_Table_t loaded_table;
+	FX_MEDIA *media_ptr = AppFileX_GetMediaHandle();
+	FX_FILE memory_file = { 0 };
+	ULONG actual_size = 0U;
+	UINT fx_status = FX_SUCCESS;
+
+	if (!camera_exposure_memory_initialized) {
+		AppExposureMemory_Init(&camera_exposure_memory);
+		camera_exposure_memory_initialized = true;
+	}
+
+	if (camera_exposure_memory_loaded || !AppFileX_IsMediaReady()
+			|| (media_ptr == NULL)) {
+		return;
+	}
+
+	if (AppFileX_AcquireMediaLock() != TX_SUCCESS) {
+		return;
+	}
+
+	fx_status = fx_file_open(media_ptr, &memory_file,
+			CAMERA_CAPTURE_EXPOSURE_MEMORY_FILE_NAME, FX_OPEN_FOR_READ);
+	if (fx_status == FX_SUCCESS) {
+		fx_status = fx_file_read(&memory_file, &loaded_table,
+				sizeof(loaded_table), &actual_size);
+		(void) fx_file_close(&memory_file);
+	}
+	AppFileX_ReleaseMediaLock();
+	camera_exposure_memory_loaded = true;
+
+	if ((fx_status == FX_SUCCESS) && (actual_size == sizeof(loaded_table))
+			&& AppExposureMemory_IsValid(&loaded_table)) {
+		camera_exposure_memory = loaded_table;
+		DebugConsole_WriteString(
+				"[CAMERA][AE] Loaded exposure memory from SD.\r\n");
+	} else {
+		DebugConsole_Printf(
+				"[CAMERA][AE] No usable exposure memory on SD (status=0x%02X size=%lu); starting empty.\r\n",
+				(unsigned int) fx_status, (unsigned long) actual_size);
+	}
+}
+
+/**
+ * @brief Write the exposure memory table back to the SD card.
+ */
+static void AppCameraCapture_SaveExposureMemory(void) {
+	FX_MEDIA *media_ptr = AppFileX_GetMediaHandle();
+	FX_FILE memory_file = { 0 };
+	UINT fx_status = FX_SUCCESS;
+
+	if (!camera_exposure_memory_loaded || !AppFileX_IsMediaReady()
+			|| (media_ptr == NULL)) {
+		return;
+	}
+
+	if (AppFileX_AcquireMediaLock() != TX_SUCCESS) {
+		return;
+	}
+
+	fx_status = fx_file_open(media_ptr, &memory_file,
+			CAMERA_CAPTURE_EXPOSURE_MEMORY_FILE_NAME, FX_OPEN_FOR_WRITE);
+	if (fx_status == FX_NOT_FOUND) {
+		(void) fx_file_create(media_ptr,
+				CAMERA_CAPTURE_EXPOSURE_MEMORY_FILE_NAME);
+		fx_status = fx_file_open(media_ptr, &memory_file,
+				CAMERA_CAPTURE_EXPOSURE_MEMORY_FILE_NAME, FX_OPEN_FOR_WRITE);
+	}
+	if (fx_status == FX_SUCCESS) {
+		/* Fixed-size record: overwrite in place so the file never shrinks
+		 * into a short read the loader would reject. */
+		(void) fx_file_seek(&memory_file, 0U);
+		fx_status = fx_file_write(&memory_file, &camera_exposure_memory,
+				sizeof(camera_exposure_memory));
+		(void) fx_file_close(&memory_file);
+		(void) fx_media_flush(media_ptr);
+	}
+	AppFileX_ReleaseMediaLock();
+
+	if (fx_status != FX_SUCCESS) {
+		DebugConsole_Printf(
+				"[CAMERA][AE] Failed to persist exposure memory, status=0x%02X.\r\n",
+				(unsigned int) fx_status);
+	}
+}
+
+/**
+ * @brief Seed the IMX335 from the exposure remembered for this hour.
+ * @param[out] time_out Receives the decoded RTC time for the later store.
+ * @retval true when the RTC time was available.
+ */
+static bool AppCameraCapture_SeedFromExposureMemory(
+		AppExposureMemory_Time_t *time_out) {
+	char timestamp[32] = { 0 };
+	uint32_t exposure_us = 0U;
+	int32_t gain_mdb = 0;
+
+	AppCameraCapture_LoadExposureMemory();
+
+	if (!App_Clock_GetCurrentTimestamp(timestamp, sizeof(timestamp))
+			|| !AppExposureMemory_ParseTimestamp(timestamp, time_out)) {
+		DebugConsole_WriteString(
+				"[CAMERA][AE] RTC time unavailable; keeping the last exposure.\r\n");
+		return false;
+	}
+
+	if (!AppExposureMemory_Lookup(&camera_exposure_memory, time_out,
+			CAMERA_CAPTURE_EXPOSURE_MEMORY_MAX_AGE_DAYS, &exposure_us,
+			&gain_mdb)) {
+		DebugConsole_WriteString(
+				"[CAMERA][AE] No remembered exposure for this hour; keeping the last exposure.\r\n");
+		return true;
+	}
+
+	CameraPlatform_SetExposureSeed((int32_t) exposure_us, gain_mdb);
+	(void) CameraPlatform_SeedImx335ExposureGain();
+	return true;
+}
+
+/**
+ * @brief Record the accepted exposure/gain for this hour, persisting on change.
+ */
+static void AppCameraCapture_RememberExposure(
+		const AppExposureMemory_Time_t *time_ptr) {
+	int32_t exposure_us = 0;
+	int32_t gain_mdb = 0;
+
+	if (!CameraPlatform_GetImx335ExposureGain(&exposure_us, &gain_mdb)
+			|| (exposure_us <= 0)) {
+		return;
+	}
+
+	if (AppExposureMemory_Store(&camera_exposure_memory, time_ptr,
+			(uint32_t) exposure_us, gain_mdb)) {
+		AppCameraCapture_SaveExposureMemory();
+	}
+}
+#endif /* CAMERA_CAPTURE_EXPOSURE_MEMORY_ENABLED */
+
+/* Processed-capture pixel layout; see CAMERA_CAPTURE_DEFAULT_FRAME_FORMAT. */
+static AppFrameFormat_t camera_capture_frame_format =
+CAMERA_CAPTURE_DEFAULT_FRAME_FORMAT;
+static bool camera_capture_frame_format_loaded = false;
+
+/**
+ * @brief Select the processed-capture pixel layout from the next frame on.
+ *
+ * Frames already handed to inference or storage keep their layout; every
+ * consumer infers it from the frame length.
+ */
+void AppCameraCapture_SetFrameFormat(AppFrameFormat_t format) {
+	camera_capture_frame_format = format;
+	camera_capture_frame_format_loaded = true;
+}
+
+/**
+ * @brief Processed-capture pixel layout used for the next frame.
+ */
+AppFrameFormat_t AppCameraCapture_GetFrameFormat(void) {
+	return camera_capture_frame_format;
+}
+
+/**
+ * @brief Apply the deployment's frame-format selection file once the SD card
+ *        is mounted.
+ *
+ * A missing or unreadable file keeps the compiled-in default; so does an
+ * explicit AppCameraCapture_SetFrameFormat() call made before the mount.
+ */
+static void AppCameraCapture_LoadFrameFormatSelection(void) {
+	FX_MEDIA *media_ptr = AppFileX_GetMediaHandle();
+	FX_FILE selection_file = { 0 };
+	CHAR selection_text[16] = { 0 };
+	ULONG actual_size = 0U;
+	UINT fx_status = FX_SUCCESS;
+	AppFrameFormat_t selected = camera_capture_frame_format;
+
+	if (camera_capture_frame_format_loaded || !AppFileX_IsMediaReady()
+			|| (media_ptr == NULL)) {
+		return;
+	}
+
+	if (AppFileX_AcquireMediaLock() != TX_SUCCESS) {
+		return;
+	}
+
+	fx_status = fx_file_open(media_ptr, &selection_file,
+			CAMERA_CAPTURE_FRAME_FORMAT_FILE_NAME, FX_OPEN_FOR_READ);
+	if (fx_status == FX_SUCCESS) {
+		fx_status = fx_file_read(&selection_file, selection_text,
+				sizeof(selection_text) - 1U, &actual_size);
+		(void) fx_file_close(&selection_file);
+	}
+	AppFileX_ReleaseMediaLock();
+	camera_capture_frame_format_loaded = true;
+
+	if (fx_status != FX_SUCCESS) {
+		return;
+	}
+
+	if (!AppFrameFormat_Parse(selection_text, (size_t) actual_size,
+			&selected)) {
+		DebugConsole_Printf(
+				"[CAMERA][CAPTURE] Ignoring unrecognised %s; keeping %s.\r\n",
+				CAMERA_CAPTURE_FRAME_FORMAT_FILE_NAME,
+				AppFrameFormat_FileExtension(camera_capture_frame_format));
+		return;
+	}
+
+	camera_capture_frame_format = selected;
+	DebugConsole_Printf("[CAMERA][CAPTURE] Frame format %s selected by %s.\r\n",
+			AppFrameFormat_FileExtension(selected),
+			CAMERA_CAPTURE_FRAME_FORMAT_FILE_NAME);
+}
+
+#if CAMERA_CAPTURE_PREDICTIVE_EXPOSURE_ENABLED
+/**
+ * @brief Program the exposure/gain the controller predicts for the next frame.
+ *
+ * The controller is initialised lazily on the first rejected frame so a
+ * request that passes the gate first time never touches the sensor limits.
+ * @retval false when the sensor is at its limit or the middleware refused the
+ *         new setting; another capture would not help.
+ */
+static bool AppCameraCapture_ApplyPredictiveExposure(
+		AppExposureControl_Context_t *context_ptr, bool *context_ready_ptr) {
+	AppExposureControl_Measurement_t measurement = { 0 };
+	AppExposureControl_Setting_t current = { 0 };
+	AppExposureControl_Setting_t next = { 0 };
+	int32_t exposure_us = 0;
+
+	if (!*context_ready_ptr) {
+		const AppExposureControl_Config_t config = {
+			.target_mean = (float) CAMERA_CAPTURE_BRIGHTNESS_TARGET_MEAN,
+			.response_gamma = CAMERA_CAPTURE_EXPOSURE_RESPONSE_GAMMA,
+			.second_step_damping = CAMERA_CAPTURE_EXPOSURE_SECOND_STEP_DAMPING,
+			.max_step_ratio = CAMERA_CAPTURE_EXPOSURE_MAX_STEP_RATIO,
+		};
+		AppExposureControl_Limits_t limits = { 0 };
+
+		if (!CameraPlatform_GetImx335ExposureLimits(&limits.exposure_min_us,
+				&limits.exposure_max_us, &limits.gain_min_mdb,
+				&limits.gain_max_mdb)) {
+			return false;
+		}
+		AppExposureControl_Init(context_ptr, &config, &limits);
+		*context_ready_ptr = true;
+	}
+
+	if (!AppExposureControl_Measure(camera_capture_luma_histogram,
+			&measurement)
+			|| !CameraPlatform_GetImx335ExposureGain(&exposure_us,
+					&current.gain_mdb)) {
+		return false;
+	}
+	current.exposure_us = (exposure_us > 0) ? (uint32_t) exposure_us : 0U;
+
+	if (!AppExposureControl_ComputeNext(context_ptr, &measurement, &current,
+			&next)) {
+		DebugConsole_WriteString(
+				"[CAMERA][CAPTURE] Predictive exposure reached sensor limit; no change applied.\r\n");
+		return false;
+	}
+
+	if (!CameraPlatform_SetImx335ExposureGain((int32_t) next.exposure_us,
+			next.gain_mdb)) {
+		return false;
+	}
+
+	DebugConsole_Printf(
+			"[CAMERA][CAPTURE] Predictive exposure step %lu: clip_hi=%lu%% clip_lo=%lu%% gamma=%lu/100, exposure %lu->%lu us gain %ld->%ld mdB.\r\n",
+			(unsigned long) context_ptr->step_count,
+			(unsigned long) (measurement.clipped_high_fraction * 100.0f),
+			(unsigned long) (measurement.clipped_low_fraction * 100.0f),
+			(unsigned long) (context_ptr->estimated_gamma * 100.0f),
+			(unsigned long) current.exposure_us,
+			(unsigned long) next.exposure_us, (long) current.gain_mdb,
+			(long) next.gain_mdb);
+	return true;
+}
+#endif /* CAMERA_CAPTURE_PREDICTIVE_EXPOSURE_ENABLED */
+
+#if CAMERA_CAPTURE_ROI_MODE_ENABLED
+/* ROI capture state. Only the camera thread touches it; the AI worker hands
+ * boxes over through App_AI_GetLastGaugeBox(). */
+static const AppCaptureRoi_Config_t camera_capture_roi_config = {
+	.sensor_width = IMX335_SENSOR_WIDTH_PIXELS,
+	.sensor_height = IMX335_SENSOR_HEIGHT_LINES,
+	.output_width = CAMERA_CAPTURE_WIDTH_PIXELS,
+	.output_height = CAMERA_CAPTURE_HEIGHT_PIXELS,
+	.target_x_min = APP_GAUGE_TRAINING_CROP_X_MIN_RATIO,
+	.target_y_min = APP_GAUGE_TRAINING_CROP_Y_MIN_RATIO,
+	.target_x_max = APP_GAUGE_TRAINING_CROP_X_MAX_RATIO,
+	.target_y_max = APP_GAUGE_TRAINING_CROP_Y_MAX_RATIO,
+	.margin_percent = CAMERA_CAPTURE_ROI_MARGIN_PERCENT,
+	.min_window_width = CAMERA_CAPTURE_ROI_MIN_WINDOW_PIXELS,
+	.move_tolerance_percent = CAMERA_CAPTURE_ROI_MOVE_TOLERANCE_PERCENT,
+};
+static AppCaptureRoi_Window_t camera_capture_roi_window;
+/* Window and box generation at the last dispatch, so the box that frame
+ * produces is mapped through the window it was actually captured with. */
+static AppCaptureRoi_Window_t camera_capture_roi_dispatch_window;
+static uint32_t camera_capture_roi_dispatch_generation = 0U;
+static uint32_t camera_capture_roi_dispatch_sequence = 0U;
+static bool camera_capture_roi_dispatched = false;
+static bool camera_capture_roi_dispatch_ran_obb = false;
+static bool camera_capture_roi_initialized = false;
+static bool camera_capture_roi_locked = false;
+static uint32_t camera_capture_roi_frames_since_obb = 0U;
+
+/**
+ * @brief Program the CMW pipe with the tracked window.
+ */
+static void AppCameraCapture_ApplyRoiWindow(const char *reason) {
+	if (!CameraPlatform_SetCaptureWindow(camera_capture_roi_window.x,
+			camera_capture_roi_window.y, camera_capture_roi_window.width,
+			camera_capture_roi_window.height)) {
+		AppCaptureRoi_DefaultWindow(&camera_capture_roi_config,
+				&camera_capture_roi_window);
+		(void) CameraPlatform_SetCaptureWindow(0U, 0U, 0U, 0U);
+		camera_capture_roi_locked = false;
+	}
+
+	DebugConsole_Printf(
+			"[CAMERA][ROI] %s: window x=%lu y=%lu %lux%lu.\r\n", reason,
+			(unsigned long) camera_capture_roi_window.x,
+			(unsigned long) camera_capture_roi_window.y,
+			(unsigned long) camera_capture_roi_window.width,
+			(unsigned long) camera_capture_roi_window.height);
+}
+
+/**
+ * @brief Fold the outcome of the previous frame into the capture window.
+ *
+ * A new OBB box moves the window onto the gauge. A re-validation frame that
+ * produced no box means the gauge is no longer where the window expects it,
+ * so the default centred framing comes back until the OBB finds it again.
+ */
+static void AppCameraCapture_UpdateRoiWindow(void) {
+	AppCaptureRoi_Box_t box = { 0 };
+	AppCaptureRoi_Window_t next = { 0 };
+	uint32_t generation = 0U;
+	bool published = false;
+	bool have_box = false;
+
+	if (!camera_capture_roi_initialized) {
+		AppCaptureRoi_DefaultWindow(&camera_capture_roi_config,
+				&camera_capture_roi_window);
+		camera_capture_roi_initialized = true;
+	}
+
+	if (!camera_capture_roi_dispatched) {
+		return;
+	}
+	camera_capture_roi_dispatched = false;
+
+	/* A frame still queued behind the AI worker says nothing yet; leave the
+	 * window alone rather than mistaking it for a lost gauge. */
+	if (!AppInferenceRuntime_WaitForRequestOutcome(
+			camera_capture_roi_dispatch_sequence, 0U, &published)) {
+		return;
+	}
+
+	have_box = App_AI_GetLastGaugeBox(&box.center_x, &box.center_y, &box.width,
+			&box.height, &generation)
+			&& (generation != camera_capture_roi_dispatch_generation);
+	if (!have_box) {
+		if (camera_capture_roi_dispatch_ran_obb && camera_capture_roi_locked) {
+			AppCaptureRoi_DefaultWindow(&camera_capture_roi_config,
+					&camera_capture_roi_window);
+			camera_capture_roi_locked = false;
+			AppCameraCapture_ApplyRoiWindow("re-validation lost gauge");
+		}
+		return;
+	}
+
+	if (!AppCaptureRoi_WindowFromBox(&camera_capture_roi_config,
+			&camera_capture_roi_dispatch_window, &box, &next)) {
+		return;
+	}
+
+	if (!camera_capture_roi_locked
+			|| AppCaptureRoi_ShouldMove(&camera_capture_roi_config,
+					&camera_capture_roi_window, &next)) {
+		camera_capture_roi_window = next;
+		AppCameraCapture_ApplyRoiWindow(
+				camera_capture_roi_locked ? "moved" : "locked");
+	}
+	camera_capture_roi_locked = true;
+}
+
+/**
+ * @brief Tell the AI worker whether this frame needs the OBB stage and
+ *        remember the window it was captured with.
+ */
+static void AppCameraCapture_PrepareRoiDispatch(void) {
+	const bool run_obb = !camera_capture_roi_locked
+			|| (camera_capture_roi_frames_since_obb
+					>= CAMERA_CAPTURE_ROI_REVALIDATE_FRAMES);
+	float unused = 0.0f;
+
+	camera_capture_roi_frames_since_obb =
+			run_obb ? 0U : (camera_capture_roi_frames_since_obb + 1U);
+	camera_capture_roi_dispatch_ran_obb = run_obb;
+	camera_capture_roi_dispatch_window = camera_capture_roi_window;
+	(void) App_AI_GetLastGaugeBox(&unused, &unused, &unused, &unused,
+			&camera_capture_roi_dispatch_generation);
+	App_AI_SetObbStageSkipped(!run_obb);
+}
+#endif /* CAMERA_CAPTURE_ROI_MODE_ENABLED */
+
+#if CAMERA_CAPTURE_BURST_ENABLED
+/* Burst ring: frame 0 is the gated frame, the rest are captured straight
+ * after it. Fusion writes back into the DMA buffer, which is free by then. */
+static uint8_t camera_capture_burst_frames[CAMERA_CAPTURE_BURST_FRAMES][CAMERA_CAPTURE_BUFFER_SIZE_BYTES]
+		__attribute__((aligned(32)));
+
+/**
+ * @brief Decide whether the accepted frame is worth a burst.
+ */
+static bool AppCameraCapture_ShouldCaptureBurst(
+		const AppLumaStats_t *stats) {
+	int32_t exposure_us = 0;
+	int32_t gain_mdb = 0;
+
+	if ((stats != NULL) && (stats->sample_count > 0U)
+			&& ((stats->bright_sample_count * 100U)
+					>= (stats->sample_count
+							* CAMERA_CAPTURE_BURST_GLARE_RATIO_PERCENT))) {
+		return true;
+	}
+
+	return CameraPlatform_GetImx335ExposureGain(&exposure_us, &gain_mdb)
+			&& (gain_mdb >= CAMERA_CAPTURE_BURST_MIN_GAIN_MDB);
+}
+
+/**
+ * @brief Capture the rest of the burst and fuse it into the capture buffer.
+ *
+ * The ISP loop stays paused between snapshots, so exposure and gain are the
+ * values the gate just accepted. A failed or short frame ends the burst
+ * early; with fewer than two frames the original capture is left as is.
+ */
+static void AppCameraCapture_CaptureBurstAndFuse(uint32_t captured_bytes) {
+	const ULONG start_tick = tx_time_get();
+	const AppFrameFormat_t format = CameraPlatform_GetCaptureFrameFormat();
+	const uint8_t *frames[CAMERA_CAPTURE_BURST_FRAMES];
+	AppBurstFusion_Shift_t shifts[CAMERA_CAPTURE_BURST_FRAMES] = { { 0, 0 } };
+	uint32_t frame_count = 1U;
+
+	if ((camera_capture_result_buffer == NULL)
+			|| (captured_bytes != CameraPlatform_GetCaptureFrameBytes())
+			|| (captured_bytes > CAMERA_CAPTURE_BUFFER_SIZE_BYTES)) {
+		return;
+	}
+
+	(void) memcpy(camera_capture_burst_frames[0], camera_capture_result_buffer,
+			captured_bytes);
+	frames[0] = camera_capture_burst_frames[0];
+
+	while (frame_count < CAMERA_CAPTURE_BURST_FRAMES) {
+		uint32_t burst_bytes = 0U;
+
+		if (!AppCameraCapture_CaptureSingleFrame(&burst_bytes)
+				|| (burst_bytes != captured_bytes)) {
+			DebugConsole_Printf(
+					"[CAMERA][CAPTURE] Burst stopped after %lu frame(s).\r\n",
+					(unsigned long) frame_count);
+			break;
+		}
+		(void) memcpy(camera_capture_burst_frames[frame_count],
+				camera_capture_result_buffer, captured_bytes);
+		frames[frame_count] = camera_capture_burst_frames[frame_count];
+		if (!AppBurstFusion_EstimateShift(frames[0], frames[frame_count],
+				format, CAMERA_CAPTURE_WIDTH_PIXELS,
+				CAMERA_CAPTURE_HEIGHT_PIXELS,
+				CAMERA_CAPTURE_BURST_MAX_SHIFT_PIXELS, &shifts[frame_count])) {
+			break;
+		}
+		frame_count++;
+	}
+
+	if ((camera_capture_result_buffer == NULL) || (frame_count < 2U)
+			|| !AppBurstFusion_Fuse(frames, shifts, frame_count, format,
+					CAMERA_CAPTURE_WIDTH_PIXELS, CAMERA_CAPTURE_HEIGHT_PIXELS,
+					CAMERA_CAPTURE_BURST_FUSION_METHOD,
+					camera_capture_result_buffer)) {
+		/* Put the gated frame back; a later burst frame may have replaced it. */
+		if (camera_capture_result_buffer != NULL) {
+			(void) memcpy(camera_capture_result_buffer,
+					camera_capture_burst_frames[0], captured_bytes);
+		}
+		return;
+	}
+
+	DebugConsole_Printf(
+			"[CAMERA][CAPTURE][TIMING] burst-fuse=%lu ms frames=%lu last-shift=(%ld,%ld)\r\n",
+			(unsigned long) (((tx_time_get() - start_tick) * 1000U)
+					/ (ULONG) TX_TIMER_TICKS_PER_SECOND),
+			(unsigned long) frame_count,
+			(long) shifts[frame_count - 1U].dx,
+			(long) shifts[frame_count - 1U].dy);
+}
+#endif /* CAMERA_CAPTURE_BURST_ENABLED */
+
+/**
+ * @brief Load the SD-backed capture settings and seed the sensor before the
+ *        first capture.
+ *
+ * Runs as the boot orchestrator's AE-seed task so the file reads and the
+ * sensor write overlap with model init. Both loaders retry on later
+ * captures, so running before the SD mount only loses the remembered seed
+ * for the first frame.
+ * @retval true when the processed pipeline is active.
+ */
+bool AppCameraCapture_PrepareFirstCapture(void) {
+	if (!camera_capture_use_cmw_pipeline) {
+		return false;
+	}
+
+	AppCameraCapture_LoadFrameFormatSelection();
+	CameraPlatform_SetCaptureFrameFormat(camera_capture_frame_format);
+#if CAMERA_CAPTURE_EXPOSURE_MEMORY_ENABLED
+	{
+		AppExposureMemory_Time_t exposure_time = { 0 };
+
+		(void) AppCameraCapture_SeedFromExposureMemory(&exposure_time);
+	}
+#endif
+	return true;
+}
+
+/**
+ * @brief Capture a single frame, dispatch inference, then queue the SD save.
+ *
+ * Inference is requested as soon as the frame passes the brightness gate so
+ * capture-to-result latency is bounded by compute. The archival save runs
+ * afterwards in the storage worker from the same reference-held buffer.
+ * @retval true when the frame was captured and handed to inference/storage.
  */
 bool AppCameraCapture_CaptureAndStoreSingleFrame(void) {
 	uint32_t captured_bytes = 0U;
-	UINT filex_status = FX_SUCCESS;
-	CHAR capture_file_name[CAMERA_CAPTURE_FILE_NAME_LENGTH] = { 0 };
 	uint8_t *image_ptr = NULL;
 	ULONG image_length = captured_bytes;
 	bool result = false;
 	const bool storage_ready = AppFileX_IsMediaReady();
-	const CHAR *file_extension = camera_capture_use_cmw_pipeline ? "yuv422"
-			: "raw16";
+	const CHAR *file_extension = "raw16";
+#if CAMERA_CAPTURE_PREDICTIVE_EXPOSURE_ENABLED
+	const uint32_t max_brightness_adjustments =
+	CAMERA_CAPTURE_EXPOSURE_MAX_CORRECTIONS;
+	AppExposureControl_Context_t exposure_context;
+	bool exposure_context_ready = false;
+	uint32_t *const luma_histogram_ptr = camera_capture_luma_histogram;
+#else
 	const uint32_t max_brightness_adjustments =
 	CAMERA_CAPTURE_BRIGHTNESS_RETRY_LIMIT;
+	AppCameraCapture_BrightnessGate_t previous_brightness_gate =
+	APP_CAMERA_CAPTURE_BRIGHTNESS_OK;
+	uint32_t *const luma_histogram_ptr = NULL;
+#endif
 	const uint32_t max_dcmipp_retries = 1U;
 	uint32_t capture_attempt = 0U;
 	uint32_t brightness_adjustment_count = 0U;
 	uint32_t dcmipp_retry_count = 0U;
 	bool capture_ok = false;
 	bool discard_next_successful_frame = false;
-	AppCameraCapture_BrightnessGate_t previous_brightness_gate =
-	APP_CAMERA_CAPTURE_BRIGHTNESS_OK;
-	AppCameraCapture_BrightnessStats_t brightness_stats = { 0 };
+	AppLumaStats_t brightness_stats = { 0 };
+	bool brightness_from_isp = false;
 	AppCameraCapture_BrightnessGate_t brightness_gate =
 	APP_CAMERA_CAPTURE_BRIGHTNESS_OK;
+#if CAMERA_CAPTURE_EXPOSURE_MEMORY_ENABLED
+	AppExposureMemory_Time_t exposure_time = { 0 };
+	bool exposure_time_valid = false;
+	bool ae_settle_pending = false;
+#endif
 
 	(void) DebugConsole_WriteString(
 			"[CAMERA][CAPTURE] Begin capture-and-store request.\r\n");
@@ -753,11 +1592,42 @@ bool AppCameraCapture_CaptureAndStoreSingleFrame(void) {
 				"[CAMERA][CAPTURE] FileX media not ready yet; this capture will skip SD save.\r\n");
 	}
 
+#if CAMERA_SENSOR_POWER_ENABLED
+	if (camera_capture_use_cmw_pipeline && !AppCameraCapture_BeginSensorWake()) {
+		DebugConsole_WriteString(
+				"[CAMERA][POWER] Sensor did not come back from power-off; skipping this cycle.\r\n");
+		return false;
+	}
+#endif
+
+	if (camera_capture_use_cmw_pipeline) {
+		AppCameraCapture_LoadFrameFormatSelection();
+		CameraPlatform_SetCaptureFrameFormat(camera_capture_frame_format);
+		file_extension = AppFrameFormat_FileExtension(
+				camera_capture_frame_format);
+	}
+
+#if CAMERA_CAPTURE_ROI_MODE_ENABLED
+	if (camera_capture_use_cmw_pipeline) {
+		AppCameraCapture_UpdateRoiWindow();
+	}
+#endif
+
+#if CAMERA_CAPTURE_EXPOSURE_MEMORY_ENABLED
+	/* Start from the exposure remembered for this hour and defer the AE
+	 * settle until the first frame actually fails the gate. */
+	if (camera_capture_use_cmw_pipeline) {
+		exposure_time_valid = AppCameraCapture_SeedFromExposureMemory(
+				&exposure_time);
+		ae_settle_pending = true;
+	}
+#else
 	/* Before the first capture attempt, let AE hardware settle then lock
 	 * so the manual brightness-gate nudges start from a stable baseline. */
 	if ((capture_attempt == 0U) && camera_capture_use_cmw_pipeline) {
 		(void)CameraPlatform_AeSettleAndLock();
 	}
+#endif
 
 	for (capture_attempt = 0U;; capture_attempt++) {
 		if (capture_attempt > 0U) {
@@ -773,6 +1643,9 @@ bool AppCameraCapture_CaptureAndStoreSingleFrame(void) {
 		}
 
 		if (AppCameraCapture_CaptureSingleFrame(&captured_bytes)) {
+#if CAMERA_SENSOR_POWER_ENABLED
+			AppCameraCapture_FinishSensorWake(true);
+#endif
 			if (discard_next_successful_frame) {
 				/* A DCMIPP retry can recover a usable buffer, but the preceding
 				 * transport error means this frame is less trustworthy than a clean
@@ -787,8 +1660,9 @@ bool AppCameraCapture_CaptureAndStoreSingleFrame(void) {
 			capture_ok = true;
 			image_ptr = camera_capture_result_buffer;
 			if (camera_capture_use_cmw_pipeline) {
-				if (!AppCameraCapture_ComputeBrightnessStats(image_ptr,
-						captured_bytes, &brightness_stats)) {
+				if (!AppCameraCapture_MeasureBrightness(image_ptr,
+						captured_bytes, &brightness_stats, luma_histogram_ptr,
+						&brightness_from_isp)) {
 					DebugConsole_Printf(
 							"[CAMERA][CAPTURE] Brightness gate could not analyze processed frame; retrying capture.\r\n");
 					capture_ok = false;
@@ -804,7 +1678,23 @@ bool AppCameraCapture_CaptureAndStoreSingleFrame(void) {
 				AppCameraCapture_ClassifyBrightness(&brightness_stats);
 				if (brightness_gate != APP_CAMERA_CAPTURE_BRIGHTNESS_OK) {
 					AppCameraCapture_LogBrightnessGateDecision(&brightness_stats,
-							brightness_gate);
+							brightness_gate, brightness_from_isp);
+#if CAMERA_CAPTURE_EXPOSURE_MEMORY_ENABLED
+					if (ae_settle_pending) {
+						/* The remembered seed missed; fall back to one AE settle
+						 * before spending the correction budget. The snapshot
+						 * left the ISP loop paused, and AEC only converges while
+						 * the background loop runs, so release it for the settle;
+						 * the next snapshot pauses it again. */
+						ae_settle_pending = false;
+						DebugConsole_WriteString(
+								"[CAMERA][AE] Seeded frame failed the gate; running AE settle.\r\n");
+						camera_capture_isp_loop_paused = false;
+						(void) CameraPlatform_AeSettleAndLock();
+						capture_ok = false;
+						continue;
+					}
+#endif
 					if (brightness_adjustment_count
 							>= max_brightness_adjustments) {
 						DebugConsole_Printf(
@@ -813,6 +1703,25 @@ bool AppCameraCapture_CaptureAndStoreSingleFrame(void) {
 						capture_ok = false;
 						break;
 					}
+#if CAMERA_CAPTURE_PREDICTIVE_EXPOSURE_ENABLED
+					/* One model-based correction from this frame's histogram
+					 * replaces the fixed-percentage nudge ladder. The hardware
+					 * summary has no 256-bin histogram, so sample it here. */
+					if (brightness_from_isp) {
+						AppLumaStats_t sampled_stats = { 0 };
+
+						(void) AppCameraCapture_ComputeBrightnessStats(image_ptr,
+								captured_bytes, &sampled_stats,
+								luma_histogram_ptr);
+					}
+					if (!AppCameraCapture_ApplyPredictiveExposure(
+							&exposure_context, &exposure_context_ready)) {
+						DebugConsole_WriteString(
+								"[CAMERA][CAPTURE] Brightness gate could not correct IMX335 exposure/gain; stopping retries.\r\n");
+						capture_ok = false;
+						break;
+					}
+#else
 					const uint32_t brightness_step_percent =
 						AppCameraCapture_ComputeBrightnessStepPercent(
 								&brightness_stats, brightness_gate,
@@ -831,6 +1740,7 @@ bool AppCameraCapture_CaptureAndStoreSingleFrame(void) {
 						break;
 					}
 					previous_brightness_gate = brightness_gate;
+#endif
 					brightness_adjustment_count++;
 					DebugConsole_WriteString(
 							"[CAMERA][CAPTURE] Brightness gate triggered; retrying capture after exposure/gain nudge.\r\n");
@@ -838,6 +1748,11 @@ bool AppCameraCapture_CaptureAndStoreSingleFrame(void) {
 					continue;
 				}
 				CameraPlatform_CacheAcceptedExposureGain();
+#if CAMERA_CAPTURE_EXPOSURE_MEMORY_ENABLED
+				if (exposure_time_valid) {
+					AppCameraCapture_RememberExposure(&exposure_time);
+				}
+#endif
 			}
 
 			break;
@@ -858,10 +1773,22 @@ bool AppCameraCapture_CaptureAndStoreSingleFrame(void) {
 		discard_next_successful_frame = true;
 	}
 
+#if CAMERA_SENSOR_POWER_ENABLED
+	AppCameraCapture_FinishSensorWake(false);
+#endif
 	if (!capture_ok) {
 		return false;
 	}
 
+#if CAMERA_CAPTURE_BURST_ENABLED
+	if (camera_capture_use_cmw_pipeline
+			&& AppCameraCapture_ShouldCaptureBurst(&brightness_stats)) {
+		AppCameraCapture_CaptureBurstAndFuse(captured_bytes);
+		/* The fused frame no longer matches any single NN pipe frame. */
+		camera_capture_nn_frame.valid = false;
+	}
+#endif
+
 	image_length = captured_bytes;
 	image_ptr = camera_capture_result_buffer;
 	if (image_ptr == NULL) {
@@ -871,6 +1798,14 @@ bool AppCameraCapture_CaptureAndStoreSingleFrame(void) {
 	}
 
 	(void) DebugConsole_WriteString("[CAMERA][CAPTURE] step: frame-ready\r\n");
+	/* One pass over the accepted frame feeds every later consumer; it runs
+	 * before dispatch so the inference snapshot can adopt it. */
+	if (!AppCameraBuffers_DescribeCaptureFrame(image_ptr,
+			(uint32_t) image_length)) {
+		DebugConsole_Printf(
+				"[CAMERA][CAPTURE] Frame ingest skipped for length %lu.\r\n",
+				(unsigned long) image_length);
+	}
 #if CAMERA_CAPTURE_ENABLE_VERBOSE_DIAGNOSTICS
 	DebugConsole_Printf(
 			"[CAMERA][CAPTURE] Frame ready for save: ptr=%p length=%lu pipeline=%s\r\n",
@@ -878,76 +1813,53 @@ bool AppCameraCapture_CaptureAndStoreSingleFrame(void) {
 			camera_capture_use_cmw_pipeline ? "processed" : "raw");
 #endif
 
-	(void) DebugConsole_WriteString("[CAMERA][CAPTURE] step: preview\r\n");
-#if CAMERA_CAPTURE_ENABLE_VERBOSE_DIAGNOSTICS
-	AppCameraDiagnostics_LogCaptureBufferPreview("ready-to-save", image_ptr,
-			(uint32_t) image_length);
-#endif
-	AppCameraDiagnostics_LogYuv422ChromaSummary("ready-to-save", image_ptr,
-			(uint32_t) image_length);
-	AppCameraCapture_LogSavePathState(image_ptr, (uint32_t) image_length);
-
 	if (camera_capture_use_cmw_pipeline) {
-	if (storage_ready) {
-		const ULONG build_name_start_tick = tx_time_get();
-		(void) DebugConsole_WriteString(
-				"[CAMERA][CAPTURE] step: build-name\r\n");
-		if (!AppStorage_BuildCaptureFileName(capture_file_name,
-				sizeof(capture_file_name), file_extension)) {
-			DebugConsole_Printf(
-					"[CAMERA][CAPTURE] Failed to build capture filename.\r\n");
-			goto cleanup;
-		}
-		(void) DebugConsole_WriteString(
-				"[CAMERA][CAPTURE] step: build-name-done\r\n");
-		DebugConsole_Printf(
-				"[CAMERA][CAPTURE][TIMING] build-name=%lu ms name=%s\r\n",
-				(unsigned long)(((tx_time_get() - build_name_start_tick) *
-					1000U) / (ULONG)TX_TIMER_TICKS_PER_SECOND),
-				capture_file_name);
+		const ULONG dispatch_start_tick = tx_time_get();
+		uint32_t inference_sequence = 0U;
 
-		if (camera_capture_use_cmw_pipeline) {
-#if CAMERA_CAPTURE_ENABLE_VERBOSE_DIAGNOSTICS
-			AppCameraCapture_LogCaptureState("processed-capture");
-			AppCameraDiagnostics_LogProcessedFrameDiagnostics("processed-capture",
-					image_ptr, (uint32_t) image_length);
+#if CAMERA_CAPTURE_ROI_MODE_ENABLED
+		AppCameraCapture_PrepareRoiDispatch();
 #endif
-		}
-
-		{
-			const ULONG save_start_tick = tx_time_get();
-			DebugConsole_Printf(
-					"[CAMERA][CAPTURE][TIMING] write-image start name=%s len=%lu\r\n",
-					capture_file_name, (unsigned long) image_length);
-			filex_status = AppFileX_WriteCapturedImage(capture_file_name,
-					image_ptr, image_length);
+		if (AppInferenceRuntime_RequestDryInference(
+					(const uint8_t *) image_ptr, (ULONG) image_length)) {
+			inference_sequence = AppInferenceRuntime_GetLastRequestSequence();
+#if CAMERA_CAPTURE_ROI_MODE_ENABLED
+			camera_capture_roi_dispatch_sequence = inference_sequence;
+			camera_capture_roi_dispatched = true;
+#endif
+		} else {
 			DebugConsole_Printf(
-					"[CAMERA][CAPTURE][TIMING] write-image=%lu ms status=%lu name=%s\r\n",
-					(unsigned long)(((tx_time_get() - save_start_tick) *
-						1000U) / (ULONG)TX_TIMER_TICKS_PER_SECOND),
-					(unsigned long) filex_status,
-					capture_file_name);
+					"[AI] Failed to queue one-shot dry-run inference.\r\n");
 		}
-		if (filex_status != FX_SUCCESS) {
+		DebugConsole_Printf(
+				"[CAMERA][CAPTURE][TIMING] inference-dispatch=%lu ms\r\n",
+				(unsigned long)(((tx_time_get() - dispatch_start_tick) *
+					1000U) / (ULONG)TX_TIMER_TICKS_PER_SECOND));
+
+		if (!storage_ready) {
+			(void) DebugConsole_WriteString(
+					"[CAMERA][CAPTURE] step: save-skipped\r\n");
+		} else if (!AppCaptureStorage_SubmitFrame(image_ptr, image_length,
+				file_extension, inference_sequence)) {
 			DebugConsole_Printf(
-					"[CAMERA][CAPTURE] Failed to write image to SD card, status=%lu.\r\n",
-					(unsigned long) filex_status);
-			goto cleanup;
+					"[CAMERA][CAPTURE] Failed to queue archival save.\r\n");
 		}
-	} else {
-		(void) DebugConsole_WriteString(
-				"[CAMERA][CAPTURE] step: build-name-skipped\r\n");
 	}
 
-	if (camera_capture_use_cmw_pipeline) {
-		if (!AppInferenceRuntime_RequestDryInference(
-					(const uint8_t *) image_ptr, (ULONG) image_length)) {
-			DebugConsole_Printf(
-					"[AI] Failed to queue one-shot dry-run inference.\r\n");
-		}
+	(void) DebugConsole_WriteString("[CAMERA][CAPTURE] step: preview\r\n");
+#if CAMERA_CAPTURE_ENABLE_VERBOSE_DIAGNOSTICS
+	AppCameraDiagnostics_LogCaptureBufferPreview("ready-to-save", image_ptr,
+			(uint32_t) image_length);
+	AppCameraCapture_LogCaptureState("processed-capture");
+	AppCameraDiagnostics_LogProcessedFrameDiagnostics("processed-capture",
+			image_ptr, (uint32_t) image_length);
+#endif
+	if (CameraPlatform_GetCaptureFrameFormat() == APP_FRAME_FORMAT_YUV422) {
+		AppCameraDiagnostics_LogYuv422ChromaSummary("ready-to-save",
+				&camera_capture_frame_descriptor);
 	}
+	AppCameraCapture_LogSavePathState(image_ptr, (uint32_t) image_length);
 
-	}
 	result = true;
 
 cleanup:
@@ -7,13 +7,17 @@
 
 #include "app_camera_platform.h"
 
+#include <string.h>
+
 #include "app_camera_buffers.h"
 #include "app_camera_config.h"
+#include "app_gauge_geometry.h"
 #include "cmw_camera.h"
 #include "cmw_imx335.h"
 #include "debug_console.h"
 #include "imx335.h"
 #include "isp_api.h"
+#include "isp_services.h"
 #include "threadx_utils.h"
 
 extern DCMIPP_HandleTypeDef hdcmipp;
@@ -30,6 +34,33 @@ extern uint8_t *camera_capture_result_buffer;
 static int32_t camera_cached_exposure_us = 0;
 static int32_t camera_cached_gain_mdb = 0;
 
+/* Sensor window the CMW pipe crops and downscales to the capture size. Zero
+ * width means the default centred square. */
+static uint32_t camera_capture_window_x = 0U;
+static uint32_t camera_capture_window_y = 0U;
+static uint32_t camera_capture_window_width = 0U;
+static uint32_t camera_capture_window_height = 0U;
+
+/* Pixel layout the CMW pipe packs into the capture buffer. */
+static AppFrameFormat_t camera_capture_frame_format = APP_FRAME_FORMAT_YUV422;
+
+/* Ancillary NN pipe of the current snapshot. It is prepared only for YUV422
+ * captures while the previous NN frame is not held by the AI worker; a setup
+ * failure leaves it off until reset and inference preprocesses on the CPU. */
+static AppNnPipe_Layout_t camera_nn_pipe_layout;
+static bool camera_nn_pipe_prepared = false;
+static bool camera_nn_pipe_armed = false;
+#if CAMERA_CAPTURE_ENABLE_NN_PIPE
+static bool camera_nn_pipe_disabled = false;
+static uint32_t camera_nn_pipe_cleared_offset = UINT32_MAX;
+#endif
+
+/* ISP frame id at which the current snapshot's luma statistics become
+ * trustworthy; false until CameraPlatform_ArmIspLumaStats() succeeds. */
+static uint32_t camera_isp_stats_valid_from_frame_id = 0U;
+static bool camera_isp_stats_armed = false;
+static ISP_SVC_StatStateTypeDef camera_isp_stats_request;
+
 /**
  * @brief Read the official IMX335 chip-ID register.
  * @param[out] chip_id Receives the register contents on success.
@@ -206,6 +237,203 @@ void CameraPlatform_CacheAcceptedExposureGain(void) {
 	}
 }
 
+/**
+ * @brief Replace the cached seed with a remembered exposure/gain.
+ *
+ * The next CameraPlatform_SeedImx335ExposureGain() call programs it.
+ */
+void CameraPlatform_SetExposureSeed(int32_t exposure_us, int32_t gain_mdb) {
+	if (exposure_us <= 0) {
+		return;
+	}
+
+	camera_cached_exposure_us = exposure_us;
+	camera_cached_gain_mdb = gain_mdb;
+}
+
+/**
+ * @brief Select the sensor window the next CMW snapshot is cropped from.
+ *
+ * The window is applied by CameraPlatform_PrepareDcmippSnapshot(), which
+ * downscales it to the fixed capture size. A zero width restores the default
+ * centred square.
+ * @retval false when the window does not fit on the sensor or would need
+ *         upscaling.
+ */
+bool CameraPlatform_SetCaptureWindow(uint32_t x, uint32_t y, uint32_t width,
+		uint32_t height) {
+	if (width == 0U) {
+		camera_capture_window_width = 0U;
+		return true;
+	}
+
+	if ((width < CAMERA_CAPTURE_WIDTH_PIXELS)
+			|| (height < CAMERA_CAPTURE_HEIGHT_PIXELS)
+			|| ((x + width) > IMX335_SENSOR_WIDTH_PIXELS)
+			|| ((y + height) > IMX335_SENSOR_HEIGHT_LINES)) {
+		return false;
+	}
+
+	camera_capture_window_x = x;
+	camera_capture_window_y = y;
+	camera_capture_window_width = width;
+	camera_capture_window_height = height;
+	return true;
+}
+
+/**
+ * @brief Sensor rectangle the CMW pipe downscales into the capture frame.
+ */
+static void CameraPlatform_GetSensorWindow(uint32_t *x, uint32_t *y,
+		uint32_t *width, uint32_t *height) {
+	if (camera_capture_window_width != 0U) {
+		*x = camera_capture_window_x;
+		*y = camera_capture_window_y;
+		*width = camera_capture_window_width;
+		*height = camera_capture_window_height;
+	} else {
+		const uint32_t sensor_square_side =
+				(IMX335_SENSOR_WIDTH_PIXELS < IMX335_SENSOR_HEIGHT_LINES) ?
+						IMX335_SENSOR_WIDTH_PIXELS : IMX335_SENSOR_HEIGHT_LINES;
+
+		*x = (IMX335_SENSOR_WIDTH_PIXELS - sensor_square_side) / 2U;
+		*y = (IMX335_SENSOR_HEIGHT_LINES - sensor_square_side) / 2U;
+		*width = sensor_square_side;
+		*height = sensor_square_side;
+	}
+}
+
+/**
+ * @brief Select the pixel layout of the next CMW snapshot.
+ *
+ * Applied by CameraPlatform_PrepareDcmippSnapshot(). Y8 keeps only the luma
+ * plane, halving the DMA write, the buffer copies and the SD archive.
+ */
+void CameraPlatform_SetCaptureFrameFormat(AppFrameFormat_t format) {
+	camera_capture_frame_format = format;
+}
+
+/**
+ * @brief Pixel layout the capture pipe is currently programmed for.
+ */
+AppFrameFormat_t CameraPlatform_GetCaptureFrameFormat(void) {
+	return camera_capture_frame_format;
+}
+
+/**
+ * @brief Bytes one snapshot writes into the capture buffer.
+ *
+ * The raw diagnostic path always fills the full buffer; the CMW path writes
+ * one frame of the selected layout.
+ */
+uint32_t CameraPlatform_GetCaptureFrameBytes(void) {
+	if (!camera_capture_use_cmw_pipeline) {
+		return CAMERA_CAPTURE_BUFFER_SIZE_BYTES;
+	}
+
+	return (uint32_t) AppFrameFormat_FrameBytes(camera_capture_frame_format,
+			CAMERA_CAPTURE_WIDTH_PIXELS, CAMERA_CAPTURE_HEIGHT_PIXELS);
+}
+
+/* The statistics engine invokes this once when a requested cycle lands; the
+ * gate polls ISP_SVC_Stats_GetLatest() instead, so there is nothing to do. */
+static ISP_StatusTypeDef CameraPlatform_IspLumaStatsReady(ISP_AlgoTypeDef *pAlgo) {
+	(void) pAlgo;
+	return ISP_OK;
+}
+
+/**
+ * @brief Point the DCMIPP luma statistics at the training crop of the next
+ *        snapshot.
+ *
+ * Maps the crop through the current sensor window onto the ISP statistics
+ * area and asks the statistics engine for the down-side average and bins,
+ * which it then gathers on every PIPE1 VSYNC. Statistics count for this
+ * snapshot only once a gather cycle starts CAMERA_CAPTURE_ISP_STATS_SETTLE_FRAMES
+ * after this call, past the latency of the stat area and of any exposure
+ * write made before arming.
+ * @retval true when the ISP accepted the statistics area and request.
+ */
+bool CameraPlatform_ArmIspLumaStats(void) {
+	uint32_t window_x = 0U;
+	uint32_t window_y = 0U;
+	uint32_t window_width = 0U;
+	uint32_t window_height = 0U;
+	ISP_StatAreaTypeDef stat_area = { 0 };
+	ISP_StatusTypeDef isp_status = ISP_OK;
+
+	camera_isp_stats_armed = false;
+	if (!camera_capture_use_cmw_pipeline || !camera_cmw_initialized) {
+		return false;
+	}
+
+	CameraPlatform_GetSensorWindow(&window_x, &window_y, &window_width,
+			&window_height);
+	{
+		const AppGaugeGeometry_Crop_t crop = AppGaugeGeometry_TrainingCrop(
+				(size_t) CAMERA_CAPTURE_WIDTH_PIXELS,
+				(size_t) CAMERA_CAPTURE_HEIGHT_PIXELS);
+
+		stat_area.X0 = window_x
+				+ (((uint32_t) crop.x_min * window_width)
+						/ CAMERA_CAPTURE_WIDTH_PIXELS);
+		stat_area.Y0 = window_y
+				+ (((uint32_t) crop.y_min * window_height)
+						/ CAMERA_CAPTURE_HEIGHT_PIXELS);
+		stat_area.XSize = ((uint32_t) crop.width * window_width)
+				/ CAMERA_CAPTURE_WIDTH_PIXELS;
+		stat_area.YSize = ((uint32_t) crop.height * window_height)
+				/ CAMERA_CAPTURE_HEIGHT_PIXELS;
+	}
+
+	isp_status = ISP_SetStatArea(&camera_sensor.hIsp, &stat_area);
+	if (isp_status == ISP_OK) {
+		isp_status = ISP_SVC_Stats_GetNext(&camera_sensor.hIsp,
+				&CameraPlatform_IspLumaStatsReady, NULL,
+				&camera_isp_stats_request, ISP_STAT_LOC_DOWN,
+				ISP_STAT_TYPE_AVG_AND_BINS, 0U);
+	}
+	if (isp_status != ISP_OK) {
+		DebugConsole_Printf(
+				"[CAMERA][STATS] ISP luma statistics unavailable, status=%ld; gate will sample the frame.\r\n",
+				(long) isp_status);
+		return false;
+	}
+
+	camera_isp_stats_valid_from_frame_id = ISP_GetMainFrameId(
+			&camera_sensor.hIsp) + CAMERA_CAPTURE_ISP_STATS_SETTLE_FRAMES;
+	camera_isp_stats_armed = true;
+	return true;
+}
+
+/**
+ * @brief Read the hardware luma summary of the armed snapshot's crop.
+ * @retval false when no gather cycle has completed since the snapshot was
+ *         armed and settled; the caller then samples the frame instead.
+ */
+bool CameraPlatform_GetIspLumaStats(uint8_t bright_level,
+		AppLumaStats_t *stats) {
+	TX_INTERRUPT_SAVE_AREA
+	ISP_SVC_StatStateTypeDef latest;
+
+	if (!camera_isp_stats_armed || (stats == NULL)) {
+		return false;
+	}
+
+	/* The VSYNC handler rewrites the latest statistics in place. */
+	TX_DISABLE
+	(void) ISP_SVC_Stats_GetLatest(&camera_sensor.hIsp, &latest);
+	TX_RESTORE
+
+	if ((latest.downFrameIdStart < camera_isp_stats_valid_from_frame_id)
+			|| (latest.downFrameIdEnd < latest.downFrameIdStart)) {
+		return false;
+	}
+
+	return AppLumaStats_FromIspBins(latest.down.histogram,
+			latest.down.averageL, bright_level, stats);
+}
+
 /**
  * @brief Seed IMX335 exposure and gain with a conservative starting point.
  *
@@ -551,6 +779,93 @@ static bool CameraPlatform_SelectImx335WhiteBalanceReference(
 	return true;
 }
 
+/**
+ * @brief Read the exposure/gain the IMX335 is currently programmed with.
+ * @retval true when both values were read.
+ */
+bool CameraPlatform_GetImx335ExposureGain(int32_t *exposure_us,
+		int32_t *gain_mdb) {
+	int32_t cmw_status = CMW_ERROR_NONE;
+
+	if ((exposure_us == NULL) || (gain_mdb == NULL)) {
+		return false;
+	}
+
+	cmw_status = CMW_CAMERA_GetExposure(exposure_us);
+	if (cmw_status == CMW_ERROR_NONE) {
+		cmw_status = CMW_CAMERA_GetGain(gain_mdb);
+	}
+	if (cmw_status != CMW_ERROR_NONE) {
+		DebugConsole_Printf(
+				"[CAMERA][CAPTURE] Failed to read current IMX335 exposure/gain, status=%ld.\r\n",
+				(long) cmw_status);
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Read the IMX335 exposure and gain limits from the middleware.
+ * @retval true when the sensor info was available.
+ */
+bool CameraPlatform_GetImx335ExposureLimits(uint32_t *exposure_min_us,
+		uint32_t *exposure_max_us, int32_t *gain_min_mdb, int32_t *gain_max_mdb) {
+	ISP_SensorInfoTypeDef sensor_info = { 0 };
+	int32_t cmw_status = CMW_ERROR_NONE;
+
+	if ((exposure_min_us == NULL) || (exposure_max_us == NULL)
+			|| (gain_min_mdb == NULL) || (gain_max_mdb == NULL)) {
+		return false;
+	}
+
+	cmw_status = CMW_CAMERA_GetSensorInfo(&sensor_info);
+	if (cmw_status != CMW_ERROR_NONE) {
+		DebugConsole_Printf(
+				"[CAMERA][CAPTURE] Failed to read IMX335 sensor info for exposure limits, status=%ld.\r\n",
+				(long) cmw_status);
+		return false;
+	}
+
+	*exposure_min_us = sensor_info.exposure_min;
+	*exposure_max_us = sensor_info.exposure_max;
+	*gain_min_mdb = sensor_info.gain_min;
+	*gain_max_mdb = sensor_info.gain_max;
+	return true;
+}
+
+/**
+ * @brief Program an absolute IMX335 exposure/gain pair.
+ *
+ * Like the nudge path, the new pair is cached so a DCMIPP transport retry
+ * resumes from it instead of the cold-start seed.
+ * @retval true when the middleware accepted both settings.
+ */
+bool CameraPlatform_SetImx335ExposureGain(int32_t exposure_us,
+		int32_t gain_mdb) {
+	int32_t cmw_status = CMW_ERROR_NONE;
+
+	cmw_status = CMW_CAMERA_SetExposure(exposure_us);
+	if (cmw_status != CMW_ERROR_NONE) {
+		DebugConsole_Printf(
+				"[CAMERA][CAPTURE] Failed to update IMX335 exposure to %ld us, status=%ld.\r\n",
+				(long) exposure_us, (long) cmw_status);
+		return false;
+	}
+
+	cmw_status = CMW_CAMERA_SetGain(gain_mdb);
+	if (cmw_status != CMW_ERROR_NONE) {
+		DebugConsole_Printf(
+				"[CAMERA][CAPTURE] Failed to update IMX335 gain to %ld mdB, status=%ld.\r\n",
+				(long) gain_mdb, (long) cmw_status);
+		return false;
+	}
+
+	camera_cached_exposure_us = exposure_us;
+	camera_cached_gain_mdb = gain_mdb;
+	return true;
+}
+
 /**
  * @brief Briefly enable ISP AEC to settle on the scene, then lock.
  *
@@ -683,39 +998,201 @@ void CameraPlatform_ReapplyImx335TestPattern(void) {
 #endif
 }
 
+/**
+ * @brief Route the ISP RGB output through the pipe's RGB->YUV matrix.
+ *
+ * CMW only programs the conversion for YUV422 packing; without it the MONO
+ * packer would store the green channel instead of luma. The coefficients
+ * match the ones CMW uses for YUV422 so Y8 luma equals the YUV422 Y plane.
+ */
+static bool CameraPlatform_EnableLumaConversion(
+		DCMIPP_HandleTypeDef *capture_dcmipp) {
+#define CAMERA_CAPTURE_N10(val) ((((uint32_t) (val)) ^ 0x7FFU) + 1U)
+	DCMIPP_ColorConversionConfTypeDef yuv_color_conf = {
+		.ClampOutputSamples = ENABLE,
+		.OutputSamplesType = 0,
+		.RR = 131, .RG = CAMERA_CAPTURE_N10(110), .RB = CAMERA_CAPTURE_N10(21),
+		.RA = 128,
+		.GR = 77, .GG = 150, .GB = 29, .GA = 0,
+		.BR = CAMERA_CAPTURE_N10(44), .BG = CAMERA_CAPTURE_N10(87), .BB = 131,
+		.BA = 128,
+	};
+#undef CAMERA_CAPTURE_N10
+
+	if (HAL_DCMIPP_PIPE_SetYUVConversionConfig(capture_dcmipp,
+	CAMERA_CAPTURE_PIPE, &yuv_color_conf) != HAL_OK) {
+		return false;
+	}
+
+	return HAL_DCMIPP_PIPE_EnableYUVConversion(capture_dcmipp,
+	CAMERA_CAPTURE_PIPE) == HAL_OK;
+}
+
+#if CAMERA_CAPTURE_ENABLE_NN_PIPE
+/**
+ * @brief Program the NN pipe to write the training crop as letterboxed RGB888.
+ *
+ * The crop is the training crop of the capture frame mapped through the
+ * sensor window, so it follows ROI mode like the ISP statistics area. The
+ * letterbox bars are cleared once per layout and never written by the pipe,
+ * so they quantize to the zero point like the CPU padding.
+ */
+static bool CameraPlatform_PrepareNnPipe(DCMIPP_HandleTypeDef *capture_dcmipp) {
+	const AppGaugeGeometry_Crop_t crop = AppGaugeGeometry_TrainingCrop(
+			(size_t) CAMERA_CAPTURE_WIDTH_PIXELS,
+			(size_t) CAMERA_CAPTURE_HEIGHT_PIXELS);
+	AppNnPipe_Request_t request = { 0 };
+	CMW_DCMIPP_Conf_t pipe_request = { 0 };
+	AppNnPipe_Status_t status = APP_NN_PIPE_OK;
+	uint32_t pitch_bytes = 0U;
+
+	CameraPlatform_GetSensorWindow(&request.window_x, &request.window_y,
+			&request.window_width, &request.window_height);
+	request.frame_width = CAMERA_CAPTURE_WIDTH_PIXELS;
+	request.frame_height = CAMERA_CAPTURE_HEIGHT_PIXELS;
+	request.crop_x = (uint32_t) crop.x_min;
+	request.crop_y = (uint32_t) crop.y_min;
+	request.crop_width = (uint32_t) crop.width;
+	request.crop_height = (uint32_t) crop.height;
+	request.model_width = CAMERA_NN_FRAME_WIDTH_PIXELS;
+	request.model_height = CAMERA_NN_FRAME_HEIGHT_PIXELS;
+	request.align_bytes = CAMERA_NN_PIPE_ALIGN_BYTES;
+
+	status = AppNnPipe_PlanLayout(&request, &camera_nn_pipe_layout);
+	if (status != APP_NN_PIPE_OK) {
+		DebugConsole_Printf(
+				"[CAMERA][NN] PIPE2 layout %s; inference keeps CPU preprocessing.\r\n",
+				AppNnPipe_StatusName(status));
+		camera_nn_pipe_disabled = true;
+		return false;
+	}
+
+	pipe_request.output_width = camera_nn_pipe_layout.output_width;
+	pipe_request.output_height = camera_nn_pipe_layout.output_height;
+	pipe_request.output_format = DCMIPP_PIXEL_PACKER_FORMAT_RGB888_YUV444_1;
+	pipe_request.output_bpp = APP_NN_PIPE_BYTES_PER_PIXEL;
+	pipe_request.enable_swap = 1;
+	pipe_request.enable_gamma_conversion = 0;
+	pipe_request.mode = CMW_Aspect_ratio_manual_roi;
+	pipe_request.manual_conf.offset_x = camera_nn_pipe_layout.roi_x;
+	pipe_request.manual_conf.offset_y = camera_nn_pipe_layout.roi_y;
+	pipe_request.manual_conf.width = camera_nn_pipe_layout.roi_width;
+	pipe_request.manual_conf.height = camera_nn_pipe_layout.roi_height;
+
+	if (CMW_CAMERA_SetPipeConfig(CAMERA_NN_PIPE, &pipe_request,
+			&pitch_bytes) != CMW_ERROR_NONE) {
+		DebugConsole_Printf(
+				"[CAMERA][NN] CMW_CAMERA_SetPipeConfig() failed for PIPE2; inference keeps CPU preprocessing.\r\n");
+		camera_nn_pipe_disabled = true;
+		return false;
+	}
+	/* Rows are model-wide so the image lands inside the letterbox. */
+	if ((pitch_bytes != camera_nn_pipe_layout.pitch_bytes)
+			&& (HAL_DCMIPP_PIPE_SetPitch(capture_dcmipp, CAMERA_NN_PIPE,
+					camera_nn_pipe_layout.pitch_bytes) != HAL_OK)) {
+		DebugConsole_Printf(
+				"[CAMERA][NN] Failed to set the PIPE2 pitch to %lu bytes; inference keeps CPU preprocessing.\r\n",
+				(unsigned long) camera_nn_pipe_layout.pitch_bytes);
+		camera_nn_pipe_disabled = true;
+		return false;
+	}
+
+	if (camera_nn_pipe_cleared_offset
+			!= camera_nn_pipe_layout.write_offset_bytes) {
+		(void) memset(camera_nn_capture_buffer, 0,
+				sizeof(camera_nn_capture_buffer));
+		camera_nn_pipe_cleared_offset = camera_nn_pipe_layout.write_offset_bytes;
+	}
+	return true;
+}
+
+/**
+ * @brief Arm the prepared NN pipe for the same snapshot as the main pipe.
+ */
+static void CameraPlatform_StartNnPipe(void) {
+	int32_t cmw_status = CMW_ERROR_NONE;
+
+	camera_nn_pipe_armed = false;
+	if (!camera_nn_pipe_prepared) {
+		return;
+	}
+	cmw_status = CMW_CAMERA_Start(CAMERA_NN_PIPE,
+			&camera_nn_capture_buffer[camera_nn_pipe_layout.write_offset_bytes],
+			CMW_MODE_SNAPSHOT);
+	if (cmw_status != CMW_ERROR_NONE) {
+		DebugConsole_Printf(
+				"[CAMERA][NN] CMW_CAMERA_Start() failed for PIPE2, status=%ld; inference keeps CPU preprocessing.\r\n",
+				(long) cmw_status);
+		camera_nn_pipe_disabled = true;
+		return;
+	}
+	camera_nn_pipe_armed = true;
+}
+#endif
+
+/**
+ * @brief True while the NN pipe is armed for the current snapshot.
+ */
+bool CameraPlatform_IsNnPipeArmed(void) {
+	return camera_nn_pipe_armed;
+}
+
+/**
+ * @brief Layout the NN pipe was last armed with.
+ */
+const AppNnPipe_Layout_t *CameraPlatform_GetNnPipeLayout(void) {
+	return &camera_nn_pipe_layout;
+}
+
+/**
+ * @brief Stop the NN pipe if it is armed; the main pipe is stopped separately.
+ */
+void CameraPlatform_StopNnPipe(void) {
+	DCMIPP_HandleTypeDef *capture_dcmipp =
+			CameraPlatform_GetCaptureDcmippHandle();
+
+	if (!camera_nn_pipe_armed) {
+		return;
+	}
+	camera_nn_pipe_armed = false;
+	if ((capture_dcmipp != NULL) && (capture_dcmipp->Instance != NULL)) {
+		(void) HAL_DCMIPP_CSI_PIPE_Stop(capture_dcmipp, CAMERA_NN_PIPE,
+		DCMIPP_VIRTUAL_CHANNEL0);
+	}
+}
+
 /**
  * @brief Configure the capture pipe using ST's camera middleware crop/downsize helpers.
- * @retval true when the output path is ready for a 224x224 YUV422 frame.
+ * @retval true when the output path is ready for a 224x224 YUV422 or Y8
+ *         frame.
  */
 bool CameraPlatform_PrepareDcmippSnapshot(void) {
 	DCMIPP_HandleTypeDef *capture_dcmipp =
 			CameraPlatform_GetCaptureDcmippHandle();
 
+	camera_nn_pipe_prepared = false;
 	if (camera_capture_use_cmw_pipeline && camera_cmw_initialized) {
 		CMW_DCMIPP_Conf_t pipe_request = { 0 };
 		uint32_t pitch_bytes = 0U;
 
 		pipe_request.output_width = CAMERA_CAPTURE_WIDTH_PIXELS;
 		pipe_request.output_height = CAMERA_CAPTURE_HEIGHT_PIXELS;
-		pipe_request.output_format =
-		DCMIPP_PIXEL_PACKER_FORMAT_YUV422_1;
-		pipe_request.output_bpp = CAMERA_CAPTURE_BYTES_PER_PIXEL;
+		if (camera_capture_frame_format == APP_FRAME_FORMAT_Y8) {
+			pipe_request.output_format =
+			DCMIPP_PIXEL_PACKER_FORMAT_MONO_Y8_G8_1;
+		} else {
+			pipe_request.output_format =
+			DCMIPP_PIXEL_PACKER_FORMAT_YUV422_1;
+		}
+		pipe_request.output_bpp = AppFrameFormat_BytesPerPixel(
+				camera_capture_frame_format);
 		pipe_request.enable_swap = 0;
 		pipe_request.enable_gamma_conversion = 0;
 		pipe_request.mode = CMW_Aspect_ratio_manual_roi;
-		{
-			const uint32_t sensor_square_side =
-					(IMX335_SENSOR_WIDTH_PIXELS < IMX335_SENSOR_HEIGHT_LINES) ?
-							IMX335_SENSOR_WIDTH_PIXELS :
-							IMX335_SENSOR_HEIGHT_LINES;
-
-			pipe_request.manual_conf.width = sensor_square_side;
-			pipe_request.manual_conf.height = sensor_square_side;
-			pipe_request.manual_conf.offset_x =
-					(IMX335_SENSOR_WIDTH_PIXELS - sensor_square_side) / 2U;
-			pipe_request.manual_conf.offset_y =
-					(IMX335_SENSOR_HEIGHT_LINES - sensor_square_side) / 2U;
-		}
+		CameraPlatform_GetSensorWindow(&pipe_request.manual_conf.offset_x,
+				&pipe_request.manual_conf.offset_y,
+				&pipe_request.manual_conf.width,
+				&pipe_request.manual_conf.height);
 
 		if (CMW_CAMERA_SetPipeConfig(CAMERA_CAPTURE_PIPE, &pipe_request,
 				&pitch_bytes) != CMW_ERROR_NONE) {
@@ -724,6 +1201,20 @@ bool CameraPlatform_PrepareDcmippSnapshot(void) {
 			return false;
 		}
 
+		if ((camera_capture_frame_format == APP_FRAME_FORMAT_Y8)
+				&& !CameraPlatform_EnableLumaConversion(capture_dcmipp)) {
+			DebugConsole_Printf(
+					"[CAMERA][CAPTURE] Failed to enable PIPE1 luma conversion for Y8.\r\n");
+			return false;
+		}
+
+#if CAMERA_CAPTURE_ENABLE_NN_PIPE
+		/* A Y8 capture feeds grey to the models; the NN pipe would not. */
+		camera_nn_pipe_prepared = (camera_capture_frame_format
+				== APP_FRAME_FORMAT_YUV422) && !camera_nn_pipe_disabled
+				&& !AppCameraBuffers_IsNnFrameHeld()
+				&& CameraPlatform_PrepareNnPipe(capture_dcmipp);
+#endif
 		return true;
 	}
 
@@ -946,6 +1437,9 @@ bool CameraPlatform_StartDcmippSnapshot(void) {
 					(long) cmw_status);
 			return false;
 		}
+#if CAMERA_CAPTURE_ENABLE_NN_PIPE
+		CameraPlatform_StartNnPipe();
+#endif
 
 		/* Do not mark the sensor stream as running yet.  The capture path still
 		 * needs to call CameraPlatform_StartImx335Stream() so the IMX335 actually
@@ -1045,3 +1539,57 @@ bool CameraPlatform_StopImx335Stream(void) {
 	camera_stream_started = false;
 	return true;
 }
+
+/**
+ * @brief Power the IMX335 down for a long idle gap (XCLR low, module off).
+ *
+ * Goes through CMW_CAMERA_DeInit() so the ISP, sensor driver and DCMIPP are
+ * released the way ST's middleware expects before the next CMW_CAMERA_Init().
+ * @retval true when the sensor is off or was never initialized.
+ */
+bool CameraPlatform_PowerOffImx335(void) {
+	int32_t cmw_status = CMW_ERROR_NONE;
+
+	if (!camera_cmw_initialized) {
+		return true;
+	}
+
+	(void) CameraPlatform_StopImx335Stream();
+	cmw_status = CMW_CAMERA_DeInit();
+	if (cmw_status != CMW_ERROR_NONE) {
+		DebugConsole_Printf(
+				"[CAMERA][POWER] CMW_CAMERA_DeInit() failed, status=%ld.\r\n",
+				(long) cmw_status);
+		return false;
+	}
+
+	camera_cmw_initialized = false;
+	camera_stream_started = false;
+	return true;
+}
+
+/**
+ * @brief Bring the IMX335 back from power-off ready for the next snapshot.
+ *
+ * Replays the same init the boot probe runs (driver register table, test
+ * pattern, cached exposure/gain seed) and then locks exposure as the boot
+ * sensor-config step does. Capture window and pixel format live in this
+ * module and are applied again by the next PrepareDcmippSnapshot().
+ * @retval true when the sensor is initialized.
+ */
+bool CameraPlatform_PowerOnImx335(void) {
+	if (camera_cmw_initialized) {
+		return true;
+	}
+
+	if (!CameraPlatform_InitializeImx335Sensor()) {
+		DebugConsole_Printf(
+				"[CAMERA][POWER] IMX335 re-initialization after power-off failed.\r\n");
+		return false;
+	}
+	if (!CameraPlatform_DisableImx335AutoExposure()) {
+		DebugConsole_Printf(
+				"[CAMERA][POWER] Warning: failed to lock IMX335 exposure after power-on.\r\n");
+	}
+	return true;
+}
@@ -0,0 +1,227 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_capture_events.c
+ * @brief   Snapshot completion state machine fed by DCMIPP/CSI interrupts.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#include "app_capture_events.h"
+
+#include <stddef.h>
+
+/**
+ * @brief Reset the per-capture record and start waiting.
+ */
+void AppCaptureEvents_Arm(AppCaptureEvents_Context_t *context_ptr,
+		uint32_t now_us, uint32_t timeout_us, bool wait_for_boundary) {
+	if (context_ptr == NULL) {
+		return;
+	}
+
+	context_ptr->state = APP_CAPTURE_EVENTS_ARMED;
+	context_ptr->wait_for_boundary = wait_for_boundary;
+	context_ptr->sof_seen = false;
+	context_ptr->eof_seen = false;
+	context_ptr->arm_us = now_us;
+	context_ptr->timeout_us = timeout_us;
+	context_ptr->sof_us = now_us;
+	context_ptr->eof_us = now_us;
+	context_ptr->error_code = 0U;
+	context_ptr->dropped_frames = 0U;
+	context_ptr->rewaits = 0U;
+}
+
+/**
+ * @brief Advance on one interrupt event.
+ *
+ * A second boundary inside the same frame (CSI SOF right after the pipe
+ * VSYNC) is ignored; a boundary after an end of frame starts the next one.
+ */
+AppCaptureEvents_State_t AppCaptureEvents_Post(
+		AppCaptureEvents_Context_t *context_ptr, AppCaptureEvents_Event_t event,
+		uint32_t now_us, uint32_t error_code) {
+	AppCaptureEvents_Context_t *const c = context_ptr;
+
+	if (c == NULL) {
+		return APP_CAPTURE_EVENTS_IDLE;
+	}
+
+	if ((c->state != APP_CAPTURE_EVENTS_ARMED)
+			&& (c->state != APP_CAPTURE_EVENTS_IN_FRAME)) {
+		/* A late transport error still spoils a frame nobody took yet. */
+		if ((c->state == APP_CAPTURE_EVENTS_READY)
+				&& (event == APP_CAPTURE_EVENT_ERROR)) {
+			c->state = APP_CAPTURE_EVENTS_FAILED;
+			c->error_code = error_code;
+		}
+		return c->state;
+	}
+
+	switch (event) {
+	case APP_CAPTURE_EVENT_VSYNC:
+	case APP_CAPTURE_EVENT_SOF:
+		if ((c->state == APP_CAPTURE_EVENTS_ARMED) || c->eof_seen) {
+			c->state = APP_CAPTURE_EVENTS_IN_FRAME;
+			c->sof_seen = true;
+			c->eof_seen = false;
+			c->sof_us = now_us;
+		}
+		break;
+	case APP_CAPTURE_EVENT_EOF:
+		/* While still armed this is the tail of a frame that began before
+		 * the arm. */
+		if ((c->state == APP_CAPTURE_EVENTS_IN_FRAME) && !c->eof_seen) {
+			c->eof_seen = true;
+			c->eof_us = now_us;
+		}
+		break;
+	case APP_CAPTURE_EVENT_FRAME:
+		if ((c->state == APP_CAPTURE_EVENTS_ARMED) && c->wait_for_boundary) {
+			c->dropped_frames++;
+			break;
+		}
+		if (!c->eof_seen) {
+			c->eof_seen = true;
+			c->eof_us = now_us;
+		}
+		c->state = APP_CAPTURE_EVENTS_READY;
+		break;
+	case APP_CAPTURE_EVENT_ERROR:
+	default:
+		c->state = APP_CAPTURE_EVENTS_FAILED;
+		c->error_code = error_code;
+		break;
+	}
+	return c->state;
+}
+
+/**
+ * @brief Report the state, timing out a capture still in flight.
+ */
+AppCaptureEvents_State_t AppCaptureEvents_Check(
+		AppCaptureEvents_Context_t *context_ptr, uint32_t now_us) {
+	if (context_ptr == NULL) {
+		return APP_CAPTURE_EVENTS_IDLE;
+	}
+
+	if (((context_ptr->state == APP_CAPTURE_EVENTS_ARMED)
+			|| (context_ptr->state == APP_CAPTURE_EVENTS_IN_FRAME))
+			&& ((uint32_t) (now_us - context_ptr->arm_us)
+					>= context_ptr->timeout_us)) {
+		context_ptr->state = APP_CAPTURE_EVENTS_TIMED_OUT;
+	}
+	return context_ptr->state;
+}
+
+/**
+ * @brief Time left before the capture times out.
+ */
+uint32_t AppCaptureEvents_RemainingUs(
+		const AppCaptureEvents_Context_t *context_ptr, uint32_t now_us) {
+	uint32_t elapsed_us = 0U;
+
+	if (context_ptr == NULL) {
+		return 0U;
+	}
+
+	elapsed_us = now_us - context_ptr->arm_us;
+	return (elapsed_us < context_ptr->timeout_us) ?
+			(context_ptr->timeout_us - elapsed_us) : 0U;
+}
+
+/**
+ * @brief Go back to waiting for the next whole frame.
+ */
+bool AppCaptureEvents_Rewait(AppCaptureEvents_Context_t *context_ptr) {
+	if ((context_ptr == NULL)
+			|| (context_ptr->state != APP_CAPTURE_EVENTS_READY)) {
+		return false;
+	}
+
+	context_ptr->state = APP_CAPTURE_EVENTS_ARMED;
+	context_ptr->wait_for_boundary = true;
+	context_ptr->sof_seen = false;
+	context_ptr->eof_seen = false;
+	context_ptr->rewaits++;
+	return true;
+}
+
+/**
+ * @brief Take the ready frame; arm_to_ready also covers rewaited frames.
+ */
+bool AppCaptureEvents_Accept(AppCaptureEvents_Context_t *context_ptr,
+		uint32_t now_us, AppCaptureEvents_Timing_t *timing_out) {
+	AppCaptureEvents_Context_t *const c = context_ptr;
+	uint32_t frame_start_us = 0U;
+
+	if ((c == NULL) || (c->state != APP_CAPTURE_EVENTS_READY)) {
+		return false;
+	}
+
+	c->state = APP_CAPTURE_EVENTS_IDLE;
+	if (timing_out != NULL) {
+		frame_start_us = c->sof_seen ? c->sof_us : c->arm_us;
+		timing_out->arm_to_sof_us = c->sof_seen ? (c->sof_us - c->arm_us) : 0U;
+		timing_out->sof_to_eof_us = c->eof_us - frame_start_us;
+		timing_out->eof_to_ready_us = now_us - c->eof_us;
+		timing_out->arm_to_ready_us = now_us - c->arm_us;
+		timing_out->dropped_frames = c->dropped_frames;
+		timing_out->rewaits = c->rewaits;
+	}
+	return true;
+}
+
+/**
+ * @brief Event bit, plus READY or FAILED when this event decided the frame.
+ */
+uint32_t AppCaptureEvents_FlagsFor(AppCaptureEvents_Event_t event,
+		AppCaptureEvents_State_t state) {
+	uint32_t flags = 0U;
+
+	switch (event) {
+	case APP_CAPTURE_EVENT_VSYNC:
+		flags = APP_CAPTURE_EVENTS_FLAG_VSYNC;
+		break;
+	case APP_CAPTURE_EVENT_SOF:
+		flags = APP_CAPTURE_EVENTS_FLAG_SOF;
+		break;
+	case APP_CAPTURE_EVENT_EOF:
+		flags = APP_CAPTURE_EVENTS_FLAG_EOF;
+		break;
+	case APP_CAPTURE_EVENT_FRAME:
+		flags = APP_CAPTURE_EVENTS_FLAG_FRAME;
+		if (state == APP_CAPTURE_EVENTS_READY) {
+			flags |= APP_CAPTURE_EVENTS_FLAG_READY;
+		}
+		break;
+	case APP_CAPTURE_EVENT_ERROR:
+	default:
+		flags = APP_CAPTURE_EVENTS_FLAG_ERROR;
+		if (state == APP_CAPTURE_EVENTS_FAILED) {
+			flags |= APP_CAPTURE_EVENTS_FLAG_FAILED;
+		}
+		break;
+	}
+	return flags;
+}
+
+const char *AppCaptureEvents_StateName(AppCaptureEvents_State_t state) {
+	switch (state) {
+	case APP_CAPTURE_EVENTS_IDLE:
+		return "idle";
+	case APP_CAPTURE_EVENTS_ARMED:
+		return "armed";
+	case APP_CAPTURE_EVENTS_IN_FRAME:
+		return "in-frame";
+	case APP_CAPTURE_EVENTS_READY:
+		return "ready";
+	case APP_CAPTURE_EVENTS_FAILED:
+		return "failed";
+	case APP_CAPTURE_EVENTS_TIMED_OUT:
+		return "timed-out";
+	default:
+		return "unknown";
+	}
+}
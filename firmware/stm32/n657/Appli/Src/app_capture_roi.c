@@ -0,0 +1,212 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_capture_roi.c
+ * @brief   Sensor capture window that tracks the last accepted gauge box.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#include "app_capture_roi.h"
+
+#include <stddef.h>
+
+/**
+ * @brief Round down to the DCMIPP crop alignment.
+ */
+static uint32_t AppCaptureRoi_AlignDown(uint32_t value) {
+	return value - (value % APP_CAPTURE_ROI_ALIGN_PIXELS);
+}
+
+/**
+ * @brief Output height over width; the window keeps this aspect so the
+ *        downscaler does not stretch the dial.
+ */
+static float AppCaptureRoi_Aspect(const AppCaptureRoi_Config_t *config_ptr) {
+	return (float) config_ptr->output_height / (float) config_ptr->output_width;
+}
+
+/**
+ * @brief Widest window with the output aspect that fits on the sensor.
+ */
+static uint32_t AppCaptureRoi_MaxWidth(const AppCaptureRoi_Config_t *config_ptr) {
+	const float height_limited = (float) config_ptr->sensor_height
+			/ AppCaptureRoi_Aspect(config_ptr);
+	float width = (float) config_ptr->sensor_width;
+
+	if (height_limited < width) {
+		width = height_limited;
+	}
+	return AppCaptureRoi_AlignDown((uint32_t) width);
+}
+
+/**
+ * @brief Fill in the height for @p width and place the window so that the
+ *        sensor point (anchor_x, anchor_y) lands at the normalised output
+ *        position (target_x, target_y), clamped to the sensor.
+ */
+static void AppCaptureRoi_Place(const AppCaptureRoi_Config_t *config_ptr,
+		uint32_t width, float anchor_x, float anchor_y, float target_x,
+		float target_y, AppCaptureRoi_Window_t *window_out) {
+	uint32_t height = 0U;
+	float x = 0.0f;
+	float y = 0.0f;
+
+	height = AppCaptureRoi_AlignDown(
+			(uint32_t) (((float) width * AppCaptureRoi_Aspect(config_ptr))
+					+ 0.5f));
+	if (height > config_ptr->sensor_height) {
+		height = AppCaptureRoi_AlignDown(config_ptr->sensor_height);
+	}
+
+	x = anchor_x - (target_x * (float) width);
+	y = anchor_y - (target_y * (float) height);
+	if (x > (float) (config_ptr->sensor_width - width)) {
+		x = (float) (config_ptr->sensor_width - width);
+	}
+	if (y > (float) (config_ptr->sensor_height - height)) {
+		y = (float) (config_ptr->sensor_height - height);
+	}
+	if (x < 0.0f) {
+		x = 0.0f;
+	}
+	if (y < 0.0f) {
+		y = 0.0f;
+	}
+
+	window_out->x = AppCaptureRoi_AlignDown((uint32_t) (x + 0.5f));
+	window_out->y = AppCaptureRoi_AlignDown((uint32_t) (y + 0.5f));
+	window_out->width = width;
+	window_out->height = height;
+}
+
+/**
+ * @brief The largest centred window with the output aspect ratio.
+ */
+void AppCaptureRoi_DefaultWindow(const AppCaptureRoi_Config_t *config_ptr,
+		AppCaptureRoi_Window_t *window_out) {
+	if ((config_ptr == NULL) || (window_out == NULL)
+			|| (config_ptr->output_width == 0U)) {
+		return;
+	}
+
+	AppCaptureRoi_Place(config_ptr, AppCaptureRoi_MaxWidth(config_ptr),
+			(float) config_ptr->sensor_width * 0.5f,
+			(float) config_ptr->sensor_height * 0.5f, 0.5f, 0.5f, window_out);
+}
+
+/**
+ * @brief Map a normalised output-frame point back to sensor pixels.
+ */
+void AppCaptureRoi_FrameToSensor(const AppCaptureRoi_Window_t *window_ptr,
+		float frame_x, float frame_y, float *sensor_x_out, float *sensor_y_out) {
+	if ((window_ptr == NULL) || (sensor_x_out == NULL)
+			|| (sensor_y_out == NULL)) {
+		return;
+	}
+
+	*sensor_x_out = (float) window_ptr->x + (frame_x * (float) window_ptr->width);
+	*sensor_y_out = (float) window_ptr->y
+			+ (frame_y * (float) window_ptr->height);
+}
+
+/**
+ * @brief Compute the window that puts the box on the target rectangle.
+ */
+bool AppCaptureRoi_WindowFromBox(const AppCaptureRoi_Config_t *config_ptr,
+		const AppCaptureRoi_Window_t *frame_window_ptr,
+		const AppCaptureRoi_Box_t *box_ptr, AppCaptureRoi_Window_t *window_out) {
+	float margin_scale = 0.0f;
+	float target_width = 0.0f;
+	float target_height = 0.0f;
+	float box_center_x = 0.0f;
+	float box_center_y = 0.0f;
+	float box_width = 0.0f;
+	float box_height = 0.0f;
+	float width = 0.0f;
+	uint32_t max_width = 0U;
+	uint32_t window_width = 0U;
+
+	if ((config_ptr == NULL) || (frame_window_ptr == NULL) || (box_ptr == NULL)
+			|| (window_out == NULL) || (config_ptr->output_width == 0U)
+			|| (frame_window_ptr->width == 0U)
+			|| (frame_window_ptr->height == 0U)) {
+		return false;
+	}
+
+	margin_scale = 1.0f
+			+ ((2.0f * (float) config_ptr->margin_percent) / 100.0f);
+	target_width = config_ptr->target_x_max - config_ptr->target_x_min;
+	target_height = config_ptr->target_y_max - config_ptr->target_y_min;
+	if ((target_width <= 0.0f) || (target_height <= 0.0f)
+			|| (box_ptr->width <= 0.0f) || (box_ptr->height <= 0.0f)
+			|| (box_ptr->center_x < 0.0f) || (box_ptr->center_x > 1.0f)
+			|| (box_ptr->center_y < 0.0f) || (box_ptr->center_y > 1.0f)) {
+		return false;
+	}
+
+	AppCaptureRoi_FrameToSensor(frame_window_ptr, box_ptr->center_x,
+			box_ptr->center_y, &box_center_x, &box_center_y);
+	box_width = box_ptr->width * (float) frame_window_ptr->width * margin_scale;
+	box_height = box_ptr->height * (float) frame_window_ptr->height
+			* margin_scale;
+
+	/* Scale so the padded box fits the target in both directions; the looser
+	 * axis keeps some extra context rather than stretching. */
+	width = box_width / target_width;
+	if ((box_height / (target_height * AppCaptureRoi_Aspect(config_ptr)))
+			> width) {
+		width = box_height / (target_height * AppCaptureRoi_Aspect(config_ptr));
+	}
+
+	max_width = AppCaptureRoi_MaxWidth(config_ptr);
+	if (width > (float) max_width) {
+		window_width = max_width;
+	} else if (width < (float) config_ptr->min_window_width) {
+		window_width = config_ptr->min_window_width;
+	} else {
+		window_width = (uint32_t) (width + 0.5f);
+	}
+	if (window_width < config_ptr->output_width) {
+		window_width = config_ptr->output_width;
+	}
+	if (window_width > max_width) {
+		window_width = max_width;
+	}
+	window_width = AppCaptureRoi_AlignDown(window_width);
+
+	AppCaptureRoi_Place(config_ptr, window_width, box_center_x, box_center_y,
+			(config_ptr->target_x_min + config_ptr->target_x_max) * 0.5f,
+			(config_ptr->target_y_min + config_ptr->target_y_max) * 0.5f,
+			window_out);
+	return true;
+}
+
+/**
+ * @brief Check whether a new window is worth reprogramming the pipe for.
+ */
+bool AppCaptureRoi_ShouldMove(const AppCaptureRoi_Config_t *config_ptr,
+		const AppCaptureRoi_Window_t *current_ptr,
+		const AppCaptureRoi_Window_t *next_ptr) {
+	uint32_t tolerance = 0U;
+	uint32_t delta_x = 0U;
+	uint32_t delta_y = 0U;
+	uint32_t delta_width = 0U;
+
+	if ((config_ptr == NULL) || (current_ptr == NULL) || (next_ptr == NULL)) {
+		return false;
+	}
+
+	tolerance = (current_ptr->width * config_ptr->move_tolerance_percent)
+			/ 100U;
+	delta_x = (next_ptr->x > current_ptr->x) ?
+			(next_ptr->x - current_ptr->x) : (current_ptr->x - next_ptr->x);
+	delta_y = (next_ptr->y > current_ptr->y) ?
+			(next_ptr->y - current_ptr->y) : (current_ptr->y - next_ptr->y);
+	delta_width = (next_ptr->width > current_ptr->width) ?
+			(next_ptr->width - current_ptr->width) :
+			(current_ptr->width - next_ptr->width);
+
+	return (delta_x > tolerance) || (delta_y > tolerance)
+			|| (delta_width > tolerance);
+}
@@ -0,0 +1,265 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_capture_schedule.c
+ * @brief   Adaptive capture period driven by recent gauge readings.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#include "app_capture_schedule.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * @brief Return the sample recorded @p age captures ago (0 = newest).
+ */
+static const AppCaptureSchedule_Sample_t *AppCaptureSchedule_GetSample(
+		const AppCaptureSchedule_Context_t *context_ptr, uint32_t age) {
+	uint32_t index = 0U;
+
+	if (age >= context_ptr->history_count) {
+		return NULL;
+	}
+
+	index = (context_ptr->history_next_index + APP_CAPTURE_SCHEDULE_HISTORY_SIZE
+			- 1U - age) % APP_CAPTURE_SCHEDULE_HISTORY_SIZE;
+	return &context_ptr->history[index];
+}
+
+/**
+ * @brief Absolute rate of change between two samples, in units per minute.
+ */
+static float AppCaptureSchedule_RatePerMinute(
+		const AppCaptureSchedule_Sample_t *newer_ptr,
+		const AppCaptureSchedule_Sample_t *older_ptr) {
+	const uint32_t span_ms = newer_ptr->time_ms - older_ptr->time_ms;
+	float delta = newer_ptr->value - older_ptr->value;
+
+	if (span_ms == 0U) {
+		return 0.0f;
+	}
+	if (delta < 0.0f) {
+		delta = -delta;
+	}
+
+	return (delta * 60000.0f) / (float) span_ms;
+}
+
+/**
+ * @brief Check whether a reading sits within the alarm margin of a threshold.
+ */
+static bool AppCaptureSchedule_NearAlarm(
+		const AppCaptureSchedule_Config_t *config_ptr, float value) {
+	if (!config_ptr->alarm_enabled) {
+		return false;
+	}
+
+	return (value <= (config_ptr->alarm_low + config_ptr->alarm_margin))
+			|| (value >= (config_ptr->alarm_high - config_ptr->alarm_margin));
+}
+
+/**
+ * @brief Reset the schedule state.
+ */
+void AppCaptureSchedule_Init(AppCaptureSchedule_Context_t *context_ptr,
+		const AppCaptureSchedule_Config_t *config_ptr, uint32_t now_ms) {
+	if ((context_ptr == NULL) || (config_ptr == NULL)) {
+		return;
+	}
+
+	(void) memset(context_ptr, 0, sizeof(*context_ptr));
+	context_ptr->config = *config_ptr;
+	if (context_ptr->config.min_period_ms == 0U) {
+		context_ptr->config.min_period_ms = 1U;
+	}
+	if (context_ptr->config.max_period_ms < context_ptr->config.min_period_ms) {
+		context_ptr->config.max_period_ms = context_ptr->config.min_period_ms;
+	}
+	if (context_ptr->config.base_period_ms < context_ptr->config.min_period_ms) {
+		context_ptr->config.base_period_ms = context_ptr->config.min_period_ms;
+	}
+	if (context_ptr->config.base_period_ms > context_ptr->config.max_period_ms) {
+		context_ptr->config.base_period_ms = context_ptr->config.max_period_ms;
+	}
+
+	context_ptr->period_ms = context_ptr->config.base_period_ms;
+	context_ptr->day_start_ms = now_ms;
+	context_ptr->last_reason = APP_CAPTURE_SCHEDULE_REASON_BASE;
+}
+
+/**
+ * @brief Re-anchor the budget window on the RTC midnight.
+ */
+void AppCaptureSchedule_SyncWallClock(AppCaptureSchedule_Context_t *context_ptr,
+		uint32_t now_ms, uint32_t date_code, uint32_t minute_of_day) {
+	if ((context_ptr == NULL) || (date_code == 0U) || (minute_of_day >= 1440U)) {
+		return;
+	}
+
+	/* An unknown date means the window was boot-relative or just rolled
+	 * over on the tick, so its count already belongs to this day. */
+	if ((context_ptr->day_date_code != 0U)
+			&& (context_ptr->day_date_code != date_code)) {
+		context_ptr->day_capture_count = 0U;
+	}
+	context_ptr->day_date_code = date_code;
+	context_ptr->day_start_ms = now_ms - (minute_of_day * 60000U);
+}
+
+/**
+ * @brief Account one capture and the reading it produced, if any.
+ */
+void AppCaptureSchedule_RecordCapture(AppCaptureSchedule_Context_t *context_ptr,
+		uint32_t now_ms, bool reading_valid, float value) {
+	if (context_ptr == NULL) {
+		return;
+	}
+
+	while ((uint32_t) (now_ms - context_ptr->day_start_ms)
+			>= APP_CAPTURE_SCHEDULE_DAY_MS) {
+		context_ptr->day_start_ms += APP_CAPTURE_SCHEDULE_DAY_MS;
+		context_ptr->day_date_code = 0U;
+		context_ptr->day_capture_count = 0U;
+	}
+	context_ptr->day_capture_count++;
+
+	context_ptr->last_reading_valid = reading_valid;
+	if (!reading_valid) {
+		return;
+	}
+
+	context_ptr->history[context_ptr->history_next_index].time_ms = now_ms;
+	context_ptr->history[context_ptr->history_next_index].value = value;
+	context_ptr->history_next_index = (context_ptr->history_next_index + 1U)
+			% APP_CAPTURE_SCHEDULE_HISTORY_SIZE;
+	if (context_ptr->history_count < APP_CAPTURE_SCHEDULE_HISTORY_SIZE) {
+		context_ptr->history_count++;
+	}
+}
+
+/**
+ * @brief Compute the delay until the next capture.
+ */
+uint32_t AppCaptureSchedule_NextPeriodMs(
+		AppCaptureSchedule_Context_t *context_ptr, uint32_t now_ms) {
+	const AppCaptureSchedule_Config_t *config_ptr = NULL;
+	const AppCaptureSchedule_Sample_t *newest_ptr = NULL;
+	const AppCaptureSchedule_Sample_t *previous_ptr = NULL;
+	const AppCaptureSchedule_Sample_t *oldest_ptr = NULL;
+	uint32_t period_ms = 0U;
+	float rate_per_min = 0.0f;
+
+	if (context_ptr == NULL) {
+		return 0U;
+	}
+
+	config_ptr = &context_ptr->config;
+	period_ms = context_ptr->period_ms;
+	newest_ptr = AppCaptureSchedule_GetSample(context_ptr, 0U);
+	previous_ptr = AppCaptureSchedule_GetSample(context_ptr, 1U);
+	oldest_ptr = AppCaptureSchedule_GetSample(context_ptr,
+			context_ptr->history_count - 1U);
+
+	if (!context_ptr->last_reading_valid || (previous_ptr == NULL)) {
+		/* Without a fresh reading we cannot tell a flat gauge from a moving
+		 * one, so never stretch past the base period while blind. */
+		if (period_ms > config_ptr->base_period_ms) {
+			period_ms = config_ptr->base_period_ms;
+		}
+		context_ptr->last_reason = APP_CAPTURE_SCHEDULE_REASON_BASE;
+	} else {
+		/* The newest step catches a sudden excursion; the full window catches
+		 * a slow drift that each single step would hide. */
+		const float step_rate = AppCaptureSchedule_RatePerMinute(newest_ptr,
+				previous_ptr);
+		const float span_rate = AppCaptureSchedule_RatePerMinute(newest_ptr,
+				oldest_ptr);
+
+		rate_per_min = (step_rate > span_rate) ? step_rate : span_rate;
+
+		if (AppCaptureSchedule_NearAlarm(config_ptr, newest_ptr->value)) {
+			period_ms /= 2U;
+			context_ptr->last_reason = APP_CAPTURE_SCHEDULE_REASON_ALARM;
+		} else if (rate_per_min >= config_ptr->fast_rate_per_min) {
+			period_ms /= 2U;
+			context_ptr->last_reason = APP_CAPTURE_SCHEDULE_REASON_CHANGING;
+		} else if ((rate_per_min <= config_ptr->stable_rate_per_min)
+				&& (context_ptr->history_count
+						>= (APP_CAPTURE_SCHEDULE_HISTORY_SIZE / 2U))) {
+			period_ms += period_ms / 2U;
+			context_ptr->last_reason = APP_CAPTURE_SCHEDULE_REASON_STABLE;
+		} else {
+			if (period_ms < config_ptr->base_period_ms) {
+				period_ms *= 2U;
+				if (period_ms > config_ptr->base_period_ms) {
+					period_ms = config_ptr->base_period_ms;
+				}
+			} else if (period_ms > config_ptr->base_period_ms) {
+				period_ms /= 2U;
+				if (period_ms < config_ptr->base_period_ms) {
+					period_ms = config_ptr->base_period_ms;
+				}
+			}
+			context_ptr->last_reason = APP_CAPTURE_SCHEDULE_REASON_BASE;
+		}
+	}
+
+	if (period_ms < config_ptr->min_period_ms) {
+		period_ms = config_ptr->min_period_ms;
+	}
+	if (period_ms > config_ptr->max_period_ms) {
+		period_ms = config_ptr->max_period_ms;
+	}
+	context_ptr->period_ms = period_ms;
+	context_ptr->last_rate_per_min = rate_per_min;
+
+	/* Spread whatever budget is left evenly over the rest of the day. The
+	 * adaptive period above is kept unstretched so tomorrow starts fresh. */
+	if (config_ptr->daily_capture_budget != 0U) {
+		const uint32_t day_elapsed_ms = now_ms - context_ptr->day_start_ms;
+		const uint32_t day_remaining_ms =
+				(day_elapsed_ms < APP_CAPTURE_SCHEDULE_DAY_MS) ?
+						(uint32_t) (APP_CAPTURE_SCHEDULE_DAY_MS - day_elapsed_ms) :
+						0U;
+		const uint32_t captures_left =
+				(context_ptr->day_capture_count
+						< config_ptr->daily_capture_budget) ?
+						(config_ptr->daily_capture_budget
+								- context_ptr->day_capture_count) :
+						0U;
+		const uint32_t budget_period_ms =
+				(captures_left == 0U) ?
+						day_remaining_ms : (day_remaining_ms / captures_left);
+
+		if (budget_period_ms > period_ms) {
+			period_ms = budget_period_ms;
+			context_ptr->last_reason = APP_CAPTURE_SCHEDULE_REASON_BUDGET;
+		}
+		if (period_ms > config_ptr->max_period_ms) {
+			period_ms = config_ptr->max_period_ms;
+		}
+	}
+
+	return period_ms;
+}
+
+/**
+ * @brief Short label for a schedule decision.
+ */
+const char *AppCaptureSchedule_ReasonName(AppCaptureSchedule_Reason_t reason) {
+	switch (reason) {
+	case APP_CAPTURE_SCHEDULE_REASON_STABLE:
+		return "stable";
+	case APP_CAPTURE_SCHEDULE_REASON_CHANGING:
+		return "changing";
+	case APP_CAPTURE_SCHEDULE_REASON_ALARM:
+		return "alarm";
+	case APP_CAPTURE_SCHEDULE_REASON_BUDGET:
+		return "budget";
+	case APP_CAPTURE_SCHEDULE_REASON_BASE:
+	default:
+		return "base";
+	}
+}
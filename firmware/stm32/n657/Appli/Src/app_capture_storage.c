@@ -0,0 +1,359 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_capture_storage.c
+ * @brief   Asynchronous archival save worker for captured frames.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#include "app_capture_storage.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* USER CODE BEGIN Includes */
+#include <stdio.h>
+#include <string.h>
+
+#include "main.h"
+#include "app_camera_buffers.h"
+#include "app_camera_config.h"
+#include "app_filex.h"
+#include "app_inference_runtime.h"
+#include "app_memory_budget.h"
+#include "app_storage.h"
+#include "app_threadx_config.h"
+#include "debug_console.h"
+#include "threadx_utils.h"
+/* USER CODE END Includes */
+
+/* Private define ------------------------------------------------------------*/
+/* USER CODE BEGIN PD */
+#define APP_CAPTURE_STORAGE_EXTENSION_LENGTH  8U
+/* USER CODE END PD */
+
+/* Private typedef -----------------------------------------------------------*/
+/* USER CODE BEGIN PTD */
+typedef struct {
+	const uint8_t *frame_ptr;
+	ULONG frame_length;
+	uint32_t inference_sequence;
+	CHAR file_extension[APP_CAPTURE_STORAGE_EXTENSION_LENGTH];
+} AppCaptureStorage_Request_t;
+
+typedef struct {
+	uint32_t submitted_count;
+	uint32_t saved_count;
+	uint32_t skipped_policy_count;
+	uint32_t skipped_media_count;
+	uint32_t failed_count;
+	uint32_t last_write_ms;
+	uint32_t max_write_ms;
+} AppCaptureStorage_Stats_t;
+/* USER CODE END PTD */
+
+/* Private variables ---------------------------------------------------------*/
+/* USER CODE BEGIN PV */
+static TX_THREAD app_capture_storage_thread;
+static ULONG app_capture_storage_thread_stack[CAPTURE_STORAGE_THREAD_STACK_SIZE_BYTES
+		/ sizeof(ULONG)];
+static bool app_capture_storage_thread_created = false;
+static TX_SEMAPHORE app_capture_storage_request_semaphore;
+static bool app_capture_storage_initialized = false;
+/* One request slot is enough: the capture buffer reference blocks the next
+ * capture until the worker is done with the previous frame. */
+static AppCaptureStorage_Request_t app_capture_storage_request;
+static volatile bool app_capture_storage_request_pending = false;
+static const AppCaptureStorage_Policy_t app_capture_storage_policy =
+		(AppCaptureStorage_Policy_t) CAMERA_CAPTURE_SAVE_POLICY;
+static const uint32_t app_capture_storage_every_n =
+		(CAMERA_CAPTURE_SAVE_EVERY_N_FRAMES == 0U) ?
+				1U : CAMERA_CAPTURE_SAVE_EVERY_N_FRAMES;
+static uint32_t app_capture_storage_frame_counter = 0U;
+static AppCaptureStorage_Stats_t app_capture_storage_stats;
+#if CAMERA_CAPTURE_SAVE_POLICY == CAMERA_CAPTURE_SAVE_POLICY_NO_READ_ONLY
+/* The no-read policy waits for the AI outcome on this copy so the capture
+ * buffer is released as soon as the frame is out of it. */
+static uint8_t app_capture_storage_frame_copy[CAMERA_CAPTURE_BUFFER_SIZE_BYTES];
+#endif
+/* USER CODE END PV */
+
+/* Private function prototypes -----------------------------------------------*/
+/* USER CODE BEGIN PFP */
+static VOID AppCaptureStorageThread_Entry(ULONG thread_input);
+static void AppCaptureStorage_ProcessRequest(
+		const AppCaptureStorage_Request_t *request_ptr);
+static uint32_t AppCaptureStorage_TicksToMs(ULONG ticks);
+/* USER CODE END PFP */
+
+/**
+ * @brief Create the request semaphore used by the storage worker.
+ */
+UINT AppCaptureStorage_Init(void) {
+	UINT status = TX_SUCCESS;
+
+	if (app_capture_storage_initialized) {
+		return TX_SUCCESS;
+	}
+
+	status = AppCameraBuffers_InitSync();
+	if (status != TX_SUCCESS) {
+		return status;
+	}
+	status = tx_semaphore_create(&app_capture_storage_request_semaphore,
+			"capture_storage_request", 0U);
+	if (status != TX_SUCCESS) {
+		return status;
+	}
+
+	(void) memset(&app_capture_storage_request, 0,
+			sizeof(app_capture_storage_request));
+	(void) memset(&app_capture_storage_stats, 0,
+			sizeof(app_capture_storage_stats));
+	app_capture_storage_request_pending = false;
+	app_capture_storage_frame_counter = 0U;
+	app_capture_storage_initialized = true;
+	return TX_SUCCESS;
+}
+
+/**
+ * @brief Start the low-priority storage worker thread.
+ */
+UINT AppCaptureStorage_Start(void) {
+	if (!app_capture_storage_initialized) {
+		const UINT init_status = AppCaptureStorage_Init();
+		if (init_status != TX_SUCCESS) {
+			return init_status;
+		}
+	}
+
+	if (app_capture_storage_thread_created) {
+		return TX_SUCCESS;
+	}
+
+	{
+		const UINT create_status = tx_thread_create(
+				&app_capture_storage_thread, "capture_storage",
+				AppCaptureStorageThread_Entry, 0U,
+				app_capture_storage_thread_stack,
+				sizeof(app_capture_storage_thread_stack),
+				CAPTURE_STORAGE_THREAD_PRIORITY,
+				CAPTURE_STORAGE_THREAD_PRIORITY, TX_NO_TIME_SLICE,
+				TX_AUTO_START);
+		if (create_status != TX_SUCCESS) {
+			return create_status;
+		}
+	}
+
+	app_capture_storage_thread_created = true;
+	DebugConsole_Printf(
+			"[CAMERA][STORAGE] Storage worker created (policy=%lu every_n=%lu).\r\n",
+			(unsigned long) app_capture_storage_policy,
+			(unsigned long) app_capture_storage_every_n);
+	return TX_SUCCESS;
+}
+
+/**
+ * @brief Queue an accepted frame for archival, or skip it by policy.
+ */
+bool AppCaptureStorage_SubmitFrame(const uint8_t *frame_ptr,
+		ULONG frame_length, const CHAR *file_extension_ptr,
+		uint32_t inference_sequence) {
+	const AppCaptureStorage_Policy_t policy = app_capture_storage_policy;
+
+	if (!app_capture_storage_thread_created || (frame_ptr == NULL)
+			|| (frame_length == 0U) || (file_extension_ptr == NULL)) {
+		return false;
+	}
+
+	app_capture_storage_stats.submitted_count++;
+
+	/* Decide the every-Nth case here so skipped frames never take a buffer
+	 * reference and the next capture can re-arm immediately. */
+	if (policy == APP_CAPTURE_STORAGE_POLICY_EVERY_NTH) {
+		const uint32_t frame_index = app_capture_storage_frame_counter++;
+
+		if ((frame_index % app_capture_storage_every_n) != 0U) {
+			app_capture_storage_stats.skipped_policy_count++;
+			return true;
+		}
+	}
+
+	if (!AppFileX_IsMediaReady()) {
+		app_capture_storage_stats.skipped_media_count++;
+		(void) DebugConsole_WriteString(
+				"[CAMERA][STORAGE] FileX media not ready; skipping SD save.\r\n");
+		return true;
+	}
+
+	if (app_capture_storage_request_pending) {
+		DebugConsole_Printf(
+				"[CAMERA][STORAGE] Previous save still pending; dropping frame.\r\n");
+		app_capture_storage_stats.failed_count++;
+		return false;
+	}
+
+	AppCameraBuffers_RetainCaptureBuffer();
+	app_capture_storage_request.frame_ptr = frame_ptr;
+	app_capture_storage_request.frame_length = frame_length;
+	app_capture_storage_request.inference_sequence = inference_sequence;
+	(void) snprintf(app_capture_storage_request.file_extension,
+			sizeof(app_capture_storage_request.file_extension), "%s",
+			file_extension_ptr);
+	app_capture_storage_request_pending = true;
+
+	if (tx_semaphore_put(&app_capture_storage_request_semaphore) != TX_SUCCESS) {
+		app_capture_storage_request_pending = false;
+		AppCameraBuffers_ReleaseCaptureBuffer();
+		app_capture_storage_stats.failed_count++;
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Wait for the storage worker to drop its capture buffer reference.
+ * @retval true when the buffer is free for the next DMA capture.
+ */
+bool AppCaptureStorage_WaitForBufferRelease(uint32_t timeout_ms) {
+	const ULONG start_tick = tx_time_get();
+
+	if (!AppCameraBuffers_IsCaptureBufferHeld()) {
+		return true;
+	}
+
+	(void) DebugConsole_WriteString(
+			"[CAMERA][STORAGE] Waiting for archival save to release capture buffer.\r\n");
+	if (!AppCameraBuffers_WaitForCaptureBufferRelease(
+			ThreadxUtils_MillisecondsToTicks(timeout_ms))) {
+		DebugConsole_Printf(
+				"[CAMERA][STORAGE] Capture buffer still held after %lu ms.\r\n",
+				(unsigned long) timeout_ms);
+		return false;
+	}
+
+	DebugConsole_Printf(
+			"[CAMERA][STORAGE][TIMING] buffer-release-wait=%lu ms\r\n",
+			(unsigned long) AppCaptureStorage_TicksToMs(
+					tx_time_get() - start_tick));
+	return true;
+}
+
+/**
+ * @brief Convert ThreadX ticks to milliseconds for timing logs.
+ */
+static uint32_t AppCaptureStorage_TicksToMs(ULONG ticks) {
+	return (uint32_t) ((ticks * 1000U) / (ULONG) TX_TIMER_TICKS_PER_SECOND);
+}
+
+/**
+ * @brief Archive one frame according to the active policy.
+ */
+static void AppCaptureStorage_ProcessRequest(
+		const AppCaptureStorage_Request_t *request_ptr) {
+	CHAR capture_file_name[CAMERA_CAPTURE_FILE_NAME_LENGTH] = { 0 };
+	UINT filex_status = FX_SUCCESS;
+	const uint8_t *frame_ptr = request_ptr->frame_ptr;
+
+#if CAMERA_CAPTURE_SAVE_POLICY == CAMERA_CAPTURE_SAVE_POLICY_NO_READ_ONLY
+	{
+		bool reading_published = false;
+
+		/* Copy out and drop the capture buffer before waiting, so a slow
+		 * inference never holds up the next capture. */
+		(void) memcpy(app_capture_storage_frame_copy, frame_ptr,
+				(size_t) request_ptr->frame_length);
+		frame_ptr = app_capture_storage_frame_copy;
+		AppCameraBuffers_ReleaseCaptureBuffer();
+
+		/* A frame that never reached the AI worker is a no-read by definition. */
+		if ((request_ptr->inference_sequence != 0U)
+				&& AppInferenceRuntime_WaitForRequestOutcome(
+						request_ptr->inference_sequence,
+						CAMERA_CAPTURE_SAVE_OUTCOME_WAIT_MS,
+						&reading_published)
+				&& reading_published) {
+			app_capture_storage_stats.skipped_policy_count++;
+			(void) DebugConsole_WriteString(
+					"[CAMERA][STORAGE] Reading published; no-read policy skips save.\r\n");
+			return;
+		}
+	}
+#endif
+
+	if (!AppStorage_BuildCaptureFileName(capture_file_name,
+			sizeof(capture_file_name), request_ptr->file_extension)) {
+		DebugConsole_Printf(
+				"[CAMERA][STORAGE] Failed to build capture filename.\r\n");
+		app_capture_storage_stats.failed_count++;
+		return;
+	}
+
+	{
+		const ULONG save_start_tick = tx_time_get();
+		uint32_t write_ms = 0U;
+
+		filex_status = AppFileX_WriteCapturedImage(capture_file_name,
+				frame_ptr, request_ptr->frame_length);
+		write_ms = AppCaptureStorage_TicksToMs(tx_time_get() - save_start_tick);
+		app_capture_storage_stats.last_write_ms = write_ms;
+		if (write_ms > app_capture_storage_stats.max_write_ms) {
+			app_capture_storage_stats.max_write_ms = write_ms;
+		}
+		DebugConsole_Printf(
+				"[CAMERA][STORAGE][TIMING] write-image=%lu ms status=%lu name=%s\r\n",
+				(unsigned long) write_ms, (unsigned long) filex_status,
+				capture_file_name);
+	}
+
+	if (filex_status != FX_SUCCESS) {
+		DebugConsole_Printf(
+				"[CAMERA][STORAGE] Failed to write image to SD card, status=%lu.\r\n",
+				(unsigned long) filex_status);
+		app_capture_storage_stats.failed_count++;
+		return;
+	}
+
+	app_capture_storage_stats.saved_count++;
+}
+
+/**
+ * @brief Low-priority worker that archives frames after inference dispatch.
+ * @param thread_input Unused ThreadX input value.
+ */
+static VOID AppCaptureStorageThread_Entry(ULONG thread_input) {
+	(void) thread_input;
+
+	(void) DebugConsole_WriteString("[CAMERA][STORAGE] worker alive\r\n");
+
+	while (1) {
+		AppCaptureStorage_Request_t request;
+
+		if (tx_semaphore_get(&app_capture_storage_request_semaphore,
+				TX_WAIT_FOREVER) != TX_SUCCESS) {
+			continue;
+		}
+
+		if (!app_capture_storage_request_pending) {
+			continue;
+		}
+
+		request = app_capture_storage_request;
+		AppCaptureStorage_ProcessRequest(&request);
+
+		/* Drop the buffer reference only after FileX is done reading it; the
+		 * no-read policy already dropped it once the frame was copied. */
+		app_capture_storage_request_pending = false;
+#if CAMERA_CAPTURE_SAVE_POLICY != CAMERA_CAPTURE_SAVE_POLICY_NO_READ_ONLY
+		AppCameraBuffers_ReleaseCaptureBuffer();
+#endif
+
+		DebugConsole_Printf(
+				"[CAMERA][STORAGE] saved=%lu skipped_policy=%lu skipped_media=%lu failed=%lu max_write=%lu ms\r\n",
+				(unsigned long) app_capture_storage_stats.saved_count,
+				(unsigned long) app_capture_storage_stats.skipped_policy_count,
+				(unsigned long) app_capture_storage_stats.skipped_media_count,
+				(unsigned long) app_capture_storage_stats.failed_count,
+				(unsigned long) app_capture_storage_stats.max_write_ms);
+	}
+}
@@ -36,6 +36,13 @@
 extern int mcu_cache_clean_range(uint32_t start_addr, uint32_t end_addr);
 extern int mcu_cache_invalidate_range(uint32_t start_addr, uint32_t end_addr);
 
+/* Boot check of the activation arena plan, also in app_ai.c. */
+extern bool AppAI_CheckActivationOverlay(const char *network_name,
+	const NN_Instance_TypeDef *nn_instance);
+extern void AppAI_EpochProfileBegin(const char *network_name);
+extern void AppAI_EpochProfileMark(void);
+extern void AppAI_EpochProfileEnd(bool completed);
+
 /* Generated ST Edge AI package for the heatmap center detector. */
 #include "../../st_ai_output/packages/heatmap_cd_v4s_80/st_ai_output/heatmap_cd.h"
 
@@ -226,6 +233,10 @@ bool AppCenterDetector_Init(void)
 		return false;
 	}
 	LL_ATON_RT_Init_Network(&NN_Instance_heatmap_cd);
+	if (!AppAI_CheckActivationOverlay("heatmap_cd", &NN_Instance_heatmap_cd))
+	{
+		return false;
+	}
 	center_det_initialized = true;
 	return true;
 }
@@ -335,6 +346,7 @@ bool AppCenterDetector_Run(const uint8_t *frame_bytes, size_t frame_size,
 
 		const uintptr_t runtime_r9 = AppCenterDetector_GetRuntimeR9(instance);
 
+		AppAI_EpochProfileBegin("heatmap_cd");
 		for (;;)
 		{
 			if (runtime_r9 != 0U)
@@ -346,6 +358,7 @@ bool AppCenterDetector_Run(const uint8_t *frame_bytes, size_t frame_size,
 
 			if (run_status == LL_ATON_RT_DONE)
 			{
+				AppAI_EpochProfileMark();
 				break;
 			}
 			if (run_status == LL_ATON_RT_WFE)
@@ -355,14 +368,18 @@ bool AppCenterDetector_Run(const uint8_t *frame_bytes, size_t frame_size,
 				{
 					__asm volatile("mov r9, %0" ::"r"(runtime_r9) : "r9");
 				}
+				AppAI_EpochProfileMark();
 				continue;
 			}
 			if (run_status != LL_ATON_RT_NO_WFE)
 			{
+				AppAI_EpochProfileEnd(false);
 				cnn_failure_reason = "epoch run failed";
 				goto center_detector_use_fallback;
 			}
+			AppAI_EpochProfileMark();
 		}
+		AppAI_EpochProfileEnd(true);
 
 		const LL_Buffer_InfoTypeDef *output_info =
 			instance->network->output_buffers_info();
@@ -0,0 +1,180 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_clock_profile.c
+ * @brief   Clock operating points, derived peripheral settings and arbitration.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#include "app_clock_profile.h"
+
+#include <stddef.h>
+
+#define APP_CLOCK_PROFILE_LPUART_BRR_MIN  0x300UL
+#define APP_CLOCK_PROFILE_LPUART_BRR_MAX  0xFFFFFUL
+#define APP_CLOCK_PROFILE_I2C_PRESC_MAX   15U
+
+/**
+ * @brief Kernel-clock ticks covering at least @p ns at one I2C prescaler.
+ */
+static uint32_t AppClockProfile_I2cTicks(uint32_t kernel_hz, uint32_t presc,
+		uint32_t ns) {
+	const uint64_t scaled = (uint64_t) ns * kernel_hz;
+	const uint64_t per_tick = 1000000000ULL * (presc + 1U);
+
+	return (uint32_t) ((scaled + per_tick - 1U) / per_tick);
+}
+
+uint32_t AppClockProfile_SpiDivider(uint32_t kernel_hz, uint32_t max_hz) {
+	if (max_hz == 0U) {
+		return 0U;
+	}
+	for (uint32_t divider = 2U; divider <= 256U; divider *= 2U) {
+		if ((kernel_hz / divider) <= max_hz) {
+			return divider;
+		}
+	}
+	return 0U;
+}
+
+uint32_t AppClockProfile_LpuartBrr(uint32_t kernel_hz, uint32_t baud) {
+	uint64_t brr = 0U;
+
+	if (baud == 0U) {
+		return 0U;
+	}
+	brr = (((uint64_t) kernel_hz * 256U) + (baud / 2U)) / baud;
+	if ((brr < APP_CLOCK_PROFILE_LPUART_BRR_MIN)
+			|| (brr > APP_CLOCK_PROFILE_LPUART_BRR_MAX)) {
+		return 0U;
+	}
+	return (uint32_t) brr;
+}
+
+/**
+ * @brief Rebuild TIMINGR for a new kernel clock from the reference timing.
+ *
+ * The lowest prescaler that fits keeps the finest resolution. SDADEL stays
+ * 0, as in the reference value.
+ */
+uint32_t AppClockProfile_I2cTiming(uint32_t kernel_hz) {
+	for (uint32_t presc = 0U; presc <= APP_CLOCK_PROFILE_I2C_PRESC_MAX;
+			presc++) {
+		const uint32_t scll = AppClockProfile_I2cTicks(kernel_hz, presc,
+				APP_CLOCK_PROFILE_I2C_SCLL_NS);
+		const uint32_t sclh = AppClockProfile_I2cTicks(kernel_hz, presc,
+				APP_CLOCK_PROFILE_I2C_SCLH_NS);
+		const uint32_t scldel = AppClockProfile_I2cTicks(kernel_hz, presc,
+				APP_CLOCK_PROFILE_I2C_SCLDEL_NS);
+
+		if ((scll == 0U) || (sclh == 0U) || (scldel == 0U)) {
+			return 0U;
+		}
+		if ((scll <= 256U) && (sclh <= 256U) && (scldel <= 16U)) {
+			return (presc << 28) | ((scldel - 1U) << 20) | ((sclh - 1U) << 8)
+					| (scll - 1U);
+		}
+	}
+	return 0U;
+}
+
+/**
+ * @brief Work out the clocks and peripheral settings for one point.
+ */
+bool AppClockProfile_Derive(uint32_t pll1_hz,
+		const AppClockProfile_Point_t *point_ptr,
+		AppClockProfile_Derived_t *derived_ptr) {
+	if ((point_ptr == NULL) || (derived_ptr == NULL)
+			|| (point_ptr->cpu_divider == 0U) || (point_ptr->sys_divider == 0U)) {
+		return false;
+	}
+
+	derived_ptr->cpu_hz = pll1_hz / point_ptr->cpu_divider;
+	derived_ptr->sys_hz = pll1_hz / point_ptr->sys_divider;
+	derived_ptr->pclk_hz = derived_ptr->sys_hz / APP_CLOCK_PROFILE_AHB_DIVIDER;
+	if ((derived_ptr->cpu_hz > APP_CLOCK_PROFILE_CPU_MAX_HZ)
+			|| (derived_ptr->sys_hz > APP_CLOCK_PROFILE_SYS_MAX_HZ)) {
+		return false;
+	}
+
+	/* The DWT divisor and the 1 MHz TIM5 timebase need whole megahertz. */
+	if (((derived_ptr->cpu_hz % 1000000UL) != 0U)
+			|| ((derived_ptr->sys_hz % 1000000UL) != 0U)) {
+		return false;
+	}
+	derived_ptr->dwt_cycles_per_us = derived_ptr->cpu_hz / 1000000UL;
+
+	derived_ptr->spi5_divider = AppClockProfile_SpiDivider(
+			derived_ptr->pclk_hz, APP_CLOCK_PROFILE_SPI5_MAX_HZ);
+	derived_ptr->lpuart_brr = AppClockProfile_LpuartBrr(derived_ptr->pclk_hz,
+			APP_CLOCK_PROFILE_LPUART_BAUD);
+	derived_ptr->i2c_timing = AppClockProfile_I2cTiming(derived_ptr->pclk_hz);
+	if ((derived_ptr->spi5_divider == 0U) || (derived_ptr->lpuart_brr == 0U)
+			|| (derived_ptr->i2c_timing == 0U)) {
+		return false;
+	}
+	derived_ptr->spi5_hz = derived_ptr->pclk_hz / derived_ptr->spi5_divider;
+	return true;
+}
+
+void AppClockProfile_InitDemand(AppClockProfile_Demand_t *demand_ptr) {
+	if (demand_ptr == NULL) {
+		return;
+	}
+	for (uint32_t i = 0U; i < (uint32_t) APP_CLOCK_CLIENT_COUNT; i++) {
+		demand_ptr->demand[i] = APP_CLOCK_PROFILE_LOW;
+	}
+}
+
+AppClockProfile_Id_t AppClockProfile_SetDemand(
+		AppClockProfile_Demand_t *demand_ptr, AppClockProfile_Client_t client,
+		AppClockProfile_Id_t profile) {
+	AppClockProfile_Id_t previous = APP_CLOCK_PROFILE_LOW;
+
+	if ((demand_ptr == NULL) || (client >= APP_CLOCK_CLIENT_COUNT)
+			|| (profile >= APP_CLOCK_PROFILE_COUNT)) {
+		return previous;
+	}
+	previous = demand_ptr->demand[client];
+	demand_ptr->demand[client] = profile;
+	return previous;
+}
+
+AppClockProfile_Id_t AppClockProfile_Effective(
+		const AppClockProfile_Demand_t *demand_ptr) {
+	AppClockProfile_Id_t effective = APP_CLOCK_PROFILE_LOW;
+
+	if (demand_ptr == NULL) {
+		return effective;
+	}
+	for (uint32_t i = 0U; i < (uint32_t) APP_CLOCK_CLIENT_COUNT; i++) {
+		if (demand_ptr->demand[i] > effective) {
+			effective = demand_ptr->demand[i];
+		}
+	}
+	return effective;
+}
+
+void AppClockProfile_Account(AppClockProfile_Energy_t *energy_ptr,
+		AppClockProfile_Id_t profile, uint32_t dwell_ms, uint32_t power_mw) {
+	if ((energy_ptr == NULL) || (profile >= APP_CLOCK_PROFILE_COUNT)) {
+		return;
+	}
+	energy_ptr->dwell_ms[profile] += dwell_ms;
+	/* mW x ms = uJ. */
+	energy_ptr->energy_uj[profile] += (uint64_t) power_mw * dwell_ms;
+}
+
+const char *AppClockProfile_Name(AppClockProfile_Id_t profile) {
+	switch (profile) {
+	case APP_CLOCK_PROFILE_LOW:
+		return "low";
+	case APP_CLOCK_PROFILE_NOMINAL:
+		return "nominal";
+	case APP_CLOCK_PROFILE_BOOST:
+		return "boost";
+	default:
+		return "unknown";
+	}
+}
@@ -0,0 +1,369 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_clocks.c
+ * @brief   Phase-driven CPU and bus clock profile switching.
+ *
+ * The capture loop, the baseline worker and the AI worker each state the
+ * profile their current phase needs; the highest demand is applied. Boost
+ * covers capture, preprocessing and baseline CV, nominal covers NPU epochs
+ * where the CPU only waits on the accelerator, and low covers the gaps
+ * between readings and the FileX/console I/O that follows them.
+ *
+ * PLL1 never changes: the camera and NPU kernel clocks hang off it, so only
+ * the IC1 (CPU) and IC2 (system bus) dividers move. Each switch parks the
+ * affected clock on HSI first, the same way App_SystemClock_Config() does.
+ * The switch runs under a scheduler lock with interrupts left on, since the
+ * RCC timeouts and HAL_InitTick() need the TIM5 timebase. A bus change also
+ * re-derives everything clocked from PCLK1/2/4: the LPUART1 BRR, the
+ * I2C1/I2C2 TIMINGR and the SPI5 data-phase prescaler. It is only attempted
+ * while those peripherals and the bus masters (DCMIPP DMA, the NPU and
+ * xSPI2) are idle, so no transfer ever straddles a clock change.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#include "app_clocks.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* USER CODE BEGIN Includes */
+#include <string.h>
+
+#include "main.h"
+#include "app_ai.h"
+#include "app_camera_config.h"
+#include "app_camera_platform.h"
+#include "app_threadx_config.h"
+#include "debug_console.h"
+#include "ina219_power.h"
+#include "inference_metrics.h"
+#include "sd_spi_ll.h"
+/* USER CODE END Includes */
+
+/* Private define ------------------------------------------------------------*/
+/* USER CODE BEGIN PD */
+#define APP_CLOCKS_PLL1_HZ  1200000000UL  /* HSI 64 MHz / 4 * 75. */
+/* USER CODE END PD */
+
+/* Private variables ---------------------------------------------------------*/
+/* USER CODE BEGIN PV */
+extern UART_HandleTypeDef hlpuart1;
+extern I2C_HandleTypeDef hi2c1;
+extern I2C_HandleTypeDef hi2c2;
+extern SPI_HandleTypeDef hspi5;
+
+static const AppClockProfile_Point_t app_clocks_points[APP_CLOCK_PROFILE_COUNT] = {
+	[APP_CLOCK_PROFILE_LOW] = {
+		.cpu_divider = APP_CLOCK_LOW_CPU_DIVIDER,
+		.sys_divider = APP_CLOCK_LOW_SYS_DIVIDER,
+	},
+	[APP_CLOCK_PROFILE_NOMINAL] = {
+		.cpu_divider = APP_CLOCK_NOMINAL_CPU_DIVIDER,
+		.sys_divider = APP_CLOCK_NOMINAL_SYS_DIVIDER,
+	},
+	[APP_CLOCK_PROFILE_BOOST] = {
+		.cpu_divider = APP_CLOCK_BOOST_CPU_DIVIDER,
+		.sys_divider = APP_CLOCK_BOOST_SYS_DIVIDER,
+	},
+};
+static AppClockProfile_Derived_t app_clocks_derived[APP_CLOCK_PROFILE_COUNT];
+static AppClockProfile_Demand_t app_clocks_demand;
+static AppClockProfile_Energy_t app_clocks_energy;
+static TX_MUTEX app_clocks_mutex;
+static bool app_clocks_ready = false;
+static AppClockProfile_Id_t app_clocks_active = APP_CLOCK_PROFILE_BOOST;
+static uint32_t app_clocks_active_since_ms = 0U;
+static uint32_t app_clocks_switch_count = 0U;
+static uint32_t app_clocks_deferred_count = 0U;
+/* USER CODE END PV */
+
+/* Private function prototypes -----------------------------------------------*/
+/* USER CODE BEGIN PFP */
+static bool AppClocks_PeripheralsIdle(void);
+static bool AppClocks_BusMastersIdle(void);
+static bool AppClocks_Apply(AppClockProfile_Id_t profile);
+static void AppClocks_ApplyBusDerived(const AppClockProfile_Derived_t *derived_ptr);
+static void AppClocks_AccountDwell(void);
+static uint32_t AppClocks_ReadPowerMw(void);
+/* USER CODE END PFP */
+
+/**
+ * @brief Derive the profile table and create the switch mutex.
+ * @retval TX_SUCCESS, TX_NOT_AVAILABLE or the tx_mutex_create status.
+ */
+UINT AppClocks_Init(void) {
+	UINT status = TX_SUCCESS;
+
+	if ((APP_CLOCK_PROFILES_ENABLED == 0U) || app_clocks_ready) {
+		return TX_SUCCESS;
+	}
+
+	for (uint32_t i = 0U; i < (uint32_t) APP_CLOCK_PROFILE_COUNT; i++) {
+		if (!AppClockProfile_Derive(APP_CLOCKS_PLL1_HZ, &app_clocks_points[i],
+				&app_clocks_derived[i])) {
+			DebugConsole_Printf(
+					"[CLOCK] Profile %s does not derive; staying at boot clocks.\r\n",
+					AppClockProfile_Name((AppClockProfile_Id_t) i));
+			return TX_NOT_AVAILABLE;
+		}
+	}
+
+	status = tx_mutex_create(&app_clocks_mutex, "clock_profiles", TX_INHERIT);
+	if (status != TX_SUCCESS) {
+		return status;
+	}
+
+	/* Boot leaves the board at the boost point with every client idle; the
+	 * first phase change drops it to what is actually needed. */
+	AppClockProfile_InitDemand(&app_clocks_demand);
+	app_clocks_active = APP_CLOCK_PROFILE_BOOST;
+	app_clocks_active_since_ms = HAL_GetTick();
+	Metrics_SetCpuClockHz(SystemCoreClock);
+	app_clocks_ready = true;
+
+	for (uint32_t i = 0U; i < (uint32_t) APP_CLOCK_PROFILE_COUNT; i++) {
+		const AppClockProfile_Derived_t *derived_ptr = &app_clocks_derived[i];
+
+		DebugConsole_Printf(
+				"[CLOCK][PROFILE] %s cpu=%luMHz bus=%luMHz spi5=/%lu i2c=0x%08lX\r\n",
+				AppClockProfile_Name((AppClockProfile_Id_t) i),
+				(unsigned long) (derived_ptr->cpu_hz / 1000000UL),
+				(unsigned long) (derived_ptr->sys_hz / 1000000UL),
+				(unsigned long) derived_ptr->spi5_divider,
+				(unsigned long) derived_ptr->i2c_timing);
+	}
+	return TX_SUCCESS;
+}
+
+/**
+ * @brief Record a client's demand and switch to the new effective profile.
+ * @param client  Pipeline phase owner.
+ * @param profile Profile the phase needs from now on.
+ * @retval The client's previous demand.
+ */
+AppClockProfile_Id_t AppClocks_SetDemand(AppClockProfile_Client_t client,
+		AppClockProfile_Id_t profile) {
+	AppClockProfile_Id_t previous = APP_CLOCK_PROFILE_LOW;
+	AppClockProfile_Id_t effective = APP_CLOCK_PROFILE_LOW;
+
+	if (!app_clocks_ready) {
+		return previous;
+	}
+	if (tx_mutex_get(&app_clocks_mutex, TX_WAIT_FOREVER) != TX_SUCCESS) {
+		return previous;
+	}
+
+	previous = AppClockProfile_SetDemand(&app_clocks_demand, client, profile);
+	effective = AppClockProfile_Effective(&app_clocks_demand);
+	if (effective != app_clocks_active) {
+		AppClocks_AccountDwell();
+		if (AppClocks_Apply(effective)) {
+			app_clocks_active = effective;
+			app_clocks_switch_count++;
+		} else {
+			app_clocks_deferred_count++;
+		}
+	}
+
+	(void) tx_mutex_put(&app_clocks_mutex);
+	return previous;
+}
+
+AppClockProfile_Id_t AppClocks_GetActiveProfile(void) {
+	return app_clocks_active;
+}
+
+/**
+ * @brief Log time and energy per profile since the previous call.
+ */
+void AppClocks_LogEnergyPerReading(void) {
+	AppClockProfile_Energy_t energy;
+	uint64_t total_uj = 0U;
+	uint32_t switches = 0U;
+	uint32_t deferred = 0U;
+
+	if (!app_clocks_ready
+			|| (tx_mutex_get(&app_clocks_mutex, TX_WAIT_FOREVER) != TX_SUCCESS)) {
+		return;
+	}
+	AppClocks_AccountDwell();
+	energy = app_clocks_energy;
+	(void) memset(&app_clocks_energy, 0, sizeof(app_clocks_energy));
+	switches = app_clocks_switch_count;
+	deferred = app_clocks_deferred_count;
+	(void) tx_mutex_put(&app_clocks_mutex);
+
+	for (uint32_t i = 0U; i < (uint32_t) APP_CLOCK_PROFILE_COUNT; i++) {
+		total_uj += energy.energy_uj[i];
+		DebugConsole_Printf("[CLOCK][ENERGY] %s ms=%lu mJ=%lu.%03lu\r\n",
+				AppClockProfile_Name((AppClockProfile_Id_t) i),
+				(unsigned long) energy.dwell_ms[i],
+				(unsigned long) (energy.energy_uj[i] / 1000U),
+				(unsigned long) (energy.energy_uj[i] % 1000U));
+	}
+	DebugConsole_Printf(
+			"[CLOCK][ENERGY] per_reading mJ=%lu.%03lu switches=%lu deferred=%lu\r\n",
+			(unsigned long) (total_uj / 1000U),
+			(unsigned long) (total_uj % 1000U), (unsigned long) switches,
+			(unsigned long) deferred);
+}
+
+/**
+ * @brief Check that nothing clocked from PCLK is mid-transfer.
+ *
+ * Called under the scheduler lock, so no other thread can start a transfer
+ * on a handle seen idle until the switch is done.
+ */
+static bool AppClocks_PeripheralsIdle(void) {
+	return (hlpuart1.gState == HAL_UART_STATE_READY)
+			&& (hi2c1.State == HAL_I2C_STATE_READY)
+			&& (hi2c2.State == HAL_I2C_STATE_READY)
+			&& (hspi5.State == HAL_SPI_STATE_READY)
+			&& ((hspi5.Instance->CR1 & SPI_CR1_SPE) == 0U);
+}
+
+/**
+ * @brief Check that no DMA master is moving data over the system bus.
+ *
+ * The capture and NN pipes run their own DMA and the NPU streams weights
+ * from xSPI2 while its thread sleeps, so the scheduler lock alone does not
+ * stop them.
+ */
+static bool AppClocks_BusMastersIdle(void) {
+	DCMIPP_HandleTypeDef *const dcmipp_ptr =
+			CameraPlatform_GetCaptureDcmippHandle();
+
+	if ((dcmipp_ptr != NULL) && (dcmipp_ptr->Instance != NULL)) {
+		if (HAL_DCMIPP_PIPE_GetState(dcmipp_ptr, CAMERA_CAPTURE_PIPE)
+				== HAL_DCMIPP_PIPE_STATE_BUSY) {
+			return false;
+		}
+#if CAMERA_CAPTURE_ENABLE_NN_PIPE
+		if (HAL_DCMIPP_PIPE_GetState(dcmipp_ptr, CAMERA_NN_PIPE)
+				== HAL_DCMIPP_PIPE_STATE_BUSY) {
+			return false;
+		}
+#endif
+	}
+
+	return !AppAI_IsBusMasterActive();
+}
+
+/**
+ * @brief Move the CPU, and the bus if its divider differs, to a profile.
+ * @retval false when the switch was deferred or the RCC rejected it.
+ */
+static bool AppClocks_Apply(AppClockProfile_Id_t profile) {
+	TX_INTERRUPT_SAVE_AREA
+	TX_THREAD *const thread_ptr = tx_thread_identify();
+	const AppClockProfile_Derived_t *derived_ptr = &app_clocks_derived[profile];
+	const bool bus_change = (app_clocks_points[profile].sys_divider
+			!= app_clocks_points[app_clocks_active].sys_divider);
+	RCC_ClkInitTypeDef clk = { 0 };
+	UINT old_threshold = 0U;
+	bool applied = false;
+
+	/* Threshold 0 keeps every other thread off the CPU while leaving the
+	 * TIM5 tick running for the HAL_RCC_ClockConfig() timeouts. */
+	if ((thread_ptr == TX_NULL)
+			|| (tx_thread_preemption_change(thread_ptr, 0U, &old_threshold)
+					!= TX_SUCCESS)) {
+		return false;
+	}
+	if (bus_change
+			&& (!AppClocks_PeripheralsIdle() || !AppClocks_BusMastersIdle())) {
+		(void) tx_thread_preemption_change(thread_ptr, old_threshold,
+				&old_threshold);
+		return false;
+	}
+
+	HAL_RCC_GetClockConfig(&clk);
+	clk.ClockType = RCC_CLOCKTYPE_CPUCLK;
+	if (bus_change) {
+		clk.ClockType |= RCC_CLOCKTYPE_SYSCLK;
+	}
+
+	/* IC dividers may only change while nothing runs from them. */
+	clk.CPUCLKSource = RCC_CPUCLKSOURCE_HSI;
+	clk.SYSCLKSource = RCC_SYSCLKSOURCE_HSI;
+	if (HAL_RCC_ClockConfig(&clk) == HAL_OK) {
+		clk.CPUCLKSource = RCC_CPUCLKSOURCE_IC1;
+		clk.SYSCLKSource = RCC_SYSCLKSOURCE_IC2_IC6_IC11;
+		clk.IC1Selection.ClockSelection = RCC_ICCLKSOURCE_PLL1;
+		clk.IC1Selection.ClockDivider = app_clocks_points[profile].cpu_divider;
+		clk.IC2Selection.ClockSelection = RCC_ICCLKSOURCE_PLL1;
+		clk.IC2Selection.ClockDivider = app_clocks_points[profile].sys_divider;
+		applied = (HAL_RCC_ClockConfig(&clk) == HAL_OK);
+	}
+	if (!applied) {
+		/* Get back onto the PLL at the old point rather than stay on HSI. */
+		clk.CPUCLKSource = RCC_CPUCLKSOURCE_IC1;
+		clk.SYSCLKSource = RCC_SYSCLKSOURCE_IC2_IC6_IC11;
+		clk.IC1Selection.ClockDivider =
+				app_clocks_points[app_clocks_active].cpu_divider;
+		clk.IC2Selection.ClockDivider =
+				app_clocks_points[app_clocks_active].sys_divider;
+		(void) HAL_RCC_ClockConfig(&clk);
+	}
+
+	/* HAL_RCC_ClockConfig() refreshed SystemCoreClock and the TIM5 timebase;
+	 * the ThreadX SysTick and the DWT timestamps follow the CPU here. */
+	TX_DISABLE
+	SysTick->LOAD = (SystemCoreClock / TX_TIMER_TICKS_PER_SECOND) - 1U;
+	SysTick->VAL = 0U;
+	TX_RESTORE
+	Metrics_SetCpuClockHz(SystemCoreClock);
+	if (applied && bus_change) {
+		AppClocks_ApplyBusDerived(derived_ptr);
+	}
+	(void) tx_thread_preemption_change(thread_ptr, old_threshold,
+			&old_threshold);
+	return applied;
+}
+
+/**
+ * @brief Re-derive the PCLK-clocked peripheral settings after a bus change.
+ *
+ * Register-only: the HAL handles stay READY and keep their Init copies in
+ * step so a later HAL_*_Init() does not undo the change.
+ */
+static void AppClocks_ApplyBusDerived(const AppClockProfile_Derived_t *derived_ptr) {
+	I2C_HandleTypeDef *const i2c_handles[] = { &hi2c1, &hi2c2 };
+
+	CLEAR_BIT(hlpuart1.Instance->CR1, USART_CR1_UE);
+	hlpuart1.Instance->BRR = derived_ptr->lpuart_brr;
+	SET_BIT(hlpuart1.Instance->CR1, USART_CR1_UE);
+
+	for (uint32_t i = 0U; i < (sizeof(i2c_handles) / sizeof(i2c_handles[0])); i++) {
+		CLEAR_BIT(i2c_handles[i]->Instance->CR1, I2C_CR1_PE);
+		i2c_handles[i]->Instance->TIMINGR = derived_ptr->i2c_timing;
+		i2c_handles[i]->Init.Timing = derived_ptr->i2c_timing;
+		SET_BIT(i2c_handles[i]->Instance->CR1, I2C_CR1_PE);
+	}
+
+	SPI_SD_RetuneForBusClock();
+}
+
+/**
+ * @brief Charge the time since the last switch to the active profile.
+ *
+ * Uses the INA219 monitor's latest board power, so a profile's energy is as
+ * fresh as the power thread's sampling period.
+ */
+static void AppClocks_AccountDwell(void) {
+	const uint32_t now_ms = HAL_GetTick();
+
+	AppClockProfile_Account(&app_clocks_energy, app_clocks_active,
+			now_ms - app_clocks_active_since_ms, AppClocks_ReadPowerMw());
+	app_clocks_active_since_ms = now_ms;
+}
+
+static uint32_t AppClocks_ReadPowerMw(void) {
+	INA219_Measurement_t measurement;
+
+	if (!INA219_GetLastMeasurement(&measurement) || !measurement.valid
+			|| (measurement.power_w <= 0.0f)) {
+		return 0U;
+	}
+	return (uint32_t) ((measurement.power_w * 1000.0f) + 0.5f);
+}
@@ -0,0 +1,91 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_epoch_profile.c
+ * @brief   Per-epoch timing profile of one NPU network.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#include "app_epoch_profile.h"
+
+#include <stddef.h>
+#include <string.h>
+
+void AppEpochProfile_Init(AppEpochProfile_t *profile_ptr) {
+	if (profile_ptr == NULL) {
+		return;
+	}
+	(void) memset(profile_ptr, 0, sizeof(*profile_ptr));
+}
+
+void AppEpochProfile_BeginRun(AppEpochProfile_t *profile_ptr, uint64_t now_us) {
+	if (profile_ptr == NULL) {
+		return;
+	}
+	profile_ptr->cursor = 0U;
+	profile_ptr->last_mark_us = now_us;
+	profile_ptr->in_run = true;
+}
+
+void AppEpochProfile_Mark(AppEpochProfile_t *profile_ptr, uint64_t now_us) {
+	AppEpochProfile_Stat_t *stat_ptr = NULL;
+	uint64_t elapsed = 0U;
+	uint32_t elapsed_us = 0U;
+
+	if ((profile_ptr == NULL) || !profile_ptr->in_run) {
+		return;
+	}
+	elapsed = (now_us > profile_ptr->last_mark_us) ?
+			(now_us - profile_ptr->last_mark_us) : 0U;
+	elapsed_us = (elapsed > UINT32_MAX) ? UINT32_MAX : (uint32_t) elapsed;
+	profile_ptr->last_mark_us = now_us;
+
+	if (profile_ptr->cursor >= APP_EPOCH_PROFILE_MAX_EPOCHS) {
+		profile_ptr->dropped++;
+		profile_ptr->cursor++;
+		return;
+	}
+	stat_ptr = &profile_ptr->epochs[profile_ptr->cursor];
+	if ((stat_ptr->count == 0U) || (elapsed_us < stat_ptr->min_us)) {
+		stat_ptr->min_us = elapsed_us;
+	}
+	if (elapsed_us > stat_ptr->max_us) {
+		stat_ptr->max_us = elapsed_us;
+	}
+	stat_ptr->total_us += elapsed_us;
+	stat_ptr->count++;
+	profile_ptr->cursor++;
+	if (profile_ptr->cursor > profile_ptr->epoch_count) {
+		profile_ptr->epoch_count = profile_ptr->cursor;
+	}
+}
+
+void AppEpochProfile_EndRun(AppEpochProfile_t *profile_ptr, bool completed) {
+	if ((profile_ptr == NULL) || !profile_ptr->in_run) {
+		return;
+	}
+	profile_ptr->in_run = false;
+	if (completed) {
+		profile_ptr->run_count++;
+	}
+}
+
+uint32_t AppEpochProfile_AverageUs(const AppEpochProfile_Stat_t *stat_ptr) {
+	if ((stat_ptr == NULL) || (stat_ptr->count == 0U)) {
+		return 0U;
+	}
+	return (uint32_t) (stat_ptr->total_us / stat_ptr->count);
+}
+
+uint64_t AppEpochProfile_TotalAverageUs(const AppEpochProfile_t *profile_ptr) {
+	uint64_t total = 0U;
+
+	if (profile_ptr == NULL) {
+		return 0U;
+	}
+	for (uint32_t index = 0U; index < profile_ptr->epoch_count; index++) {
+		total += AppEpochProfile_AverageUs(&profile_ptr->epochs[index]);
+	}
+	return total;
+}
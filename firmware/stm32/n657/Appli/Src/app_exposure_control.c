@@ -0,0 +1,248 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_exposure_control.c
+ * @brief   Model-based one-shot exposure/gain correction for the IMX335 path.
+ *
+ * The processed luma is modelled as mean ~ (exposure x gain)^(1/gamma), where
+ * gamma folds in the ISP tone curve. Inverting that gives the exposure x gain
+ * ratio needed to hit the target mean from a single rejected frame. Exposure
+ * is spent before gain to keep sensor noise down.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#include "app_exposure_control.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+/* Histogram bins treated as clipped; the mean is unreliable past these. */
+#define APP_EXPOSURE_CONTROL_CLIP_HIGH_LEVEL      250U
+#define APP_EXPOSURE_CONTROL_CLIP_LOW_LEVEL         5U
+/* Specular highlights on the gauge glass clip a few pixels in good frames. */
+#define APP_EXPOSURE_CONTROL_CLIP_IGNORE_FRACTION 0.25f
+/* Past this clipped share the mean is too biased to refine gamma from. */
+#define APP_EXPOSURE_CONTROL_CLIP_FRACTION       0.50f
+/* A fully clipped frame hides how far off it is; assume at least this much
+ * more correction (in linear exposure) than the mean alone suggests. */
+#define APP_EXPOSURE_CONTROL_CLIP_EXTRA_RATIO     4.0f
+/* Plausible range for a gamma refined from two frames. */
+#define APP_EXPOSURE_CONTROL_GAMMA_MIN            0.8f
+#define APP_EXPOSURE_CONTROL_GAMMA_MAX            4.0f
+
+/**
+ * @brief Map a clipped fraction to 0..1, ignoring the small clipped share a
+ *        well-exposed frame with a few specular highlights already has.
+ */
+static float AppExposureControl_ClipWeight(float clipped_fraction) {
+	const float ignored = APP_EXPOSURE_CONTROL_CLIP_IGNORE_FRACTION;
+
+	if (clipped_fraction <= ignored) {
+		return 0.0f;
+	}
+
+	return (clipped_fraction - ignored) / (1.0f - ignored);
+}
+
+/**
+ * @brief Reset the controller for a new capture request.
+ */
+void AppExposureControl_Init(AppExposureControl_Context_t *context_ptr,
+		const AppExposureControl_Config_t *config_ptr,
+		const AppExposureControl_Limits_t *limits_ptr) {
+	if ((context_ptr == NULL) || (config_ptr == NULL) || (limits_ptr == NULL)) {
+		return;
+	}
+
+	(void) memset(context_ptr, 0, sizeof(*context_ptr));
+	context_ptr->config = *config_ptr;
+	context_ptr->limits = *limits_ptr;
+	if (context_ptr->config.response_gamma <= 0.0f) {
+		context_ptr->config.response_gamma = 2.2f;
+	}
+	if ((context_ptr->config.second_step_damping <= 0.0f)
+			|| (context_ptr->config.second_step_damping > 1.0f)) {
+		context_ptr->config.second_step_damping = 1.0f;
+	}
+	if (context_ptr->config.max_step_ratio < 1.0f) {
+		context_ptr->config.max_step_ratio = 1.0f;
+	}
+	context_ptr->estimated_gamma = context_ptr->config.response_gamma;
+}
+
+/**
+ * @brief Summarize a 256-bin luma histogram.
+ */
+bool AppExposureControl_Measure(const uint32_t *histogram_ptr,
+		AppExposureControl_Measurement_t *measurement_out) {
+	uint64_t sum = 0U;
+	uint32_t sample_count = 0U;
+	uint32_t clipped_high = 0U;
+	uint32_t clipped_low = 0U;
+	uint32_t level = 0U;
+
+	if ((histogram_ptr == NULL) || (measurement_out == NULL)) {
+		return false;
+	}
+
+	for (level = 0U; level < APP_EXPOSURE_CONTROL_HISTOGRAM_BINS; level++) {
+		const uint32_t count = histogram_ptr[level];
+
+		sum += (uint64_t) count * level;
+		sample_count += count;
+		if (level >= APP_EXPOSURE_CONTROL_CLIP_HIGH_LEVEL) {
+			clipped_high += count;
+		}
+		if (level <= APP_EXPOSURE_CONTROL_CLIP_LOW_LEVEL) {
+			clipped_low += count;
+		}
+	}
+
+	if (sample_count == 0U) {
+		return false;
+	}
+
+	measurement_out->sample_count = sample_count;
+	measurement_out->mean = (float) sum / (float) sample_count;
+	measurement_out->clipped_high_fraction = (float) clipped_high
+			/ (float) sample_count;
+	measurement_out->clipped_low_fraction = (float) clipped_low
+			/ (float) sample_count;
+	return true;
+}
+
+/**
+ * @brief Exposure x linear gain for a sensor setting.
+ */
+float AppExposureControl_TotalFromSetting(
+		const AppExposureControl_Setting_t *setting_ptr) {
+	if (setting_ptr == NULL) {
+		return 0.0f;
+	}
+
+	return (float) setting_ptr->exposure_us
+			* powf(10.0f, (float) setting_ptr->gain_mdb / 20000.0f);
+}
+
+/**
+ * @brief Split a total into exposure first, then gain, within the limits.
+ */
+void AppExposureControl_SettingFromTotal(
+		const AppExposureControl_Limits_t *limits_ptr, float total,
+		AppExposureControl_Setting_t *setting_out) {
+	float min_gain_linear = 0.0f;
+	float exposure_us = 0.0f;
+
+	if ((limits_ptr == NULL) || (setting_out == NULL)) {
+		return;
+	}
+
+	min_gain_linear = powf(10.0f, (float) limits_ptr->gain_min_mdb / 20000.0f);
+	exposure_us = total / min_gain_linear;
+
+	if (exposure_us <= (float) limits_ptr->exposure_max_us) {
+		if (exposure_us < (float) limits_ptr->exposure_min_us) {
+			exposure_us = (float) limits_ptr->exposure_min_us;
+		}
+		setting_out->exposure_us = (uint32_t) (exposure_us + 0.5f);
+		setting_out->gain_mdb = limits_ptr->gain_min_mdb;
+		return;
+	}
+
+	/* Exposure is maxed out; make up the rest with gain. */
+	{
+		const float gain_linear = total / (float) limits_ptr->exposure_max_us;
+		float gain_mdb = 20000.0f * log10f(gain_linear);
+
+		if (gain_mdb > (float) limits_ptr->gain_max_mdb) {
+			gain_mdb = (float) limits_ptr->gain_max_mdb;
+		}
+		if (gain_mdb < (float) limits_ptr->gain_min_mdb) {
+			gain_mdb = (float) limits_ptr->gain_min_mdb;
+		}
+		setting_out->exposure_us = limits_ptr->exposure_max_us;
+		setting_out->gain_mdb = (int32_t) (gain_mdb + 0.5f);
+	}
+}
+
+/**
+ * @brief Compute the exposure/gain for the next frame.
+ */
+bool AppExposureControl_ComputeNext(AppExposureControl_Context_t *context_ptr,
+		const AppExposureControl_Measurement_t *measurement_ptr,
+		const AppExposureControl_Setting_t *current_ptr,
+		AppExposureControl_Setting_t *next_out) {
+	float total = 0.0f;
+	float mean = 0.0f;
+	float log_ratio = 0.0f;
+	float max_log_step = 0.0f;
+	bool clipped = false;
+
+	if ((context_ptr == NULL) || (measurement_ptr == NULL)
+			|| (current_ptr == NULL) || (next_out == NULL)) {
+		return false;
+	}
+
+	total = AppExposureControl_TotalFromSetting(current_ptr);
+	mean = (measurement_ptr->mean < 1.0f) ? 1.0f : measurement_ptr->mean;
+	clipped = (measurement_ptr->clipped_high_fraction
+			> APP_EXPOSURE_CONTROL_CLIP_FRACTION)
+			|| (measurement_ptr->clipped_low_fraction
+					> APP_EXPOSURE_CONTROL_CLIP_FRACTION);
+	if (total <= 0.0f) {
+		return false;
+	}
+
+	/* Two unclipped frames at different settings pin down the real slope of
+	 * the response, which absorbs ISP tone-curve differences between sites. */
+	if (context_ptr->has_previous && !context_ptr->previous_clipped && !clipped) {
+		const float log_total_delta = logf(total / context_ptr->previous_total);
+		const float log_mean_delta = logf(mean / context_ptr->previous_mean);
+
+		if ((fabsf(log_total_delta) > 0.05f) && (fabsf(log_mean_delta) > 0.02f)) {
+			const float gamma = log_total_delta / log_mean_delta;
+
+			if ((gamma >= APP_EXPOSURE_CONTROL_GAMMA_MIN)
+					&& (gamma <= APP_EXPOSURE_CONTROL_GAMMA_MAX)) {
+				context_ptr->estimated_gamma = gamma;
+			}
+		}
+	}
+
+	log_ratio = context_ptr->estimated_gamma
+			* logf(context_ptr->config.target_mean / mean);
+
+	/* The mean of a clipped frame understates the error, so push further in
+	 * proportion to how much of the crop is pinned at either end. */
+	log_ratio -= AppExposureControl_ClipWeight(
+			measurement_ptr->clipped_high_fraction)
+			* logf(APP_EXPOSURE_CONTROL_CLIP_EXTRA_RATIO);
+	log_ratio += AppExposureControl_ClipWeight(
+			measurement_ptr->clipped_low_fraction)
+			* logf(APP_EXPOSURE_CONTROL_CLIP_EXTRA_RATIO);
+
+	if (context_ptr->step_count > 0U) {
+		log_ratio *= context_ptr->config.second_step_damping;
+	}
+
+	max_log_step = logf(context_ptr->config.max_step_ratio);
+	if (log_ratio > max_log_step) {
+		log_ratio = max_log_step;
+	} else if (log_ratio < -max_log_step) {
+		log_ratio = -max_log_step;
+	}
+
+	AppExposureControl_SettingFromTotal(&context_ptr->limits,
+			total * expf(log_ratio), next_out);
+
+	context_ptr->has_previous = true;
+	context_ptr->previous_total = total;
+	context_ptr->previous_mean = mean;
+	context_ptr->previous_clipped = clipped;
+	context_ptr->step_count++;
+
+	return (next_out->exposure_us != current_ptr->exposure_us)
+			|| (next_out->gain_mdb != current_ptr->gain_mdb);
+}
@@ -0,0 +1,264 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_exposure_memory.c
+ * @brief   Accepted IMX335 exposure/gain remembered per time-of-day bucket.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#include "app_exposure_memory.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * @brief Bitwise CRC-32 (IEEE, reflected). The table is ~300 bytes and only
+ *        checked on load/save, so a lookup table is not worth the flash.
+ */
+static uint32_t AppExposureMemory_Crc32(const uint8_t *data_ptr,
+		size_t length) {
+	uint32_t crc = 0xFFFFFFFFUL;
+	size_t index = 0U;
+	uint32_t bit = 0U;
+
+	for (index = 0U; index < length; index++) {
+		crc ^= data_ptr[index];
+		for (bit = 0U; bit < 8U; bit++) {
+			crc = (crc >> 1U) ^ (0xEDB88320UL & (0UL - (crc & 1UL)));
+		}
+	}
+
+	return ~crc;
+}
+
+static uint32_t AppExposureMemory_ComputeCrc(
+		const AppExposureMemory_Table_t *table_ptr) {
+	return AppExposureMemory_Crc32((const uint8_t*) table_ptr,
+			offsetof(AppExposureMemory_Table_t, crc32));
+}
+
+/**
+ * @brief Parse @p count decimal digits, or return false on a non-digit.
+ */
+static bool AppExposureMemory_ParseDigits(const char *text_ptr, uint32_t count,
+		uint32_t *value_out) {
+	uint32_t value = 0U;
+	uint32_t index = 0U;
+
+	for (index = 0U; index < count; index++) {
+		const char ch = text_ptr[index];
+
+		if ((ch < '0') || (ch > '9')) {
+			return false;
+		}
+		value = (value * 10U) + (uint32_t) (ch - '0');
+	}
+
+	*value_out = value;
+	return true;
+}
+
+/**
+ * @brief Days since 1970-01-01 for a YYYYMMDD date (proleptic Gregorian).
+ */
+static int32_t AppExposureMemory_DayNumber(uint32_t date_code) {
+	int32_t year = (int32_t) (date_code / 10000U);
+	const int32_t month = (int32_t) ((date_code / 100U) % 100U);
+	const int32_t day = (int32_t) (date_code % 100U);
+	int32_t era = 0;
+	int32_t year_of_era = 0;
+	int32_t day_of_year = 0;
+
+	year -= (month <= 2) ? 1 : 0;
+	era = year / 400;
+	year_of_era = year - (era * 400);
+	day_of_year = ((153 * (month + ((month > 2) ? -3 : 9))) + 2) / 5 + day - 1;
+	return (era * 146097) + (year_of_era * 365) + (year_of_era / 4)
+			- (year_of_era / 100) + day_of_year - 719468;
+}
+
+/**
+ * @brief Check whether an entry is usable for a capture at @p time_ptr.
+ */
+static bool AppExposureMemory_IsFresh(const AppExposureMemory_Entry_t *entry_ptr,
+		const AppExposureMemory_Time_t *time_ptr, uint32_t max_age_days) {
+	int32_t age_days = 0;
+
+	if ((entry_ptr->date_code == 0U) || (entry_ptr->exposure_us == 0U)) {
+		return false;
+	}
+
+	age_days = AppExposureMemory_DayNumber(time_ptr->date_code)
+			- AppExposureMemory_DayNumber(entry_ptr->date_code);
+	return (age_days >= 0) && ((uint32_t) age_days <= max_age_days);
+}
+
+/**
+ * @brief Reset to an empty, sealed table.
+ */
+void AppExposureMemory_Init(AppExposureMemory_Table_t *table_ptr) {
+	if (table_ptr == NULL) {
+		return;
+	}
+
+	(void) memset(table_ptr, 0, sizeof(*table_ptr));
+	table_ptr->magic = APP_EXPOSURE_MEMORY_MAGIC;
+	table_ptr->bucket_count = APP_EXPOSURE_MEMORY_BUCKET_COUNT;
+	AppExposureMemory_Seal(table_ptr);
+}
+
+/**
+ * @brief Check magic, layout and CRC of a table read back from storage.
+ */
+bool AppExposureMemory_IsValid(const AppExposureMemory_Table_t *table_ptr) {
+	if (table_ptr == NULL) {
+		return false;
+	}
+
+	return (table_ptr->magic == APP_EXPOSURE_MEMORY_MAGIC)
+			&& (table_ptr->bucket_count == APP_EXPOSURE_MEMORY_BUCKET_COUNT)
+			&& (table_ptr->crc32 == AppExposureMemory_ComputeCrc(table_ptr));
+}
+
+/**
+ * @brief Recompute the CRC after editing entries.
+ */
+void AppExposureMemory_Seal(AppExposureMemory_Table_t *table_ptr) {
+	if (table_ptr == NULL) {
+		return;
+	}
+
+	table_ptr->crc32 = AppExposureMemory_ComputeCrc(table_ptr);
+}
+
+/**
+ * @brief Decode an RTC timestamp into a date code and minute of day.
+ */
+bool AppExposureMemory_ParseTimestamp(const char *text_ptr,
+		AppExposureMemory_Time_t *time_out) {
+	uint32_t year = 0U;
+	uint32_t month = 0U;
+	uint32_t day = 0U;
+	uint32_t hour = 0U;
+	uint32_t minute = 0U;
+
+	if ((text_ptr == NULL) || (time_out == NULL)
+			|| (strlen(text_ptr) < 16U)) {
+		return false;
+	}
+
+	if ((text_ptr[4] != '-') || (text_ptr[7] != '-')
+			|| ((text_ptr[10] != '_') && (text_ptr[10] != ' '))
+			|| ((text_ptr[13] != '-') && (text_ptr[13] != ':'))
+			|| !AppExposureMemory_ParseDigits(&text_ptr[0], 4U, &year)
+			|| !AppExposureMemory_ParseDigits(&text_ptr[5], 2U, &month)
+			|| !AppExposureMemory_ParseDigits(&text_ptr[8], 2U, &day)
+			|| !AppExposureMemory_ParseDigits(&text_ptr[11], 2U, &hour)
+			|| !AppExposureMemory_ParseDigits(&text_ptr[14], 2U, &minute)) {
+		return false;
+	}
+
+	if ((month < 1U) || (month > 12U) || (day < 1U) || (day > 31U)
+			|| (hour > 23U) || (minute > 59U)) {
+		return false;
+	}
+
+	time_out->date_code = (year * 10000U) + (month * 100U) + day;
+	time_out->minute_of_day = (hour * 60U) + minute;
+	return true;
+}
+
+/**
+ * @brief Find the remembered setting for this time of day.
+ */
+bool AppExposureMemory_Lookup(const AppExposureMemory_Table_t *table_ptr,
+		const AppExposureMemory_Time_t *time_ptr, uint32_t max_age_days,
+		uint32_t *exposure_us_out, int32_t *gain_mdb_out) {
+	const AppExposureMemory_Entry_t *candidates[3] = { NULL, NULL, NULL };
+	uint32_t bucket = 0U;
+	uint32_t offset_in_bucket = 0U;
+	uint32_t index = 0U;
+
+	if ((table_ptr == NULL) || (time_ptr == NULL) || (exposure_us_out == NULL)
+			|| (gain_mdb_out == NULL)
+			|| (time_ptr->minute_of_day >= 1440U)) {
+		return false;
+	}
+
+	bucket = time_ptr->minute_of_day / APP_EXPOSURE_MEMORY_BUCKET_MINUTES;
+	offset_in_bucket = time_ptr->minute_of_day % APP_EXPOSURE_MEMORY_BUCKET_MINUTES;
+
+	/* Own bucket first, then whichever neighbour the capture is closer to. */
+	candidates[0] = &table_ptr->entries[bucket];
+	if (offset_in_bucket < (APP_EXPOSURE_MEMORY_BUCKET_MINUTES / 2U)) {
+		candidates[1] = &table_ptr->entries[(bucket
+				+ APP_EXPOSURE_MEMORY_BUCKET_COUNT - 1U)
+				% APP_EXPOSURE_MEMORY_BUCKET_COUNT];
+		candidates[2] = &table_ptr->entries[(bucket + 1U)
+				% APP_EXPOSURE_MEMORY_BUCKET_COUNT];
+	} else {
+		candidates[1] = &table_ptr->entries[(bucket + 1U)
+				% APP_EXPOSURE_MEMORY_BUCKET_COUNT];
+		candidates[2] = &table_ptr->entries[(bucket
+				+ APP_EXPOSURE_MEMORY_BUCKET_COUNT - 1U)
+				% APP_EXPOSURE_MEMORY_BUCKET_COUNT];
+	}
+
+	for (index = 0U; index < 3U; index++) {
+		if (AppExposureMemory_IsFresh(candidates[index], time_ptr,
+				max_age_days)) {
+			*exposure_us_out = candidates[index]->exposure_us;
+			*gain_mdb_out = candidates[index]->gain_mdb;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @brief Remember the setting of an accepted frame in its bucket.
+ */
+bool AppExposureMemory_Store(AppExposureMemory_Table_t *table_ptr,
+		const AppExposureMemory_Time_t *time_ptr, uint32_t exposure_us,
+		int32_t gain_mdb) {
+	AppExposureMemory_Entry_t *entry_ptr = NULL;
+	uint32_t exposure_delta_us = 0U;
+	int32_t gain_delta_mdb = 0;
+	bool changed = false;
+
+	if ((table_ptr == NULL) || (time_ptr == NULL) || (exposure_us == 0U)
+			|| (time_ptr->minute_of_day >= 1440U)) {
+		return false;
+	}
+
+	entry_ptr = &table_ptr->entries[time_ptr->minute_of_day
+			/ APP_EXPOSURE_MEMORY_BUCKET_MINUTES];
+	exposure_delta_us = (exposure_us > entry_ptr->exposure_us) ?
+			(exposure_us - entry_ptr->exposure_us) :
+			(entry_ptr->exposure_us - exposure_us);
+	gain_delta_mdb = gain_mdb - entry_ptr->gain_mdb;
+	if (gain_delta_mdb < 0) {
+		gain_delta_mdb = -gain_delta_mdb;
+	}
+
+	changed = (entry_ptr->date_code != time_ptr->date_code)
+			|| ((exposure_delta_us * 100U)
+					> (entry_ptr->exposure_us
+							* APP_EXPOSURE_MEMORY_EXPOSURE_TOLERANCE_PERCENT))
+			|| (gain_delta_mdb > APP_EXPOSURE_MEMORY_GAIN_TOLERANCE_MDB);
+
+	/* Leave near-identical values alone so the RAM copy keeps matching the
+	 * persisted one; drift inside the tolerance is irrelevant for seeding and
+	 * comparing against the stored value stops it creeping past unsaved. */
+	if (!changed) {
+		return false;
+	}
+
+	entry_ptr->date_code = time_ptr->date_code;
+	entry_ptr->exposure_us = exposure_us;
+	entry_ptr->gain_mdb = gain_mdb;
+	AppExposureMemory_Seal(table_ptr);
+	return true;
+}
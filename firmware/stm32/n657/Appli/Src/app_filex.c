@@ -30,10 +30,18 @@
 #include <string.h>
 
 #include "app_azure_rtos_config.h"
+#include "app_boot.h"
+#include "app_frame_format.h"
+#include "app_inference_log_config.h"
 #include "app_memory_budget.h"
+#include "inference_metrics.h"
+#include "sd_card_profile.h"
+#include "sd_fat_format.h"
 #include "sd_spi_ll.h"
 #include "main.h"
 #include "app_threadx.h"
+#include "app_threadx_config.h"
+#include "app_low_power.h"
 #include "tx_api.h" /* ThreadX services like tx_thread_sleep. */
 #include "debug_console.h"
 #include "debug_led.h"
@@ -133,6 +141,8 @@ typedef enum {
 	APP_FILEX_STATE_SD_READ_OCR_CMD58,
 	APP_FILEX_STATE_SD_READ_PARTITION0_INFO,
 	APP_FILEX_STATE_FILEX_MEDIA_OPEN,
+	APP_FILEX_STATE_SD_CARD_PROFILE,
+	APP_FILEX_STATE_CARD_FORMAT,
 	APP_FILEX_STATE_LOG_SERVICE_INITIALIZE,
 	APP_FILEX_STATE_TEST_FILE_CREATE_OPEN_WRITE_CLOSE,
 	APP_FILEX_STATE_CAPTURE_DIRECTORY_CREATE,
@@ -191,12 +201,33 @@ typedef struct {
  * mode because they overwrite captures and hide the one-file-per-minute log. */
 #define APP_FILEX_PREPARE_CAPTURE_SLOTS      0U
 #define APP_FILEX_PREALLOCATE_CAPTURE_SLOTS   0U
-#define APP_FILEX_CAPTURE_FILE_FORMAT_COUNT   2U
+#define APP_FILEX_CAPTURE_FILE_FORMAT_COUNT   3U
 #define APP_FILEX_CAPTURE_RING_SLOT_COUNT     4U
 #define FILEX_SD_INIT_TIMEOUT_MS         60000U
 #define FILEX_SD_INIT_RETRY_DELAY_MS       250U
 #define FILEX_PARTITION_READ_RETRY_DELAY_MS   50U
 #define FILEX_PARTITION_READ_RETRY_TIMEOUT_MS 2000U
+/* Card write-geometry profile. The probe runs once per card and partition;
+ * later boots read the stored result. Alignment is capped so a 4 MiB AU does
+ * not push every small capture file onto its own erase block. */
+#define APP_FILEX_SD_CARD_PROFILE_FILE_NAME   "sd_card_profile.bin"
+#define APP_FILEX_SD_CARD_PROBE_FILE_NAME     "sd_probe.tmp"
+#define APP_FILEX_SD_CARD_PROBE_SECTORS       16U
+#define APP_FILEX_SD_CARD_PROBE_MIN_BOUNDARY  32U
+#define APP_FILEX_SD_CARD_PROBE_MAX_BOUNDARY  8192U
+#define APP_FILEX_SD_CARD_PROBE_REPEATS       3U
+#define APP_FILEX_SD_CARD_PROBE_PENALTY_PCT   50U
+#define APP_FILEX_SD_MAX_ALIGN_SECTORS        256U
+/* Opt-in reformat. Creating APP_FILEX_CARD_FORMAT_REQUEST_FILE_NAME in the
+ * root (from a PC or the host tool) reformats the card on the next boot with
+ * clusters and FATs placed from the card's AU. The file vanishes with the old
+ * volume, so the request runs once. */
+#define APP_FILEX_CARD_FORMAT_ON_REQUEST       1U
+#define APP_FILEX_CARD_FORMAT_REQUEST_FILE_NAME "format_card.req"
+#define APP_FILEX_CARD_FORMAT_DEFAULT_AU_SECTORS 8192U
+#define APP_FILEX_CARD_FORMAT_MAX_SLACK_PCT    35U
+#define APP_FILEX_CARD_FORMAT_CAPTURE_DIR_CLUSTERS   2U
+#define APP_FILEX_CARD_FORMAT_INFERENCE_DIR_CLUSTERS 1U
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -225,6 +256,9 @@ static ULONG g_captured_image_fallback_next_index = 0U;
 static bool g_captured_image_fallback_index_seeded = false;
 static ULONG g_capture_slot_next_index = 0U;
 static ULONG g_capture_media_last_flush_tick = 0U;
+/* Write geometry of the mounted card; align_sectors is 0 until known. */
+static SdCardProfile_Profile g_sd_card_profile;
+static uint8_t g_sd_card_probe_sector[512];
 
 typedef struct {
 	bool valid;
@@ -239,7 +273,8 @@ static ULONG g_capture_timestamp_queue_tail = 0U;
 static ULONG g_capture_timestamp_queue_count = 0U;
 typedef enum {
 	APP_FILEX_CAPTURE_FORMAT_YUV422 = 0U,
-	APP_FILEX_CAPTURE_FORMAT_RAW16 = 1U
+	APP_FILEX_CAPTURE_FORMAT_RAW16 = 1U,
+	APP_FILEX_CAPTURE_FORMAT_Y8 = 2U
 } AppFileX_CaptureFileFormat;
 
 typedef struct {
@@ -288,6 +323,15 @@ static const CHAR *AppFileX_GetCaptureFileExtension(
 		AppFileX_CaptureFileFormat format);
 static ULONG AppFileX_MillisecondsToTicks(uint32_t timeout_ms);
 static void AppFileX_LogStateMessage(const char *message);
+static void AppFileX_LoadOrProbeCardProfile(
+		const AppFileX_StateMachineContext *context_ptr);
+static int32_t AppFileX_ProbeWriteSectors(void *write_context, uint32_t lba,
+		uint32_t sector_count, uint32_t *elapsed_us_out);
+static uint32_t AppFileX_GetFirstDataLba(void);
+static int32_t AppFileX_RunCardProbe(SdCardProfile_Profile *profile_out);
+static bool AppFileX_IsCardFormatRequested(void);
+static int32_t AppFileX_FormatCard(
+		const AppFileX_StateMachineContext *context_ptr);
 /* USER CODE END PFP */
 
 /**
@@ -377,10 +421,30 @@ void fx_app_thread_entry(ULONG thread_input)
 	AppFileX_StateMachine_Initialize(&app_filex_context);
 
 	while (1) {
-		AppFileX_StateMachine_Step(&app_filex_context);
+		/* Bring-up talks to the card directly rather than through the media
+		 * driver, so hold SPI5 for those steps (including error retries). */
+		if (app_filex_context.state != APP_FILEX_STATE_RUNNING) {
+			const bool spi_held = AppLowPower_AcquireDomain(
+					APP_POWER_DOMAIN_SD_SPI);
+
+			AppFileX_StateMachine_Step(&app_filex_context);
+			if (spi_held) {
+				AppLowPower_ReleaseDomain(APP_POWER_DOMAIN_SD_SPI);
+			}
+		} else {
+			AppFileX_StateMachine_Step(&app_filex_context);
+		}
 
-		/* Always yield so we do not hog the CPU. */
-		tx_thread_sleep(1U);
+		/* Once mounted, only wake for queued log lines or the shared idle
+		 * grid; bring-up still steps every tick. Always yield so we do not
+		 * hog the CPU. */
+		if (app_filex_context.state == APP_FILEX_STATE_RUNNING) {
+			(void) SdDebugLogService_WaitForPending(
+					AppLowPower_CoalescedTimeoutTicks(
+							APP_LOW_POWER_COALESCE_MS));
+		} else {
+			tx_thread_sleep(1U);
+		}
 	}
 
 /* USER CODE END fx_app_thread_entry 1*/
@@ -708,7 +772,57 @@ static void AppFileX_StateMachine_Step(
 		AppFileX_LogTimingStep("media_open", media_open_tick);
 
 		context_ptr->last_progress_tick = tx_time_get();
-		context_ptr->state = APP_FILEX_STATE_LOG_SERVICE_INITIALIZE;
+		context_ptr->state = APP_FILEX_STATE_SD_CARD_PROFILE;
+		context_ptr->state_entry_tick = context_ptr->last_progress_tick;
+		break;
+	}
+
+	case APP_FILEX_STATE_SD_CARD_PROFILE: {
+		const ULONG card_profile_tick = tx_time_get();
+		AppFileX_LogStateMessage("[FILEX][STATE] CARD PROFILE\r\n");
+		/**
+		 * Learn the card's allocation-unit geometry so new files start on a
+		 * unit boundary. A failure only costs alignment, never the mount.
+		 */
+		AppFileX_LoadOrProbeCardProfile(context_ptr);
+		AppFileX_LogTimingStep("card_profile", card_profile_tick);
+
+		context_ptr->last_progress_tick = tx_time_get();
+		context_ptr->state = APP_FILEX_STATE_CARD_FORMAT;
+		context_ptr->state_entry_tick = context_ptr->last_progress_tick;
+		break;
+	}
+
+	case APP_FILEX_STATE_CARD_FORMAT: {
+		const ULONG card_format_tick = tx_time_get();
+		int32_t format_status = 0;
+
+		if (!AppFileX_IsCardFormatRequested()) {
+			context_ptr->last_progress_tick = tx_time_get();
+			context_ptr->state = APP_FILEX_STATE_LOG_SERVICE_INITIALIZE;
+			context_ptr->state_entry_tick = context_ptr->last_progress_tick;
+			break;
+		}
+
+		AppFileX_LogStateMessage("[FILEX][STATE] CARD FORMAT\r\n");
+		/**
+		 * Rewrite the volume underneath FileX, then mount it again; the
+		 * profile step re-probes because the stored profile went with the
+		 * old volume.
+		 */
+		(void) fx_media_close(&g_sd_fx_media);
+		context_ptr->filex_media_is_open = 0U;
+
+		format_status = AppFileX_FormatCard(context_ptr);
+		if (format_status != 0) {
+			AppFileX_StateMachine_EnterError(context_ptr,
+					APP_FILEX_STATE_CARD_FORMAT, (UINT) (-format_status));
+			break;
+		}
+		AppFileX_LogTimingStep("card_format", card_format_tick);
+
+		context_ptr->last_progress_tick = tx_time_get();
+		context_ptr->state = APP_FILEX_STATE_FILEX_MEDIA_OPEN;
 		context_ptr->state_entry_tick = context_ptr->last_progress_tick;
 		break;
 	}
@@ -869,6 +983,7 @@ static void AppFileX_StateMachine_Step(
 
 		g_filex_media_ready = true;
 		AppStorage_NotifyMediaReady();
+		AppBoot_CompleteExternal(APP_BOOT_TASK_SD_MOUNT, true);
 		(void) DebugConsole_WriteString("[FILEX] media ready\r\n");
 
 		context_ptr->last_progress_tick = tx_time_get();
@@ -911,6 +1026,7 @@ static void AppFileX_StateMachine_Step(
 
 		g_sd_filex_driver_context.is_initialized = 0U;
 		g_filex_media_ready = false;
+		g_sd_card_profile.align_sectors = 0U;
 
 		/* Restart the module from the beginning. */
 		AppFileX_StateMachine_Initialize(context_ptr);
@@ -984,6 +1100,31 @@ void AppFileX_ReleaseMediaLock(void) {
 	AppFileX_UnlockMedia();
 }
 
+/*==============================================================================
+ * Function: AppFileX_AlignNextAllocationLocked
+ *
+ * Purpose:
+ *   Point the FileX free-cluster search at the next cluster that starts on a
+ *   card allocation unit, so a new file's data does not straddle one.
+ *
+ * Notes:
+ *   Call with the media lock held, right before the first write to an empty
+ *   file. Clusters skipped over stay free and are reused once the search
+ *   wraps; if the aligned cluster is taken FileX simply moves on from it.
+ *==============================================================================*/
+void AppFileX_AlignNextAllocationLocked(void) {
+	if (g_sd_card_profile.align_sectors == 0U) {
+		return;
+	}
+
+	g_sd_fx_media.fx_media_cluster_search_start =
+			SdCardProfile_NextAlignedCluster(AppFileX_GetFirstDataLba(),
+					g_sd_fx_media.fx_media_sectors_per_cluster,
+					g_sd_fx_media.fx_media_total_clusters,
+					g_sd_fx_media.fx_media_cluster_search_start,
+					g_sd_card_profile.align_sectors);
+}
+
 /*==============================================================================*/
 UINT AppFileX_PrepareCaptureSlots(void) {
 	UINT status = TX_SUCCESS;
@@ -1011,11 +1152,23 @@ static const CHAR *AppFileX_GetCaptureFileExtension(
 		return "yuv422";
 	case APP_FILEX_CAPTURE_FORMAT_RAW16:
 		return "raw16";
+	case APP_FILEX_CAPTURE_FORMAT_Y8:
+		return "y8";
 	default:
 		return NULL;
 	}
 }
 
+/*==============================================================================*/
+static ULONG AppFileX_GetCaptureFileBytes(AppFileX_CaptureFileFormat format) {
+	if (format == APP_FILEX_CAPTURE_FORMAT_Y8) {
+		return (ULONG) AppFrameFormat_FrameBytes(APP_FRAME_FORMAT_Y8,
+				CAMERA_CAPTURE_WIDTH_PIXELS, CAMERA_CAPTURE_HEIGHT_PIXELS);
+	}
+
+	return CAMERA_CAPTURE_BUFFER_SIZE_BYTES;
+}
+
 /*==============================================================================*/
 static bool AppFileX_ParseCaptureSlotName(const CHAR *file_name_ptr,
 		ULONG *slot_index_ptr, AppFileX_CaptureFileFormat *format_ptr) {
@@ -1053,6 +1206,8 @@ static bool AppFileX_ParseCaptureSlotName(const CHAR *file_name_ptr,
 		*format_ptr = APP_FILEX_CAPTURE_FORMAT_YUV422;
 	} else if (strcmp(extension_ptr, "raw16") == 0) {
 		*format_ptr = APP_FILEX_CAPTURE_FORMAT_RAW16;
+	} else if (strcmp(extension_ptr, "y8") == 0) {
+		*format_ptr = APP_FILEX_CAPTURE_FORMAT_Y8;
 	} else {
 		return false;
 	}
@@ -1353,7 +1508,8 @@ static UINT AppFileX_CloseCaptureSlotsLocked(void) {
 /*==============================================================================*/
 static UINT AppFileX_PrepareCaptureSlotsLocked(void) {
 	static const AppFileX_CaptureFileFormat capture_formats[] = {
-			APP_FILEX_CAPTURE_FORMAT_YUV422, APP_FILEX_CAPTURE_FORMAT_RAW16 };
+			APP_FILEX_CAPTURE_FORMAT_YUV422, APP_FILEX_CAPTURE_FORMAT_RAW16,
+			APP_FILEX_CAPTURE_FORMAT_Y8 };
 	static const size_t capture_format_count =
 			sizeof(capture_formats) / sizeof(capture_formats[0]);
 	UINT status = FX_SUCCESS;
@@ -1407,7 +1563,7 @@ static UINT AppFileX_PrepareCaptureSlotsLocked(void) {
 
 			if (APP_FILEX_PREALLOCATE_CAPTURE_SLOTS != 0U) {
 				status = fx_file_allocate(capture_file_ptr,
-						CAMERA_CAPTURE_BUFFER_SIZE_BYTES);
+						AppFileX_GetCaptureFileBytes(format));
 				if (status != FX_SUCCESS) {
 					DebugConsole_Printf(
 							"[FILEX][CAPTURE] Preallocate %s returned status=%lu; continuing with open handle.\r\n",
@@ -1824,6 +1980,10 @@ UINT AppFileX_WriteCapturedImage(const CHAR *file_name_ptr,
 					1000U) / (ULONG)TX_TIMER_TICKS_PER_SECOND),
 				path);
 
+		if (capture_fx_file.fx_file_current_file_size == 0U) {
+			AppFileX_AlignNextAllocationLocked();
+		}
+
 		const ULONG fallback_write_start_tick = tx_time_get();
 		file_status = fx_file_write(&capture_fx_file, (VOID*) data_ptr,
 				data_length);
@@ -1909,6 +2069,319 @@ static void AppFileX_UnlockMedia(void) {
 	(void) tx_mutex_put(&g_filex_media_mutex);
 }
 
+/*==============================================================================
+ * Function: AppFileX_GetFirstDataLba
+ *
+ * Purpose:
+ *   Physical card LBA of FAT cluster 2.
+ *==============================================================================*/
+static uint32_t AppFileX_GetFirstDataLba(void) {
+	return g_sd_filex_driver_context.partition_start_lba
+			+ (uint32_t) g_sd_fx_media.fx_media_data_sector_start;
+}
+
+/*==============================================================================
+ * Function: AppFileX_ProbeWriteSectors
+ *
+ * Purpose:
+ *   Timed raw write for the card probe. CMD24 returns only once the card is
+ *   no longer busy, so the time includes any erase stall.
+ *==============================================================================*/
+static int32_t AppFileX_ProbeWriteSectors(void *write_context, uint32_t lba,
+		uint32_t sector_count, uint32_t *elapsed_us_out) {
+	const uint64_t start_us = Metrics_GetMicros();
+	(void) write_context;
+
+	for (uint32_t sector = 0U; sector < sector_count; sector++) {
+		if (SPI_WriteSingleBlock512(lba + sector, g_sd_card_probe_sector)
+				!= 0x00U) {
+			return -1;
+		}
+	}
+
+	*elapsed_us_out = (uint32_t) (Metrics_GetMicros() - start_us);
+	return 0;
+}
+
+/*==============================================================================
+ * Function: AppFileX_RunCardProbe
+ *
+ * Purpose:
+ *   Run the write-latency probe inside a temporary file, so the scratch
+ *   writes only ever land on clusters FileX has handed to the probe.
+ *
+ * Returns:
+ *   SdCardProfile_Probe status, or -2 if the scratch file could not be set up
+ *   (for example no free run of clusters long enough on a full card).
+ *==============================================================================*/
+static int32_t AppFileX_RunCardProbe(SdCardProfile_Profile *profile_out) {
+	const uint32_t boundary_sectors = APP_FILEX_SD_CARD_PROBE_MAX_BOUNDARY;
+	SdCardProfile_ProbeConfig config;
+	FX_FILE probe_file;
+	uint32_t file_lba = 0U;
+	int32_t probe_status = -2;
+	UINT fx_status = FX_SUCCESS;
+
+	if (g_sd_fx_media.fx_media_bytes_per_sector
+			!= sizeof(g_sd_card_probe_sector)) {
+		return -2;
+	}
+
+	/* A reset mid-probe leaves the scratch file behind. */
+	(void) fx_file_delete(&g_sd_fx_media, APP_FILEX_SD_CARD_PROBE_FILE_NAME);
+	fx_status = fx_file_create(&g_sd_fx_media,
+			APP_FILEX_SD_CARD_PROBE_FILE_NAME);
+	if (fx_status != FX_SUCCESS) {
+		return -2;
+	}
+	fx_status = fx_file_open(&g_sd_fx_media, &probe_file,
+			APP_FILEX_SD_CARD_PROBE_FILE_NAME, FX_OPEN_FOR_WRITE);
+	if (fx_status != FX_SUCCESS) {
+		(void) fx_file_delete(&g_sd_fx_media,
+				APP_FILEX_SD_CARD_PROBE_FILE_NAME);
+		return -2;
+	}
+
+	/* fx_file_allocate only hands out consecutive clusters, so two largest
+	 * boundaries plus a probe write always contain an aligned window. */
+	fx_status = fx_file_allocate(&probe_file,
+			(ULONG) ((2U * boundary_sectors) + APP_FILEX_SD_CARD_PROBE_SECTORS)
+					* sizeof(g_sd_card_probe_sector));
+	if (fx_status == FX_SUCCESS) {
+		file_lba = AppFileX_GetFirstDataLba()
+				+ ((probe_file.fx_file_first_physical_cluster - 2U)
+						* g_sd_fx_media.fx_media_sectors_per_cluster);
+
+		config.window_start_lba = ((file_lba + boundary_sectors - 1U)
+				/ boundary_sectors) * boundary_sectors;
+		config.window_sectors = boundary_sectors
+				+ APP_FILEX_SD_CARD_PROBE_SECTORS;
+		config.probe_sectors = APP_FILEX_SD_CARD_PROBE_SECTORS;
+		config.min_boundary_sectors = APP_FILEX_SD_CARD_PROBE_MIN_BOUNDARY;
+		config.max_boundary_sectors = boundary_sectors;
+		config.repeats = APP_FILEX_SD_CARD_PROBE_REPEATS;
+		config.penalty_percent = APP_FILEX_SD_CARD_PROBE_PENALTY_PCT;
+
+		(void) memset(g_sd_card_probe_sector, 0xA5,
+				sizeof(g_sd_card_probe_sector));
+		probe_status = SdCardProfile_Probe(AppFileX_ProbeWriteSectors, NULL,
+				&config, profile_out);
+	}
+
+	(void) fx_file_close(&probe_file);
+	(void) fx_file_delete(&g_sd_fx_media, APP_FILEX_SD_CARD_PROBE_FILE_NAME);
+	return probe_status;
+}
+
+/*==============================================================================
+ * Function: AppFileX_LoadOrProbeCardProfile
+ *
+ * Purpose:
+ *   Use the stored card profile when it matches the mounted partition;
+ *   otherwise read the SD status AU, probe the card and store the result.
+ *
+ * Notes:
+ *   A failed probe still aligns to the SD status AU for this boot but is not
+ *   stored, so the next boot probes again.
+ *==============================================================================*/
+static void AppFileX_LoadOrProbeCardProfile(
+		const AppFileX_StateMachineContext *context_ptr) {
+	SdCardProfile_Profile profile;
+	SdCardProfile_SdStatus sd_status;
+	uint8_t sd_status_block[SD_CARD_PROFILE_SD_STATUS_BYTES] = { 0U };
+	FX_FILE profile_file;
+	ULONG bytes_read = 0U;
+	int32_t probe_status = -2;
+	UINT fx_status = FX_SUCCESS;
+
+	(void) memset(&profile, 0, sizeof(profile));
+	(void) memset(&sd_status, 0, sizeof(sd_status));
+	g_sd_card_profile.align_sectors = 0U;
+
+	fx_status = fx_file_open(&g_sd_fx_media, &profile_file,
+			APP_FILEX_SD_CARD_PROFILE_FILE_NAME, FX_OPEN_FOR_READ);
+	if (fx_status == FX_SUCCESS) {
+		fx_status = fx_file_read(&profile_file, &profile, sizeof(profile),
+				&bytes_read);
+		(void) fx_file_close(&profile_file);
+		if ((fx_status == FX_SUCCESS) && (bytes_read == sizeof(profile))
+				&& (SdCardProfile_IsValid(&profile,
+						context_ptr->partition_start_lba,
+						context_ptr->partition_sector_count) != 0U)) {
+			g_sd_card_profile = profile;
+			DebugConsole_Printf(
+					"[FILEX][CARD] profile loaded au=%lu boundary=%lu align=%lu sectors\r\n",
+					(unsigned long) profile.au_sectors,
+					(unsigned long) profile.boundary_sectors,
+					(unsigned long) profile.align_sectors);
+			return;
+		}
+		(void) memset(&profile, 0, sizeof(profile));
+	}
+
+	if (SPI_SendACMD13_ReadSdStatus(sd_status_block) == 0x00U) {
+		(void) SdCardProfile_ParseSdStatus(sd_status_block, &sd_status);
+	}
+
+	probe_status = AppFileX_RunCardProbe(&profile);
+	if (probe_status != 0) {
+		(void) memset(&profile, 0, sizeof(profile));
+	}
+
+	profile.magic = SD_CARD_PROFILE_MAGIC;
+	profile.version = SD_CARD_PROFILE_VERSION;
+	profile.partition_start_lba = context_ptr->partition_start_lba;
+	profile.partition_sector_count = context_ptr->partition_sector_count;
+	profile.au_sectors = sd_status.au_sectors;
+	profile.align_sectors = SdCardProfile_ChooseAlignSectors(
+			profile.boundary_sectors, profile.au_sectors,
+			APP_FILEX_SD_MAX_ALIGN_SECTORS);
+	g_sd_card_profile = profile;
+
+	DebugConsole_Printf(
+			"[FILEX][CARD] probe=%ld au=%lu boundary=%lu baseline=%lu us align=%lu sectors\r\n",
+			(long) probe_status, (unsigned long) profile.au_sectors,
+			(unsigned long) profile.boundary_sectors,
+			(unsigned long) profile.baseline_us,
+			(unsigned long) profile.align_sectors);
+
+	if (probe_status != 0) {
+		return;
+	}
+
+	(void) fx_file_delete(&g_sd_fx_media, APP_FILEX_SD_CARD_PROFILE_FILE_NAME);
+	fx_status = fx_file_create(&g_sd_fx_media,
+			APP_FILEX_SD_CARD_PROFILE_FILE_NAME);
+	if (fx_status == FX_SUCCESS) {
+		fx_status = fx_file_open(&g_sd_fx_media, &profile_file,
+				APP_FILEX_SD_CARD_PROFILE_FILE_NAME, FX_OPEN_FOR_WRITE);
+	}
+	if (fx_status == FX_SUCCESS) {
+		fx_status = fx_file_write(&profile_file, &profile, sizeof(profile));
+		(void) fx_file_close(&profile_file);
+	}
+	(void) fx_media_flush(&g_sd_fx_media);
+	if (fx_status != FX_SUCCESS) {
+		DebugConsole_Printf(
+				"[FILEX][CARD] profile not stored, status=%lu\r\n",
+				(unsigned long) fx_status);
+	}
+}
+
+/*==============================================================================
+ * Function: AppFileX_IsCardFormatRequested
+ *
+ * Purpose:
+ *   Report whether the root holds the reformat request file.
+ *==============================================================================*/
+static bool AppFileX_IsCardFormatRequested(void) {
+#if APP_FILEX_CARD_FORMAT_ON_REQUEST
+	UINT file_attributes = 0U;
+
+	return fx_file_attributes_read(&g_sd_fx_media,
+			APP_FILEX_CARD_FORMAT_REQUEST_FILE_NAME, &file_attributes)
+			== FX_SUCCESS;
+#else
+	return false;
+#endif
+}
+
+/*==============================================================================
+ * Function: AppFileX_FormatWriteSector
+ *
+ * Purpose:
+ *   SdFatFormat sector writer: partition-relative sector to card LBA.
+ *==============================================================================*/
+static int32_t AppFileX_FormatWriteSector(void *write_context,
+		uint32_t sector, const uint8_t data[SD_FAT_FORMAT_SECTOR_BYTES]) {
+	const AppFileX_StateMachineContext *context_ptr =
+			(const AppFileX_StateMachineContext*) write_context;
+
+	return (SPI_WriteSingleBlock512(context_ptr->partition_start_lba + sector,
+			data) == 0x00U) ? 0 : -1;
+}
+
+/*==============================================================================
+ * Function: AppFileX_FormatCard
+ *
+ * Purpose:
+ *   Reformat partition 0 as FAT32 laid out for the capture workload, with
+ *   contiguous extents for the capture and inference directories.
+ *
+ * Notes:
+ *   The layout aligns to the SD status AU when the card reports one, else to
+ *   the probed write boundary, else to 4 MiB, which is the AU of most
+ *   SDHC/SDXC cards. Media must be closed.
+ *
+ * Returns:
+ *   0 on success, or the SdFatFormat error code.
+ *==============================================================================*/
+static int32_t AppFileX_FormatCard(
+		const AppFileX_StateMachineContext *context_ptr) {
+	const SdFatFormat_Directory directories[] = { {
+			CAPTURED_IMAGES_DIRECTORY_NAME,
+			APP_FILEX_CARD_FORMAT_CAPTURE_DIR_CLUSTERS }, {
+			INFERENCE_LOG_DIRECTORY_NAME,
+			APP_FILEX_CARD_FORMAT_INFERENCE_DIR_CLUSTERS } };
+	SdFatFormat_Config config;
+	SdFatFormat_Layout layout;
+	UINT year = 0U;
+	UINT month = 0U;
+	UINT day = 0U;
+	UINT hour = 0U;
+	UINT minute = 0U;
+	UINT second = 0U;
+	uint32_t dos_date_time = 0U;
+	int32_t status = 0;
+
+	(void) memset(&config, 0, sizeof(config));
+	config.partition_start_lba = context_ptr->partition_start_lba;
+	config.partition_sectors = context_ptr->partition_sector_count;
+	config.align_sectors = APP_FILEX_CARD_FORMAT_DEFAULT_AU_SECTORS;
+	if ((g_sd_card_profile.au_sectors != 0U)
+			&& ((g_sd_card_profile.au_sectors
+					& (g_sd_card_profile.au_sectors - 1U)) == 0U)) {
+		config.align_sectors = g_sd_card_profile.au_sectors;
+	} else if (g_sd_card_profile.boundary_sectors != 0U) {
+		config.align_sectors = g_sd_card_profile.boundary_sectors;
+	}
+	if (config.align_sectors > SD_FAT_FORMAT_MAX_ALIGN_SECTORS) {
+		config.align_sectors = SD_FAT_FORMAT_MAX_ALIGN_SECTORS;
+	}
+	config.file_bytes = CAMERA_CAPTURE_BUFFER_SIZE_BYTES;
+	config.max_slack_percent = APP_FILEX_CARD_FORMAT_MAX_SLACK_PCT;
+
+	status = SdFatFormat_PlanLayout(&config, &layout);
+	if (status != 0) {
+		DebugConsole_Printf("[FILEX][FORMAT] no layout, status=%ld\r\n",
+				(long) status);
+		return status;
+	}
+
+	(void) fx_system_date_get(&year, &month, &day);
+	(void) fx_system_time_get(&hour, &minute, &second);
+	dos_date_time = ((uint32_t) (((year - 1980U) << 9U) | (month << 5U) | day)
+			<< 16U) | ((hour << 11U) | (minute << 5U) | (second / 2U));
+
+	DebugConsole_Printf(
+			"[FILEX][FORMAT] align=%lu spc=%lu reserved=%lu fat=%lu clusters=%lu\r\n",
+			(unsigned long) layout.align_sectors,
+			(unsigned long) layout.sectors_per_cluster,
+			(unsigned long) layout.reserved_sectors,
+			(unsigned long) layout.sectors_per_fat,
+			(unsigned long) layout.cluster_count);
+
+	status = SdFatFormat_Write(&layout, directories,
+			(uint32_t) (sizeof(directories) / sizeof(directories[0])),
+			(uint32_t) tx_time_get() ^ context_ptr->partition_sector_count,
+			dos_date_time, AppFileX_FormatWriteSector, (void*) context_ptr);
+	if (status != 0) {
+		DebugConsole_Printf("[FILEX][FORMAT] write failed, status=%ld\r\n",
+				(long) status);
+	}
+	return status;
+}
+
 /*==============================================================================
  * Function: AppFileX_CreateCapturedImagesDirectoryLocked
  *==============================================================================*/
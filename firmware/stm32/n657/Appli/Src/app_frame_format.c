@@ -0,0 +1,130 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_frame_format.c
+ * @brief   Pixel layout of captured frames (packed YUV422 or luma-only Y8).
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#include "app_frame_format.h"
+
+#include <string.h>
+
+/**
+ * @brief Bytes per pixel of a layout.
+ */
+uint32_t AppFrameFormat_BytesPerPixel(AppFrameFormat_t format) {
+	return (format == APP_FRAME_FORMAT_Y8) ? 1U : 2U;
+}
+
+/**
+ * @brief Bytes in one full frame of a layout.
+ */
+size_t AppFrameFormat_FrameBytes(AppFrameFormat_t format, size_t width_pixels,
+		size_t height_pixels) {
+	return width_pixels * height_pixels
+			* (size_t) AppFrameFormat_BytesPerPixel(format);
+}
+
+/**
+ * @brief Infer the layout of a frame from its length.
+ */
+bool AppFrameFormat_FromLength(size_t width_pixels, size_t height_pixels,
+		size_t length_bytes, AppFrameFormat_t *format_out) {
+	if ((format_out == NULL) || (width_pixels == 0U) || (height_pixels == 0U)) {
+		return false;
+	}
+
+	if (length_bytes >= AppFrameFormat_FrameBytes(APP_FRAME_FORMAT_YUV422,
+			width_pixels, height_pixels)) {
+		*format_out = APP_FRAME_FORMAT_YUV422;
+		return true;
+	}
+
+	if (length_bytes >= AppFrameFormat_FrameBytes(APP_FRAME_FORMAT_Y8,
+			width_pixels, height_pixels)) {
+		*format_out = APP_FRAME_FORMAT_Y8;
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ * @brief Byte offset of the luma sample for pixel (x, y).
+ */
+size_t AppFrameFormat_LumaOffset(AppFrameFormat_t format, size_t width_pixels,
+		size_t x, size_t y) {
+	if (format == APP_FRAME_FORMAT_Y8) {
+		return (y * width_pixels) + x;
+	}
+
+	/* Y0 U Y1 V: even pixels at the pair start, odd pixels two bytes on. */
+	return (((y * width_pixels) + (x & ~(size_t) 1U)) * 2U)
+			+ (((x & 1U) != 0U) ? 2U : 0U);
+}
+
+/**
+ * @brief SD archive extension, without the dot.
+ */
+const char *AppFrameFormat_FileExtension(AppFrameFormat_t format) {
+	return (format == APP_FRAME_FORMAT_Y8) ? "y8" : "yuv422";
+}
+
+/**
+ * @brief Parse a deployment selection such as "y8" or "yuv422".
+ */
+bool AppFrameFormat_Parse(const char *text_ptr, size_t length,
+		AppFrameFormat_t *format_out) {
+	static const struct {
+		const char *name;
+		AppFrameFormat_t format;
+	} names[] = {
+		{ "y8", APP_FRAME_FORMAT_Y8 },
+		{ "yuv422", APP_FRAME_FORMAT_YUV422 },
+	};
+	size_t start = 0U;
+	size_t end = length;
+	size_t index = 0U;
+
+	if ((text_ptr == NULL) || (format_out == NULL)) {
+		return false;
+	}
+
+	while ((start < end) && ((text_ptr[start] == ' ')
+			|| (text_ptr[start] == '\t') || (text_ptr[start] == '\r')
+			|| (text_ptr[start] == '\n'))) {
+		start++;
+	}
+	while ((end > start) && ((text_ptr[end - 1U] == ' ')
+			|| (text_ptr[end - 1U] == '\t') || (text_ptr[end - 1U] == '\r')
+			|| (text_ptr[end - 1U] == '\n') || (text_ptr[end - 1U] == '\0'))) {
+		end--;
+	}
+
+	for (index = 0U; index < (sizeof(names) / sizeof(names[0])); index++) {
+		const size_t name_length = strlen(names[index].name);
+		size_t offset = 0U;
+
+		if (name_length != (end - start)) {
+			continue;
+		}
+		for (offset = 0U; offset < name_length; offset++) {
+			char ch = text_ptr[start + offset];
+
+			if ((ch >= 'A') && (ch <= 'Z')) {
+				ch = (char) (ch - 'A' + 'a');
+			}
+			if (ch != names[index].name[offset]) {
+				break;
+			}
+		}
+		if (offset == name_length) {
+			*format_out = names[index].format;
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,340 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_frame_ingest.c
+ * @brief   One-pass summary of an accepted capture for every frame consumer.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#include "app_frame_ingest.h"
+
+#include <string.h>
+
+#define APP_FRAME_INGEST_FNV64_OFFSET  0xCBF29CE484222325ULL
+#define APP_FRAME_INGEST_FNV64_PRIME   0x00000100000001B3ULL
+
+/**
+ * @brief Fold one 32-bit word into the running FNV-1a hash.
+ */
+static inline uint64_t AppFrameIngest_HashWord(uint64_t hash, uint32_t word) {
+	return (hash ^ (uint64_t) word) * APP_FRAME_INGEST_FNV64_PRIME;
+}
+
+/**
+ * @brief Count the non-zero bytes of a 32-bit word without a branch per byte.
+ */
+static inline uint32_t AppFrameIngest_NonZeroBytes(uint32_t word) {
+	const uint32_t high = (((word & 0x7F7F7F7FU) + 0x7F7F7F7FU) | word)
+			& 0x80808080U;
+
+	return ((high >> 7U) * 0x01010101U) >> 24U;
+}
+
+static inline uint32_t AppFrameIngest_LoadWord(const uint8_t *bytes) {
+	return (uint32_t) bytes[0] | ((uint32_t) bytes[1] << 8U)
+			| ((uint32_t) bytes[2] << 16U) | ((uint32_t) bytes[3] << 24U);
+}
+
+/**
+ * @brief Content hash the ingest pass records, computed on its own.
+ */
+uint64_t AppFrameIngest_Hash(const uint8_t *bytes, size_t length_bytes) {
+	uint64_t hash = APP_FRAME_INGEST_FNV64_OFFSET;
+	size_t index = 0U;
+
+	if (bytes == NULL) {
+		return hash;
+	}
+	for (; (index + 4U) <= length_bytes; index += 4U) {
+		hash = AppFrameIngest_HashWord(hash, AppFrameIngest_LoadWord(&bytes[index]));
+	}
+	for (; index < length_bytes; index++) {
+		hash = AppFrameIngest_HashWord(hash, bytes[index]);
+	}
+	return hash;
+}
+
+/**
+ * @brief True when the descriptor summarizes exactly this buffer.
+ */
+bool AppFrameIngest_Describes(const AppFrameIngest_Descriptor_t *descriptor_ptr,
+		const uint8_t *frame_ptr, size_t length_bytes) {
+	return (descriptor_ptr != NULL) && descriptor_ptr->valid
+			&& (frame_ptr != NULL) && (descriptor_ptr->frame_ptr == frame_ptr)
+			&& ((size_t) descriptor_ptr->length_bytes == length_bytes);
+}
+
+/**
+ * @brief Add the brightness-profile samples of one row already in cache.
+ */
+static void AppFrameIngest_SampleCropRow(const uint8_t *row_ptr,
+		uint32_t bytes_per_pixel, AppFrameIngest_Descriptor_t *d) {
+	for (uint32_t x = d->crop.crop_x_min; x < d->crop.crop_x_end;
+			x += d->crop.crop_step) {
+		const uint8_t luma = row_ptr[x * bytes_per_pixel];
+
+		d->crop_luma_sum += luma;
+		d->crop_sample_count++;
+		if (luma >= d->crop.crop_bright_level) {
+			d->crop_bright_count++;
+		}
+	}
+}
+
+/**
+ * @brief Emit one thumbnail row from the column accumulators and clear them.
+ */
+static void AppFrameIngest_FinishThumbnailRow(uint32_t *block_sums,
+		uint32_t thumbnail_row, AppFrameIngest_Descriptor_t *d) {
+	const uint32_t block_pixels = APP_FRAME_INGEST_THUMBNAIL_BLOCK
+			* APP_FRAME_INGEST_THUMBNAIL_BLOCK;
+	uint8_t *const out = &d->thumbnail[thumbnail_row * d->thumbnail_width];
+
+	for (uint32_t tx = 0U; tx < d->thumbnail_width; tx++) {
+		out[tx] = (uint8_t) ((block_sums[tx] + (block_pixels / 2U))
+				/ block_pixels);
+		block_sums[tx] = 0U;
+	}
+}
+
+/**
+ * @brief Walk one YUV422 row (Y0 U Y1 V words) into the descriptor.
+ *
+ * Running values live in locals for the whole row, so the histogram stores
+ * do not force them back through the descriptor on every pixel pair. Each
+ * thumbnail block of eight pixels is summed locally and stored once.
+ */
+static uint64_t AppFrameIngest_Yuv422Row(const uint8_t *row,
+		uint32_t width_pixels, bool hash_row, uint64_t hash,
+		uint32_t *block_sums, uint32_t block_count,
+		AppFrameIngest_Descriptor_t *d) {
+	uint32_t *const histogram = d->luma_histogram;
+	const uint32_t pairs = width_pixels / 2U;
+	const uint32_t pairs_per_block = APP_FRAME_INGEST_THUMBNAIL_BLOCK / 2U;
+	uint32_t row_luma = 0U;
+	uint32_t row_u = 0U;
+	uint32_t row_v = 0U;
+	uint32_t nonzero = 0U;
+	uint32_t min_u = d->min_u;
+	uint32_t max_u = d->max_u;
+	uint32_t min_v = d->min_v;
+	uint32_t max_v = d->max_v;
+	uint32_t pair = 0U;
+
+	while (pair < pairs) {
+		const uint32_t block_end = ((pair + pairs_per_block) <= pairs) ?
+				(pair + pairs_per_block) : pairs;
+		const uint32_t block_index = pair / pairs_per_block;
+		uint32_t block_luma = 0U;
+
+		for (; pair < block_end; pair++) {
+			const uint32_t word = AppFrameIngest_LoadWord(&row[pair * 4U]);
+			const uint32_t y0 = word & 0xFFU;
+			const uint32_t u = (word >> 8U) & 0xFFU;
+			const uint32_t y1 = (word >> 16U) & 0xFFU;
+			const uint32_t v = word >> 24U;
+
+			if (hash_row) {
+				hash = AppFrameIngest_HashWord(hash, word);
+			}
+			nonzero += AppFrameIngest_NonZeroBytes(word);
+			histogram[y0]++;
+			histogram[y1]++;
+			block_luma += (uint32_t) y0 + y1;
+			row_u += u;
+			row_v += v;
+			min_u = (u < min_u) ? u : min_u;
+			max_u = (u > max_u) ? u : max_u;
+			min_v = (v < min_v) ? v : min_v;
+			max_v = (v > max_v) ? v : max_v;
+		}
+		row_luma += block_luma;
+		if (block_index < block_count) {
+			block_sums[block_index] += block_luma;
+		}
+	}
+
+	d->nonzero_bytes += nonzero;
+	d->luma_sum += row_luma;
+	d->u_sum += row_u;
+	d->v_sum += row_v;
+	d->chroma_pair_count += pairs;
+	d->min_u = (uint8_t) min_u;
+	d->max_u = (uint8_t) max_u;
+	d->min_v = (uint8_t) min_v;
+	d->max_v = (uint8_t) max_v;
+	return hash;
+}
+
+/**
+ * @brief Walk one Y8 row, four pixels per word, into the descriptor.
+ */
+static uint64_t AppFrameIngest_Y8Row(const uint8_t *row,
+		uint32_t width_pixels, bool hash_row, uint64_t hash,
+		uint32_t *block_sums, uint32_t block_count,
+		AppFrameIngest_Descriptor_t *d) {
+	uint32_t *const histogram = d->luma_histogram;
+	const uint32_t quads = width_pixels / 4U;
+	const uint32_t quads_per_block = APP_FRAME_INGEST_THUMBNAIL_BLOCK / 4U;
+	uint32_t row_luma = 0U;
+	uint32_t nonzero = 0U;
+	uint32_t quad = 0U;
+
+	while (quad < quads) {
+		const uint32_t block_end = ((quad + quads_per_block) <= quads) ?
+				(quad + quads_per_block) : quads;
+		const uint32_t block_index = quad / quads_per_block;
+		uint32_t block_luma = 0U;
+
+		for (; quad < block_end; quad++) {
+			const uint32_t word = AppFrameIngest_LoadWord(&row[quad * 4U]);
+			const uint8_t y0 = (uint8_t) word;
+			const uint8_t y1 = (uint8_t) (word >> 8U);
+			const uint8_t y2 = (uint8_t) (word >> 16U);
+			const uint8_t y3 = (uint8_t) (word >> 24U);
+
+			if (hash_row) {
+				hash = AppFrameIngest_HashWord(hash, word);
+			}
+			nonzero += AppFrameIngest_NonZeroBytes(word);
+			histogram[y0]++;
+			histogram[y1]++;
+			histogram[y2]++;
+			histogram[y3]++;
+			block_luma += (uint32_t) y0 + y1 + y2 + y3;
+		}
+		row_luma += block_luma;
+		if (block_index < block_count) {
+			block_sums[block_index] += block_luma;
+		}
+	}
+	/* Widths that are not a multiple of four. */
+	for (uint32_t x = quads * 4U; x < width_pixels; x++) {
+		const uint8_t luma = row[x];
+		const uint32_t block_index = x / APP_FRAME_INGEST_THUMBNAIL_BLOCK;
+
+		nonzero += (luma != 0U) ? 1U : 0U;
+		histogram[luma]++;
+		row_luma += luma;
+		if (block_index < block_count) {
+			block_sums[block_index] += luma;
+		}
+	}
+
+	d->nonzero_bytes += nonzero;
+	d->luma_sum += row_luma;
+	return hash;
+}
+
+/**
+ * @brief Summarize a packed YUV422 or Y8 frame in a single pass.
+ *
+ * Each row is read once as 32-bit words (Y0 U Y1 V, or four Y8 pixels);
+ * the crop samples are taken from the same row while it is still in cache.
+ * Luma min and max come from the histogram afterwards instead of per-pixel
+ * compares.
+ */
+bool AppFrameIngest_Run(const uint8_t *frame_ptr, size_t length_bytes,
+		size_t width_pixels, size_t height_pixels,
+		const AppFrameIngest_Config_t *config_ptr,
+		AppFrameIngest_Descriptor_t *descriptor_out) {
+	AppFrameIngest_Descriptor_t *const d = descriptor_out;
+	uint32_t block_sums[APP_FRAME_INGEST_THUMBNAIL_MAX_SIDE] = { 0U };
+	AppFrameFormat_t format = APP_FRAME_FORMAT_YUV422;
+	uint32_t bytes_per_pixel = 0U;
+	size_t stride_bytes = 0U;
+	bool hash_in_pass = false;
+	uint64_t hash = APP_FRAME_INGEST_FNV64_OFFSET;
+
+	if (d == NULL) {
+		return false;
+	}
+	(void) memset(d, 0, sizeof(*d));
+	if ((frame_ptr == NULL) || (config_ptr == NULL)
+			|| !AppFrameFormat_FromLength(width_pixels, height_pixels,
+					length_bytes, &format)) {
+		return false;
+	}
+	if ((config_ptr->crop_x_min > config_ptr->crop_x_end)
+			|| (config_ptr->crop_y_min > config_ptr->crop_y_end)
+			|| (config_ptr->crop_x_end > width_pixels)
+			|| (config_ptr->crop_y_end > height_pixels)
+			|| (config_ptr->crop_step == 0U)) {
+		return false;
+	}
+
+	bytes_per_pixel = AppFrameFormat_BytesPerPixel(format);
+	stride_bytes = width_pixels * bytes_per_pixel;
+	/* Words only line up with rows when the stride is a whole number of
+	 * words; otherwise the hash takes its own pass. */
+	hash_in_pass = ((stride_bytes % 4U) == 0U);
+
+	d->frame_ptr = frame_ptr;
+	d->length_bytes = (uint32_t) length_bytes;
+	d->format = format;
+	d->width_pixels = (uint32_t) width_pixels;
+	d->height_pixels = (uint32_t) height_pixels;
+	d->crop = *config_ptr;
+	d->min_u = 0xFFU;
+	d->min_v = 0xFFU;
+	if (((width_pixels / APP_FRAME_INGEST_THUMBNAIL_BLOCK)
+			<= APP_FRAME_INGEST_THUMBNAIL_MAX_SIDE)
+			&& ((height_pixels / APP_FRAME_INGEST_THUMBNAIL_BLOCK)
+					<= APP_FRAME_INGEST_THUMBNAIL_MAX_SIDE)) {
+		d->thumbnail_width = (uint32_t) (width_pixels
+				/ APP_FRAME_INGEST_THUMBNAIL_BLOCK);
+		d->thumbnail_height = (uint32_t) (height_pixels
+				/ APP_FRAME_INGEST_THUMBNAIL_BLOCK);
+	}
+
+	for (size_t y = 0U; y < height_pixels; y++) {
+		const uint8_t *const row = &frame_ptr[y * stride_bytes];
+		const uint32_t thumbnail_row = (uint32_t) (y
+				/ APP_FRAME_INGEST_THUMBNAIL_BLOCK);
+		const uint32_t block_count = (thumbnail_row < d->thumbnail_height) ?
+				d->thumbnail_width : 0U;
+
+		if (format == APP_FRAME_FORMAT_YUV422) {
+			hash = AppFrameIngest_Yuv422Row(row, (uint32_t) width_pixels,
+					hash_in_pass, hash, block_sums, block_count, d);
+		} else {
+			hash = AppFrameIngest_Y8Row(row, (uint32_t) width_pixels,
+					hash_in_pass, hash, block_sums, block_count, d);
+		}
+
+		if ((y >= config_ptr->crop_y_min) && (y < config_ptr->crop_y_end)
+				&& (((y - config_ptr->crop_y_min) % config_ptr->crop_step)
+						== 0U)) {
+			AppFrameIngest_SampleCropRow(row, bytes_per_pixel, d);
+		}
+		if ((block_count != 0U) && ((y % APP_FRAME_INGEST_THUMBNAIL_BLOCK)
+				== (APP_FRAME_INGEST_THUMBNAIL_BLOCK - 1U))) {
+			AppFrameIngest_FinishThumbnailRow(block_sums, thumbnail_row, d);
+		}
+	}
+
+	d->content_hash = hash_in_pass ? hash :
+			AppFrameIngest_Hash(frame_ptr, stride_bytes * height_pixels);
+	d->luma_count = (uint32_t) (width_pixels * height_pixels);
+	if (d->chroma_pair_count == 0U) {
+		d->min_u = 0U;
+		d->min_v = 0U;
+	}
+	for (uint32_t level = 0U; level < APP_FRAME_INGEST_HISTOGRAM_BINS;
+			level++) {
+		if (d->luma_histogram[level] != 0U) {
+			d->min_y = (uint8_t) level;
+			break;
+		}
+	}
+	for (uint32_t level = APP_FRAME_INGEST_HISTOGRAM_BINS; level > 0U;
+			level--) {
+		if (d->luma_histogram[level - 1U] != 0U) {
+			d->max_y = (uint8_t) (level - 1U);
+			break;
+		}
+	}
+	d->valid = true;
+	return true;
+}
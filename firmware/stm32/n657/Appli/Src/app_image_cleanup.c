@@ -18,6 +18,7 @@
 
 #include "app_memory_budget.h"
 #include "app_filex.h"
+#include "app_low_power.h"
 #include "app_storage.h"
 #include "ds3231_clock.h"
 #include "debug_console.h"
@@ -185,14 +186,14 @@ static VOID AppImageCleanupThread_Entry(ULONG thread_input) {
 		(void) AppFileX_ServiceCaptureMediaFlush();
 
 		if (now_tick < next_cleanup_tick) {
-			DelayMilliseconds_Cooperative(APP_IMAGE_CLEANUP_SERVICE_POLL_MS);
+			AppLowPower_SleepCoalesced(APP_IMAGE_CLEANUP_SERVICE_POLL_MS);
 			continue;
 		}
 
 		if (!AppStorage_WaitForMediaReady(APP_IMAGE_CLEANUP_MEDIA_READY_TIMEOUT_MS)) {
 			DebugConsole_Printf(
 					"[IMAGE][CLEANUP] Media not ready yet; retrying later.\r\n");
-			DelayMilliseconds_Cooperative(APP_IMAGE_CLEANUP_RETRY_DELAY_MS);
+			AppLowPower_SleepCoalesced(APP_IMAGE_CLEANUP_RETRY_DELAY_MS);
 			continue;
 		}
 
@@ -201,7 +202,7 @@ static VOID AppImageCleanupThread_Entry(ULONG thread_input) {
 			DebugConsole_Printf(
 					"[IMAGE][CLEANUP] Sweep failed with status=%lu; retrying later.\r\n",
 					(unsigned long) sweep_status);
-			DelayMilliseconds_Cooperative(APP_IMAGE_CLEANUP_RETRY_DELAY_MS);
+			AppLowPower_SleepCoalesced(APP_IMAGE_CLEANUP_RETRY_DELAY_MS);
 			continue;
 		}
 
@@ -210,7 +211,7 @@ static VOID AppImageCleanupThread_Entry(ULONG thread_input) {
 					APP_IMAGE_CLEANUP_PERIOD_MS);
 		} while (next_cleanup_tick <= now_tick);
 
-		DelayMilliseconds_Cooperative(APP_IMAGE_CLEANUP_SERVICE_POLL_MS);
+		AppLowPower_SleepCoalesced(APP_IMAGE_CLEANUP_SERVICE_POLL_MS);
 	}
 }
 
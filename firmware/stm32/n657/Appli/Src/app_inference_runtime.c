@@ -16,11 +16,14 @@
 #include <string.h>
 
 #include "app_ai.h"
+#include "app_boot.h"
 #include "app_camera_buffers.h"
 #include "app_camera_platform.h"
+#include "app_clocks.h"
 #include "app_filex.h"
 #include "app_inference_log_config.h"
 #include "app_inference_log_utils.h"
+#include "app_low_power.h"
 #include "app_memory_budget.h"
 #include "app_threadx_config.h"
 #include "debug_console.h"
@@ -44,6 +47,8 @@ typedef enum {
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+#define CAMERA_AI_OUTCOME_EVENT_FLAG 0x00000001U
+
 /* The CNN is now the sole inference authority. The baseline is no longer
  * allowed to override the CNN output. The classical path may still run
  * for diagnostic logging, but the CNN value is always the final answer. */
@@ -80,6 +85,13 @@ static volatile const uint8_t *camera_ai_request_frame_ptr = NULL;
 static volatile ULONG camera_ai_request_frame_length = 0U;
 static volatile uint64_t camera_ai_request_capture_time_us = 0ULL;
 static volatile bool camera_ai_request_in_flight = false;
+/* Track request/completion sequence numbers so consumers that react to the
+ * inference outcome (the no-read-only archival policy) can wait for the exact
+ * frame they hold instead of whichever request finished last. */
+static TX_EVENT_FLAGS_GROUP camera_ai_outcome_flags;
+static volatile uint32_t camera_ai_request_sequence = 0U;
+static volatile uint32_t camera_ai_completed_sequence = 0U;
+static volatile bool camera_ai_completed_published = false;
 static bool app_inference_runtime_initialized = false;
 
 /* USER CODE END PV */
@@ -115,6 +127,12 @@ UINT AppInferenceRuntime_Init(void) {
 		return status;
 	}
 
+	status = tx_event_flags_create(&camera_ai_outcome_flags,
+			"camera_ai_outcome");
+	if (status != TX_SUCCESS) {
+		return status;
+	}
+
 	camera_ai_sync_created = true;
 
 	status = tx_queue_create(&inference_log_queue, "inference_log_queue",
@@ -131,6 +149,9 @@ UINT AppInferenceRuntime_Init(void) {
 	camera_ai_request_frame_length = 0U;
 	camera_ai_request_capture_time_us = 0ULL;
 	camera_ai_request_in_flight = false;
+	camera_ai_request_sequence = 0U;
+	camera_ai_completed_sequence = 0U;
+	camera_ai_completed_published = false;
 	TX_RESTORE
 
 	app_inference_runtime_initialized = true;
@@ -221,14 +242,27 @@ bool AppInferenceRuntime_RequestDryInference(const uint8_t *frame_ptr,
 		return false;
 	}
 
+	/* Re-arm the outcome flag before the new sequence becomes visible. Nothing
+	 * is in flight, so no completion can set it again until this request
+	 * finishes. */
+	(void) tx_event_flags_set(&camera_ai_outcome_flags,
+			~CAMERA_AI_OUTCOME_EVENT_FLAG, TX_AND);
+
 	TX_DISABLE
 	camera_ai_request_capture_time_us = Metrics_GetMicros();
 	Metrics_StartInference("AI");
 	(void) memcpy(camera_inference_frame_snapshot, frame_ptr, (size_t) frame_length);
+	AppCameraBuffers_AdoptSnapshotDescriptor(frame_ptr, (size_t) frame_length);
+	AppCameraBuffers_AdoptNnFrame(frame_ptr);
 	(void) DebugConsole_WriteString("[AI] Shared snapshot copied.\r\n");
 	(void) DebugConsole_WriteString("[AI] Queueing dry-run request.\r\n");
 
 	camera_ai_request_in_flight = true;
+	/* Sequence 0 is reserved for "no inference queued". */
+	camera_ai_request_sequence++;
+	if (camera_ai_request_sequence == 0U) {
+		camera_ai_request_sequence = 1U;
+	}
 	camera_ai_request_frame_ptr = camera_inference_frame_snapshot;
 	camera_ai_request_frame_length = frame_length;
 	TX_RESTORE
@@ -240,6 +274,7 @@ bool AppInferenceRuntime_RequestDryInference(const uint8_t *frame_ptr,
 		camera_ai_request_frame_ptr = NULL;
 		camera_ai_request_frame_length = 0U;
 		TX_RESTORE
+		AppCameraBuffers_ReleaseNnFrame();
 		Metrics_EndInference("AI", NAN);
 		DebugConsole_Printf(
 				"[AI] Failed to signal dry-run request semaphore.\r\n");
@@ -249,6 +284,66 @@ bool AppInferenceRuntime_RequestDryInference(const uint8_t *frame_ptr,
 	return true;
 }
 
+/**
+ * @brief Report the sequence number of the most recently queued request.
+ */
+uint32_t AppInferenceRuntime_GetLastRequestSequence(void) {
+	return camera_ai_request_sequence;
+}
+
+/**
+ * @brief Wait for a queued request to finish and report whether it published.
+ * @retval true when the request completed before the timeout.
+ */
+bool AppInferenceRuntime_WaitForRequestOutcome(uint32_t request_sequence,
+		uint32_t timeout_ms, bool *reading_published_ptr) {
+	const ULONG deadline_tick = tx_time_get()
+			+ ThreadxUtils_MillisecondsToTicks(timeout_ms);
+
+	if (!camera_ai_sync_created || (reading_published_ptr == NULL)) {
+		return false;
+	}
+
+	while (true) {
+		TX_INTERRUPT_SAVE_AREA
+		ULONG actual_flags = 0U;
+		uint32_t completed_sequence = 0U;
+		bool published = false;
+		const ULONG now_tick = tx_time_get();
+
+		TX_DISABLE
+		completed_sequence = camera_ai_completed_sequence;
+		published = camera_ai_completed_published;
+		TX_RESTORE
+
+		/* Wrap-safe "completed >= requested" comparison. */
+		if ((int32_t) (completed_sequence - request_sequence) >= 0) {
+			/* A later request may already have overwritten the published flag;
+			 * only the exact match carries a trustworthy outcome. */
+			*reading_published_ptr = (completed_sequence == request_sequence)
+					&& published;
+			return true;
+		}
+
+		if ((LONG) (deadline_tick - now_tick) <= 0) {
+			return false;
+		}
+
+		/* The flag is only cleared when the next request is armed, so every
+		 * waiter on this outcome sees it and the sequence check above decides.
+		 * A timeout loops once more so a late completion is still reported. */
+		if (tx_event_flags_get(&camera_ai_outcome_flags,
+				CAMERA_AI_OUTCOME_EVENT_FLAG, TX_OR, &actual_flags,
+				(ULONG) (deadline_tick - now_tick)) == TX_SUCCESS) {
+			/* Set means the latest request finished; a sequence beyond it was
+			 * never queued and would otherwise spin until the deadline. */
+			if ((int32_t) (camera_ai_request_sequence - request_sequence) < 0) {
+				return false;
+			}
+		}
+	}
+}
+
 /* USER CODE END 0 */
 
 /**
@@ -271,6 +366,8 @@ static VOID CameraAIThread_Entry(ULONG thread_input) {
 
 		frame_ptr = (const uint8_t *) camera_ai_request_frame_ptr;
 		frame_length = camera_ai_request_frame_length;
+		const uint32_t request_sequence = camera_ai_request_sequence;
+		bool reading_published = false;
 		const uint64_t frame_capture_time_us = camera_ai_request_capture_time_us;
 		camera_ai_request_frame_ptr = NULL;
 		camera_ai_request_frame_length = 0U;
@@ -281,7 +378,12 @@ static VOID CameraAIThread_Entry(ULONG thread_input) {
 		if ((frame_ptr == NULL) || (frame_length == 0U)) {
 			DebugConsole_Printf(
 					"[AI] Worker woke without a queued frame; ignoring.\r\n");
+			camera_ai_completed_sequence = request_sequence;
+			camera_ai_completed_published = false;
+			AppCameraBuffers_ReleaseNnFrame();
 			camera_ai_request_in_flight = false;
+			(void) tx_event_flags_set(&camera_ai_outcome_flags,
+					CAMERA_AI_OUTCOME_EVENT_FLAG, TX_OR);
 			continue;
 		}
 
@@ -294,8 +396,27 @@ static VOID CameraAIThread_Entry(ULONG thread_input) {
 		 * metrics while the AI model time stays comparable to the baseline. */
 		Metrics_MarkComputeStart("AI");
 
-		if (!App_AI_RunDryInferenceFromYuv422(frame_ptr,
-				(size_t) frame_length)) {
+		/* The NPU and the weight window are only clocked for the run. The
+		 * preprocessing runs boosted; the epoch loop drops to nominal while
+		 * the NPU does the work. */
+		const bool npu_held = AppLowPower_AcquireDomain(APP_POWER_DOMAIN_NPU);
+		const bool xspi2_held = AppLowPower_AcquireDomain(
+				APP_POWER_DOMAIN_XSPI2);
+		(void) AppClocks_SetDemand(APP_CLOCK_CLIENT_AI, APP_CLOCK_PROFILE_BOOST);
+		const bool inference_ok = App_AI_RunDryInferenceFromYuv422(frame_ptr,
+				(size_t) frame_length);
+		/* Every stage fed the training crop may read the NN pipe frame, so
+		 * it is held for the whole run. */
+		AppCameraBuffers_ReleaseNnFrame();
+		(void) AppClocks_SetDemand(APP_CLOCK_CLIENT_AI, APP_CLOCK_PROFILE_LOW);
+		if (xspi2_held) {
+			AppLowPower_ReleaseDomain(APP_POWER_DOMAIN_XSPI2);
+		}
+		if (npu_held) {
+			AppLowPower_ReleaseDomain(APP_POWER_DOMAIN_NPU);
+		}
+
+		if (!inference_ok) {
 			DebugConsole_Printf(
 					"[AI] One-shot dry-run inference failed; continuing.\r\n");
 		} else {
@@ -318,6 +439,8 @@ static VOID CameraAIThread_Entry(ULONG thread_input) {
 						sizeof(inference_line), "[AI] Inference exact: ", final_value);
 				(void) DebugConsole_WriteString(inference_line);
 				(void) bits;
+				reading_published = true;
+				AppBoot_NotifyReading("ai");
 				if (inference_log_thread_created) {
 					(void) tx_queue_send(&inference_log_queue, &bits.u,
 							TX_NO_WAIT);
@@ -330,8 +453,12 @@ static VOID CameraAIThread_Entry(ULONG thread_input) {
 
 		TX_INTERRUPT_SAVE_AREA
 		TX_DISABLE
+		camera_ai_completed_sequence = request_sequence;
+		camera_ai_completed_published = reading_published;
 		camera_ai_request_in_flight = false;
 		TX_RESTORE
+		(void) tx_event_flags_set(&camera_ai_outcome_flags,
+				CAMERA_AI_OUTCOME_EVENT_FLAG, TX_OR);
 	}
 }
 
@@ -422,6 +549,7 @@ static VOID InferenceLogThread_Entry(ULONG thread_input) {
 								log_file_name, FX_OPEN_FOR_WRITE);
 						if (open_status == FX_SUCCESS) {
 							const char *header = "datetime,value_degC\n";
+							AppFileX_AlignNextAllocationLocked();
 							(void) fx_file_write(&log_file, (VOID*) header,
 									(ULONG) strlen(header));
 						}
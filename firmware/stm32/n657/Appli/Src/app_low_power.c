@@ -0,0 +1,603 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_low_power.c
+ * @brief   Tickless idle hooks, coalesced service wake-ups and peripheral
+ *          power domains for ThreadX.
+ *
+ * When the scheduler has nothing to run, tx_low_power_enter() walks the
+ * ThreadX timer wheel for the next real expiry, stops SysTick and stretches
+ * the TIM5 HAL timebase period so it fires once at that deadline. The core then
+ * sits in WFI until TIM5 or any other interrupt wakes it, and
+ * tx_low_power_exit() replays the skipped ThreadX ticks and HAL milliseconds
+ * from the TIM5 counter.
+ *
+ * The core only uses SLEEP here, not STOP: TIM5 is the only wake timer this
+ * build has and it stops with the core clock tree in STOP. SLEEP keeps SRAM,
+ * the DCMIPP setup and the IMX335 register state intact.
+ *
+ * Between uses the NPU, the xSPI2 window, DCMIPP/CSI and SPI5 have their
+ * kernel clocks gated through the AppPowerDomain reference counts. Gating is
+ * a clock stop, never a reset, so every block keeps its configuration and
+ * the enable hooks only have to turn the clock back on. The hooks are plain
+ * RCC/GPIO register writes, which lets the manager run under a short
+ * interrupt lock from any thread and from the deferred-gate timer.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#include "app_low_power.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* USER CODE BEGIN Includes */
+#include "main.h"
+#include "tx_timer.h"
+#include "app_threadx_config.h"
+#include "debug_console.h"
+#include "threadx_utils.h"
+/* USER CODE END Includes */
+
+/* Private define ------------------------------------------------------------*/
+/* USER CODE BEGIN PD */
+#define APP_LOW_POWER_TICK_PERIOD_US      (1000000U / (uint32_t) TX_TIMER_TICKS_PER_SECOND)
+#define APP_LOW_POWER_HAL_TICK_PERIOD_US  1000U
+#define APP_LOW_POWER_MAX_IDLE_TICKS \
+	((APP_LOW_POWER_MAX_IDLE_MS * 1000U) / APP_LOW_POWER_TICK_PERIOD_US)
+/* USER CODE END PD */
+
+/* Private variables ---------------------------------------------------------*/
+/* USER CODE BEGIN PV */
+static volatile bool app_low_power_tickless_enabled =
+		(APP_LOW_POWER_TICKLESS_ENABLED != 0U);
+static bool app_low_power_tickless_active = false;
+/* Time already spent in the current ThreadX / HAL tick when the window began. */
+static uint32_t app_low_power_entry_tick_us = 0U;
+static uint32_t app_low_power_entry_hal_us = 0U;
+/* Sub-tick time not yet replayed into the ThreadX clock. */
+static uint32_t app_low_power_tick_carry_us = 0U;
+static AppLowPower_Stats_t app_low_power_stats;
+static AppPowerDomain_Context_t app_low_power_domains;
+static TX_TIMER app_low_power_domain_timer;
+static bool app_low_power_domains_ready = false;
+/* USER CODE END PV */
+
+/* Private function prototypes -----------------------------------------------*/
+/* USER CODE BEGIN PFP */
+static uint32_t AppLowPower_TicksUntilNextTimer(void);
+static uint32_t AppLowPower_ReplayTimerTicks(uint32_t tick_count);
+static void AppLowPower_ArmDomainTimer(uint32_t delay_ms);
+static VOID AppLowPower_DomainTimerExpired(ULONG timer_input);
+/* USER CODE END PFP */
+
+/**
+ * @brief Find how many ticks remain until the next ThreadX timer expires.
+ *
+ * The timer interrupt checks *_tx_timer_current_ptr on the next tick, so a
+ * timer in the slot at offset N is processed on tick N + 1. A timer longer
+ * than the wheel sits in a slot with more than TX_TIMER_ENTRIES ticks left;
+ * processing it only takes TX_TIMER_ENTRIES off and re-arms it, so its real
+ * expiry is that many ticks later and every slot has to be walked.
+ *
+ * @retval Ticks until the first expiry, capped at APP_LOW_POWER_MAX_IDLE_TICKS,
+ *         or 0 when the wheel pointer looks corrupted.
+ */
+static uint32_t AppLowPower_TicksUntilNextTimer(void) {
+	TX_TIMER_INTERNAL **slot_ptr = _tx_timer_current_ptr;
+	uint32_t next_ticks = APP_LOW_POWER_MAX_IDLE_TICKS;
+
+	if ((slot_ptr < _tx_timer_list_start) || (slot_ptr >= _tx_timer_list_end)) {
+		return 0U;
+	}
+
+	for (uint32_t offset = 0U; offset < (uint32_t) TX_TIMER_ENTRIES; offset++) {
+		TX_TIMER_INTERNAL *const head_ptr = *slot_ptr;
+
+		if ((offset + 1U) >= next_ticks) {
+			break;
+		}
+		if (head_ptr != TX_NULL) {
+			TX_TIMER_INTERNAL *timer_ptr = head_ptr;
+
+			do {
+				const ULONG remaining =
+						timer_ptr->tx_timer_internal_remaining_ticks;
+				uint32_t expiry = offset + 1U;
+
+				if (remaining > (ULONG) TX_TIMER_ENTRIES) {
+					expiry += (uint32_t) (remaining - (ULONG) TX_TIMER_ENTRIES);
+				}
+				if (expiry < next_ticks) {
+					next_ticks = expiry;
+				}
+				timer_ptr = timer_ptr->tx_timer_internal_active_next;
+			} while ((timer_ptr != head_ptr) && (timer_ptr != TX_NULL));
+		}
+
+		slot_ptr++;
+		if (slot_ptr == _tx_timer_list_end) {
+			slot_ptr = _tx_timer_list_start;
+		}
+	}
+
+	return next_ticks;
+}
+
+/**
+ * @brief Advance the ThreadX clock and wheel over ticks with no expiry.
+ *
+ * Does what the tick handler would have done for each skipped tick: a slot
+ * that is crossed can only hold timers longer than the wheel, which lose
+ * TX_TIMER_ENTRIES ticks and are re-armed from the following slot.
+ *
+ * @param tick_count Ticks to skip; must be below the next expiry.
+ * @retval Ticks actually replayed; fewer when a crossed slot holds a timer
+ *         that is due, which is left for the real tick handler.
+ */
+static uint32_t AppLowPower_ReplayTimerTicks(uint32_t tick_count) {
+	uint32_t replayed = 0U;
+
+	for (; replayed < tick_count; replayed++) {
+		TX_TIMER_INTERNAL **const slot_ptr = _tx_timer_current_ptr;
+		TX_TIMER_INTERNAL *timer_ptr = *slot_ptr;
+
+		if (timer_ptr != TX_NULL) {
+			TX_TIMER_INTERNAL *const head_ptr = timer_ptr;
+			TX_TIMER_INTERNAL *const tail_ptr =
+					head_ptr->tx_timer_internal_active_previous;
+
+			do {
+				if (timer_ptr->tx_timer_internal_remaining_ticks
+						<= (ULONG) TX_TIMER_ENTRIES) {
+					return replayed;
+				}
+				timer_ptr = timer_ptr->tx_timer_internal_active_next;
+			} while (timer_ptr != head_ptr);
+
+			/* Open the ring so re-arming a timer cannot disturb the walk. */
+			tail_ptr->tx_timer_internal_active_next = TX_NULL;
+			*slot_ptr = TX_NULL;
+		}
+
+		_tx_timer_system_clock++;
+		_tx_timer_current_ptr = slot_ptr + 1;
+		if (_tx_timer_current_ptr == _tx_timer_list_end) {
+			_tx_timer_current_ptr = _tx_timer_list_start;
+		}
+
+		while (timer_ptr != TX_NULL) {
+			TX_TIMER_INTERNAL *const next_ptr =
+					timer_ptr->tx_timer_internal_active_next;
+
+			timer_ptr->tx_timer_internal_remaining_ticks -=
+					(ULONG) TX_TIMER_ENTRIES;
+			timer_ptr->tx_timer_internal_list_head = TX_NULL;
+			_tx_timer_system_activate(timer_ptr);
+			timer_ptr = next_ptr;
+		}
+	}
+
+	return replayed;
+}
+
+/**
+ * @brief ThreadX idle entry hook: stop the tick until the next timer is due.
+ *
+ * Runs from the scheduler idle loop with interrupts masked, right before WFI.
+ * Any pending tick, time-slice or timer work keeps the normal tick running.
+ */
+void tx_low_power_enter(void) {
+	uint32_t wait_ticks = 0U;
+	uint32_t cycles_per_us = 0U;
+	uint32_t window_us = 0U;
+
+	app_low_power_stats.idle_entry_count++;
+	app_low_power_tickless_active = false;
+
+	if (!app_low_power_tickless_enabled) {
+		return;
+	}
+
+	if ((_tx_timer_time_slice != 0U) || (_tx_timer_expired != 0U)
+			|| ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0U)
+			|| ((TIM5->SR & TIM_SR_UIF) != 0U)) {
+		return;
+	}
+
+	wait_ticks = AppLowPower_TicksUntilNextTimer();
+	if (wait_ticks < APP_LOW_POWER_MIN_TICKLESS_TICKS) {
+		return;
+	}
+
+	cycles_per_us = SystemCoreClock / 1000000U;
+	if (cycles_per_us == 0U) {
+		return;
+	}
+
+	SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+	app_low_power_entry_tick_us = (SysTick->LOAD - SysTick->VAL)
+			/ cycles_per_us;
+	if (app_low_power_entry_tick_us >= APP_LOW_POWER_TICK_PERIOD_US) {
+		app_low_power_entry_tick_us = APP_LOW_POWER_TICK_PERIOD_US - 1U;
+	}
+
+	/* TIM5 is a 32-bit counter at 1 MHz, so the stretched period fits easily. */
+	window_us = (wait_ticks * APP_LOW_POWER_TICK_PERIOD_US)
+			- app_low_power_entry_tick_us;
+	app_low_power_entry_hal_us = TIM5->CNT;
+	TIM5->CNT = 0U;
+	TIM5->ARR = window_us - 1U;
+
+	app_low_power_tickless_active = true;
+	app_low_power_stats.tickless_entry_count++;
+}
+
+/**
+ * @brief ThreadX idle exit hook: restore the tick and replay skipped time.
+ *
+ * Runs right after WFI with interrupts still masked, so the TIM5 handler has
+ * not run yet. The update flag is consumed here and the HAL tick is advanced
+ * directly to avoid counting the wake-up twice.
+ */
+void tx_low_power_exit(void) {
+	bool timer_fired = false;
+	uint32_t elapsed_us = 0U;
+	uint32_t hal_us = 0U;
+	uint32_t tick_us = 0U;
+	uint32_t elapsed_ticks = 0U;
+	uint32_t due_ticks = 0U;
+	bool pend_tick = false;
+
+	if (!app_low_power_tickless_active) {
+		return;
+	}
+	app_low_power_tickless_active = false;
+
+	timer_fired = ((TIM5->SR & TIM_SR_UIF) != 0U);
+	elapsed_us = TIM5->CNT;
+	if (timer_fired) {
+		elapsed_us += TIM5->ARR + 1U;
+	}
+	TIM5->SR = ~((uint32_t) TIM_SR_UIF);
+	NVIC_ClearPendingIRQ(TIM5_IRQn);
+
+	/* Put the 1 ms HAL timebase back, keeping the partial millisecond. */
+	hal_us = app_low_power_entry_hal_us + elapsed_us;
+	uwTick += hal_us / APP_LOW_POWER_HAL_TICK_PERIOD_US;
+	TIM5->ARR = APP_LOW_POWER_HAL_TICK_PERIOD_US - 1U;
+	TIM5->CNT = hal_us % APP_LOW_POWER_HAL_TICK_PERIOD_US;
+
+	/* Replay whole ThreadX ticks. The slot that is due now is left to the
+	 * real tick handler so the timer thread sees the expiration as usual. */
+	tick_us = app_low_power_entry_tick_us + elapsed_us
+			+ app_low_power_tick_carry_us;
+	elapsed_ticks = tick_us / APP_LOW_POWER_TICK_PERIOD_US;
+	app_low_power_tick_carry_us = tick_us % APP_LOW_POWER_TICK_PERIOD_US;
+
+	due_ticks = AppLowPower_TicksUntilNextTimer();
+	if ((due_ticks != 0U) && (elapsed_ticks >= due_ticks)) {
+		app_low_power_tick_carry_us += (elapsed_ticks - due_ticks)
+				* APP_LOW_POWER_TICK_PERIOD_US;
+		elapsed_ticks = due_ticks - 1U;
+		pend_tick = true;
+	}
+
+	if ((due_ticks != 0U) && (elapsed_ticks != 0U)) {
+		const uint32_t replayed = AppLowPower_ReplayTimerTicks(elapsed_ticks);
+
+		if (replayed < elapsed_ticks) {
+			app_low_power_tick_carry_us += (elapsed_ticks - replayed)
+					* APP_LOW_POWER_TICK_PERIOD_US;
+			elapsed_ticks = replayed;
+			pend_tick = true;
+		}
+	}
+
+	SysTick->VAL = 0U;
+	SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+	if (pend_tick) {
+		SCB->ICSR = SCB_ICSR_PENDSTSET_Msk;
+	}
+
+	if (timer_fired) {
+		app_low_power_stats.timer_wake_count++;
+	} else {
+		app_low_power_stats.early_wake_count++;
+	}
+	app_low_power_stats.suppressed_tick_count += elapsed_ticks;
+	app_low_power_stats.tickless_ms += elapsed_us / 1000U;
+	if ((elapsed_us / 1000U) > app_low_power_stats.longest_tickless_ms) {
+		app_low_power_stats.longest_tickless_ms = elapsed_us / 1000U;
+	}
+}
+
+/**
+ * @brief Enable or disable tickless idle at runtime.
+ * @param enabled true to stop SysTick while idle.
+ */
+void AppLowPower_SetTicklessEnabled(bool enabled) {
+	app_low_power_tickless_enabled = enabled;
+}
+
+/**
+ * @brief Copy the idle residency counters.
+ * @param stats_ptr Destination for the snapshot.
+ */
+void AppLowPower_GetStats(AppLowPower_Stats_t *stats_ptr) {
+	TX_INTERRUPT_SAVE_AREA
+
+	if (stats_ptr == NULL) {
+		return;
+	}
+
+	TX_DISABLE
+	*stats_ptr = app_low_power_stats;
+	TX_RESTORE
+}
+
+/**
+ * @brief Print idle residency and wake-up counts to the debug console.
+ */
+void AppLowPower_LogStats(void) {
+	AppLowPower_Stats_t stats;
+	const uint32_t uptime_ms = (uint32_t) ThreadxUtils_GetTickMs();
+	uint32_t residency_permille = 0U;
+
+	AppLowPower_GetStats(&stats);
+	if (uptime_ms != 0U) {
+		residency_permille = (uint32_t) (((uint64_t) stats.tickless_ms
+				* 1000U) / uptime_ms);
+	}
+
+	DebugConsole_Printf(
+			"[POWER][IDLE] idle=%lu tickless=%lu wake_timer=%lu wake_irq=%lu "
+			"tickless_ms=%lu longest_ms=%lu residency=%lu.%lu%%\r\n",
+			(unsigned long) stats.idle_entry_count,
+			(unsigned long) stats.tickless_entry_count,
+			(unsigned long) stats.timer_wake_count,
+			(unsigned long) stats.early_wake_count,
+			(unsigned long) stats.tickless_ms,
+			(unsigned long) stats.longest_tickless_ms,
+			(unsigned long) (residency_permille / 10U),
+			(unsigned long) (residency_permille % 10U));
+
+	if (app_low_power_domains_ready) {
+		for (uint32_t i = 0U; i < (uint32_t) APP_POWER_DOMAIN_COUNT; i++) {
+			const AppPowerDomain_Id_t id = (AppPowerDomain_Id_t) i;
+			TX_INTERRUPT_SAVE_AREA
+			uint64_t on_ms = 0U;
+			uint32_t enables = 0U;
+			bool powered = false;
+
+			TX_DISABLE
+			on_ms = AppPowerDomain_OnTimeMs(&app_low_power_domains, id,
+					HAL_GetTick());
+			enables = app_low_power_domains.domain[i].enable_count;
+			powered = AppPowerDomain_IsPowered(&app_low_power_domains, id);
+			TX_RESTORE
+
+			DebugConsole_Printf(
+					"[POWER][DOMAIN] %s %s on_ms=%lu enables=%lu\r\n",
+					AppPowerDomain_Name(id), powered ? "on" : "gated",
+					(unsigned long) on_ms, (unsigned long) enables);
+		}
+	}
+}
+
+/**
+ * @brief Convert a service period into a timeout ending on the shared grid.
+ * @param delay_ms Minimum delay in milliseconds.
+ * @retval Timeout in ThreadX ticks.
+ */
+ULONG AppLowPower_CoalescedTimeoutTicks(uint32_t delay_ms) {
+	const ULONG grid_ticks = ThreadxUtils_MillisecondsToTicks(
+			APP_LOW_POWER_COALESCE_MS);
+	const ULONG now_tick = tx_time_get();
+	ULONG wake_tick = now_tick + ThreadxUtils_MillisecondsToTicks(delay_ms);
+
+	if (grid_ticks > 1U) {
+		const ULONG remainder_ticks = wake_tick % grid_ticks;
+
+		if (remainder_ticks != 0U) {
+			wake_tick += grid_ticks - remainder_ticks;
+		}
+	}
+
+	return (ULONG) (wake_tick - now_tick);
+}
+
+/**
+ * @brief Sleep for at least delay_ms and wake on the shared grid.
+ * @param delay_ms Minimum delay in milliseconds.
+ */
+void AppLowPower_SleepCoalesced(uint32_t delay_ms) {
+	const ULONG sleep_ticks = AppLowPower_CoalescedTimeoutTicks(delay_ms);
+
+	if (sleep_ticks != 0U) {
+		(void) tx_thread_sleep(sleep_ticks);
+	}
+}
+
+/* Clock gate hooks. None of them reset a block, so its registers survive. */
+static bool AppLowPower_EnableNpu(void) {
+	__HAL_RCC_NPU_CLK_ENABLE();
+	__HAL_RCC_CACHEAXI_CLK_ENABLE();
+	return true;
+}
+
+static void AppLowPower_DisableNpu(void) {
+	__HAL_RCC_CACHEAXI_CLK_DISABLE();
+	__HAL_RCC_NPU_CLK_DISABLE();
+}
+
+static bool AppLowPower_EnableXspi2(void) {
+	__HAL_RCC_XSPI2_CLK_ENABLE();
+	return true;
+}
+
+static void AppLowPower_DisableXspi2(void) {
+	__HAL_RCC_XSPI2_CLK_DISABLE();
+}
+
+static bool AppLowPower_EnableCamera(void) {
+	__HAL_RCC_DCMIPP_CLK_ENABLE();
+	__HAL_RCC_CSI_CLK_ENABLE();
+	return true;
+}
+
+static void AppLowPower_DisableCamera(void) {
+	__HAL_RCC_CSI_CLK_DISABLE();
+	__HAL_RCC_DCMIPP_CLK_DISABLE();
+}
+
+static bool AppLowPower_EnableSdSpi(void) {
+	__HAL_RCC_SPI5_CLK_ENABLE();
+	return true;
+}
+
+/* Leave the card deselected so it drops to its own standby current. */
+static void AppLowPower_RetainSdSpi(void) {
+	HAL_GPIO_WritePin(SPI5_CS_GPIO_Port, SPI5_CS_Pin, GPIO_PIN_SET);
+}
+
+static void AppLowPower_DisableSdSpi(void) {
+	__HAL_RCC_SPI5_CLK_DISABLE();
+}
+
+/**
+ * @brief Register the peripheral domains and create the deferred-gate timer.
+ *
+ * The NPU is only clocked once the AI boot lane brings it up, so it starts
+ * gated; the others were clocked by the FSBL or main() and start on.
+ * @retval TX_SUCCESS or the tx_timer_create status.
+ */
+UINT AppLowPower_InitDomains(void) {
+	const AppPowerDomain_Hooks_t npu_hooks = {
+		.enable = AppLowPower_EnableNpu,
+		.retain = NULL,
+		.disable = AppLowPower_DisableNpu,
+		.min_off_ms = APP_POWER_DOMAIN_NPU_MIN_OFF_MS,
+	};
+	const AppPowerDomain_Hooks_t xspi2_hooks = {
+		.enable = AppLowPower_EnableXspi2,
+		.retain = NULL,
+		.disable = AppLowPower_DisableXspi2,
+		.min_off_ms = APP_POWER_DOMAIN_XSPI2_MIN_OFF_MS,
+	};
+	const AppPowerDomain_Hooks_t camera_hooks = {
+		.enable = AppLowPower_EnableCamera,
+		.retain = NULL,
+		.disable = AppLowPower_DisableCamera,
+		.min_off_ms = APP_POWER_DOMAIN_CAMERA_MIN_OFF_MS,
+	};
+	const AppPowerDomain_Hooks_t sd_spi_hooks = {
+		.enable = AppLowPower_EnableSdSpi,
+		.retain = AppLowPower_RetainSdSpi,
+		.disable = AppLowPower_DisableSdSpi,
+		.min_off_ms = APP_POWER_DOMAIN_SD_SPI_MIN_OFF_MS,
+	};
+	const uint32_t now_ms = HAL_GetTick();
+	UINT status = TX_SUCCESS;
+
+	if ((APP_POWER_DOMAINS_ENABLED == 0U) || app_low_power_domains_ready) {
+		return TX_SUCCESS;
+	}
+
+	status = tx_timer_create(&app_low_power_domain_timer, "power_domains",
+			AppLowPower_DomainTimerExpired, 0U, 1U, 0U, TX_NO_ACTIVATE);
+	if (status != TX_SUCCESS) {
+		return status;
+	}
+
+	AppPowerDomain_Init(&app_low_power_domains);
+	AppPowerDomain_Register(&app_low_power_domains, APP_POWER_DOMAIN_NPU,
+			&npu_hooks, false, now_ms);
+	AppPowerDomain_Register(&app_low_power_domains, APP_POWER_DOMAIN_XSPI2,
+			&xspi2_hooks, true, now_ms);
+	AppPowerDomain_Register(&app_low_power_domains, APP_POWER_DOMAIN_CAMERA,
+			&camera_hooks, true, now_ms);
+	AppPowerDomain_Register(&app_low_power_domains, APP_POWER_DOMAIN_SD_SPI,
+			&sd_spi_hooks, true, now_ms);
+	app_low_power_domains_ready = true;
+	return TX_SUCCESS;
+}
+
+/**
+ * @brief Take a domain reference, ungating it if needed.
+ * @param id Domain the caller is about to use.
+ * @retval true when a reference is held (always true with gating disabled).
+ */
+bool AppLowPower_AcquireDomain(AppPowerDomain_Id_t id) {
+	TX_INTERRUPT_SAVE_AREA
+	bool acquired = false;
+
+	if (!app_low_power_domains_ready) {
+		return true;
+	}
+
+	TX_DISABLE
+	acquired = AppPowerDomain_Acquire(&app_low_power_domains, id,
+			HAL_GetTick());
+	TX_RESTORE
+	return acquired;
+}
+
+/**
+ * @brief Drop a domain reference and arm the timer for its deferred gate.
+ * @param id Domain the caller has finished with.
+ */
+void AppLowPower_ReleaseDomain(AppPowerDomain_Id_t id) {
+	TX_INTERRUPT_SAVE_AREA
+	uint32_t next_due_ms = APP_POWER_DOMAIN_NONE_PENDING;
+
+	if (!app_low_power_domains_ready) {
+		return;
+	}
+
+	TX_DISABLE
+	AppPowerDomain_Release(&app_low_power_domains, id, HAL_GetTick());
+	next_due_ms = AppPowerDomain_Service(&app_low_power_domains,
+			HAL_GetTick());
+	TX_RESTORE
+
+	if (next_due_ms != APP_POWER_DOMAIN_NONE_PENDING) {
+		AppLowPower_ArmDomainTimer(next_due_ms);
+	}
+}
+
+/**
+ * @brief Restart the one-shot gate timer so it fires after delay_ms.
+ *
+ * A ThreadX timer keeps the deadline visible to the tickless idle hook, so a
+ * pending gate ends an idle window instead of waiting for the next capture.
+ * @param delay_ms Time until the earliest pending gate.
+ */
+static void AppLowPower_ArmDomainTimer(uint32_t delay_ms) {
+	ULONG ticks = ThreadxUtils_MillisecondsToTicks(delay_ms);
+
+	if (ticks == 0U) {
+		ticks = 1U;
+	}
+	(void) tx_timer_deactivate(&app_low_power_domain_timer);
+	(void) tx_timer_change(&app_low_power_domain_timer, ticks, 0U);
+	(void) tx_timer_activate(&app_low_power_domain_timer);
+}
+
+/**
+ * @brief Gate the domains whose minimum off time has run out.
+ * @param timer_input Unused timer input value.
+ */
+static VOID AppLowPower_DomainTimerExpired(ULONG timer_input) {
+	TX_INTERRUPT_SAVE_AREA
+	uint32_t next_due_ms = APP_POWER_DOMAIN_NONE_PENDING;
+
+	(void) timer_input;
+
+	TX_DISABLE
+	next_due_ms = AppPowerDomain_Service(&app_low_power_domains,
+			HAL_GetTick());
+	TX_RESTORE
+
+	if (next_due_ms != APP_POWER_DOMAIN_NONE_PENDING) {
+		AppLowPower_ArmDomainTimer(next_due_ms);
+	}
+}
@@ -0,0 +1,200 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_luma_stats.c
+ * @brief   Luma summaries for the capture brightness gate.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#include "app_luma_stats.h"
+
+#include <string.h>
+
+#define APP_LUMA_STATS_BELOW_BINS  6U
+#define APP_LUMA_STATS_MAX_COUNT   0x00FFFFFFUL
+
+/* Bin i of [0..5] counts luma below these; bin 6 + i counts luma at or
+ * above app_luma_stats_above_edge[i]. */
+static const uint8_t app_luma_stats_below_edge[APP_LUMA_STATS_BELOW_BINS] = {
+	4U, 8U, 16U, 32U, 64U, 128U,
+};
+static const uint8_t app_luma_stats_above_edge[APP_LUMA_STATS_BELOW_BINS] = {
+	128U, 192U, 225U, 240U, 248U, 252U,
+};
+
+/**
+ * @brief Summarize the ISP luma average and threshold bins.
+ */
+bool AppLumaStats_FromIspBins(const uint32_t bins[APP_LUMA_STATS_ISP_BINS],
+		uint8_t mean_y, uint8_t bright_level, AppLumaStats_t *stats_ptr) {
+	const uint32_t *below = bins;
+	const uint32_t *above = NULL;
+	uint64_t total = 0U;
+	uint32_t shift = 0U;
+	uint32_t bright = 0U;
+	uint8_t min_y = 0U;
+	uint8_t max_y = 0U;
+
+	if ((bins == NULL) || (stats_ptr == NULL)) {
+		return false;
+	}
+	above = &bins[APP_LUMA_STATS_BELOW_BINS];
+
+	/* Every pixel is either below 128 or above 127. */
+	total = (uint64_t) below[APP_LUMA_STATS_BELOW_BINS - 1U] + above[0];
+	if (total == 0U) {
+		return false;
+	}
+	for (uint32_t i = 1U; i < APP_LUMA_STATS_BELOW_BINS; i++) {
+		if ((below[i] < below[i - 1U]) || (above[i] > above[i - 1U])) {
+			return false;
+		}
+	}
+
+	/* Lowest luma: the first "below" bin that holds anything bounds it from
+	 * below by the previous edge; with none, the last "above" bin holding
+	 * every pixel does. */
+	min_y = app_luma_stats_above_edge[0];
+	if (below[APP_LUMA_STATS_BELOW_BINS - 1U] != 0U) {
+		for (uint32_t i = 0U; i < APP_LUMA_STATS_BELOW_BINS; i++) {
+			if (below[i] != 0U) {
+				min_y = (i == 0U) ? 0U : app_luma_stats_below_edge[i - 1U];
+				break;
+			}
+		}
+	} else {
+		for (uint32_t i = 0U; i < APP_LUMA_STATS_BELOW_BINS; i++) {
+			if (above[i] == above[0]) {
+				min_y = app_luma_stats_above_edge[i];
+			}
+		}
+	}
+
+	/* Highest luma, mirrored. */
+	max_y = 255U;
+	if (above[0] == 0U) {
+		for (uint32_t i = 0U; i < APP_LUMA_STATS_BELOW_BINS; i++) {
+			if (below[i] == below[APP_LUMA_STATS_BELOW_BINS - 1U]) {
+				max_y = (uint8_t) (app_luma_stats_below_edge[i] - 1U);
+				break;
+			}
+		}
+	} else {
+		for (uint32_t i = APP_LUMA_STATS_BELOW_BINS; i > 0U; i--) {
+			if (above[i - 1U] != 0U) {
+				max_y = (i == APP_LUMA_STATS_BELOW_BINS) ? 255U
+						: (uint8_t) (app_luma_stats_above_edge[i] - 1U);
+				break;
+			}
+		}
+	}
+
+	/* Bright pixels: the count above the first edge at or past the level. */
+	for (uint32_t i = 0U; i < APP_LUMA_STATS_BELOW_BINS; i++) {
+		if (app_luma_stats_above_edge[i] >= bright_level) {
+			bright = above[i];
+			break;
+		}
+	}
+
+	while ((total >> shift) > APP_LUMA_STATS_MAX_COUNT) {
+		shift++;
+	}
+	stats_ptr->sample_count = (uint32_t) (total >> shift);
+	stats_ptr->bright_sample_count = bright >> shift;
+	stats_ptr->min_y = min_y;
+	stats_ptr->max_y = max_y;
+	stats_ptr->mean_y = mean_y;
+	return true;
+}
+
+/**
+ * @brief Sample every step-th pixel of every step-th row of a region.
+ */
+bool AppLumaStats_SampleRegion(const uint8_t *frame_ptr, size_t length_bytes,
+		const AppLumaStats_Region_t *region_ptr, uint32_t step,
+		uint8_t bright_level, AppLumaStats_t *stats_ptr,
+		uint32_t *histogram_ptr) {
+	uint64_t sum_y = 0U;
+	uint32_t sample_count = 0U;
+	uint32_t bright_sample_count = 0U;
+	uint32_t stride_bytes = 0U;
+	uint8_t min_y = 0xFFU;
+	uint8_t max_y = 0U;
+
+	if ((frame_ptr == NULL) || (region_ptr == NULL) || (stats_ptr == NULL)
+			|| (step == 0U) || (region_ptr->bytes_per_pixel == 0U)
+			|| (region_ptr->x_end > region_ptr->width_pixels)
+			|| (region_ptr->x_min >= region_ptr->x_end)
+			|| (region_ptr->y_min >= region_ptr->y_end)) {
+		return false;
+	}
+	stride_bytes = region_ptr->width_pixels * region_ptr->bytes_per_pixel;
+	if (((size_t) (region_ptr->y_end - 1U) * stride_bytes
+			+ (size_t) region_ptr->x_end * region_ptr->bytes_per_pixel)
+			> length_bytes) {
+		return false;
+	}
+
+	if (histogram_ptr != NULL) {
+		(void) memset(histogram_ptr, 0,
+				APP_LUMA_STATS_HISTOGRAM_BINS * sizeof(histogram_ptr[0]));
+	}
+
+	for (uint32_t row = region_ptr->y_min; row < region_ptr->y_end;
+			row += step) {
+		const uint8_t *row_ptr = &frame_ptr[(size_t) row * stride_bytes];
+
+		for (uint32_t col = region_ptr->x_min; col < region_ptr->x_end;
+				col += step) {
+			const uint8_t y_sample = row_ptr[col * region_ptr->bytes_per_pixel];
+
+			if (y_sample < min_y) {
+				min_y = y_sample;
+			}
+			if (y_sample > max_y) {
+				max_y = y_sample;
+			}
+			if (y_sample >= bright_level) {
+				bright_sample_count++;
+			}
+			if (histogram_ptr != NULL) {
+				histogram_ptr[y_sample]++;
+			}
+			sum_y += y_sample;
+			sample_count++;
+		}
+	}
+
+	stats_ptr->sample_count = sample_count;
+	stats_ptr->bright_sample_count = bright_sample_count;
+	stats_ptr->min_y = min_y;
+	stats_ptr->max_y = max_y;
+	stats_ptr->mean_y = (uint32_t) (sum_y / sample_count);
+	return true;
+}
+
+bool AppLumaStats_AnyNonZero(const uint8_t *buffer_ptr, size_t length_bytes,
+		uint32_t stride_words) {
+	const size_t word_count = length_bytes / sizeof(uint32_t);
+	uint32_t word = 0U;
+
+	if ((buffer_ptr == NULL) || (stride_words == 0U)) {
+		return false;
+	}
+
+	for (size_t i = 0U; i < word_count; i += stride_words) {
+		(void) memcpy(&word, &buffer_ptr[i * sizeof(uint32_t)], sizeof(word));
+		if (word != 0U) {
+			return true;
+		}
+	}
+	/* A tail shorter than a word is still part of the frame. */
+	for (size_t i = word_count * sizeof(uint32_t); i < length_bytes; i++) {
+		if (buffer_ptr[i] != 0U) {
+			return true;
+		}
+	}
+	return false;
+}
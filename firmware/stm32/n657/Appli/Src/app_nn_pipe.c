@@ -0,0 +1,183 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_nn_pipe.c
+ * @brief   Layout and quantization of the ancillary DCMIPP NN pipe frame.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#include "app_nn_pipe.h"
+
+#include <string.h>
+
+AppNnPipe_Status_t AppNnPipe_PlanLayout(const AppNnPipe_Request_t *request_ptr,
+		AppNnPipe_Layout_t *layout_ptr) {
+	const AppNnPipe_Request_t *const r = request_ptr;
+	float resize_scale = 0.0f;
+	uint32_t resized_width = 0U;
+	uint32_t resized_height = 0U;
+
+	if ((r == NULL) || (layout_ptr == NULL) || (r->frame_width == 0U)
+			|| (r->frame_height == 0U) || (r->window_width == 0U)
+			|| (r->window_height == 0U) || (r->crop_width == 0U)
+			|| (r->crop_height == 0U) || (r->model_width == 0U)
+			|| (r->model_height == 0U)
+			|| ((r->crop_x + r->crop_width) > r->frame_width)
+			|| ((r->crop_y + r->crop_height) > r->frame_height)) {
+		return APP_NN_PIPE_BAD_REQUEST;
+	}
+	(void) memset(layout_ptr, 0, sizeof(*layout_ptr));
+
+	layout_ptr->roi_x = r->window_x
+			+ (uint32_t) (((uint64_t) r->crop_x * r->window_width)
+					/ r->frame_width);
+	layout_ptr->roi_y = r->window_y
+			+ (uint32_t) (((uint64_t) r->crop_y * r->window_height)
+					/ r->frame_height);
+	layout_ptr->roi_width = (uint32_t) (((uint64_t) r->crop_width
+			* r->window_width) / r->frame_width);
+	layout_ptr->roi_height = (uint32_t) (((uint64_t) r->crop_height
+			* r->window_height) / r->frame_height);
+
+	/* Same fit as the CPU resize so both paths letterbox identically. */
+	resize_scale = (float) r->model_width / (float) r->crop_width;
+	if (((float) r->model_height / (float) r->crop_height) < resize_scale) {
+		resize_scale = (float) r->model_height / (float) r->crop_height;
+	}
+	resized_width = (uint32_t) (((float) r->crop_width * resize_scale) + 0.5f);
+	resized_height = (uint32_t) (((float) r->crop_height * resize_scale)
+			+ 0.5f);
+	if (resized_width == 0U) {
+		resized_width = 1U;
+	}
+	if (resized_height == 0U) {
+		resized_height = 1U;
+	}
+	if (resized_width > r->model_width) {
+		resized_width = r->model_width;
+	}
+	if (resized_height > r->model_height) {
+		resized_height = r->model_height;
+	}
+
+	layout_ptr->output_width = resized_width;
+	layout_ptr->output_height = resized_height;
+	layout_ptr->pad_x = (r->model_width - resized_width) / 2U;
+	layout_ptr->pad_y = (r->model_height - resized_height) / 2U;
+	layout_ptr->model_width = r->model_width;
+	layout_ptr->model_height = r->model_height;
+	layout_ptr->pitch_bytes = r->model_width * APP_NN_PIPE_BYTES_PER_PIXEL;
+	layout_ptr->tensor_bytes = layout_ptr->pitch_bytes * r->model_height;
+	layout_ptr->write_offset_bytes = (layout_ptr->pad_y
+			* layout_ptr->pitch_bytes)
+			+ (layout_ptr->pad_x * APP_NN_PIPE_BYTES_PER_PIXEL);
+
+	if ((r->align_bytes != 0U)
+			&& ((layout_ptr->pitch_bytes % r->align_bytes) != 0U)) {
+		return APP_NN_PIPE_PITCH_UNALIGNED;
+	}
+	if ((r->align_bytes != 0U)
+			&& ((layout_ptr->write_offset_bytes % r->align_bytes) != 0U)) {
+		return APP_NN_PIPE_OFFSET_UNALIGNED;
+	}
+	return APP_NN_PIPE_OK;
+}
+
+void AppNnPipe_BuildQuant(float scale, int32_t zero_point, bool is_unsigned,
+		AppNnPipe_Quant_t *quant_ptr) {
+	const int32_t q_min = is_unsigned ? 0 : -128;
+	const int32_t q_max = is_unsigned ? 255 : 127;
+	bool is_copy = true;
+	bool is_flip = true;
+
+	if (quant_ptr == NULL) {
+		return;
+	}
+	if (scale <= 0.0f) {
+		scale = 1.0f / 255.0f;
+	}
+	for (uint32_t value = 0U; value < 256U; value++) {
+		const float scaled = ((float) value / 255.0f) / scale;
+		/* Round half away from zero, like lroundf in the CPU path. */
+		int32_t q = (int32_t) (scaled + 0.5f) + zero_point;
+
+		if (q < q_min) {
+			q = q_min;
+		}
+		if (q > q_max) {
+			q = q_max;
+		}
+		quant_ptr->table[value] = (uint8_t) q;
+		is_copy = is_copy && (quant_ptr->table[value] == (uint8_t) value);
+		is_flip = is_flip
+				&& (quant_ptr->table[value] == (uint8_t) (value ^ 0x80U));
+	}
+	quant_ptr->kind = is_copy ? APP_NN_PIPE_QUANT_COPY :
+			(is_flip ? APP_NN_PIPE_QUANT_FLIP_SIGN : APP_NN_PIPE_QUANT_TABLE);
+}
+
+void AppNnPipe_Quantize(const AppNnPipe_Quant_t *quant_ptr,
+		const uint8_t *image_ptr, uint8_t *tensor_ptr, size_t length_bytes) {
+	size_t index = 0U;
+
+	if ((quant_ptr == NULL) || (image_ptr == NULL) || (tensor_ptr == NULL)) {
+		return;
+	}
+	switch (quant_ptr->kind) {
+	case APP_NN_PIPE_QUANT_COPY:
+		if (image_ptr != tensor_ptr) {
+			(void) memmove(tensor_ptr, image_ptr, length_bytes);
+		}
+		break;
+	case APP_NN_PIPE_QUANT_FLIP_SIGN:
+		if (((((uintptr_t) image_ptr) | ((uintptr_t) tensor_ptr))
+				& (sizeof(uint32_t) - 1U)) == 0U) {
+			for (; (index + sizeof(uint32_t)) <= length_bytes;
+					index += sizeof(uint32_t)) {
+				uint32_t word = 0U;
+
+				(void) memcpy(&word, &image_ptr[index], sizeof(word));
+				word ^= 0x80808080UL;
+				(void) memcpy(&tensor_ptr[index], &word, sizeof(word));
+			}
+		}
+		for (; index < length_bytes; index++) {
+			tensor_ptr[index] = (uint8_t) (image_ptr[index] ^ 0x80U);
+		}
+		break;
+	default:
+		for (; index < length_bytes; index++) {
+			tensor_ptr[index] = quant_ptr->table[image_ptr[index]];
+		}
+		break;
+	}
+}
+
+const char *AppNnPipe_StatusName(AppNnPipe_Status_t status) {
+	switch (status) {
+	case APP_NN_PIPE_OK:
+		return "ok";
+	case APP_NN_PIPE_BAD_REQUEST:
+		return "bad-request";
+	case APP_NN_PIPE_PITCH_UNALIGNED:
+		return "pitch-unaligned";
+	case APP_NN_PIPE_OFFSET_UNALIGNED:
+		return "offset-unaligned";
+	default:
+		return "unknown";
+	}
+}
+
+const char *AppNnPipe_QuantKindName(AppNnPipe_QuantKind_t kind) {
+	switch (kind) {
+	case APP_NN_PIPE_QUANT_COPY:
+		return "copy";
+	case APP_NN_PIPE_QUANT_FLIP_SIGN:
+		return "flip-sign";
+	case APP_NN_PIPE_QUANT_TABLE:
+		return "table";
+	default:
+		return "unknown";
+	}
+}
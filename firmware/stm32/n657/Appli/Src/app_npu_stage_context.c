@@ -0,0 +1,216 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_npu_stage_context.c
+ * @brief   Init-once bookkeeping for the NPU execution context of each stage.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#include "app_npu_stage_context.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#define APP_NPU_STAGE_CONTEXT_FNV_OFFSET  2166136261UL
+#define APP_NPU_STAGE_CONTEXT_FNV_PRIME   16777619UL
+
+/** @brief Index of the entry for a stage, or entry_count when absent. */
+static uint32_t AppNpuStageContext_Find(
+		const AppNpuStageContext_Table_t *table_ptr, const void *stage_key) {
+	uint32_t index = 0U;
+
+	while ((index < table_ptr->entry_count)
+			&& (table_ptr->entries[index].stage_key != stage_key)) {
+		index++;
+	}
+	return index;
+}
+
+/** @brief Fold one sample into a timing record. */
+static void AppNpuStageContext_AddTiming(AppNpuStageContext_Timing_t *timing_ptr,
+		uint32_t elapsed_us) {
+	timing_ptr->count++;
+	timing_ptr->last_us = elapsed_us;
+	timing_ptr->total_us += elapsed_us;
+	if (elapsed_us > timing_ptr->max_us) {
+		timing_ptr->max_us = elapsed_us;
+	}
+}
+
+void AppNpuStageContext_Init(AppNpuStageContext_Table_t *table_ptr) {
+	if (table_ptr == NULL) {
+		return;
+	}
+	(void) memset(table_ptr, 0, sizeof(*table_ptr));
+}
+
+uint32_t AppNpuStageContext_Signature(const uint32_t *words_ptr,
+		uint32_t word_count) {
+	uint32_t hash = (uint32_t) APP_NPU_STAGE_CONTEXT_FNV_OFFSET;
+
+	if (words_ptr == NULL) {
+		return hash;
+	}
+	for (uint32_t index = 0U; index < word_count; index++) {
+		uint32_t word = words_ptr[index];
+
+		for (uint32_t byte = 0U; byte < 4U; byte++) {
+			hash ^= (word & 0xFFU);
+			hash *= (uint32_t) APP_NPU_STAGE_CONTEXT_FNV_PRIME;
+			word >>= 8U;
+		}
+	}
+	return hash;
+}
+
+AppNpuStageContext_Action_t AppNpuStageContext_Plan(
+		AppNpuStageContext_Table_t *table_ptr, const void *stage_key,
+		uint32_t signature, AppNpuStageContext_Reason_t *reason_out) {
+	AppNpuStageContext_Entry_t *entry_ptr = NULL;
+	AppNpuStageContext_Reason_t reason = APP_NPU_STAGE_CONTEXT_REASON_FIRST_USE;
+	uint32_t index = 0U;
+
+	if ((table_ptr != NULL) && (stage_key != NULL)) {
+		index = AppNpuStageContext_Find(table_ptr, stage_key);
+		if (index < table_ptr->entry_count) {
+			entry_ptr = &table_ptr->entries[index];
+		} else if (table_ptr->entry_count < APP_NPU_STAGE_CONTEXT_MAX_STAGES) {
+			entry_ptr = &table_ptr->entries[table_ptr->entry_count++];
+			(void) memset(entry_ptr, 0, sizeof(*entry_ptr));
+			entry_ptr->stage_key = stage_key;
+		}
+	}
+
+	if ((entry_ptr != NULL) && entry_ptr->live) {
+		if (entry_ptr->signature == signature) {
+			reason = APP_NPU_STAGE_CONTEXT_REASON_NONE;
+		} else {
+			entry_ptr->live = false;
+			entry_ptr->integrity_failures++;
+			reason = APP_NPU_STAGE_CONTEXT_REASON_CORRUPTED;
+		}
+	} else if ((entry_ptr != NULL) && (entry_ptr->init.count > 0U)) {
+		reason = APP_NPU_STAGE_CONTEXT_REASON_INVALIDATED;
+	}
+
+	if (entry_ptr != NULL) {
+		entry_ptr->last_reason = reason;
+	}
+	if (reason_out != NULL) {
+		*reason_out = reason;
+	}
+	return (reason == APP_NPU_STAGE_CONTEXT_REASON_NONE) ?
+			APP_NPU_STAGE_CONTEXT_REARM : APP_NPU_STAGE_CONTEXT_FULL_INIT;
+}
+
+bool AppNpuStageContext_MarkInitialized(AppNpuStageContext_Table_t *table_ptr,
+		const void *stage_key, uint32_t signature, uint32_t elapsed_us) {
+	AppNpuStageContext_Entry_t *entry_ptr = NULL;
+	uint32_t index = 0U;
+
+	if ((table_ptr == NULL) || (stage_key == NULL)) {
+		return false;
+	}
+	index = AppNpuStageContext_Find(table_ptr, stage_key);
+	if (index == table_ptr->entry_count) {
+		return false;
+	}
+	entry_ptr = &table_ptr->entries[index];
+	entry_ptr->signature = signature;
+	entry_ptr->live = true;
+	AppNpuStageContext_AddTiming(&entry_ptr->init, elapsed_us);
+	return true;
+}
+
+bool AppNpuStageContext_RecordRearm(AppNpuStageContext_Table_t *table_ptr,
+		const void *stage_key, uint32_t elapsed_us) {
+	uint32_t index = 0U;
+
+	if ((table_ptr == NULL) || (stage_key == NULL)) {
+		return false;
+	}
+	index = AppNpuStageContext_Find(table_ptr, stage_key);
+	if (index == table_ptr->entry_count) {
+		return false;
+	}
+	AppNpuStageContext_AddTiming(&table_ptr->entries[index].rearm, elapsed_us);
+	return true;
+}
+
+bool AppNpuStageContext_RecordRun(AppNpuStageContext_Table_t *table_ptr,
+		const void *stage_key, uint32_t npu_run_count) {
+	uint32_t index = 0U;
+
+	if ((table_ptr == NULL) || (stage_key == NULL)) {
+		return false;
+	}
+	index = AppNpuStageContext_Find(table_ptr, stage_key);
+	if (index == table_ptr->entry_count) {
+		return false;
+	}
+	table_ptr->entries[index].last_run_count = npu_run_count;
+	return true;
+}
+
+void AppNpuStageContext_InvalidateDisplaced(
+		AppNpuStageContext_Table_t *table_ptr, uint32_t npu_run_count) {
+	if (table_ptr == NULL) {
+		return;
+	}
+	for (uint32_t index = 0U; index < table_ptr->entry_count; index++) {
+		AppNpuStageContext_Entry_t *const entry_ptr = &table_ptr->entries[index];
+
+		if (entry_ptr->live && (entry_ptr->last_run_count != npu_run_count)) {
+			entry_ptr->live = false;
+		}
+	}
+}
+
+void AppNpuStageContext_Invalidate(AppNpuStageContext_Table_t *table_ptr,
+		const void *stage_key) {
+	uint32_t index = 0U;
+
+	if ((table_ptr == NULL) || (stage_key == NULL)) {
+		return;
+	}
+	index = AppNpuStageContext_Find(table_ptr, stage_key);
+	if (index < table_ptr->entry_count) {
+		table_ptr->entries[index].live = false;
+	}
+}
+
+void AppNpuStageContext_InvalidateAll(AppNpuStageContext_Table_t *table_ptr) {
+	if (table_ptr == NULL) {
+		return;
+	}
+	for (uint32_t index = 0U; index < table_ptr->entry_count; index++) {
+		table_ptr->entries[index].live = false;
+	}
+}
+
+const AppNpuStageContext_Entry_t *AppNpuStageContext_Get(
+		const AppNpuStageContext_Table_t *table_ptr, const void *stage_key) {
+	uint32_t index = 0U;
+
+	if ((table_ptr == NULL) || (stage_key == NULL)) {
+		return NULL;
+	}
+	index = AppNpuStageContext_Find(table_ptr, stage_key);
+	return (index < table_ptr->entry_count) ? &table_ptr->entries[index] : NULL;
+}
+
+const char *AppNpuStageContext_ReasonName(AppNpuStageContext_Reason_t reason) {
+	switch (reason) {
+	case APP_NPU_STAGE_CONTEXT_REASON_NONE:
+		return "none";
+	case APP_NPU_STAGE_CONTEXT_REASON_FIRST_USE:
+		return "first-use";
+	case APP_NPU_STAGE_CONTEXT_REASON_INVALIDATED:
+		return "invalidated";
+	case APP_NPU_STAGE_CONTEXT_REASON_CORRUPTED:
+		return "corrupted";
+	default:
+		return "unknown";
+	}
+}
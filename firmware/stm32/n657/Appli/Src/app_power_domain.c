@@ -0,0 +1,187 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_power_domain.c
+ * @brief   Reference-counted gating for peripheral power domains.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#include "app_power_domain.h"
+
+#include <stddef.h>
+#include <string.h>
+
+static AppPowerDomain_State_t *AppPowerDomain_Lookup(
+		AppPowerDomain_Context_t *context_ptr, AppPowerDomain_Id_t id) {
+	if ((context_ptr == NULL) || (id >= APP_POWER_DOMAIN_COUNT)
+			|| !context_ptr->domain[id].registered) {
+		return NULL;
+	}
+	return &context_ptr->domain[id];
+}
+
+/**
+ * @brief Run the retain and disable hooks and close the on-time interval.
+ */
+static void AppPowerDomain_Gate(AppPowerDomain_State_t *domain_ptr,
+		uint32_t now_ms) {
+	if (domain_ptr->hooks.retain != NULL) {
+		domain_ptr->hooks.retain();
+	}
+	if (domain_ptr->hooks.disable != NULL) {
+		domain_ptr->hooks.disable();
+	}
+	domain_ptr->on_time_ms += (uint32_t) (now_ms - domain_ptr->on_since_ms);
+	domain_ptr->powered = false;
+	domain_ptr->gate_pending = false;
+	domain_ptr->gate_count++;
+}
+
+void AppPowerDomain_Init(AppPowerDomain_Context_t *context_ptr) {
+	if (context_ptr == NULL) {
+		return;
+	}
+	(void) memset(context_ptr, 0, sizeof(*context_ptr));
+}
+
+void AppPowerDomain_Register(AppPowerDomain_Context_t *context_ptr,
+		AppPowerDomain_Id_t id, const AppPowerDomain_Hooks_t *hooks_ptr,
+		bool powered, uint32_t now_ms) {
+	AppPowerDomain_State_t *domain_ptr = NULL;
+
+	if ((context_ptr == NULL) || (id >= APP_POWER_DOMAIN_COUNT)
+			|| (hooks_ptr == NULL)) {
+		return;
+	}
+
+	domain_ptr = &context_ptr->domain[id];
+	(void) memset(domain_ptr, 0, sizeof(*domain_ptr));
+	domain_ptr->hooks = *hooks_ptr;
+	domain_ptr->registered = true;
+	domain_ptr->powered = powered;
+	domain_ptr->on_since_ms = now_ms;
+}
+
+/**
+ * @brief Take a reference, ungating the domain if it was off.
+ */
+bool AppPowerDomain_Acquire(AppPowerDomain_Context_t *context_ptr,
+		AppPowerDomain_Id_t id, uint32_t now_ms) {
+	AppPowerDomain_State_t *domain_ptr = AppPowerDomain_Lookup(context_ptr,
+			id);
+
+	if (domain_ptr == NULL) {
+		return false;
+	}
+
+	if (!domain_ptr->powered) {
+		if ((domain_ptr->hooks.enable != NULL) && !domain_ptr->hooks.enable()) {
+			return false;
+		}
+		domain_ptr->powered = true;
+		domain_ptr->on_since_ms = now_ms;
+		domain_ptr->enable_count++;
+	}
+
+	domain_ptr->gate_pending = false;
+	domain_ptr->ref_count++;
+	return true;
+}
+
+/**
+ * @brief Drop a reference; the last one starts the minimum-off window.
+ */
+void AppPowerDomain_Release(AppPowerDomain_Context_t *context_ptr,
+		AppPowerDomain_Id_t id, uint32_t now_ms) {
+	AppPowerDomain_State_t *domain_ptr = AppPowerDomain_Lookup(context_ptr,
+			id);
+
+	/* An unbalanced release must not gate a block someone else still uses. */
+	if ((domain_ptr == NULL) || (domain_ptr->ref_count == 0U)) {
+		return;
+	}
+
+	domain_ptr->ref_count--;
+	if (domain_ptr->ref_count != 0U) {
+		return;
+	}
+
+	if (domain_ptr->hooks.min_off_ms == 0U) {
+		AppPowerDomain_Gate(domain_ptr, now_ms);
+		return;
+	}
+	domain_ptr->gate_pending = true;
+	domain_ptr->released_ms = now_ms;
+}
+
+/**
+ * @brief Gate every domain whose minimum-off window has run out.
+ */
+uint32_t AppPowerDomain_Service(AppPowerDomain_Context_t *context_ptr,
+		uint32_t now_ms) {
+	uint32_t next_due_ms = APP_POWER_DOMAIN_NONE_PENDING;
+
+	if (context_ptr == NULL) {
+		return next_due_ms;
+	}
+
+	for (uint32_t i = 0U; i < (uint32_t) APP_POWER_DOMAIN_COUNT; i++) {
+		AppPowerDomain_State_t *domain_ptr = &context_ptr->domain[i];
+		uint32_t idle_ms = 0U;
+
+		if (!domain_ptr->registered || !domain_ptr->gate_pending) {
+			continue;
+		}
+
+		idle_ms = now_ms - domain_ptr->released_ms;
+		if (idle_ms >= domain_ptr->hooks.min_off_ms) {
+			AppPowerDomain_Gate(domain_ptr, now_ms);
+		} else if ((domain_ptr->hooks.min_off_ms - idle_ms) < next_due_ms) {
+			next_due_ms = domain_ptr->hooks.min_off_ms - idle_ms;
+		}
+	}
+	return next_due_ms;
+}
+
+bool AppPowerDomain_IsPowered(const AppPowerDomain_Context_t *context_ptr,
+		AppPowerDomain_Id_t id) {
+	if ((context_ptr == NULL) || (id >= APP_POWER_DOMAIN_COUNT)) {
+		return false;
+	}
+	return context_ptr->domain[id].powered;
+}
+
+/**
+ * @brief Total ungated time, including the interval still running.
+ */
+uint64_t AppPowerDomain_OnTimeMs(const AppPowerDomain_Context_t *context_ptr,
+		AppPowerDomain_Id_t id, uint32_t now_ms) {
+	const AppPowerDomain_State_t *domain_ptr = NULL;
+
+	if ((context_ptr == NULL) || (id >= APP_POWER_DOMAIN_COUNT)) {
+		return 0U;
+	}
+
+	domain_ptr = &context_ptr->domain[id];
+	if (!domain_ptr->powered) {
+		return domain_ptr->on_time_ms;
+	}
+	return domain_ptr->on_time_ms
+			+ (uint32_t) (now_ms - domain_ptr->on_since_ms);
+}
+
+const char *AppPowerDomain_Name(AppPowerDomain_Id_t id) {
+	switch (id) {
+	case APP_POWER_DOMAIN_NPU:
+		return "npu";
+	case APP_POWER_DOMAIN_XSPI2:
+		return "xspi2";
+	case APP_POWER_DOMAIN_CAMERA:
+		return "dcmipp";
+	case APP_POWER_DOMAIN_SD_SPI:
+		return "sd_spi";
+	default:
+		return "unknown";
+	}
+}
@@ -0,0 +1,111 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_sensor_power.c
+ * @brief   Sensor power-state policy for the idle gap between captures.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#include "app_sensor_power.h"
+
+#include <stddef.h>
+
+/**
+ * @brief Load the tunables and reset the wake estimates.
+ */
+void AppSensorPower_Init(AppSensorPower_Context_t *context_ptr,
+		const AppSensorPower_Config_t *config_ptr) {
+	if ((context_ptr == NULL) || (config_ptr == NULL)) {
+		return;
+	}
+
+	context_ptr->config = *config_ptr;
+	for (uint32_t i = 0U; i < (uint32_t) APP_SENSOR_POWER_STATE_COUNT; i++) {
+		context_ptr->wake_estimate_ms[i] = config_ptr->initial_wake_ms[i];
+		context_ptr->wake_count[i] = 0U;
+		context_ptr->wake_failures[i] = 0U;
+		context_ptr->disabled[i] = false;
+	}
+}
+
+/**
+ * @brief Pick the deepest state that can still wake before the deadline.
+ */
+AppSensorPower_State_t AppSensorPower_Choose(
+		const AppSensorPower_Context_t *context_ptr, uint32_t idle_ms) {
+	if (context_ptr == NULL) {
+		return APP_SENSOR_POWER_STREAMING;
+	}
+
+	for (uint32_t i = (uint32_t) APP_SENSOR_POWER_STATE_COUNT - 1U; i > 0U;
+			i--) {
+		const AppSensorPower_State_t state = (AppSensorPower_State_t) i;
+
+		if (context_ptr->disabled[i]) {
+			continue;
+		}
+		if ((idle_ms >= context_ptr->config.min_idle_ms[i])
+				&& (idle_ms >= AppSensorPower_WakeLeadMs(context_ptr, state))) {
+			return state;
+		}
+	}
+	return APP_SENSOR_POWER_STREAMING;
+}
+
+/**
+ * @brief Wake estimate plus guard for one state.
+ */
+uint32_t AppSensorPower_WakeLeadMs(const AppSensorPower_Context_t *context_ptr,
+		AppSensorPower_State_t state) {
+	if ((context_ptr == NULL) || (state >= APP_SENSOR_POWER_STATE_COUNT)) {
+		return 0U;
+	}
+	return context_ptr->wake_estimate_ms[state] + context_ptr->config.guard_ms;
+}
+
+/**
+ * @brief Fold one measured wake into the estimate for its state.
+ */
+void AppSensorPower_RecordWake(AppSensorPower_Context_t *context_ptr,
+		AppSensorPower_State_t state, bool success, uint32_t wake_ms) {
+	uint32_t *estimate_ptr = NULL;
+
+	if ((context_ptr == NULL) || (state >= APP_SENSOR_POWER_STATE_COUNT)) {
+		return;
+	}
+
+	if (!success) {
+		context_ptr->wake_failures[state]++;
+		if ((state != APP_SENSOR_POWER_STREAMING)
+				&& (context_ptr->config.max_wake_failures != 0U)
+				&& (context_ptr->wake_failures[state]
+						>= context_ptr->config.max_wake_failures)) {
+			context_ptr->disabled[state] = true;
+		}
+		return;
+	}
+
+	estimate_ptr = &context_ptr->wake_estimate_ms[state];
+	if ((context_ptr->wake_count[state] == 0U) || (wake_ms >= *estimate_ptr)) {
+		/* The first measurement replaces the guess outright. */
+		*estimate_ptr = wake_ms;
+	} else {
+		*estimate_ptr -= (*estimate_ptr - wake_ms) / 4U;
+	}
+	context_ptr->wake_count[state]++;
+	context_ptr->wake_failures[state] = 0U;
+}
+
+const char *AppSensorPower_StateName(AppSensorPower_State_t state) {
+	switch (state) {
+	case APP_SENSOR_POWER_STREAMING:
+		return "streaming";
+	case APP_SENSOR_POWER_STANDBY:
+		return "standby";
+	case APP_SENSOR_POWER_OFF:
+		return "off";
+	default:
+		return "unknown";
+	}
+}
@@ -31,25 +31,35 @@
 #include "app_camera_config.h"
 #include "app_camera_buffers.h"
 #include "app_camera_capture.h"
+#include "app_capture_events.h"
+#include "app_capture_storage.h"
+#include "app_capture_schedule.h"
+#include "app_exposure_memory.h"
+#include "app_clocks.h"
 #include "app_camera_platform.h"
 #include "app_baseline_runtime.h"
+#include "app_boot.h"
 #include "app_ai_config.h"
 #include "app_inference_runtime.h"
 #include "app_image_cleanup.h"
+#include "app_low_power.h"
 #include "app_storage.h"
 #include "app_threadx_config.h"
 #include "app_memory_budget.h"
 #include "app_filex.h"
 #include "app_ai.h"
+#include "app_ai_xspi2.h"
 #include "main.h"
 #include "debug_console.h"
 #include "debug_led.h"
+#include "ds3231_clock.h"
 #include "threadx_utils.h"
 #include "cmw_camera.h"
 #include "cmw_imx335.h"
 #include "cmw_utils.h"
 #include "imx335.h"
 #include "imx335_reg.h"
+#include "inference_metrics.h"
 
 /* USER CODE END Includes */
 
@@ -76,6 +86,11 @@ static TX_THREAD camera_init_thread;
 static ULONG camera_init_thread_stack[CAMERA_INIT_THREAD_STACK_SIZE_BYTES
 		/ sizeof(ULONG)];
 static bool camera_init_thread_created = false;
+/* AI boot lane: brings up the NPU and model while the camera probes. */
+static TX_THREAD boot_ai_thread;
+static ULONG boot_ai_thread_stack[BOOT_AI_THREAD_STACK_SIZE_BYTES
+		/ sizeof(ULONG)];
+static bool boot_ai_thread_created = false;
 static TX_THREAD camera_isp_thread;
 static ULONG camera_isp_thread_stack[CAMERA_ISP_THREAD_STACK_SIZE_BYTES
 		/ sizeof(ULONG)];
@@ -91,7 +106,10 @@ bool camera_cmw_initialized = false;
 /* Keep the middleware path active so the ISP/AEC pipeline can produce optical
  * frames instead of the raw sensor dump. */
 bool camera_capture_use_cmw_pipeline = false;
-TX_SEMAPHORE camera_capture_done_semaphore;
+/* Capture completion: the DCMIPP/CSI callbacks feed the state machine and
+ * raise one flag per event; the capture thread blocks on READY/FAILED. */
+TX_EVENT_FLAGS_GROUP camera_capture_events;
+AppCaptureEvents_Context_t camera_capture_event_state;
 TX_SEMAPHORE camera_capture_isp_semaphore;
 static bool camera_capture_sync_created = false;
 bool camera_stream_started = false;
@@ -108,6 +126,12 @@ volatile uint32_t camera_capture_line_error_mask = 0U;
 volatile uint32_t camera_capture_csi_linebyte_event_count = 0U;
 volatile bool camera_capture_csi_linebyte_event_logged = false;
 volatile uint32_t camera_capture_vsync_event_count = 0U;
+/* VSYNC count when each pipe finished its frame: equal counts mean the main
+ * and NN pipe frames came from the same exposure. */
+volatile uint32_t camera_capture_frame_vsync_count = 0U;
+volatile uint32_t camera_nn_frame_event_count = 0U;
+volatile uint32_t camera_nn_frame_vsync_count = 0U;
+volatile bool camera_nn_frame_failed = false;
 volatile uint32_t camera_capture_isp_run_count = 0U;
 volatile bool camera_capture_isp_loop_paused = false;
 /* Count raw IRQ entry points so we can tell whether the interrupt chain is
@@ -117,6 +141,12 @@ volatile uint32_t camera_capture_dcmipp_irq_count = 0U;
 volatile uint32_t camera_capture_reported_byte_count = 0U;
 volatile uint32_t camera_capture_counter_status = (uint32_t) HAL_ERROR;
 
+#if CAMERA_CAPTURE_ADAPTIVE_SCHEDULE_ENABLED
+/* Adaptive capture cadence, owned by the camera init thread. */
+static AppCaptureSchedule_Context_t camera_capture_schedule;
+static ULONG camera_capture_schedule_baseline_generation = 0U;
+#endif
+
 /* Reuse the CubeMX-generated camera control I2C instance from main.c. */
 extern DCMIPP_HandleTypeDef hdcmipp;
 extern I2C_HandleTypeDef hi2c2;
@@ -128,6 +158,8 @@ extern I2C_HandleTypeDef hi2c2;
 
 static VOID CameraHeartbeatThread_Entry(ULONG thread_input);
 static VOID AppThreadX_StackErrorHandler(TX_THREAD *thread_ptr);
+static void AppThreadX_PostCaptureEvent(AppCaptureEvents_Event_t event,
+		uint32_t error_code);
 
 /**
  * @brief ThreadX entry point used to run camera bring-up diagnostics.
@@ -135,6 +167,11 @@ static VOID AppThreadX_StackErrorHandler(TX_THREAD *thread_ptr);
  */
 static VOID CameraInitThread_Entry(ULONG thread_input);
 static VOID CameraIspThread_Entry(ULONG thread_input);
+static VOID BootAiThread_Entry(ULONG thread_input);
+#if CAMERA_CAPTURE_ADAPTIVE_SCHEDULE_ENABLED
+static void CameraCaptureSchedule_Init(void);
+static uint32_t CameraCaptureSchedule_NextDelayMs(bool capture_ok);
+#endif
 
 /**
  * @brief ThreadX app initialization hook.
@@ -172,11 +209,11 @@ UINT App_ThreadX_Start(void) {
 	}
 
 	if (!camera_capture_sync_created) {
-		UINT semaphore_status = tx_semaphore_create(
-				&camera_capture_done_semaphore, "camera_capture_done", 0U);
+		UINT semaphore_status = tx_event_flags_create(&camera_capture_events,
+				"camera_capture_events");
 		if (semaphore_status != TX_SUCCESS) {
 			DebugConsole_Printf(
-					"[CAMERA][THREAD] Failed to create capture semaphore, status=%lu\r\n",
+					"[CAMERA][THREAD] Failed to create capture event flags, status=%lu\r\n",
 					(unsigned long) semaphore_status);
 			return semaphore_status;
 		}
@@ -213,6 +250,36 @@ UINT App_ThreadX_Start(void) {
 		}
 	}
 
+	{
+		const UINT boot_init_status = AppBoot_Init();
+		if (boot_init_status != TX_SUCCESS) {
+			DebugConsole_Printf(
+					"[BOOT] Failed to create boot orchestrator, status=%lu\r\n",
+					(unsigned long) boot_init_status);
+			return boot_init_status;
+		}
+	}
+
+	{
+		const UINT domain_init_status = AppLowPower_InitDomains();
+		if (domain_init_status != TX_SUCCESS) {
+			DebugConsole_Printf(
+					"[POWER] Failed to create power-domain timer, status=%lu\r\n",
+					(unsigned long) domain_init_status);
+			return domain_init_status;
+		}
+	}
+
+	{
+		/* Without profiles the board just keeps its boot clocks. */
+		const UINT clock_init_status = AppClocks_Init();
+		if (clock_init_status != TX_SUCCESS) {
+			DebugConsole_Printf(
+					"[CLOCK] Clock profiles disabled, status=%lu\r\n",
+					(unsigned long) clock_init_status);
+		}
+	}
+
 	{
 		const UINT storage_init_status = AppStorage_Init();
 		if (storage_init_status != TX_SUCCESS) {
@@ -242,6 +309,16 @@ UINT App_ThreadX_Start(void) {
 		}
 	}
 
+	{
+		const UINT capture_storage_status = AppCaptureStorage_Start();
+		if (capture_storage_status != TX_SUCCESS) {
+			DebugConsole_Printf(
+					"[CAMERA][STORAGE] Failed to start storage worker, status=%lu\r\n",
+					(unsigned long) capture_storage_status);
+			return capture_storage_status;
+		}
+	}
+
 	{
 		AppBaselineRuntime_SetCalibrationProfileByName(
 			APP_BASELINE_CALIBRATION_PROFILE_NAME);
@@ -296,6 +373,22 @@ UINT App_ThreadX_Start(void) {
 				"[CAMERA][THREAD] Heartbeat thread created and started.\r\n");
 	}
 
+	if (!boot_ai_thread_created) {
+		const UINT boot_ai_create_status = tx_thread_create(&boot_ai_thread,
+				"boot_ai", BootAiThread_Entry, 0U, boot_ai_thread_stack,
+				sizeof(boot_ai_thread_stack), BOOT_AI_THREAD_PRIORITY,
+				BOOT_AI_THREAD_PRIORITY, TX_NO_TIME_SLICE, TX_AUTO_START);
+
+		if (boot_ai_create_status != TX_SUCCESS) {
+			DebugConsole_Printf(
+					"[BOOT] Failed to create AI boot lane thread, status=%lu\r\n",
+					(unsigned long) boot_ai_create_status);
+			return boot_ai_create_status;
+		}
+
+		boot_ai_thread_created = true;
+	}
+
 	if (!camera_init_thread_created) {
 		/* Create a dedicated thread so camera probing is isolated from other startup work. */
 		const UINT create_status = tx_thread_create(&camera_init_thread,
@@ -388,6 +481,120 @@ void MX_ThreadX_Init(void) {
 	/* USER CODE END Kernel_Start_Error */
 }
 
+/**
+ * @brief Camera-lane boot tasks: probe, sensor config, RTC re-read, AE seed.
+ * @param task Boot task the orchestrator scheduled on this lane.
+ * @retval true when the task succeeded.
+ */
+static bool CameraInitThread_RunBootTask(AppBoot_Task_t task) {
+	bool task_ok = false;
+
+	switch (task) {
+	case APP_BOOT_TASK_CAMERA_PROBE:
+	case APP_BOOT_TASK_SENSOR_CONFIG:
+		camera_capture_isp_loop_paused = true;
+		if (!App_ThreadX_LockCameraMiddleware(
+				CameraPlatform_MillisecondsToTicks(
+						CAMERA_MIDDLEWARE_LOCK_TIMEOUT_MS))) {
+			camera_capture_isp_loop_paused = false;
+			DebugConsole_Printf(
+					"[CAMERA][THREAD] Failed to lock camera middleware for probe.\r\n");
+			return false;
+		}
+
+		if (task == APP_BOOT_TASK_CAMERA_PROBE) {
+			(void) DebugConsole_WriteString("[CAMERA] probe start\r\n");
+			task_ok = (CameraPlatform_ProbeBCamsImx() == TX_SUCCESS);
+		} else {
+			task_ok = CameraPlatform_DisableImx335AutoExposure();
+			if (!task_ok) {
+				DebugConsole_Printf(
+						"[CAMERA][THREAD] Warning: failed to lock IMX335 exposure after probe.\r\n");
+			}
+		}
+		App_ThreadX_UnlockCameraMiddleware();
+		camera_capture_isp_loop_paused = false;
+
+		if ((task == APP_BOOT_TASK_CAMERA_PROBE) && task_ok) {
+			DebugConsole_Printf(
+					"[CAMERA][THREAD] Camera probe completed successfully.\r\n");
+
+			/* Start cleanup only after the camera has proven it can probe and
+			 * capture, so the background sweeper cannot interfere with startup. */
+			const UINT image_cleanup_start_status = AppImageCleanup_Start();
+			if (image_cleanup_start_status != TX_SUCCESS) {
+				DebugConsole_Printf(
+						"[IMAGE][CLEANUP] Deferred start failed, status=%lu.\r\n",
+						(unsigned long) image_cleanup_start_status);
+			}
+		}
+		return task_ok;
+
+	case APP_BOOT_TASK_RTC: {
+		char timestamp[32] = { 0 };
+
+		return App_Clock_GetCurrentTimestamp(timestamp, sizeof(timestamp));
+	}
+
+	case APP_BOOT_TASK_AE_SEED:
+		return AppCameraCapture_PrepareFirstCapture();
+
+	default:
+		return false;
+	}
+}
+
+/**
+ * @brief AI-lane boot tasks: NPU/RISAF bring-up, then model init.
+ * @param task Boot task the orchestrator scheduled on this lane.
+ * @retval true when the task succeeded.
+ */
+static bool BootAiThread_RunBootTask(AppBoot_Task_t task) {
+	switch (task) {
+	case APP_BOOT_TASK_NPU_CONFIG:
+		return AppAI_EnsureNpuHardwareReady();
+
+	case APP_BOOT_TASK_MODEL_INIT: {
+		/* Model init and the boot dry run read weights through the xSPI2
+		 * window and run the NPU; both gate again once the lane is done. */
+		const bool npu_held = AppLowPower_AcquireDomain(APP_POWER_DOMAIN_NPU);
+		const bool xspi2_held = AppLowPower_AcquireDomain(
+				APP_POWER_DOMAIN_XSPI2);
+		const bool model_ready = App_AI_Model_Init();
+
+		if (!model_ready) {
+			DebugConsole_Printf(
+					"[AI] Model runtime init failed; continuing without inference.\r\n");
+		}
+#if APP_AI_ENABLE_TIP_FOCUS_GEOMETRY_STAGE && APP_AI_ENABLE_TIP_FOCUS_BOOT_DRY_RUN
+		if (model_ready) {
+			(void)AppAI_TipFocus_DryRun();
+		}
+#endif
+		if (xspi2_held) {
+			AppLowPower_ReleaseDomain(APP_POWER_DOMAIN_XSPI2);
+		}
+		if (npu_held) {
+			AppLowPower_ReleaseDomain(APP_POWER_DOMAIN_NPU);
+		}
+		return model_ready;
+	}
+
+	default:
+		return false;
+	}
+}
+
+/**
+ * @brief ThreadX entry point for the AI boot lane; exits once its tasks ran.
+ * @param thread_input Unused ThreadX input value.
+ */
+static VOID BootAiThread_Entry(ULONG thread_input) {
+	(void) thread_input;
+
+	AppBoot_RunLane(APP_BOOT_LANE_AI, BootAiThread_RunBootTask);
+}
+
 /**
  * @brief ThreadX entry point used to run camera bring-up diagnostics.
  * @param thread_input Unused ThreadX input value.
@@ -398,79 +605,177 @@ static VOID CameraInitThread_Entry(ULONG thread_input) {
 	(void) DebugConsole_WriteString("[CAMERA] thread entry\r\n");
 	(void) DebugConsole_WriteString(
 			"[CAMERA][THREAD] Camera init startup delay skipped; probing immediately.\r\n");
-	(void) DebugConsole_WriteString("[CAMERA] probe start\r\n");
-	camera_capture_isp_loop_paused = true;
 
-	if (!App_ThreadX_LockCameraMiddleware(
-			CameraPlatform_MillisecondsToTicks(
-					CAMERA_MIDDLEWARE_LOCK_TIMEOUT_MS))) {
-		camera_capture_isp_loop_paused = false;
+	/* Probe, configure and seed the sensor while the AI lane brings up the
+	 * NPU and model on its own thread. */
+	AppBoot_RunLane(APP_BOOT_LANE_CAMERA, CameraInitThread_RunBootTask);
+	if (!AppBoot_TaskSucceeded(APP_BOOT_TASK_CAMERA_PROBE)) {
 		DebugConsole_Printf(
-				"[CAMERA][THREAD] Failed to lock camera middleware for probe.\r\n");
+				"[CAMERA][THREAD] Camera probe failed or is not configured yet.\r\n");
 		return;
 	}
 
-		if (CameraPlatform_ProbeBCamsImx() == TX_SUCCESS) {
-			if (!CameraPlatform_DisableImx335AutoExposure()) {
-				DebugConsole_Printf(
-						"[CAMERA][THREAD] Warning: failed to lock IMX335 exposure after probe.\r\n");
-			}
-			App_ThreadX_UnlockCameraMiddleware();
-			camera_capture_isp_loop_paused = false;
+	/* The first capture is only worth taking once the model can read it. */
+	if (!AppBoot_WaitForTasks(APP_BOOT_TASK_MASK(APP_BOOT_TASK_MODEL_INIT),
+			APP_BOOT_MODEL_INIT_WAIT_MS)) {
+		DebugConsole_Printf(
+				"[BOOT] Model init still running after %lu ms; capturing anyway.\r\n",
+				(unsigned long) APP_BOOT_MODEL_INIT_WAIT_MS);
+	}
+
+	BSP_LED_Off(LED_BLUE);
+#if CAMERA_CAPTURE_ADAPTIVE_SCHEDULE_ENABLED
+	CameraCaptureSchedule_Init();
+	DebugConsole_Printf(
+			"[CAMERA][THREAD] Entering capture/inference loop (adaptive period %lu-%lu s)...\r\n",
+			(unsigned long) (CAMERA_CAPTURE_PERIOD_MIN_MS / 1000U),
+			(unsigned long) (CAMERA_CAPTURE_PERIOD_MAX_MS / 1000U));
+#else
+	DebugConsole_Printf(
+			"[CAMERA][THREAD] Entering capture/inference loop (period=60s)...\r\n");
+#endif
+	while (1) {
+		const bool storage_ready = AppFileX_IsMediaReady();
+		uint32_t next_delay_ms = CAMERA_CAPTURE_PERIOD_MS;
+		bool capture_ok = false;
+
+		/* Capture and preprocess at full speed, then let the workers'
+		 * demands alone decide the clocks until the next reading. */
+		(void) AppClocks_SetDemand(APP_CLOCK_CLIENT_CAMERA,
+				APP_CLOCK_PROFILE_BOOST);
+		capture_ok = AppCameraCapture_CaptureAndStoreSingleFrame();
+		(void) AppClocks_SetDemand(APP_CLOCK_CLIENT_CAMERA,
+				APP_CLOCK_PROFILE_LOW);
+
+		if (capture_ok) {
 			DebugConsole_Printf(
-					"[CAMERA][THREAD] Camera probe completed successfully.\r\n");
+					"[CAMERA][THREAD] Capture and inference completed successfully.\r\n");
+		} else {
+			DebugConsole_Printf(
+					"[CAMERA][THREAD] Capture/inference attempt failed.\r\n");
+		}
 
-			/* Start cleanup only after the camera has proven it can probe and
-			 * capture, so the background sweeper cannot interfere with startup. */
-			{
-				const UINT image_cleanup_start_status = AppImageCleanup_Start();
-				if (image_cleanup_start_status != TX_SUCCESS) {
-					DebugConsole_Printf(
-							"[IMAGE][CLEANUP] Deferred start failed, status=%lu.\r\n",
-							(unsigned long) image_cleanup_start_status);
-				}
-			}
+#if CAMERA_CAPTURE_ADAPTIVE_SCHEDULE_ENABLED
+		next_delay_ms = CameraCaptureSchedule_NextDelayMs(capture_ok);
+#endif
 
-	if (!App_AI_Model_Init()) {
-				DebugConsole_Printf(
-					"[AI] Model runtime init failed; continuing without inference.\r\n");
+		/* While FileX is still coming up, retry sooner so the board keeps
+		 * producing visible progress instead of looking stalled for a full
+		 * minute between attempts. */
+		if (!storage_ready) {
+			next_delay_ms = 5000U;
 		}
 
-#if APP_AI_ENABLE_TIP_FOCUS_GEOMETRY_STAGE && APP_AI_ENABLE_TIP_FOCUS_BOOT_DRY_RUN
-		(void)AppAI_TipFocus_DryRun();
+		AppLowPower_LogStats();
+		AppClocks_LogEnergyPerReading();
+
+#if CAMERA_SENSOR_POWER_ENABLED
+		/* Park the sensor for the gap and wake early enough that its first
+		 * frame still lands on the schedule. */
+		{
+			const uint32_t wake_lead_ms = AppCameraCapture_EnterIdlePower(
+					next_delay_ms);
+
+			next_delay_ms = (next_delay_ms > wake_lead_ms) ?
+					(next_delay_ms - wake_lead_ms) : 0U;
+		}
 #endif
 
-		BSP_LED_Off(LED_BLUE);
-		DebugConsole_Printf(
-				"[CAMERA][THREAD] Entering capture/inference loop (period=60s)...\r\n");
-		while (1) {
-			const bool storage_ready = AppFileX_IsMediaReady();
-			uint32_t next_delay_ms = CAMERA_CAPTURE_PERIOD_MS;
+		/* Block on the timer wheel rather than polling every tick so the
+		 * idle hook can stop SysTick for the whole capture interval. */
+		AppLowPower_SleepCoalesced(next_delay_ms);
+	}
+}
 
-			if (AppCameraCapture_CaptureAndStoreSingleFrame()) {
-				DebugConsole_Printf(
-						"[CAMERA][THREAD] Capture and inference completed successfully.\r\n");
-			} else {
-				DebugConsole_Printf(
-						"[CAMERA][THREAD] Capture/inference attempt failed.\r\n");
-			}
+#if CAMERA_CAPTURE_ADAPTIVE_SCHEDULE_ENABLED
+/**
+ * @brief Load the adaptive capture schedule tunables.
+ */
+static void CameraCaptureSchedule_Init(void) {
+	const AppCaptureSchedule_Config_t config = {
+		.min_period_ms = CAMERA_CAPTURE_PERIOD_MIN_MS,
+		.base_period_ms = CAMERA_CAPTURE_PERIOD_MS,
+		.max_period_ms = CAMERA_CAPTURE_PERIOD_MAX_MS,
+		.stable_rate_per_min = CAMERA_CAPTURE_STABLE_RATE_PER_MIN,
+		.fast_rate_per_min = CAMERA_CAPTURE_FAST_RATE_PER_MIN,
+		.alarm_enabled = (CAMERA_CAPTURE_ALARM_ENABLED != 0U),
+		.alarm_low = CAMERA_CAPTURE_ALARM_LOW,
+		.alarm_high = CAMERA_CAPTURE_ALARM_HIGH,
+		.alarm_margin = CAMERA_CAPTURE_ALARM_MARGIN,
+		.daily_capture_budget = CAMERA_CAPTURE_DAILY_BUDGET,
+	};
+
+	AppCaptureSchedule_Init(&camera_capture_schedule, &config, HAL_GetTick());
+	camera_capture_schedule_baseline_generation =
+			AppBaselineRuntime_GetLastEstimateGeneration();
+}
 
-			/* While FileX is still coming up, retry sooner so the board keeps
-			 * producing visible progress instead of looking stalled for a full
-			 * minute between attempts. */
-			if (!storage_ready) {
-				next_delay_ms = 5000U;
-			}
+/**
+ * @brief Feed this cycle's reading to the schedule and pick the next delay.
+ *
+ * The AI value is preferred; when the AI worker holds or fails the frame, a
+ * fresh baseline estimate stands in so a flaky model does not pin the
+ * schedule to the base period.
+ *
+ * @param capture_ok true when the cycle produced a frame.
+ * @retval Delay until the next capture, net of the time spent waiting here.
+ */
+static uint32_t CameraCaptureSchedule_NextDelayMs(bool capture_ok) {
+	const uint32_t capture_ms = HAL_GetTick();
+	char timestamp[32] = { 0 };
+	AppExposureMemory_Time_t wall_time = { 0 };
+	bool reading_valid = false;
+	float reading = 0.0f;
+	uint32_t delay_ms = 0U;
+	uint32_t waited_ms = 0U;
+
+	/* Key the daily budget on the RTC day; without a clock it stays a 24 h
+	 * window from boot. */
+	if (App_Clock_GetCurrentTimestamp(timestamp, sizeof(timestamp))
+			&& AppExposureMemory_ParseTimestamp(timestamp, &wall_time)) {
+		AppCaptureSchedule_SyncWallClock(&camera_capture_schedule, capture_ms,
+				wall_time.date_code, wall_time.minute_of_day);
+	}
 
-			DelayMilliseconds_Cooperative(next_delay_ms);
+	if (capture_ok) {
+		const uint32_t inference_sequence =
+				AppInferenceRuntime_GetLastRequestSequence();
+		bool ai_published = false;
+		ULONG baseline_generation = 0U;
+
+		if ((inference_sequence != 0U)
+				&& AppInferenceRuntime_WaitForRequestOutcome(inference_sequence,
+						CAMERA_CAPTURE_SCHEDULE_OUTCOME_WAIT_MS, &ai_published)
+				&& ai_published) {
+			reading_valid = App_AI_GetLastInferenceResult(&reading);
 		}
+
+		baseline_generation = AppBaselineRuntime_GetLastEstimateGeneration();
+		if (!reading_valid
+				&& (baseline_generation
+						!= camera_capture_schedule_baseline_generation)) {
+			reading_valid = AppBaselineRuntime_GetLastEstimate(&reading, NULL);
+		}
+		camera_capture_schedule_baseline_generation = baseline_generation;
 	}
 
-	App_ThreadX_UnlockCameraMiddleware();
-	camera_capture_isp_loop_paused = false;
+	AppCaptureSchedule_RecordCapture(&camera_capture_schedule, capture_ms,
+			reading_valid, reading);
+	delay_ms = AppCaptureSchedule_NextPeriodMs(&camera_capture_schedule,
+			capture_ms);
+
 	DebugConsole_Printf(
-			"[CAMERA][THREAD] Camera probe failed or is not configured yet.\r\n");
+			"[CAMERA][SCHEDULE] next=%lu ms reason=%s rate=%ld mU/min today=%lu/%lu\r\n",
+			(unsigned long) delay_ms,
+			AppCaptureSchedule_ReasonName(camera_capture_schedule.last_reason),
+			(long) (camera_capture_schedule.last_rate_per_min * 1000.0f),
+			(unsigned long) camera_capture_schedule.day_capture_count,
+			(unsigned long) CAMERA_CAPTURE_DAILY_BUDGET);
+
+	waited_ms = HAL_GetTick() - capture_ms;
+	return (waited_ms < delay_ms) ? (delay_ms - waited_ms) : 0U;
 }
+#endif
 
 /**
  * @brief Low-priority heartbeat thread that toggles a visible board LED.
@@ -487,13 +792,34 @@ static VOID CameraHeartbeatThread_Entry(ULONG thread_input) {
 	while (1) {
 		BSP_LED_Toggle(LED_GREEN);
 		DebugConsole_WriteString("[WATCHDOG] pulse\r\n");
-		DelayMilliseconds_ThreadX(CAMERA_HEARTBEAT_PULSE_MS);
+		AppLowPower_SleepCoalesced(CAMERA_HEARTBEAT_PULSE_MS);
 		BSP_LED_Toggle(LED_GREEN);
-		DelayMilliseconds_ThreadX(CAMERA_HEARTBEAT_PERIOD_MS
+		AppLowPower_SleepCoalesced(CAMERA_HEARTBEAT_PERIOD_MS
 				- CAMERA_HEARTBEAT_PULSE_MS);
 	}
 }
 
+/**
+ * @brief Feed one capture event to the completion state machine.
+ *
+ * Callable from any DCMIPP/CSI callback; interrupts stay masked while the
+ * state advances so nested callbacks cannot interleave. Only the event that
+ * decides the frame raises READY or FAILED, so the capture thread sleeps
+ * through VSYNCs and frames it must not take.
+ */
+static void AppThreadX_PostCaptureEvent(AppCaptureEvents_Event_t event,
+		uint32_t error_code) {
+	TX_INTERRUPT_SAVE_AREA
+	AppCaptureEvents_State_t state = APP_CAPTURE_EVENTS_IDLE;
+
+	TX_DISABLE
+	state = AppCaptureEvents_Post(&camera_capture_event_state, event,
+			(uint32_t) Metrics_GetMicros(), error_code);
+	TX_RESTORE
+	(void) tx_event_flags_set(&camera_capture_events,
+			(ULONG) AppCaptureEvents_FlagsFor(event, state), TX_OR);
+}
+
 /**
  * @brief Low-priority camera ISP thread that keeps the middleware running.
  * @param thread_input Unused ThreadX input value.
@@ -505,15 +831,23 @@ static VOID CameraIspThread_Entry(ULONG thread_input) {
 			"[CAMERA][THREAD] Camera ISP service thread running.\r\n");
 
 	while (1) {
+		/* Only poll the ISP at 20 ms while the sensor streams; between
+		 * captures the VSYNC callback wakes us, so wait on the shared grid. */
+		const ULONG wait_ticks =
+				(camera_stream_started && camera_cmw_initialized) ?
+						CameraPlatform_MillisecondsToTicks(20U) :
+						AppLowPower_CoalescedTimeoutTicks(
+								APP_LOW_POWER_COALESCE_MS);
 		UINT semaphore_status = tx_semaphore_get(&camera_capture_isp_semaphore,
-				CameraPlatform_MillisecondsToTicks(20U));
+				wait_ticks);
 
 		if ((semaphore_status == TX_SUCCESS)
 				|| (camera_stream_started && camera_cmw_initialized)) {
 			if (!AppCameraCapture_RunImx335Background()) {
 				camera_capture_failed = true;
 				camera_capture_error_code = 0x49535052U; /* 'ISPR' */
-				(void) tx_semaphore_put(&camera_capture_done_semaphore);
+				AppThreadX_PostCaptureEvent(APP_CAPTURE_EVENT_ERROR,
+						camera_capture_error_code);
 			}
 		}
 	}
@@ -531,6 +865,7 @@ int CMW_CAMERA_PIPE_VsyncEventCallback(uint32_t pipe) {
 
 	(void) tx_semaphore_put(&camera_capture_isp_semaphore);
 	camera_capture_vsync_event_count++;
+	AppThreadX_PostCaptureEvent(APP_CAPTURE_EVENT_VSYNC, 0U);
 
 	/* No DebugConsole_Printf from ISR Ã¢â‚¬â€ mutex is illegal in interrupt context. */
 
@@ -548,15 +883,25 @@ int CMW_CAMERA_PIPE_FrameEventCallback(uint32_t pipe) {
 	DCMIPP_HandleTypeDef *capture_dcmipp =
 			CameraPlatform_GetCaptureDcmippHandle();
 
+#if CAMERA_CAPTURE_ENABLE_NN_PIPE
+	if (pipe == CAMERA_NN_PIPE) {
+		camera_nn_frame_event_count++;
+		camera_nn_frame_vsync_count = camera_capture_vsync_event_count;
+		(void) tx_event_flags_set(&camera_capture_events,
+				(ULONG) APP_CAPTURE_EVENTS_FLAG_NN_FRAME, TX_OR);
+		return CMW_ERROR_NONE;
+	}
+#endif
 	if (pipe != CAMERA_CAPTURE_PIPE) {
 		return CMW_ERROR_NONE;
 	}
 
 	camera_capture_frame_event_count++;
+	camera_capture_frame_vsync_count = camera_capture_vsync_event_count;
 
 	if (camera_capture_use_cmw_pipeline) {
 		counter_status = HAL_OK;
-		byte_count = CAMERA_CAPTURE_BUFFER_SIZE_BYTES;
+		byte_count = CameraPlatform_GetCaptureFrameBytes();
 	} else if ((capture_dcmipp != NULL) && (capture_dcmipp->Instance != NULL)) {
 		counter_status = HAL_DCMIPP_PIPE_GetDataCounter(capture_dcmipp,
 		CAMERA_CAPTURE_PIPE, &byte_count);
@@ -566,7 +911,7 @@ int CMW_CAMERA_PIPE_FrameEventCallback(uint32_t pipe) {
 	camera_capture_reported_byte_count = byte_count;
 
 	if ((counter_status != HAL_OK) || (byte_count == 0U)) {
-		byte_count = CAMERA_CAPTURE_BUFFER_SIZE_BYTES;
+		byte_count = CameraPlatform_GetCaptureFrameBytes();
 	} else if (!camera_capture_use_cmw_pipeline
 			&& (byte_count > CAMERA_CAPTURE_BUFFER_SIZE_BYTES)) {
 		DebugConsole_Printf(
@@ -582,9 +927,9 @@ int CMW_CAMERA_PIPE_FrameEventCallback(uint32_t pipe) {
 	camera_capture_frame_done = true;
 
 	/* No DebugConsole_Printf from ISR Ã¢â‚¬â€ tx_mutex_get is illegal in interrupt
-	 * context.  The main capture thread logs first8 after the semaphore fires. */
+	 * context.  The main capture thread logs first8 once READY is raised. */
 
-	(void) tx_semaphore_put(&camera_capture_done_semaphore);
+	AppThreadX_PostCaptureEvent(APP_CAPTURE_EVENT_FRAME, 0U);
 
 	return CMW_ERROR_NONE;
 }
@@ -597,6 +942,15 @@ void CMW_CAMERA_PIPE_ErrorCallback(uint32_t pipe) {
 	DCMIPP_HandleTypeDef *capture_dcmipp =
 			CameraPlatform_GetCaptureDcmippHandle();
 
+#if CAMERA_CAPTURE_ENABLE_NN_PIPE
+	/* A failed NN frame only costs the CPU preprocessing fallback. */
+	if (pipe == CAMERA_NN_PIPE) {
+		camera_nn_frame_failed = true;
+		(void) tx_event_flags_set(&camera_capture_events,
+				(ULONG) APP_CAPTURE_EVENTS_FLAG_NN_FRAME, TX_OR);
+		return;
+	}
+#endif
 	if (pipe != CAMERA_CAPTURE_PIPE) {
 		return;
 	}
@@ -604,7 +958,8 @@ void CMW_CAMERA_PIPE_ErrorCallback(uint32_t pipe) {
 	camera_capture_failed = true;
 	camera_capture_error_code = capture_dcmipp->ErrorCode;
 	camera_capture_snapshot_armed = false;
-	(void) tx_semaphore_put(&camera_capture_done_semaphore);
+	AppThreadX_PostCaptureEvent(APP_CAPTURE_EVENT_ERROR,
+			camera_capture_error_code);
 }
 
 /**
@@ -619,8 +974,9 @@ void HAL_DCMIPP_ErrorCallback(DCMIPP_HandleTypeDef *hdcmipp) {
 	camera_capture_failed = true;
 	camera_capture_error_code = hdcmipp->ErrorCode;
 	camera_capture_snapshot_armed = false;
-	/* Log from main thread after semaphore fires Ã¢â‚¬â€ no Printf from ISR. */
-	(void) tx_semaphore_put(&camera_capture_done_semaphore);
+	/* Log from main thread after FAILED is raised Ã¢â‚¬â€ no Printf from ISR. */
+	AppThreadX_PostCaptureEvent(APP_CAPTURE_EVENT_ERROR,
+			camera_capture_error_code);
 }
 
 /**
@@ -632,7 +988,8 @@ void HAL_DCMIPP_CSI_ClockChangerFifoFullEventCallback(
 	UNUSED(hdcmipp);
 	camera_capture_failed = true;
 	camera_capture_error_code = 0xCCF1F0U;
-	(void) tx_semaphore_put(&camera_capture_done_semaphore);
+	AppThreadX_PostCaptureEvent(APP_CAPTURE_EVENT_ERROR,
+			camera_capture_error_code);
 }
 
 /**
@@ -653,6 +1010,7 @@ void HAL_DCMIPP_CSI_StartOfFrameEventCallback(DCMIPP_HandleTypeDef *hdcmipp,
 	}
 
 	camera_capture_sof_seen = true;
+	AppThreadX_PostCaptureEvent(APP_CAPTURE_EVENT_SOF, 0U);
 }
 
 /**
@@ -673,9 +1031,11 @@ void HAL_DCMIPP_CSI_EndOfFrameEventCallback(DCMIPP_HandleTypeDef *hdcmipp,
 	}
 
 	camera_capture_eof_seen = true;
-	/* Ignore VC-level EOF as a wake source. In continuous sensor streaming it can
-	 * arrive for frames that are not the armed PIPE0 snapshot yet, which would
-	 * release the waiting thread with a zero byte count. */
+	/* VC-level EOF only timestamps the frame and never raises READY. In
+	 * continuous sensor streaming it can arrive for frames that are not the
+	 * armed PIPE0 snapshot yet, which would release the waiting thread with a
+	 * zero byte count. */
+	AppThreadX_PostCaptureEvent(APP_CAPTURE_EVENT_EOF, 0U);
 }
 
 /**
@@ -694,7 +1054,8 @@ void HAL_DCMIPP_CSI_LineErrorCallback(DCMIPP_HandleTypeDef *hdcmipp,
 	if ((camera_capture_line_error_count >= 8U) && !camera_capture_sof_seen) {
 		camera_capture_failed = true;
 		camera_capture_error_code = 0x1E000000U | DataLane;
-		(void) tx_semaphore_put(&camera_capture_done_semaphore);
+		AppThreadX_PostCaptureEvent(APP_CAPTURE_EVENT_ERROR,
+				camera_capture_error_code);
 	}
 }
 
@@ -0,0 +1,152 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_xspi2_residency.c
+ * @brief   Verify-once residency table for the model stages on xSPI2.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#include "app_xspi2_residency.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/** @brief Index of the entry for a stage, or entry_count when absent. */
+static uint32_t AppXspi2Residency_Find(
+		const AppXspi2Residency_Table_t *table_ptr, const void *stage_key) {
+	uint32_t index = 0U;
+
+	while ((index < table_ptr->entry_count)
+			&& (table_ptr->entries[index].stage_key != stage_key)) {
+		index++;
+	}
+	return index;
+}
+
+/** @brief Let a zero-initialized table work without an explicit init. */
+static void AppXspi2Residency_EnsureGeneration(
+		AppXspi2Residency_Table_t *table_ptr) {
+	if (table_ptr->generation == 0U) {
+		table_ptr->generation = 1U;
+	}
+}
+
+void AppXspi2Residency_Init(AppXspi2Residency_Table_t *table_ptr) {
+	if (table_ptr == NULL) {
+		return;
+	}
+	(void) memset(table_ptr, 0, sizeof(*table_ptr));
+	table_ptr->generation = 1U;
+}
+
+AppXspi2Residency_Action_t AppXspi2Residency_Plan(
+		AppXspi2Residency_Table_t *table_ptr, const void *stage_key,
+		uint32_t chip_offset, bool mapped) {
+	AppXspi2Residency_Entry_t *entry_ptr = NULL;
+	uint32_t index = 0U;
+
+	if ((table_ptr == NULL) || (stage_key == NULL)) {
+		return APP_XSPI2_RESIDENCY_VERIFY;
+	}
+	AppXspi2Residency_EnsureGeneration(table_ptr);
+
+	index = AppXspi2Residency_Find(table_ptr, stage_key);
+	if (index == table_ptr->entry_count) {
+		if (table_ptr->entry_count >= APP_XSPI2_RESIDENCY_MAX_STAGES) {
+			return APP_XSPI2_RESIDENCY_VERIFY;
+		}
+		entry_ptr = &table_ptr->entries[table_ptr->entry_count++];
+		entry_ptr->stage_key = stage_key;
+		entry_ptr->chip_offset = chip_offset;
+		entry_ptr->verified_generation = 0U;
+		return APP_XSPI2_RESIDENCY_VERIFY;
+	}
+
+	entry_ptr = &table_ptr->entries[index];
+	/* A stage spec that moved to another region is a different image. */
+	if (entry_ptr->chip_offset != chip_offset) {
+		entry_ptr->chip_offset = chip_offset;
+		entry_ptr->verified_generation = 0U;
+	}
+	if (entry_ptr->verified_generation != table_ptr->generation) {
+		return APP_XSPI2_RESIDENCY_VERIFY;
+	}
+	return mapped ? APP_XSPI2_RESIDENCY_MAPPED : APP_XSPI2_RESIDENCY_ENABLE_MM;
+}
+
+bool AppXspi2Residency_MarkResident(AppXspi2Residency_Table_t *table_ptr,
+		const void *stage_key) {
+	uint32_t index = 0U;
+
+	if ((table_ptr == NULL) || (stage_key == NULL)) {
+		return false;
+	}
+	AppXspi2Residency_EnsureGeneration(table_ptr);
+	index = AppXspi2Residency_Find(table_ptr, stage_key);
+	if (index == table_ptr->entry_count) {
+		return false;
+	}
+	table_ptr->entries[index].verified_generation = table_ptr->generation;
+	return true;
+}
+
+bool AppXspi2Residency_IsResident(const AppXspi2Residency_Table_t *table_ptr,
+		const void *stage_key) {
+	uint32_t index = 0U;
+
+	if ((table_ptr == NULL) || (stage_key == NULL)) {
+		return false;
+	}
+	index = AppXspi2Residency_Find(table_ptr, stage_key);
+	return (index < table_ptr->entry_count)
+			&& (table_ptr->entries[index].verified_generation != 0U)
+			&& (table_ptr->entries[index].verified_generation
+					== table_ptr->generation);
+}
+
+void AppXspi2Residency_InvalidateAll(AppXspi2Residency_Table_t *table_ptr) {
+	if (table_ptr == NULL) {
+		return;
+	}
+	AppXspi2Residency_EnsureGeneration(table_ptr);
+	table_ptr->generation++;
+	/* Generation 0 means "never verified"; on wrap, forget explicitly so no
+	 * entry from 2^32 provisionings ago can match again. */
+	if (table_ptr->generation == 0U) {
+		for (uint32_t index = 0U; index < table_ptr->entry_count; index++) {
+			table_ptr->entries[index].verified_generation = 0U;
+		}
+		table_ptr->generation = 1U;
+	}
+}
+
+uint32_t AppXspi2Residency_ResidentCount(
+		const AppXspi2Residency_Table_t *table_ptr) {
+	uint32_t resident = 0U;
+
+	if (table_ptr == NULL) {
+		return 0U;
+	}
+	for (uint32_t index = 0U; index < table_ptr->entry_count; index++) {
+		if ((table_ptr->entries[index].verified_generation != 0U)
+				&& (table_ptr->entries[index].verified_generation
+						== table_ptr->generation)) {
+			resident++;
+		}
+	}
+	return resident;
+}
+
+const char *AppXspi2Residency_ActionName(AppXspi2Residency_Action_t action) {
+	switch (action) {
+	case APP_XSPI2_RESIDENCY_MAPPED:
+		return "mapped";
+	case APP_XSPI2_RESIDENCY_ENABLE_MM:
+		return "enable-mm";
+	case APP_XSPI2_RESIDENCY_VERIFY:
+		return "verify";
+	default:
+		return "unknown";
+	}
+}
@@ -0,0 +1,235 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file    app_xspi_dtr.c
+ * @brief   Octal DTR bring-up, DQS delay calibration and STR fallback for
+ *          the xSPI2 NOR.
+ *
+ * STR reads are the reference: the flash is known to read correctly there,
+ * so whatever it returns for a region is what DTR must return too. A DQS
+ * delay tap passes when every pattern read matches. The centre of the widest
+ * passing run is the tap with the most margin on either side for
+ * temperature and voltage drift.
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+
+#include "app_xspi_dtr.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/* STR reads of every region plus the sweep results. Static to keep ~600 B
+ * off the AI thread stack; bring-up runs once per reconfigure. */
+static struct {
+	uint8_t reference[APP_XSPI_DTR_MAX_REGIONS][APP_XSPI_DTR_MAX_REGION_BYTES];
+	bool usable[APP_XSPI_DTR_MAX_REGIONS];
+	bool passes[APP_XSPI_DTR_MAX_TAPS];
+	uint8_t scratch[APP_XSPI_DTR_MAX_REGION_BYTES];
+} app_xspi_dtr_work;
+
+bool AppXspiDtr_FindWidestWindow(const bool *passes, uint32_t tap_count,
+		uint32_t *start_out, uint32_t *width_out) {
+	uint32_t best_start = 0U;
+	uint32_t best_width = 0U;
+	uint32_t run_start = 0U;
+	uint32_t run_width = 0U;
+
+	if ((passes == NULL) || (start_out == NULL) || (width_out == NULL)) {
+		return false;
+	}
+
+	for (uint32_t tap = 0U; tap < tap_count; tap++) {
+		if (!passes[tap]) {
+			run_width = 0U;
+			continue;
+		}
+		if (run_width == 0U) {
+			run_start = tap;
+		}
+		run_width++;
+		if (run_width > best_width) {
+			best_start = run_start;
+			best_width = run_width;
+		}
+	}
+
+	*start_out = best_start;
+	*width_out = best_width;
+	return best_width > 0U;
+}
+
+/**
+ * @brief A usable pattern needs bit transitions; an erased or blank region
+ *        reads the same at every tap and would calibrate nothing.
+ */
+static bool AppXspiDtr_HasTransitions(const uint8_t *bytes, uint32_t length) {
+	for (uint32_t i = 1U; i < length; i++) {
+		if (bytes[i] != bytes[0]) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool AppXspiDtr_ConfigValid(const AppXspiDtr_Config_t *config_ptr,
+		const AppXspiDtr_Ops_t *ops_ptr) {
+	if ((config_ptr == NULL) || (ops_ptr == NULL)
+			|| (config_ptr->regions == NULL)
+			|| (config_ptr->region_count == 0U)
+			|| (config_ptr->region_count > APP_XSPI_DTR_MAX_REGIONS)
+			|| (config_ptr->tap_count == 0U)
+			|| (config_ptr->tap_count > APP_XSPI_DTR_MAX_TAPS)
+			|| (config_ptr->min_window_taps == 0U)
+			|| (config_ptr->reads_per_tap == 0U)
+			|| (ops_ptr->enter_str == NULL) || (ops_ptr->enter_dtr == NULL)
+			|| (ops_ptr->set_delay_tap == NULL) || (ops_ptr->read == NULL)
+			|| (ops_ptr->read_mapped == NULL)) {
+		return false;
+	}
+
+	for (uint32_t i = 0U; i < config_ptr->region_count; i++) {
+		if ((config_ptr->regions[i].length == 0U)
+				|| (config_ptr->regions[i].length
+						> APP_XSPI_DTR_MAX_REGION_BYTES)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Record the failure and put the flash back in STR.
+ */
+static AppXspiDtr_State_t AppXspiDtr_FallBack(const AppXspiDtr_Ops_t *ops_ptr,
+		AppXspiDtr_Failure_t failure, AppXspiDtr_Result_t *result_ptr) {
+	result_ptr->failure = failure;
+	result_ptr->state = ops_ptr->enter_str(ops_ptr->ctx) ?
+			APP_XSPI_DTR_STATE_STR_FALLBACK : APP_XSPI_DTR_STATE_FAILED;
+	return result_ptr->state;
+}
+
+static bool AppXspiDtr_TapPasses(const AppXspiDtr_Config_t *config_ptr,
+		const AppXspiDtr_Ops_t *ops_ptr) {
+	const AppXspiDtr_Region_t *pattern = &config_ptr->regions[0];
+
+	for (uint32_t i = 0U; i < config_ptr->reads_per_tap; i++) {
+		if (!ops_ptr->read(ops_ptr->ctx, pattern->offset,
+				app_xspi_dtr_work.scratch, pattern->length)
+				|| (memcmp(app_xspi_dtr_work.scratch,
+						app_xspi_dtr_work.reference[0], pattern->length) != 0)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+AppXspiDtr_State_t AppXspiDtr_BringUp(const AppXspiDtr_Config_t *config_ptr,
+		const AppXspiDtr_Ops_t *ops_ptr, AppXspiDtr_Result_t *result_ptr) {
+	if (result_ptr == NULL) {
+		return APP_XSPI_DTR_STATE_FAILED;
+	}
+	(void) memset(result_ptr, 0, sizeof(*result_ptr));
+	result_ptr->state = APP_XSPI_DTR_STATE_STR_REFERENCE;
+
+	if (!AppXspiDtr_ConfigValid(config_ptr, ops_ptr)) {
+		result_ptr->failure = APP_XSPI_DTR_FAILURE_CONFIG;
+		result_ptr->state = APP_XSPI_DTR_STATE_STR_FALLBACK;
+		return result_ptr->state;
+	}
+
+	/* 1. Reference reads in STR. Nothing has changed yet, so a failure here
+	 *    leaves the flash as it was. */
+	for (uint32_t i = 0U; i < config_ptr->region_count; i++) {
+		const AppXspiDtr_Region_t *region = &config_ptr->regions[i];
+
+		if (!ops_ptr->read(ops_ptr->ctx, region->offset,
+				app_xspi_dtr_work.reference[i], region->length)) {
+			result_ptr->failure = APP_XSPI_DTR_FAILURE_STR_READ;
+			result_ptr->state = APP_XSPI_DTR_STATE_STR_FALLBACK;
+			return result_ptr->state;
+		}
+		app_xspi_dtr_work.usable[i] = (region->expected == NULL)
+				|| (memcmp(app_xspi_dtr_work.reference[i], region->expected,
+						region->length) == 0);
+	}
+	if (!app_xspi_dtr_work.usable[0]
+			|| !AppXspiDtr_HasTransitions(app_xspi_dtr_work.reference[0],
+					config_ptr->regions[0].length)) {
+		result_ptr->failure = APP_XSPI_DTR_FAILURE_NO_PATTERN;
+		result_ptr->state = APP_XSPI_DTR_STATE_STR_FALLBACK;
+		return result_ptr->state;
+	}
+
+	/* 2. Mode switch. */
+	result_ptr->state = APP_XSPI_DTR_STATE_SWITCHING;
+	if (!ops_ptr->enter_dtr(ops_ptr->ctx, config_ptr->dtr_dummy_cycles)) {
+		return AppXspiDtr_FallBack(ops_ptr, APP_XSPI_DTR_FAILURE_MODE_SWITCH,
+				result_ptr);
+	}
+
+	/* 3. DQS delay sweep over the pattern. */
+	result_ptr->state = APP_XSPI_DTR_STATE_CALIBRATING;
+	for (uint32_t tap = 0U; tap < config_ptr->tap_count; tap++) {
+		app_xspi_dtr_work.passes[tap] = ops_ptr->set_delay_tap(ops_ptr->ctx,
+				tap) && AppXspiDtr_TapPasses(config_ptr, ops_ptr);
+		if (app_xspi_dtr_work.passes[tap]) {
+			result_ptr->passing_taps++;
+		}
+	}
+	(void) AppXspiDtr_FindWidestWindow(app_xspi_dtr_work.passes,
+			config_ptr->tap_count, &result_ptr->window_start,
+			&result_ptr->window_taps);
+	if (result_ptr->window_taps < config_ptr->min_window_taps) {
+		return AppXspiDtr_FallBack(ops_ptr,
+				APP_XSPI_DTR_FAILURE_NARROW_WINDOW, result_ptr);
+	}
+	result_ptr->selected_tap = result_ptr->window_start
+			+ (result_ptr->window_taps / 2U);
+	if (!ops_ptr->set_delay_tap(ops_ptr->ctx, result_ptr->selected_tap)) {
+		return AppXspiDtr_FallBack(ops_ptr, APP_XSPI_DTR_FAILURE_MODE_SWITCH,
+				result_ptr);
+	}
+
+	/* 4. Every usable region, pattern included, through the mapped window. */
+	result_ptr->state = APP_XSPI_DTR_STATE_VALIDATING;
+	for (uint32_t i = 0U; i < config_ptr->region_count; i++) {
+		const AppXspiDtr_Region_t *region = &config_ptr->regions[i];
+
+		if (!app_xspi_dtr_work.usable[i]) {
+			continue;
+		}
+		if (!ops_ptr->read_mapped(ops_ptr->ctx, region->offset,
+				app_xspi_dtr_work.scratch, region->length)
+				|| (memcmp(app_xspi_dtr_work.scratch,
+						app_xspi_dtr_work.reference[i], region->length) != 0)) {
+			return AppXspiDtr_FallBack(ops_ptr,
+					APP_XSPI_DTR_FAILURE_VALIDATION, result_ptr);
+		}
+		result_ptr->validated_regions++;
+	}
+
+	result_ptr->state = APP_XSPI_DTR_STATE_DTR_ACTIVE;
+	return result_ptr->state;
+}
+
+const char *AppXspiDtr_FailureName(AppXspiDtr_Failure_t failure) {
+	switch (failure) {
+	case APP_XSPI_DTR_FAILURE_NONE:
+		return "none";
+	case APP_XSPI_DTR_FAILURE_CONFIG:
+		return "config";
+	case APP_XSPI_DTR_FAILURE_STR_READ:
+		return "str-read";
+	case APP_XSPI_DTR_FAILURE_NO_PATTERN:
+		return "no-pattern";
+	case APP_XSPI_DTR_FAILURE_MODE_SWITCH:
+		return "mode-switch";
+	case APP_XSPI_DTR_FAILURE_NARROW_WINDOW:
+		return "narrow-window";
+	case APP_XSPI_DTR_FAILURE_VALIDATION:
+		return "validation";
+	default:
+		return "unknown";
+	}
+}
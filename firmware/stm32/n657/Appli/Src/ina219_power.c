@@ -14,6 +14,7 @@
 #include <string.h>
 #include <math.h>
 #include <stdlib.h>
+#include "app_low_power.h"
 #include "debug_console.h"
 #include "inference_metrics.h"
 #include "main.h"
@@ -31,7 +32,7 @@
 /* Thread configuration */
 #define INA219_THREAD_STACK_SIZE    1024U
 #define INA219_THREAD_PRIORITY      10U      /* Must outrank the pipeline workers */
-#define INA219_SAMPLE_PERIOD_MS     250U     /* Sample every 250 ms for power stats */
+#define INA219_SAMPLE_PERIOD_MS     1000U    /* Sample once per shared idle wake-up */
 
 /* Private variables ---------------------------------------------------------*/
 static I2C_HandleTypeDef *g_hi2c = NULL;
@@ -239,8 +240,10 @@ static void INA219_ThreadEntry(ULONG thread_input)
     DebugConsole_Printf("[INA219] Monitoring thread started\r\n");
     
     while (g_thread_running) {
-        /* Wait for semaphore or timeout (1 second) */
-        (void) tx_semaphore_get(&g_ina219_semaphore, INA219_SAMPLE_PERIOD_MS);
+        /* Wait for semaphore or the next shared wake-up, so idle sampling
+         * rides along with the other periodic services. */
+        (void) tx_semaphore_get(&g_ina219_semaphore,
+                AppLowPower_CoalescedTimeoutTicks(INA219_SAMPLE_PERIOD_MS));
 
         /* Read sensor and feed power (mW) to the metrics subsystem so
          * min/avg/max can be reported per-pipeline after latency ends. */
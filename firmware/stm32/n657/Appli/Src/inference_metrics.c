@@ -47,12 +47,29 @@ static struct
 	float power_sum_mw;
 } s_active_slots[METRICS_ACTIVE_SLOTS] = {0};
 
-/* 64-bit DWT cycle-counter extension to avoid wrap every 5.4 s. */
+/* 64-bit DWT cycle-counter extension to avoid wrap every 7 s. Time is
+ * measured from the last CPU clock change so a profile switch does not
+ * rescale what was already counted. */
 static struct
 {
 	uint64_t high_cycles;
 	uint32_t prev_cycles;
-} s_dwt_state = {0, 0};
+	uint64_t base_cycles;
+	uint64_t base_us;
+	uint32_t cycles_per_us;
+} s_dwt_state = {0, 0, 0, 0, 0};
+
+/* xSPI2 model stage switches: count and latency, split by whether the
+ * switch stayed in memory-mapped mode. */
+static struct
+{
+	uint32_t mapped_count;
+	uint64_t mapped_total_us;
+	uint32_t mapped_max_us;
+	uint32_t peripheral_count;
+	uint64_t peripheral_total_us;
+	uint32_t peripheral_max_us;
+} s_xspi2_switches = {0};
 
 /* Private function prototypes -----------------------------------------------*/
 static float Metrics_ReadPower(void);
@@ -95,12 +112,9 @@ void Metrics_Init(void)
 }
 
 /**
- * @brief Get current timestamp in microseconds using DWT cycle counter.
- *
- * The DWT counter wraps every ~5.4 s at 800 MHz, so we extend it to 64
- * bits by tracking the high word across wraps.
+ * @brief Extend the DWT cycle counter to 64 bits, starting it on first use.
  */
-uint64_t Metrics_GetMicros(void)
+static uint64_t Metrics_ReadCycles(void)
 {
 	static bool dwt_initialized = false;
 	if (!dwt_initialized)
@@ -119,8 +133,55 @@ uint64_t Metrics_GetMicros(void)
 		s_dwt_state.high_cycles += (1ULL << 32);
 	}
 	s_dwt_state.prev_cycles = cycles;
-	uint64_t total = s_dwt_state.high_cycles + (uint64_t)cycles;
-	return total / 800ULL;
+	return s_dwt_state.high_cycles + (uint64_t)cycles;
+}
+
+/**
+ * @brief Get current timestamp in microseconds using DWT cycle counter.
+ *
+ * The counter runs at the CPU clock, so the divisor follows
+ * Metrics_SetCpuClockHz() and defaults to SystemCoreClock. Safe to call
+ * from interrupt context.
+ */
+uint64_t Metrics_GetMicros(void)
+{
+	/* The capture interrupt callbacks timestamp events too, so the 64-bit
+	 * extension must not be torn by a nested call. */
+	const uint32_t primask = __get_PRIMASK();
+	uint64_t total = 0U;
+	uint64_t now_us = 0U;
+
+	__disable_irq();
+	total = Metrics_ReadCycles();
+	if (s_dwt_state.cycles_per_us == 0U)
+	{
+		s_dwt_state.cycles_per_us = SystemCoreClock / 1000000U;
+		if (s_dwt_state.cycles_per_us == 0U)
+		{
+			s_dwt_state.cycles_per_us = 1U;
+		}
+	}
+	now_us = s_dwt_state.base_us
+			+ ((total - s_dwt_state.base_cycles) / s_dwt_state.cycles_per_us);
+	__set_PRIMASK(primask);
+	return now_us;
+}
+
+/**
+ * @brief Rebase the microsecond clock on a CPU clock change.
+ */
+void Metrics_SetCpuClockHz(uint32_t cpu_hz)
+{
+	const uint64_t now_us = Metrics_GetMicros();
+
+	if (cpu_hz < 1000000U)
+	{
+		return;
+	}
+	s_dwt_state.base_us = now_us;
+	s_dwt_state.base_cycles = s_dwt_state.high_cycles
+			+ (uint64_t)s_dwt_state.prev_cycles;
+	s_dwt_state.cycles_per_us = cpu_hz / 1000000U;
 }
 
 /**
@@ -692,15 +753,52 @@ void Metrics_LogAll(void)
                             energy_avg_tenth / 10L, labs(energy_avg_tenth % 10L));
     }
 
+    if ((s_xspi2_switches.mapped_count + s_xspi2_switches.peripheral_count) > 0U)
+    {
+        DebugConsole_Printf("  xSPI2 stage switches: mapped n=%lu avg=%lu us max=%lu us, peripheral n=%lu avg=%lu us max=%lu us\r\n",
+                            (unsigned long)s_xspi2_switches.mapped_count,
+                            (unsigned long)((s_xspi2_switches.mapped_count > 0U)
+                                ? (s_xspi2_switches.mapped_total_us / s_xspi2_switches.mapped_count) : 0U),
+                            (unsigned long)s_xspi2_switches.mapped_max_us,
+                            (unsigned long)s_xspi2_switches.peripheral_count,
+                            (unsigned long)((s_xspi2_switches.peripheral_count > 0U)
+                                ? (s_xspi2_switches.peripheral_total_us / s_xspi2_switches.peripheral_count) : 0U),
+                            (unsigned long)s_xspi2_switches.peripheral_max_us);
+    }
+
     DebugConsole_Printf("\r\n");
 }
 
+/**
+ * @brief Count one xSPI2 model stage switch and its latency.
+ */
+void Metrics_RecordXspi2StageSwitch(uint32_t elapsed_us, bool touched_peripheral)
+{
+    if (touched_peripheral)
+    {
+        s_xspi2_switches.peripheral_count++;
+        s_xspi2_switches.peripheral_total_us += elapsed_us;
+        if (elapsed_us > s_xspi2_switches.peripheral_max_us)
+        {
+            s_xspi2_switches.peripheral_max_us = elapsed_us;
+        }
+        return;
+    }
+    s_xspi2_switches.mapped_count++;
+    s_xspi2_switches.mapped_total_us += elapsed_us;
+    if (elapsed_us > s_xspi2_switches.mapped_max_us)
+    {
+        s_xspi2_switches.mapped_max_us = elapsed_us;
+    }
+}
+
 /**
  * @brief Clear all recorded metrics.
  */
 void Metrics_Clear(void)
 {
     memset(s_metrics_buffer, 0, sizeof(s_metrics_buffer));
+    memset(&s_xspi2_switches, 0, sizeof(s_xspi2_switches));
     s_metrics_count = 0;
     s_metrics_index = 0;
     DebugConsole_Printf("[METRICS] Cleared all samples\r\n");
@@ -0,0 +1,240 @@
+#include "sd_card_profile.h"
+
+#include <string.h>
+
+/* AU_SIZE code -> AU size in KiB (SD Physical Layer spec, SD status). */
+static const uint32_t g_sd_card_profile_au_kib[16] = { 0U, 16U, 32U, 64U,
+		128U, 256U, 512U, 1024U, 2048U, 4096U, 8192U, 12288U, 16384U, 24576U,
+		32768U, 65536U };
+
+/*==============================================================================
+ * Function: SdCardProfile_IsPowerOfTwo
+ *
+ * Purpose:
+ *   True for 1, 2, 4 ...; false for 0.
+ *==============================================================================*/
+static uint8_t SdCardProfile_IsPowerOfTwo(uint32_t value) {
+	return ((value != 0U) && ((value & (value - 1U)) == 0U)) ? 1U : 0U;
+}
+
+/*==============================================================================
+ * Function: SdCardProfile_FastestWrite
+ *
+ * Purpose:
+ *   Repeat one write and keep the fastest time. Bus and scheduler noise only
+ *   ever add latency, while an erase stall repeats every time.
+ *
+ * Returns:
+ *   0 on success, nonzero if any write failed.
+ *==============================================================================*/
+static int32_t SdCardProfile_FastestWrite(
+		SdCardProfile_WriteSectorsFunction write_function,
+		void *write_context, uint32_t lba, uint32_t sector_count,
+		uint32_t repeats, uint32_t *fastest_us_out) {
+	uint32_t fastest_us = UINT32_MAX;
+
+	for (uint32_t attempt = 0U; attempt < repeats; attempt++) {
+		uint32_t elapsed_us = 0U;
+
+		if (write_function(write_context, lba, sector_count, &elapsed_us)
+				!= 0) {
+			return -1;
+		}
+		if (elapsed_us < fastest_us) {
+			fastest_us = elapsed_us;
+		}
+	}
+
+	*fastest_us_out = fastest_us;
+	return 0;
+}
+
+/*==============================================================================
+ * Function: SdCardProfile_ParseSdStatus
+ *==============================================================================*/
+uint8_t SdCardProfile_ParseSdStatus(
+		const uint8_t sd_status[SD_CARD_PROFILE_SD_STATUS_BYTES],
+		SdCardProfile_SdStatus *status_out) {
+	if ((sd_status == NULL) || (status_out == NULL)) {
+		return 0U;
+	}
+
+	/* Bit b of the 512-bit register lives in byte (511 - b) / 8. */
+	status_out->au_size_code = (uint8_t) (sd_status[10] >> 4U);
+	status_out->au_sectors =
+			g_sd_card_profile_au_kib[status_out->au_size_code] * 2U;
+	status_out->erase_size_au = (uint16_t) (((uint16_t) sd_status[11] << 8U)
+			| sd_status[12]);
+	status_out->erase_timeout_s = (uint8_t) (sd_status[13] >> 2U);
+	status_out->erase_offset_s = (uint8_t) (sd_status[13] & 0x03U);
+
+	return (status_out->au_sectors != 0U) ? 1U : 0U;
+}
+
+/*==============================================================================
+ * Function: SdCardProfile_Probe
+ *==============================================================================*/
+int32_t SdCardProfile_Probe(SdCardProfile_WriteSectorsFunction write_function,
+		void *write_context, const SdCardProfile_ProbeConfig *config_ptr,
+		SdCardProfile_Profile *profile_out) {
+	uint32_t size_steps = 0U;
+	uint32_t candidates = 0U;
+
+	if ((write_function == NULL) || (config_ptr == NULL)
+			|| (profile_out == NULL) || (config_ptr->repeats == 0U)
+			|| (config_ptr->probe_sectors < 2U)
+			|| (SdCardProfile_IsPowerOfTwo(config_ptr->probe_sectors) == 0U)
+			|| (SdCardProfile_IsPowerOfTwo(config_ptr->min_boundary_sectors)
+					== 0U)
+			|| (SdCardProfile_IsPowerOfTwo(config_ptr->max_boundary_sectors)
+					== 0U)
+			|| (config_ptr->min_boundary_sectors < config_ptr->probe_sectors)
+			|| (config_ptr->max_boundary_sectors
+					< config_ptr->min_boundary_sectors)
+			|| ((config_ptr->window_start_lba
+					% config_ptr->max_boundary_sectors) != 0U)
+			|| (config_ptr->window_sectors
+					< (config_ptr->max_boundary_sectors
+							+ config_ptr->probe_sectors))) {
+		return -1;
+	}
+
+	for (uint32_t sectors = 1U; sectors <= config_ptr->probe_sectors;
+			sectors <<= 1U) {
+		size_steps++;
+	}
+	for (uint32_t boundary = config_ptr->min_boundary_sectors;
+			boundary <= config_ptr->max_boundary_sectors; boundary <<= 1U) {
+		candidates++;
+	}
+	if ((size_steps > SD_CARD_PROFILE_MAX_SIZE_STEPS)
+			|| (candidates > SD_CARD_PROFILE_MAX_CANDIDATES)) {
+		return -1;
+	}
+
+	(void) memset(profile_out->size_us, 0, sizeof(profile_out->size_us));
+	(void) memset(profile_out->straddle_us, 0,
+			sizeof(profile_out->straddle_us));
+	profile_out->probe_sectors = config_ptr->probe_sectors;
+	profile_out->size_step_count = size_steps;
+	profile_out->min_boundary_sectors = config_ptr->min_boundary_sectors;
+	profile_out->candidate_count = candidates;
+	profile_out->boundary_sectors = 0U;
+
+	/* Latency against size, every write starting on the window boundary.
+	 * The last step is the aligned reference for the straddle tests. */
+	for (uint32_t step = 0U; step < size_steps; step++) {
+		if (SdCardProfile_FastestWrite(write_function, write_context,
+				config_ptr->window_start_lba, 1UL << step,
+				config_ptr->repeats, &profile_out->size_us[step]) != 0) {
+			return -2;
+		}
+	}
+	profile_out->baseline_us = profile_out->size_us[size_steps - 1U];
+
+	/* Latency against alignment. */
+	for (uint32_t index = 0U; index < candidates; index++) {
+		const uint32_t boundary = config_ptr->min_boundary_sectors << index;
+		const uint32_t lba = config_ptr->window_start_lba + boundary
+				- (config_ptr->probe_sectors / 2U);
+
+		if (SdCardProfile_FastestWrite(write_function, write_context, lba,
+				config_ptr->probe_sectors, config_ptr->repeats,
+				&profile_out->straddle_us[index]) != 0) {
+			return -2;
+		}
+
+		if ((profile_out->boundary_sectors == 0U)
+				&& (((uint64_t) profile_out->straddle_us[index] * 100U)
+						> ((uint64_t) profile_out->baseline_us
+								* (100U + config_ptr->penalty_percent)))) {
+			profile_out->boundary_sectors = boundary;
+		}
+	}
+
+	return 0;
+}
+
+/*==============================================================================
+ * Function: SdCardProfile_ChooseAlignSectors
+ *==============================================================================*/
+uint32_t SdCardProfile_ChooseAlignSectors(uint32_t boundary_sectors,
+		uint32_t au_sectors, uint32_t max_align_sectors) {
+	uint32_t align_sectors = 0U;
+
+	if (SdCardProfile_IsPowerOfTwo(boundary_sectors) != 0U) {
+		align_sectors = boundary_sectors;
+	} else if (SdCardProfile_IsPowerOfTwo(au_sectors) != 0U) {
+		/* 12 MiB and 24 MiB AUs are not powers of two; they are also far
+		 * past any useful per-file alignment, so only the cap applies. */
+		align_sectors = au_sectors;
+	} else if (au_sectors != 0U) {
+		align_sectors = max_align_sectors;
+	}
+
+	if ((max_align_sectors != 0U) && (align_sectors > max_align_sectors)) {
+		align_sectors = max_align_sectors;
+	}
+	return (SdCardProfile_IsPowerOfTwo(align_sectors) != 0U) ?
+			align_sectors : 0U;
+}
+
+/*==============================================================================
+ * Function: SdCardProfile_IsValid
+ *==============================================================================*/
+uint8_t SdCardProfile_IsValid(const SdCardProfile_Profile *profile_ptr,
+		uint32_t partition_start_lba, uint32_t partition_sector_count) {
+	if ((profile_ptr == NULL) || (profile_ptr->magic != SD_CARD_PROFILE_MAGIC)
+			|| (profile_ptr->version != SD_CARD_PROFILE_VERSION)
+			|| (profile_ptr->partition_start_lba != partition_start_lba)
+			|| (profile_ptr->partition_sector_count != partition_sector_count)
+			|| (profile_ptr->size_step_count > SD_CARD_PROFILE_MAX_SIZE_STEPS)
+			|| (profile_ptr->candidate_count > SD_CARD_PROFILE_MAX_CANDIDATES)) {
+		return 0U;
+	}
+
+	return ((profile_ptr->align_sectors == 0U)
+			|| (SdCardProfile_IsPowerOfTwo(profile_ptr->align_sectors) != 0U)) ?
+			1U : 0U;
+}
+
+/*==============================================================================
+ * Function: SdCardProfile_NextAlignedCluster
+ *==============================================================================*/
+uint32_t SdCardProfile_NextAlignedCluster(uint32_t first_data_lba,
+		uint32_t sectors_per_cluster, uint32_t total_clusters,
+		uint32_t search_cluster, uint32_t align_sectors) {
+	const uint32_t first_cluster = 2U; /* FAT data clusters start at 2. */
+	uint32_t clusters_per_unit = 0U;
+	uint32_t phase = 0U;
+	uint32_t cluster = 0U;
+
+	if ((sectors_per_cluster == 0U) || (total_clusters == 0U)
+			|| (SdCardProfile_IsPowerOfTwo(align_sectors) == 0U)
+			|| ((align_sectors % sectors_per_cluster) != 0U)
+			|| ((first_data_lba % sectors_per_cluster) != 0U)
+			|| (search_cluster < first_cluster)
+			|| (search_cluster >= (first_cluster + total_clusters))) {
+		return search_cluster;
+	}
+
+	/* Clusters whose first LBA is a multiple of the unit repeat every
+	 * clusters_per_unit clusters, offset by phase from cluster 2. */
+	clusters_per_unit = align_sectors / sectors_per_cluster;
+	phase = ((align_sectors - (first_data_lba % align_sectors)) % align_sectors)
+			/ sectors_per_cluster;
+
+	cluster = search_cluster - first_cluster;
+	if ((cluster % clusters_per_unit) != phase) {
+		cluster += (phase + clusters_per_unit - (cluster % clusters_per_unit))
+				% clusters_per_unit;
+	}
+	if (cluster >= total_clusters) {
+		cluster = phase;
+		if (cluster >= total_clusters) {
+			return search_cluster;
+		}
+	}
+
+	return cluster + first_cluster;
+}
@@ -46,6 +46,9 @@ typedef struct {
  *==============================================================================*/
 static TX_QUEUE g_sd_debug_log_queue;
 static ULONG *g_sd_debug_log_queue_storage_ptr = NULL;
+/* Signalled on every enqueue so the drain side can block instead of polling. */
+static TX_SEMAPHORE g_sd_debug_log_pending_semaphore;
+static uint8_t g_sd_debug_log_pending_semaphore_created = 0U;
 
 static TX_BLOCK_POOL g_sd_debug_log_block_pool;
 static UCHAR *g_sd_debug_log_block_pool_storage_ptr = NULL;
@@ -168,6 +171,11 @@ static int32_t SdDebugLogService_FileX_OpenAppend(void *user_context_ptr,
 		return -3;
 	}
 
+	/* A fresh log file takes its first cluster on an allocation unit. */
+	if (g_sd_debug_log_fx_file.fx_file_current_file_size == 0U) {
+		AppFileX_AlignNextAllocationLocked();
+	}
+
 	/* Mark file handle open. */
 	g_sd_debug_log_file_is_open = 1U;
 	SdDebugLogService_UnlockMedia();
@@ -543,6 +551,15 @@ UINT SdDebugLogService_Initialize(TX_BYTE_POOL *byte_pool_ptr,
 		return status;
 	}
 
+	if (g_sd_debug_log_pending_semaphore_created == 0U) {
+		status = tx_semaphore_create(&g_sd_debug_log_pending_semaphore,
+				(CHAR*) "sd_debug_log_pending", 0U);
+		if (status != TX_SUCCESS) {
+			return status;
+		}
+		g_sd_debug_log_pending_semaphore_created = 1U;
+	}
+
 	return TX_SUCCESS;
 }
 
@@ -597,6 +614,11 @@ UINT SdDebugLogService_EnqueueLine(const CHAR *line_ptr) {
 		return status;
 	}
 
+	/* A ceiling of one is enough: the drain side re-checks the queue depth. */
+	if (g_sd_debug_log_pending_semaphore_created != 0U) {
+		(void) tx_semaphore_ceiling_put(&g_sd_debug_log_pending_semaphore, 1U);
+	}
+
 	return TX_SUCCESS;
 }
 
@@ -633,6 +655,24 @@ void SdDebugLogService_ServiceQueue(ULONG max_messages_to_process) {
 	}
 }
 
+UINT SdDebugLogService_WaitForPending(ULONG wait_ticks) {
+	ULONG enqueued_count = 0U;
+
+	if (g_sd_debug_log_pending_semaphore_created == 0U) {
+		(void) tx_thread_sleep(wait_ticks);
+		return TX_NO_INSTANCE;
+	}
+
+	/* Lines left over from a bounded drain do not need a new signal. */
+	if ((tx_queue_info_get(&g_sd_debug_log_queue, TX_NULL, &enqueued_count,
+			TX_NULL, TX_NULL, TX_NULL, TX_NULL) == TX_SUCCESS)
+			&& (enqueued_count != 0U)) {
+		return TX_SUCCESS;
+	}
+
+	return tx_semaphore_get(&g_sd_debug_log_pending_semaphore, wait_ticks);
+}
+
 void SdDebugLogService_ForceFlush(void) {
 	/* Force flush and close of the active file. */
 	(void) SdDebugLogCore_ForceFlushAndClose(&g_sd_debug_log_core_context,
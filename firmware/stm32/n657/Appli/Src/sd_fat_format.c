@@ -0,0 +1,546 @@
+#include "sd_fat_format.h"
+
+#include <string.h>
+
+#define SD_FAT_FORMAT_ROOT_CLUSTER        (2U)
+#define SD_FAT_FORMAT_FSINFO_SECTOR       (1U)
+#define SD_FAT_FORMAT_BACKUP_BOOT_SECTOR  (6U)
+#define SD_FAT_FORMAT_ENTRIES_PER_SECTOR  (SD_FAT_FORMAT_SECTOR_BYTES / 4U)
+#define SD_FAT_FORMAT_DIR_ENTRY_BYTES     (32U)
+#define SD_FAT_FORMAT_LFN_CHARS           (13U)
+#define SD_FAT_FORMAT_END_OF_CHAIN        (0x0FFFFFFFUL)
+#define SD_FAT_FORMAT_ATTR_DIRECTORY      (0x10U)
+#define SD_FAT_FORMAT_ATTR_LONG_NAME      (0x0FU)
+
+/* One sector of scratch; the format runs once and only on the FileX thread. */
+static uint8_t g_sd_fat_format_sector[SD_FAT_FORMAT_SECTOR_BYTES];
+
+/* Byte offsets of the 13 UCS-2 characters inside a long-name entry. */
+static const uint8_t g_sd_fat_format_lfn_offsets[SD_FAT_FORMAT_LFN_CHARS] = {
+		1U, 3U, 5U, 7U, 9U, 14U, 16U, 18U, 20U, 22U, 24U, 28U, 30U };
+
+/*==============================================================================
+ * Function: SdFatFormat_IsPowerOfTwo
+ *==============================================================================*/
+static uint8_t SdFatFormat_IsPowerOfTwo(uint32_t value) {
+	return ((value != 0U) && ((value & (value - 1U)) == 0U)) ? 1U : 0U;
+}
+
+/*==============================================================================
+ * Function: SdFatFormat_AlignUp
+ *==============================================================================*/
+static uint32_t SdFatFormat_AlignUp(uint32_t value, uint32_t align) {
+	return ((value + align - 1U) / align) * align;
+}
+
+/*==============================================================================
+ * Function: SdFatFormat_Put16 / SdFatFormat_Put32
+ *
+ * Purpose:
+ *   Little-endian field stores.
+ *==============================================================================*/
+static void SdFatFormat_Put16(uint8_t *buffer, uint32_t offset,
+		uint32_t value) {
+	buffer[offset] = (uint8_t) value;
+	buffer[offset + 1U] = (uint8_t) (value >> 8U);
+}
+
+static void SdFatFormat_Put32(uint8_t *buffer, uint32_t offset,
+		uint32_t value) {
+	SdFatFormat_Put16(buffer, offset, value);
+	SdFatFormat_Put16(buffer, offset + 2U, value >> 16U);
+}
+
+/*==============================================================================
+ * Function: SdFatFormat_FitLayout
+ *
+ * Purpose:
+ *   Place the FATs and data region for one cluster size.
+ *
+ * Notes:
+ *   FAT 1 starts on an allocation-unit boundary and each FAT is rounded up
+ *   to a whole cluster, so the data region starts cluster-aligned on the
+ *   card and no cluster straddles a unit. The root and the pre-created
+ *   directories follow the FATs inside that first unit, keeping all the
+ *   per-file metadata writes in one unit. The FAT is deliberately not padded
+ *   to a whole unit: FileX tracks written FAT sectors in a fixed-size map,
+ *   so a longer FAT means more secondary FAT sectors copied per flush.
+ *
+ *   The FAT length depends on the cluster count, which depends on the FAT
+ *   length; growing the FAT only shrinks the data region, so a few rounds
+ *   settle it.
+ *
+ * Returns:
+ *   0 if the cluster count is valid for FAT32, otherwise -1.
+ *==============================================================================*/
+static int32_t SdFatFormat_FitLayout(const SdFatFormat_Config *config_ptr,
+		uint32_t sectors_per_cluster, SdFatFormat_Layout *layout_ptr) {
+	const uint32_t align = config_ptr->align_sectors;
+	const uint32_t total = config_ptr->partition_sectors;
+	uint32_t reserved = 0U;
+	uint32_t fat_used = 1U;
+	uint32_t fat_padded = 0U;
+	uint32_t data_start = 0U;
+	uint32_t clusters = 0U;
+
+	/* Measured on the card rather than inside the partition. */
+	reserved = SdFatFormat_AlignUp(
+			config_ptr->partition_start_lba
+					+ SD_FAT_FORMAT_MIN_RESERVED_SECTORS, align)
+			- config_ptr->partition_start_lba;
+
+	for (uint32_t round = 0U; round < 8U; round++) {
+		uint64_t fat_bytes = 0U;
+		uint32_t fat_needed = 0U;
+
+		fat_padded = SdFatFormat_AlignUp(fat_used, sectors_per_cluster);
+		data_start = reserved
+				+ (SD_FAT_FORMAT_NUMBER_OF_FATS * fat_padded);
+		if (data_start >= total) {
+			return -1;
+		}
+
+		clusters = (total - data_start) / sectors_per_cluster;
+		fat_bytes = ((uint64_t) clusters + SD_FAT_FORMAT_ROOT_CLUSTER) * 4U;
+		fat_needed = (uint32_t) ((fat_bytes + SD_FAT_FORMAT_SECTOR_BYTES - 1U)
+				/ SD_FAT_FORMAT_SECTOR_BYTES);
+		if (fat_needed <= fat_padded) {
+			fat_used = fat_needed;
+			break;
+		}
+		fat_used = fat_needed;
+	}
+
+	if ((fat_used > fat_padded) || (clusters < SD_FAT_FORMAT_MIN_CLUSTERS)
+			|| (clusters > SD_FAT_FORMAT_MAX_CLUSTERS)) {
+		return -1;
+	}
+
+	layout_ptr->hidden_sectors = config_ptr->partition_start_lba;
+	layout_ptr->total_sectors = total;
+	layout_ptr->align_sectors = align;
+	layout_ptr->sectors_per_cluster = sectors_per_cluster;
+	layout_ptr->reserved_sectors = reserved;
+	layout_ptr->sectors_per_fat = fat_padded;
+	layout_ptr->fat_used_sectors = fat_used;
+	layout_ptr->data_start_sector = data_start;
+	layout_ptr->cluster_count = clusters;
+	return 0;
+}
+
+/*==============================================================================
+ * Function: SdFatFormat_PlanLayout
+ *==============================================================================*/
+int32_t SdFatFormat_PlanLayout(const SdFatFormat_Config *config_ptr,
+		SdFatFormat_Layout *layout_ptr) {
+	if ((config_ptr == NULL) || (layout_ptr == NULL)
+			|| (config_ptr->partition_sectors == 0U)
+			|| (config_ptr->file_bytes == 0U)
+			|| (SdFatFormat_IsPowerOfTwo(config_ptr->align_sectors) == 0U)
+			|| (config_ptr->align_sectors > SD_FAT_FORMAT_MAX_ALIGN_SECTORS)
+			|| (config_ptr->partition_start_lba > (UINT32_MAX
+					- SD_FAT_FORMAT_MAX_ALIGN_SECTORS))) {
+		return -1;
+	}
+
+	for (uint32_t sectors_per_cluster = SD_FAT_FORMAT_MAX_SECTORS_PER_CLUSTER;
+			sectors_per_cluster != 0U; sectors_per_cluster >>= 1U) {
+		const uint64_t cluster_bytes = (uint64_t) sectors_per_cluster
+				* SD_FAT_FORMAT_SECTOR_BYTES;
+		const uint64_t allocated_bytes = ((config_ptr->file_bytes
+				+ cluster_bytes - 1U) / cluster_bytes) * cluster_bytes;
+
+		if (sectors_per_cluster > config_ptr->align_sectors) {
+			continue; /* Clusters must tile the unit. */
+		}
+		if ((allocated_bytes * 100U)
+				> ((uint64_t) config_ptr->file_bytes
+						* (100U + config_ptr->max_slack_percent))) {
+			continue;
+		}
+		if (SdFatFormat_FitLayout(config_ptr, sectors_per_cluster, layout_ptr)
+				== 0) {
+			return 0;
+		}
+	}
+
+	return -2;
+}
+
+/*==============================================================================
+ * Function: SdFatFormat_DirectoryFirstCluster
+ *==============================================================================*/
+uint32_t SdFatFormat_DirectoryFirstCluster(
+		const SdFatFormat_Directory *directories, uint32_t directory_index) {
+	uint32_t cluster = SD_FAT_FORMAT_ROOT_CLUSTER + 1U;
+
+	for (uint32_t index = 0U; index < directory_index; index++) {
+		cluster += directories[index].clusters;
+	}
+	return cluster;
+}
+
+/*==============================================================================
+ * Function: SdFatFormat_FatEntry
+ *
+ * Purpose:
+ *   Value of one FAT entry on the fresh volume: the two reserved entries,
+ *   the one-cluster root directory, then each directory extent chained
+ *   cluster to cluster.
+ *==============================================================================*/
+static uint32_t SdFatFormat_FatEntry(const SdFatFormat_Directory *directories,
+		uint32_t directory_count, uint32_t cluster) {
+	if (cluster == 0U) {
+		return 0x0FFFFFF8UL; /* Media byte 0xF8. */
+	}
+	if ((cluster == 1U) || (cluster == SD_FAT_FORMAT_ROOT_CLUSTER)) {
+		return SD_FAT_FORMAT_END_OF_CHAIN;
+	}
+
+	for (uint32_t index = 0U; index < directory_count; index++) {
+		const uint32_t first = SdFatFormat_DirectoryFirstCluster(directories,
+				index);
+		const uint32_t last = first + directories[index].clusters - 1U;
+
+		if ((cluster >= first) && (cluster <= last)) {
+			return (cluster == last) ? SD_FAT_FORMAT_END_OF_CHAIN :
+					(cluster + 1U);
+		}
+	}
+	return 0U;
+}
+
+/*==============================================================================
+ * Function: SdFatFormat_ShortName
+ *
+ * Purpose:
+ *   Build the 8.3 alias "BASE~N" FileX and other readers fall back to. N
+ *   counts earlier directories with the same base so aliases stay unique.
+ *==============================================================================*/
+static void SdFatFormat_ShortName(const SdFatFormat_Directory *directories,
+		uint32_t directory_index, uint8_t short_name[11]) {
+	uint8_t bases[SD_FAT_FORMAT_MAX_DIRECTORIES][6];
+	uint32_t base_length = 0U;
+	uint32_t tail = 1U;
+
+	(void) memset(bases, ' ', sizeof(bases));
+	for (uint32_t index = 0U; index <= directory_index; index++) {
+		const char *name = directories[index].name;
+		uint32_t length = 0U;
+
+		for (uint32_t char_index = 0U;
+				(name[char_index] != '\0') && (length < 6U); char_index++) {
+			char c = name[char_index];
+
+			if ((c >= 'a') && (c <= 'z')) {
+				c = (char) (c - 'a' + 'A');
+			}
+			if (((c >= 'A') && (c <= 'Z')) || ((c >= '0') && (c <= '9'))
+					|| (c == '_') || (c == '-')) {
+				bases[index][length] = (uint8_t) c;
+				length++;
+			}
+		}
+		if (length == 0U) {
+			bases[index][0] = '_';
+			length = 1U;
+		}
+		if (index == directory_index) {
+			base_length = length;
+		}
+	}
+
+	for (uint32_t index = 0U; index < directory_index; index++) {
+		if (memcmp(bases[index], bases[directory_index], 6U) == 0) {
+			tail++;
+		}
+	}
+
+	(void) memset(short_name, ' ', 11U);
+	(void) memcpy(short_name, bases[directory_index], base_length);
+	short_name[base_length] = '~';
+	short_name[base_length + 1U] = (uint8_t) ('0' + tail);
+}
+
+/*==============================================================================
+ * Function: SdFatFormat_ShortNameChecksum
+ *==============================================================================*/
+static uint8_t SdFatFormat_ShortNameChecksum(const uint8_t short_name[11]) {
+	uint8_t sum = 0U;
+
+	for (uint32_t index = 0U; index < 11U; index++) {
+		sum = (uint8_t) ((uint8_t) ((sum & 1U) << 7U) + (sum >> 1U)
+				+ short_name[index]);
+	}
+	return sum;
+}
+
+/*==============================================================================
+ * Function: SdFatFormat_PutShortEntry
+ *==============================================================================*/
+static void SdFatFormat_PutShortEntry(uint8_t *entry,
+		const uint8_t short_name[11], uint32_t cluster,
+		uint32_t dos_date_time) {
+	(void) memcpy(entry, short_name, 11U);
+	entry[11] = SD_FAT_FORMAT_ATTR_DIRECTORY;
+	SdFatFormat_Put16(entry, 14U, dos_date_time); /* Created. */
+	SdFatFormat_Put16(entry, 16U, dos_date_time >> 16U);
+	SdFatFormat_Put16(entry, 18U, dos_date_time >> 16U); /* Accessed. */
+	SdFatFormat_Put16(entry, 20U, cluster >> 16U);
+	SdFatFormat_Put16(entry, 22U, dos_date_time); /* Modified. */
+	SdFatFormat_Put16(entry, 24U, dos_date_time >> 16U);
+	SdFatFormat_Put16(entry, 26U, cluster);
+}
+
+/*==============================================================================
+ * Function: SdFatFormat_PutLongName
+ *
+ * Purpose:
+ *   Write the long-name entries for name, last part first as FAT expects.
+ *
+ * Returns:
+ *   Number of 32-byte entries written.
+ *==============================================================================*/
+static uint32_t SdFatFormat_PutLongName(uint8_t *entries, const char *name,
+		uint8_t checksum) {
+	const uint32_t length = (uint32_t) strlen(name);
+	const uint32_t count = (length + SD_FAT_FORMAT_LFN_CHARS - 1U)
+			/ SD_FAT_FORMAT_LFN_CHARS;
+
+	for (uint32_t slot = 0U; slot < count; slot++) {
+		const uint32_t part = count - 1U - slot;
+		uint8_t *entry = &entries[slot * SD_FAT_FORMAT_DIR_ENTRY_BYTES];
+
+		entry[0] = (uint8_t) ((part + 1U) | ((slot == 0U) ? 0x40U : 0U));
+		entry[11] = SD_FAT_FORMAT_ATTR_LONG_NAME;
+		entry[13] = checksum;
+		for (uint32_t char_index = 0U; char_index < SD_FAT_FORMAT_LFN_CHARS;
+				char_index++) {
+			const uint32_t name_index = (part * SD_FAT_FORMAT_LFN_CHARS)
+					+ char_index;
+			uint32_t value = 0xFFFFU; /* Padding after the terminator. */
+
+			if (name_index < length) {
+				value = (uint8_t) name[name_index];
+			} else if (name_index == length) {
+				value = 0U;
+			}
+			SdFatFormat_Put16(entry,
+					g_sd_fat_format_lfn_offsets[char_index], value);
+		}
+	}
+	return count;
+}
+
+/*==============================================================================
+ * Function: SdFatFormat_WriteCluster
+ *
+ * Purpose:
+ *   Write a cluster whose first sector is g_sd_fat_format_sector and whose
+ *   remaining sectors are zero.
+ *==============================================================================*/
+static int32_t SdFatFormat_WriteCluster(const SdFatFormat_Layout *layout_ptr,
+		uint32_t cluster, SdFatFormat_WriteSectorFunction write_function,
+		void *write_context) {
+	const uint32_t first_sector = layout_ptr->data_start_sector
+			+ ((cluster - SD_FAT_FORMAT_ROOT_CLUSTER)
+					* layout_ptr->sectors_per_cluster);
+
+	for (uint32_t sector = 0U; sector < layout_ptr->sectors_per_cluster;
+			sector++) {
+		if (write_function(write_context, first_sector + sector,
+				g_sd_fat_format_sector) != 0) {
+			return -2;
+		}
+		if (sector == 0U) {
+			(void) memset(g_sd_fat_format_sector, 0,
+					sizeof(g_sd_fat_format_sector));
+		}
+	}
+	return 0;
+}
+
+/*==============================================================================
+ * Function: SdFatFormat_BuildBootSector
+ *==============================================================================*/
+static void SdFatFormat_BuildBootSector(const SdFatFormat_Layout *layout_ptr,
+		uint32_t volume_id) {
+	uint8_t *boot = g_sd_fat_format_sector;
+
+	(void) memset(boot, 0, SD_FAT_FORMAT_SECTOR_BYTES);
+	boot[0] = 0xEBU; /* Jump over the BPB. */
+	boot[1] = 0x58U;
+	boot[2] = 0x90U;
+	(void) memcpy(&boot[3], "MSWIN4.1", 8U);
+	SdFatFormat_Put16(boot, 11U, SD_FAT_FORMAT_SECTOR_BYTES);
+	boot[13] = (uint8_t) layout_ptr->sectors_per_cluster;
+	SdFatFormat_Put16(boot, 14U, layout_ptr->reserved_sectors);
+	boot[16] = SD_FAT_FORMAT_NUMBER_OF_FATS;
+	boot[21] = 0xF8U; /* Fixed media. */
+	SdFatFormat_Put16(boot, 24U, 63U); /* Sectors per track. */
+	SdFatFormat_Put16(boot, 26U, 255U); /* Heads. */
+	SdFatFormat_Put32(boot, 28U, layout_ptr->hidden_sectors);
+	SdFatFormat_Put32(boot, 32U, layout_ptr->total_sectors);
+	SdFatFormat_Put32(boot, 36U, layout_ptr->sectors_per_fat);
+	SdFatFormat_Put32(boot, 44U, SD_FAT_FORMAT_ROOT_CLUSTER);
+	SdFatFormat_Put16(boot, 48U, SD_FAT_FORMAT_FSINFO_SECTOR);
+	SdFatFormat_Put16(boot, 50U, SD_FAT_FORMAT_BACKUP_BOOT_SECTOR);
+	boot[64] = 0x80U; /* Drive number. */
+	boot[66] = 0x29U; /* Extended boot signature. */
+	SdFatFormat_Put32(boot, 67U, volume_id);
+	(void) memcpy(&boot[71], "NO NAME    ", 11U);
+	(void) memcpy(&boot[82], "FAT32   ", 8U);
+	boot[510] = 0x55U;
+	boot[511] = 0xAAU;
+}
+
+/*==============================================================================
+ * Function: SdFatFormat_BuildFsInfo
+ *==============================================================================*/
+static void SdFatFormat_BuildFsInfo(const SdFatFormat_Layout *layout_ptr,
+		uint32_t next_free_cluster) {
+	uint8_t *fs_info = g_sd_fat_format_sector;
+	const uint32_t used_clusters = next_free_cluster
+			- SD_FAT_FORMAT_ROOT_CLUSTER;
+
+	(void) memset(fs_info, 0, SD_FAT_FORMAT_SECTOR_BYTES);
+	SdFatFormat_Put32(fs_info, 0U, 0x41615252UL);
+	SdFatFormat_Put32(fs_info, 484U, 0x61417272UL);
+	SdFatFormat_Put32(fs_info, 488U, layout_ptr->cluster_count - used_clusters);
+	SdFatFormat_Put32(fs_info, 492U, next_free_cluster);
+	SdFatFormat_Put32(fs_info, 508U, 0xAA550000UL);
+}
+
+/*==============================================================================
+ * Function: SdFatFormat_Write
+ *==============================================================================*/
+int32_t SdFatFormat_Write(const SdFatFormat_Layout *layout_ptr,
+		const SdFatFormat_Directory *directories, uint32_t directory_count,
+		uint32_t volume_id, uint32_t dos_date_time,
+		SdFatFormat_WriteSectorFunction write_function, void *write_context) {
+	uint8_t short_name[11];
+	uint32_t next_free_cluster = 0U;
+	uint32_t entry_offset = 0U;
+
+	if ((layout_ptr == NULL) || (write_function == NULL)
+			|| (directory_count > SD_FAT_FORMAT_MAX_DIRECTORIES)
+			|| ((directory_count != 0U) && (directories == NULL))
+			|| (layout_ptr->sectors_per_cluster == 0U)
+			|| (layout_ptr->cluster_count < SD_FAT_FORMAT_MIN_CLUSTERS)) {
+		return -1;
+	}
+	for (uint32_t index = 0U; index < directory_count; index++) {
+		const size_t length = (directories[index].name != NULL) ?
+				strlen(directories[index].name) : 0U;
+
+		if ((length == 0U) || (length > SD_FAT_FORMAT_MAX_NAME_LENGTH)
+				|| (directories[index].clusters == 0U)) {
+			return -1;
+		}
+	}
+	next_free_cluster = SdFatFormat_DirectoryFirstCluster(directories,
+			directory_count);
+	if ((next_free_cluster - SD_FAT_FORMAT_ROOT_CLUSTER)
+			>= layout_ptr->cluster_count) {
+		return -1;
+	}
+
+	/* Clear both boot sectors first so an interrupted reformat leaves an
+	 * unmountable volume rather than the old layout over the new FATs. */
+	(void) memset(g_sd_fat_format_sector, 0, sizeof(g_sd_fat_format_sector));
+	if ((write_function(write_context, 0U, g_sd_fat_format_sector) != 0)
+			|| (write_function(write_context,
+					SD_FAT_FORMAT_BACKUP_BOOT_SECTOR, g_sd_fat_format_sector)
+					!= 0)) {
+		return -2;
+	}
+
+	/* Both FAT copies, entries only; the cluster rounding is never read. */
+	for (uint32_t fat = 0U; fat < SD_FAT_FORMAT_NUMBER_OF_FATS; fat++) {
+		const uint32_t fat_start = layout_ptr->reserved_sectors
+				+ (fat * layout_ptr->sectors_per_fat);
+
+		for (uint32_t sector = 0U; sector < layout_ptr->fat_used_sectors;
+				sector++) {
+			const uint32_t first_entry = sector
+					* SD_FAT_FORMAT_ENTRIES_PER_SECTOR;
+
+			(void) memset(g_sd_fat_format_sector, 0,
+					sizeof(g_sd_fat_format_sector));
+			for (uint32_t entry = 0U; (entry < SD_FAT_FORMAT_ENTRIES_PER_SECTOR)
+					&& ((first_entry + entry) < next_free_cluster); entry++) {
+				SdFatFormat_Put32(g_sd_fat_format_sector, entry * 4U,
+						SdFatFormat_FatEntry(directories, directory_count,
+								first_entry + entry));
+			}
+			if (write_function(write_context, fat_start + sector,
+					g_sd_fat_format_sector) != 0) {
+				return -2;
+			}
+		}
+	}
+
+	/* Root directory: long name plus alias for each directory. */
+	(void) memset(g_sd_fat_format_sector, 0, sizeof(g_sd_fat_format_sector));
+	for (uint32_t index = 0U; index < directory_count; index++) {
+		SdFatFormat_ShortName(directories, index, short_name);
+		entry_offset += SdFatFormat_PutLongName(
+				&g_sd_fat_format_sector[entry_offset], directories[index].name,
+				SdFatFormat_ShortNameChecksum(short_name))
+				* SD_FAT_FORMAT_DIR_ENTRY_BYTES;
+		SdFatFormat_PutShortEntry(&g_sd_fat_format_sector[entry_offset],
+				short_name,
+				SdFatFormat_DirectoryFirstCluster(directories, index),
+				dos_date_time);
+		entry_offset += SD_FAT_FORMAT_DIR_ENTRY_BYTES;
+	}
+	if (SdFatFormat_WriteCluster(layout_ptr, SD_FAT_FORMAT_ROOT_CLUSTER,
+			write_function, write_context) != 0) {
+		return -2;
+	}
+
+	/* Each extent: "." and ".." (parent is the root, recorded as 0). */
+	for (uint32_t index = 0U; index < directory_count; index++) {
+		const uint32_t first = SdFatFormat_DirectoryFirstCluster(directories,
+				index);
+
+		(void) memset(g_sd_fat_format_sector, 0,
+				sizeof(g_sd_fat_format_sector));
+		(void) memset(short_name, ' ', sizeof(short_name));
+		short_name[0] = '.';
+		SdFatFormat_PutShortEntry(g_sd_fat_format_sector, short_name, first,
+				dos_date_time);
+		short_name[1] = '.';
+		SdFatFormat_PutShortEntry(
+				&g_sd_fat_format_sector[SD_FAT_FORMAT_DIR_ENTRY_BYTES],
+				short_name, 0U, dos_date_time);
+
+		for (uint32_t cluster = first;
+				cluster < (first + directories[index].clusters); cluster++) {
+			if (SdFatFormat_WriteCluster(layout_ptr, cluster, write_function,
+					write_context) != 0) {
+				return -2;
+			}
+		}
+	}
+
+	/* FSInfo and its backup, then the backup boot sector and the boot
+	 * sector itself. */
+	SdFatFormat_BuildFsInfo(layout_ptr, next_free_cluster);
+	if ((write_function(write_context,
+			SD_FAT_FORMAT_BACKUP_BOOT_SECTOR + SD_FAT_FORMAT_FSINFO_SECTOR,
+			g_sd_fat_format_sector) != 0)
+			|| (write_function(write_context, SD_FAT_FORMAT_FSINFO_SECTOR,
+					g_sd_fat_format_sector) != 0)) {
+		return -2;
+	}
+	SdFatFormat_BuildBootSector(layout_ptr, volume_id);
+	if ((write_function(write_context, SD_FAT_FORMAT_BACKUP_BOOT_SECTOR,
+			g_sd_fat_format_sector) != 0)
+			|| (write_function(write_context, 0U, g_sd_fat_format_sector)
+					!= 0)) {
+		return -2;
+	}
+
+	return 0;
+}
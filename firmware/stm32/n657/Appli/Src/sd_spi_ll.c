@@ -16,12 +16,44 @@
 #include "tx_api.h"
 #include "threadx_utils.h"
 #include "debug_console.h"
+#include "app_low_power.h"
+#include "app_clock_profile.h"
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include "sd_spi_protocol.h"
 
 extern SPI_HandleTypeDef hspi5; // Use CubeMX-generated SPI handle, provided by STM32 HAL startup code.
 
+/* Set once the card has left the 400 kHz identification phase. */
+static bool g_sd_spi_high_speed = false;
+
+/*==============================================================================
+ * Function: SPI_SD_HighSpeedPrescaler
+ *
+ * Purpose:
+ *   MBR field value for the fastest SCK within the SD SPI-mode limit at the
+ *   current PCLK2 (the SPI5 kernel clock).
+ *
+ * Notes:
+ *   The MBR encoding is log2(divider) - 1, which is also how the HAL
+ *   SPI_BAUDRATEPRESCALER_x constants are laid out.
+ *==============================================================================*/
+static uint32_t SPI_SD_HighSpeedPrescaler(void) {
+    uint32_t divider = AppClockProfile_SpiDivider(HAL_RCC_GetPCLK2Freq(),
+            APP_CLOCK_PROFILE_SPI5_MAX_HZ);
+    uint32_t field = 0U;
+
+    if (divider == 0U) {
+        return SPI_BAUDRATEPRESCALER_256;
+    }
+    while (divider > 2U) {
+        divider >>= 1U;
+        field++;
+    }
+    return field << SPI_CFG1_MBR_Pos;
+}
+
 /*==============================================================================
  * Function: SPI_SD_SetHighSpeed
  *
@@ -30,12 +62,35 @@ extern SPI_HandleTypeDef hspi5; // Use CubeMX-generated SPI handle, provided by
  *   Must be called after ACMD41 succeeds and before any block read/write.
  *
  * Notes:
- *   SPI5 kernel clock = PCLK2 = 100 MHz.
- *   PRESCALER_4 → 25 MHz, which is the SD SPI mode specification maximum.
+ *   The prescaler follows PCLK2, so SCK stays at the 25 MHz SD SPI-mode
+ *   maximum whichever clock profile is active (/4 at the 100 MHz boot bus).
  *==============================================================================*/
 void SPI_SD_SetHighSpeed(void) {
-    hspi5.Init.BaudRatePrescaler = SPI_BAUDRATEPRESCALER_4;
+    hspi5.Init.BaudRatePrescaler = SPI_SD_HighSpeedPrescaler();
     (void) HAL_SPI_Init(&hspi5);
+    g_sd_spi_high_speed = true;
+}
+
+/*==============================================================================
+ * Function: SPI_SD_RetuneForBusClock
+ *
+ * Purpose:
+ *   Re-derive the data-phase prescaler after PCLK2 changed.
+ *
+ * Notes:
+ *   Register-only so it can run inside the clock switch's interrupt lock.
+ *   The caller holds the FileX media lock, so SPE is clear between
+ *   transfers; a card still in identification keeps its slow prescaler.
+ *==============================================================================*/
+void SPI_SD_RetuneForBusClock(void) {
+    uint32_t prescaler = 0U;
+
+    if (!g_sd_spi_high_speed || ((hspi5.Instance->CR1 & SPI_CR1_SPE) != 0U)) {
+        return;
+    }
+    prescaler = SPI_SD_HighSpeedPrescaler();
+    MODIFY_REG(hspi5.Instance->CFG1, SPI_CFG1_MBR, prescaler);
+    hspi5.Init.BaudRatePrescaler = prescaler;
 }
 
 /* CMD17 (READ_SINGLE_BLOCK) data token for a valid data block. */
@@ -584,6 +639,86 @@ uint8_t SPI_SendCMD58_ReadOCR(uint8_t ocr_out[4]) {
 	return r1; /* Return R1 for caller diagnostics. */
 }
 
+/*==============================================================================
+ * Function: SPI_SendACMD13_ReadSdStatus
+ *
+ * Purpose:
+ *   Send CMD55 then ACMD13 (SD_STATUS) and read the 64-byte SD status block.
+ *
+ * Parameters:
+ *   sd_status_out - Pointer to a 64-byte buffer (MSB of the register first).
+ *
+ * Returns:
+ *   0x00 on success, otherwise an R1 error code or 0xFF on timeout.
+ *
+ * Side Effects:
+ *   Controls CS, clocks bus, and reads the status block from MISO.
+ *
+ * Preconditions:
+ *   - Card initialized (ACMD41 ready).
+ *
+ * Concurrency:
+ *   Not thread-safe.
+ *
+ * Notes:
+ *   In SPI mode ACMD13 answers with R2; the second byte is discarded and the
+ *   status follows as a normal data block.
+ *==============================================================================*/
+uint8_t SPI_SendACMD13_ReadSdStatus(uint8_t sd_status_out[64]) {
+	uint8_t r1 = 0xFFU; /* R1 response from CMD55 and ACMD13. */
+	uint8_t token = 0xFFU; /* Data token (0xFE indicates start of data). */
+	SdSpiProtocol_DataTokenWaitStatus token_wait_status =
+			SD_SPI_PROTOCOL_DATA_TOKEN_WAIT_STATUS_TIMEOUT;
+
+	if (sd_status_out == NULL) /* Validate output buffer pointer. */
+	{
+		return 0xFFU; /* Return generic failure for invalid argument. */
+	}
+
+	SD_Select(); /* Assert CS low to start an SPI transaction. */
+	SD_SendIdleClocks(1U); /* Provide gap clocks so card can respond cleanly. */
+
+	r1 = SD_SendCommand(55U, 0U, 0xFFU); /* CMD55: next command is an application command. */
+	if (r1 > 0x01U) /* Ready or idle are both fine for APP_CMD. */
+	{
+		SD_Deselect(); /* Release CS. */
+		SD_SendIdleClocks(2U); /* Trailing clocks. */
+		return r1; /* Return the R1 error code. */
+	}
+	(void) SD_SPI_TransferByte(0xFFU); /* Small gap between CMD55 and the ACMD. */
+
+	r1 = SD_SendCommand(13U, 0U, 0xFFU); /* ACMD13 requests the SD status block. */
+	(void) SD_SPI_TransferByte(0xFFU); /* Discard the second R2 byte. */
+	if (r1 != 0x00U) /* If card did not accept command, stop early. */
+	{
+		SD_Deselect(); /* Release CS. */
+		SD_SendIdleClocks(2U); /* Trailing clocks. */
+		return r1; /* Return the R1 error code. */
+	}
+
+	token_wait_status = SdSpiProtocol_WaitForDataToken(
+			SD_SPI_TransferByte_ProtocolAdapter, NULL,
+			SD_SPI_DATA_START_TOKEN_SINGLE_BLOCK_READ, 100000U, &token); /* Status block uses the single-block token. */
+	if (token_wait_status != SD_SPI_PROTOCOL_DATA_TOKEN_WAIT_STATUS_OK) {
+		SD_Deselect(); /* Release CS to end transaction. */
+		SD_SendIdleClocks(2U); /* Extra clocks help card return to idle state. */
+		return 0xFFU; /* Return timeout or unexpected token. */
+	}
+
+	for (uint32_t i = 0U; i < 64U; i++) /* Read the 512-bit status block. */
+	{
+		sd_status_out[i] = SD_SPI_TransferByte(0xFFU); /* Send dummy byte, receive data byte. */
+	}
+
+	(void) SD_SPI_TransferByte(0xFFU); /* Discard CRC byte 0, not used here. */
+	(void) SD_SPI_TransferByte(0xFFU); /* Discard CRC byte 1, not used here. */
+
+	SD_Deselect(); /* End SPI transaction. */
+	SD_SendIdleClocks(2U); /* Trailing clocks. */
+
+	return 0x00U; /* Success. */
+}
+
 /*==============================================================================
  * Function: SPI_ReadUInt32LittleEndian
  *
@@ -975,11 +1110,15 @@ uint8_t SPI_ReadPartition0Info(uint32_t *partition_start_lba_out,
  * Notes:
  *   This driver maps FileX logical sector numbers to physical SD sectors by
  *   adding the FAT partition start LBA (MBR offset).
+ *
+ *   SPI5 is held for the duration of each request; the power-domain minimum
+ *   off time keeps it clocked across the bursts FileX issues back to back.
  *==============================================================================*/
 VOID SPI_FileX_SdSpiMediaDriver(FX_MEDIA *media_ptr) {
 	Sd_FileX_DriverContext *context =
 			(Sd_FileX_DriverContext*) media_ptr->fx_media_driver_info; /* Retrieve driver context pointer. */
 	UINT status = FX_SUCCESS; /* Default to success unless an operation fails. */
+	bool spi_held = false; /* Whether this request took an SPI5 reference. */
 
 	if (context == NULL) /* Driver must have context to know partition offsets. */
 	{
@@ -988,6 +1127,8 @@ VOID SPI_FileX_SdSpiMediaDriver(FX_MEDIA *media_ptr) {
 		return; /* Exit immediately. */
 	}
 
+	spi_held = AppLowPower_AcquireDomain(APP_POWER_DOMAIN_SD_SPI); /* Ungate SPI5 if it was idle. */
+
 	switch (media_ptr->fx_media_driver_request) /* Dispatch based on FileX request code. */
 	{
 	case FX_DRIVER_INIT: /* FileX is opening the media and wants geometry. */
@@ -1082,4 +1223,8 @@ VOID SPI_FileX_SdSpiMediaDriver(FX_MEDIA *media_ptr) {
 		break; /* Exit switch. */
 	}
 	}
+
+	if (spi_held) {
+		AppLowPower_ReleaseDomain(APP_POWER_DOMAIN_SD_SPI); /* Gate again once FileX goes quiet. */
+	}
 }
@@ -22,6 +22,7 @@
 #include "stm32n6xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "app_ai.h"
 #include "cmw_camera.h"
 #include "debug_console.h"
 #include "stm32n6xx_ll_lpuart.h"
@@ -207,6 +208,8 @@ void HardFault_Handler_C(uint32_t *stacked_regs, uint32_t exc_lr)
   IT_RawUartWriteHex32((uint32_t)app_ai_scalar_preprocess_last_row);
   IT_RawUartWrite("\r\n");
   IT_RawUartWrite("[FAULT] HardFault latched; staying in fault loop.\r\n");
+  /* The loop only ends in a reset; hand the boot ROM an SPI-mode flash. */
+  AppAI_Xspi2ResetFlashForReboot();
   while (1)
   {
     __NOP();
@@ -252,6 +255,7 @@ static void IT_LogContextFault(const char *fault_name, uint32_t *stacked_regs, u
   IT_RawUartWrite("[FAULT] ");
   IT_RawUartWrite(fault_name);
   IT_RawUartWrite(" latched; staying in fault loop.\r\n");
+  AppAI_Xspi2ResetFlashForReboot();
   while (1)
   {
     __NOP();
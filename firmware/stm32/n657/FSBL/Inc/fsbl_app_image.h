@@ -0,0 +1,86 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file           : fsbl_app_image.h
+  * @brief          : Application image header, CRC-32 and load copy.
+  *
+  * The header is a 32-byte little-endian block written next to the signed
+  * application (see tools/make_app_image_header.py). It tells the FSBL how
+  * many bytes to copy and what CRC-32 they must have once in RAM, so the
+  * copy no longer has to cover the whole 512 KB slot.
+  *
+  * Pure logic with no HAL dependency so it can be unit-tested on the host.
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+#ifndef __FSBL_APP_IMAGE_H
+#define __FSBL_APP_IMAGE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define FSBL_APP_IMAGE_MAGIC        (0x48505041UL)  /* "APPH" in flash order */
+#define FSBL_APP_IMAGE_VERSION      (1U)
+#define FSBL_APP_IMAGE_HEADER_SIZE  (32U)
+
+/* Header layout (byte offsets):
+ *   0  magic          4  version (u16)   6  header_size (u16)
+ *   8  load_address  12  image_size     16  image_crc32
+ *  20  reserved[2]   28  header_crc32 (CRC-32 of bytes 0..27) */
+typedef struct
+{
+  uint32_t load_address;
+  uint32_t image_size;
+  uint32_t image_crc32;
+} FsblAppImage_Header_t;
+
+typedef enum
+{
+  FSBL_APP_IMAGE_OK = 0,
+  FSBL_APP_IMAGE_ERASED,           /* Header slot is blank: legacy layout. */
+  FSBL_APP_IMAGE_BAD_MAGIC,
+  FSBL_APP_IMAGE_BAD_VERSION,
+  FSBL_APP_IMAGE_BAD_HEADER_CRC,
+  FSBL_APP_IMAGE_BAD_LOAD_ADDRESS,
+  FSBL_APP_IMAGE_BAD_SIZE,
+} FsblAppImage_Status_t;
+
+/**
+  * @brief  Continue a CRC-32 (IEEE 802.3, zlib-compatible) over more bytes.
+  * @param  crc Previous result, or 0 to start.
+  */
+uint32_t FsblAppImage_Crc32Update(uint32_t crc, const void *data, size_t length);
+
+/**
+  * @brief  Decode and check a header against where the FSBL will load it.
+  * @param  expected_load Only this load address is accepted.
+  * @param  max_size      Largest image the RAM slot can hold.
+  */
+FsblAppImage_Status_t FsblAppImage_ParseHeader(const uint8_t *bytes,
+                                               size_t length,
+                                               uint32_t expected_load,
+                                               uint32_t max_size,
+                                               FsblAppImage_Header_t *header);
+
+/**
+  * @brief  Copy @p length bytes in 32-byte bursts and return the CRC-32 of
+  *         what landed in @p dst.
+  *
+  * Each burst is checksummed from the destination right after it is
+  * written, so the source (memory-mapped flash) is read only once and the
+  * CRC covers the copy itself. Both pointers must be 4-byte aligned.
+  */
+uint32_t FsblAppImage_CopyWithCrc(void *dst, const void *src, size_t length);
+
+const char *FsblAppImage_StatusName(FsblAppImage_Status_t status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FSBL_APP_IMAGE_H */
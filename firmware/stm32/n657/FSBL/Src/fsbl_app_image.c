@@ -0,0 +1,192 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file           : fsbl_app_image.c
+  * @brief          : Application image header, CRC-32 and load copy.
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+#include "fsbl_app_image.h"
+
+#include <stdbool.h>
+
+#define FSBL_APP_IMAGE_CRC_POLY     (0xEDB88320UL)
+#define FSBL_APP_IMAGE_BURST_WORDS  (8U)  /* One 32-byte cache line. */
+
+static uint32_t fsbl_crc_table[256];
+static bool fsbl_crc_table_ready = false;
+
+static void FsblAppImage_BuildCrcTable(void)
+{
+  for (uint32_t i = 0U; i < 256U; i++)
+  {
+    uint32_t value = i;
+
+    for (uint32_t bit = 0U; bit < 8U; bit++)
+    {
+      value = ((value & 1UL) != 0UL) ? ((value >> 1) ^ FSBL_APP_IMAGE_CRC_POLY)
+                                     : (value >> 1);
+    }
+    fsbl_crc_table[i] = value;
+  }
+  fsbl_crc_table_ready = true;
+}
+
+static uint32_t FsblAppImage_ReadLe32(const uint8_t *bytes)
+{
+  return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) |
+         ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+static uint16_t FsblAppImage_ReadLe16(const uint8_t *bytes)
+{
+  return (uint16_t)((uint16_t)bytes[0] | ((uint16_t)bytes[1] << 8));
+}
+
+uint32_t FsblAppImage_Crc32Update(uint32_t crc, const void *data, size_t length)
+{
+  const uint8_t *bytes = (const uint8_t *)data;
+
+  if (!fsbl_crc_table_ready)
+  {
+    FsblAppImage_BuildCrcTable();
+  }
+
+  crc = ~crc;
+  for (size_t i = 0U; i < length; i++)
+  {
+    crc = fsbl_crc_table[(crc ^ bytes[i]) & 0xFFU] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+FsblAppImage_Status_t FsblAppImage_ParseHeader(const uint8_t *bytes,
+                                               size_t length,
+                                               uint32_t expected_load,
+                                               uint32_t max_size,
+                                               FsblAppImage_Header_t *header)
+{
+  bool erased = true;
+  uint32_t image_size = 0U;
+
+  if ((bytes == NULL) || (header == NULL) ||
+      (length < FSBL_APP_IMAGE_HEADER_SIZE))
+  {
+    return FSBL_APP_IMAGE_BAD_SIZE;
+  }
+
+  for (uint32_t i = 0U; i < FSBL_APP_IMAGE_HEADER_SIZE; i++)
+  {
+    if (bytes[i] != 0xFFU)
+    {
+      erased = false;
+      break;
+    }
+  }
+  if (erased)
+  {
+    return FSBL_APP_IMAGE_ERASED;
+  }
+
+  if (FsblAppImage_ReadLe32(&bytes[0]) != FSBL_APP_IMAGE_MAGIC)
+  {
+    return FSBL_APP_IMAGE_BAD_MAGIC;
+  }
+  if ((FsblAppImage_ReadLe16(&bytes[4]) != FSBL_APP_IMAGE_VERSION) ||
+      (FsblAppImage_ReadLe16(&bytes[6]) != FSBL_APP_IMAGE_HEADER_SIZE))
+  {
+    return FSBL_APP_IMAGE_BAD_VERSION;
+  }
+  if (FsblAppImage_Crc32Update(0U, bytes, FSBL_APP_IMAGE_HEADER_SIZE - 4U) !=
+      FsblAppImage_ReadLe32(&bytes[FSBL_APP_IMAGE_HEADER_SIZE - 4U]))
+  {
+    return FSBL_APP_IMAGE_BAD_HEADER_CRC;
+  }
+  if (FsblAppImage_ReadLe32(&bytes[8]) != expected_load)
+  {
+    return FSBL_APP_IMAGE_BAD_LOAD_ADDRESS;
+  }
+
+  /* At least the initial SP and reset vector, and never past the slot. */
+  image_size = FsblAppImage_ReadLe32(&bytes[12]);
+  if ((image_size < 8U) || (image_size > max_size))
+  {
+    return FSBL_APP_IMAGE_BAD_SIZE;
+  }
+
+  header->load_address = expected_load;
+  header->image_size = image_size;
+  header->image_crc32 = FsblAppImage_ReadLe32(&bytes[16]);
+  return FSBL_APP_IMAGE_OK;
+}
+
+uint32_t FsblAppImage_CopyWithCrc(void *dst, const void *src, size_t length)
+{
+  const size_t burst_bytes = FSBL_APP_IMAGE_BURST_WORDS * sizeof(uint32_t);
+  const uint32_t *src_words = (const uint32_t *)src;
+  uint32_t *dst_words = (uint32_t *)dst;
+  const uint8_t *src_tail = NULL;
+  uint8_t *dst_tail = NULL;
+  size_t remaining = length;
+  uint32_t crc = 0U;
+
+  /* Eight loads then eight stores per burst, so the compiler can use
+   * LDM/STM and each xSPI prefetch is consumed as a whole line. */
+  while (remaining >= burst_bytes)
+  {
+    const uint32_t w0 = src_words[0];
+    const uint32_t w1 = src_words[1];
+    const uint32_t w2 = src_words[2];
+    const uint32_t w3 = src_words[3];
+    const uint32_t w4 = src_words[4];
+    const uint32_t w5 = src_words[5];
+    const uint32_t w6 = src_words[6];
+    const uint32_t w7 = src_words[7];
+
+    dst_words[0] = w0;
+    dst_words[1] = w1;
+    dst_words[2] = w2;
+    dst_words[3] = w3;
+    dst_words[4] = w4;
+    dst_words[5] = w5;
+    dst_words[6] = w6;
+    dst_words[7] = w7;
+    crc = FsblAppImage_Crc32Update(crc, dst_words, burst_bytes);
+
+    src_words += FSBL_APP_IMAGE_BURST_WORDS;
+    dst_words += FSBL_APP_IMAGE_BURST_WORDS;
+    remaining -= burst_bytes;
+  }
+
+  src_tail = (const uint8_t *)src_words;
+  dst_tail = (uint8_t *)dst_words;
+  for (size_t i = 0U; i < remaining; i++)
+  {
+    dst_tail[i] = src_tail[i];
+  }
+  return FsblAppImage_Crc32Update(crc, dst_tail, remaining);
+}
+
+const char *FsblAppImage_StatusName(FsblAppImage_Status_t status)
+{
+  switch (status)
+  {
+    case FSBL_APP_IMAGE_OK:
+      return "ok";
+    case FSBL_APP_IMAGE_ERASED:
+      return "erased";
+    case FSBL_APP_IMAGE_BAD_MAGIC:
+      return "bad magic";
+    case FSBL_APP_IMAGE_BAD_VERSION:
+      return "bad version";
+    case FSBL_APP_IMAGE_BAD_HEADER_CRC:
+      return "bad header crc";
+    case FSBL_APP_IMAGE_BAD_LOAD_ADDRESS:
+      return "bad load address";
+    case FSBL_APP_IMAGE_BAD_SIZE:
+      return "bad size";
+    default:
+      return "unknown";
+  }
+}
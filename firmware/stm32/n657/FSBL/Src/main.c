@@ -22,6 +22,7 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "fsbl_app_image.h"
 
 /* USER CODE END Includes */
 
@@ -76,6 +77,10 @@ static void FSBL_TryBootApplication(void);
 #define FSBL_APP_FLASH_BASE   (0x70100400UL)  /* raw binary in xSPI2 flash */
 #define FSBL_APP_RAM_BASE     (0x34000400UL)  /* AXISRAM1 — matches app linker ROM origin */
 #define FSBL_APP_MAX_SIZE     (0x80000UL)     /* 512 KB copy limit (safe upper bound) */
+/* App image header (fsbl_app_image.h): its own 4 KB sector just below the
+ * signed app, so reflashing it never touches the FSBL or the STM2 header.
+ * Blank (erased) means an older flash layout: copy the whole slot. */
+#define FSBL_APP_HEADER_FLASH_ADDR (0x700FF000UL)
 
 /* Init XSPI2 and put the MX25UM51245G into OctoSPI STR memory-mapped mode.
  *
@@ -305,35 +310,87 @@ static void FSBL_TryBootApplication(void)
     return;
   }
 
+  /* Only the real image is copied when the header says how big it is. */
+  FsblAppImage_Header_t header = {0};
+  const FsblAppImage_Status_t header_status = FsblAppImage_ParseHeader(
+      (const uint8_t *)FSBL_APP_HEADER_FLASH_ADDR, FSBL_APP_IMAGE_HEADER_SIZE,
+      FSBL_APP_RAM_BASE, FSBL_APP_MAX_SIZE, &header);
+  const uint32_t copy_size = (header_status == FSBL_APP_IMAGE_OK) ?
+                             header.image_size : FSBL_APP_MAX_SIZE;
+
+  if (header_status == FSBL_APP_IMAGE_OK)
+  {
+    printf("[FSBL] App header @0x%08lX: size=%lu crc=0x%08lX\r\n",
+           (unsigned long)FSBL_APP_HEADER_FLASH_ADDR,
+           (unsigned long)header.image_size,
+           (unsigned long)header.image_crc32);
+  }
+  else
+  {
+    printf("[FSBL] App header @0x%08lX: %s, copying full %lu-byte slot\r\n",
+           (unsigned long)FSBL_APP_HEADER_FLASH_ADDR,
+           FsblAppImage_StatusName(header_status),
+           (unsigned long)FSBL_APP_MAX_SIZE);
+  }
+
   /* Vectors look sane — signal we are about to copy */
   FSBL_BlinkLED(LED_GREEN, 3, 150);  /* 3x green: starting LRUN copy */
   printf("[FSBL] Copying %lu bytes from flash 0x%08lX to RAM 0x%08lX...\r\n",
-         (unsigned long)FSBL_APP_MAX_SIZE,
+         (unsigned long)copy_size,
          (unsigned long)FSBL_APP_FLASH_BASE,
          (unsigned long)FSBL_APP_RAM_BASE);
 
-  const uint32_t *src = (const uint32_t *)FSBL_APP_FLASH_BASE;
-  uint32_t       *dst = (uint32_t *)FSBL_APP_RAM_BASE;
-  for (uint32_t i = 0; i < FSBL_APP_MAX_SIZE / 4U; i++)
+  const uint32_t copy_start_ms = HAL_GetTick();
+  uint32_t ram_crc = 0UL;
+  if (header_status == FSBL_APP_IMAGE_OK)
   {
-    dst[i] = src[i];
+    ram_crc = FsblAppImage_CopyWithCrc((void *)FSBL_APP_RAM_BASE,
+                                       (const void *)FSBL_APP_FLASH_BASE,
+                                       copy_size);
+    printf("[FSBL] Copy done in %lu ms (crc=0x%08lX). Flushing caches.\r\n",
+           (unsigned long)(HAL_GetTick() - copy_start_ms),
+           (unsigned long)ram_crc);
+  }
+  else
+  {
+    /* Nothing to check a CRC against, so skip it and copy the slot. */
+    const uint32_t *src = (const uint32_t *)FSBL_APP_FLASH_BASE;
+    uint32_t       *dst = (uint32_t *)FSBL_APP_RAM_BASE;
+    for (uint32_t i = 0; i < copy_size / 4U; i++)
+    {
+      dst[i] = src[i];
+    }
+    printf("[FSBL] Copy done in %lu ms. Flushing caches.\r\n",
+           (unsigned long)(HAL_GetTick() - copy_start_ms));
   }
-
-  printf("[FSBL] Copy done. Flushing caches.\r\n");
   SCB_CleanInvalidateDCache();
   SCB_InvalidateICache();
 
-  /* Verify: first two words in RAM should match flash */
-  const uint32_t *ram_vecs = (const uint32_t *)FSBL_APP_RAM_BASE;
-  printf("[FSBL] RAM verify   @0x%08lX: SP=%08lX  Reset=%08lX\r\n",
-         (unsigned long)FSBL_APP_RAM_BASE,
-         (unsigned long)ram_vecs[0], (unsigned long)ram_vecs[1]);
-
-  if (ram_vecs[0] != app_sp || ram_vecs[1] != app_reset)
+  if (header_status == FSBL_APP_IMAGE_OK)
   {
-    printf("[FSBL] ERROR: RAM verify mismatch — copy failed!\r\n");
-    FSBL_BlinkLED(LED_RED, 20, 50);  /* fast red: copy verify failed */
-    return;
+    /* The CRC was taken from RAM as it was written, so it covers the copy. */
+    if (ram_crc != header.image_crc32)
+    {
+      printf("[FSBL] ERROR: App CRC mismatch (expected 0x%08lX) — not booting!\r\n",
+             (unsigned long)header.image_crc32);
+      FSBL_BlinkLED(LED_RED, 20, 50);  /* fast red: copy verify failed */
+      return;
+    }
+  }
+  else
+  {
+    /* No header to check against: fall back to the vector spot check. */
+    const uint32_t *ram_vecs = (const uint32_t *)FSBL_APP_RAM_BASE;
+    printf("[FSBL] RAM verify   @0x%08lX: SP=%08lX  Reset=%08lX\r\n",
+           (unsigned long)FSBL_APP_RAM_BASE,
+           (unsigned long)ram_vecs[0], (unsigned long)ram_vecs[1]);
+
+    if (ram_vecs[0] != app_sp || ram_vecs[1] != app_reset)
+    {
+      printf("[FSBL] ERROR: RAM verify mismatch — copy failed!\r\n");
+      FSBL_BlinkLED(LED_RED, 20, 50);  /* fast red: copy verify failed */
+      return;
+    }
   }
 
   FSBL_BlinkLED(LED_GREEN, 1, 500);  /* 1x long green: jumping now */
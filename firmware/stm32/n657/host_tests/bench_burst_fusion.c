@@ -0,0 +1,99 @@
+/*==============================================================================
+ * File: bench_burst_fusion.c
+ *
+ * Purpose:
+ *   Host timing run for the burst fusion kernel at the live 224x224 size.
+ *
+ * Approach:
+ *   - Build a three-frame burst with small known offsets, then time shift
+ *     estimation plus median and mean fusion over a fixed number of passes.
+ *   - Host numbers only rank changes to the kernel; the on-target figure is
+ *     the [CAMERA][CAPTURE][TIMING] burst-fuse log line.
+ *==============================================================================*/
+
+#include "app_burst_fusion.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_WIDTH       224U
+#define BENCH_HEIGHT      224U
+#define BENCH_FRAMES      3U
+#define BENCH_MAX_SHIFT   6U
+#define BENCH_ITERATIONS  20U
+
+static uint8_t bench_frames[BENCH_FRAMES][BENCH_WIDTH * BENCH_HEIGHT * 2U];
+static uint8_t bench_output[BENCH_WIDTH * BENCH_HEIGHT * 2U];
+
+/*==============================================================================
+ * Function: Bench_BuildBurst
+ *
+ * Purpose:
+ *   Fill each frame with the same smooth pattern moved by a couple of pixels.
+ *==============================================================================*/
+static void Bench_BuildBurst(AppFrameFormat_t format) {
+	const size_t bpp = AppFrameFormat_BytesPerPixel(format);
+
+	for (size_t k = 0U; k < BENCH_FRAMES; k++) {
+		for (size_t y = 0U; y < BENCH_HEIGHT; y++) {
+			for (size_t x = 0U; x < BENCH_WIDTH; x++) {
+				const size_t sx = x + (k * 2U);
+				const size_t sy = y + k;
+				uint8_t *const pixel =
+						&bench_frames[k][((y * BENCH_WIDTH) + x) * bpp];
+
+				pixel[0] = (uint8_t) (((sx * 37U) ^ (sy * 91U)) & 0xFFU);
+				if (bpp == 2U) {
+					pixel[1] = 128U;
+				}
+			}
+		}
+	}
+}
+
+/*==============================================================================
+ * Function: Bench_Run
+ *
+ * Purpose:
+ *   Time one full align-and-merge pass and print the per-pass cost.
+ *==============================================================================*/
+static void Bench_Run(AppFrameFormat_t format, AppBurstFusion_Method_t method,
+		const char *label) {
+	const uint8_t *frames[BENCH_FRAMES];
+	AppBurstFusion_Shift_t shifts[BENCH_FRAMES] = { { 0, 0 } };
+	clock_t start = 0;
+	clock_t end = 0;
+
+	Bench_BuildBurst(format);
+	for (size_t k = 0U; k < BENCH_FRAMES; k++) {
+		frames[k] = bench_frames[k];
+	}
+
+	start = clock();
+	for (uint32_t i = 0U; i < BENCH_ITERATIONS; i++) {
+		for (size_t k = 1U; k < BENCH_FRAMES; k++) {
+			(void) AppBurstFusion_EstimateShift(bench_frames[0], bench_frames[k],
+					format, BENCH_WIDTH, BENCH_HEIGHT, BENCH_MAX_SHIFT,
+					&shifts[k]);
+		}
+		(void) AppBurstFusion_Fuse(frames, shifts, BENCH_FRAMES, format,
+				BENCH_WIDTH, BENCH_HEIGHT, method, bench_output);
+	}
+	end = clock();
+
+	printf("%-14s %3u frames  %8.1f us/burst  (shift k=1: %d,%d)\n", label,
+			(unsigned) BENCH_FRAMES,
+			((double) (end - start) * 1.0e6)
+					/ ((double) CLOCKS_PER_SEC * BENCH_ITERATIONS),
+			(int) shifts[1].dx, (int) shifts[1].dy);
+}
+
+int main(void) {
+	Bench_Run(APP_FRAME_FORMAT_Y8, APP_BURST_FUSION_MEDIAN, "y8 median");
+	Bench_Run(APP_FRAME_FORMAT_Y8, APP_BURST_FUSION_MEAN, "y8 mean");
+	Bench_Run(APP_FRAME_FORMAT_YUV422, APP_BURST_FUSION_MEDIAN,
+			"yuv422 median");
+	Bench_Run(APP_FRAME_FORMAT_YUV422, APP_BURST_FUSION_MEAN, "yuv422 mean");
+	return 0;
+}
@@ -0,0 +1,300 @@
+/*==============================================================================
+ * File: bench_frame_ingest.c
+ *
+ * Purpose:
+ *   Host timing run for the one-pass frame ingest against the separate
+ *   full-frame passes it replaces, at the live 224x224 capture size.
+ *
+ * Approach:
+ *   - Frames come from recorded captures passed on the command line (raw
+ *     .yuv422 or .y8 files as saved to captured_images), or from a synthetic
+ *     gauge-like frame when none are given.
+ *   - The separate side repeats what each consumer used to do on its own:
+ *     the non-zero byte count, the YUV422 chroma summary, the AI frame
+ *     signature and the baseline training-crop brightness profile.
+ *   - Both sides must agree on every shared figure before timing counts.
+ *   - Also reported: the frame loads each side issues. The capture buffer
+ *     is noncacheable on target, so every load is a bus read there, while
+ *     the host serves repeat passes from cache and understates the saving.
+ *   - Host numbers only rank changes to the kernel; the on-target figure is
+ *     the [CAMERA][CAPTURE] frame-ready step timing.
+ *
+ * Usage:
+ *   frame_ingest_bench [frame.yuv422 ...]
+ *==============================================================================*/
+
+#include "app_frame_format.h"
+#include "app_frame_ingest.h"
+#include "app_gauge_geometry.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_WIDTH       224U
+#define BENCH_HEIGHT      224U
+#define BENCH_MAX_BYTES   (BENCH_WIDTH * BENCH_HEIGHT * 2U)
+#define BENCH_ITERATIONS  200U
+
+static uint8_t bench_frame[BENCH_MAX_BYTES];
+static AppFrameIngest_Descriptor_t bench_descriptor;
+
+/*==============================================================================
+ * Type: Bench_Separate
+ *
+ * Purpose:
+ *   Results of the per-consumer passes, kept so the compiler cannot drop
+ *   them and so they can be checked against the descriptor.
+ *==============================================================================*/
+typedef struct {
+	uint32_t nonzero_bytes;
+	uint64_t sum_y;
+	uint64_t sum_u;
+	uint64_t sum_v;
+	uint32_t pair_count;
+	uint8_t min_y;
+	uint8_t max_y;
+	uint8_t min_u;
+	uint8_t max_u;
+	uint8_t min_v;
+	uint8_t max_v;
+	uint32_t signature;
+	uint64_t crop_luma_sum;
+	uint32_t crop_sample_count;
+	uint32_t crop_bright_count;
+} Bench_Separate;
+
+/*==============================================================================
+ * Function: Bench_LoadFrame
+ *
+ * Purpose:
+ *   Read one recorded capture; its size decides YUV422 or Y8.
+ *
+ * Returns:
+ *   Frame length in bytes, or 0 when the file is missing or the wrong size.
+ *==============================================================================*/
+static size_t Bench_LoadFrame(const char *path) {
+	FILE *file = fopen(path, "rb");
+	size_t length = 0U;
+
+	if (file == NULL) {
+		return 0U;
+	}
+	length = fread(bench_frame, 1U, sizeof(bench_frame), file);
+	(void) fclose(file);
+	if ((length != BENCH_MAX_BYTES) && (length != (BENCH_WIDTH * BENCH_HEIGHT))) {
+		return 0U;
+	}
+	return length;
+}
+
+/*==============================================================================
+ * Function: Bench_BuildSyntheticFrame
+ *
+ * Purpose:
+ *   A dark face with a bright ring and a needle, near-neutral chroma.
+ *==============================================================================*/
+static size_t Bench_BuildSyntheticFrame(void) {
+	for (size_t y = 0U; y < BENCH_HEIGHT; y++) {
+		for (size_t x = 0U; x < BENCH_WIDTH; x++) {
+			const long dx = (long) x - 112L;
+			const long dy = (long) y - 112L;
+			const long r2 = (dx * dx) + (dy * dy);
+			uint8_t *const pixel = &bench_frame[((y * BENCH_WIDTH) + x) * 2U];
+			uint8_t luma = (uint8_t) (60U + ((x * 3U + y * 5U) & 0x1FU));
+
+			if ((r2 > 80L * 80L) && (r2 < 90L * 90L)) {
+				luma = 220U;
+			} else if ((dx > 0) && (dy > -3L) && (dy < 3L) && (dx < 70L)) {
+				luma = 20U;
+			}
+			pixel[0] = luma;
+			pixel[1] = (uint8_t) (((x & 1U) == 0U) ? 126U : 131U);
+		}
+	}
+	return BENCH_MAX_BYTES;
+}
+
+/*==============================================================================
+ * Function: Bench_IngestConfig
+ *
+ * Purpose:
+ *   The config the capture path uses: training crop, step 2, bright 180.
+ *==============================================================================*/
+static AppFrameIngest_Config_t Bench_IngestConfig(void) {
+	const AppGaugeGeometry_Crop_t crop = AppGaugeGeometry_TrainingCrop(
+			BENCH_WIDTH, BENCH_HEIGHT);
+	AppFrameIngest_Config_t config;
+
+	config.crop_x_min = (uint32_t) crop.x_min;
+	config.crop_y_min = (uint32_t) crop.y_min;
+	config.crop_x_end = (uint32_t) (crop.x_min + crop.width);
+	config.crop_y_end = (uint32_t) (crop.y_min + crop.height);
+	config.crop_step = 2U;
+	config.crop_bright_level = 180U;
+	return config;
+}
+
+/*==============================================================================
+ * Function: Bench_RunSeparate
+ *
+ * Purpose:
+ *   The four full passes the consumers made before the ingest descriptor.
+ *==============================================================================*/
+static void Bench_RunSeparate(size_t length, AppFrameFormat_t format,
+		const AppFrameIngest_Config_t *config, Bench_Separate *out) {
+	uint32_t hash = 2166136261UL;
+
+	*out = (Bench_Separate) { 0U };
+
+	/* Capture acceptance: non-zero bytes. */
+	for (size_t index = 0U; index < length; index++) {
+		out->nonzero_bytes += (bench_frame[index] != 0U) ? 1U : 0U;
+	}
+
+	/* Chroma summary. */
+	if (format == APP_FRAME_FORMAT_YUV422) {
+		out->min_y = 0xFFU;
+		out->min_u = 0xFFU;
+		out->min_v = 0xFFU;
+		for (size_t index = 0U; (index + 3U) < length; index += 4U) {
+			const uint8_t y0 = bench_frame[index];
+			const uint8_t u = bench_frame[index + 1U];
+			const uint8_t y1 = bench_frame[index + 2U];
+			const uint8_t v = bench_frame[index + 3U];
+
+			out->min_y = (y0 < out->min_y) ? y0 : out->min_y;
+			out->min_y = (y1 < out->min_y) ? y1 : out->min_y;
+			out->max_y = (y0 > out->max_y) ? y0 : out->max_y;
+			out->max_y = (y1 > out->max_y) ? y1 : out->max_y;
+			out->min_u = (u < out->min_u) ? u : out->min_u;
+			out->max_u = (u > out->max_u) ? u : out->max_u;
+			out->min_v = (v < out->min_v) ? v : out->min_v;
+			out->max_v = (v > out->max_v) ? v : out->max_v;
+			out->sum_y += (uint64_t) y0 + y1;
+			out->sum_u += u;
+			out->sum_v += v;
+			out->pair_count++;
+		}
+	}
+
+	/* AI frame signature. */
+	for (size_t index = 0U; index < length; index++) {
+		hash ^= bench_frame[index];
+		hash *= 16777619UL;
+	}
+	out->signature = hash;
+
+	/* Baseline brightness profile. */
+	for (size_t y = config->crop_y_min; y < config->crop_y_end;
+			y += config->crop_step) {
+		for (size_t x = config->crop_x_min; x < config->crop_x_end;
+				x += config->crop_step) {
+			const uint8_t luma = bench_frame[AppFrameFormat_LumaOffset(format,
+					BENCH_WIDTH, x, y)];
+
+			out->crop_luma_sum += luma;
+			out->crop_sample_count++;
+			out->crop_bright_count += (luma >= config->crop_bright_level) ?
+					1U : 0U;
+		}
+	}
+}
+
+/*==============================================================================
+ * Function: Bench_Agrees
+ *
+ * Purpose:
+ *   Check the descriptor reports what the separate passes computed.
+ *==============================================================================*/
+static bool Bench_Agrees(const Bench_Separate *separate,
+		const AppFrameIngest_Descriptor_t *d, AppFrameFormat_t format) {
+	bool agrees = (separate->nonzero_bytes == d->nonzero_bytes)
+			&& (separate->crop_luma_sum == d->crop_luma_sum)
+			&& (separate->crop_sample_count == d->crop_sample_count)
+			&& (separate->crop_bright_count == d->crop_bright_count);
+
+	if (format == APP_FRAME_FORMAT_YUV422) {
+		agrees = agrees && (separate->sum_y == d->luma_sum)
+				&& (separate->sum_u == d->u_sum)
+				&& (separate->sum_v == d->v_sum)
+				&& (separate->pair_count == d->chroma_pair_count)
+				&& (separate->min_y == d->min_y) && (separate->max_y == d->max_y)
+				&& (separate->min_u == d->min_u) && (separate->max_u == d->max_u)
+				&& (separate->min_v == d->min_v) && (separate->max_v == d->max_v);
+	}
+	return agrees;
+}
+
+/*==============================================================================
+ * Function: Bench_Frame
+ *
+ * Purpose:
+ *   Time both sides on the loaded frame and print the per-frame cost.
+ *==============================================================================*/
+static bool Bench_Frame(const char *label, size_t length) {
+	const AppFrameIngest_Config_t config = Bench_IngestConfig();
+	AppFrameFormat_t format = APP_FRAME_FORMAT_YUV422;
+	Bench_Separate separate;
+	clock_t start = 0;
+	double separate_us = 0.0;
+	double fused_us = 0.0;
+	size_t separate_loads = 0U;
+	size_t fused_loads = 0U;
+
+	if (!AppFrameFormat_FromLength(BENCH_WIDTH, BENCH_HEIGHT, length, &format)) {
+		return false;
+	}
+
+	start = clock();
+	for (uint32_t i = 0U; i < BENCH_ITERATIONS; i++) {
+		Bench_RunSeparate(length, format, &config, &separate);
+	}
+	separate_us = ((double) (clock() - start) * 1.0e6)
+			/ ((double) CLOCKS_PER_SEC * BENCH_ITERATIONS);
+
+	start = clock();
+	for (uint32_t i = 0U; i < BENCH_ITERATIONS; i++) {
+		(void) AppFrameIngest_Run(bench_frame, length, BENCH_WIDTH,
+				BENCH_HEIGHT, &config, &bench_descriptor);
+	}
+	fused_us = ((double) (clock() - start) * 1.0e6)
+			/ ((double) CLOCKS_PER_SEC * BENCH_ITERATIONS);
+
+	if (!Bench_Agrees(&separate, &bench_descriptor, format)) {
+		printf("%-24s descriptor disagrees with the separate passes\n", label);
+		return false;
+	}
+	/* Byte loads per pass before; one word load per four bytes now, plus
+	 * the crop samples on both sides. */
+	separate_loads = ((format == APP_FRAME_FORMAT_YUV422) ? 3U : 2U) * length
+			+ separate.crop_sample_count;
+	fused_loads = (length / 4U) + bench_descriptor.crop_sample_count;
+	printf("%-24s %-6s separate %8.1f us %7lu loads  fused %8.1f us %7lu loads  (hash=%016llx)\n",
+			label, (format == APP_FRAME_FORMAT_YUV422) ? "yuv422" : "y8",
+			separate_us, (unsigned long) separate_loads, fused_us,
+			(unsigned long) fused_loads,
+			(unsigned long long) bench_descriptor.content_hash);
+	return true;
+}
+
+int main(int argc, char **argv) {
+	bool ok = true;
+
+	if (argc < 2) {
+		ok = Bench_Frame("synthetic", Bench_BuildSyntheticFrame());
+		return ok ? 0 : 1;
+	}
+	for (int arg = 1; arg < argc; arg++) {
+		const size_t length = Bench_LoadFrame(argv[arg]);
+
+		if (length == 0U) {
+			printf("%-24s skipped: missing or not a %ux%u frame\n", argv[arg],
+					(unsigned) BENCH_WIDTH, (unsigned) BENCH_HEIGHT);
+			continue;
+		}
+		ok = Bench_Frame(argv[arg], length) && ok;
+	}
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,473 @@
+/*==============================================================================
+ * File: bench_sd_format.c
+ *
+ * Purpose:
+ *   Host comparison of the AU-aligned FAT32 layout against FileX's default
+ *   format, running the real FileX library over a RAM-disk card image.
+ *
+ * Approach:
+ *   - An 8 GiB card with an 8192-sector partition and a 4 MiB AU, stored
+ *     sparsely so only written sectors take memory.
+ *   - Three volumes: fx_media_format with 32 KiB clusters, the same with the
+ *     per-file AU alignment the writers use, and SdFatFormat with it.
+ *   - Each volume takes the capture workload the firmware produces: one
+ *     100,352-byte frame per minute in a per-day folder, a CSV row per frame
+ *     and a media flush every two minutes.
+ *   - Reported per capture: clusters and fragments in the frame's chain,
+ *     frames straddling an AU, driver write requests, FAT sector writes and
+ *     a modelled card write time. The model charges a command cost, a
+ *     per-sector cost, a stall for a request that crosses an AU and a
+ *     smaller one for touching an AU outside the card's two open ones.
+ *     It ranks layouts; the on-target figure is the
+ *     [FILEX][CAPTURE][TIMING] fallback-write log line.
+ *
+ * Usage:
+ *   sd_format_bench [captures]   (default 2880, two days)
+ *==============================================================================*/
+
+#include "fx_api.h"
+#include "fx_utility.h"
+#include "sd_card_profile.h"
+#include "sd_fat_format.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_CARD_SECTORS        16777216UL
+#define BENCH_PARTITION_START     8192UL
+#define BENCH_AU_SECTORS          8192UL
+#define BENCH_WRITE_ALIGN_SECTORS 256UL /* APP_FILEX_SD_MAX_ALIGN_SECTORS */
+#define BENCH_CHUNK_SECTORS       128UL
+#define BENCH_CAPTURE_BYTES       100352UL
+#define BENCH_CACHE_SECTORS       4U    /* FILEX_MEDIA_CACHE_SECTORS */
+#define BENCH_COMMAND_US          300UL
+#define BENCH_SECTOR_US           40UL
+#define BENCH_AU_CROSS_US         20000UL
+#define BENCH_AU_SWITCH_US        3000UL
+
+/*==============================================================================
+ * Type: Bench_Card
+ *
+ * Purpose:
+ *   Sparse RAM-disk card plus the write statistics of the current volume.
+ *==============================================================================*/
+typedef struct {
+	uint8_t *chunks[BENCH_CARD_SECTORS / BENCH_CHUNK_SECTORS];
+	uint32_t partition_start;
+	uint32_t open_au[2];
+	uint64_t write_requests;
+	uint64_t fat_sector_writes;
+	uint64_t modelled_us;
+	FX_MEDIA *media_ptr;
+} Bench_Card;
+
+/*==============================================================================
+ * Type: Bench_Result
+ *==============================================================================*/
+typedef struct {
+	const char *name;
+	uint32_t sectors_per_cluster;
+	uint32_t data_start_lba;
+	uint32_t captures;
+	uint64_t clusters;
+	uint64_t fragments;
+	uint32_t au_straddles;
+	uint64_t write_requests;
+	uint64_t fat_sector_writes;
+	uint64_t modelled_us;
+} Bench_Result;
+
+static Bench_Card bench_card;
+static FX_MEDIA bench_media;
+static UCHAR bench_media_cache[BENCH_CACHE_SECTORS * 512U];
+static UCHAR bench_frame[BENCH_CAPTURE_BYTES];
+
+/*==============================================================================
+ * Function: Bench_Sector
+ *
+ * Purpose:
+ *   Address of a card sector, allocating its chunk on first write. Unwritten
+ *   sectors read as zero.
+ *==============================================================================*/
+static uint8_t *Bench_Sector(uint32_t lba, int for_write) {
+	static uint8_t zero_sector[512];
+	uint8_t **chunk = &bench_card.chunks[lba / BENCH_CHUNK_SECTORS];
+
+	if (*chunk == NULL) {
+		if (!for_write) {
+			(void) memset(zero_sector, 0, sizeof(zero_sector));
+			return zero_sector;
+		}
+		*chunk = calloc(BENCH_CHUNK_SECTORS, 512U);
+		if (*chunk == NULL) {
+			fprintf(stderr, "out of memory\n");
+			exit(1);
+		}
+	}
+	return *chunk + ((lba % BENCH_CHUNK_SECTORS) * 512U);
+}
+
+/*==============================================================================
+ * Function: Bench_ChargeWrite
+ *
+ * Purpose:
+ *   Count one write request and add its modelled card time.
+ *==============================================================================*/
+static void Bench_ChargeWrite(uint32_t lba, uint32_t count) {
+	const uint32_t first_au = lba / BENCH_AU_SECTORS;
+	const uint32_t last_au = (lba + count - 1U) / BENCH_AU_SECTORS;
+	uint64_t cost_us = BENCH_COMMAND_US + ((uint64_t) BENCH_SECTOR_US * count);
+
+	if (first_au != last_au) {
+		cost_us += BENCH_AU_CROSS_US;
+	}
+	for (uint32_t au = first_au; au <= last_au; au++) {
+		if (au == bench_card.open_au[0]) {
+			continue;
+		}
+		if (au != bench_card.open_au[1]) {
+			cost_us += BENCH_AU_SWITCH_US;
+		}
+		bench_card.open_au[1] = bench_card.open_au[0];
+		bench_card.open_au[0] = au;
+	}
+
+	bench_card.write_requests++;
+	bench_card.modelled_us += cost_us;
+}
+
+/*==============================================================================
+ * Function: Bench_RamDiskDriver
+ *
+ * Purpose:
+ *   FileX media driver over the sparse card; logical sectors are partition
+ *   relative, as in SPI_FileX_SdSpiMediaDriver.
+ *==============================================================================*/
+static VOID Bench_RamDiskDriver(FX_MEDIA *media_ptr) {
+	const uint32_t lba = bench_card.partition_start
+			+ (uint32_t) media_ptr->fx_media_driver_logical_sector;
+	const uint32_t count = (uint32_t) media_ptr->fx_media_driver_sectors;
+	UCHAR *buffer = (UCHAR*) media_ptr->fx_media_driver_buffer;
+
+	media_ptr->fx_media_driver_status = FX_SUCCESS;
+	switch (media_ptr->fx_media_driver_request) {
+	case FX_DRIVER_READ:
+		for (uint32_t i = 0U; i < count; i++) {
+			(void) memcpy(&buffer[i * 512U], Bench_Sector(lba + i, 0), 512U);
+		}
+		break;
+	case FX_DRIVER_BOOT_READ:
+		(void) memcpy(buffer, Bench_Sector(bench_card.partition_start, 0),
+				512U);
+		break;
+	case FX_DRIVER_WRITE: {
+		const ULONG fat_start = media_ptr->fx_media_reserved_sectors;
+		const ULONG fat_end = fat_start
+				+ (media_ptr->fx_media_number_of_FATs
+						* media_ptr->fx_media_sectors_per_FAT);
+
+		for (uint32_t i = 0U; i < count; i++) {
+			const ULONG logical = media_ptr->fx_media_driver_logical_sector + i;
+
+			(void) memcpy(Bench_Sector(lba + i, 1), &buffer[i * 512U], 512U);
+			if ((logical >= fat_start) && (logical < fat_end)) {
+				bench_card.fat_sector_writes++;
+			}
+		}
+		Bench_ChargeWrite(lba, count);
+		break;
+	}
+	case FX_DRIVER_BOOT_WRITE:
+		(void) memcpy(Bench_Sector(bench_card.partition_start, 1), buffer,
+				512U);
+		Bench_ChargeWrite(bench_card.partition_start, 1U);
+		break;
+	default:
+		break; /* Init, flush, abort, release and uninit need nothing. */
+	}
+}
+
+/*==============================================================================
+ * Function: Bench_FormatterWrite
+ *==============================================================================*/
+static int32_t Bench_FormatterWrite(void *write_context, uint32_t sector,
+		const uint8_t data[SD_FAT_FORMAT_SECTOR_BYTES]) {
+	(void) write_context;
+	(void) memcpy(Bench_Sector(bench_card.partition_start + sector, 1), data,
+			512U);
+	return 0;
+}
+
+/*==============================================================================
+ * Function: Bench_ResetCard
+ *==============================================================================*/
+static void Bench_ResetCard(void) {
+	for (size_t i = 0U; i < (BENCH_CARD_SECTORS / BENCH_CHUNK_SECTORS); i++) {
+		free(bench_card.chunks[i]);
+		bench_card.chunks[i] = NULL;
+	}
+	(void) memset(&bench_card, 0, sizeof(bench_card));
+	bench_card.partition_start = BENCH_PARTITION_START;
+	bench_card.open_au[0] = UINT32_MAX;
+	bench_card.open_au[1] = UINT32_MAX;
+}
+
+/*==============================================================================
+ * Function: Bench_WalkChain
+ *
+ * Purpose:
+ *   Count clusters and fragments of a file's chain and whether its data
+ *   straddles an AU.
+ *==============================================================================*/
+static void Bench_WalkChain(ULONG first_cluster, Bench_Result *result_ptr) {
+	const ULONG spc = bench_media.fx_media_sectors_per_cluster;
+	const ULONG first_lba = BENCH_PARTITION_START
+			+ bench_media.fx_media_data_sector_start;
+	ULONG cluster = first_cluster;
+	ULONG first_au = (first_lba + ((first_cluster - 2U) * spc))
+			/ BENCH_AU_SECTORS;
+	int straddles = 0;
+
+	result_ptr->fragments++;
+	while ((cluster >= 2U)
+			&& (cluster < (bench_media.fx_media_total_clusters + 2U))) {
+		const ULONG cluster_lba = first_lba + ((cluster - 2U) * spc);
+		ULONG next = 0U;
+
+		result_ptr->clusters++;
+		if (((cluster_lba / BENCH_AU_SECTORS) != first_au)
+				|| (((cluster_lba + spc - 1U) / BENCH_AU_SECTORS) != first_au)) {
+			straddles = 1;
+		}
+		if (_fx_utility_FAT_entry_read(&bench_media, cluster, &next)
+				!= FX_SUCCESS) {
+			break;
+		}
+		if ((next >= 2U) && (next != (cluster + 1U))
+				&& (next < (bench_media.fx_media_total_clusters + 2U))) {
+			result_ptr->fragments++;
+		}
+		cluster = next;
+	}
+	if (straddles) {
+		result_ptr->au_straddles++;
+	}
+}
+
+/*==============================================================================
+ * Function: Bench_RunWorkload
+ *
+ * Purpose:
+ *   Replay the firmware's capture and CSV writes on the open volume.
+ *==============================================================================*/
+static int Bench_RunWorkload(uint32_t captures, int align_files,
+		Bench_Result *result_ptr) {
+	const uint64_t requests_before = bench_card.write_requests;
+	const uint64_t fat_before = bench_card.fat_sector_writes;
+	const uint64_t us_before = bench_card.modelled_us;
+
+	(void) fx_directory_create(&bench_media, "captured_images");
+	(void) fx_directory_create(&bench_media, "inference");
+
+	for (uint32_t capture = 0U; capture < captures; capture++) {
+		const uint32_t day = 1U + (capture / 1440U);
+		const uint32_t minute = capture % 1440U;
+		CHAR date[16];
+		CHAR name[40];
+		CHAR row[48];
+		FX_FILE file;
+		UINT status;
+
+		(void) snprintf(date, sizeof(date), "2026-07-%02u", (unsigned) day);
+		(void) snprintf(name, sizeof(name), "capture_%02u-%02u-00.yuv422",
+				(unsigned) (minute / 60U), (unsigned) (minute % 60U));
+
+		/* AppFileX_WriteCapturedImage, fallback path. */
+		(void) fx_directory_default_set(&bench_media, "captured_images");
+		(void) fx_directory_create(&bench_media, date);
+		(void) fx_directory_default_set(&bench_media, date);
+		(void) fx_file_create(&bench_media, name);
+		status = fx_file_open(&bench_media, &file, name, FX_OPEN_FOR_WRITE);
+		if (status != FX_SUCCESS) {
+			fprintf(stderr, "%s: open %s failed %u\n", result_ptr->name, name,
+					status);
+			return -1;
+		}
+		if (align_files) {
+			bench_media.fx_media_cluster_search_start =
+					SdCardProfile_NextAlignedCluster(
+							BENCH_PARTITION_START
+									+ bench_media.fx_media_data_sector_start,
+							bench_media.fx_media_sectors_per_cluster,
+							bench_media.fx_media_total_clusters,
+							bench_media.fx_media_cluster_search_start,
+							BENCH_WRITE_ALIGN_SECTORS);
+		}
+		status = fx_file_write(&file, bench_frame, BENCH_CAPTURE_BYTES);
+		if (status != FX_SUCCESS) {
+			fprintf(stderr, "%s: write %s failed %u\n", result_ptr->name, name,
+					status);
+			return -1;
+		}
+		Bench_WalkChain(file.fx_file_first_physical_cluster, result_ptr);
+		(void) fx_file_close(&file);
+		(void) fx_directory_default_set(&bench_media, FX_NULL);
+
+		/* Inference CSV row. */
+		(void) snprintf(name, sizeof(name), "inference/%s.csv", date);
+		status = fx_file_open(&bench_media, &file, name, FX_OPEN_FOR_WRITE);
+		if (status == FX_NOT_FOUND) {
+			(void) fx_file_create(&bench_media, name);
+			status = fx_file_open(&bench_media, &file, name,
+					FX_OPEN_FOR_WRITE);
+		}
+		if (status == FX_SUCCESS) {
+			const int length = snprintf(row, sizeof(row),
+					"%s %02u:%02u:00,21.37\n", date,
+					(unsigned) (minute / 60U), (unsigned) (minute % 60U));
+
+			(void) fx_file_seek(&file, file.fx_file_current_file_size);
+			(void) fx_file_write(&file, row, (ULONG) length);
+			(void) fx_file_close(&file);
+		}
+
+		if ((capture % 2U) == 1U) {
+			(void) fx_media_flush(&bench_media);
+		}
+	}
+	(void) fx_media_flush(&bench_media);
+
+	result_ptr->captures = captures;
+	result_ptr->sectors_per_cluster = bench_media.fx_media_sectors_per_cluster;
+	result_ptr->data_start_lba = (uint32_t) (BENCH_PARTITION_START
+			+ bench_media.fx_media_data_sector_start);
+	result_ptr->write_requests = bench_card.write_requests - requests_before;
+	result_ptr->fat_sector_writes = bench_card.fat_sector_writes - fat_before;
+	result_ptr->modelled_us = bench_card.modelled_us - us_before;
+	return 0;
+}
+
+/*==============================================================================
+ * Function: Bench_OpenMedia
+ *==============================================================================*/
+static int Bench_OpenMedia(void) {
+	const UINT status = fx_media_open(&bench_media, "BENCH",
+			Bench_RamDiskDriver, NULL, bench_media_cache,
+			sizeof(bench_media_cache));
+
+	if (status != FX_SUCCESS) {
+		fprintf(stderr, "media open failed %u\n", status);
+		return -1;
+	}
+	return 0;
+}
+
+/*==============================================================================
+ * Function: Bench_RunDefault
+ *==============================================================================*/
+static int Bench_RunDefault(uint32_t captures, int align_files,
+		Bench_Result *result_ptr) {
+	UINT status;
+
+	Bench_ResetCard();
+	status = fx_media_format(&bench_media, Bench_RamDiskDriver, NULL,
+			bench_media_cache, sizeof(bench_media_cache), "DEFAULT", 2U, 32U,
+			BENCH_PARTITION_START, BENCH_CARD_SECTORS - BENCH_PARTITION_START,
+			512U, 64U, 255U, 63U);
+	if (status != FX_SUCCESS) {
+		fprintf(stderr, "fx_media_format failed %u\n", status);
+		return -1;
+	}
+	if (Bench_OpenMedia() != 0) {
+		return -1;
+	}
+	status = (UINT) Bench_RunWorkload(captures, align_files, result_ptr);
+	(void) fx_media_close(&bench_media);
+	return (int) status;
+}
+
+/*==============================================================================
+ * Function: Bench_RunTuned
+ *==============================================================================*/
+static int Bench_RunTuned(uint32_t captures, Bench_Result *result_ptr) {
+	const SdFatFormat_Directory directories[2] = { { "captured_images", 2U }, {
+			"inference", 1U } };
+	SdFatFormat_Config config;
+	SdFatFormat_Layout layout;
+	int status;
+
+	Bench_ResetCard();
+	config.partition_start_lba = BENCH_PARTITION_START;
+	config.partition_sectors = BENCH_CARD_SECTORS - BENCH_PARTITION_START;
+	config.align_sectors = BENCH_AU_SECTORS;
+	config.file_bytes = BENCH_CAPTURE_BYTES;
+	config.max_slack_percent = 35U;
+	if ((SdFatFormat_PlanLayout(&config, &layout) != 0)
+			|| (SdFatFormat_Write(&layout, directories, 2U, 0x20260701UL,
+					0x5CE10000UL, Bench_FormatterWrite, NULL) != 0)) {
+		fprintf(stderr, "SdFatFormat failed\n");
+		return -1;
+	}
+	if (Bench_OpenMedia() != 0) {
+		return -1;
+	}
+	status = Bench_RunWorkload(captures, 1, result_ptr);
+	(void) fx_media_close(&bench_media);
+	return status;
+}
+
+/*==============================================================================
+ * Function: Bench_Print
+ *==============================================================================*/
+static void Bench_Print(const Bench_Result *r) {
+	const double n = (double) r->captures;
+
+	printf("%-22s %4lu KiB  data@%-6lu %6.2f %6.2f %6.1f%% %7.2f %7.2f %8.2f\n",
+			r->name, (unsigned long) (r->sectors_per_cluster / 2U),
+			(unsigned long) (r->data_start_lba % BENCH_AU_SECTORS),
+			(double) r->clusters / n, (double) r->fragments / n,
+			(100.0 * (double) r->au_straddles) / n,
+			(double) r->write_requests / n, (double) r->fat_sector_writes / n,
+			((double) r->modelled_us / n) / 1000.0);
+}
+
+int main(int argc, char **argv) {
+	uint32_t captures = 2880U;
+	Bench_Result results[3];
+
+	if (argc > 1) {
+		captures = (uint32_t) strtoul(argv[1], NULL, 10);
+	}
+	if (captures == 0U) {
+		captures = 1U;
+	}
+	for (size_t i = 0U; i < sizeof(bench_frame); i++) {
+		bench_frame[i] = (UCHAR) (i * 31U);
+	}
+
+	(void) memset(results, 0, sizeof(results));
+	results[0].name = "fx_media_format";
+	results[1].name = "fx_media_format+align";
+	results[2].name = "SdFatFormat+align";
+
+	fx_system_initialize();
+	if ((Bench_RunDefault(captures, 0, &results[0]) != 0)
+			|| (Bench_RunDefault(captures, 1, &results[1]) != 0)
+			|| (Bench_RunTuned(captures, &results[2]) != 0)) {
+		return 1;
+	}
+	Bench_ResetCard();
+
+	printf("%u captures of %lu bytes, AU %lu sectors (per capture below)\n",
+			(unsigned) captures, (unsigned long) BENCH_CAPTURE_BYTES,
+			(unsigned long) BENCH_AU_SECTORS);
+	printf("%-22s %8s  %-11s %6s %6s %7s %7s %7s %8s\n", "layout", "cluster",
+			"data%AU", "chain", "frags", "AU-str", "writes", "FATwr",
+			"model-ms");
+	for (size_t i = 0U; i < 3U; i++) {
+		Bench_Print(&results[i]);
+	}
+	return 0;
+}
@@ -0,0 +1,111 @@
+/*==============================================================================
+ * File: test_activation_overlay.c
+ *
+ * Purpose:
+ *   Unity unit tests for the AppActivationOverlay arena plan checks.
+ *
+ * Approach:
+ *   - Build small plans by hand: sequential stages sharing offset 0, two
+ *     stages live at the same step, and a region past the arena end.
+ *   - Feed buffer addresses the way the firmware walks the generated
+ *     buffer tables and check the extent against the planned region.
+ *==============================================================================*/
+
+#include "unity.h"
+#include "app_activation_overlay.h"
+
+#include <stdint.h>
+
+#define TEST_ARENA_BASE  0x34100000U
+#define TEST_ARENA_SIZE  0x002C0000U
+
+/*==============================================================================
+ * Test: test_ActivationOverlay_SequentialStages_MayShareBytes
+ *
+ * Expected:
+ *   Stages at different steps may overlay each other; a stage kept live into
+ *   the next step must not share bytes with it; a region past the arena end
+ *   is rejected and reported by index.
+ *==============================================================================*/
+void test_ActivationOverlay_SequentialStages_MayShareBytes(void) {
+	AppActivationOverlay_Region_t regions[3] = {
+		{ "obb", 0x00000000U, 0x00200000U, 0U, 0U },
+		{ "heatmap_cd", 0x00000000U, 0x00080000U, 1U, 1U },
+		{ "tip_focus", 0x00000000U, 0x00100000U, 2U, 2U },
+	};
+	uint32_t first = 0U;
+	uint32_t second = 0U;
+
+	TEST_ASSERT_EQUAL_INT(APP_ACTIVATION_OVERLAY_OK,
+			AppActivationOverlay_CheckPlan(regions, 3U, TEST_ARENA_SIZE, NULL,
+					NULL));
+
+	regions[1].last_step = 2U;
+	TEST_ASSERT_EQUAL_INT(APP_ACTIVATION_OVERLAY_LIFETIME_OVERLAP,
+			AppActivationOverlay_CheckPlan(regions, 3U, TEST_ARENA_SIZE,
+					&first, &second));
+	TEST_ASSERT_EQUAL_UINT32(1U, first);
+	TEST_ASSERT_EQUAL_UINT32(2U, second);
+
+	regions[2].offset = 0x00080000U;
+	TEST_ASSERT_EQUAL_INT(APP_ACTIVATION_OVERLAY_OK,
+			AppActivationOverlay_CheckPlan(regions, 3U, TEST_ARENA_SIZE, NULL,
+					NULL));
+
+	regions[2].offset = 0x00200000U;
+	TEST_ASSERT_EQUAL_INT(APP_ACTIVATION_OVERLAY_OUT_OF_ARENA,
+			AppActivationOverlay_CheckPlan(regions, 3U, TEST_ARENA_SIZE,
+					&first, &second));
+	TEST_ASSERT_EQUAL_UINT32(2U, first);
+	TEST_ASSERT_TRUE(AppActivationOverlay_Find(regions, 3U, "heatmap_cd")
+			== &regions[1]);
+	TEST_ASSERT_NULL(AppActivationOverlay_Find(regions, 3U, "rectifier"));
+}
+
+/*==============================================================================
+ * Test: test_ActivationOverlay_Extent_ChecksPlacedBuffers
+ *
+ * Expected:
+ *   Buffers outside the arena are counted but ignored; buffers inside must
+ *   stay within the stage's region; a buffer crossing the arena edge fails.
+ *==============================================================================*/
+void test_ActivationOverlay_Extent_ChecksPlacedBuffers(void) {
+	const AppActivationOverlay_Region_t region = { "tip_focus", 0x00080000U,
+			0x00040000U, 2U, 2U };
+	AppActivationOverlay_Extent_t extent;
+
+	AppActivationOverlay_ExtentInit(&extent);
+	TEST_ASSERT_EQUAL_INT(APP_ACTIVATION_OVERLAY_OK,
+			AppActivationOverlay_CheckExtent(&region, &extent));
+
+	AppActivationOverlay_ExtentAdd(&extent, TEST_ARENA_BASE, TEST_ARENA_SIZE,
+			TEST_ARENA_BASE + 0x00090000U, 0x1000U);
+	AppActivationOverlay_ExtentAdd(&extent, TEST_ARENA_BASE, TEST_ARENA_SIZE,
+			TEST_ARENA_BASE + 0x00080000U, 0x2000U);
+	AppActivationOverlay_ExtentAdd(&extent, TEST_ARENA_BASE, TEST_ARENA_SIZE,
+			0x70400000U, 0x10000U);
+	AppActivationOverlay_ExtentAdd(&extent, TEST_ARENA_BASE, TEST_ARENA_SIZE,
+			TEST_ARENA_BASE + 0x000A0000U, 0U);
+	TEST_ASSERT_EQUAL_UINT32(0x00080000U, extent.start);
+	TEST_ASSERT_EQUAL_UINT32(0x00091000U, extent.end);
+	TEST_ASSERT_EQUAL_UINT32(2U, extent.buffer_count);
+	TEST_ASSERT_EQUAL_UINT32(1U, extent.outside_count);
+	TEST_ASSERT_EQUAL_INT(APP_ACTIVATION_OVERLAY_OK,
+			AppActivationOverlay_CheckExtent(&region, &extent));
+
+	AppActivationOverlay_ExtentAdd(&extent, TEST_ARENA_BASE, TEST_ARENA_SIZE,
+			TEST_ARENA_BASE + 0x000BF000U, 0x2000U);
+	TEST_ASSERT_EQUAL_INT(APP_ACTIVATION_OVERLAY_EXTENT_EXCEEDED,
+			AppActivationOverlay_CheckExtent(&region, &extent));
+
+	AppActivationOverlay_ExtentAdd(&extent, TEST_ARENA_BASE, TEST_ARENA_SIZE,
+			TEST_ARENA_BASE + TEST_ARENA_SIZE - 0x100U, 0x200U);
+	TEST_ASSERT_TRUE(extent.straddles);
+	TEST_ASSERT_EQUAL_INT(APP_ACTIVATION_OVERLAY_OUT_OF_ARENA,
+			AppActivationOverlay_CheckExtent(&region, &extent));
+	TEST_ASSERT_EQUAL_INT(APP_ACTIVATION_OVERLAY_UNKNOWN_STAGE,
+			AppActivationOverlay_CheckExtent(NULL, &extent));
+	TEST_ASSERT_EQUAL_STRING("extent-exceeded",
+			AppActivationOverlay_StatusName(
+					APP_ACTIVATION_OVERLAY_EXTENT_EXCEEDED));
+}
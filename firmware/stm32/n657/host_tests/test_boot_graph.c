@@ -0,0 +1,194 @@
+/*==============================================================================
+ * File: test_boot_graph.c
+ *
+ * Purpose:
+ *   Unity unit tests for the AppBootGraph module.
+ *
+ * Approach:
+ *   - Use a cut-down copy of the firmware boot graph (camera lane, AI lane
+ *     and an externally completed SD mount) and drive it with explicit
+ *     millisecond timestamps, the way the lane workers do.
+ *==============================================================================*/
+
+#include "unity.h"
+#include "app_boot_graph.h"
+
+#include <stdint.h>
+
+enum {
+	TEST_LANE_CAMERA = 0,
+	TEST_LANE_AI = 1,
+	TEST_LANE_EXTERNAL = 2,
+};
+
+enum {
+	TEST_TASK_SD_MOUNT = 0,
+	TEST_TASK_NPU,
+	TEST_TASK_MODEL,
+	TEST_TASK_PROBE,
+	TEST_TASK_SENSOR,
+	TEST_TASK_AE_SEED,
+	TEST_TASK_COUNT,
+};
+
+static const AppBootGraph_TaskDesc_t test_tasks[TEST_TASK_COUNT] = {
+	[TEST_TASK_SD_MOUNT] = { "sd-mount", TEST_LANE_EXTERNAL, 0U, 0U, 0U },
+	[TEST_TASK_NPU] = { "npu", TEST_LANE_AI, 0U, 0U, 0U },
+	[TEST_TASK_MODEL] = { "model", TEST_LANE_AI,
+			APP_BOOT_GRAPH_TASK_BIT(TEST_TASK_NPU), 0U, 0U },
+	[TEST_TASK_PROBE] = { "probe", TEST_LANE_CAMERA, 0U, 0U, 0U },
+	[TEST_TASK_SENSOR] = { "sensor", TEST_LANE_CAMERA,
+			APP_BOOT_GRAPH_TASK_BIT(TEST_TASK_PROBE), 0U, 0U },
+	[TEST_TASK_AE_SEED] = { "ae-seed", TEST_LANE_CAMERA,
+			APP_BOOT_GRAPH_TASK_BIT(TEST_TASK_SENSOR),
+			APP_BOOT_GRAPH_TASK_BIT(TEST_TASK_SD_MOUNT), 2000U },
+};
+
+/*==============================================================================
+ * Test: test_BootGraph_IndependentLanes_RunConcurrently
+ *
+ * Expected:
+ *   Both lanes get their first task at boot; a lane whose next task depends
+ *   on its own running task waits, then proceeds once it completes.
+ *==============================================================================*/
+void test_BootGraph_IndependentLanes_RunConcurrently(void) {
+	AppBootGraph_t graph;
+	size_t index = 99U;
+	uint32_t wait_ms = 0U;
+
+	TEST_ASSERT_TRUE(AppBootGraph_Init(&graph, test_tasks, TEST_TASK_COUNT,
+			0U));
+
+	TEST_ASSERT_EQUAL_INT(APP_BOOT_GRAPH_NEXT_READY,
+			AppBootGraph_TakeNext(&graph, TEST_LANE_CAMERA, 10U, &index, NULL));
+	TEST_ASSERT_EQUAL_UINT32(TEST_TASK_PROBE, (uint32_t) index);
+	TEST_ASSERT_EQUAL_INT(APP_BOOT_GRAPH_NEXT_READY,
+			AppBootGraph_TakeNext(&graph, TEST_LANE_AI, 10U, &index, NULL));
+	TEST_ASSERT_EQUAL_UINT32(TEST_TASK_NPU, (uint32_t) index);
+
+	TEST_ASSERT_EQUAL_INT(APP_BOOT_GRAPH_NEXT_WAIT,
+			AppBootGraph_TakeNext(&graph, TEST_LANE_AI, 20U, &index,
+					&wait_ms));
+	TEST_ASSERT_EQUAL_UINT32(APP_BOOT_GRAPH_WAIT_FOREVER, wait_ms);
+
+	TEST_ASSERT_TRUE(AppBootGraph_Complete(&graph, TEST_TASK_NPU, true, 30U));
+	TEST_ASSERT_EQUAL_INT(APP_BOOT_GRAPH_NEXT_READY,
+			AppBootGraph_TakeNext(&graph, TEST_LANE_AI, 30U, &index, NULL));
+	TEST_ASSERT_EQUAL_UINT32(TEST_TASK_MODEL, (uint32_t) index);
+	TEST_ASSERT_TRUE(AppBootGraph_Complete(&graph, TEST_TASK_MODEL, true,
+			400U));
+	TEST_ASSERT_EQUAL_INT(APP_BOOT_GRAPH_NEXT_FINISHED,
+			AppBootGraph_TakeNext(&graph, TEST_LANE_AI, 400U, &index, NULL));
+
+	TEST_ASSERT_EQUAL_UINT32(10U, graph.start_ms[TEST_TASK_PROBE]);
+	TEST_ASSERT_EQUAL_UINT32(30U, graph.start_ms[TEST_TASK_MODEL]);
+	TEST_ASSERT_EQUAL_UINT32(400U, graph.end_ms[TEST_TASK_MODEL]);
+}
+
+/*==============================================================================
+ * Test: test_BootGraph_SoftDependency_WaitsOnlyUntilDeadline
+ *
+ * Expected:
+ *   The AE seed holds for the SD mount with a wait hint that counts down to
+ *   its deadline, runs without it once the deadline passes, and runs at once
+ *   when the mount finishes early. A failed mount does not skip it.
+ *==============================================================================*/
+void test_BootGraph_SoftDependency_WaitsOnlyUntilDeadline(void) {
+	AppBootGraph_t graph;
+	size_t index = 99U;
+	uint32_t wait_ms = 0U;
+
+	TEST_ASSERT_TRUE(AppBootGraph_Init(&graph, test_tasks, TEST_TASK_COUNT,
+			1000U));
+	(void) AppBootGraph_TakeNext(&graph, TEST_LANE_CAMERA, 1000U, &index, NULL);
+	TEST_ASSERT_TRUE(AppBootGraph_Complete(&graph, TEST_TASK_PROBE, true,
+			1500U));
+	(void) AppBootGraph_TakeNext(&graph, TEST_LANE_CAMERA, 1500U, &index, NULL);
+	TEST_ASSERT_TRUE(AppBootGraph_Complete(&graph, TEST_TASK_SENSOR, true,
+			1800U));
+
+	TEST_ASSERT_EQUAL_INT(APP_BOOT_GRAPH_NEXT_WAIT,
+			AppBootGraph_TakeNext(&graph, TEST_LANE_CAMERA, 1800U, &index,
+					&wait_ms));
+	TEST_ASSERT_EQUAL_UINT32(1200U, wait_ms);
+	TEST_ASSERT_EQUAL_INT(APP_BOOT_GRAPH_NEXT_READY,
+			AppBootGraph_TakeNext(&graph, TEST_LANE_CAMERA, 3000U, &index,
+					NULL));
+	TEST_ASSERT_EQUAL_UINT32(TEST_TASK_AE_SEED, (uint32_t) index);
+
+	/* Early mount: no waiting at all. */
+	TEST_ASSERT_TRUE(AppBootGraph_Init(&graph, test_tasks, TEST_TASK_COUNT,
+			0U));
+	TEST_ASSERT_TRUE(AppBootGraph_Complete(&graph, TEST_TASK_SD_MOUNT, false,
+			200U));
+	TEST_ASSERT_EQUAL_UINT32(0U, graph.start_ms[TEST_TASK_SD_MOUNT]);
+	(void) AppBootGraph_TakeNext(&graph, TEST_LANE_CAMERA, 300U, &index, NULL);
+	(void) AppBootGraph_Complete(&graph, TEST_TASK_PROBE, true, 300U);
+	(void) AppBootGraph_TakeNext(&graph, TEST_LANE_CAMERA, 300U, &index, NULL);
+	(void) AppBootGraph_Complete(&graph, TEST_TASK_SENSOR, true, 300U);
+	TEST_ASSERT_EQUAL_INT(APP_BOOT_GRAPH_NEXT_READY,
+			AppBootGraph_TakeNext(&graph, TEST_LANE_CAMERA, 300U, &index,
+					NULL));
+	TEST_ASSERT_EQUAL_UINT32(TEST_TASK_AE_SEED, (uint32_t) index);
+}
+
+/*==============================================================================
+ * Test: test_BootGraph_FailedHardDependency_SkipsDownstream
+ *
+ * Expected:
+ *   A failed camera probe skips sensor config and, transitively, the AE
+ *   seed; the camera lane then reports finished and the graph is settled.
+ *==============================================================================*/
+void test_BootGraph_FailedHardDependency_SkipsDownstream(void) {
+	AppBootGraph_t graph;
+	size_t index = 99U;
+	const uint32_t camera_mask = APP_BOOT_GRAPH_TASK_BIT(TEST_TASK_PROBE)
+			| APP_BOOT_GRAPH_TASK_BIT(TEST_TASK_SENSOR)
+			| APP_BOOT_GRAPH_TASK_BIT(TEST_TASK_AE_SEED);
+
+	TEST_ASSERT_TRUE(AppBootGraph_Init(&graph, test_tasks, TEST_TASK_COUNT,
+			0U));
+	(void) AppBootGraph_TakeNext(&graph, TEST_LANE_CAMERA, 5U, &index, NULL);
+	TEST_ASSERT_FALSE(AppBootGraph_IsSettled(&graph, camera_mask));
+	TEST_ASSERT_TRUE(AppBootGraph_Complete(&graph, TEST_TASK_PROBE, false,
+			50U));
+
+	TEST_ASSERT_EQUAL_INT(APP_BOOT_TASK_SKIPPED,
+			graph.state[TEST_TASK_SENSOR]);
+	TEST_ASSERT_EQUAL_INT(APP_BOOT_TASK_SKIPPED,
+			graph.state[TEST_TASK_AE_SEED]);
+	TEST_ASSERT_EQUAL_INT(APP_BOOT_GRAPH_NEXT_FINISHED,
+			AppBootGraph_TakeNext(&graph, TEST_LANE_CAMERA, 50U, &index, NULL));
+	TEST_ASSERT_TRUE(AppBootGraph_IsSettled(&graph, camera_mask));
+	TEST_ASSERT_FALSE(AppBootGraph_Complete(&graph, TEST_TASK_SENSOR, true,
+			60U));
+	TEST_ASSERT_EQUAL_STRING("skipped",
+			AppBootGraph_StateName(graph.state[TEST_TASK_SENSOR]));
+}
+
+/*==============================================================================
+ * Test: test_BootGraph_Init_RejectsBadGraphs
+ *
+ * Expected:
+ *   Cycles, self dependencies and references past the end of the table are
+ *   refused so a typo in the boot table cannot deadlock startup.
+ *==============================================================================*/
+void test_BootGraph_Init_RejectsBadGraphs(void) {
+	AppBootGraph_t graph;
+	const AppBootGraph_TaskDesc_t cycle[2] = {
+		{ "a", 0U, APP_BOOT_GRAPH_TASK_BIT(1), 0U, 0U },
+		{ "b", 1U, 0U, APP_BOOT_GRAPH_TASK_BIT(0), 100U },
+	};
+	const AppBootGraph_TaskDesc_t self[1] = {
+		{ "a", 0U, APP_BOOT_GRAPH_TASK_BIT(0), 0U, 0U },
+	};
+	const AppBootGraph_TaskDesc_t unknown[2] = {
+		{ "a", 0U, 0U, 0U, 0U },
+		{ "b", 0U, APP_BOOT_GRAPH_TASK_BIT(2), 0U, 0U },
+	};
+
+	TEST_ASSERT_FALSE(AppBootGraph_Init(&graph, cycle, 2U, 0U));
+	TEST_ASSERT_FALSE(AppBootGraph_Init(&graph, self, 1U, 0U));
+	TEST_ASSERT_FALSE(AppBootGraph_Init(&graph, unknown, 2U, 0U));
+	TEST_ASSERT_FALSE(AppBootGraph_Init(&graph, test_tasks, 0U, 0U));
+}
@@ -0,0 +1,244 @@
+/*==============================================================================
+ * File: test_burst_fusion.c
+ *
+ * Purpose:
+ *   Unity unit tests for the AppBurstFusion module.
+ *
+ * Approach:
+ *   - Synthesise a textured luma scene with a fixed-seed generator, derive
+ *     translated and noisy burst frames from it, and check that alignment
+ *     recovers the translation and the merge removes the injected noise.
+ *   - Use the live 224x224 frame size so the tests exercise the same
+ *     search window the capture path uses.
+ *==============================================================================*/
+
+#include "unity.h"
+#include "app_burst_fusion.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_WIDTH   224U
+#define TEST_HEIGHT  224U
+#define TEST_Y8_BYTES     (TEST_WIDTH * TEST_HEIGHT)
+#define TEST_YUV422_BYTES (TEST_WIDTH * TEST_HEIGHT * 2U)
+
+static uint8_t test_scene[TEST_YUV422_BYTES];
+static uint8_t test_frames[3][TEST_YUV422_BYTES];
+static uint8_t test_output[TEST_YUV422_BYTES];
+
+/*==============================================================================
+ * Function: Test_Random
+ *
+ * Purpose:
+ *   Small deterministic LCG so every run sees the same scene and noise.
+ *==============================================================================*/
+static uint32_t Test_Random(uint32_t *state_ptr) {
+	*state_ptr = (*state_ptr * 1664525U) + 1013904223U;
+	return *state_ptr >> 16;
+}
+
+/*==============================================================================
+ * Function: Test_BuildScene
+ *
+ * Purpose:
+ *   Fill test_scene with blurred noise: enough texture for a unique
+ *   registration minimum, smooth enough that a one-pixel error still costs.
+ *   YUV422 scenes get a constant chroma pair.
+ *==============================================================================*/
+static void Test_BuildScene(AppFrameFormat_t format) {
+	static uint8_t raw[TEST_Y8_BYTES];
+	uint32_t state = 12345U;
+	const size_t bpp = AppFrameFormat_BytesPerPixel(format);
+
+	for (size_t i = 0U; i < TEST_Y8_BYTES; i++) {
+		raw[i] = (uint8_t) (Test_Random(&state) & 0xFFU);
+	}
+
+	for (size_t y = 0U; y < TEST_HEIGHT; y++) {
+		for (size_t x = 0U; x < TEST_WIDTH; x++) {
+			uint32_t sum = 0U;
+			uint32_t count = 0U;
+
+			for (size_t yy = (y > 0U) ? (y - 1U) : 0U;
+					(yy <= (y + 1U)) && (yy < TEST_HEIGHT); yy++) {
+				for (size_t xx = (x > 0U) ? (x - 1U) : 0U;
+						(xx <= (x + 1U)) && (xx < TEST_WIDTH); xx++) {
+					sum += raw[(yy * TEST_WIDTH) + xx];
+					count++;
+				}
+			}
+			test_scene[((y * TEST_WIDTH) + x) * bpp] = (uint8_t) (sum / count);
+			if (bpp == 2U) {
+				test_scene[(((y * TEST_WIDTH) + x) * bpp) + 1U] =
+						((x & 1U) == 0U) ? 100U : 150U;
+			}
+		}
+	}
+}
+
+/*==============================================================================
+ * Function: Test_Translate
+ *
+ * Purpose:
+ *   Write test_scene shifted so that frame(x + dx, y + dy) == scene(x, y);
+ *   uncovered pixels get a flat grey.
+ *==============================================================================*/
+static void Test_Translate(uint8_t *frame_ptr, AppFrameFormat_t format,
+		int32_t dx, int32_t dy) {
+	const size_t bpp = AppFrameFormat_BytesPerPixel(format);
+
+	for (int32_t y = 0; y < (int32_t) TEST_HEIGHT; y++) {
+		for (int32_t x = 0; x < (int32_t) TEST_WIDTH; x++) {
+			const int32_t sx = x - dx;
+			const int32_t sy = y - dy;
+			uint8_t *const pixel = &frame_ptr[(((size_t) y * TEST_WIDTH)
+					+ (size_t) x) * bpp];
+
+			if ((sx < 0) || (sy < 0) || (sx >= (int32_t) TEST_WIDTH)
+					|| (sy >= (int32_t) TEST_HEIGHT)) {
+				(void) memset(pixel, 128, bpp);
+			} else {
+				(void) memcpy(pixel, &test_scene[(((size_t) sy * TEST_WIDTH)
+						+ (size_t) sx) * bpp], bpp);
+			}
+		}
+	}
+}
+
+/*==============================================================================
+ * Test: test_BurstFusion_EstimateShift_RecoversTranslation
+ *
+ * Expected:
+ *   A Y8 frame moved by (+3, -2) and a YUV422 frame moved by (-4, +1) are
+ *   registered exactly; an unmoved frame reports zero shift.
+ *==============================================================================*/
+void test_BurstFusion_EstimateShift_RecoversTranslation(void) {
+	AppBurstFusion_Shift_t shift = { 99, 99 };
+
+	Test_BuildScene(APP_FRAME_FORMAT_Y8);
+	Test_Translate(test_frames[1], APP_FRAME_FORMAT_Y8, 3, -2);
+	TEST_ASSERT_TRUE(AppBurstFusion_EstimateShift(test_scene, test_frames[1],
+			APP_FRAME_FORMAT_Y8, TEST_WIDTH, TEST_HEIGHT, 6U, &shift));
+	TEST_ASSERT_EQUAL_INT32(3, shift.dx);
+	TEST_ASSERT_EQUAL_INT32(-2, shift.dy);
+
+	TEST_ASSERT_TRUE(AppBurstFusion_EstimateShift(test_scene, test_scene,
+			APP_FRAME_FORMAT_Y8, TEST_WIDTH, TEST_HEIGHT, 6U, &shift));
+	TEST_ASSERT_EQUAL_INT32(0, shift.dx);
+	TEST_ASSERT_EQUAL_INT32(0, shift.dy);
+
+	Test_BuildScene(APP_FRAME_FORMAT_YUV422);
+	Test_Translate(test_frames[1], APP_FRAME_FORMAT_YUV422, -4, 1);
+	TEST_ASSERT_TRUE(AppBurstFusion_EstimateShift(test_scene, test_frames[1],
+			APP_FRAME_FORMAT_YUV422, TEST_WIDTH, TEST_HEIGHT, 6U, &shift));
+	TEST_ASSERT_EQUAL_INT32(-4, shift.dx);
+	TEST_ASSERT_EQUAL_INT32(1, shift.dy);
+}
+
+/*==============================================================================
+ * Test: test_BurstFusion_Median_RejectsTransientGlint
+ *
+ * Expected:
+ *   A saturated glint present in one of three aligned frames is absent from
+ *   the median output, and YUV422 chroma bytes pass through untouched.
+ *==============================================================================*/
+void test_BurstFusion_Median_RejectsTransientGlint(void) {
+	const uint8_t *frames[3] = { test_frames[0], test_frames[1],
+			test_frames[2] };
+	const AppBurstFusion_Shift_t shifts[3] = { { 0, 0 }, { 0, 0 }, { 0, 0 } };
+
+	Test_BuildScene(APP_FRAME_FORMAT_YUV422);
+	for (size_t k = 0U; k < 3U; k++) {
+		(void) memcpy(test_frames[k], test_scene, TEST_YUV422_BYTES);
+	}
+	for (size_t y = 100U; y < 110U; y++) {
+		for (size_t x = 100U; x < 110U; x++) {
+			test_frames[1][((y * TEST_WIDTH) + x) * 2U] = 255U;
+		}
+	}
+
+	TEST_ASSERT_TRUE(AppBurstFusion_Fuse(frames, shifts, 3U,
+			APP_FRAME_FORMAT_YUV422, TEST_WIDTH, TEST_HEIGHT,
+			APP_BURST_FUSION_MEDIAN, test_output));
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(test_scene, test_output, TEST_YUV422_BYTES);
+}
+
+/*==============================================================================
+ * Test: test_BurstFusion_Mean_AlignsAndAveragesNoise
+ *
+ * Expected:
+ *   Three noisy, mutually shifted Y8 frames fuse back onto the reference
+ *   grid with a lower mean error than the reference alone, and the border
+ *   that the shifted frames do not cover still carries reference data.
+ *==============================================================================*/
+void test_BurstFusion_Mean_AlignsAndAveragesNoise(void) {
+	const int32_t offsets[3][2] = { { 0, 0 }, { 2, 1 }, { -1, -3 } };
+	const uint8_t *frames[3] = { test_frames[0], test_frames[1],
+			test_frames[2] };
+	AppBurstFusion_Shift_t shifts[3] = { { 0, 0 } };
+	uint32_t state = 777U;
+	uint64_t reference_error = 0U;
+	uint64_t fused_error = 0U;
+
+	Test_BuildScene(APP_FRAME_FORMAT_Y8);
+	for (size_t k = 0U; k < 3U; k++) {
+		Test_Translate(test_frames[k], APP_FRAME_FORMAT_Y8, offsets[k][0],
+				offsets[k][1]);
+		for (size_t i = 0U; i < TEST_Y8_BYTES; i++) {
+			int32_t value = (int32_t) test_frames[k][i]
+					+ (int32_t) (Test_Random(&state) % 25U) - 12;
+
+			test_frames[k][i] = (uint8_t) ((value < 0) ? 0 :
+					((value > 255) ? 255 : value));
+		}
+	}
+	for (size_t k = 1U; k < 3U; k++) {
+		TEST_ASSERT_TRUE(AppBurstFusion_EstimateShift(test_frames[0],
+				test_frames[k], APP_FRAME_FORMAT_Y8, TEST_WIDTH, TEST_HEIGHT,
+				6U, &shifts[k]));
+		TEST_ASSERT_EQUAL_INT32(offsets[k][0], shifts[k].dx);
+		TEST_ASSERT_EQUAL_INT32(offsets[k][1], shifts[k].dy);
+	}
+
+	TEST_ASSERT_TRUE(AppBurstFusion_Fuse(frames, shifts, 3U,
+			APP_FRAME_FORMAT_Y8, TEST_WIDTH, TEST_HEIGHT, APP_BURST_FUSION_MEAN,
+			test_output));
+	for (size_t i = 0U; i < TEST_Y8_BYTES; i++) {
+		reference_error += (uint64_t) abs((int) test_frames[0][i]
+				- (int) test_scene[i]);
+		fused_error += (uint64_t) abs((int) test_output[i]
+				- (int) test_scene[i]);
+	}
+	TEST_ASSERT_LESS_THAN_UINT32((uint32_t) ((reference_error * 3U) / 4U),
+			(uint32_t) fused_error);
+
+	/* Row 223 is off-frame for the (-1, -3) frame but still fused from the
+	 * other two, so it must stay near the scene. */
+	TEST_ASSERT_UINT32_WITHIN(12U, test_scene[(223U * TEST_WIDTH) + 50U],
+			test_output[(223U * TEST_WIDTH) + 50U]);
+}
+
+/*==============================================================================
+ * Test: test_BurstFusion_Fuse_RejectsInvalidArguments
+ *
+ * Expected:
+ *   Odd YUV422 column shifts (which would mix Y and chroma bytes), an output
+ *   that aliases an input, and oversized bursts are refused.
+ *==============================================================================*/
+void test_BurstFusion_Fuse_RejectsInvalidArguments(void) {
+	const uint8_t *frames[2] = { test_frames[0], test_frames[1] };
+	const AppBurstFusion_Shift_t odd_shift[2] = { { 0, 0 }, { 1, 0 } };
+	const AppBurstFusion_Shift_t zero_shift[2] = { { 0, 0 }, { 0, 0 } };
+
+	TEST_ASSERT_FALSE(AppBurstFusion_Fuse(frames, odd_shift, 2U,
+			APP_FRAME_FORMAT_YUV422, TEST_WIDTH, TEST_HEIGHT,
+			APP_BURST_FUSION_MEAN, test_output));
+	TEST_ASSERT_FALSE(AppBurstFusion_Fuse(frames, zero_shift, 2U,
+			APP_FRAME_FORMAT_Y8, TEST_WIDTH, TEST_HEIGHT, APP_BURST_FUSION_MEAN,
+			test_frames[1]));
+	TEST_ASSERT_FALSE(AppBurstFusion_Fuse(frames, zero_shift,
+			APP_BURST_FUSION_MAX_FRAMES + 1U, APP_FRAME_FORMAT_Y8, TEST_WIDTH,
+			TEST_HEIGHT, APP_BURST_FUSION_MEAN, test_output));
+}
@@ -0,0 +1,173 @@
+/*==============================================================================
+ * File: test_capture_events.c
+ *
+ * Purpose:
+ *   Unity unit tests for the AppCaptureEvents completion state machine.
+ *
+ * Approach:
+ *   - Replay synthetic DCMIPP/CSI interrupt sequences with microsecond
+ *     timestamps, the way the callbacks post them, and check the state the
+ *     capture thread would see and the phase timings it would log.
+ *==============================================================================*/
+
+#include "unity.h"
+#include "app_capture_events.h"
+
+#include <stdint.h>
+
+#define TEST_TIMEOUT_US  8000000U
+
+/*==============================================================================
+ * Test: test_CaptureEvents_CleanFrame_RecordsPhaseTimings
+ *
+ * Expected:
+ *   VSYNC, a duplicate CSI SOF, CSI EOF and the pipe frame event make the
+ *   frame ready; only FRAME raises READY; Accept reports arm->SOF, SOF->EOF
+ *   and EOF->ready from the first boundary and the CSI EOF.
+ *==============================================================================*/
+void test_CaptureEvents_CleanFrame_RecordsPhaseTimings(void) {
+	AppCaptureEvents_Context_t context;
+	AppCaptureEvents_Timing_t timing;
+
+	AppCaptureEvents_Arm(&context, 1000U, TEST_TIMEOUT_US, false);
+	TEST_ASSERT_EQUAL_INT(APP_CAPTURE_EVENTS_IN_FRAME,
+			AppCaptureEvents_Post(&context, APP_CAPTURE_EVENT_VSYNC, 31000U, 0U));
+	(void) AppCaptureEvents_Post(&context, APP_CAPTURE_EVENT_SOF, 31200U, 0U);
+	TEST_ASSERT_EQUAL_UINT32(APP_CAPTURE_EVENTS_FLAG_EOF,
+			AppCaptureEvents_FlagsFor(APP_CAPTURE_EVENT_EOF,
+					AppCaptureEvents_Post(&context, APP_CAPTURE_EVENT_EOF,
+							98000U, 0U)));
+	TEST_ASSERT_EQUAL_UINT32(
+			APP_CAPTURE_EVENTS_FLAG_FRAME | APP_CAPTURE_EVENTS_FLAG_READY,
+			AppCaptureEvents_FlagsFor(APP_CAPTURE_EVENT_FRAME,
+					AppCaptureEvents_Post(&context, APP_CAPTURE_EVENT_FRAME,
+							98400U, 0U)));
+	TEST_ASSERT_EQUAL_INT(APP_CAPTURE_EVENTS_READY,
+			AppCaptureEvents_Check(&context, 99000U));
+
+	TEST_ASSERT_TRUE(AppCaptureEvents_Accept(&context, 99000U, &timing));
+	TEST_ASSERT_EQUAL_UINT32(30000U, timing.arm_to_sof_us);
+	TEST_ASSERT_EQUAL_UINT32(67000U, timing.sof_to_eof_us);
+	TEST_ASSERT_EQUAL_UINT32(1000U, timing.eof_to_ready_us);
+	TEST_ASSERT_EQUAL_UINT32(98000U, timing.arm_to_ready_us);
+	TEST_ASSERT_EQUAL_UINT32(0U, timing.dropped_frames);
+	TEST_ASSERT_EQUAL_INT(APP_CAPTURE_EVENTS_IDLE,
+			AppCaptureEvents_Post(&context, APP_CAPTURE_EVENT_FRAME, 99500U,
+					0U));
+	TEST_ASSERT_FALSE(AppCaptureEvents_Accept(&context, 99600U, &timing));
+}
+
+/*==============================================================================
+ * Test: test_CaptureEvents_Streaming_WaitsForNextBoundary
+ *
+ * Expected:
+ *   Armed mid-frame on a running stream, the tail EOF and the frame event of
+ *   the frame already in flight are not taken; the next VSYNC starts the
+ *   frame that is. Without a boundary requirement the first frame counts.
+ *   An all-zero frame sent back waits for another whole frame.
+ *==============================================================================*/
+void test_CaptureEvents_Streaming_WaitsForNextBoundary(void) {
+	AppCaptureEvents_Context_t context;
+	AppCaptureEvents_Timing_t timing;
+
+	AppCaptureEvents_Arm(&context, 0U, TEST_TIMEOUT_US, true);
+	(void) AppCaptureEvents_Post(&context, APP_CAPTURE_EVENT_EOF, 20000U, 0U);
+	TEST_ASSERT_EQUAL_INT(APP_CAPTURE_EVENTS_ARMED,
+			AppCaptureEvents_Post(&context, APP_CAPTURE_EVENT_FRAME, 20500U,
+					0U));
+	TEST_ASSERT_EQUAL_UINT32(APP_CAPTURE_EVENTS_FLAG_FRAME,
+			AppCaptureEvents_FlagsFor(APP_CAPTURE_EVENT_FRAME,
+					APP_CAPTURE_EVENTS_ARMED));
+	(void) AppCaptureEvents_Post(&context, APP_CAPTURE_EVENT_VSYNC, 30000U, 0U);
+	TEST_ASSERT_EQUAL_INT(APP_CAPTURE_EVENTS_READY,
+			AppCaptureEvents_Post(&context, APP_CAPTURE_EVENT_FRAME, 130000U,
+					0U));
+
+	/* The frame was all zero: wait for the next one, same deadline. */
+	TEST_ASSERT_TRUE(AppCaptureEvents_Rewait(&context));
+	TEST_ASSERT_FALSE(AppCaptureEvents_Rewait(&context));
+	TEST_ASSERT_EQUAL_INT(APP_CAPTURE_EVENTS_ARMED,
+			AppCaptureEvents_Post(&context, APP_CAPTURE_EVENT_FRAME, 135000U,
+					0U));
+	(void) AppCaptureEvents_Post(&context, APP_CAPTURE_EVENT_SOF, 230000U, 0U);
+	(void) AppCaptureEvents_Post(&context, APP_CAPTURE_EVENT_FRAME, 330000U, 0U);
+	TEST_ASSERT_TRUE(AppCaptureEvents_Accept(&context, 331000U, &timing));
+	TEST_ASSERT_EQUAL_UINT32(230000U, timing.arm_to_sof_us);
+	TEST_ASSERT_EQUAL_UINT32(100000U, timing.sof_to_eof_us);
+	TEST_ASSERT_EQUAL_UINT32(2U, timing.dropped_frames);
+	TEST_ASSERT_EQUAL_UINT32(1U, timing.rewaits);
+
+	/* First snapshot: the stream starts after the arm, so no boundary is
+	 * needed and the SOF phase is folded into SOF->EOF. */
+	AppCaptureEvents_Arm(&context, 500U, TEST_TIMEOUT_US, false);
+	TEST_ASSERT_EQUAL_INT(APP_CAPTURE_EVENTS_READY,
+			AppCaptureEvents_Post(&context, APP_CAPTURE_EVENT_FRAME, 90500U,
+					0U));
+	TEST_ASSERT_TRUE(AppCaptureEvents_Accept(&context, 90500U, &timing));
+	TEST_ASSERT_EQUAL_UINT32(0U, timing.arm_to_sof_us);
+	TEST_ASSERT_EQUAL_UINT32(90000U, timing.sof_to_eof_us);
+}
+
+/*==============================================================================
+ * Test: test_CaptureEvents_Errors_FailAndKeepTheirCode
+ *
+ * Expected:
+ *   An error mid-frame fails the capture with its code and raises FAILED;
+ *   later frame events cannot revive it. A late error after the frame
+ *   completed but before the thread took it still fails it.
+ *==============================================================================*/
+void test_CaptureEvents_Errors_FailAndKeepTheirCode(void) {
+	AppCaptureEvents_Context_t context;
+	AppCaptureEvents_Timing_t timing;
+
+	AppCaptureEvents_Arm(&context, 0U, TEST_TIMEOUT_US, false);
+	(void) AppCaptureEvents_Post(&context, APP_CAPTURE_EVENT_VSYNC, 100U, 0U);
+	TEST_ASSERT_EQUAL_UINT32(
+			APP_CAPTURE_EVENTS_FLAG_ERROR | APP_CAPTURE_EVENTS_FLAG_FAILED,
+			AppCaptureEvents_FlagsFor(APP_CAPTURE_EVENT_ERROR,
+					AppCaptureEvents_Post(&context, APP_CAPTURE_EVENT_ERROR,
+							200U, 0xCCF1F0U)));
+	TEST_ASSERT_EQUAL_INT(APP_CAPTURE_EVENTS_FAILED,
+			AppCaptureEvents_Post(&context, APP_CAPTURE_EVENT_FRAME, 300U, 0U));
+	TEST_ASSERT_EQUAL_UINT32(0xCCF1F0U, context.error_code);
+	TEST_ASSERT_EQUAL_INT(APP_CAPTURE_EVENTS_FAILED,
+			AppCaptureEvents_Check(&context, TEST_TIMEOUT_US + 1U));
+	TEST_ASSERT_FALSE(AppCaptureEvents_Accept(&context, 400U, &timing));
+
+	AppCaptureEvents_Arm(&context, 0U, TEST_TIMEOUT_US, false);
+	(void) AppCaptureEvents_Post(&context, APP_CAPTURE_EVENT_FRAME, 100U, 0U);
+	TEST_ASSERT_EQUAL_INT(APP_CAPTURE_EVENTS_FAILED,
+			AppCaptureEvents_Post(&context, APP_CAPTURE_EVENT_ERROR, 150U,
+					0x1E000002U));
+	TEST_ASSERT_EQUAL_UINT32(0x1E000002U, context.error_code);
+}
+
+/*==============================================================================
+ * Test: test_CaptureEvents_Timeout_IsExactAcrossClockWrap
+ *
+ * Expected:
+ *   Armed just before the 32-bit microsecond clock wraps, the capture has
+ *   the full timeout left, times out exactly at the deadline, and a frame
+ *   arriving afterwards does not revive it.
+ *==============================================================================*/
+void test_CaptureEvents_Timeout_IsExactAcrossClockWrap(void) {
+	AppCaptureEvents_Context_t context;
+	const uint32_t arm_us = 0xFFFFF000U;
+
+	AppCaptureEvents_Arm(&context, arm_us, TEST_TIMEOUT_US, true);
+	(void) AppCaptureEvents_Post(&context, APP_CAPTURE_EVENT_VSYNC,
+			arm_us + 0x2000U, 0U);
+	TEST_ASSERT_EQUAL_UINT32(TEST_TIMEOUT_US - 0x3000U,
+			AppCaptureEvents_RemainingUs(&context, arm_us + 0x3000U));
+	TEST_ASSERT_EQUAL_INT(APP_CAPTURE_EVENTS_IN_FRAME,
+			AppCaptureEvents_Check(&context, arm_us + TEST_TIMEOUT_US - 1U));
+	TEST_ASSERT_EQUAL_INT(APP_CAPTURE_EVENTS_TIMED_OUT,
+			AppCaptureEvents_Check(&context, arm_us + TEST_TIMEOUT_US));
+	TEST_ASSERT_EQUAL_UINT32(0U,
+			AppCaptureEvents_RemainingUs(&context, arm_us + TEST_TIMEOUT_US));
+	TEST_ASSERT_EQUAL_INT(APP_CAPTURE_EVENTS_TIMED_OUT,
+			AppCaptureEvents_Post(&context, APP_CAPTURE_EVENT_FRAME,
+					arm_us + TEST_TIMEOUT_US + 5U, 0U));
+	TEST_ASSERT_EQUAL_STRING("timed-out",
+			AppCaptureEvents_StateName(context.state));
+}
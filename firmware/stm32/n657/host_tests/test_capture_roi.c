@@ -0,0 +1,223 @@
+/*==============================================================================
+ * File: test_capture_roi.c
+ *
+ * Purpose:
+ *   Unity unit tests for the AppCaptureRoi module.
+ *
+ * Approach:
+ *   - Use the live IMX335 -> 224x224 configuration with the training crop as
+ *     the target, so every case mirrors what the capture path programs.
+ *   - Check a computed window by mapping the detected box back into it and
+ *     comparing against the target rectangle in output-frame coordinates.
+ *==============================================================================*/
+
+#include "unity.h"
+#include "app_capture_roi.h"
+
+#include <stdint.h>
+
+/*==============================================================================
+ * Function: Test_LiveConfig
+ *
+ * Purpose:
+ *   Sensor, output and target geometry used by app_camera_capture.c.
+ *==============================================================================*/
+static AppCaptureRoi_Config_t Test_LiveConfig(void) {
+	const AppCaptureRoi_Config_t config = {
+		.sensor_width = 2592U,
+		.sensor_height = 1944U,
+		.output_width = 224U,
+		.output_height = 224U,
+		.target_x_min = 0.1027f,
+		.target_y_min = 0.2573f,
+		.target_x_max = 0.7987f,
+		.target_y_max = 0.8071f,
+		.margin_percent = 0U,
+		.min_window_width = 448U,
+		.move_tolerance_percent = 5U,
+	};
+
+	return config;
+}
+
+/*==============================================================================
+ * Function: Test_AssertBoxOnTarget
+ *
+ * Purpose:
+ *   Map a sensor-space box into @p window_ptr and check that its centre sits
+ *   on the target centre and that it fills the target on its tighter axis.
+ *==============================================================================*/
+static void Test_AssertBoxOnTarget(const AppCaptureRoi_Config_t *config_ptr,
+		const AppCaptureRoi_Window_t *window_ptr, float sensor_center_x,
+		float sensor_center_y, float sensor_width, float sensor_height) {
+	const float center_x = (sensor_center_x - (float) window_ptr->x)
+			/ (float) window_ptr->width;
+	const float center_y = (sensor_center_y - (float) window_ptr->y)
+			/ (float) window_ptr->height;
+	const float fill_x = (sensor_width / (float) window_ptr->width)
+			/ (config_ptr->target_x_max - config_ptr->target_x_min);
+	const float fill_y = (sensor_height / (float) window_ptr->height)
+			/ (config_ptr->target_y_max - config_ptr->target_y_min);
+
+	TEST_ASSERT_FLOAT_WITHIN(0.005f,
+			(config_ptr->target_x_min + config_ptr->target_x_max) * 0.5f,
+			center_x);
+	TEST_ASSERT_FLOAT_WITHIN(0.005f,
+			(config_ptr->target_y_min + config_ptr->target_y_max) * 0.5f,
+			center_y);
+	TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.0f, (fill_x > fill_y) ? fill_x : fill_y);
+}
+
+/*==============================================================================
+ * Test: test_CaptureRoi_DefaultWindow_MatchesCenteredSquare
+ *
+ * Expected:
+ *   The default window is the centred 1944x1944 square the fixed framing
+ *   has always used.
+ *==============================================================================*/
+void test_CaptureRoi_DefaultWindow_MatchesCenteredSquare(void) {
+	const AppCaptureRoi_Config_t config = Test_LiveConfig();
+	AppCaptureRoi_Window_t window = { 0 };
+
+	AppCaptureRoi_DefaultWindow(&config, &window);
+	TEST_ASSERT_EQUAL_UINT32(324U, window.x);
+	TEST_ASSERT_EQUAL_UINT32(0U, window.y);
+	TEST_ASSERT_EQUAL_UINT32(1944U, window.width);
+	TEST_ASSERT_EQUAL_UINT32(1944U, window.height);
+}
+
+/*==============================================================================
+ * Test: test_CaptureRoi_WindowFromBox_PutsBoxOnTrainingCrop
+ *
+ * Expected:
+ *   A gauge found off-centre and smaller than the training framing gets a
+ *   tighter, aligned window in which it lands on the training crop.
+ *==============================================================================*/
+void test_CaptureRoi_WindowFromBox_PutsBoxOnTrainingCrop(void) {
+	const AppCaptureRoi_Config_t config = Test_LiveConfig();
+	AppCaptureRoi_Window_t frame_window = { 0 };
+	AppCaptureRoi_Window_t window = { 0 };
+	const AppCaptureRoi_Box_t box = { .center_x = 0.40f, .center_y = 0.45f,
+			.width = 0.35f, .height = 0.30f };
+	float sensor_center_x = 0.0f;
+	float sensor_center_y = 0.0f;
+
+	AppCaptureRoi_DefaultWindow(&config, &frame_window);
+	TEST_ASSERT_TRUE(AppCaptureRoi_WindowFromBox(&config, &frame_window, &box,
+			&window));
+
+	TEST_ASSERT_LESS_THAN_UINT32(frame_window.width, window.width);
+	TEST_ASSERT_EQUAL_UINT32(window.width, window.height);
+	TEST_ASSERT_EQUAL_UINT32(0U, window.x % APP_CAPTURE_ROI_ALIGN_PIXELS);
+	TEST_ASSERT_EQUAL_UINT32(0U, window.y % APP_CAPTURE_ROI_ALIGN_PIXELS);
+	TEST_ASSERT_EQUAL_UINT32(0U, window.width % APP_CAPTURE_ROI_ALIGN_PIXELS);
+
+	AppCaptureRoi_FrameToSensor(&frame_window, box.center_x, box.center_y,
+			&sensor_center_x, &sensor_center_y);
+	Test_AssertBoxOnTarget(&config, &window, sensor_center_x, sensor_center_y,
+			box.width * (float) frame_window.width,
+			box.height * (float) frame_window.height);
+}
+
+/*==============================================================================
+ * Test: test_CaptureRoi_WindowFromBox_IsStableWhenReapplied
+ *
+ * Expected:
+ *   Re-detecting the same physical gauge inside the ROI window yields the
+ *   same window again, so the loop does not walk or oscillate.
+ *==============================================================================*/
+void test_CaptureRoi_WindowFromBox_IsStableWhenReapplied(void) {
+	const AppCaptureRoi_Config_t config = Test_LiveConfig();
+	AppCaptureRoi_Window_t frame_window = { 0 };
+	AppCaptureRoi_Window_t first = { 0 };
+	AppCaptureRoi_Window_t second = { 0 };
+	const AppCaptureRoi_Box_t box = { .center_x = 0.55f, .center_y = 0.50f,
+			.width = 0.40f, .height = 0.35f };
+	AppCaptureRoi_Box_t redetected = { 0 };
+	float sensor_center_x = 0.0f;
+	float sensor_center_y = 0.0f;
+
+	AppCaptureRoi_DefaultWindow(&config, &frame_window);
+	TEST_ASSERT_TRUE(AppCaptureRoi_WindowFromBox(&config, &frame_window, &box,
+			&first));
+
+	AppCaptureRoi_FrameToSensor(&frame_window, box.center_x, box.center_y,
+			&sensor_center_x, &sensor_center_y);
+	redetected.center_x = (sensor_center_x - (float) first.x)
+			/ (float) first.width;
+	redetected.center_y = (sensor_center_y - (float) first.y)
+			/ (float) first.height;
+	redetected.width = box.width * (float) frame_window.width
+			/ (float) first.width;
+	redetected.height = box.height * (float) frame_window.height
+			/ (float) first.height;
+
+	TEST_ASSERT_TRUE(AppCaptureRoi_WindowFromBox(&config, &first, &redetected,
+			&second));
+	TEST_ASSERT_FALSE(AppCaptureRoi_ShouldMove(&config, &first, &second));
+	TEST_ASSERT_UINT32_WITHIN(APP_CAPTURE_ROI_ALIGN_PIXELS, first.x, second.x);
+	TEST_ASSERT_UINT32_WITHIN(APP_CAPTURE_ROI_ALIGN_PIXELS, first.y, second.y);
+	TEST_ASSERT_UINT32_WITHIN(APP_CAPTURE_ROI_ALIGN_PIXELS, first.width,
+			second.width);
+}
+
+/*==============================================================================
+ * Test: test_CaptureRoi_WindowFromBox_ClampsToSensorAndZoomLimit
+ *
+ * Expected:
+ *   A tiny box is not zoomed past the minimum window, a box at the sensor
+ *   corner yields a window that stays on the sensor, and a huge box falls
+ *   back to the full-height square.
+ *==============================================================================*/
+void test_CaptureRoi_WindowFromBox_ClampsToSensorAndZoomLimit(void) {
+	const AppCaptureRoi_Config_t config = Test_LiveConfig();
+	AppCaptureRoi_Window_t frame_window = { 0 };
+	AppCaptureRoi_Window_t window = { 0 };
+	const AppCaptureRoi_Box_t tiny = { .center_x = 0.5f, .center_y = 0.5f,
+			.width = 0.02f, .height = 0.02f };
+	const AppCaptureRoi_Box_t corner = { .center_x = 0.02f, .center_y = 0.98f,
+			.width = 0.30f, .height = 0.30f };
+	const AppCaptureRoi_Box_t huge = { .center_x = 0.5f, .center_y = 0.5f,
+			.width = 1.0f, .height = 1.0f };
+
+	AppCaptureRoi_DefaultWindow(&config, &frame_window);
+
+	TEST_ASSERT_TRUE(AppCaptureRoi_WindowFromBox(&config, &frame_window, &tiny,
+			&window));
+	TEST_ASSERT_EQUAL_UINT32(config.min_window_width, window.width);
+
+	TEST_ASSERT_TRUE(AppCaptureRoi_WindowFromBox(&config, &frame_window,
+			&corner, &window));
+	TEST_ASSERT_LESS_OR_EQUAL_UINT32(config.sensor_width,
+			window.x + window.width);
+	TEST_ASSERT_LESS_OR_EQUAL_UINT32(config.sensor_height,
+			window.y + window.height);
+
+	TEST_ASSERT_TRUE(AppCaptureRoi_WindowFromBox(&config, &frame_window, &huge,
+			&window));
+	TEST_ASSERT_EQUAL_UINT32(1944U, window.width);
+	TEST_ASSERT_EQUAL_UINT32(0U, window.y);
+}
+
+/*==============================================================================
+ * Test: test_CaptureRoi_WindowFromBox_RejectsDegenerateBox
+ *
+ * Expected:
+ *   Zero-sized boxes and centres outside the frame are refused so a bad
+ *   decode cannot steer the window off the gauge.
+ *==============================================================================*/
+void test_CaptureRoi_WindowFromBox_RejectsDegenerateBox(void) {
+	const AppCaptureRoi_Config_t config = Test_LiveConfig();
+	AppCaptureRoi_Window_t frame_window = { 0 };
+	AppCaptureRoi_Window_t window = { 0 };
+	const AppCaptureRoi_Box_t empty = { .center_x = 0.5f, .center_y = 0.5f,
+			.width = 0.0f, .height = 0.3f };
+	const AppCaptureRoi_Box_t outside = { .center_x = 1.2f, .center_y = 0.5f,
+			.width = 0.3f, .height = 0.3f };
+
+	AppCaptureRoi_DefaultWindow(&config, &frame_window);
+	TEST_ASSERT_FALSE(AppCaptureRoi_WindowFromBox(&config, &frame_window,
+			&empty, &window));
+	TEST_ASSERT_FALSE(AppCaptureRoi_WindowFromBox(&config, &frame_window,
+			&outside, &window));
+}
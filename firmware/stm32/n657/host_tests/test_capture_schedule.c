@@ -0,0 +1,213 @@
+/*==============================================================================
+ * File: test_capture_schedule.c
+ *
+ * Purpose:
+ *   Unity unit tests for the AppCaptureSchedule module.
+ *
+ * Approach:
+ *   - The module is pure logic, so we drive it with synthetic timestamps and
+ *     readings and check the period it asks for.
+ *   - Each test follows the real loop: record a capture, ask for the next
+ *     period, advance time by that period.
+ *==============================================================================*/
+
+#include "unity.h"
+#include "app_capture_schedule.h"
+
+#include <stdint.h>
+
+/*==============================================================================
+ * Function: Test_DefaultConfig
+ *
+ * Purpose:
+ *   Build the tunables used by the tests (15 s floor, 60 s base, 15 min
+ *   ceiling, no alarm, no budget unless a test sets one).
+ *==============================================================================*/
+static AppCaptureSchedule_Config_t Test_DefaultConfig(void) {
+	AppCaptureSchedule_Config_t config = {
+		.min_period_ms = 15000U,
+		.base_period_ms = 60000U,
+		.max_period_ms = 900000U,
+		.stable_rate_per_min = 0.05f,
+		.fast_rate_per_min = 0.5f,
+		.alarm_enabled = false,
+		.alarm_low = 0.0f,
+		.alarm_high = 80.0f,
+		.alarm_margin = 5.0f,
+		.daily_capture_budget = 0U,
+	};
+
+	return config;
+}
+
+/*==============================================================================
+ * Function: Test_RunCycles
+ *
+ * Purpose:
+ *   Feed a constant reading for a number of cycles and return the last period.
+ *==============================================================================*/
+static uint32_t Test_RunCycles(AppCaptureSchedule_Context_t *context_ptr,
+		uint32_t *now_ms_ptr, uint32_t cycles, float value) {
+	uint32_t period_ms = 0U;
+	uint32_t cycle = 0U;
+
+	for (cycle = 0U; cycle < cycles; cycle++) {
+		AppCaptureSchedule_RecordCapture(context_ptr, *now_ms_ptr, true, value);
+		period_ms = AppCaptureSchedule_NextPeriodMs(context_ptr, *now_ms_ptr);
+		*now_ms_ptr += period_ms;
+	}
+
+	return period_ms;
+}
+
+/*==============================================================================
+ * Test: test_CaptureSchedule_FlatReadings_GrowToCeiling
+ *
+ * Expected:
+ *   A gauge that never moves walks the period up to the hard ceiling and
+ *   stays there.
+ *==============================================================================*/
+void test_CaptureSchedule_FlatReadings_GrowToCeiling(void) {
+	const AppCaptureSchedule_Config_t config = Test_DefaultConfig();
+	AppCaptureSchedule_Context_t context;
+	uint32_t now_ms = 0U;
+
+	AppCaptureSchedule_Init(&context, &config, now_ms);
+
+	TEST_ASSERT_EQUAL_UINT32(900000U,
+			Test_RunCycles(&context, &now_ms, 20U, 21.0f));
+	TEST_ASSERT_EQUAL_INT(APP_CAPTURE_SCHEDULE_REASON_STABLE,
+			context.last_reason);
+}
+
+/*==============================================================================
+ * Test: test_CaptureSchedule_FastChange_ShrinksToFloor
+ *
+ * Expected:
+ *   After a long flat stretch, a steady 2 units/min ramp halves the period
+ *   each cycle until it reaches the floor.
+ *==============================================================================*/
+void test_CaptureSchedule_FastChange_ShrinksToFloor(void) {
+	const AppCaptureSchedule_Config_t config = Test_DefaultConfig();
+	AppCaptureSchedule_Context_t context;
+	uint32_t now_ms = 0U;
+	uint32_t period_ms = 0U;
+	float value = 21.0f;
+	uint32_t cycle = 0U;
+
+	AppCaptureSchedule_Init(&context, &config, now_ms);
+	period_ms = Test_RunCycles(&context, &now_ms, 20U, value);
+
+	for (cycle = 0U; cycle < 12U; cycle++) {
+		value += 2.0f * ((float) period_ms / 60000.0f);
+		AppCaptureSchedule_RecordCapture(&context, now_ms, true, value);
+		period_ms = AppCaptureSchedule_NextPeriodMs(&context, now_ms);
+		now_ms += period_ms;
+	}
+
+	TEST_ASSERT_EQUAL_UINT32(15000U, period_ms);
+	TEST_ASSERT_EQUAL_INT(APP_CAPTURE_SCHEDULE_REASON_CHANGING,
+			context.last_reason);
+}
+
+/*==============================================================================
+ * Test: test_CaptureSchedule_AlarmProximity_ShrinksPeriod
+ *
+ * Expected:
+ *   A flat reading inside the alarm margin is treated like a fast change.
+ *==============================================================================*/
+void test_CaptureSchedule_AlarmProximity_ShrinksPeriod(void) {
+	AppCaptureSchedule_Config_t config = Test_DefaultConfig();
+	AppCaptureSchedule_Context_t context;
+	uint32_t now_ms = 0U;
+
+	config.alarm_enabled = true;
+	AppCaptureSchedule_Init(&context, &config, now_ms);
+
+	TEST_ASSERT_EQUAL_UINT32(15000U,
+			Test_RunCycles(&context, &now_ms, 6U, 77.0f));
+	TEST_ASSERT_EQUAL_INT(APP_CAPTURE_SCHEDULE_REASON_ALARM,
+			context.last_reason);
+}
+
+/*==============================================================================
+ * Test: test_CaptureSchedule_MissingReading_NeverStretches
+ *
+ * Expected:
+ *   A cycle without a published reading drops the period back to the base
+ *   instead of continuing to stretch on stale history.
+ *==============================================================================*/
+void test_CaptureSchedule_MissingReading_NeverStretches(void) {
+	const AppCaptureSchedule_Config_t config = Test_DefaultConfig();
+	AppCaptureSchedule_Context_t context;
+	uint32_t now_ms = 0U;
+
+	AppCaptureSchedule_Init(&context, &config, now_ms);
+	(void) Test_RunCycles(&context, &now_ms, 20U, 21.0f);
+
+	AppCaptureSchedule_RecordCapture(&context, now_ms, false, 0.0f);
+	TEST_ASSERT_EQUAL_UINT32(60000U,
+			AppCaptureSchedule_NextPeriodMs(&context, now_ms));
+}
+
+/*==============================================================================
+ * Test: test_CaptureSchedule_ExhaustedBudget_HoldsCeiling
+ *
+ * Expected:
+ *   Once the daily budget is spent, even a fast-moving gauge waits the full
+ *   ceiling, and a new 24 h window restores the adaptive period.
+ *==============================================================================*/
+void test_CaptureSchedule_ExhaustedBudget_HoldsCeiling(void) {
+	AppCaptureSchedule_Config_t config = Test_DefaultConfig();
+	AppCaptureSchedule_Context_t context;
+	uint32_t now_ms = 0U;
+	uint32_t cycle = 0U;
+
+	config.daily_capture_budget = 4U;
+	AppCaptureSchedule_Init(&context, &config, now_ms);
+
+	for (cycle = 0U; cycle < 4U; cycle++) {
+		AppCaptureSchedule_RecordCapture(&context, now_ms, true,
+				10.0f * (float) cycle);
+		now_ms += 1000U;
+	}
+
+	TEST_ASSERT_EQUAL_UINT32(900000U,
+			AppCaptureSchedule_NextPeriodMs(&context, now_ms));
+	TEST_ASSERT_EQUAL_INT(APP_CAPTURE_SCHEDULE_REASON_BUDGET,
+			context.last_reason);
+
+	now_ms = APP_CAPTURE_SCHEDULE_DAY_MS + 1000U;
+	AppCaptureSchedule_RecordCapture(&context, now_ms, true, 50.0f);
+	TEST_ASSERT_EQUAL_UINT32(1U, context.day_capture_count);
+}
+
+/*==============================================================================
+ * Test: test_CaptureSchedule_WallClock_RollsBudgetAtMidnight
+ *
+ * Expected:
+ *   Once synced to the RTC, the budget window ends at midnight rather than
+ *   24 h after boot, and a new RTC date restarts the count.
+ *==============================================================================*/
+void test_CaptureSchedule_WallClock_RollsBudgetAtMidnight(void) {
+	AppCaptureSchedule_Config_t config = Test_DefaultConfig();
+	AppCaptureSchedule_Context_t context;
+	uint32_t now_ms = 5000U;
+
+	config.daily_capture_budget = 4U;
+	AppCaptureSchedule_Init(&context, &config, 0U);
+
+	/* Booted at 23:50: ten minutes and three captures left in the day. */
+	AppCaptureSchedule_SyncWallClock(&context, now_ms, 20260314U, 1430U);
+	AppCaptureSchedule_RecordCapture(&context, now_ms, true, 21.0f);
+	TEST_ASSERT_EQUAL_UINT32(200000U,
+			AppCaptureSchedule_NextPeriodMs(&context, now_ms));
+	TEST_ASSERT_EQUAL_INT(APP_CAPTURE_SCHEDULE_REASON_BUDGET,
+			context.last_reason);
+
+	now_ms += 11U * 60000U;
+	AppCaptureSchedule_SyncWallClock(&context, now_ms, 20260315U, 1U);
+	AppCaptureSchedule_RecordCapture(&context, now_ms, true, 21.0f);
+	TEST_ASSERT_EQUAL_UINT32(1U, context.day_capture_count);
+	TEST_ASSERT_EQUAL_UINT32(20260315U, context.day_date_code);
+}
@@ -0,0 +1,155 @@
+/*==============================================================================
+ * File: test_clock_profile.c
+ *
+ * Purpose:
+ *   Unity unit tests for the AppClockProfile operating-point tables.
+ *
+ * Approach:
+ *   - Derive every shipped point off the 1.2 GHz PLL1 and check the peripheral
+ *     settings against the values the fixed clock tree used.
+ *   - Drive demand arbitration and energy accounting directly.
+ *==============================================================================*/
+
+#include "unity.h"
+#include "app_clock_profile.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define TEST_PLL1_HZ  1200000000UL
+
+/*==============================================================================
+ * Test: test_ClockProfile_Derive_BoostMatchesBootClockTree
+ *
+ * Expected:
+ *   The boot point (IC1 /2, IC2 /3) reproduces the settings main.c hardcodes:
+ *   SPI5 /4 at 25 MHz, I2C 0x009034B6 and 600 DWT cycles per microsecond.
+ *==============================================================================*/
+void test_ClockProfile_Derive_BoostMatchesBootClockTree(void) {
+	const AppClockProfile_Point_t point = { .cpu_divider = 2U, .sys_divider =
+			3U };
+	AppClockProfile_Derived_t derived;
+
+	TEST_ASSERT_TRUE(AppClockProfile_Derive(TEST_PLL1_HZ, &point, &derived));
+	TEST_ASSERT_EQUAL_UINT32(600000000UL, derived.cpu_hz);
+	TEST_ASSERT_EQUAL_UINT32(100000000UL, derived.pclk_hz);
+	TEST_ASSERT_EQUAL_UINT32(4U, derived.spi5_divider);
+	TEST_ASSERT_EQUAL_UINT32(25000000UL, derived.spi5_hz);
+	TEST_ASSERT_EQUAL_UINT32(222222U, derived.lpuart_brr);
+	TEST_ASSERT_EQUAL_HEX32(0x009034B6U, derived.i2c_timing);
+	TEST_ASSERT_EQUAL_UINT32(600U, derived.dwt_cycles_per_us);
+}
+
+/*==============================================================================
+ * Test: test_ClockProfile_Derive_LowKeepsPeripheralRates
+ *
+ * Expected:
+ *   Halving the bus halves the prescalers so SD SCK stays at 25 MHz, the
+ *   LPUART BRR halves, and the I2C timing keeps the same SCL durations.
+ *==============================================================================*/
+void test_ClockProfile_Derive_LowKeepsPeripheralRates(void) {
+	const AppClockProfile_Point_t point = { .cpu_divider = 8U, .sys_divider =
+			6U };
+	AppClockProfile_Derived_t derived;
+
+	TEST_ASSERT_TRUE(AppClockProfile_Derive(TEST_PLL1_HZ, &point, &derived));
+	TEST_ASSERT_EQUAL_UINT32(150000000UL, derived.cpu_hz);
+	TEST_ASSERT_EQUAL_UINT32(50000000UL, derived.pclk_hz);
+	TEST_ASSERT_EQUAL_UINT32(2U, derived.spi5_divider);
+	TEST_ASSERT_EQUAL_UINT32(25000000UL, derived.spi5_hz);
+	TEST_ASSERT_EQUAL_UINT32(111111U, derived.lpuart_brr);
+	TEST_ASSERT_EQUAL_HEX32(0x00401A5BU, derived.i2c_timing);
+	TEST_ASSERT_EQUAL_UINT32(150U, derived.dwt_cycles_per_us);
+
+	/* A kernel clock too fast for PRESC 0 moves to a coarser prescaler. */
+	TEST_ASSERT_EQUAL_HEX32(0x109034B6U,
+			AppClockProfile_I2cTiming(200000000UL));
+}
+
+/*==============================================================================
+ * Test: test_ClockProfile_Derive_RejectsInvalidPoints
+ *
+ * Expected:
+ *   Points that overclock the CPU or bus, that land on fractional megahertz,
+ *   or that have a zero divider are rejected.
+ *==============================================================================*/
+void test_ClockProfile_Derive_RejectsInvalidPoints(void) {
+	const AppClockProfile_Point_t overclock_cpu = { 1U, 3U };
+	const AppClockProfile_Point_t overclock_bus = { 2U, 2U };
+	const AppClockProfile_Point_t fractional = { 7U, 3U };
+	const AppClockProfile_Point_t zero = { 0U, 3U };
+	AppClockProfile_Derived_t derived;
+
+	TEST_ASSERT_FALSE(AppClockProfile_Derive(TEST_PLL1_HZ, &overclock_cpu,
+			&derived));
+	TEST_ASSERT_FALSE(AppClockProfile_Derive(TEST_PLL1_HZ, &overclock_bus,
+			&derived));
+	TEST_ASSERT_FALSE(AppClockProfile_Derive(TEST_PLL1_HZ, &fractional,
+			&derived));
+	TEST_ASSERT_FALSE(AppClockProfile_Derive(TEST_PLL1_HZ, &zero, &derived));
+
+	TEST_ASSERT_EQUAL_UINT32(256U, AppClockProfile_SpiDivider(6400000UL,
+			25000UL));
+	TEST_ASSERT_EQUAL_UINT32(0U, AppClockProfile_SpiDivider(100000000UL,
+			100000UL));
+	/* BRR below 0x300 is not allowed by the LPUART. */
+	TEST_ASSERT_EQUAL_UINT32(0U, AppClockProfile_LpuartBrr(1000000UL,
+			921600UL));
+}
+
+/*==============================================================================
+ * Test: test_ClockProfile_Demand_HighestWinsAndRestores
+ *
+ * Expected:
+ *   The effective profile is the highest client demand, LOW with no demand,
+ *   and SetDemand hands back the previous value for nested phases.
+ *==============================================================================*/
+void test_ClockProfile_Demand_HighestWinsAndRestores(void) {
+	AppClockProfile_Demand_t demand;
+	AppClockProfile_Id_t previous = APP_CLOCK_PROFILE_LOW;
+
+	AppClockProfile_InitDemand(&demand);
+	TEST_ASSERT_EQUAL_INT(APP_CLOCK_PROFILE_LOW,
+			AppClockProfile_Effective(&demand));
+
+	(void) AppClockProfile_SetDemand(&demand, APP_CLOCK_CLIENT_AI,
+			APP_CLOCK_PROFILE_BOOST);
+	previous = AppClockProfile_SetDemand(&demand, APP_CLOCK_CLIENT_AI,
+			APP_CLOCK_PROFILE_NOMINAL);
+	TEST_ASSERT_EQUAL_INT(APP_CLOCK_PROFILE_BOOST, previous);
+	TEST_ASSERT_EQUAL_INT(APP_CLOCK_PROFILE_NOMINAL,
+			AppClockProfile_Effective(&demand));
+
+	/* Baseline CV running alongside the NPU epochs keeps the boost. */
+	(void) AppClockProfile_SetDemand(&demand, APP_CLOCK_CLIENT_BASELINE,
+			APP_CLOCK_PROFILE_BOOST);
+	TEST_ASSERT_EQUAL_INT(APP_CLOCK_PROFILE_BOOST,
+			AppClockProfile_Effective(&demand));
+
+	(void) AppClockProfile_SetDemand(&demand, APP_CLOCK_CLIENT_BASELINE,
+			APP_CLOCK_PROFILE_LOW);
+	(void) AppClockProfile_SetDemand(&demand, APP_CLOCK_CLIENT_AI, previous);
+	TEST_ASSERT_EQUAL_INT(APP_CLOCK_PROFILE_BOOST,
+			AppClockProfile_Effective(&demand));
+}
+
+/*==============================================================================
+ * Test: test_ClockProfile_Account_SumsEnergyPerProfile
+ *
+ * Expected:
+ *   Dwell and energy (mW x ms = uJ) accumulate per profile only.
+ *==============================================================================*/
+void test_ClockProfile_Account_SumsEnergyPerProfile(void) {
+	AppClockProfile_Energy_t energy = { 0 };
+
+	AppClockProfile_Account(&energy, APP_CLOCK_PROFILE_BOOST, 120U, 950U);
+	AppClockProfile_Account(&energy, APP_CLOCK_PROFILE_BOOST, 80U, 900U);
+	AppClockProfile_Account(&energy, APP_CLOCK_PROFILE_LOW, 5000U, 310U);
+	AppClockProfile_Account(&energy, APP_CLOCK_PROFILE_COUNT, 10U, 10U);
+
+	TEST_ASSERT_EQUAL_UINT32(200U, energy.dwell_ms[APP_CLOCK_PROFILE_BOOST]);
+	TEST_ASSERT_EQUAL_UINT64(186000U,
+			energy.energy_uj[APP_CLOCK_PROFILE_BOOST]);
+	TEST_ASSERT_EQUAL_UINT64(1550000U, energy.energy_uj[APP_CLOCK_PROFILE_LOW]);
+	TEST_ASSERT_EQUAL_UINT32(0U, energy.dwell_ms[APP_CLOCK_PROFILE_NOMINAL]);
+}
@@ -0,0 +1,94 @@
+/*==============================================================================
+ * File: test_epoch_profile.c
+ *
+ * Purpose:
+ *   Unity unit tests for the AppEpochProfile per-epoch timing accumulator.
+ *
+ * Approach:
+ *   - Drive runs with synthetic microsecond timestamps the way the epoch
+ *     loop marks them after each RunEpochBlock pass.
+ *   - Check min/avg/max per epoch step, aborted runs, and table overflow.
+ *==============================================================================*/
+
+#include "unity.h"
+#include "app_epoch_profile.h"
+
+#include <stdint.h>
+
+static AppEpochProfile_t profile;
+
+static void run_epochs(uint64_t start_us, const uint32_t *durations,
+		uint32_t count, bool completed) {
+	uint64_t now = start_us;
+
+	AppEpochProfile_BeginRun(&profile, now);
+	for (uint32_t index = 0U; index < count; index++) {
+		now += durations[index];
+		AppEpochProfile_Mark(&profile, now);
+	}
+	AppEpochProfile_EndRun(&profile, completed);
+}
+
+/*==============================================================================
+ * Test: test_EpochProfile_AccumulatesPerEpochStep
+ *
+ * Expected:
+ *   Each epoch step keeps its own min/avg/max across runs; the total is the
+ *   sum of the averages; an aborted run keeps its samples but is not counted
+ *   as a run; marks outside a run are ignored.
+ *==============================================================================*/
+void test_EpochProfile_AccumulatesPerEpochStep(void) {
+	const uint32_t first[3] = { 100U, 400U, 50U };
+	const uint32_t second[3] = { 300U, 400U, 70U };
+	const uint32_t aborted[1] = { 200U };
+
+	AppEpochProfile_Init(&profile);
+	run_epochs(1000U, first, 3U, true);
+	run_epochs(5000U, second, 3U, true);
+	TEST_ASSERT_EQUAL_UINT32(2U, profile.run_count);
+	TEST_ASSERT_EQUAL_UINT32(3U, profile.epoch_count);
+	TEST_ASSERT_EQUAL_UINT32(100U, profile.epochs[0].min_us);
+	TEST_ASSERT_EQUAL_UINT32(300U, profile.epochs[0].max_us);
+	TEST_ASSERT_EQUAL_UINT32(200U,
+			AppEpochProfile_AverageUs(&profile.epochs[0]));
+	TEST_ASSERT_EQUAL_UINT32(60U, AppEpochProfile_AverageUs(&profile.epochs[2]));
+	TEST_ASSERT_EQUAL_UINT32(660U,
+			(uint32_t) AppEpochProfile_TotalAverageUs(&profile));
+
+	run_epochs(9000U, aborted, 1U, false);
+	TEST_ASSERT_EQUAL_UINT32(2U, profile.run_count);
+	TEST_ASSERT_EQUAL_UINT32(3U, profile.epochs[0].count);
+
+	AppEpochProfile_Mark(&profile, 20000U);
+	TEST_ASSERT_EQUAL_UINT32(3U, profile.epochs[0].count);
+	TEST_ASSERT_EQUAL_UINT32(0U, AppEpochProfile_AverageUs(NULL));
+}
+
+/*==============================================================================
+ * Test: test_EpochProfile_CountsEpochsPastTable
+ *
+ * Expected:
+ *   Epoch steps past APP_EPOCH_PROFILE_MAX_EPOCHS are counted as dropped
+ *   and the table stays at its capacity; a clock that steps backwards
+ *   records zero instead of wrapping.
+ *==============================================================================*/
+void test_EpochProfile_CountsEpochsPastTable(void) {
+	uint64_t now = 0U;
+
+	AppEpochProfile_Init(&profile);
+	AppEpochProfile_BeginRun(&profile, now);
+	for (uint32_t index = 0U; index < APP_EPOCH_PROFILE_MAX_EPOCHS + 2U;
+			index++) {
+		now += 10U;
+		AppEpochProfile_Mark(&profile, now);
+	}
+	AppEpochProfile_EndRun(&profile, true);
+	TEST_ASSERT_EQUAL_UINT32(APP_EPOCH_PROFILE_MAX_EPOCHS, profile.epoch_count);
+	TEST_ASSERT_EQUAL_UINT32(2U, profile.dropped);
+
+	AppEpochProfile_BeginRun(&profile, 500U);
+	AppEpochProfile_Mark(&profile, 400U);
+	AppEpochProfile_EndRun(&profile, true);
+	TEST_ASSERT_EQUAL_UINT32(0U, profile.epochs[0].min_us);
+	TEST_ASSERT_EQUAL_UINT32(5U, AppEpochProfile_AverageUs(&profile.epochs[0]));
+}
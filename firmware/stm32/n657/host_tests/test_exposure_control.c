@@ -0,0 +1,244 @@
+/*==============================================================================
+ * File: test_exposure_control.c
+ *
+ * Purpose:
+ *   Unity unit tests for the AppExposureControl module.
+ *
+ * Approach:
+ *   - A small IMX335 + ISP model turns (exposure, gain) into a crop histogram:
+ *     linear signal = illuminance x reflectance x exposure x gain, clipped at
+ *     full well, then passed through a display gamma.
+ *   - Scene illuminance is chosen so the default 1/3-exposure 1/2-gain seed
+ *     reproduces the crop means seen in recorded frames (night, 18:xx dusk at
+ *     43-87, 13:xx midday at 97-156, and the near-white 11:51 glare frame).
+ *   - Each test runs the real capture loop: measure, stop when the mean is in
+ *     the gate band, otherwise ask the controller for the next setting.
+ *==============================================================================*/
+
+#include "unity.h"
+#include "app_exposure_control.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#define TEST_EXPOSURE_PIXEL_COUNT      1024U
+#define TEST_EXPOSURE_BAND_LOW         150.0f
+#define TEST_EXPOSURE_BAND_HIGH        190.0f
+#define TEST_EXPOSURE_MAX_CORRECTIONS    4U
+
+static uint32_t test_histogram[APP_EXPOSURE_CONTROL_HISTOGRAM_BINS];
+
+/*==============================================================================
+ * Function: Test_Imx335Limits
+ *
+ * Purpose:
+ *   Sensor limits reported by the IMX335 middleware.
+ *==============================================================================*/
+static AppExposureControl_Limits_t Test_Imx335Limits(void) {
+	const AppExposureControl_Limits_t limits = {
+		.exposure_min_us = 8U,
+		.exposure_max_us = 33266U,
+		.gain_min_mdb = 0,
+		.gain_max_mdb = 72000,
+	};
+
+	return limits;
+}
+
+/*==============================================================================
+ * Function: Test_DefaultConfig
+ *
+ * Purpose:
+ *   Tunables matching the firmware defaults in app_camera_config.h.
+ *==============================================================================*/
+static AppExposureControl_Config_t Test_DefaultConfig(void) {
+	const AppExposureControl_Config_t config = {
+		.target_mean = 165.0f,
+		.response_gamma = 2.2f,
+		.second_step_damping = 0.8f,
+		.max_step_ratio = 100.0f,
+	};
+
+	return config;
+}
+
+/*==============================================================================
+ * Function: Test_SeedSetting
+ *
+ * Purpose:
+ *   The cold-start seed used by CameraPlatform_SeedImx335ExposureGain.
+ *==============================================================================*/
+static AppExposureControl_Setting_t Test_SeedSetting(void) {
+	const AppExposureControl_Limits_t limits = Test_Imx335Limits();
+	AppExposureControl_Setting_t seed;
+
+	seed.exposure_us = limits.exposure_min_us
+			+ ((limits.exposure_max_us - limits.exposure_min_us) / 3U);
+	seed.gain_mdb = limits.gain_min_mdb
+			+ ((limits.gain_max_mdb - limits.gain_min_mdb) / 2);
+	return seed;
+}
+
+/*==============================================================================
+ * Function: Test_SimulateFrame
+ *
+ * Purpose:
+ *   Render the crop histogram for one frame. Reflectance ramps from 0.25 to
+ *   1.0 across the crop like a white dial with dark markings. illuminance is
+ *   relative to the seed: 1.0 puts the brightest pixel exactly at full well.
+ *==============================================================================*/
+static void Test_SimulateFrame(float illuminance, float sensor_gamma,
+		const AppExposureControl_Setting_t *setting_ptr) {
+	const AppExposureControl_Setting_t seed = Test_SeedSetting();
+	const float relative_total = AppExposureControl_TotalFromSetting(setting_ptr)
+			/ AppExposureControl_TotalFromSetting(&seed);
+	uint32_t pixel = 0U;
+
+	(void) memset(test_histogram, 0, sizeof(test_histogram));
+	for (pixel = 0U; pixel < TEST_EXPOSURE_PIXEL_COUNT; pixel++) {
+		const float reflectance = 0.25f
+				+ (0.75f * (float) pixel / (float) (TEST_EXPOSURE_PIXEL_COUNT - 1U));
+		float signal = illuminance * reflectance * relative_total;
+		uint32_t level = 0U;
+
+		if (signal > 1.0f) {
+			signal = 1.0f;
+		}
+		level = (uint32_t) ((255.0f * powf(signal, 1.0f / sensor_gamma)) + 0.5f);
+		test_histogram[level]++;
+	}
+}
+
+/*==============================================================================
+ * Function: Test_CorrectionsToBand
+ *
+ * Purpose:
+ *   Run the capture loop from the seed and return how many controller
+ *   corrections were needed before a frame landed in the gate band.
+ *   Returns TEST_EXPOSURE_MAX_CORRECTIONS + 1 when it never converged.
+ *==============================================================================*/
+static uint32_t Test_CorrectionsToBand(float illuminance, float sensor_gamma) {
+	const AppExposureControl_Config_t config = Test_DefaultConfig();
+	const AppExposureControl_Limits_t limits = Test_Imx335Limits();
+	AppExposureControl_Context_t context;
+	AppExposureControl_Setting_t setting = Test_SeedSetting();
+	AppExposureControl_Setting_t next;
+	AppExposureControl_Measurement_t measurement;
+	uint32_t corrections = 0U;
+
+	AppExposureControl_Init(&context, &config, &limits);
+	for (corrections = 0U; corrections <= TEST_EXPOSURE_MAX_CORRECTIONS;
+			corrections++) {
+		Test_SimulateFrame(illuminance, sensor_gamma, &setting);
+		TEST_ASSERT_TRUE(AppExposureControl_Measure(test_histogram, &measurement));
+		if ((measurement.mean >= TEST_EXPOSURE_BAND_LOW)
+				&& (measurement.mean < TEST_EXPOSURE_BAND_HIGH)) {
+			return corrections;
+		}
+		if (!AppExposureControl_ComputeNext(&context, &measurement, &setting,
+				&next)) {
+			break;
+		}
+		setting = next;
+	}
+
+	return TEST_EXPOSURE_MAX_CORRECTIONS + 1U;
+}
+
+/*==============================================================================
+ * Test: test_ExposureControl_RecordedLighting_ConvergesInTwoFrames
+ *
+ * Expected:
+ *   Every recorded lighting condition reaches the gate band within two
+ *   corrections of the cold-start seed when the ISP matches the model.
+ *==============================================================================*/
+void test_ExposureControl_RecordedLighting_ConvergesInTwoFrames(void) {
+	/* Seed crop means: ~20 night, ~60 dusk, ~130 midday, ~250 glare. */
+	const float illuminance[] = { 0.004f, 0.07f, 0.35f, 1.0f, 4.0f };
+	uint32_t index = 0U;
+
+	for (index = 0U; index < (sizeof(illuminance) / sizeof(illuminance[0]));
+			index++) {
+		TEST_ASSERT_LESS_OR_EQUAL_UINT32(2U,
+				Test_CorrectionsToBand(illuminance[index], 2.2f));
+	}
+}
+
+/*==============================================================================
+ * Test: test_ExposureControl_GammaMismatch_ConvergesInTwoFrames
+ *
+ * Expected:
+ *   An ISP tone curve steeper or flatter than the assumed 2.2 still converges
+ *   within two corrections, thanks to the damped second step.
+ *==============================================================================*/
+void test_ExposureControl_GammaMismatch_ConvergesInTwoFrames(void) {
+	const float illuminance[] = { 0.004f, 0.07f, 0.35f, 4.0f };
+	const float sensor_gamma[] = { 1.8f, 2.6f };
+	uint32_t light = 0U;
+	uint32_t curve = 0U;
+
+	for (curve = 0U; curve < (sizeof(sensor_gamma) / sizeof(sensor_gamma[0]));
+			curve++) {
+		for (light = 0U; light < (sizeof(illuminance) / sizeof(illuminance[0]));
+				light++) {
+			TEST_ASSERT_LESS_OR_EQUAL_UINT32(2U,
+					Test_CorrectionsToBand(illuminance[light], sensor_gamma[curve]));
+		}
+	}
+}
+
+/*==============================================================================
+ * Test: test_ExposureControl_InBandFrame_NeedsNoCorrection
+ *
+ * Expected:
+ *   A scene whose seed frame already sits in the band is accepted as-is.
+ *==============================================================================*/
+void test_ExposureControl_InBandFrame_NeedsNoCorrection(void) {
+	TEST_ASSERT_EQUAL_UINT32(0U, Test_CorrectionsToBand(0.55f, 2.2f));
+}
+
+/*==============================================================================
+ * Test: test_ExposureControl_SensorLimit_ReportsNoChange
+ *
+ * Expected:
+ *   When exposure and gain are already maxed and the frame is still dark,
+ *   the controller reports that another frame would not help.
+ *==============================================================================*/
+void test_ExposureControl_SensorLimit_ReportsNoChange(void) {
+	const AppExposureControl_Config_t config = Test_DefaultConfig();
+	const AppExposureControl_Limits_t limits = Test_Imx335Limits();
+	AppExposureControl_Context_t context;
+	const AppExposureControl_Setting_t maxed = { .exposure_us =
+			limits.exposure_max_us, .gain_mdb = limits.gain_max_mdb };
+	AppExposureControl_Setting_t next;
+	AppExposureControl_Measurement_t measurement = { .sample_count = 100U,
+			.mean = 40.0f, .clipped_high_fraction = 0.0f,
+			.clipped_low_fraction = 0.0f };
+
+	AppExposureControl_Init(&context, &config, &limits);
+	TEST_ASSERT_FALSE(AppExposureControl_ComputeNext(&context, &measurement,
+			&maxed, &next));
+	TEST_ASSERT_EQUAL_UINT32(limits.exposure_max_us, next.exposure_us);
+	TEST_ASSERT_EQUAL_INT32(limits.gain_max_mdb, next.gain_mdb);
+}
+
+/*==============================================================================
+ * Test: test_ExposureControl_SettingFromTotal_SpendsExposureFirst
+ *
+ * Expected:
+ *   Gain stays at its minimum until exposure is maxed out, and the split
+ *   round-trips the requested exposure x gain.
+ *==============================================================================*/
+void test_ExposureControl_SettingFromTotal_SpendsExposureFirst(void) {
+	const AppExposureControl_Limits_t limits = Test_Imx335Limits();
+	AppExposureControl_Setting_t setting;
+
+	AppExposureControl_SettingFromTotal(&limits, 20000.0f, &setting);
+	TEST_ASSERT_EQUAL_UINT32(20000U, setting.exposure_us);
+	TEST_ASSERT_EQUAL_INT32(0, setting.gain_mdb);
+
+	AppExposureControl_SettingFromTotal(&limits, 332660.0f, &setting);
+	TEST_ASSERT_EQUAL_UINT32(limits.exposure_max_us, setting.exposure_us);
+	TEST_ASSERT_INT32_WITHIN(2, 20000, setting.gain_mdb);
+}
@@ -0,0 +1,177 @@
+/*==============================================================================
+ * File: test_exposure_memory.c
+ *
+ * Purpose:
+ *   Unity unit tests for the AppExposureMemory module.
+ *
+ * Approach:
+ *   - The module is pure logic, so we build tables in RAM, drive them with
+ *     RTC-style timestamps and check what the capture path would seed with.
+ *   - Persistence is just the sealed struct, so corrupting a byte stands in
+ *     for a torn SD write.
+ *==============================================================================*/
+
+#include "unity.h"
+#include "app_exposure_memory.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/*==============================================================================
+ * Function: Test_Time
+ *
+ * Purpose:
+ *   Parse a capture-style timestamp, failing the test if it is rejected.
+ *==============================================================================*/
+static AppExposureMemory_Time_t Test_Time(const char *text_ptr) {
+	AppExposureMemory_Time_t time = { 0 };
+
+	TEST_ASSERT_TRUE(AppExposureMemory_ParseTimestamp(text_ptr, &time));
+	return time;
+}
+
+/*==============================================================================
+ * Test: test_ExposureMemory_ParseTimestamp_AcceptsRtcForms
+ *
+ * Expected:
+ *   Both the filename form and the raw DS3231 form decode; garbage and
+ *   out-of-range fields are rejected.
+ *==============================================================================*/
+void test_ExposureMemory_ParseTimestamp_AcceptsRtcForms(void) {
+	AppExposureMemory_Time_t time = { 0 };
+
+	TEST_ASSERT_TRUE(AppExposureMemory_ParseTimestamp("2026-03-14_18-05-09",
+			&time));
+	TEST_ASSERT_EQUAL_UINT32(20260314U, time.date_code);
+	TEST_ASSERT_EQUAL_UINT32((18U * 60U) + 5U, time.minute_of_day);
+
+	TEST_ASSERT_TRUE(AppExposureMemory_ParseTimestamp("2026-03-14 07:59:00",
+			&time));
+	TEST_ASSERT_EQUAL_UINT32((7U * 60U) + 59U, time.minute_of_day);
+
+	TEST_ASSERT_FALSE(AppExposureMemory_ParseTimestamp("2026-13-14_18-05-09",
+			&time));
+	TEST_ASSERT_FALSE(AppExposureMemory_ParseTimestamp("2026-03-14_24-00-00",
+			&time));
+	TEST_ASSERT_FALSE(AppExposureMemory_ParseTimestamp("not a timestamp",
+			&time));
+}
+
+/*==============================================================================
+ * Test: test_ExposureMemory_Lookup_PrefersOwnThenNearerBucket
+ *
+ * Expected:
+ *   A capture at 18:10 uses the 18:00 bucket when it is filled; with only
+ *   17:00 and 19:00 filled it picks 17:00 (closer), and at 18:40 it picks
+ *   19:00.
+ *==============================================================================*/
+void test_ExposureMemory_Lookup_PrefersOwnThenNearerBucket(void) {
+	AppExposureMemory_Table_t table;
+	uint32_t exposure_us = 0U;
+	int32_t gain_mdb = 0;
+	AppExposureMemory_Time_t time = Test_Time("2026-03-14_17-30-00");
+
+	AppExposureMemory_Init(&table);
+	(void) AppExposureMemory_Store(&table, &time, 1700U, 0);
+	time = Test_Time("2026-03-14_19-30-00");
+	(void) AppExposureMemory_Store(&table, &time, 1900U, 0);
+
+	time = Test_Time("2026-03-15_18-10-00");
+	TEST_ASSERT_TRUE(AppExposureMemory_Lookup(&table, &time, 7U, &exposure_us,
+			&gain_mdb));
+	TEST_ASSERT_EQUAL_UINT32(1700U, exposure_us);
+
+	time = Test_Time("2026-03-15_18-40-00");
+	TEST_ASSERT_TRUE(AppExposureMemory_Lookup(&table, &time, 7U, &exposure_us,
+			&gain_mdb));
+	TEST_ASSERT_EQUAL_UINT32(1900U, exposure_us);
+
+	(void) AppExposureMemory_Store(&table, &time, 1800U, 1000);
+	TEST_ASSERT_TRUE(AppExposureMemory_Lookup(&table, &time, 7U, &exposure_us,
+			&gain_mdb));
+	TEST_ASSERT_EQUAL_UINT32(1800U, exposure_us);
+	TEST_ASSERT_EQUAL_INT32(1000, gain_mdb);
+}
+
+/*==============================================================================
+ * Test: test_ExposureMemory_Lookup_IgnoresStaleAndFutureEntries
+ *
+ * Expected:
+ *   An entry older than the max age is skipped, and so is one dated after
+ *   the capture (the RTC was reset to an earlier date).
+ *==============================================================================*/
+void test_ExposureMemory_Lookup_IgnoresStaleAndFutureEntries(void) {
+	AppExposureMemory_Table_t table;
+	uint32_t exposure_us = 0U;
+	int32_t gain_mdb = 0;
+	AppExposureMemory_Time_t time = Test_Time("2026-02-26_12-00-00");
+
+	AppExposureMemory_Init(&table);
+	(void) AppExposureMemory_Store(&table, &time, 4000U, 0);
+
+	/* Across the month boundary: 7 days is still fresh, 8 is not. */
+	time = Test_Time("2026-03-05_12-00-00");
+	TEST_ASSERT_TRUE(AppExposureMemory_Lookup(&table, &time, 7U, &exposure_us,
+			&gain_mdb));
+	time = Test_Time("2026-03-06_12-00-00");
+	TEST_ASSERT_FALSE(AppExposureMemory_Lookup(&table, &time, 7U, &exposure_us,
+			&gain_mdb));
+
+	time = Test_Time("2000-01-01_12-00-00");
+	TEST_ASSERT_FALSE(AppExposureMemory_Lookup(&table, &time, 7U, &exposure_us,
+			&gain_mdb));
+}
+
+/*==============================================================================
+ * Test: test_ExposureMemory_Store_OnlyReportsMaterialChanges
+ *
+ * Expected:
+ *   Re-storing a near-identical setting on the same day asks for no SD write
+ *   and leaves the entry alone; a large change or a new day does.
+ *==============================================================================*/
+void test_ExposureMemory_Store_OnlyReportsMaterialChanges(void) {
+	AppExposureMemory_Table_t table;
+	uint32_t exposure_us = 0U;
+	int32_t gain_mdb = 0;
+	AppExposureMemory_Time_t time = Test_Time("2026-03-14_09-00-00");
+
+	AppExposureMemory_Init(&table);
+	TEST_ASSERT_TRUE(AppExposureMemory_Store(&table, &time, 10000U, 6000));
+	TEST_ASSERT_FALSE(AppExposureMemory_Store(&table, &time, 11000U, 6500));
+	TEST_ASSERT_TRUE(AppExposureMemory_Lookup(&table, &time, 7U, &exposure_us,
+			&gain_mdb));
+	TEST_ASSERT_EQUAL_UINT32(10000U, exposure_us);
+
+	TEST_ASSERT_TRUE(AppExposureMemory_Store(&table, &time, 15000U, 6000));
+	TEST_ASSERT_TRUE(AppExposureMemory_Store(&table, &time, 15000U, 9000));
+
+	time = Test_Time("2026-03-15_09-10-00");
+	TEST_ASSERT_TRUE(AppExposureMemory_Store(&table, &time, 15000U, 9000));
+}
+
+/*==============================================================================
+ * Test: test_ExposureMemory_IsValid_RejectsCorruptCopy
+ *
+ * Expected:
+ *   A sealed table validates; flipping one byte or changing the layout
+ *   fields makes the loader reject it.
+ *==============================================================================*/
+void test_ExposureMemory_IsValid_RejectsCorruptCopy(void) {
+	AppExposureMemory_Table_t table;
+	AppExposureMemory_Table_t copy;
+	AppExposureMemory_Time_t time = Test_Time("2026-03-14_09-00-00");
+
+	AppExposureMemory_Init(&table);
+	TEST_ASSERT_TRUE(AppExposureMemory_IsValid(&table));
+	(void) AppExposureMemory_Store(&table, &time, 10000U, 6000);
+	TEST_ASSERT_TRUE(AppExposureMemory_IsValid(&table));
+
+	(void) memcpy(&copy, &table, sizeof(copy));
+	((uint8_t*) &copy.entries[9])[0] ^= 0x01U;
+	TEST_ASSERT_FALSE(AppExposureMemory_IsValid(&copy));
+
+	(void) memcpy(&copy, &table, sizeof(copy));
+	copy.bucket_count = 12U;
+	AppExposureMemory_Seal(&copy);
+	TEST_ASSERT_FALSE(AppExposureMemory_IsValid(&copy));
+}
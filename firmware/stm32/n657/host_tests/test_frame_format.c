@@ -0,0 +1,105 @@
+/*==============================================================================
+ * File: test_frame_format.c
+ *
+ * Purpose:
+ *   Unity unit tests for the AppFrameFormat module.
+ *
+ * Approach:
+ *   - Build tiny frames in both layouts with a known luma ramp and check that
+ *     the offset helper reads the same luma back from either.
+ *   - Check length-based detection at the live 224x224 size.
+ *==============================================================================*/
+
+#include "unity.h"
+#include "app_frame_format.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define TEST_FRAME_WIDTH  6U
+#define TEST_FRAME_HEIGHT 3U
+
+/*==============================================================================
+ * Test: test_FrameFormat_LumaOffset_ReadsSameLumaFromBothLayouts
+ *
+ * Expected:
+ *   A YUYV frame and a Y8 frame carrying the same luma return identical
+ *   samples for every pixel, including odd columns.
+ *==============================================================================*/
+void test_FrameFormat_LumaOffset_ReadsSameLumaFromBothLayouts(void) {
+	uint8_t yuv422[TEST_FRAME_WIDTH * TEST_FRAME_HEIGHT * 2U];
+	uint8_t y8[TEST_FRAME_WIDTH * TEST_FRAME_HEIGHT];
+	size_t x = 0U;
+	size_t y = 0U;
+
+	for (y = 0U; y < TEST_FRAME_HEIGHT; y++) {
+		for (x = 0U; x < TEST_FRAME_WIDTH; x += 2U) {
+			const size_t pair = ((y * TEST_FRAME_WIDTH) + x) * 2U;
+			const uint8_t luma0 = (uint8_t) ((y * 40U) + x);
+			const uint8_t luma1 = (uint8_t) ((y * 40U) + x + 1U);
+
+			yuv422[pair + 0U] = luma0;
+			yuv422[pair + 1U] = 0x80U;
+			yuv422[pair + 2U] = luma1;
+			yuv422[pair + 3U] = 0x7FU;
+			y8[(y * TEST_FRAME_WIDTH) + x] = luma0;
+			y8[(y * TEST_FRAME_WIDTH) + x + 1U] = luma1;
+		}
+	}
+
+	for (y = 0U; y < TEST_FRAME_HEIGHT; y++) {
+		for (x = 0U; x < TEST_FRAME_WIDTH; x++) {
+			TEST_ASSERT_EQUAL_UINT8(
+					yuv422[AppFrameFormat_LumaOffset(APP_FRAME_FORMAT_YUV422,
+							TEST_FRAME_WIDTH, x, y)],
+					y8[AppFrameFormat_LumaOffset(APP_FRAME_FORMAT_Y8,
+							TEST_FRAME_WIDTH, x, y)]);
+		}
+	}
+}
+
+/*==============================================================================
+ * Test: test_FrameFormat_FromLength_TellsLayoutsApart
+ *
+ * Expected:
+ *   At 224x224 a 100352-byte frame is YUV422, a 50176-byte frame is Y8 and
+ *   anything shorter is rejected; Y8 frames are exactly half the size.
+ *==============================================================================*/
+void test_FrameFormat_FromLength_TellsLayoutsApart(void) {
+	AppFrameFormat_t format = APP_FRAME_FORMAT_YUV422;
+
+	TEST_ASSERT_EQUAL_UINT32(100352U,
+			(uint32_t) AppFrameFormat_FrameBytes(APP_FRAME_FORMAT_YUV422, 224U,
+					224U));
+	TEST_ASSERT_EQUAL_UINT32(50176U,
+			(uint32_t) AppFrameFormat_FrameBytes(APP_FRAME_FORMAT_Y8, 224U,
+					224U));
+
+	TEST_ASSERT_TRUE(AppFrameFormat_FromLength(224U, 224U, 100352U, &format));
+	TEST_ASSERT_EQUAL_INT(APP_FRAME_FORMAT_YUV422, format);
+	TEST_ASSERT_TRUE(AppFrameFormat_FromLength(224U, 224U, 50176U, &format));
+	TEST_ASSERT_EQUAL_INT(APP_FRAME_FORMAT_Y8, format);
+	TEST_ASSERT_FALSE(AppFrameFormat_FromLength(224U, 224U, 50175U, &format));
+}
+
+/*==============================================================================
+ * Test: test_FrameFormat_Parse_AcceptsDeploymentFileContents
+ *
+ * Expected:
+ *   Selections written by hand on a PC (mixed case, CRLF, NUL padding) parse;
+ *   anything else is rejected so a typo keeps the default format.
+ *==============================================================================*/
+void test_FrameFormat_Parse_AcceptsDeploymentFileContents(void) {
+	const char padded[] = { 'Y', '8', '\r', '\n', '\0', '\0' };
+	AppFrameFormat_t format = APP_FRAME_FORMAT_YUV422;
+
+	TEST_ASSERT_TRUE(AppFrameFormat_Parse(padded, sizeof(padded), &format));
+	TEST_ASSERT_EQUAL_INT(APP_FRAME_FORMAT_Y8, format);
+	TEST_ASSERT_TRUE(AppFrameFormat_Parse(" yuv422 ", 8U, &format));
+	TEST_ASSERT_EQUAL_INT(APP_FRAME_FORMAT_YUV422, format);
+	TEST_ASSERT_EQUAL_STRING("y8",
+			AppFrameFormat_FileExtension(APP_FRAME_FORMAT_Y8));
+
+	TEST_ASSERT_FALSE(AppFrameFormat_Parse("y16", 3U, &format));
+	TEST_ASSERT_FALSE(AppFrameFormat_Parse("", 0U, &format));
+}
@@ -0,0 +1,209 @@
+/*==============================================================================
+ * File: test_frame_ingest.c
+ *
+ * Purpose:
+ *   Unity unit tests for the one-pass AppFrameIngest frame descriptor.
+ *
+ * Approach:
+ *   - Build small YUV422 and Y8 frames and check every descriptor field
+ *     against a plain per-field scan of the same bytes.
+ *==============================================================================*/
+
+#include "unity.h"
+#include "app_frame_ingest.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#define TEST_FRAME_WIDTH   24U
+#define TEST_FRAME_HEIGHT  16U
+
+static uint8_t test_frame[TEST_FRAME_WIDTH * TEST_FRAME_HEIGHT * 2U];
+static AppFrameIngest_Descriptor_t test_descriptor;
+
+static void FrameIngest_TestFill(size_t length_bytes) {
+	for (size_t index = 0U; index < length_bytes; index++) {
+		test_frame[index] = (uint8_t) ((index * 37U) ^ (index >> 3U));
+	}
+	test_frame[5] = 0U;
+	test_frame[9] = 0U;
+}
+
+static AppFrameIngest_Config_t FrameIngest_TestConfig(void) {
+	AppFrameIngest_Config_t config;
+
+	config.crop_x_min = 3U;
+	config.crop_y_min = 2U;
+	config.crop_x_end = 20U;
+	config.crop_y_end = 13U;
+	config.crop_step = 2U;
+	config.crop_bright_level = 180U;
+	return config;
+}
+
+/*==============================================================================
+ * Test: test_FrameIngest_Run_MatchesSeparateYuv422Scans
+ *
+ * Expected:
+ *   Non-zero count, luma sum, range and histogram, chroma sums and ranges,
+ *   the hash, the crop profile and the 8x8 block thumbnail all equal what a
+ *   separate scan per field computes.
+ *==============================================================================*/
+void test_FrameIngest_Run_MatchesSeparateYuv422Scans(void) {
+	const size_t length = sizeof(test_frame);
+	const AppFrameIngest_Config_t config = FrameIngest_TestConfig();
+	uint32_t histogram[APP_FRAME_INGEST_HISTOGRAM_BINS] = { 0U };
+	uint32_t nonzero = 0U;
+	uint64_t luma_sum = 0U;
+	uint64_t u_sum = 0U;
+	uint64_t v_sum = 0U;
+	uint8_t min_y = 0xFFU;
+	uint8_t max_y = 0U;
+	uint8_t min_u = 0xFFU;
+	uint8_t max_v = 0U;
+	uint64_t crop_sum = 0U;
+	uint32_t crop_count = 0U;
+	uint32_t crop_bright = 0U;
+	uint32_t block = 0U;
+
+	FrameIngest_TestFill(length);
+	TEST_ASSERT_TRUE(AppFrameIngest_Run(test_frame, length, TEST_FRAME_WIDTH,
+			TEST_FRAME_HEIGHT, &config, &test_descriptor));
+
+	for (size_t index = 0U; index < length; index++) {
+		nonzero += (test_frame[index] != 0U) ? 1U : 0U;
+	}
+	for (size_t pixel = 0U; pixel < (TEST_FRAME_WIDTH * TEST_FRAME_HEIGHT);
+			pixel++) {
+		const uint8_t luma = test_frame[pixel * 2U];
+		const uint8_t chroma = test_frame[(pixel * 2U) + 1U];
+
+		histogram[luma]++;
+		luma_sum += luma;
+		min_y = (luma < min_y) ? luma : min_y;
+		max_y = (luma > max_y) ? luma : max_y;
+		if ((pixel % 2U) == 0U) {
+			u_sum += chroma;
+			min_u = (chroma < min_u) ? chroma : min_u;
+		} else {
+			v_sum += chroma;
+			max_v = (chroma > max_v) ? chroma : max_v;
+		}
+	}
+	for (size_t y = config.crop_y_min; y < config.crop_y_end; y += 2U) {
+		for (size_t x = config.crop_x_min; x < config.crop_x_end; x += 2U) {
+			const uint8_t luma = test_frame[((y * TEST_FRAME_WIDTH) + x) * 2U];
+
+			crop_sum += luma;
+			crop_count++;
+			crop_bright += (luma >= 180U) ? 1U : 0U;
+		}
+	}
+	/* Thumbnail pixel (1, 1): luma mean of rows 8..15, columns 8..15. */
+	for (size_t y = 8U; y < 16U; y++) {
+		for (size_t x = 8U; x < 16U; x++) {
+			block += test_frame[((y * TEST_FRAME_WIDTH) + x) * 2U];
+		}
+	}
+
+	TEST_ASSERT_TRUE(test_descriptor.valid);
+	TEST_ASSERT_EQUAL_INT(APP_FRAME_FORMAT_YUV422, test_descriptor.format);
+	TEST_ASSERT_EQUAL_UINT32(nonzero, test_descriptor.nonzero_bytes);
+	TEST_ASSERT_TRUE(AppFrameIngest_Hash(test_frame, length)
+			== test_descriptor.content_hash);
+	TEST_ASSERT_EQUAL_UINT32(TEST_FRAME_WIDTH * TEST_FRAME_HEIGHT,
+			test_descriptor.luma_count);
+	TEST_ASSERT_TRUE(luma_sum == test_descriptor.luma_sum);
+	TEST_ASSERT_EQUAL_UINT8(min_y, test_descriptor.min_y);
+	TEST_ASSERT_EQUAL_UINT8(max_y, test_descriptor.max_y);
+	TEST_ASSERT_EQUAL_UINT32_ARRAY(histogram, test_descriptor.luma_histogram,
+			APP_FRAME_INGEST_HISTOGRAM_BINS);
+	TEST_ASSERT_EQUAL_UINT32(TEST_FRAME_WIDTH * TEST_FRAME_HEIGHT / 2U,
+			test_descriptor.chroma_pair_count);
+	TEST_ASSERT_TRUE(u_sum == test_descriptor.u_sum);
+	TEST_ASSERT_TRUE(v_sum == test_descriptor.v_sum);
+	TEST_ASSERT_EQUAL_UINT8(min_u, test_descriptor.min_u);
+	TEST_ASSERT_EQUAL_UINT8(max_v, test_descriptor.max_v);
+	TEST_ASSERT_EQUAL_UINT32(crop_count, test_descriptor.crop_sample_count);
+	TEST_ASSERT_EQUAL_UINT32(crop_bright, test_descriptor.crop_bright_count);
+	TEST_ASSERT_TRUE(crop_sum == test_descriptor.crop_luma_sum);
+	TEST_ASSERT_EQUAL_UINT32(3U, test_descriptor.thumbnail_width);
+	TEST_ASSERT_EQUAL_UINT32(2U, test_descriptor.thumbnail_height);
+	TEST_ASSERT_EQUAL_UINT8((block + 32U) / 64U, test_descriptor.thumbnail[4]);
+}
+
+/*==============================================================================
+ * Test: test_FrameIngest_Run_HandlesY8AndUnalignedStride
+ *
+ * Expected:
+ *   A Y8 frame whose width is not a multiple of four still counts every
+ *   pixel, reports no chroma and hashes exactly the pixel bytes even though
+ *   the words no longer line up with rows.
+ *==============================================================================*/
+void test_FrameIngest_Run_HandlesY8AndUnalignedStride(void) {
+	const size_t width = 10U;
+	const size_t height = 9U;
+	const size_t length = width * height;
+	AppFrameIngest_Config_t config = FrameIngest_TestConfig();
+	uint64_t luma_sum = 0U;
+	uint32_t nonzero = 0U;
+
+	config.crop_x_end = 10U;
+	config.crop_y_end = 9U;
+	FrameIngest_TestFill(length);
+	TEST_ASSERT_TRUE(AppFrameIngest_Run(test_frame, length, width, height,
+			&config, &test_descriptor));
+
+	for (size_t index = 0U; index < length; index++) {
+		luma_sum += test_frame[index];
+		nonzero += (test_frame[index] != 0U) ? 1U : 0U;
+	}
+	TEST_ASSERT_EQUAL_INT(APP_FRAME_FORMAT_Y8, test_descriptor.format);
+	TEST_ASSERT_TRUE(luma_sum == test_descriptor.luma_sum);
+	TEST_ASSERT_EQUAL_UINT32(nonzero, test_descriptor.nonzero_bytes);
+	TEST_ASSERT_EQUAL_UINT32(0U, test_descriptor.chroma_pair_count);
+	TEST_ASSERT_TRUE(AppFrameIngest_Hash(test_frame, length)
+			== test_descriptor.content_hash);
+	TEST_ASSERT_EQUAL_UINT32(1U, test_descriptor.thumbnail_width);
+	TEST_ASSERT_EQUAL_UINT32(1U, test_descriptor.thumbnail_height);
+	TEST_ASSERT_EQUAL_UINT32(16U, test_descriptor.crop_sample_count);
+
+	/* Changing one byte changes the hash. */
+	test_frame[length - 1U] ^= 1U;
+	TEST_ASSERT_FALSE(AppFrameIngest_Hash(test_frame, length)
+			== test_descriptor.content_hash);
+}
+
+/*==============================================================================
+ * Test: test_FrameIngest_Run_RejectsBadInputAndMatchesOnlyItsBuffer
+ *
+ * Expected:
+ *   A short buffer or a crop outside the frame leaves the descriptor
+ *   invalid; a valid descriptor only describes its own buffer and length.
+ *==============================================================================*/
+void test_FrameIngest_Run_RejectsBadInputAndMatchesOnlyItsBuffer(void) {
+	const size_t length = sizeof(test_frame);
+	AppFrameIngest_Config_t config = FrameIngest_TestConfig();
+
+	FrameIngest_TestFill(length);
+	TEST_ASSERT_FALSE(AppFrameIngest_Run(test_frame, 10U, TEST_FRAME_WIDTH,
+			TEST_FRAME_HEIGHT, &config, &test_descriptor));
+	TEST_ASSERT_FALSE(test_descriptor.valid);
+	config.crop_x_end = TEST_FRAME_WIDTH + 1U;
+	TEST_ASSERT_FALSE(AppFrameIngest_Run(test_frame, length, TEST_FRAME_WIDTH,
+			TEST_FRAME_HEIGHT, &config, &test_descriptor));
+	TEST_ASSERT_FALSE(AppFrameIngest_Describes(&test_descriptor, test_frame,
+			length));
+
+	config = FrameIngest_TestConfig();
+	TEST_ASSERT_TRUE(AppFrameIngest_Run(test_frame, length, TEST_FRAME_WIDTH,
+			TEST_FRAME_HEIGHT, &config, &test_descriptor));
+	TEST_ASSERT_TRUE(AppFrameIngest_Describes(&test_descriptor, test_frame,
+			length));
+	TEST_ASSERT_FALSE(AppFrameIngest_Describes(&test_descriptor, test_frame,
+			length - 2U));
+	TEST_ASSERT_FALSE(AppFrameIngest_Describes(&test_descriptor,
+			&test_frame[2], length));
+	TEST_ASSERT_FALSE(AppFrameIngest_Describes(NULL, test_frame, length));
+}
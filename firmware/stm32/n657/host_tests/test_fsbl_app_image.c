@@ -0,0 +1,160 @@
+/*==============================================================================
+ * File: test_fsbl_app_image.c
+ *
+ * Purpose:
+ *   Unity unit tests for the FSBL application image header module.
+ *
+ * Approach:
+ *   - Build headers byte-for-byte the way tools/make_app_image_header.py
+ *     packs them, then parse them back with the FSBL's expectations.
+ *   - Copy into a buffer with guard bytes to catch overruns on odd sizes.
+ *==============================================================================*/
+
+#include "unity.h"
+#include "fsbl_app_image.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define TEST_LOAD_ADDRESS  (0x34000400UL)
+#define TEST_MAX_SIZE      (0x80000UL)
+
+/*==============================================================================
+ * Function: Test_PutLe32
+ *
+ * Purpose:
+ *   Store a little-endian word, as struct.pack("<I") does.
+ *==============================================================================*/
+static void Test_PutLe32(uint8_t *bytes, uint32_t value) {
+	bytes[0] = (uint8_t) value;
+	bytes[1] = (uint8_t) (value >> 8);
+	bytes[2] = (uint8_t) (value >> 16);
+	bytes[3] = (uint8_t) (value >> 24);
+}
+
+/*==============================================================================
+ * Function: Test_BuildHeader
+ *
+ * Purpose:
+ *   Pack a version-1 header for an image and seal it with the header CRC.
+ *==============================================================================*/
+static void Test_BuildHeader(uint8_t header[FSBL_APP_IMAGE_HEADER_SIZE],
+		uint32_t load_address, uint32_t image_size, uint32_t image_crc) {
+	memset(header, 0, FSBL_APP_IMAGE_HEADER_SIZE);
+	Test_PutLe32(&header[0], FSBL_APP_IMAGE_MAGIC);
+	header[4] = (uint8_t) FSBL_APP_IMAGE_VERSION;
+	header[6] = (uint8_t) FSBL_APP_IMAGE_HEADER_SIZE;
+	Test_PutLe32(&header[8], load_address);
+	Test_PutLe32(&header[12], image_size);
+	Test_PutLe32(&header[16], image_crc);
+	Test_PutLe32(&header[28], FsblAppImage_Crc32Update(0U, header, 28U));
+}
+
+/*==============================================================================
+ * Test: test_FsblAppImage_Crc32_MatchesZlib
+ *
+ * Expected:
+ *   The standard check value for "123456789" (what zlib.crc32 gives the
+ *   host tool), and the same result when the data is fed in pieces.
+ *==============================================================================*/
+void test_FsblAppImage_Crc32_MatchesZlib(void) {
+	const char *check = "123456789";
+	uint32_t crc = 0U;
+
+	TEST_ASSERT_EQUAL_HEX32(0xCBF43926UL,
+			FsblAppImage_Crc32Update(0U, check, 9U));
+
+	crc = FsblAppImage_Crc32Update(0U, check, 4U);
+	crc = FsblAppImage_Crc32Update(crc, check + 4, 5U);
+	TEST_ASSERT_EQUAL_HEX32(0xCBF43926UL, crc);
+	TEST_ASSERT_EQUAL_HEX32(0U, FsblAppImage_Crc32Update(0U, check, 0U));
+}
+
+/*==============================================================================
+ * Test: test_FsblAppImage_ParseHeader_AcceptsToolOutput
+ *
+ * Expected:
+ *   A well-formed header decodes to the packed size and CRC.
+ *==============================================================================*/
+void test_FsblAppImage_ParseHeader_AcceptsToolOutput(void) {
+	uint8_t bytes[FSBL_APP_IMAGE_HEADER_SIZE];
+	FsblAppImage_Header_t header = { 0 };
+
+	Test_BuildHeader(bytes, TEST_LOAD_ADDRESS, 301457U, 0x1234ABCDUL);
+
+	TEST_ASSERT_EQUAL_INT(FSBL_APP_IMAGE_OK,
+			FsblAppImage_ParseHeader(bytes, sizeof(bytes), TEST_LOAD_ADDRESS,
+					TEST_MAX_SIZE, &header));
+	TEST_ASSERT_EQUAL_HEX32(TEST_LOAD_ADDRESS, header.load_address);
+	TEST_ASSERT_EQUAL_UINT32(301457U, header.image_size);
+	TEST_ASSERT_EQUAL_HEX32(0x1234ABCDUL, header.image_crc32);
+}
+
+/*==============================================================================
+ * Test: test_FsblAppImage_ParseHeader_RejectsBadHeaders
+ *
+ * Expected:
+ *   A blank sector reads as ERASED (legacy layout); a wrong magic, a flipped
+ *   bit, the wrong load address or an oversized image are each refused.
+ *==============================================================================*/
+void test_FsblAppImage_ParseHeader_RejectsBadHeaders(void) {
+	uint8_t bytes[FSBL_APP_IMAGE_HEADER_SIZE];
+	FsblAppImage_Header_t header = { 0 };
+
+	memset(bytes, 0xFF, sizeof(bytes));
+	TEST_ASSERT_EQUAL_INT(FSBL_APP_IMAGE_ERASED,
+			FsblAppImage_ParseHeader(bytes, sizeof(bytes), TEST_LOAD_ADDRESS,
+					TEST_MAX_SIZE, &header));
+
+	Test_BuildHeader(bytes, TEST_LOAD_ADDRESS, 4096U, 0U);
+	bytes[0] ^= 0x01U;
+	TEST_ASSERT_EQUAL_INT(FSBL_APP_IMAGE_BAD_MAGIC,
+			FsblAppImage_ParseHeader(bytes, sizeof(bytes), TEST_LOAD_ADDRESS,
+					TEST_MAX_SIZE, &header));
+
+	Test_BuildHeader(bytes, TEST_LOAD_ADDRESS, 4096U, 0U);
+	bytes[13] ^= 0x40U;
+	TEST_ASSERT_EQUAL_INT(FSBL_APP_IMAGE_BAD_HEADER_CRC,
+			FsblAppImage_ParseHeader(bytes, sizeof(bytes), TEST_LOAD_ADDRESS,
+					TEST_MAX_SIZE, &header));
+
+	Test_BuildHeader(bytes, 0x34100000UL, 4096U, 0U);
+	TEST_ASSERT_EQUAL_INT(FSBL_APP_IMAGE_BAD_LOAD_ADDRESS,
+			FsblAppImage_ParseHeader(bytes, sizeof(bytes), TEST_LOAD_ADDRESS,
+					TEST_MAX_SIZE, &header));
+
+	Test_BuildHeader(bytes, TEST_LOAD_ADDRESS, TEST_MAX_SIZE + 4U, 0U);
+	TEST_ASSERT_EQUAL_INT(FSBL_APP_IMAGE_BAD_SIZE,
+			FsblAppImage_ParseHeader(bytes, sizeof(bytes), TEST_LOAD_ADDRESS,
+					TEST_MAX_SIZE, &header));
+	TEST_ASSERT_EQUAL_STRING("bad size",
+			FsblAppImage_StatusName(FSBL_APP_IMAGE_BAD_SIZE));
+}
+
+/*==============================================================================
+ * Test: test_FsblAppImage_CopyWithCrc_CopiesExactlyTheImage
+ *
+ * Expected:
+ *   An image that is not a whole number of bursts is copied byte-exact,
+ *   nothing past its end is written, and the returned CRC equals the CRC
+ *   of the source image.
+ *==============================================================================*/
+void test_FsblAppImage_CopyWithCrc_CopiesExactlyTheImage(void) {
+	static uint32_t src_words[260];
+	static uint32_t dst_words[260];
+	const size_t image_size = 1000U + 3U;
+	uint8_t *dst = (uint8_t *) dst_words;
+	uint32_t crc = 0U;
+
+	for (size_t i = 0U; i < 260U; i++) {
+		src_words[i] = (uint32_t) (i * 2654435761UL);
+	}
+	memset(dst_words, 0xA5, sizeof(dst_words));
+
+	crc = FsblAppImage_CopyWithCrc(dst_words, src_words, image_size);
+
+	TEST_ASSERT_EQUAL_MEMORY(src_words, dst_words, image_size);
+	TEST_ASSERT_EQUAL_HEX8(0xA5U, dst[image_size]);
+	TEST_ASSERT_EQUAL_HEX32(
+			FsblAppImage_Crc32Update(0U, src_words, image_size), crc);
+}
@@ -0,0 +1,146 @@
+/*==============================================================================
+ * File: test_luma_stats.c
+ *
+ * Purpose:
+ *   Unity unit tests for the AppLumaStats brightness-gate summaries.
+ *
+ * Approach:
+ *   - Feed hand-built DCMIPP threshold bins and check that min, max and the
+ *     bright count bound the true frame the way the gate needs.
+ *   - Compare the strided crop sample with the full scan on small frames.
+ *==============================================================================*/
+
+#include "unity.h"
+#include "app_luma_stats.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#define TEST_FRAME_WIDTH   16U
+#define TEST_FRAME_HEIGHT   8U
+#define TEST_FRAME_BPP      2U
+
+/*==============================================================================
+ * Test: test_LumaStats_FromIspBins_BoundsUniformFrames
+ *
+ * Expected:
+ *   A frame of luma 200 reports min >= 192, max <= 224 and no bright pixels
+ *   at level 220 (the 225 edge holds none); a frame of luma 10 reports
+ *   8..15.
+ *==============================================================================*/
+void test_LumaStats_FromIspBins_BoundsUniformFrames(void) {
+	const uint32_t bright_bins[APP_LUMA_STATS_ISP_BINS] = { 0U, 0U, 0U, 0U,
+			0U, 0U, 1000U, 1000U, 0U, 0U, 0U, 0U };
+	const uint32_t dark_bins[APP_LUMA_STATS_ISP_BINS] = { 0U, 0U, 1000U, 1000U,
+			1000U, 1000U, 0U, 0U, 0U, 0U, 0U, 0U };
+	AppLumaStats_t stats;
+
+	TEST_ASSERT_TRUE(AppLumaStats_FromIspBins(bright_bins, 200U, 220U, &stats));
+	TEST_ASSERT_EQUAL_UINT32(1000U, stats.sample_count);
+	TEST_ASSERT_EQUAL_UINT32(0U, stats.bright_sample_count);
+	TEST_ASSERT_EQUAL_UINT8(192U, stats.min_y);
+	TEST_ASSERT_EQUAL_UINT8(224U, stats.max_y);
+	TEST_ASSERT_EQUAL_UINT32(200U, stats.mean_y);
+
+	TEST_ASSERT_TRUE(AppLumaStats_FromIspBins(dark_bins, 10U, 220U, &stats));
+	TEST_ASSERT_EQUAL_UINT32(1000U, stats.sample_count);
+	TEST_ASSERT_EQUAL_UINT8(8U, stats.min_y);
+	TEST_ASSERT_EQUAL_UINT8(15U, stats.max_y);
+}
+
+/*==============================================================================
+ * Test: test_LumaStats_FromIspBins_ScalesAndRejects
+ *
+ * Expected:
+ *   Counts near 2^32 are scaled together so bright * 100 cannot overflow,
+ *   the 64..127 and saturated halves report min 64 and max 255, and empty or non-monotonic bins are
+ *   rejected.
+ *==============================================================================*/
+void test_LumaStats_FromIspBins_ScalesAndRejects(void) {
+	const uint32_t saturated_bins[APP_LUMA_STATS_ISP_BINS] = { 0U, 0U, 0U, 0U,
+			0U, 0x80000000UL, 0x80000000UL, 0x80000000UL, 0x80000000UL,
+			0x80000000UL, 0x80000000UL, 0x80000000UL };
+	const uint32_t empty_bins[APP_LUMA_STATS_ISP_BINS] = { 0U };
+	const uint32_t broken_bins[APP_LUMA_STATS_ISP_BINS] = { 0U, 0U, 5U, 3U, 3U,
+			3U, 1U, 0U, 0U, 0U, 0U, 0U };
+	AppLumaStats_t stats;
+
+	TEST_ASSERT_TRUE(AppLumaStats_FromIspBins(saturated_bins, 128U, 220U,
+			&stats));
+	TEST_ASSERT_TRUE(stats.sample_count <= 0x00FFFFFFUL);
+	TEST_ASSERT_EQUAL_UINT32(stats.sample_count / 2U,
+			stats.bright_sample_count);
+	TEST_ASSERT_EQUAL_UINT8(64U, stats.min_y);
+	TEST_ASSERT_EQUAL_UINT8(255U, stats.max_y);
+
+	TEST_ASSERT_FALSE(AppLumaStats_FromIspBins(empty_bins, 0U, 220U, &stats));
+	TEST_ASSERT_FALSE(AppLumaStats_FromIspBins(broken_bins, 0U, 220U, &stats));
+}
+
+/*==============================================================================
+ * Test: test_LumaStats_SampleRegion_StridedMatchesFullScan
+ *
+ * Expected:
+ *   On a frame whose luma only changes every four pixels, the step-4 sample
+ *   reads 1/16 of the pixels and reports the same mean, extremes and bright
+ *   ratio as the full scan; a region past the frame is rejected.
+ *==============================================================================*/
+void test_LumaStats_SampleRegion_StridedMatchesFullScan(void) {
+	uint8_t frame[TEST_FRAME_WIDTH * TEST_FRAME_HEIGHT * TEST_FRAME_BPP];
+	uint32_t histogram[APP_LUMA_STATS_HISTOGRAM_BINS];
+	AppLumaStats_Region_t region = { .width_pixels = TEST_FRAME_WIDTH,
+			.bytes_per_pixel = TEST_FRAME_BPP, .x_min = 0U, .y_min = 0U,
+			.x_end = TEST_FRAME_WIDTH, .y_end = TEST_FRAME_HEIGHT };
+	AppLumaStats_t full;
+	AppLumaStats_t strided;
+
+	for (uint32_t y = 0U; y < TEST_FRAME_HEIGHT; y++) {
+		for (uint32_t x = 0U; x < TEST_FRAME_WIDTH; x++) {
+			const uint32_t offset = (y * TEST_FRAME_WIDTH + x) * TEST_FRAME_BPP;
+
+			frame[offset] = (uint8_t) (((x / 4U) + (y / 4U)) * 50U + 20U);
+			frame[offset + 1U] = 0x80U;
+		}
+	}
+
+	TEST_ASSERT_TRUE(AppLumaStats_SampleRegion(frame, sizeof(frame), &region,
+			1U, 200U, &full, NULL));
+	TEST_ASSERT_TRUE(AppLumaStats_SampleRegion(frame, sizeof(frame), &region,
+			4U, 200U, &strided, histogram));
+
+	TEST_ASSERT_EQUAL_UINT32(full.sample_count / 16U, strided.sample_count);
+	TEST_ASSERT_EQUAL_UINT32(full.mean_y, strided.mean_y);
+	TEST_ASSERT_EQUAL_UINT8(full.min_y, strided.min_y);
+	TEST_ASSERT_EQUAL_UINT8(full.max_y, strided.max_y);
+	TEST_ASSERT_EQUAL_UINT32(full.bright_sample_count / 16U,
+			strided.bright_sample_count);
+	TEST_ASSERT_EQUAL_UINT32(1U, histogram[20U]);
+	TEST_ASSERT_EQUAL_UINT32(1U, histogram[220U]);
+
+	region.y_end = TEST_FRAME_HEIGHT + 1U;
+	TEST_ASSERT_FALSE(AppLumaStats_SampleRegion(frame, sizeof(frame), &region,
+			4U, 200U, &strided, NULL));
+}
+
+/*==============================================================================
+ * Test: test_LumaStats_AnyNonZero_StopsOnStrideHits
+ *
+ * Expected:
+ *   An all-zero buffer reads as empty, a word on the stride or a byte in the
+ *   sub-word tail reads as written.
+ *==============================================================================*/
+void test_LumaStats_AnyNonZero_StopsOnStrideHits(void) {
+	uint8_t buffer[67];
+
+	(void) memset(buffer, 0, sizeof(buffer));
+	TEST_ASSERT_FALSE(AppLumaStats_AnyNonZero(buffer, sizeof(buffer), 4U));
+
+	buffer[8U * sizeof(uint32_t) + 3U] = 1U;
+	TEST_ASSERT_TRUE(AppLumaStats_AnyNonZero(buffer, sizeof(buffer), 4U));
+
+	(void) memset(buffer, 0, sizeof(buffer));
+	buffer[sizeof(buffer) - 1U] = 1U;
+	TEST_ASSERT_TRUE(AppLumaStats_AnyNonZero(buffer, sizeof(buffer), 4U));
+	TEST_ASSERT_FALSE(AppLumaStats_AnyNonZero(buffer, sizeof(buffer), 0U));
+}
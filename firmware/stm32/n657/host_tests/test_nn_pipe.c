@@ -0,0 +1,128 @@
+/*==============================================================================
+ * File: test_nn_pipe.c
+ *
+ * Purpose:
+ *   Unity unit tests for the AppNnPipe layout planner and quantization map.
+ *
+ * Approach:
+ *   - Plan the training crop of the 224x224 capture for a 224x224 model and
+ *     check the sensor ROI, letterbox and DMA alignment against the values
+ *     the CPU resize produces.
+ *   - Build the byte map for the common tensor encodings and quantize a
+ *     short buffer in place.
+ *==============================================================================*/
+
+#include "unity.h"
+#include "app_nn_pipe.h"
+
+#include <stdint.h>
+#include <string.h>
+
+static AppNnPipe_Request_t training_request(void) {
+	AppNnPipe_Request_t request;
+
+	(void) memset(&request, 0, sizeof(request));
+	request.window_width = 2592U;
+	request.window_height = 1944U;
+	request.frame_width = 224U;
+	request.frame_height = 224U;
+	request.crop_x = 23U;
+	request.crop_y = 57U;
+	request.crop_width = 155U;
+	request.crop_height = 123U;
+	request.model_width = 224U;
+	request.model_height = 224U;
+	request.align_bytes = 16U;
+	return request;
+}
+
+/*==============================================================================
+ * Test: test_NnPipe_PlanLayout_LetterboxesLikeCpuResize
+ *
+ * Expected:
+ *   The wide training crop fills the model width and is centred vertically
+ *   (224x178, 23 rows of padding) with a 16-byte aligned start; the ROI is
+ *   the crop scaled into the sensor window. A model row or letterbox start
+ *   that is not aligned is refused, as is a crop outside the frame.
+ *==============================================================================*/
+void test_NnPipe_PlanLayout_LetterboxesLikeCpuResize(void) {
+	AppNnPipe_Request_t request = training_request();
+	AppNnPipe_Layout_t layout;
+
+	TEST_ASSERT_EQUAL_INT(APP_NN_PIPE_OK,
+			AppNnPipe_PlanLayout(&request, &layout));
+	TEST_ASSERT_EQUAL_UINT32(266U, layout.roi_x);
+	TEST_ASSERT_EQUAL_UINT32(494U, layout.roi_y);
+	TEST_ASSERT_EQUAL_UINT32(1793U, layout.roi_width);
+	TEST_ASSERT_EQUAL_UINT32(1067U, layout.roi_height);
+	TEST_ASSERT_EQUAL_UINT32(224U, layout.output_width);
+	TEST_ASSERT_EQUAL_UINT32(178U, layout.output_height);
+	TEST_ASSERT_EQUAL_UINT32(0U, layout.pad_x);
+	TEST_ASSERT_EQUAL_UINT32(23U, layout.pad_y);
+	TEST_ASSERT_EQUAL_UINT32(672U, layout.pitch_bytes);
+	TEST_ASSERT_EQUAL_UINT32(15456U, layout.write_offset_bytes);
+	TEST_ASSERT_EQUAL_UINT32(224U * 224U * 3U, layout.tensor_bytes);
+
+	request.crop_y = 0U;
+	request.crop_width = 100U;
+	request.crop_height = 200U;
+	TEST_ASSERT_EQUAL_INT(APP_NN_PIPE_OFFSET_UNALIGNED,
+			AppNnPipe_PlanLayout(&request, &layout));
+	TEST_ASSERT_EQUAL_UINT32(56U, layout.pad_x);
+	TEST_ASSERT_EQUAL_UINT32(168U, layout.write_offset_bytes);
+
+	request = training_request();
+	request.model_width = 100U;
+	TEST_ASSERT_EQUAL_INT(APP_NN_PIPE_PITCH_UNALIGNED,
+			AppNnPipe_PlanLayout(&request, &layout));
+
+	request = training_request();
+	request.crop_x = 100U;
+	TEST_ASSERT_EQUAL_INT(APP_NN_PIPE_BAD_REQUEST,
+			AppNnPipe_PlanLayout(&request, &layout));
+	TEST_ASSERT_EQUAL_INT(APP_NN_PIPE_BAD_REQUEST,
+			AppNnPipe_PlanLayout(NULL, &layout));
+	TEST_ASSERT_EQUAL_STRING("offset-unaligned",
+			AppNnPipe_StatusName(APP_NN_PIPE_OFFSET_UNALIGNED));
+}
+
+/*==============================================================================
+ * Test: test_NnPipe_Quant_PicksCheapestMap
+ *
+ * Expected:
+ *   uint8 at 1/255 is a plain copy, int8 at 1/255 with zero point -128 is a
+ *   sign flip, anything else uses the table with half-away-from-zero
+ *   rounding and clamping. Quantizing in place gives the mapped bytes.
+ *==============================================================================*/
+void test_NnPipe_Quant_PicksCheapestMap(void) {
+	static AppNnPipe_Quant_t quant;
+	uint32_t words[2] = { 0U, 0U };
+	uint8_t *bytes = (uint8_t*) words;
+	const uint8_t image[7] = { 0U, 1U, 127U, 128U, 200U, 255U, 64U };
+
+	AppNnPipe_BuildQuant(1.0f / 255.0f, 0, true, &quant);
+	TEST_ASSERT_EQUAL_INT(APP_NN_PIPE_QUANT_COPY, quant.kind);
+
+	AppNnPipe_BuildQuant(1.0f / 255.0f, -128, false, &quant);
+	TEST_ASSERT_EQUAL_INT(APP_NN_PIPE_QUANT_FLIP_SIGN, quant.kind);
+	TEST_ASSERT_EQUAL_STRING("flip-sign", AppNnPipe_QuantKindName(quant.kind));
+	(void) memcpy(bytes, image, sizeof(image));
+	AppNnPipe_Quantize(&quant, bytes, bytes, sizeof(image));
+	for (uint32_t index = 0U; index < sizeof(image); index++) {
+		TEST_ASSERT_EQUAL_UINT8(quant.table[image[index]], bytes[index]);
+	}
+	TEST_ASSERT_EQUAL_UINT8(0x80U, bytes[0]);
+	TEST_ASSERT_EQUAL_UINT8(0x7FU, bytes[5]);
+
+	AppNnPipe_BuildQuant(2.0f / 255.0f, 0, true, &quant);
+	TEST_ASSERT_EQUAL_INT(APP_NN_PIPE_QUANT_TABLE, quant.kind);
+	TEST_ASSERT_EQUAL_UINT8(1U, quant.table[1]);
+	TEST_ASSERT_EQUAL_UINT8(127U, quant.table[254]);
+
+	AppNnPipe_BuildQuant(1.0f / 255.0f, 10, true, &quant);
+	TEST_ASSERT_EQUAL_INT(APP_NN_PIPE_QUANT_TABLE, quant.kind);
+	TEST_ASSERT_EQUAL_UINT8(10U, quant.table[0]);
+	TEST_ASSERT_EQUAL_UINT8(255U, quant.table[250]);
+	AppNnPipe_Quantize(&quant, image, bytes, sizeof(image));
+	TEST_ASSERT_EQUAL_UINT8(74U, bytes[6]);
+}
@@ -0,0 +1,191 @@
+/*==============================================================================
+ * File: test_npu_stage_context.c
+ *
+ * Purpose:
+ *   Unity unit tests for the AppNpuStageContext init-once table.
+ *
+ * Approach:
+ *   - Use dummy stage specs as keys, sign a fake instance snapshot, and
+ *     replay repeated inferences, an aborted run, a clobbered instance and a
+ *     full table.
+ *==============================================================================*/
+
+#include "unity.h"
+#include "app_npu_stage_context.h"
+
+#include <stdint.h>
+
+static const int test_obb_stage = 1;
+static const int test_other_stage = 2;
+
+/*==============================================================================
+ * Test: test_NpuStageContext_RepeatedInference_InitsOnceThenRearms
+ *
+ * Expected:
+ *   Each stage needs one full init on first use; afterwards every inference
+ *   is a re-arm, and init and re-arm timings are kept apart per stage.
+ *==============================================================================*/
+void test_NpuStageContext_RepeatedInference_InitsOnceThenRearms(void) {
+	AppNpuStageContext_Table_t table;
+	AppNpuStageContext_Reason_t reason = APP_NPU_STAGE_CONTEXT_REASON_NONE;
+	const uint32_t snapshot[3] = { 0x34100000U, 0U, 0x70400000U };
+	const uint32_t signature = AppNpuStageContext_Signature(snapshot, 3U);
+	const AppNpuStageContext_Entry_t *entry_ptr = NULL;
+
+	AppNpuStageContext_Init(&table);
+	TEST_ASSERT_EQUAL_INT(APP_NPU_STAGE_CONTEXT_FULL_INIT,
+			AppNpuStageContext_Plan(&table, &test_obb_stage, signature,
+					&reason));
+	TEST_ASSERT_EQUAL_INT(APP_NPU_STAGE_CONTEXT_REASON_FIRST_USE, reason);
+	TEST_ASSERT_TRUE(AppNpuStageContext_MarkInitialized(&table,
+			&test_obb_stage, signature, 5000U));
+	TEST_ASSERT_EQUAL_INT(APP_NPU_STAGE_CONTEXT_FULL_INIT,
+			AppNpuStageContext_Plan(&table, &test_other_stage, signature,
+					NULL));
+	TEST_ASSERT_TRUE(AppNpuStageContext_MarkInitialized(&table,
+			&test_other_stage, signature, 3000U));
+
+	for (uint32_t reading = 0U; reading < 10U; reading++) {
+		TEST_ASSERT_EQUAL_INT(APP_NPU_STAGE_CONTEXT_REARM,
+				AppNpuStageContext_Plan(&table, &test_obb_stage, signature,
+						&reason));
+		TEST_ASSERT_EQUAL_INT(APP_NPU_STAGE_CONTEXT_REASON_NONE, reason);
+		TEST_ASSERT_TRUE(AppNpuStageContext_RecordRearm(&table,
+				&test_obb_stage, 40U + reading));
+	}
+
+	entry_ptr = AppNpuStageContext_Get(&table, &test_obb_stage);
+	TEST_ASSERT_NOT_NULL(entry_ptr);
+	TEST_ASSERT_EQUAL_UINT32(1U, entry_ptr->init.count);
+	TEST_ASSERT_EQUAL_UINT32(5000U, entry_ptr->init.max_us);
+	TEST_ASSERT_EQUAL_UINT32(10U, entry_ptr->rearm.count);
+	TEST_ASSERT_EQUAL_UINT32(49U, entry_ptr->rearm.max_us);
+	TEST_ASSERT_EQUAL_UINT32(445U, (uint32_t) entry_ptr->rearm.total_us);
+	TEST_ASSERT_EQUAL_UINT32(0U,
+			AppNpuStageContext_Get(&table, &test_other_stage)->rearm.count);
+}
+
+/*==============================================================================
+ * Test: test_NpuStageContext_CorruptionAndInvalidate_ForceFullInit
+ *
+ * Expected:
+ *   A changed instance signature counts as an integrity failure and forces
+ *   a full init once; an explicit invalidate does the same without counting
+ *   as corruption; invalidate-all drops every live stage.
+ *==============================================================================*/
+void test_NpuStageContext_CorruptionAndInvalidate_ForceFullInit(void) {
+	AppNpuStageContext_Table_t table;
+	AppNpuStageContext_Reason_t reason = APP_NPU_STAGE_CONTEXT_REASON_NONE;
+	uint32_t snapshot[3] = { 0x34100000U, 0U, 0x70400000U };
+	uint32_t signature = AppNpuStageContext_Signature(snapshot, 3U);
+	uint32_t clobbered = 0U;
+
+	AppNpuStageContext_Init(&table);
+	(void) AppNpuStageContext_Plan(&table, &test_obb_stage, signature, NULL);
+	(void) AppNpuStageContext_MarkInitialized(&table, &test_obb_stage,
+			signature, 5000U);
+
+	snapshot[1] = 0x34180000U;
+	clobbered = AppNpuStageContext_Signature(snapshot, 3U);
+	TEST_ASSERT_TRUE(clobbered != signature);
+	TEST_ASSERT_EQUAL_INT(APP_NPU_STAGE_CONTEXT_FULL_INIT,
+			AppNpuStageContext_Plan(&table, &test_obb_stage, clobbered,
+					&reason));
+	TEST_ASSERT_EQUAL_INT(APP_NPU_STAGE_CONTEXT_REASON_CORRUPTED, reason);
+	TEST_ASSERT_EQUAL_UINT32(1U,
+			AppNpuStageContext_Get(&table, &test_obb_stage)->integrity_failures);
+	(void) AppNpuStageContext_MarkInitialized(&table, &test_obb_stage,
+			clobbered, 5100U);
+	TEST_ASSERT_EQUAL_INT(APP_NPU_STAGE_CONTEXT_REARM,
+			AppNpuStageContext_Plan(&table, &test_obb_stage, clobbered, NULL));
+
+	AppNpuStageContext_Invalidate(&table, &test_obb_stage);
+	TEST_ASSERT_EQUAL_INT(APP_NPU_STAGE_CONTEXT_FULL_INIT,
+			AppNpuStageContext_Plan(&table, &test_obb_stage, clobbered,
+					&reason));
+	TEST_ASSERT_EQUAL_INT(APP_NPU_STAGE_CONTEXT_REASON_INVALIDATED, reason);
+	TEST_ASSERT_EQUAL_UINT32(1U,
+			AppNpuStageContext_Get(&table, &test_obb_stage)->integrity_failures);
+
+	(void) AppNpuStageContext_MarkInitialized(&table, &test_obb_stage,
+			clobbered, 5000U);
+	AppNpuStageContext_InvalidateAll(&table);
+	TEST_ASSERT_FALSE(AppNpuStageContext_Get(&table, &test_obb_stage)->live);
+	TEST_ASSERT_EQUAL_UINT32(3U,
+			AppNpuStageContext_Get(&table, &test_obb_stage)->init.count);
+}
+
+/*==============================================================================
+ * Test: test_NpuStageContext_ZeroedTableAndOverflow_StaySafe
+ *
+ * Expected:
+ *   A zero-initialized table has nothing live; stages past the table size
+ *   always need a full init and cannot be recorded; a NULL key never
+ *   re-arms.
+ *==============================================================================*/
+void test_NpuStageContext_ZeroedTableAndOverflow_StaySafe(void) {
+	static AppNpuStageContext_Table_t table;
+	static const uint8_t keys[APP_NPU_STAGE_CONTEXT_MAX_STAGES + 1U] = { 0U };
+	AppNpuStageContext_Reason_t reason = APP_NPU_STAGE_CONTEXT_REASON_NONE;
+
+	TEST_ASSERT_NULL(AppNpuStageContext_Get(&table, &keys[0]));
+	TEST_ASSERT_FALSE(AppNpuStageContext_RecordRearm(&table, &keys[0], 1U));
+	for (uint32_t index = 0U; index < APP_NPU_STAGE_CONTEXT_MAX_STAGES; index++) {
+		TEST_ASSERT_EQUAL_INT(APP_NPU_STAGE_CONTEXT_FULL_INIT,
+				AppNpuStageContext_Plan(&table, &keys[index], 0U, NULL));
+		TEST_ASSERT_TRUE(AppNpuStageContext_MarkInitialized(&table,
+				&keys[index], 0U, 1U));
+		TEST_ASSERT_EQUAL_INT(APP_NPU_STAGE_CONTEXT_REARM,
+				AppNpuStageContext_Plan(&table, &keys[index], 0U, NULL));
+	}
+
+	TEST_ASSERT_EQUAL_INT(APP_NPU_STAGE_CONTEXT_FULL_INIT,
+			AppNpuStageContext_Plan(&table,
+					&keys[APP_NPU_STAGE_CONTEXT_MAX_STAGES], 0U, &reason));
+	TEST_ASSERT_EQUAL_INT(APP_NPU_STAGE_CONTEXT_REASON_FIRST_USE, reason);
+	TEST_ASSERT_FALSE(AppNpuStageContext_MarkInitialized(&table,
+			&keys[APP_NPU_STAGE_CONTEXT_MAX_STAGES], 0U, 1U));
+	TEST_ASSERT_EQUAL_INT(APP_NPU_STAGE_CONTEXT_FULL_INIT,
+			AppNpuStageContext_Plan(&table,
+					&keys[APP_NPU_STAGE_CONTEXT_MAX_STAGES], 0U, NULL));
+	TEST_ASSERT_EQUAL_INT(APP_NPU_STAGE_CONTEXT_FULL_INIT,
+			AppNpuStageContext_Plan(&table, NULL, 0U, NULL));
+	TEST_ASSERT_EQUAL_STRING("corrupted",
+			AppNpuStageContext_ReasonName(APP_NPU_STAGE_CONTEXT_REASON_CORRUPTED));
+}
+
+/*==============================================================================
+ * Test: test_NpuStageContext_OtherNetworkRun_DropsLiveContext
+ *
+ * Expected:
+ *   Back-to-back runs of one stage re-arm; once any other network has run
+ *   on the NPU, the stage that ran before it needs a full init again.
+ *==============================================================================*/
+void test_NpuStageContext_OtherNetworkRun_DropsLiveContext(void) {
+	AppNpuStageContext_Table_t table;
+	AppNpuStageContext_Reason_t reason = APP_NPU_STAGE_CONTEXT_REASON_NONE;
+	uint32_t npu_run_count = 0U;
+
+	AppNpuStageContext_Init(&table);
+	(void) AppNpuStageContext_Plan(&table, &test_obb_stage, 7U, NULL);
+	(void) AppNpuStageContext_MarkInitialized(&table, &test_obb_stage, 7U, 1U);
+	TEST_ASSERT_TRUE(AppNpuStageContext_RecordRun(&table, &test_obb_stage,
+			++npu_run_count));
+
+	AppNpuStageContext_InvalidateDisplaced(&table, npu_run_count);
+	TEST_ASSERT_EQUAL_INT(APP_NPU_STAGE_CONTEXT_REARM,
+			AppNpuStageContext_Plan(&table, &test_obb_stage, 7U, NULL));
+	(void) AppNpuStageContext_RecordRun(&table, &test_obb_stage,
+			++npu_run_count);
+
+	/* A network outside the table (e.g. the centre detector) runs. */
+	npu_run_count++;
+	AppNpuStageContext_InvalidateDisplaced(&table, npu_run_count);
+	TEST_ASSERT_EQUAL_INT(APP_NPU_STAGE_CONTEXT_FULL_INIT,
+			AppNpuStageContext_Plan(&table, &test_obb_stage, 7U, &reason));
+	TEST_ASSERT_EQUAL_INT(APP_NPU_STAGE_CONTEXT_REASON_INVALIDATED, reason);
+	TEST_ASSERT_EQUAL_UINT32(0U,
+			AppNpuStageContext_Get(&table, &test_obb_stage)->integrity_failures);
+	TEST_ASSERT_FALSE(AppNpuStageContext_RecordRun(&table, &test_other_stage,
+			npu_run_count));
+}
@@ -0,0 +1,199 @@
+/*==============================================================================
+ * File: test_power_domain.c
+ *
+ * Purpose:
+ *   Unity unit tests for the AppPowerDomain reference-counting manager.
+ *
+ * Approach:
+ *   - Register one domain with counting hooks and drive acquire, release and
+ *     service calls against a fake millisecond clock.
+ *==============================================================================*/
+
+#include "unity.h"
+#include "app_power_domain.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+static uint32_t test_enable_calls;
+static uint32_t test_retain_calls;
+static uint32_t test_disable_calls;
+static bool test_enable_result;
+/* Set when retain ran while the domain was still clocked. */
+static bool test_retain_before_disable;
+
+static bool Test_Enable(void) {
+	test_enable_calls++;
+	return test_enable_result;
+}
+
+static void Test_Retain(void) {
+	test_retain_calls++;
+	test_retain_before_disable = (test_disable_calls == test_retain_calls - 1U);
+}
+
+static void Test_Disable(void) {
+	test_disable_calls++;
+}
+
+/*==============================================================================
+ * Function: Test_Setup
+ *
+ * Purpose:
+ *   Register the SD SPI domain with counting hooks and the given minimum off
+ *   time, starting gated or powered at t = 1000 ms.
+ *==============================================================================*/
+static void Test_Setup(AppPowerDomain_Context_t *context_ptr,
+		uint32_t min_off_ms, bool powered) {
+	const AppPowerDomain_Hooks_t hooks = {
+		.enable = Test_Enable,
+		.retain = Test_Retain,
+		.disable = Test_Disable,
+		.min_off_ms = min_off_ms,
+	};
+
+	test_enable_calls = 0U;
+	test_retain_calls = 0U;
+	test_disable_calls = 0U;
+	test_enable_result = true;
+	test_retain_before_disable = false;
+
+	AppPowerDomain_Init(context_ptr);
+	AppPowerDomain_Register(context_ptr, APP_POWER_DOMAIN_SD_SPI, &hooks,
+			powered, 1000U);
+}
+
+/*==============================================================================
+ * Test: test_PowerDomain_RefCount_GatesOnlyAfterLastRelease
+ *
+ * Expected:
+ *   Nested acquires enable once, the first release keeps the domain on, and
+ *   the last release gates it straight away when there is no off window.
+ *==============================================================================*/
+void test_PowerDomain_RefCount_GatesOnlyAfterLastRelease(void) {
+	AppPowerDomain_Context_t context;
+
+	Test_Setup(&context, 0U, false);
+
+	TEST_ASSERT_TRUE(AppPowerDomain_Acquire(&context, APP_POWER_DOMAIN_SD_SPI,
+			1000U));
+	TEST_ASSERT_TRUE(AppPowerDomain_Acquire(&context, APP_POWER_DOMAIN_SD_SPI,
+			1010U));
+	TEST_ASSERT_EQUAL_UINT32(1U, test_enable_calls);
+
+	AppPowerDomain_Release(&context, APP_POWER_DOMAIN_SD_SPI, 1020U);
+	TEST_ASSERT_TRUE(AppPowerDomain_IsPowered(&context,
+			APP_POWER_DOMAIN_SD_SPI));
+	TEST_ASSERT_EQUAL_UINT32(0U, test_disable_calls);
+
+	AppPowerDomain_Release(&context, APP_POWER_DOMAIN_SD_SPI, 1050U);
+	TEST_ASSERT_FALSE(AppPowerDomain_IsPowered(&context,
+			APP_POWER_DOMAIN_SD_SPI));
+	TEST_ASSERT_EQUAL_UINT32(1U, test_disable_calls);
+	TEST_ASSERT_TRUE(test_retain_before_disable);
+
+	/* A stray release must not underflow or gate again. */
+	AppPowerDomain_Release(&context, APP_POWER_DOMAIN_SD_SPI, 1060U);
+	TEST_ASSERT_EQUAL_UINT32(1U, test_disable_calls);
+	TEST_ASSERT_EQUAL_UINT32(0U,
+			context.domain[APP_POWER_DOMAIN_SD_SPI].ref_count);
+}
+
+/*==============================================================================
+ * Test: test_PowerDomain_Hysteresis_HoldsThroughShortGaps
+ *
+ * Expected:
+ *   With a 500 ms minimum off time, a re-acquire 200 ms after release does not
+ *   toggle the hardware, Service reports the remaining wait, and the gate
+ *   lands once the domain has been unused for the full window.
+ *==============================================================================*/
+void test_PowerDomain_Hysteresis_HoldsThroughShortGaps(void) {
+	AppPowerDomain_Context_t context;
+
+	Test_Setup(&context, 500U, false);
+
+	TEST_ASSERT_TRUE(AppPowerDomain_Acquire(&context, APP_POWER_DOMAIN_SD_SPI,
+			1000U));
+	AppPowerDomain_Release(&context, APP_POWER_DOMAIN_SD_SPI, 1100U);
+	TEST_ASSERT_EQUAL_UINT32(400U, AppPowerDomain_Service(&context, 1200U));
+
+	TEST_ASSERT_TRUE(AppPowerDomain_Acquire(&context, APP_POWER_DOMAIN_SD_SPI,
+			1300U));
+	TEST_ASSERT_EQUAL_UINT32(APP_POWER_DOMAIN_NONE_PENDING,
+			AppPowerDomain_Service(&context, 2000U));
+	TEST_ASSERT_EQUAL_UINT32(1U, test_enable_calls);
+	TEST_ASSERT_EQUAL_UINT32(0U, test_disable_calls);
+
+	/* The window restarts from the latest release, not the first one. */
+	AppPowerDomain_Release(&context, APP_POWER_DOMAIN_SD_SPI, 2000U);
+	TEST_ASSERT_EQUAL_UINT32(1U, AppPowerDomain_Service(&context, 2499U));
+	TEST_ASSERT_TRUE(AppPowerDomain_IsPowered(&context,
+			APP_POWER_DOMAIN_SD_SPI));
+	TEST_ASSERT_EQUAL_UINT32(APP_POWER_DOMAIN_NONE_PENDING,
+			AppPowerDomain_Service(&context, 2500U));
+	TEST_ASSERT_FALSE(AppPowerDomain_IsPowered(&context,
+			APP_POWER_DOMAIN_SD_SPI));
+	TEST_ASSERT_EQUAL_UINT32(1U, test_retain_calls);
+	TEST_ASSERT_EQUAL_UINT32(1U, test_disable_calls);
+}
+
+/*==============================================================================
+ * Test: test_PowerDomain_OnTime_CountsOnlyUngatedIntervals
+ *
+ * Expected:
+ *   On-time covers 1000..2500 and 5000..now; the gated gap does not count.
+ *==============================================================================*/
+void test_PowerDomain_OnTime_CountsOnlyUngatedIntervals(void) {
+	AppPowerDomain_Context_t context;
+
+	Test_Setup(&context, 500U, false);
+
+	TEST_ASSERT_TRUE(AppPowerDomain_Acquire(&context, APP_POWER_DOMAIN_SD_SPI,
+			1000U));
+	AppPowerDomain_Release(&context, APP_POWER_DOMAIN_SD_SPI, 2000U);
+	(void) AppPowerDomain_Service(&context, 2500U);
+	TEST_ASSERT_EQUAL_UINT64(1500U, AppPowerDomain_OnTimeMs(&context,
+			APP_POWER_DOMAIN_SD_SPI, 4000U));
+
+	TEST_ASSERT_TRUE(AppPowerDomain_Acquire(&context, APP_POWER_DOMAIN_SD_SPI,
+			5000U));
+	TEST_ASSERT_EQUAL_UINT64(1750U, AppPowerDomain_OnTimeMs(&context,
+			APP_POWER_DOMAIN_SD_SPI, 5250U));
+	TEST_ASSERT_EQUAL_UINT32(2U,
+			context.domain[APP_POWER_DOMAIN_SD_SPI].enable_count);
+}
+
+/*==============================================================================
+ * Test: test_PowerDomain_BootStateAndFailedEnable
+ *
+ * Expected:
+ *   A domain boot left on stays on through Service until its first release,
+ *   and an enable hook failure leaves the domain off with no reference held.
+ *==============================================================================*/
+void test_PowerDomain_BootStateAndFailedEnable(void) {
+	AppPowerDomain_Context_t context;
+
+	Test_Setup(&context, 0U, true);
+
+	(void) AppPowerDomain_Service(&context, 90000U);
+	TEST_ASSERT_TRUE(AppPowerDomain_IsPowered(&context,
+			APP_POWER_DOMAIN_SD_SPI));
+	TEST_ASSERT_TRUE(AppPowerDomain_Acquire(&context, APP_POWER_DOMAIN_SD_SPI,
+			90000U));
+	TEST_ASSERT_EQUAL_UINT32(0U, test_enable_calls);
+	AppPowerDomain_Release(&context, APP_POWER_DOMAIN_SD_SPI, 90010U);
+	TEST_ASSERT_FALSE(AppPowerDomain_IsPowered(&context,
+			APP_POWER_DOMAIN_SD_SPI));
+
+	test_enable_result = false;
+	TEST_ASSERT_FALSE(AppPowerDomain_Acquire(&context, APP_POWER_DOMAIN_SD_SPI,
+			91000U));
+	TEST_ASSERT_FALSE(AppPowerDomain_IsPowered(&context,
+			APP_POWER_DOMAIN_SD_SPI));
+	TEST_ASSERT_EQUAL_UINT32(0U,
+			context.domain[APP_POWER_DOMAIN_SD_SPI].ref_count);
+
+	/* Domains nobody registered can never be acquired. */
+	TEST_ASSERT_FALSE(AppPowerDomain_Acquire(&context, APP_POWER_DOMAIN_NPU,
+			91000U));
+}
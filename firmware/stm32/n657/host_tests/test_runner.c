@@ -7,6 +7,90 @@ void test_SdSpiProtocol_SendCommandAndGetR1_PollsUntilNonFF(void);
 void test_rollover_occurs_when_record_would_exceed_threshold(void);
 void test_open_if_needed_creates_file_if_missing(void);
 void test_force_flush_and_close_closes_when_open(void);
+void test_CaptureSchedule_FlatReadings_GrowToCeiling(void);
+void test_CaptureSchedule_FastChange_ShrinksToFloor(void);
+void test_CaptureSchedule_AlarmProximity_ShrinksPeriod(void);
+void test_CaptureSchedule_MissingReading_NeverStretches(void);
+void test_CaptureSchedule_ExhaustedBudget_HoldsCeiling(void);
+void test_CaptureSchedule_WallClock_RollsBudgetAtMidnight(void);
+void test_ExposureControl_RecordedLighting_ConvergesInTwoFrames(void);
+void test_ExposureControl_GammaMismatch_ConvergesInTwoFrames(void);
+void test_ExposureControl_InBandFrame_NeedsNoCorrection(void);
+void test_ExposureControl_SensorLimit_ReportsNoChange(void);
+void test_ExposureControl_SettingFromTotal_SpendsExposureFirst(void);
+void test_ExposureMemory_ParseTimestamp_AcceptsRtcForms(void);
+void test_ExposureMemory_Lookup_PrefersOwnThenNearerBucket(void);
+void test_ExposureMemory_Lookup_IgnoresStaleAndFutureEntries(void);
+void test_ExposureMemory_Store_OnlyReportsMaterialChanges(void);
+void test_ExposureMemory_IsValid_RejectsCorruptCopy(void);
+void test_CaptureRoi_DefaultWindow_MatchesCenteredSquare(void);
+void test_CaptureRoi_WindowFromBox_PutsBoxOnTrainingCrop(void);
+void test_CaptureRoi_WindowFromBox_IsStableWhenReapplied(void);
+void test_CaptureRoi_WindowFromBox_ClampsToSensorAndZoomLimit(void);
+void test_CaptureRoi_WindowFromBox_RejectsDegenerateBox(void);
+void test_FrameFormat_LumaOffset_ReadsSameLumaFromBothLayouts(void);
+void test_FrameFormat_FromLength_TellsLayoutsApart(void);
+void test_FrameFormat_Parse_AcceptsDeploymentFileContents(void);
+void test_BurstFusion_EstimateShift_RecoversTranslation(void);
+void test_BurstFusion_Median_RejectsTransientGlint(void);
+void test_BurstFusion_Mean_AlignsAndAveragesNoise(void);
+void test_BurstFusion_Fuse_RejectsInvalidArguments(void);
+void test_BootGraph_IndependentLanes_RunConcurrently(void);
+void test_BootGraph_SoftDependency_WaitsOnlyUntilDeadline(void);
+void test_BootGraph_FailedHardDependency_SkipsDownstream(void);
+void test_BootGraph_Init_RejectsBadGraphs(void);
+void test_FsblAppImage_Crc32_MatchesZlib(void);
+void test_FsblAppImage_ParseHeader_AcceptsToolOutput(void);
+void test_FsblAppImage_ParseHeader_RejectsBadHeaders(void);
+void test_FsblAppImage_CopyWithCrc_CopiesExactlyTheImage(void);
+void test_SensorPower_Choose_PicksDeepestStateThatFits(void);
+void test_SensorPower_RecordWake_RisesAtOnceAndDecaysSlowly(void);
+void test_SensorPower_FailedWakes_DisableOnlyAfterLimit(void);
+void test_PowerDomain_RefCount_GatesOnlyAfterLastRelease(void);
+void test_PowerDomain_Hysteresis_HoldsThroughShortGaps(void);
+void test_PowerDomain_OnTime_CountsOnlyUngatedIntervals(void);
+void test_PowerDomain_BootStateAndFailedEnable(void);
+void test_ClockProfile_Derive_BoostMatchesBootClockTree(void);
+void test_ClockProfile_Derive_LowKeepsPeripheralRates(void);
+void test_ClockProfile_Derive_RejectsInvalidPoints(void);
+void test_ClockProfile_Demand_HighestWinsAndRestores(void);
+void test_ClockProfile_Account_SumsEnergyPerProfile(void);
+void test_LumaStats_FromIspBins_BoundsUniformFrames(void);
+void test_LumaStats_FromIspBins_ScalesAndRejects(void);
+void test_LumaStats_SampleRegion_StridedMatchesFullScan(void);
+void test_LumaStats_AnyNonZero_StopsOnStrideHits(void);
+void test_XspiDtr_FindWidestWindow_PrefersWidestLowestRun(void);
+void test_XspiDtr_BringUp_CentresWindowAndValidates(void);
+void test_XspiDtr_BringUp_FallsBackToStr(void);
+void test_XspiDtr_BringUp_ErasedPatternStaysInStr(void);
+void test_SdCardProfile_ParseSdStatus_DecodesAuFields(void);
+void test_SdCardProfile_Probe_FindsAuThroughNoise(void);
+void test_SdCardProfile_ChooseAlign_FallsBackToSdStatus(void);
+void test_SdCardProfile_NextAlignedCluster_StepsToUnitBoundary(void);
+void test_SdFatFormat_PlanLayout_AlignsFatAndClustersToUnit(void);
+void test_SdFatFormat_PlanLayout_TradesClusterSizeForSlackAndCount(void);
+void test_SdFatFormat_Write_ProducesFat32Metadata(void);
+void test_SdFatFormat_Write_RejectsBadInputAndReportsFailedWrites(void);
+void test_FrameIngest_Run_MatchesSeparateYuv422Scans(void);
+void test_FrameIngest_Run_HandlesY8AndUnalignedStride(void);
+void test_FrameIngest_Run_RejectsBadInputAndMatchesOnlyItsBuffer(void);
+void test_CaptureEvents_CleanFrame_RecordsPhaseTimings(void);
+void test_CaptureEvents_Streaming_WaitsForNextBoundary(void);
+void test_CaptureEvents_Errors_FailAndKeepTheirCode(void);
+void test_CaptureEvents_Timeout_IsExactAcrossClockWrap(void);
+void test_Xspi2Residency_Alternation_VerifiesEachStageOnce(void);
+void test_Xspi2Residency_Provisioning_ForcesReverify(void);
+void test_Xspi2Residency_ZeroedTableAndOverflow_StaySafe(void);
+void test_NpuStageContext_RepeatedInference_InitsOnceThenRearms(void);
+void test_NpuStageContext_CorruptionAndInvalidate_ForceFullInit(void);
+void test_NpuStageContext_ZeroedTableAndOverflow_StaySafe(void);
+void test_NpuStageContext_OtherNetworkRun_DropsLiveContext(void);
+void test_ActivationOverlay_SequentialStages_MayShareBytes(void);
+void test_ActivationOverlay_Extent_ChecksPlacedBuffers(void);
+void test_EpochProfile_AccumulatesPerEpochStep(void);
+void test_EpochProfile_CountsEpochsPastTable(void);
+void test_NnPipe_PlanLayout_LetterboxesLikeCpuResize(void);
+void test_NnPipe_Quant_PicksCheapestMap(void);
 
 
 /*==============================================================================
@@ -132,6 +216,90 @@ int main(void)
 	RUN_TEST(test_rollover_occurs_when_record_would_exceed_threshold);
 	RUN_TEST(test_open_if_needed_creates_file_if_missing);
 	RUN_TEST(test_force_flush_and_close_closes_when_open);
+	RUN_TEST(test_CaptureSchedule_FlatReadings_GrowToCeiling);
+	RUN_TEST(test_CaptureSchedule_FastChange_ShrinksToFloor);
+	RUN_TEST(test_CaptureSchedule_AlarmProximity_ShrinksPeriod);
+	RUN_TEST(test_CaptureSchedule_MissingReading_NeverStretches);
+	RUN_TEST(test_CaptureSchedule_ExhaustedBudget_HoldsCeiling);
+	RUN_TEST(test_CaptureSchedule_WallClock_RollsBudgetAtMidnight);
+	RUN_TEST(test_ExposureControl_RecordedLighting_ConvergesInTwoFrames);
+	RUN_TEST(test_ExposureControl_GammaMismatch_ConvergesInTwoFrames);
+	RUN_TEST(test_ExposureControl_InBandFrame_NeedsNoCorrection);
+	RUN_TEST(test_ExposureControl_SensorLimit_ReportsNoChange);
+	RUN_TEST(test_ExposureControl_SettingFromTotal_SpendsExposureFirst);
+	RUN_TEST(test_ExposureMemory_ParseTimestamp_AcceptsRtcForms);
+	RUN_TEST(test_ExposureMemory_Lookup_PrefersOwnThenNearerBucket);
+	RUN_TEST(test_ExposureMemory_Lookup_IgnoresStaleAndFutureEntries);
+	RUN_TEST(test_ExposureMemory_Store_OnlyReportsMaterialChanges);
+	RUN_TEST(test_ExposureMemory_IsValid_RejectsCorruptCopy);
+	RUN_TEST(test_CaptureRoi_DefaultWindow_MatchesCenteredSquare);
+	RUN_TEST(test_CaptureRoi_WindowFromBox_PutsBoxOnTrainingCrop);
+	RUN_TEST(test_CaptureRoi_WindowFromBox_IsStableWhenReapplied);
+	RUN_TEST(test_CaptureRoi_WindowFromBox_ClampsToSensorAndZoomLimit);
+	RUN_TEST(test_CaptureRoi_WindowFromBox_RejectsDegenerateBox);
+	RUN_TEST(test_FrameFormat_LumaOffset_ReadsSameLumaFromBothLayouts);
+	RUN_TEST(test_FrameFormat_FromLength_TellsLayoutsApart);
+	RUN_TEST(test_FrameFormat_Parse_AcceptsDeploymentFileContents);
+	RUN_TEST(test_BurstFusion_EstimateShift_RecoversTranslation);
+	RUN_TEST(test_BurstFusion_Median_RejectsTransientGlint);
+	RUN_TEST(test_BurstFusion_Mean_AlignsAndAveragesNoise);
+	RUN_TEST(test_BurstFusion_Fuse_RejectsInvalidArguments);
+	RUN_TEST(test_BootGraph_IndependentLanes_RunConcurrently);
+	RUN_TEST(test_BootGraph_SoftDependency_WaitsOnlyUntilDeadline);
+	RUN_TEST(test_BootGraph_FailedHardDependency_SkipsDownstream);
+	RUN_TEST(test_BootGraph_Init_RejectsBadGraphs);
+	RUN_TEST(test_FsblAppImage_Crc32_MatchesZlib);
+	RUN_TEST(test_FsblAppImage_ParseHeader_AcceptsToolOutput);
+	RUN_TEST(test_FsblAppImage_ParseHeader_RejectsBadHeaders);
+	RUN_TEST(test_FsblAppImage_CopyWithCrc_CopiesExactlyTheImage);
+	RUN_TEST(test_SensorPower_Choose_PicksDeepestStateThatFits);
+	RUN_TEST(test_SensorPower_RecordWake_RisesAtOnceAndDecaysSlowly);
+	RUN_TEST(test_SensorPower_FailedWakes_DisableOnlyAfterLimit);
+	RUN_TEST(test_PowerDomain_RefCount_GatesOnlyAfterLastRelease);
+	RUN_TEST(test_PowerDomain_Hysteresis_HoldsThroughShortGaps);
+	RUN_TEST(test_PowerDomain_OnTime_CountsOnlyUngatedIntervals);
+	RUN_TEST(test_PowerDomain_BootStateAndFailedEnable);
+	RUN_TEST(test_ClockProfile_Derive_BoostMatchesBootClockTree);
+	RUN_TEST(test_ClockProfile_Derive_LowKeepsPeripheralRates);
+	RUN_TEST(test_ClockProfile_Derive_RejectsInvalidPoints);
+	RUN_TEST(test_ClockProfile_Demand_HighestWinsAndRestores);
+	RUN_TEST(test_ClockProfile_Account_SumsEnergyPerProfile);
+	RUN_TEST(test_LumaStats_FromIspBins_BoundsUniformFrames);
+	RUN_TEST(test_LumaStats_FromIspBins_ScalesAndRejects);
+	RUN_TEST(test_LumaStats_SampleRegion_StridedMatchesFullScan);
+	RUN_TEST(test_LumaStats_AnyNonZero_StopsOnStrideHits);
+	RUN_TEST(test_XspiDtr_FindWidestWindow_PrefersWidestLowestRun);
+	RUN_TEST(test_XspiDtr_BringUp_CentresWindowAndValidates);
+	RUN_TEST(test_XspiDtr_BringUp_FallsBackToStr);
+	RUN_TEST(test_XspiDtr_BringUp_ErasedPatternStaysInStr);
+	RUN_TEST(test_SdCardProfile_ParseSdStatus_DecodesAuFields);
+	RUN_TEST(test_SdCardProfile_Probe_FindsAuThroughNoise);
+	RUN_TEST(test_SdCardProfile_ChooseAlign_FallsBackToSdStatus);
+	RUN_TEST(test_SdCardProfile_NextAlignedCluster_StepsToUnitBoundary);
+	RUN_TEST(test_SdFatFormat_PlanLayout_AlignsFatAndClustersToUnit);
+	RUN_TEST(test_SdFatFormat_PlanLayout_TradesClusterSizeForSlackAndCount);
+	RUN_TEST(test_SdFatFormat_Write_ProducesFat32Metadata);
+	RUN_TEST(test_SdFatFormat_Write_RejectsBadInputAndReportsFailedWrites);
+	RUN_TEST(test_FrameIngest_Run_MatchesSeparateYuv422Scans);
+	RUN_TEST(test_FrameIngest_Run_HandlesY8AndUnalignedStride);
+	RUN_TEST(test_FrameIngest_Run_RejectsBadInputAndMatchesOnlyItsBuffer);
+	RUN_TEST(test_CaptureEvents_CleanFrame_RecordsPhaseTimings);
+	RUN_TEST(test_CaptureEvents_Streaming_WaitsForNextBoundary);
+	RUN_TEST(test_CaptureEvents_Errors_FailAndKeepTheirCode);
+	RUN_TEST(test_CaptureEvents_Timeout_IsExactAcrossClockWrap);
+	RUN_TEST(test_Xspi2Residency_Alternation_VerifiesEachStageOnce);
+	RUN_TEST(test_Xspi2Residency_Provisioning_ForcesReverify);
+	RUN_TEST(test_Xspi2Residency_ZeroedTableAndOverflow_StaySafe);
+	RUN_TEST(test_NpuStageContext_RepeatedInference_InitsOnceThenRearms);
+	RUN_TEST(test_NpuStageContext_CorruptionAndInvalidate_ForceFullInit);
+	RUN_TEST(test_NpuStageContext_ZeroedTableAndOverflow_StaySafe);
+	RUN_TEST(test_NpuStageContext_OtherNetworkRun_DropsLiveContext);
+	RUN_TEST(test_ActivationOverlay_SequentialStages_MayShareBytes);
+	RUN_TEST(test_ActivationOverlay_Extent_ChecksPlacedBuffers);
+	RUN_TEST(test_EpochProfile_AccumulatesPerEpochStep);
+	RUN_TEST(test_EpochProfile_CountsEpochsPastTable);
+	RUN_TEST(test_NnPipe_PlanLayout_LetterboxesLikeCpuResize);
+	RUN_TEST(test_NnPipe_Quant_PicksCheapestMap);
 
     unity_result_code = UNITY_END();
 
@@ -0,0 +1,230 @@
+/*==============================================================================
+ * File: test_sd_card_profile.c
+ *
+ * Purpose:
+ *   Unity unit tests for the SD card write-geometry profile.
+ *
+ * Approach:
+ *   - Decode hand-built SD status blocks.
+ *   - Run the latency probe against a simulated card: a fixed command cost,
+ *     a per-sector cost, a small flash-page penalty and a large stall for
+ *     any write that crosses an allocation-unit boundary, plus bus noise on
+ *     every third write.
+ *   - Check the cluster alignment arithmetic the FileX writers use.
+ *==============================================================================*/
+
+#include "unity.h"
+#include "sd_card_profile.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/*==============================================================================
+ * Type: SdCardProfile_TestCard
+ *
+ * Purpose:
+ *   Write-latency model of an SD card.
+ *==============================================================================*/
+typedef struct {
+	uint32_t au_sectors;        /* 0 = no AU penalty. */
+	uint32_t au_penalty_us;
+	uint32_t page_sectors;
+	uint32_t page_penalty_us;
+	uint32_t fail_after_writes; /* 0 = never fail. */
+	uint32_t write_count;
+	uint32_t lowest_lba;
+	uint32_t highest_lba;
+} SdCardProfile_TestCard;
+
+static uint8_t SdCardProfile_TestCrosses(uint32_t lba, uint32_t count,
+		uint32_t unit) {
+	return ((unit != 0U) && ((lba / unit) != ((lba + count - 1U) / unit))) ?
+			1U : 0U;
+}
+
+static int32_t SdCardProfile_TestWrite(void *write_context, uint32_t lba,
+		uint32_t sector_count, uint32_t *elapsed_us_out) {
+	SdCardProfile_TestCard *card = (SdCardProfile_TestCard*) write_context;
+	uint32_t elapsed_us = 300U + (40U * sector_count);
+
+	card->write_count++;
+	if ((card->fail_after_writes != 0U)
+			&& (card->write_count > card->fail_after_writes)) {
+		return -1;
+	}
+	if (lba < card->lowest_lba) {
+		card->lowest_lba = lba;
+	}
+	if ((lba + sector_count - 1U) > card->highest_lba) {
+		card->highest_lba = lba + sector_count - 1U;
+	}
+
+	if (SdCardProfile_TestCrosses(lba, sector_count, card->page_sectors) != 0U) {
+		elapsed_us += card->page_penalty_us;
+	}
+	if (SdCardProfile_TestCrosses(lba, sector_count, card->au_sectors) != 0U) {
+		elapsed_us += card->au_penalty_us;
+	}
+	if ((card->write_count % 3U) == 0U) {
+		elapsed_us += 5000U; /* Bus or scheduler noise. */
+	}
+
+	*elapsed_us_out = elapsed_us;
+	return 0;
+}
+
+static SdCardProfile_ProbeConfig SdCardProfile_TestConfig(void) {
+	SdCardProfile_ProbeConfig config;
+
+	config.window_start_lba = 8192U;
+	config.window_sectors = 8192U + 16U;
+	config.probe_sectors = 16U;
+	config.min_boundary_sectors = 32U;
+	config.max_boundary_sectors = 8192U;
+	config.repeats = 3U;
+	config.penalty_percent = 50U;
+	return config;
+}
+
+/*==============================================================================
+ * Test: test_SdCardProfile_ParseSdStatus_DecodesAuFields
+ *
+ * Expected:
+ *   AU_SIZE 9 is 4 MiB (8192 sectors), ERASE_SIZE and ERASE_TIMEOUT/OFFSET
+ *   come out of bytes 11..13, and AU_SIZE 0 reports no AU.
+ *==============================================================================*/
+void test_SdCardProfile_ParseSdStatus_DecodesAuFields(void) {
+	uint8_t sd_status[SD_CARD_PROFILE_SD_STATUS_BYTES] = { 0U };
+	SdCardProfile_SdStatus status;
+
+	sd_status[10] = 0x90U;
+	sd_status[11] = 0x01U;
+	sd_status[12] = 0x02U;
+	sd_status[13] = (uint8_t) ((10U << 2U) | 0x01U);
+
+	TEST_ASSERT_EQUAL_UINT8(1U,
+			SdCardProfile_ParseSdStatus(sd_status, &status));
+	TEST_ASSERT_EQUAL_UINT8(9U, status.au_size_code);
+	TEST_ASSERT_EQUAL_UINT32(8192U, status.au_sectors);
+	TEST_ASSERT_EQUAL_UINT16(0x0102U, status.erase_size_au);
+	TEST_ASSERT_EQUAL_UINT8(10U, status.erase_timeout_s);
+	TEST_ASSERT_EQUAL_UINT8(1U, status.erase_offset_s);
+
+	sd_status[10] = 0x0FU; /* Low nibble is reserved. */
+	TEST_ASSERT_EQUAL_UINT8(0U,
+			SdCardProfile_ParseSdStatus(sd_status, &status));
+	TEST_ASSERT_EQUAL_UINT32(0U, status.au_sectors);
+}
+
+/*==============================================================================
+ * Test: test_SdCardProfile_Probe_FindsAuThroughNoise
+ *
+ * Expected:
+ *   A 128 KiB AU (256 sectors) is found despite noise on every third write
+ *   and a page penalty below the threshold; every write stays inside the
+ *   scratch window.
+ *==============================================================================*/
+void test_SdCardProfile_Probe_FindsAuThroughNoise(void) {
+	const SdCardProfile_ProbeConfig config = SdCardProfile_TestConfig();
+	SdCardProfile_TestCard card = { 256U, 20000U, 8U, 150U, 0U, 0U,
+			UINT32_MAX, 0U };
+	SdCardProfile_Profile profile;
+
+	TEST_ASSERT_EQUAL_INT32(0,
+			SdCardProfile_Probe(SdCardProfile_TestWrite, &card, &config,
+					&profile));
+	TEST_ASSERT_EQUAL_UINT32(256U, profile.boundary_sectors);
+	TEST_ASSERT_EQUAL_UINT32(5U, profile.size_step_count);
+	TEST_ASSERT_EQUAL_UINT32(340U, profile.size_us[0]);
+	TEST_ASSERT_EQUAL_UINT32(300U + (40U * 16U) + 150U, profile.baseline_us);
+	TEST_ASSERT_EQUAL_UINT32(9U, profile.candidate_count);
+	TEST_ASSERT_TRUE(profile.straddle_us[3] > 20000U);
+	TEST_ASSERT_TRUE(profile.straddle_us[2] < 2000U);
+	TEST_ASSERT_TRUE(card.lowest_lba >= config.window_start_lba);
+	TEST_ASSERT_TRUE(card.highest_lba
+			< (config.window_start_lba + config.window_sectors));
+
+	/* A 4 MiB AU is the last candidate. */
+	card.au_sectors = 8192U;
+	card.write_count = 0U;
+	TEST_ASSERT_EQUAL_INT32(0,
+			SdCardProfile_Probe(SdCardProfile_TestWrite, &card, &config,
+					&profile));
+	TEST_ASSERT_EQUAL_UINT32(8192U, profile.boundary_sectors);
+}
+
+/*==============================================================================
+ * Test: test_SdCardProfile_ChooseAlign_FallsBackToSdStatus
+ *
+ * Expected:
+ *   A card without stalls reports no boundary, so the AU from the SD status
+ *   register is used, capped; the measured boundary wins when present.
+ *   Bad configs and failed writes are reported.
+ *==============================================================================*/
+void test_SdCardProfile_ChooseAlign_FallsBackToSdStatus(void) {
+	SdCardProfile_ProbeConfig config = SdCardProfile_TestConfig();
+	SdCardProfile_TestCard card = { 0U, 0U, 0U, 0U, 0U, 0U, UINT32_MAX, 0U };
+	SdCardProfile_Profile profile;
+
+	TEST_ASSERT_EQUAL_INT32(0,
+			SdCardProfile_Probe(SdCardProfile_TestWrite, &card, &config,
+					&profile));
+	TEST_ASSERT_EQUAL_UINT32(0U, profile.boundary_sectors);
+
+	TEST_ASSERT_EQUAL_UINT32(1024U,
+			SdCardProfile_ChooseAlignSectors(0U, 8192U, 1024U));
+	TEST_ASSERT_EQUAL_UINT32(128U,
+			SdCardProfile_ChooseAlignSectors(0U, 128U, 1024U));
+	TEST_ASSERT_EQUAL_UINT32(256U,
+			SdCardProfile_ChooseAlignSectors(256U, 8192U, 1024U));
+	TEST_ASSERT_EQUAL_UINT32(1024U,
+			SdCardProfile_ChooseAlignSectors(0U, 24576U, 1024U));
+	TEST_ASSERT_EQUAL_UINT32(0U, SdCardProfile_ChooseAlignSectors(0U, 0U,
+			1024U));
+
+	card.fail_after_writes = 4U;
+	card.write_count = 0U;
+	TEST_ASSERT_EQUAL_INT32(-2,
+			SdCardProfile_Probe(SdCardProfile_TestWrite, &card, &config,
+					&profile));
+
+	config.window_start_lba = 100U; /* Not aligned to the largest boundary. */
+	TEST_ASSERT_EQUAL_INT32(-1,
+			SdCardProfile_Probe(SdCardProfile_TestWrite, &card, &config,
+					&profile));
+}
+
+/*==============================================================================
+ * Test: test_SdCardProfile_NextAlignedCluster_StepsToUnitBoundary
+ *
+ * Expected:
+ *   With cluster 2 at LBA 8192 + 64 and 64-sector clusters, 256-sector units
+ *   start at clusters 5, 9, 13 ...; the search wraps past the end and gives
+ *   up on a cluster grid that can never line up.
+ *==============================================================================*/
+void test_SdCardProfile_NextAlignedCluster_StepsToUnitBoundary(void) {
+	const uint32_t first_data_lba = 8192U + 64U;
+
+	/* Cluster 2 at 8256: 8256 + 3 * 64 = 8448 = 33 * 256. */
+	TEST_ASSERT_EQUAL_UINT32(5U,
+			SdCardProfile_NextAlignedCluster(first_data_lba, 64U, 100U, 2U,
+					256U));
+	TEST_ASSERT_EQUAL_UINT32(5U,
+			SdCardProfile_NextAlignedCluster(first_data_lba, 64U, 100U, 5U,
+					256U));
+	TEST_ASSERT_EQUAL_UINT32(9U,
+			SdCardProfile_NextAlignedCluster(first_data_lba, 64U, 100U, 6U,
+					256U));
+	/* Clusters 2..99: the next unit would start at 101, so wrap to 5. */
+	TEST_ASSERT_EQUAL_UINT32(5U,
+			SdCardProfile_NextAlignedCluster(first_data_lba, 64U, 98U, 98U,
+					256U));
+	/* Data region not on a cluster-size boundary. */
+	TEST_ASSERT_EQUAL_UINT32(7U,
+			SdCardProfile_NextAlignedCluster(first_data_lba + 1U, 64U, 100U,
+					7U, 256U));
+	/* Cluster larger than the unit. */
+	TEST_ASSERT_EQUAL_UINT32(7U,
+			SdCardProfile_NextAlignedCluster(first_data_lba, 512U, 100U, 7U,
+					256U));
+}
@@ -0,0 +1,297 @@
+/*==============================================================================
+ * File: test_sd_fat_format.c
+ *
+ * Purpose:
+ *   Unity unit tests for the allocation-unit aligned FAT32 formatter.
+ *
+ * Approach:
+ *   - Plan layouts for a deployment-sized partition and for small or
+ *     slack-limited ones.
+ *   - Format into a recorder that keeps the metadata sectors of interest and
+ *     check them field by field.
+ *==============================================================================*/
+
+#include "unity.h"
+#include "sd_fat_format.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define TEST_CAPTURE_BYTES       100352U
+#define TEST_PARTITION_START     8192U
+#define TEST_PARTITION_SECTORS   (16777216U - TEST_PARTITION_START)
+#define TEST_AU_SECTORS          8192U
+#define TEST_RECORDED_SECTORS    8U
+
+/*==============================================================================
+ * Type: SdFatFormat_TestRecorder
+ *
+ * Purpose:
+ *   Keeps the last write to each watched sector and counts all writes.
+ *==============================================================================*/
+typedef struct {
+	uint32_t watched[TEST_RECORDED_SECTORS];
+	uint8_t data[TEST_RECORDED_SECTORS][SD_FAT_FORMAT_SECTOR_BYTES];
+	uint32_t write_count;
+	uint32_t last_sector;
+	uint32_t fail_after_writes; /* 0 = never fail. */
+} SdFatFormat_TestRecorder;
+
+static int32_t SdFatFormat_TestWrite(void *write_context, uint32_t sector,
+		const uint8_t data[SD_FAT_FORMAT_SECTOR_BYTES]) {
+	SdFatFormat_TestRecorder *recorder =
+			(SdFatFormat_TestRecorder*) write_context;
+
+	recorder->write_count++;
+	if ((recorder->fail_after_writes != 0U)
+			&& (recorder->write_count > recorder->fail_after_writes)) {
+		return -1;
+	}
+	recorder->last_sector = sector;
+	for (uint32_t index = 0U; index < TEST_RECORDED_SECTORS; index++) {
+		if (recorder->watched[index] == sector) {
+			(void) memcpy(recorder->data[index], data,
+					SD_FAT_FORMAT_SECTOR_BYTES);
+		}
+	}
+	return 0;
+}
+
+static uint32_t SdFatFormat_TestGet16(const uint8_t *buffer, uint32_t offset) {
+	return (uint32_t) buffer[offset] | ((uint32_t) buffer[offset + 1U] << 8U);
+}
+
+static uint32_t SdFatFormat_TestGet32(const uint8_t *buffer, uint32_t offset) {
+	return SdFatFormat_TestGet16(buffer, offset)
+			| (SdFatFormat_TestGet16(buffer, offset + 2U) << 16U);
+}
+
+static SdFatFormat_Config SdFatFormat_TestConfig(void) {
+	SdFatFormat_Config config;
+
+	config.partition_start_lba = TEST_PARTITION_START;
+	config.partition_sectors = TEST_PARTITION_SECTORS;
+	config.align_sectors = TEST_AU_SECTORS;
+	config.file_bytes = TEST_CAPTURE_BYTES;
+	config.max_slack_percent = 35U;
+	return config;
+}
+
+/*==============================================================================
+ * Test: test_SdFatFormat_PlanLayout_AlignsFatAndClustersToUnit
+ *
+ * Expected:
+ *   An 8 GiB card with a 4 MiB AU gets 64 KiB clusters (two per capture,
+ *   31% slack). FAT 1 starts on a card-absolute AU boundary, the FAT is
+ *   rounded only to a whole cluster, and the root cluster lands in the same
+ *   AU with every cluster boundary card-aligned.
+ *==============================================================================*/
+void test_SdFatFormat_PlanLayout_AlignsFatAndClustersToUnit(void) {
+	SdFatFormat_Config config = SdFatFormat_TestConfig();
+	SdFatFormat_Layout layout;
+
+	TEST_ASSERT_EQUAL_INT32(0, SdFatFormat_PlanLayout(&config, &layout));
+	TEST_ASSERT_EQUAL_UINT32(128U, layout.sectors_per_cluster);
+	TEST_ASSERT_EQUAL_UINT32(0U,
+			(layout.hidden_sectors + layout.reserved_sectors)
+					% TEST_AU_SECTORS);
+	TEST_ASSERT_EQUAL_UINT32(0U,
+			(layout.hidden_sectors + layout.data_start_sector)
+					% layout.sectors_per_cluster);
+	TEST_ASSERT_EQUAL_UINT32(
+			(layout.hidden_sectors + layout.reserved_sectors)
+					/ TEST_AU_SECTORS,
+			(layout.hidden_sectors + layout.data_start_sector)
+					/ TEST_AU_SECTORS);
+	TEST_ASSERT_EQUAL_UINT32(0U,
+			layout.sectors_per_fat % layout.sectors_per_cluster);
+	TEST_ASSERT_TRUE((layout.sectors_per_fat - layout.fat_used_sectors)
+			< layout.sectors_per_cluster);
+	TEST_ASSERT_TRUE(layout.reserved_sectors >= 32U);
+	TEST_ASSERT_TRUE(layout.cluster_count >= SD_FAT_FORMAT_MIN_CLUSTERS);
+	TEST_ASSERT_TRUE((layout.fat_used_sectors * 128U)
+			>= (layout.cluster_count + 2U));
+	TEST_ASSERT_TRUE((layout.data_start_sector
+			+ (layout.cluster_count * layout.sectors_per_cluster))
+			<= layout.total_sectors);
+
+	/* A partition that starts off the unit still aligns on the card. */
+	config.partition_start_lba = 2048U;
+	TEST_ASSERT_EQUAL_INT32(0, SdFatFormat_PlanLayout(&config, &layout));
+	TEST_ASSERT_EQUAL_UINT32(8192U - 2048U, layout.reserved_sectors);
+	TEST_ASSERT_EQUAL_UINT32(0U,
+			(layout.hidden_sectors + layout.data_start_sector)
+					% layout.sectors_per_cluster);
+}
+
+/*==============================================================================
+ * Test: test_SdFatFormat_PlanLayout_TradesClusterSizeForSlackAndCount
+ *
+ * Expected:
+ *   A 10% slack budget drops to 8 KiB clusters; a 2 GiB partition drops to
+ *   16 KiB to stay FAT32; a tiny partition or a bad unit is rejected.
+ *==============================================================================*/
+void test_SdFatFormat_PlanLayout_TradesClusterSizeForSlackAndCount(void) {
+	SdFatFormat_Config config = SdFatFormat_TestConfig();
+	SdFatFormat_Layout layout;
+
+	config.max_slack_percent = 10U;
+	TEST_ASSERT_EQUAL_INT32(0, SdFatFormat_PlanLayout(&config, &layout));
+	TEST_ASSERT_EQUAL_UINT32(16U, layout.sectors_per_cluster);
+
+	config = SdFatFormat_TestConfig();
+	config.partition_sectors = 4194304U;
+	TEST_ASSERT_EQUAL_INT32(0, SdFatFormat_PlanLayout(&config, &layout));
+	TEST_ASSERT_EQUAL_UINT32(32U, layout.sectors_per_cluster);
+
+	config.partition_sectors = 20000U;
+	TEST_ASSERT_EQUAL_INT32(-2, SdFatFormat_PlanLayout(&config, &layout));
+
+	config = SdFatFormat_TestConfig();
+	config.align_sectors = 3000U;
+	TEST_ASSERT_EQUAL_INT32(-1, SdFatFormat_PlanLayout(&config, &layout));
+	config.align_sectors = 65536U;
+	TEST_ASSERT_EQUAL_INT32(-1, SdFatFormat_PlanLayout(&config, &layout));
+}
+
+/*==============================================================================
+ * Test: test_SdFatFormat_Write_ProducesFat32Metadata
+ *
+ * Expected:
+ *   Boot sector, FSInfo, FAT chains and the root directory describe two
+ *   preallocated directories; the boot sector is the last sector written.
+ *==============================================================================*/
+void test_SdFatFormat_Write_ProducesFat32Metadata(void) {
+	const SdFatFormat_Config config = SdFatFormat_TestConfig();
+	const SdFatFormat_Directory directories[2] = { { "captured_images", 2U }, {
+			"inference", 1U } };
+	static SdFatFormat_TestRecorder recorder;
+	SdFatFormat_Layout layout;
+	const uint8_t *boot = recorder.data[0];
+	const uint8_t *fs_info = recorder.data[1];
+	const uint8_t *fat = recorder.data[2];
+	const uint8_t *root = recorder.data[3];
+	const uint8_t *captures = recorder.data[4];
+	uint8_t checksum = 0U;
+
+	TEST_ASSERT_EQUAL_INT32(0, SdFatFormat_PlanLayout(&config, &layout));
+	(void) memset(&recorder, 0, sizeof(recorder));
+	recorder.watched[0] = 0U;
+	recorder.watched[1] = 1U;
+	recorder.watched[2] = layout.reserved_sectors;
+	recorder.watched[3] = layout.data_start_sector;
+	recorder.watched[4] = layout.data_start_sector
+			+ layout.sectors_per_cluster;
+	recorder.watched[5] = UINT32_MAX;
+	recorder.watched[6] = UINT32_MAX;
+	recorder.watched[7] = UINT32_MAX;
+
+	TEST_ASSERT_EQUAL_INT32(0,
+			SdFatFormat_Write(&layout, directories, 2U, 0x12345678UL,
+					0x5CE10000UL, SdFatFormat_TestWrite, &recorder));
+	TEST_ASSERT_EQUAL_UINT32(0U, recorder.last_sector);
+	TEST_ASSERT_EQUAL_UINT32(
+			(2U * layout.fat_used_sectors) + (4U * layout.sectors_per_cluster)
+					+ 6U, recorder.write_count);
+
+	TEST_ASSERT_EQUAL_UINT32(0xEBU, boot[0]);
+	TEST_ASSERT_EQUAL_UINT32(512U, SdFatFormat_TestGet16(boot, 11U));
+	TEST_ASSERT_EQUAL_UINT32(layout.sectors_per_cluster, boot[13]);
+	TEST_ASSERT_EQUAL_UINT32(layout.reserved_sectors,
+			SdFatFormat_TestGet16(boot, 14U));
+	TEST_ASSERT_EQUAL_UINT32(2U, boot[16]);
+	TEST_ASSERT_EQUAL_UINT32(TEST_PARTITION_START,
+			SdFatFormat_TestGet32(boot, 28U));
+	TEST_ASSERT_EQUAL_UINT32(TEST_PARTITION_SECTORS,
+			SdFatFormat_TestGet32(boot, 32U));
+	TEST_ASSERT_EQUAL_UINT32(layout.sectors_per_fat,
+			SdFatFormat_TestGet32(boot, 36U));
+	TEST_ASSERT_EQUAL_UINT32(2U, SdFatFormat_TestGet32(boot, 44U));
+	TEST_ASSERT_EQUAL_UINT32(0xAA55U, SdFatFormat_TestGet16(boot, 510U));
+
+	TEST_ASSERT_EQUAL_UINT32(0x41615252UL, SdFatFormat_TestGet32(fs_info, 0U));
+	TEST_ASSERT_EQUAL_UINT32(layout.cluster_count - 4U,
+			SdFatFormat_TestGet32(fs_info, 488U));
+	TEST_ASSERT_EQUAL_UINT32(6U, SdFatFormat_TestGet32(fs_info, 492U));
+
+	/* Root at 2, captured_images at 3-4, inference at 5. */
+	TEST_ASSERT_EQUAL_UINT32(0x0FFFFFF8UL, SdFatFormat_TestGet32(fat, 0U));
+	TEST_ASSERT_EQUAL_UINT32(0x0FFFFFFFUL, SdFatFormat_TestGet32(fat, 8U));
+	TEST_ASSERT_EQUAL_UINT32(4U, SdFatFormat_TestGet32(fat, 12U));
+	TEST_ASSERT_EQUAL_UINT32(0x0FFFFFFFUL, SdFatFormat_TestGet32(fat, 16U));
+	TEST_ASSERT_EQUAL_UINT32(0x0FFFFFFFUL, SdFatFormat_TestGet32(fat, 20U));
+	TEST_ASSERT_EQUAL_UINT32(0U, SdFatFormat_TestGet32(fat, 24U));
+
+	/* "captured_images" is two long-name entries, then "CAPTUR~1". */
+	TEST_ASSERT_EQUAL_UINT32(0x42U, root[0]);
+	TEST_ASSERT_EQUAL_UINT32(0x0FU, root[11]);
+	TEST_ASSERT_EQUAL_UINT32('e', root[1]);
+	TEST_ASSERT_EQUAL_UINT32('s', root[3]);
+	TEST_ASSERT_EQUAL_UINT32(0U, SdFatFormat_TestGet16(root, 5U));
+	TEST_ASSERT_EQUAL_UINT32(0xFFFFU, SdFatFormat_TestGet16(root, 7U));
+	TEST_ASSERT_EQUAL_UINT32(0x01U, root[32]);
+	TEST_ASSERT_EQUAL_UINT32('c', root[33]);
+	TEST_ASSERT_TRUE(memcmp(&root[64], "CAPTUR~1   ", 11U) == 0);
+	for (uint32_t index = 0U; index < 11U; index++) {
+		checksum = (uint8_t) ((uint8_t) ((checksum & 1U) << 7U)
+				+ (checksum >> 1U) + root[64U + index]);
+	}
+	TEST_ASSERT_EQUAL_UINT32(checksum, root[13]);
+	TEST_ASSERT_EQUAL_UINT32(checksum, root[45]);
+	TEST_ASSERT_EQUAL_UINT32(0x10U, root[64U + 11U]);
+	TEST_ASSERT_EQUAL_UINT32(3U, SdFatFormat_TestGet16(root, 64U + 26U));
+	TEST_ASSERT_EQUAL_UINT32(0x5CE1U, SdFatFormat_TestGet16(root, 64U + 24U));
+	TEST_ASSERT_TRUE(memcmp(&root[128], "INFERE~1   ", 11U) == 0);
+	TEST_ASSERT_EQUAL_UINT32(5U, SdFatFormat_TestGet16(root, 128U + 26U));
+	TEST_ASSERT_EQUAL_UINT32(0U, root[160]);
+
+	TEST_ASSERT_TRUE(memcmp(&captures[0], ".          ", 11U) == 0);
+	TEST_ASSERT_EQUAL_UINT32(3U, SdFatFormat_TestGet16(captures, 26U));
+	TEST_ASSERT_TRUE(memcmp(&captures[32], "..         ", 11U) == 0);
+	TEST_ASSERT_EQUAL_UINT32(0U, SdFatFormat_TestGet16(captures, 32U + 26U));
+}
+
+/*==============================================================================
+ * Test: test_SdFatFormat_Write_RejectsBadInputAndReportsFailedWrites
+ *
+ * Expected:
+ *   Empty or overlong names and empty extents are refused before any write;
+ *   a failed write stops the format after the boot sectors were cleared and
+ *   before they are rewritten.
+ *==============================================================================*/
+void test_SdFatFormat_Write_RejectsBadInputAndReportsFailedWrites(void) {
+	const SdFatFormat_Config config = SdFatFormat_TestConfig();
+	SdFatFormat_Directory directories[1] = { { "inference", 1U } };
+	static SdFatFormat_TestRecorder recorder;
+	SdFatFormat_Layout layout;
+
+	TEST_ASSERT_EQUAL_INT32(0, SdFatFormat_PlanLayout(&config, &layout));
+	(void) memset(&recorder, 0, sizeof(recorder));
+	for (uint32_t index = 0U; index < TEST_RECORDED_SECTORS; index++) {
+		recorder.watched[index] = UINT32_MAX;
+	}
+
+	directories[0].name = "";
+	TEST_ASSERT_EQUAL_INT32(-1,
+			SdFatFormat_Write(&layout, directories, 1U, 1U, 0U,
+					SdFatFormat_TestWrite, &recorder));
+	directories[0].name = "a_directory_name_that_is_too_long";
+	TEST_ASSERT_EQUAL_INT32(-1,
+			SdFatFormat_Write(&layout, directories, 1U, 1U, 0U,
+					SdFatFormat_TestWrite, &recorder));
+	directories[0].name = "inference";
+	directories[0].clusters = 0U;
+	TEST_ASSERT_EQUAL_INT32(-1,
+			SdFatFormat_Write(&layout, directories, 1U, 1U, 0U,
+					SdFatFormat_TestWrite, &recorder));
+	TEST_ASSERT_EQUAL_UINT32(0U, recorder.write_count);
+
+	directories[0].clusters = 1U;
+	recorder.fail_after_writes = 10U;
+	recorder.last_sector = UINT32_MAX;
+	TEST_ASSERT_EQUAL_INT32(-2,
+			SdFatFormat_Write(&layout, directories, 1U, 1U, 0U,
+					SdFatFormat_TestWrite, &recorder));
+	TEST_ASSERT_EQUAL_UINT32(layout.reserved_sectors + 7U,
+			recorder.last_sector);
+}
@@ -0,0 +1,111 @@
+/*==============================================================================
+ * File: test_sensor_power.c
+ *
+ * Purpose:
+ *   Unity unit tests for the AppSensorPower policy module.
+ *
+ * Approach:
+ *   - Use the firmware's default tunables and feed idle gaps and measured
+ *     wake times the way the camera thread does after each cycle.
+ *==============================================================================*/
+
+#include "unity.h"
+#include "app_sensor_power.h"
+
+#include <stdint.h>
+
+/*==============================================================================
+ * Function: Test_InitDefaults
+ *
+ * Purpose:
+ *   Standby from 2 s (600 ms wake), off from 20 s (1.5 s wake), 100 ms guard,
+ *   off given up after two failed wakes.
+ *==============================================================================*/
+static void Test_InitDefaults(AppSensorPower_Context_t *context_ptr) {
+	const AppSensorPower_Config_t config = {
+		.initial_wake_ms = { 0U, 600U, 1500U },
+		.min_idle_ms = { 0U, 2000U, 20000U },
+		.guard_ms = 100U,
+		.max_wake_failures = 2U,
+	};
+
+	AppSensorPower_Init(context_ptr, &config);
+}
+
+/*==============================================================================
+ * Test: test_SensorPower_Choose_PicksDeepestStateThatFits
+ *
+ * Expected:
+ *   Short gaps keep streaming, medium gaps use standby, the 60 s capture gap
+ *   powers the sensor off, and the lead is the wake estimate plus guard.
+ *==============================================================================*/
+void test_SensorPower_Choose_PicksDeepestStateThatFits(void) {
+	AppSensorPower_Context_t context;
+
+	Test_InitDefaults(&context);
+
+	TEST_ASSERT_EQUAL_INT(APP_SENSOR_POWER_STREAMING,
+			AppSensorPower_Choose(&context, 1500U));
+	TEST_ASSERT_EQUAL_INT(APP_SENSOR_POWER_STANDBY,
+			AppSensorPower_Choose(&context, 5000U));
+	TEST_ASSERT_EQUAL_INT(APP_SENSOR_POWER_OFF,
+			AppSensorPower_Choose(&context, 60000U));
+	TEST_ASSERT_EQUAL_UINT32(1600U,
+			AppSensorPower_WakeLeadMs(&context, APP_SENSOR_POWER_OFF));
+	TEST_ASSERT_EQUAL_UINT32(700U,
+			AppSensorPower_WakeLeadMs(&context, APP_SENSOR_POWER_STANDBY));
+}
+
+/*==============================================================================
+ * Test: test_SensorPower_RecordWake_RisesAtOnceAndDecaysSlowly
+ *
+ * Expected:
+ *   The first measurement replaces the guess; a slower wake raises the
+ *   estimate immediately; a faster one only pulls it a quarter of the way.
+ *   A measured off-wake too slow for the gap pushes the choice to standby.
+ *==============================================================================*/
+void test_SensorPower_RecordWake_RisesAtOnceAndDecaysSlowly(void) {
+	AppSensorPower_Context_t context;
+
+	Test_InitDefaults(&context);
+
+	AppSensorPower_RecordWake(&context, APP_SENSOR_POWER_OFF, true, 1200U);
+	TEST_ASSERT_EQUAL_UINT32(1200U, context.wake_estimate_ms[APP_SENSOR_POWER_OFF]);
+
+	AppSensorPower_RecordWake(&context, APP_SENSOR_POWER_OFF, true, 2000U);
+	TEST_ASSERT_EQUAL_UINT32(2000U, context.wake_estimate_ms[APP_SENSOR_POWER_OFF]);
+
+	AppSensorPower_RecordWake(&context, APP_SENSOR_POWER_OFF, true, 1200U);
+	TEST_ASSERT_EQUAL_UINT32(1800U, context.wake_estimate_ms[APP_SENSOR_POWER_OFF]);
+
+	AppSensorPower_RecordWake(&context, APP_SENSOR_POWER_OFF, true, 25000U);
+	TEST_ASSERT_EQUAL_INT(APP_SENSOR_POWER_STANDBY,
+			AppSensorPower_Choose(&context, 22000U));
+}
+
+/*==============================================================================
+ * Test: test_SensorPower_FailedWakes_DisableOnlyAfterLimit
+ *
+ * Expected:
+ *   One failed power-on is tolerated; a success resets the count; two in a
+ *   row retire the off state and long gaps fall back to standby.
+ *==============================================================================*/
+void test_SensorPower_FailedWakes_DisableOnlyAfterLimit(void) {
+	AppSensorPower_Context_t context;
+
+	Test_InitDefaults(&context);
+
+	AppSensorPower_RecordWake(&context, APP_SENSOR_POWER_OFF, false, 0U);
+	TEST_ASSERT_EQUAL_INT(APP_SENSOR_POWER_OFF,
+			AppSensorPower_Choose(&context, 60000U));
+	AppSensorPower_RecordWake(&context, APP_SENSOR_POWER_OFF, true, 1400U);
+	AppSensorPower_RecordWake(&context, APP_SENSOR_POWER_OFF, false, 0U);
+	TEST_ASSERT_EQUAL_INT(APP_SENSOR_POWER_OFF,
+			AppSensorPower_Choose(&context, 60000U));
+
+	AppSensorPower_RecordWake(&context, APP_SENSOR_POWER_OFF, false, 0U);
+	TEST_ASSERT_EQUAL_INT(APP_SENSOR_POWER_STANDBY,
+			AppSensorPower_Choose(&context, 60000U));
+	TEST_ASSERT_EQUAL_STRING("standby",
+			AppSensorPower_StateName(APP_SENSOR_POWER_STANDBY));
+}
@@ -0,0 +1,128 @@
+/*==============================================================================
+ * File: test_xspi2_residency.c
+ *
+ * Purpose:
+ *   Unity unit tests for the AppXspi2Residency verify-once stage table.
+ *
+ * Approach:
+ *   - Use two dummy stage specs as keys and replay the per-reading
+ *     alternation between them, a provisioning write, a mapped window that
+ *     was turned off and a full table.
+ *==============================================================================*/
+
+#include "unity.h"
+#include "app_xspi2_residency.h"
+
+#include <stdint.h>
+
+#define TEST_OBB_OFFSET        0x01400000U
+#define TEST_TIP_FOCUS_OFFSET  0x00400000U
+
+static const int test_obb_stage = 1;
+static const int test_tip_focus_stage = 2;
+
+/*==============================================================================
+ * Test: test_Xspi2Residency_Alternation_VerifiesEachStageOnce
+ *
+ * Expected:
+ *   The first use of each stage needs a verify; once both are marked
+ *   resident, alternating between them stays mapped for every reading.
+ *==============================================================================*/
+void test_Xspi2Residency_Alternation_VerifiesEachStageOnce(void) {
+	AppXspi2Residency_Table_t table;
+
+	AppXspi2Residency_Init(&table);
+	TEST_ASSERT_EQUAL_INT(APP_XSPI2_RESIDENCY_VERIFY,
+			AppXspi2Residency_Plan(&table, &test_obb_stage, TEST_OBB_OFFSET,
+					false));
+	TEST_ASSERT_TRUE(AppXspi2Residency_MarkResident(&table, &test_obb_stage));
+	TEST_ASSERT_EQUAL_INT(APP_XSPI2_RESIDENCY_VERIFY,
+			AppXspi2Residency_Plan(&table, &test_tip_focus_stage,
+					TEST_TIP_FOCUS_OFFSET, true));
+	TEST_ASSERT_TRUE(AppXspi2Residency_MarkResident(&table,
+			&test_tip_focus_stage));
+	TEST_ASSERT_EQUAL_UINT32(2U, AppXspi2Residency_ResidentCount(&table));
+
+	for (uint32_t reading = 0U; reading < 10U; reading++) {
+		TEST_ASSERT_EQUAL_INT(APP_XSPI2_RESIDENCY_MAPPED,
+				AppXspi2Residency_Plan(&table, &test_obb_stage, TEST_OBB_OFFSET,
+						true));
+		TEST_ASSERT_EQUAL_INT(APP_XSPI2_RESIDENCY_MAPPED,
+				AppXspi2Residency_Plan(&table, &test_tip_focus_stage,
+						TEST_TIP_FOCUS_OFFSET, true));
+	}
+	TEST_ASSERT_EQUAL_UINT32(2U, table.entry_count);
+}
+
+/*==============================================================================
+ * Test: test_Xspi2Residency_Provisioning_ForcesReverify
+ *
+ * Expected:
+ *   A provisioning write drops every stage back to verify; a stage whose
+ *   region moved needs a verify too; a resident stage with the window off
+ *   only needs memory-mapped mode re-enabled.
+ *==============================================================================*/
+void test_Xspi2Residency_Provisioning_ForcesReverify(void) {
+	AppXspi2Residency_Table_t table;
+
+	AppXspi2Residency_Init(&table);
+	(void) AppXspi2Residency_Plan(&table, &test_obb_stage, TEST_OBB_OFFSET,
+			true);
+	(void) AppXspi2Residency_MarkResident(&table, &test_obb_stage);
+	TEST_ASSERT_EQUAL_INT(APP_XSPI2_RESIDENCY_ENABLE_MM,
+			AppXspi2Residency_Plan(&table, &test_obb_stage, TEST_OBB_OFFSET,
+					false));
+
+	AppXspi2Residency_InvalidateAll(&table);
+	TEST_ASSERT_FALSE(AppXspi2Residency_IsResident(&table, &test_obb_stage));
+	TEST_ASSERT_EQUAL_INT(APP_XSPI2_RESIDENCY_VERIFY,
+			AppXspi2Residency_Plan(&table, &test_obb_stage, TEST_OBB_OFFSET,
+					true));
+	(void) AppXspi2Residency_MarkResident(&table, &test_obb_stage);
+	TEST_ASSERT_TRUE(AppXspi2Residency_IsResident(&table, &test_obb_stage));
+
+	TEST_ASSERT_EQUAL_INT(APP_XSPI2_RESIDENCY_VERIFY,
+			AppXspi2Residency_Plan(&table, &test_obb_stage,
+					TEST_OBB_OFFSET + 0x10000U, true));
+	TEST_ASSERT_FALSE(AppXspi2Residency_IsResident(&table, &test_obb_stage));
+}
+
+/*==============================================================================
+ * Test: test_Xspi2Residency_ZeroedTableAndOverflow_StaySafe
+ *
+ * Expected:
+ *   A zero-initialized table reports nothing resident; stages past the
+ *   table size always verify and cannot be marked; unknown keys and a
+ *   generation wrap never produce a stale match.
+ *==============================================================================*/
+void test_Xspi2Residency_ZeroedTableAndOverflow_StaySafe(void) {
+	static AppXspi2Residency_Table_t table;
+	static const uint8_t keys[APP_XSPI2_RESIDENCY_MAX_STAGES + 1U] = { 0U };
+
+	TEST_ASSERT_FALSE(AppXspi2Residency_IsResident(&table, &keys[0]));
+	TEST_ASSERT_FALSE(AppXspi2Residency_MarkResident(&table, &keys[0]));
+	for (uint32_t index = 0U; index < APP_XSPI2_RESIDENCY_MAX_STAGES; index++) {
+		TEST_ASSERT_EQUAL_INT(APP_XSPI2_RESIDENCY_VERIFY,
+				AppXspi2Residency_Plan(&table, &keys[index], index * 0x10000U,
+						true));
+		TEST_ASSERT_TRUE(AppXspi2Residency_MarkResident(&table, &keys[index]));
+	}
+	TEST_ASSERT_EQUAL_UINT32(APP_XSPI2_RESIDENCY_MAX_STAGES,
+			AppXspi2Residency_ResidentCount(&table));
+
+	TEST_ASSERT_EQUAL_INT(APP_XSPI2_RESIDENCY_VERIFY,
+			AppXspi2Residency_Plan(&table,
+					&keys[APP_XSPI2_RESIDENCY_MAX_STAGES], 0x00800000U, true));
+	TEST_ASSERT_FALSE(AppXspi2Residency_MarkResident(&table,
+			&keys[APP_XSPI2_RESIDENCY_MAX_STAGES]));
+	TEST_ASSERT_EQUAL_INT(APP_XSPI2_RESIDENCY_VERIFY,
+			AppXspi2Residency_Plan(&table, NULL, 0U, true));
+
+	table.generation = UINT32_MAX;
+	(void) AppXspi2Residency_MarkResident(&table, &keys[0]);
+	AppXspi2Residency_InvalidateAll(&table);
+	TEST_ASSERT_EQUAL_UINT32(1U, table.generation);
+	TEST_ASSERT_EQUAL_UINT32(0U, AppXspi2Residency_ResidentCount(&table));
+	TEST_ASSERT_EQUAL_STRING("mapped",
+			AppXspi2Residency_ActionName(APP_XSPI2_RESIDENCY_MAPPED));
+}
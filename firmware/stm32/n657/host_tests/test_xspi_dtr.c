@@ -0,0 +1,270 @@
+/*==============================================================================
+ * File: test_xspi_dtr.c
+ *
+ * Purpose:
+ *   Unity unit tests for the AppXspiDtr octal DTR bring-up.
+ *
+ * Approach:
+ *   - Drive the bring-up against a simulated NOR: a small flash array, the
+ *     current transfer mode and a band of DQS taps that sample correctly in
+ *     DTR. Taps outside the band return bit-shifted data.
+ *   - Inject a rejected mode switch, a narrow window, corrupted mapped reads
+ *     and an erased pattern, and check the flash always ends in a known mode.
+ *==============================================================================*/
+
+#include "unity.h"
+#include "app_xspi_dtr.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#define TEST_NOR_BYTES      1024U
+#define TEST_NOR_TAPS         32U
+#define TEST_PATTERN_OFFSET    0U
+#define TEST_STAGE_OFFSET    256U
+#define TEST_REGION_BYTES     16U
+
+typedef struct {
+	uint8_t flash[TEST_NOR_BYTES];
+	bool dtr;
+	uint32_t tap;
+	uint32_t good_tap_first;
+	uint32_t good_tap_last;
+	bool reject_dtr;
+	bool corrupt_mapped;
+	uint8_t dummy_cycles;
+	uint32_t enter_dtr_calls;
+	uint32_t enter_str_calls;
+	uint32_t reads;
+} TestNor_t;
+
+static TestNor_t test_nor;
+
+static bool TestNor_EnterStr(void *ctx) {
+	TestNor_t *nor = (TestNor_t *) ctx;
+
+	nor->dtr = false;
+	nor->enter_str_calls++;
+	return true;
+}
+
+static bool TestNor_EnterDtr(void *ctx, uint8_t dummy_cycles) {
+	TestNor_t *nor = (TestNor_t *) ctx;
+
+	nor->enter_dtr_calls++;
+	nor->dummy_cycles = dummy_cycles;
+	if (nor->reject_dtr) {
+		return false;
+	}
+	nor->dtr = true;
+	return true;
+}
+
+static bool TestNor_SetDelayTap(void *ctx, uint32_t tap) {
+	((TestNor_t *) ctx)->tap = tap;
+	return true;
+}
+
+static bool TestNor_Sample(TestNor_t *nor, uint32_t offset, uint8_t *dst,
+		uint32_t length) {
+	const bool good = !nor->dtr
+			|| ((nor->tap >= nor->good_tap_first)
+					&& (nor->tap <= nor->good_tap_last));
+
+	if ((offset + length) > TEST_NOR_BYTES) {
+		return false;
+	}
+	for (uint32_t i = 0U; i < length; i++) {
+		/* A tap outside the eye latches the neighbouring bit. */
+		dst[i] = good ? nor->flash[offset + i]
+				: (uint8_t) (nor->flash[offset + i] << 1);
+	}
+	nor->reads++;
+	return true;
+}
+
+static bool TestNor_Read(void *ctx, uint32_t offset, uint8_t *dst,
+		uint32_t length) {
+	return TestNor_Sample((TestNor_t *) ctx, offset, dst, length);
+}
+
+static bool TestNor_ReadMapped(void *ctx, uint32_t offset, uint8_t *dst,
+		uint32_t length) {
+	TestNor_t *nor = (TestNor_t *) ctx;
+
+	if (!TestNor_Sample(nor, offset, dst, length)) {
+		return false;
+	}
+	if (nor->corrupt_mapped && nor->dtr) {
+		dst[length - 1U] ^= 0x01U;
+	}
+	return true;
+}
+
+static const AppXspiDtr_Ops_t test_ops = {
+	.enter_str = TestNor_EnterStr,
+	.enter_dtr = TestNor_EnterDtr,
+	.set_delay_tap = TestNor_SetDelayTap,
+	.read = TestNor_Read,
+	.read_mapped = TestNor_ReadMapped,
+	.ctx = &test_nor,
+};
+
+static uint8_t test_stage_signature[TEST_REGION_BYTES];
+static AppXspiDtr_Region_t test_regions[2];
+
+static AppXspiDtr_Config_t TestNor_Reset(uint32_t good_first,
+		uint32_t good_last) {
+	AppXspiDtr_Config_t config;
+
+	(void) memset(&test_nor, 0, sizeof(test_nor));
+	for (uint32_t i = 0U; i < TEST_NOR_BYTES; i++) {
+		test_nor.flash[i] = (uint8_t) ((i * 37U) ^ 0xA5U);
+	}
+	test_nor.good_tap_first = good_first;
+	test_nor.good_tap_last = good_last;
+	(void) memcpy(test_stage_signature, &test_nor.flash[TEST_STAGE_OFFSET],
+			sizeof(test_stage_signature));
+
+	test_regions[0].offset = TEST_PATTERN_OFFSET;
+	test_regions[0].length = TEST_REGION_BYTES;
+	test_regions[0].expected = NULL;
+	test_regions[1].offset = TEST_STAGE_OFFSET;
+	test_regions[1].length = TEST_REGION_BYTES;
+	test_regions[1].expected = test_stage_signature;
+
+	config.regions = test_regions;
+	config.region_count = 2U;
+	config.tap_count = TEST_NOR_TAPS;
+	config.min_window_taps = 4U;
+	config.reads_per_tap = 2U;
+	config.dtr_dummy_cycles = 6U;
+	return config;
+}
+
+/*==============================================================================
+ * Test: test_XspiDtr_FindWidestWindow_PrefersWidestLowestRun
+ *
+ * Expected:
+ *   The widest run wins, ties go to the lower run, and an all-fail sweep
+ *   reports no window.
+ *==============================================================================*/
+void test_XspiDtr_FindWidestWindow_PrefersWidestLowestRun(void) {
+	const bool sweep[10] = { true, false, true, true, true, false, true, true,
+			true, true };
+	const bool ties[8] = { false, true, true, false, true, true, false,
+			false };
+	const bool none[4] = { false, false, false, false };
+	uint32_t start = 99U;
+	uint32_t width = 99U;
+
+	TEST_ASSERT_TRUE(AppXspiDtr_FindWidestWindow(sweep, 10U, &start, &width));
+	TEST_ASSERT_EQUAL_UINT32(6U, start);
+	TEST_ASSERT_EQUAL_UINT32(4U, width);
+
+	TEST_ASSERT_TRUE(AppXspiDtr_FindWidestWindow(ties, 8U, &start, &width));
+	TEST_ASSERT_EQUAL_UINT32(1U, start);
+	TEST_ASSERT_EQUAL_UINT32(2U, width);
+
+	TEST_ASSERT_FALSE(AppXspiDtr_FindWidestWindow(none, 4U, &start, &width));
+	TEST_ASSERT_EQUAL_UINT32(0U, width);
+	TEST_ASSERT_FALSE(AppXspiDtr_FindWidestWindow(NULL, 4U, &start, &width));
+}
+
+/*==============================================================================
+ * Test: test_XspiDtr_BringUp_CentresWindowAndValidates
+ *
+ * Expected:
+ *   With taps 10..19 good, the flash ends in DTR at tap 15 with both regions
+ *   validated and the configured dummy cycles programmed.
+ *==============================================================================*/
+void test_XspiDtr_BringUp_CentresWindowAndValidates(void) {
+	const AppXspiDtr_Config_t config = TestNor_Reset(10U, 19U);
+	AppXspiDtr_Result_t result;
+
+	TEST_ASSERT_EQUAL_INT(APP_XSPI_DTR_STATE_DTR_ACTIVE,
+			AppXspiDtr_BringUp(&config, &test_ops, &result));
+	TEST_ASSERT_EQUAL_INT(APP_XSPI_DTR_FAILURE_NONE, result.failure);
+	TEST_ASSERT_EQUAL_UINT32(10U, result.passing_taps);
+	TEST_ASSERT_EQUAL_UINT32(10U, result.window_start);
+	TEST_ASSERT_EQUAL_UINT32(10U, result.window_taps);
+	TEST_ASSERT_EQUAL_UINT32(15U, result.selected_tap);
+	TEST_ASSERT_EQUAL_UINT32(2U, result.validated_regions);
+	TEST_ASSERT_TRUE(test_nor.dtr);
+	TEST_ASSERT_EQUAL_UINT32(15U, test_nor.tap);
+	TEST_ASSERT_EQUAL_UINT8(6U, test_nor.dummy_cycles);
+	TEST_ASSERT_EQUAL_UINT32(0U, test_nor.enter_str_calls);
+}
+
+/*==============================================================================
+ * Test: test_XspiDtr_BringUp_FallsBackToStr
+ *
+ * Expected:
+ *   A rejected switch, a window narrower than the minimum and a corrupted
+ *   mapped read each restore STR once and report why. The stage region does
+ *   not count when its STR read does not match the signature.
+ *==============================================================================*/
+void test_XspiDtr_BringUp_FallsBackToStr(void) {
+	AppXspiDtr_Config_t config = TestNor_Reset(10U, 19U);
+	AppXspiDtr_Result_t result;
+
+	test_nor.reject_dtr = true;
+	TEST_ASSERT_EQUAL_INT(APP_XSPI_DTR_STATE_STR_FALLBACK,
+			AppXspiDtr_BringUp(&config, &test_ops, &result));
+	TEST_ASSERT_EQUAL_INT(APP_XSPI_DTR_FAILURE_MODE_SWITCH, result.failure);
+	TEST_ASSERT_FALSE(test_nor.dtr);
+	TEST_ASSERT_EQUAL_UINT32(1U, test_nor.enter_str_calls);
+
+	config = TestNor_Reset(10U, 12U);
+	TEST_ASSERT_EQUAL_INT(APP_XSPI_DTR_STATE_STR_FALLBACK,
+			AppXspiDtr_BringUp(&config, &test_ops, &result));
+	TEST_ASSERT_EQUAL_INT(APP_XSPI_DTR_FAILURE_NARROW_WINDOW, result.failure);
+	TEST_ASSERT_EQUAL_UINT32(3U, result.window_taps);
+	TEST_ASSERT_FALSE(test_nor.dtr);
+	TEST_ASSERT_EQUAL_UINT32(1U, test_nor.enter_str_calls);
+
+	config = TestNor_Reset(10U, 19U);
+	test_nor.corrupt_mapped = true;
+	TEST_ASSERT_EQUAL_INT(APP_XSPI_DTR_STATE_STR_FALLBACK,
+			AppXspiDtr_BringUp(&config, &test_ops, &result));
+	TEST_ASSERT_EQUAL_INT(APP_XSPI_DTR_FAILURE_VALIDATION, result.failure);
+	TEST_ASSERT_FALSE(test_nor.dtr);
+
+	/* A stale stage image is skipped, not blamed on DTR. */
+	config = TestNor_Reset(10U, 19U);
+	test_stage_signature[0] ^= 0xFFU;
+	TEST_ASSERT_EQUAL_INT(APP_XSPI_DTR_STATE_DTR_ACTIVE,
+			AppXspiDtr_BringUp(&config, &test_ops, &result));
+	TEST_ASSERT_EQUAL_UINT32(1U, result.validated_regions);
+}
+
+/*==============================================================================
+ * Test: test_XspiDtr_BringUp_ErasedPatternStaysInStr
+ *
+ * Expected:
+ *   An erased (all 0xFF) pattern cannot calibrate anything, so the flash is
+ *   never switched and no delay tap is touched. Invalid configs are refused
+ *   the same way.
+ *==============================================================================*/
+void test_XspiDtr_BringUp_ErasedPatternStaysInStr(void) {
+	AppXspiDtr_Config_t config = TestNor_Reset(10U, 19U);
+	AppXspiDtr_Result_t result;
+
+	(void) memset(&test_nor.flash[TEST_PATTERN_OFFSET], 0xFF,
+			TEST_REGION_BYTES);
+	TEST_ASSERT_EQUAL_INT(APP_XSPI_DTR_STATE_STR_FALLBACK,
+			AppXspiDtr_BringUp(&config, &test_ops, &result));
+	TEST_ASSERT_EQUAL_INT(APP_XSPI_DTR_FAILURE_NO_PATTERN, result.failure);
+	TEST_ASSERT_EQUAL_UINT32(0U, test_nor.enter_dtr_calls);
+	TEST_ASSERT_EQUAL_UINT32(0U, test_nor.enter_str_calls);
+
+	config = TestNor_Reset(10U, 19U);
+	config.tap_count = APP_XSPI_DTR_MAX_TAPS + 1U;
+	TEST_ASSERT_EQUAL_INT(APP_XSPI_DTR_STATE_STR_FALLBACK,
+			AppXspiDtr_BringUp(&config, &test_ops, &result));
+	TEST_ASSERT_EQUAL_INT(APP_XSPI_DTR_FAILURE_CONFIG, result.failure);
+	TEST_ASSERT_EQUAL_UINT32(0U, test_nor.reads);
+	TEST_ASSERT_EQUAL_STRING("config",
+			AppXspiDtr_FailureName(result.failure));
+}
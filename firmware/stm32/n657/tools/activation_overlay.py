@@ -0,0 +1,272 @@
+"""Plan a shared activation arena for the sequential NPU stages.
+
+Reads the LL_Buffer_InfoTypeDef tables in each stage's generated network C
+file and measures the span its activations occupy inside the arena window
+(the OBB reloc window at 0x34100000 by default). Stages then get offsets in
+one shared arena:
+  - stages whose lifetimes (pipeline steps) do not intersect may share bytes,
+  - stages live at the same step get disjoint ranges,
+  - pinned stages keep the offset their package was compiled for; the
+    planner only places stages marked relocatable.
+
+The plan is written to Appli/Inc/app_activation_overlay_plan.h, which the
+firmware checks at boot against the buffers the runtime actually placed
+(app_activation_overlay.c). Whatever lies past the plan's high-water mark is
+free for frame buffers or resident weights.
+
+Stages come from tools/activation_overlay_stages.json; paths are relative to
+firmware/stm32/n657. A stage may also name a define in its *_reloc_conf.h
+that gives the activation pool size, which then bounds the region from below.
+
+Usage:
+    python activation_overlay.py
+    python activation_overlay.py --check    # fail if the header is stale
+
+Exit status: 0 plan written or up to date, 1 conflict or stale header,
+2 bad input.
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import re
+import sys
+from dataclasses import dataclass, field
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parents[1]
+DEFAULT_STAGES = Path(__file__).with_name("activation_overlay_stages.json")
+DEFAULT_HEADER = ROOT / "Appli" / "Inc" / "app_activation_overlay_plan.h"
+
+TABLE_FUNCTION = re.compile(
+    r"LL_ATON_(Input|Output|Internal)_Buffers_Info_(\w+)\s*\(\s*void\s*\)\s*\{")
+BUFFER_NAME = re.compile(r"\.name\s*=\s*\"([^\"]+)\"")
+ADDR_BASE = re.compile(r"\.addr_base\s*=\s*\{[^}]*?\b(0x[0-9A-Fa-f]+)")
+DEFINE = re.compile(r"^\s*#\s*define\s+(\w+)\s+\(?\s*(0x[0-9A-Fa-f]+|\d+)[uUlL]*\s*\)?",
+                    re.MULTILINE)
+
+
+def int_field(text: str, name: str) -> int | None:
+    match = re.search(r"\." + name + r"\s*=\s*(0x[0-9A-Fa-f]+|\d+)", text)
+    return int(match.group(1), 0) if match else None
+
+
+def align_up(value: int, align: int) -> int:
+    return (value + align - 1) // align * align
+
+
+@dataclass
+class Buffer:
+    name: str
+    table: str
+    address: int
+    size: int
+
+
+@dataclass
+class Stage:
+    name: str
+    first_step: int
+    last_step: int
+    relocatable: bool
+    buffers: list[Buffer] = field(default_factory=list)
+    unresolved: int = 0
+    outside: int = 0
+    start: int = 0
+    end: int = 0
+    pool_size: int = 0
+    offset: int = 0
+
+    @property
+    def size(self) -> int:
+        return max(self.end - self.start, self.pool_size)
+
+    def live_with(self, other: Stage) -> bool:
+        return (self.first_step <= other.last_step
+                and other.first_step <= self.last_step)
+
+
+def read_buffers(text: str) -> tuple[list[Buffer], int]:
+    """Return the activation buffers of a generated network and how many
+    entries had no literal base address."""
+    tables = [(m.start(), m.group(1)) for m in TABLE_FUNCTION.finditer(text)]
+    names = list(BUFFER_NAME.finditer(text))
+    buffers: list[Buffer] = []
+    seen: set[str] = set()
+    unresolved = 0
+    for index, match in enumerate(names):
+        end = names[index + 1].start() if index + 1 < len(names) else len(text)
+        entry = text[match.start():end]
+        table = next((kind for pos, kind in reversed(tables)
+                      if pos < match.start()), "?")
+        if match.group(1) in seen or int_field(entry, "is_param"):
+            continue
+        seen.add(match.group(1))
+        base = ADDR_BASE.search(entry)
+        start = int_field(entry, "offset_start")
+        stop = int_field(entry, "offset_end")
+        if base is None or start is None or stop is None:
+            unresolved += 1
+            continue
+        buffers.append(Buffer(match.group(1), table,
+                              int(base.group(1), 16) + start, stop - start))
+    return buffers, unresolved
+
+
+def load_stages(config: dict, arena_base: int, arena_size: int) -> list[Stage]:
+    stages: list[Stage] = []
+    for entry in config["stages"]:
+        step = int(entry["step"])
+        stage = Stage(entry["name"], step, int(entry.get("live_until", step)),
+                      bool(entry.get("relocatable", False)))
+        source = ROOT / entry["source"]
+        stage.buffers, stage.unresolved = read_buffers(
+            source.read_text(errors="replace"))
+        inside = [b for b in stage.buffers
+                  if arena_base <= b.address < arena_base + arena_size]
+        stage.outside = len(stage.buffers) - len(inside)
+        for buffer in inside:
+            if buffer.address + buffer.size > arena_base + arena_size:
+                raise ValueError(f"{stage.name}: {buffer.name} runs past the arena")
+        if inside:
+            stage.start = min(b.address for b in inside) - arena_base
+            stage.end = max(b.address + b.size for b in inside) - arena_base
+        if "reloc_conf" in entry:
+            defines = {name: int(value, 0) for name, value in DEFINE.findall(
+                (ROOT / entry["reloc_conf"]).read_text(errors="replace"))}
+            if entry["pool_size_define"] not in defines:
+                raise ValueError(f"{stage.name}: {entry['pool_size_define']} "
+                                 f"not defined in {entry['reloc_conf']}")
+            stage.pool_size = defines[entry["pool_size_define"]]
+        stages.append(stage)
+    return stages
+
+
+def place(stages: list[Stage], align: int) -> list[str]:
+    """Assign offsets; return the conflicts that make the plan unusable."""
+    problems: list[str] = []
+    placed = [s for s in stages if not s.relocatable]
+    for stage in placed:
+        stage.offset = stage.start
+    for index, first in enumerate(placed):
+        for second in placed[index + 1:]:
+            if (first.live_with(second) and first.size and second.size
+                    and first.offset < second.offset + second.size
+                    and second.offset < first.offset + first.size):
+                problems.append(f"pinned stages {first.name} and {second.name} "
+                                f"are live together and overlap")
+
+    # Greedy first fit, largest first: each region goes to the lowest offset
+    # that clears every region live at one of its steps.
+    for stage in sorted((s for s in stages if s.relocatable),
+                        key=lambda s: s.size, reverse=True):
+        offset = 0
+        for other in sorted((o for o in placed if o.live_with(stage) and o.size),
+                            key=lambda o: o.offset):
+            if offset + stage.size <= other.offset:
+                break
+            offset = max(offset, align_up(other.offset + other.size, align))
+        stage.offset = offset
+        placed.append(stage)
+    return problems
+
+
+def render_header(stages: list[Stage], arena_base: int, arena_size: int,
+                  config_name: str) -> str:
+    used = max((s.offset + s.size for s in stages), default=0)
+    lines = [
+        "/* USER CODE BEGIN Header */",
+        "/**",
+        " ******************************************************************************",
+        " * @file    app_activation_overlay_plan.h",
+        " * @brief   Activation arena plan for the sequential NPU stages.",
+        " *",
+        f" * Written by tools/activation_overlay.py from tools/{config_name};",
+        " * re-run it after regenerating a model package instead of editing this",
+        " * file. Checked at boot by app_activation_overlay.c.",
+        " ******************************************************************************",
+        " */",
+        "/* USER CODE END Header */",
+        "",
+        "#ifndef __APP_ACTIVATION_OVERLAY_PLAN_H",
+        "#define __APP_ACTIVATION_OVERLAY_PLAN_H",
+        "",
+        f"#define APP_ACTIVATION_ARENA_BASE_ADDR   0x{arena_base:08X}UL",
+        f"#define APP_ACTIVATION_ARENA_SIZE_BYTES  {arena_size}UL",
+        "/* High-water mark of the plan; [USED, SIZE) is free for other buffers. */",
+        f"#define APP_ACTIVATION_ARENA_USED_BYTES  {used}UL",
+        "/* Set until the tool writes a plan from real buffer tables. */",
+        "#define APP_ACTIVATION_OVERLAY_PLAN_PLACEHOLDER  0U",
+        "",
+        f"#define APP_ACTIVATION_OVERLAY_REGION_COUNT  {len(stages)}U",
+        "/* { network name, offset, size, first step, last step } */",
+        "#define APP_ACTIVATION_OVERLAY_REGIONS \\",
+    ]
+    rows = [f"\t{{ \"{s.name}\", 0x{s.offset:08X}UL, {s.size}UL, "
+            f"{s.first_step}U, {s.last_step}U }}" for s in stages]
+    lines += [row + (", \\" if i + 1 < len(rows) else "")
+              for i, row in enumerate(rows)]
+    lines += ["", "#endif /* __APP_ACTIVATION_OVERLAY_PLAN_H */", ""]
+    return "\n".join(lines)
+
+
+def print_report(stages: list[Stage], arena_size: int) -> None:
+    print(f"{'Stage':<40} {'steps':>7} {'offset':>10} {'size':>9} "
+          f"{'buffers':>7} {'outside':>7} {'unres.':>6}  placement")
+    for stage in stages:
+        print(f"{stage.name:<40} {stage.first_step:>3}..{stage.last_step:<3} "
+              f"0x{stage.offset:08X} {stage.size:>9} {len(stage.buffers):>7} "
+              f"{stage.outside:>7} {stage.unresolved:>6}  "
+              f"{'relocatable' if stage.relocatable else 'pinned'}")
+    used = max((s.offset + s.size for s in stages), default=0)
+    separate = sum(s.size for s in stages)
+    print(f"\narena {arena_size} bytes, plan uses {used}, "
+          f"free {arena_size - used}; separate placement would need {separate}")
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("stages", type=Path, nargs="?", default=DEFAULT_STAGES,
+                        help="stage list (JSON)")
+    parser.add_argument("--output", type=Path, default=DEFAULT_HEADER,
+                        help="plan header to write")
+    parser.add_argument("--check", action="store_true",
+                        help="compare with the existing header instead of writing")
+    args = parser.parse_args()
+
+    try:
+        config = json.loads(args.stages.read_text())
+        arena = config["arena"]
+        arena_base = int(str(arena["base"]), 0)
+        arena_size = int(str(arena["size"]), 0)
+        stages = load_stages(config, arena_base, arena_size)
+    except (OSError, ValueError, KeyError) as error:
+        print(f"activation_overlay: {error}", file=sys.stderr)
+        return 2
+
+    problems = place(stages, int(arena.get("align", 32)))
+    print_report(stages, arena_size)
+    for stage in stages:
+        if stage.offset + stage.size > arena_size:
+            problems.append(f"{stage.name} does not fit in the arena")
+    for problem in problems:
+        print(f"CONFLICT {problem}")
+    if problems:
+        return 1
+
+    header = render_header(stages, arena_base, arena_size, args.stages.name)
+    if args.check:
+        current = args.output.read_text() if args.output.exists() else ""
+        if current != header:
+            print(f"{args.output}: stale; re-run without --check")
+            return 1
+        print(f"{args.output}: up to date")
+        return 0
+    args.output.write_text(header)
+    print(f"{args.output}: plan written")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,70 @@
+"""Write the 32-byte FSBL application image header for an app binary.
+
+The FSBL reads this header from its own flash sector (0x700FF000) to learn
+how many bytes of the application to copy into AXISRAM1 and which CRC-32
+the copy must have. Layout matches FSBL/Inc/fsbl_app_image.h.
+
+Usage:
+    python make_app_image_header.py Appli/Debug/n657_Appli.bin app_header.bin
+
+Flash the output at 0x700FF000 next to the signed application. Pass the
+unsigned binary: the FSBL copies the payload that follows the STM2 header.
+"""
+
+from __future__ import annotations
+
+import argparse
+import struct
+import zlib
+from pathlib import Path
+
+MAGIC = 0x48505041  # "APPH"
+VERSION = 1
+HEADER_SIZE = 32
+DEFAULT_LOAD_ADDRESS = 0x34000400
+MAX_IMAGE_SIZE = 0x80000
+
+
+def build_header(image: bytes, load_address: int) -> bytes:
+    """Return the header bytes for ``image`` loaded at ``load_address``."""
+    if not 8 <= len(image) <= MAX_IMAGE_SIZE:
+        raise ValueError(
+            f"image is {len(image)} bytes; the FSBL slot holds 8..{MAX_IMAGE_SIZE}"
+        )
+    body = struct.pack(
+        "<IHHIIIII",
+        MAGIC,
+        VERSION,
+        HEADER_SIZE,
+        load_address,
+        len(image),
+        zlib.crc32(image),
+        0,
+        0,
+    )
+    return body + struct.pack("<I", zlib.crc32(body))
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("image", type=Path, help="application .bin (unsigned)")
+    parser.add_argument("output", type=Path, help="header .bin to flash")
+    parser.add_argument(
+        "--load-address",
+        type=lambda text: int(text, 0),
+        default=DEFAULT_LOAD_ADDRESS,
+        help="RAM address the FSBL copies to (default 0x34000400)",
+    )
+    args = parser.parse_args()
+
+    image = args.image.read_bytes()
+    header = build_header(image, args.load_address)
+    args.output.write_bytes(header)
+    print(
+        f"{args.output}: size={len(image)} crc=0x{zlib.crc32(image):08X} "
+        f"load=0x{args.load_address:08X}"
+    )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,394 @@
+"""Report and gate the application's memory map from the linked ELF.
+
+Reads n657_Appli.elf (and optionally n657_Appli.map) and prints:
+  - usage of every linker memory region (from the map) and RAM bank,
+  - the largest symbols with their bank, output section and object file,
+  - placement problems for buffers that DMA or the NPU touch,
+  - growth against a checked-in baseline, failing past the thresholds.
+
+Rules (which buffers DMA/NPU touch, thresholds) live in
+tools/memory_budget_rules.json. The baseline is written from a known-good
+build with --write-baseline and checked in next to it.
+
+Usage:
+    python3 memory_budget.py Appli/Debug/n657_Appli.elf \
+        --map Appli/Debug/n657_Appli.map \
+        --baseline tools/memory_budget_baseline.json
+    python3 memory_budget.py Appli/Debug/n657_Appli.elf --write-baseline \
+        tools/memory_budget_baseline.json
+
+Exit status: 0 within budget, 1 regression or placement error, 2 bad input.
+"""
+
+from __future__ import annotations
+
+import argparse
+import bisect
+import json
+import re
+import struct
+import sys
+from dataclasses import dataclass, field
+from pathlib import Path
+
+DEFAULT_RULES = Path(__file__).with_name("memory_budget_rules.json")
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+SHT_SYMTAB = 2
+STT_OBJECT = 1
+
+
+@dataclass(frozen=True)
+class Bank:
+    """One physical memory on the STM32N657, at its secure alias."""
+
+    name: str
+    base: int
+    size: int
+    dma: bool  # Reachable by DCMIPP/GPDMA.
+    npu: bool  # Reachable by the NPU bus masters.
+    slow: bool  # Off-chip; every miss pays the xSPI latency.
+
+
+# Secure aliases; the non-secure alias clears bit 28 (0x34... -> 0x24...).
+# FLEXRAM shares the first 400 KB of AXISRAM1 and stays system RAM in the
+# LRUN layout, so it is reported as part of AXISRAM1.
+BANKS = (
+    Bank("ITCM", 0x10000000, 0x00040000, dma=False, npu=False, slow=False),
+    Bank("DTCM", 0x30000000, 0x00040000, dma=False, npu=False, slow=False),
+    Bank("AXISRAM1", 0x34000000, 0x00100000, dma=True, npu=True, slow=False),
+    Bank("AXISRAM2", 0x34100000, 0x00100000, dma=True, npu=True, slow=False),
+    Bank("AXISRAM3", 0x34200000, 0x00070000, dma=True, npu=True, slow=False),
+    Bank("AXISRAM4", 0x34270000, 0x00070000, dma=True, npu=True, slow=False),
+    Bank("AXISRAM5", 0x342E0000, 0x00070000, dma=True, npu=True, slow=False),
+    Bank("AXISRAM6", 0x34350000, 0x00070000, dma=True, npu=True, slow=False),
+    Bank("CACHEAXI", 0x343C0000, 0x00040000, dma=False, npu=True, slow=False),
+    Bank("VENCRAM", 0x34400000, 0x00020000, dma=True, npu=False, slow=False),
+    Bank("xSPI2", 0x70000000, 0x10000000, dma=True, npu=True, slow=True),
+    Bank("xSPI3", 0x80000000, 0x10000000, dma=True, npu=True, slow=True),
+    Bank("xSPI1", 0x90000000, 0x10000000, dma=True, npu=True, slow=True),
+)
+
+
+def secure_alias(address: int) -> int:
+    """Fold the non-secure RAM aliases onto the secure ones."""
+    if 0x00000000 <= address < 0x10000000 or 0x20000000 <= address < 0x30000000:
+        return address | 0x10000000
+    return address
+
+
+def bank_for(address: int) -> Bank | None:
+    address = secure_alias(address)
+    for bank in BANKS:
+        if bank.base <= address < bank.base + bank.size:
+            return bank
+    return None
+
+
+@dataclass
+class Section:
+    name: str
+    address: int
+    size: int
+    nobits: bool
+
+
+@dataclass
+class Symbol:
+    name: str
+    address: int
+    size: int
+    section: str
+    obj: str = ""
+
+
+@dataclass
+class Region:
+    name: str
+    origin: int
+    length: int
+    used: int = 0
+
+
+@dataclass
+class Image:
+    sections: list[Section] = field(default_factory=list)
+    symbols: list[Symbol] = field(default_factory=list)
+    markers: dict[str, int] = field(default_factory=dict)
+
+
+def read_elf(data: bytes) -> Image:
+    """Return the allocated sections and data symbols of an ELF image."""
+    if data[:4] != b"\x7fELF":
+        raise ValueError("not an ELF file")
+    is64 = data[4] == 2
+    if data[5] != 1:
+        raise ValueError("only little-endian ELF is supported")
+
+    if is64:
+        shoff, = struct.unpack_from("<Q", data, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x3A)
+        sh_fmt, sym_fmt = "<IIQQQQIIQQ", "<IBBHQQ"
+    else:
+        shoff, = struct.unpack_from("<I", data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x2E)
+        sh_fmt, sym_fmt = "<IIIIIIIIII", "<IIIBBH"
+
+    headers = [struct.unpack_from(sh_fmt, data, shoff + i * shentsize)
+               for i in range(shnum)]
+    shstr = headers[shstrndx]
+
+    def string(table_offset: int, offset: int) -> str:
+        end = data.index(b"\0", table_offset + offset)
+        return data[table_offset + offset:end].decode("ascii", "replace")
+
+    names = [string(shstr[4], h[0]) for h in headers]
+    image = Image()
+    for name, h in zip(names, headers):
+        sh_type, flags, addr, size = h[1], h[2], h[3], h[5]
+        if flags & SHF_ALLOC and size:
+            image.sections.append(Section(name, addr, size, sh_type == SHT_NOBITS))
+
+    for h in headers:
+        if h[1] != SHT_SYMTAB:
+            continue
+        strtab = headers[h[6]][4]
+        entsize = h[9]
+        for offset in range(h[4], h[4] + h[5], entsize):
+            if is64:
+                st_name, info, _, shndx, value, size = struct.unpack_from(
+                    sym_fmt, data, offset)
+            else:
+                st_name, value, size, info, _, shndx = struct.unpack_from(
+                    sym_fmt, data, offset)
+            name = string(strtab, st_name)
+            if name.startswith("__") and name.endswith("noncacheable"):
+                image.markers[name] = value
+            if (info & 0xF) != STT_OBJECT or size == 0 or not 0 < shndx < shnum:
+                continue
+            if not headers[shndx][2] & SHF_ALLOC:
+                continue
+            image.symbols.append(Symbol(name, value, size, names[shndx]))
+    return image
+
+
+MEMORY_LINE = re.compile(r"^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)")
+INPUT_LINE = re.compile(r"^ (?:\S+)?\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*\.o\)?)$")
+
+
+def read_map(text: str) -> tuple[list[Region], list[tuple[int, int, str]]]:
+    """Return the linker memory regions and (address, size, object) inputs."""
+    regions: list[Region] = []
+    inputs: list[tuple[int, int, str]] = []
+    lines = text.splitlines()
+    in_memory = False
+    for line in lines:
+        if line.startswith("Memory Configuration"):
+            in_memory = True
+            continue
+        if in_memory:
+            if line.startswith("Linker script and memory map"):
+                in_memory = False
+                continue
+            match = MEMORY_LINE.match(line)
+            if match and match.group(1) not in ("Name", "*default*"):
+                regions.append(Region(match.group(1), int(match.group(2), 16),
+                                      int(match.group(3), 16)))
+            continue
+        match = INPUT_LINE.match(line)
+        if match:
+            address, size = int(match.group(1), 16), int(match.group(2), 16)
+            if size:
+                # Keep the object name only; archive members look like
+                # "libc_nano.a(lib_a-memcpy.o)".
+                obj = re.split(r"[\\/]", match.group(3))[-1]
+                inputs.append((address, size, obj))
+    inputs.sort()
+    return regions, inputs
+
+
+def attribute_objects(symbols: list[Symbol],
+                      inputs: list[tuple[int, int, str]]) -> None:
+    starts = [entry[0] for entry in inputs]
+    for symbol in symbols:
+        index = bisect.bisect_right(starts, symbol.address) - 1
+        if index >= 0:
+            address, size, obj = inputs[index]
+            if address <= symbol.address < address + size:
+                symbol.obj = obj
+
+
+def overlap(start: int, size: int, base: int, length: int) -> int:
+    return max(0, min(start + size, base + length) - max(start, base))
+
+
+def bank_usage(sections: list[Section]) -> dict[str, int]:
+    used: dict[str, int] = {}
+    for section in sections:
+        start = secure_alias(section.address)
+        for bank in BANKS:
+            bytes_in_bank = overlap(start, section.size, bank.base, bank.size)
+            if bytes_in_bank:
+                used[bank.name] = used.get(bank.name, 0) + bytes_in_bank
+    return used
+
+
+def region_usage(regions: list[Region], sections: list[Section]) -> None:
+    for region in regions:
+        region.used = sum(overlap(s.address, s.size, region.origin, region.length)
+                          for s in sections)
+
+
+def check_placement(image: Image, rules: dict) -> list[str]:
+    """Flag DMA/NPU buffers that sit where their masters are slow or blind."""
+    problems: list[str] = []
+    by_name = {symbol.name: symbol for symbol in image.symbols}
+    nc_start = image.markers.get("__snoncacheable")
+    nc_end = image.markers.get("__enoncacheable")
+
+    for rule in rules.get("buffers", []):
+        symbol = by_name.get(rule["symbol"])
+        if symbol is None:
+            if rule.get("required", False):
+                problems.append(f"{rule['symbol']}: missing from the image")
+            continue
+        access = rule["access"]
+        bank = bank_for(symbol.address)
+        where = f"{symbol.name} @0x{symbol.address:08X} ({symbol.section}, " \
+                f"{bank.name if bank else 'unknown bank'})"
+        if bank is None:
+            problems.append(f"{where}: outside every known bank")
+            continue
+        if (access == "dma" and not bank.dma) or (access == "npu" and not bank.npu):
+            problems.append(f"{where}: {access.upper()} cannot reach {bank.name}")
+        if bank.slow and not rule.get("allow_slow", False):
+            problems.append(f"{where}: {access.upper()} buffer in slow {bank.name}")
+        noncacheable = (nc_start is not None and nc_end is not None
+                        and nc_start <= symbol.address
+                        and symbol.address + symbol.size <= nc_end)
+        if rule.get("cache") == "noncacheable" and not noncacheable:
+            problems.append(f"{where}: must sit in .noncacheable")
+        elif rule.get("cache") != "maintained" and not noncacheable and not bank.slow:
+            problems.append(f"{where}: cacheable without declared cache maintenance")
+    return problems
+
+
+def compare(current: dict, baseline: dict, thresholds: dict) -> list[str]:
+    """Return budget regressions of ``current`` against ``baseline``."""
+    failures: list[str] = []
+    region_limit = thresholds.get("region_growth_bytes", 4096)
+    symbol_limit = thresholds.get("symbol_growth_bytes", 1024)
+    symbol_percent = thresholds.get("symbol_growth_percent", 10)
+    new_limit = thresholds.get("new_symbol_bytes", 8192)
+
+    for kind in ("regions", "banks"):
+        for name, used in current[kind].items():
+            before = baseline.get(kind, {}).get(name, 0)
+            if used - before > region_limit:
+                failures.append(f"{kind[:-1]} {name}: {before} -> {used} bytes "
+                                f"(+{used - before}, limit +{region_limit})")
+
+    old_symbols = baseline.get("symbols", {})
+    for name, size in current["symbols"].items():
+        before = old_symbols.get(name)
+        if before is None:
+            if size > new_limit:
+                failures.append(f"new symbol {name}: {size} bytes (limit {new_limit})")
+            continue
+        allowed = max(symbol_limit, before * symbol_percent // 100)
+        if size - before > allowed:
+            failures.append(f"symbol {name}: {before} -> {size} bytes "
+                            f"(+{size - before}, limit +{allowed})")
+    return failures
+
+
+def summarize(image: Image, regions: list[Region], min_symbol_bytes: int) -> dict:
+    symbols: dict[str, int] = {}
+    for symbol in image.symbols:
+        if symbol.size >= min_symbol_bytes:
+            # Statics with the same name in different units are added up.
+            symbols[symbol.name] = symbols.get(symbol.name, 0) + symbol.size
+    return {
+        "regions": {region.name: region.used for region in regions},
+        "banks": bank_usage(image.sections),
+        "symbols": dict(sorted(symbols.items())),
+    }
+
+
+def print_report(image: Image, regions: list[Region], top: int) -> None:
+    if regions:
+        print("Region           Origin       Length     Used      %")
+        for region in regions:
+            percent = 100.0 * region.used / region.length if region.length else 0.0
+            print(f"{region.name:<16} 0x{region.origin:08X}  {region.length:>9}  "
+                  f"{region.used:>9}  {percent:5.1f}")
+        print()
+
+    used = bank_usage(image.sections)
+    print("Bank             Used       Size       %      Sections")
+    for bank in BANKS:
+        if bank.name not in used:
+            continue
+        names = sorted({s.name for s in image.sections
+                        if bank_for(s.address) is bank})
+        percent = 100.0 * used[bank.name] / bank.size
+        print(f"{bank.name:<16} {used[bank.name]:>9}  {bank.size:>9}  "
+              f"{percent:5.1f}  {' '.join(names)}")
+    print()
+
+    print(f"Top {top} symbols")
+    for symbol in sorted(image.symbols, key=lambda s: s.size, reverse=True)[:top]:
+        bank = bank_for(symbol.address)
+        print(f"{symbol.size:>9}  {bank.name if bank else '?':<9} "
+              f"{symbol.section:<24} {symbol.name}  {symbol.obj}")
+    print()
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", type=Path, help="linked application .elf")
+    parser.add_argument("--map", type=Path, help="linker .map for regions and objects")
+    parser.add_argument("--rules", type=Path, default=DEFAULT_RULES,
+                        help="placement rules and thresholds (JSON)")
+    parser.add_argument("--baseline", type=Path, help="baseline to gate against")
+    parser.add_argument("--write-baseline", type=Path, metavar="PATH",
+                        help="write this build's figures as the new baseline")
+    parser.add_argument("--top", type=int, help="symbols to list")
+    args = parser.parse_args()
+
+    try:
+        rules = json.loads(args.rules.read_text()) if args.rules.exists() else {}
+        image = read_elf(args.elf.read_bytes())
+        regions: list[Region] = []
+        if args.map:
+            regions, inputs = read_map(args.map.read_text(errors="replace"))
+            attribute_objects(image.symbols, inputs)
+        baseline = json.loads(args.baseline.read_text()) if args.baseline else None
+    except (OSError, ValueError, struct.error) as error:
+        print(f"memory_budget: {error}", file=sys.stderr)
+        return 2
+
+    thresholds = rules.get("thresholds", {})
+    region_usage(regions, image.sections)
+    print_report(image, regions, args.top or thresholds.get("top_symbols", 25))
+    current = summarize(image, regions, thresholds.get("min_symbol_bytes", 256))
+
+    failures = check_placement(image, rules)
+    for problem in failures:
+        print(f"PLACEMENT {problem}")
+    if baseline is not None:
+        regressions = compare(current, baseline, thresholds)
+        for regression in regressions:
+            print(f"REGRESSION {regression}")
+        failures += regressions
+
+    if args.write_baseline:
+        args.write_baseline.write_text(json.dumps(current, indent=2) + "\n")
+        print(f"{args.write_baseline}: baseline written")
+    print("memory budget: " + ("FAIL" if failures else "OK"))
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,136 @@
+"""Exit-status checks for memory_budget.py on a synthetic ELF and map.
+
+The fixture is a minimal little-endian ELF32 with one 32 KB .data object and
+one 32 KB .bss object in AXISRAM1, built here so no toolchain output is
+needed.
+
+Usage:
+    python3 -m unittest discover -s tools -p "test_*.py"
+"""
+
+from __future__ import annotations
+
+import json
+import struct
+import subprocess
+import sys
+import tempfile
+import unittest
+from pathlib import Path
+
+TOOL = Path(__file__).with_name("memory_budget.py")
+
+DATA_ADDR = 0x34000000
+BSS_ADDR = 0x34010000
+BASE_SIZE = 0x8000
+
+MAP_TEXT = """\
+Memory Configuration
+
+Name             Origin             Length             Attributes
+AXISRAM1         0x34000000         0x00100000         xrw
+*default*        0x00000000         0xffffffff
+
+Linker script and memory map
+
+ .data          0x34000000     0x{data:x} ./Appli/Src/app_fixture.o
+ .bss           0x34010000     0x{bss:x} ./Appli/Src/app_fixture.o
+"""
+
+RULES = {
+    "thresholds": {
+        "min_symbol_bytes": 256,
+        "region_growth_bytes": 4096,
+        "symbol_growth_bytes": 1024,
+        "symbol_growth_percent": 10,
+        "new_symbol_bytes": 8192,
+    },
+}
+
+
+def build_elf(data_size: int, bss_size: int) -> bytes:
+    """Return an ELF32 with fixture_table in .data and fixture_pool in .bss."""
+    shstrtab = b"\0.data\0.bss\0.symtab\0.strtab\0.shstrtab\0"
+    strtab = b"\0fixture_table\0fixture_pool\0"
+    symbols = b"".join((
+        struct.pack("<IIIBBH", 0, 0, 0, 0, 0, 0),
+        struct.pack("<IIIBBH", 1, DATA_ADDR, data_size, 0x11, 0, 1),
+        struct.pack("<IIIBBH", 15, BSS_ADDR, bss_size, 0x11, 0, 2),
+    ))
+
+    data_offset = 0x34
+    symtab_offset = data_offset + data_size
+    strtab_offset = symtab_offset + len(symbols)
+    shstrtab_offset = strtab_offset + len(strtab)
+    shoff = (shstrtab_offset + len(shstrtab) + 3) & ~3
+
+    headers = [
+        (0, 0, 0, 0, 0, 0, 0, 0, 0, 0),
+        (1, 1, 0x3, DATA_ADDR, data_offset, data_size, 0, 0, 4, 0),
+        (7, 8, 0x3, BSS_ADDR, symtab_offset, bss_size, 0, 0, 4, 0),
+        (12, 2, 0, 0, symtab_offset, len(symbols), 4, 1, 4, 16),
+        (20, 3, 0, 0, strtab_offset, len(strtab), 0, 0, 1, 0),
+        (28, 3, 0, 0, shstrtab_offset, len(shstrtab), 0, 0, 1, 0),
+    ]
+
+    ident = b"\x7fELF" + bytes((1, 1, 1)) + bytes(9)
+    elf_header = ident + struct.pack("<HHIIIIIHHHHHH", 2, 40, 1, 0, 0, shoff,
+                                     0, 0x34, 0, 0, 40, len(headers), 5)
+    body = elf_header + bytes(data_size) + symbols + strtab + shstrtab
+    body += bytes(shoff - len(body))
+    return body + b"".join(struct.pack("<IIIIIIIIII", *h) for h in headers)
+
+
+class MemoryBudgetTest(unittest.TestCase):
+    def setUp(self) -> None:
+        self.tmp = tempfile.TemporaryDirectory()
+        self.dir = Path(self.tmp.name)
+        self.rules = self.dir / "rules.json"
+        self.rules.write_text(json.dumps(RULES))
+        self.baseline = self.dir / "baseline.json"
+        self.write_build(data_size=BASE_SIZE, bss_size=BASE_SIZE)
+        self.assertEqual(self.run_tool("--write-baseline", self.baseline)[0], 0)
+
+    def tearDown(self) -> None:
+        self.tmp.cleanup()
+
+    def write_build(self, data_size: int, bss_size: int) -> None:
+        (self.dir / "app.elf").write_bytes(build_elf(data_size, bss_size))
+        (self.dir / "app.map").write_text(MAP_TEXT.format(data=data_size, bss=bss_size))
+
+    def run_tool(self, *extra: object) -> tuple[int, str]:
+        command = [sys.executable, str(TOOL), str(self.dir / "app.elf"),
+                   "--map", str(self.dir / "app.map"), "--rules", str(self.rules)]
+        command += [str(arg) for arg in extra]
+        result = subprocess.run(command, capture_output=True, text=True)
+        return result.returncode, result.stdout
+
+    def test_unchanged_build_passes(self) -> None:
+        self.assertEqual(self.run_tool("--baseline", self.baseline)[0], 0)
+
+    def test_growth_within_thresholds_passes(self) -> None:
+        # 10 % of 32 KB is the per-symbol limit; the region grows by 4 KB.
+        self.write_build(data_size=BASE_SIZE + 2048, bss_size=BASE_SIZE + 2048)
+        self.assertEqual(self.run_tool("--baseline", self.baseline)[0], 0)
+
+    def test_symbol_growth_past_threshold_fails(self) -> None:
+        self.write_build(data_size=BASE_SIZE, bss_size=BASE_SIZE + 3280)
+        status, output = self.run_tool("--baseline", self.baseline)
+        self.assertEqual(status, 1)
+        self.assertIn("REGRESSION symbol fixture_pool", output)
+
+    def test_region_growth_past_threshold_fails(self) -> None:
+        # Both symbols stay under their limit; together they pass 4 KB.
+        self.write_build(data_size=BASE_SIZE + 2056, bss_size=BASE_SIZE + 2048)
+        status, output = self.run_tool("--baseline", self.baseline)
+        self.assertEqual(status, 1)
+        self.assertIn("REGRESSION region AXISRAM1", output)
+        self.assertNotIn("REGRESSION symbol", output)
+
+    def test_bad_elf_is_an_input_error(self) -> None:
+        (self.dir / "app.elf").write_bytes(b"not an elf")
+        self.assertEqual(self.run_tool("--baseline", self.baseline)[0], 2)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,108 @@
+"""Placement checks for weight_placement.py on a synthetic network and profile.
+
+The fixture network has three flash weight tensors over two epochs, and the
+profile makes both epochs flash-bound, so a 64 KB pool must take a
+non-empty, aligned subset of them.
+
+Usage:
+    python3 -m unittest discover -s tools -p "test_*.py"
+"""
+
+from __future__ import annotations
+
+import json
+import subprocess
+import sys
+import tempfile
+import unittest
+from pathlib import Path
+
+TOOL = Path(__file__).with_name("weight_placement.py")
+
+NETWORK = "fixture_net"
+POOL_BASE = 0x34350000
+BUDGET = 64 * 1024
+
+# name, epoch, offset_start, size
+WEIGHTS = (
+    ("conv1_weights", 1, 0x0000, 50000),
+    ("conv2_weights", 2, 0xC400, 20000),
+    ("conv3_weights", 2, 0x11400, 30000),
+)
+
+BUFFER_ENTRY = """\
+    {{
+      .name = "{name}",
+      .addr_base = {{(unsigned char *)(0x70400000UL) /* Equivalent hex address = 0x70400000UL */}},
+      .offset_start = {start},
+      .offset_end = {end},
+      .is_param = 1,
+      .epoch = {epoch},
+    }},
+"""
+
+# step, runs, avg_us, min_us, max_us: each step is slower than its weights
+# take to stream from flash at the tool's default 100 MB/s.
+PROFILE = f"""\
+[AI][EPOCH] {NETWORK} runs=4 epochs=2 dropped=0 total_avg_us=1500
+[AI][EPOCH] {NETWORK},0,4,600,580,620
+[AI][EPOCH] {NETWORK},1,4,900,880,920
+"""
+
+
+class WeightPlacementTest(unittest.TestCase):
+    def setUp(self) -> None:
+        self.tmp = tempfile.TemporaryDirectory()
+        self.dir = Path(self.tmp.name)
+        source = self.dir / "fixture_net.c"
+        source.write_text(
+            "const LL_Buffer_InfoTypeDef *LL_ATON_Input_Buffers_Info_fixture_net(void)\n"
+            "{\n  static const LL_Buffer_InfoTypeDef buff_info[] = {\n"
+            + "".join(BUFFER_ENTRY.format(name=name, epoch=epoch, start=start,
+                                          end=start + size)
+                      for name, epoch, start, size in WEIGHTS)
+            + "  };\n  return buff_info;\n}\n")
+        self.stages = self.dir / "stages.json"
+        self.stages.write_text(json.dumps({
+            "stages": [{"name": NETWORK, "step": 0, "source": str(source)}],
+        }))
+        self.profile = self.dir / "console.log"
+        self.profile.write_text(PROFILE)
+        self.output = self.dir / "placement.json"
+
+    def tearDown(self) -> None:
+        self.tmp.cleanup()
+
+    def run_tool(self, *extra: object) -> int:
+        command = [sys.executable, str(TOOL), NETWORK, "--profile",
+                   str(self.profile), "--stages", str(self.stages)]
+        command += [str(arg) for arg in extra]
+        return subprocess.run(command, capture_output=True, text=True).returncode
+
+    def test_places_flash_bound_weights_in_the_pool(self) -> None:
+        status = self.run_tool("--pool-base", hex(POOL_BASE), "--budget", BUDGET,
+                               "--output", self.output)
+        self.assertEqual(status, 0)
+        plan = json.loads(self.output.read_text())
+
+        self.assertTrue(plan["tensors"])
+        self.assertEqual(plan["pool_base"], f"0x{POOL_BASE:08X}")
+        self.assertLessEqual(plan["pool_bytes"], BUDGET)
+        self.assertLess(plan["predicted_us"], plan["baseline_us"])
+        end = 0
+        for tensor in plan["tensors"]:
+            self.assertEqual(tensor["pool_offset"] % 32, 0)
+            self.assertGreaterEqual(tensor["pool_offset"], end)
+            self.assertGreater(tensor["saving_us"], 0.0)
+            end = tensor["pool_offset"] + tensor["size"]
+        self.assertLessEqual(end, BUDGET)
+
+    def test_pool_is_required(self) -> None:
+        self.assertEqual(self.run_tool("--budget", BUDGET), 2)
+        self.assertEqual(self.run_tool("--pool-base", hex(POOL_BASE)), 2)
+        self.assertEqual(self.run_tool("--pool-base", hex(POOL_BASE + 4),
+                                       "--budget", BUDGET), 2)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,278 @@
+"""Profile-guided placement of NPU weights between internal RAM and xSPI2.
+
+Every stage streams its weights from the xSPI2 NOR window during its epochs.
+This tool finds the weight tensors whose flash reads cost the most epoch
+time per byte and picks the set to keep in an internal RAM pool instead:
+
+  1. Weight tensors (is_param buffers) and the epoch that reads each come
+     from the stage's generated network C file (the same stage list as
+     tools/activation_overlay.py).
+  2. Per-epoch times come from the "[AI][EPOCH]" lines a build with
+     APP_AI_ENABLE_EPOCH_PROFILE prints on the debug console.
+  3. An epoch's flash stall is the part of its time that streaming its
+     weights from flash would explain beyond reading them from RAM:
+         stall = max(0, min(measured, bytes / flash_bw) - bytes / ram_bw)
+     Each tensor carries its share of the stall by size, so the cost per
+     byte is stall / bytes of its epoch.
+  4. Tensors go into the pool by cost per byte, largest savings first,
+     until the budget runs out. The predicted epoch time drops by the
+     placed share of its stall.
+
+The pool is an internal RAM region set aside for the weights, given by
+--pool-base and --budget. There is no default: the checked-in activation
+overlay plan is a placeholder with no free tail, so the region has to come
+from the memory budget report. The placement is written as JSON. It lists
+each tensor's pool offset so the package can be regenerated with those
+tensors in an internal RAM pool; the network's init then copies them from
+flash when the stage is installed. After flashing the regenerated package,
+run again with --confirm and a new profile to check the prediction.
+
+Profile steps count passes through LL_ATON_RT_RunEpochBlock. They match the
+generated epoch numbers offset by --epoch-base (1 for the current packages).
+
+Usage:
+    python3 weight_placement.py tip_focus_v18_int8 --profile console.log \\
+        --pool-base ADDR --budget BYTES --output tip_focus_placement.json
+    python3 weight_placement.py tip_focus_v18_int8 \\
+        --confirm tip_focus_placement.json --profile after.log
+
+Exit status: 0 placement written or prediction confirmed, 1 prediction
+missed by more than --tolerance, 2 bad input.
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import re
+import sys
+from dataclasses import dataclass, field
+from pathlib import Path
+
+from activation_overlay import (ADDR_BASE, BUFFER_NAME, DEFAULT_STAGES, ROOT,
+                                align_up, int_field)
+
+XSPI_WINDOW = (0x70000000, 0x80000000)
+EPOCH_LINE = re.compile(
+    r"\[AI\]\[EPOCH\]\s+([\w.-]+),(\d+),(\d+),(\d+),(\d+),(\d+)")
+
+
+@dataclass
+class Weight:
+    name: str
+    epoch: int
+    size: int
+    address: int | None
+    saving_us: float = 0.0
+    pool_offset: int | None = None
+
+
+@dataclass
+class Epoch:
+    step: int
+    measured_us: float
+    weights: list[Weight] = field(default_factory=list)
+    stall_us: float = 0.0
+
+    @property
+    def weight_bytes(self) -> int:
+        return sum(w.size for w in self.weights)
+
+    def predicted_us(self) -> float:
+        if not self.weight_bytes:
+            return self.measured_us
+        placed = sum(w.size for w in self.weights if w.pool_offset is not None)
+        return self.measured_us - self.stall_us * placed / self.weight_bytes
+
+
+def read_weights(text: str) -> list[Weight]:
+    """Return the flash-resident weight tensors of a generated network."""
+    names = list(BUFFER_NAME.finditer(text))
+    weights: list[Weight] = []
+    seen: set[str] = set()
+    for index, match in enumerate(names):
+        end = names[index + 1].start() if index + 1 < len(names) else len(text)
+        entry = text[match.start():end]
+        if match.group(1) in seen or not int_field(entry, "is_param"):
+            continue
+        seen.add(match.group(1))
+        start = int_field(entry, "offset_start")
+        stop = int_field(entry, "offset_end")
+        epoch = int_field(entry, "epoch")
+        if start is None or stop is None or epoch is None or stop <= start:
+            continue
+        base = ADDR_BASE.search(entry)
+        # Reloc packages leave the base symbolic; their parameters sit at the
+        # stage's xSPI2 window, so only a literal non-xSPI address is skipped.
+        address = int(base.group(1), 16) + start if base else None
+        if address is not None and not XSPI_WINDOW[0] <= address < XSPI_WINDOW[1]:
+            continue
+        weights.append(Weight(match.group(1), epoch, stop - start, address))
+    return weights
+
+
+def read_profile(text: str, network: str) -> dict[int, float]:
+    """Average time per epoch step; later windows override earlier ones."""
+    profile: dict[int, float] = {}
+    for match in EPOCH_LINE.finditer(text):
+        if match.group(1) == network and int(match.group(3)):
+            profile[int(match.group(2))] = float(match.group(4))
+    return profile
+
+
+def build_epochs(weights: list[Weight], profile: dict[int, float],
+                 epoch_base: int, flash_bpus: float,
+                 ram_bpus: float) -> tuple[list[Epoch], list[Weight]]:
+    """Attach weights to profiled epochs; return the epochs and the weights
+    whose epoch was not profiled."""
+    epochs = {step: Epoch(step, us) for step, us in profile.items()}
+    unprofiled: list[Weight] = []
+    for weight in weights:
+        epoch = epochs.get(weight.epoch - epoch_base)
+        if epoch is None:
+            unprofiled.append(weight)
+        else:
+            epoch.weights.append(weight)
+    for epoch in epochs.values():
+        total = epoch.weight_bytes
+        if total:
+            epoch.stall_us = max(0.0, min(epoch.measured_us, total / flash_bpus)
+                                 - total / ram_bpus)
+            for weight in epoch.weights:
+                weight.saving_us = epoch.stall_us * weight.size / total
+    return sorted(epochs.values(), key=lambda e: e.step), unprofiled
+
+
+def place(weights: list[Weight], budget: int, align: int) -> int:
+    """Greedy by saving per byte; return the pool bytes used."""
+    used = 0
+    for weight in sorted(weights, key=lambda w: w.saving_us / w.size,
+                         reverse=True):
+        if weight.saving_us <= 0.0:
+            break
+        offset = align_up(used, align)
+        if offset + weight.size <= budget:
+            weight.pool_offset = offset
+            used = offset + weight.size
+    return used
+
+
+def print_report(epochs: list[Epoch], placed: list[Weight], used: int,
+                 budget: int, unprofiled: list[Weight]) -> None:
+    print(f"{'Weight':<48} {'epoch':>5} {'bytes':>9} {'saving us':>10} "
+          f"{'us/KiB':>8} {'pool offset':>11}")
+    for weight in placed:
+        print(f"{weight.name:<48} {weight.epoch:>5} {weight.size:>9} "
+              f"{weight.saving_us:>10.1f} "
+              f"{weight.saving_us * 1024 / weight.size:>8.2f} "
+              f"0x{weight.pool_offset:08X}")
+    baseline = sum(e.measured_us for e in epochs)
+    predicted = sum(e.predicted_us() for e in epochs)
+    stalled = sum(e.stall_us for e in epochs)
+    print(f"\n{len(placed)} tensors, {used} of {budget} pool bytes; "
+          f"flash stall {stalled:.0f} us of {baseline:.0f} us profiled")
+    if baseline:
+        print(f"predicted {predicted:.0f} us "
+              f"({100.0 * (baseline - predicted) / baseline:.1f}% faster)")
+    if unprofiled:
+        print(f"{len(unprofiled)} weight tensors fall outside the profiled "
+              f"epochs; check --epoch-base")
+
+
+def confirm(plan: dict, profile: dict[int, float], tolerance: float) -> int:
+    measured = sum(profile.values())
+    baseline = float(plan["baseline_us"])
+    predicted = float(plan["predicted_us"])
+    print(f"baseline {baseline:.0f} us, predicted {predicted:.0f} us, "
+          f"measured {measured:.0f} us")
+    gain = baseline - predicted
+    if gain <= 0.0:
+        print("placement predicted no gain; nothing to confirm")
+        return 0
+    achieved = (baseline - measured) / gain
+    print(f"achieved {100.0 * achieved:.0f}% of the predicted gain")
+    return 0 if achieved >= 1.0 - tolerance else 1
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("network", help="stage name in the stage list")
+    parser.add_argument("--profile", type=Path, required=True,
+                        help="console log with [AI][EPOCH] lines")
+    parser.add_argument("--stages", type=Path, default=DEFAULT_STAGES,
+                        help="stage list (JSON)")
+    parser.add_argument("--pool-base", type=lambda text: int(text, 0),
+                        help="internal RAM address of the pool (required "
+                             "unless --confirm)")
+    parser.add_argument("--budget", type=int,
+                        help="pool bytes (required unless --confirm)")
+    parser.add_argument("--align", type=int, default=32)
+    parser.add_argument("--epoch-base", type=int, default=1,
+                        help="generated epoch number of profile step 0")
+    parser.add_argument("--flash-mbps", type=float, default=100.0,
+                        help="xSPI2 read bandwidth, MB/s (STR; ~200 in DTR)")
+    parser.add_argument("--ram-mbps", type=float, default=3200.0,
+                        help="internal RAM bandwidth seen by the NPU, MB/s")
+    parser.add_argument("--output", type=Path, help="placement JSON to write")
+    parser.add_argument("--confirm", type=Path, metavar="PLACEMENT",
+                        help="compare --profile against a placement's prediction")
+    parser.add_argument("--tolerance", type=float, default=0.25,
+                        help="allowed shortfall of the predicted gain")
+    args = parser.parse_args()
+
+    try:
+        profile = read_profile(args.profile.read_text(errors="replace"),
+                               args.network)
+        if not profile:
+            raise ValueError(f"no [AI][EPOCH] lines for {args.network} "
+                             f"in {args.profile}")
+        if args.confirm:
+            return confirm(json.loads(args.confirm.read_text()), profile,
+                           args.tolerance)
+        config = json.loads(args.stages.read_text())
+        entry = next((s for s in config["stages"]
+                      if s["name"] == args.network), None)
+        if entry is None:
+            raise ValueError(f"{args.network} is not in {args.stages}")
+        if args.pool_base is None or args.budget is None or args.budget <= 0:
+            raise ValueError("pass --pool-base and a positive --budget")
+        if args.pool_base % args.align:
+            raise ValueError(f"--pool-base is not {args.align}-byte aligned")
+        weights = read_weights((ROOT / entry["source"]).read_text(
+            errors="replace"))
+    except (OSError, ValueError, KeyError) as error:
+        print(f"weight_placement: {error}", file=sys.stderr)
+        return 2
+
+    budget = args.budget
+    epochs, unprofiled = build_epochs(weights, profile, args.epoch_base,
+                                      args.flash_mbps, args.ram_mbps)
+    used = place([w for e in epochs for w in e.weights], budget, args.align)
+    placed = sorted((w for e in epochs for w in e.weights
+                     if w.pool_offset is not None),
+                    key=lambda w: w.pool_offset)
+    print_report(epochs, placed, used, budget, unprofiled)
+
+    if args.output:
+        args.output.write_text(json.dumps({
+            "network": args.network,
+            "pool_base": f"0x{args.pool_base:08X}",
+            "pool_bytes": used,
+            "budget": budget,
+            "baseline_us": round(sum(e.measured_us for e in epochs), 1),
+            "predicted_us": round(sum(e.predicted_us() for e in epochs), 1),
+            "tensors": [{
+                "name": w.name,
+                "epoch": w.epoch,
+                "size": w.size,
+                "flash_addr": None if w.address is None else f"0x{w.address:08X}",
+                "pool_offset": w.pool_offset,
+                "saving_us": round(w.saving_us, 1),
+            } for w in placed],
+        }, indent=2) + "\n")
+        print(f"{args.output}: placement written")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())